@@ -0,0 +1,415 @@
+#include "app_registry.h"
+#include "assets.h"
+#include "settings.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+static const char* TAG = "APP_REGISTRY";
+
+typedef struct {
+    const char* id;
+    const char* name;
+    const char* icon;               // asset name
+} app_builtin_t;
+
+#include "app_table.h"              // k_app_table, generated from apps.csv
+
+#define EXT_SLOTS       128         // open addressing, power of two
+#define EXT_MAGIC       0x52505041u // "APPR"
+#define EXT_VERSION     1
+#define BIN_MAGIC       0x19        // LVGL v9 image header
+#define BIN_CF_RGB565A8 0x14
+#define BIN_FLAG_COMPRESSED 0x08
+#define ICON_SCALE_MAX  4
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t crc;                   // esp_rom_crc32_le over the records
+} ext_header_t;
+
+typedef struct __attribute__((packed)) {
+    char id[APP_REGISTRY_ID_MAX];
+    char name[APP_REGISTRY_NAME_MAX];
+    char icon[APP_REGISTRY_FILE_MAX];
+} ext_record_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t magic;
+    uint8_t cf;
+    uint16_t flags;
+    uint16_t w;
+    uint16_t h;
+    uint16_t stride;
+    uint16_t reserved;
+} bin_header_t;
+
+_Static_assert(sizeof(bin_header_t) == 12, "LVGL image header layout");
+
+typedef struct {
+    app_info_t info;
+    ext_record_t rec;
+    uint32_t hash;
+    bool used;
+    // Kept when the app is removed: a card may still show it until the
+    // entry is reused, and reuse only swaps the pixels under the lock
+    lv_image_dsc_t icon;
+    uint8_t* pixels;
+} ext_app_t;
+
+static char s_base[32] = "/spiffs";
+static app_info_t s_builtin[APP_TABLE_SLOTS];   // resolved on first lookup
+static ext_app_t* s_ext;                        // APP_REGISTRY_EXT_MAX, PSRAM
+static uint8_t s_ext_slots[EXT_SLOTS];          // entry + 1, 0 = empty
+static size_t s_ext_count;
+
+static uint32_t app_hash(const char* id, uint32_t seed)
+{
+    uint32_t h = 0x811c9dc5u ^ seed;
+    while (*id) h = (h ^ (uint8_t)tolower((unsigned char)*id++)) * 0x01000193u;
+    return h ^ (h >> 15);
+}
+
+static void table_path(char* out, size_t out_sz)
+{
+    snprintf(out, out_sz, "%s/.apps", s_base);
+}
+
+// The new table is written here and renamed over the old one
+static void table_tmp_path(char* out, size_t out_sz)
+{
+    snprintf(out, out_sz, "%s/.apps.tmp", s_base);
+}
+
+static void slots_rebuild(void)
+{
+    memset(s_ext_slots, 0, sizeof(s_ext_slots));
+    for (size_t e = 0; e < APP_REGISTRY_EXT_MAX; ++e) {
+        if (!s_ext[e].used) continue;
+        uint32_t i = s_ext[e].hash & (EXT_SLOTS - 1);
+        while (s_ext_slots[i]) i = (i + 1) & (EXT_SLOTS - 1);
+        s_ext_slots[i] = (uint8_t)(e + 1);
+    }
+}
+
+static ext_app_t* ext_find(const char* id, uint32_t h)
+{
+    for (uint32_t n = 0, i = h & (EXT_SLOTS - 1); n < EXT_SLOTS && s_ext_slots[i]; ++n, i = (i + 1) & (EXT_SLOTS - 1)) {
+        ext_app_t* e = &s_ext[s_ext_slots[i] - 1];
+        if (e->hash == h && strcasecmp(e->rec.id, id) == 0) return e;
+    }
+    return NULL;
+}
+
+// Box-filter an RGB565A8 image `scale` times the icon size down to it
+static void icon_downscale(const uint8_t* src, uint32_t stride, uint32_t h, uint32_t scale, uint8_t* dst)
+{
+    const uint32_t S = APP_REGISTRY_ICON_SIZE;
+    const uint8_t* src_a = src + stride * h;
+    const uint32_t stride_a = stride / 2;
+    uint16_t* dst_rgb = (uint16_t*)dst;
+    uint8_t* dst_a = dst + S * S * 2;
+    const uint32_t n = scale * scale;
+
+    for (uint32_t y = 0; y < S; ++y) {
+        for (uint32_t x = 0; x < S; ++x) {
+            uint32_t r = 0, g = 0, b = 0, a = 0;
+            for (uint32_t dy = 0; dy < scale; ++dy) {
+                const uint32_t sy = y * scale + dy;
+                const uint16_t* row = (const uint16_t*)(src + sy * stride);
+                for (uint32_t dx = 0; dx < scale; ++dx) {
+                    const uint32_t sx = x * scale + dx;
+                    const uint16_t px = row[sx];
+                    r += px >> 11;
+                    g += (px >> 5) & 0x3F;
+                    b += px & 0x1F;
+                    a += src_a[sy * stride_a + sx];
+                }
+            }
+            dst_rgb[y * S + x] = (uint16_t)(((r / n) << 11) | ((g / n) << 5) | (b / n));
+            dst_a[y * S + x] = (uint8_t)(a / n);
+        }
+    }
+}
+
+static esp_err_t icon_load(const char* file, uint8_t** out, uint16_t* flags)
+{
+    char path[sizeof(s_base) + APP_REGISTRY_FILE_MAX + 2];
+    snprintf(path, sizeof(path), "%s/%s", s_base, file);
+    FILE* f = fopen(path, "rb");
+    if (!f) return ESP_ERR_NOT_FOUND;
+
+    bin_header_t hdr;
+    esp_err_t err = ESP_ERR_INVALID_SIZE;
+    uint8_t* src = NULL;
+    uint8_t* dst = NULL;
+    if (fread(&hdr, 1, sizeof(hdr), f) != sizeof(hdr)) goto out;
+    const uint32_t scale = hdr.w / APP_REGISTRY_ICON_SIZE;
+    if (hdr.magic != BIN_MAGIC || hdr.cf != BIN_CF_RGB565A8 || (hdr.flags & BIN_FLAG_COMPRESSED) ||
+        hdr.w != hdr.h || hdr.w % APP_REGISTRY_ICON_SIZE || scale == 0 || scale > ICON_SCALE_MAX ||
+        hdr.stride < hdr.w * 2 || hdr.stride % 2) {
+        ESP_LOGW(TAG, "%s: not a square uncompressed RGB565A8 icon", file);
+        goto out;
+    }
+
+    const size_t src_size = (size_t)hdr.stride * hdr.h + (size_t)(hdr.stride / 2) * hdr.h;
+    const size_t dst_size = APP_REGISTRY_ICON_SIZE * APP_REGISTRY_ICON_SIZE * 3;
+    src = heap_caps_malloc(src_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    dst = heap_caps_malloc(dst_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!src || !dst) {
+        err = ESP_ERR_NO_MEM;
+        goto out;
+    }
+    if (fread(src, 1, src_size, f) != src_size) goto out;
+
+    icon_downscale(src, hdr.stride, hdr.h, scale, dst);
+    *out = dst;
+    *flags = hdr.flags;
+    dst = NULL;
+    err = ESP_OK;
+out:
+    fclose(f);
+    heap_caps_free(src);
+    heap_caps_free(dst);
+    return err;
+}
+
+static void icon_set(ext_app_t* e, uint8_t* pixels, uint16_t flags)
+{
+    lv_image_cache_drop(&e->icon);
+    heap_caps_free(e->pixels);
+    e->pixels = pixels;
+    e->icon = (lv_image_dsc_t){
+        .header = {
+            .magic = LV_IMAGE_HEADER_MAGIC,
+            .cf = LV_COLOR_FORMAT_RGB565A8,
+            .flags = flags,
+            .w = APP_REGISTRY_ICON_SIZE,
+            .h = APP_REGISTRY_ICON_SIZE,
+            .stride = APP_REGISTRY_ICON_SIZE * 2,
+        },
+        .data_size = pixels ? APP_REGISTRY_ICON_SIZE * APP_REGISTRY_ICON_SIZE * 3 : 0,
+        .data = pixels,
+    };
+    e->info.icon = pixels ? &e->icon : NULL;
+}
+
+static void entry_fill(ext_app_t* e, const ext_record_t* rec)
+{
+    e->rec = *rec;
+    e->rec.id[APP_REGISTRY_ID_MAX - 1] = '\0';
+    e->rec.name[APP_REGISTRY_NAME_MAX - 1] = '\0';
+    e->rec.icon[APP_REGISTRY_FILE_MAX - 1] = '\0';
+    e->hash = app_hash(e->rec.id, 0);
+    e->info.id = e->rec.id;
+    e->info.name = e->rec.name[0] ? e->rec.name : e->rec.id;
+    e->used = true;
+}
+
+static esp_err_t table_save(void)
+{
+    const size_t size = sizeof(ext_header_t) + s_ext_count * sizeof(ext_record_t);
+    uint8_t* buf = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) return ESP_ERR_NO_MEM;
+    ext_record_t* recs = (ext_record_t*)(buf + sizeof(ext_header_t));
+    size_t n = 0;
+    for (size_t e = 0; e < APP_REGISTRY_EXT_MAX; ++e) {
+        if (s_ext[e].used) recs[n++] = s_ext[e].rec;
+    }
+    ext_header_t hdr = {
+        .magic = EXT_MAGIC,
+        .version = EXT_VERSION,
+        .count = (uint16_t)n,
+        .crc = esp_rom_crc32_le(0, (const uint8_t*)recs, n * sizeof(ext_record_t)),
+    };
+    memcpy(buf, &hdr, sizeof(hdr));
+
+    char path[sizeof(s_base) + 8];
+    char tmp[sizeof(s_base) + 12];
+    table_path(path, sizeof(path));
+    table_tmp_path(tmp, sizeof(tmp));
+    esp_err_t err = ESP_FAIL;
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        bool ok = fwrite(buf, 1, size, f) == size;
+        ok = fclose(f) == 0 && ok;
+#if !CONFIG_SETTINGS_STORAGE_LITTLEFS
+        // SPIFFS rename does not replace an existing file. Until the rename
+        // only the complete .tmp is left; table_load() picks it up.
+        if (ok) remove(path);
+#endif
+        if (ok && rename(tmp, path) == 0) {
+            settings_wear_note(SETTINGS_PART_STORAGE, (uint32_t)size, 0);
+            settings_storage_changed();
+            err = ESP_OK;
+        } else if (!ok) {
+            // A failed rename keeps the .tmp: on SPIFFS it is the only table left
+            remove(tmp);
+        }
+    }
+    heap_caps_free(buf);
+    if (err != ESP_OK) ESP_LOGE(TAG, "Could not write %s", path);
+    return err;
+}
+
+static esp_err_t table_read(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return ESP_ERR_NOT_FOUND;
+
+    esp_err_t err = ESP_ERR_INVALID_CRC;
+    ext_header_t hdr;
+    ext_record_t* recs = NULL;
+    if (fread(&hdr, 1, sizeof(hdr), f) != sizeof(hdr) || hdr.magic != EXT_MAGIC ||
+        hdr.version != EXT_VERSION || hdr.count > APP_REGISTRY_EXT_MAX) {
+        ESP_LOGW(TAG, "Ignoring %s: bad header", path);
+        goto out;
+    }
+    recs = heap_caps_malloc(hdr.count * sizeof(*recs) + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!recs || fread(recs, sizeof(*recs), hdr.count, f) != hdr.count ||
+        esp_rom_crc32_le(0, (const uint8_t*)recs, hdr.count * sizeof(*recs)) != hdr.crc) {
+        ESP_LOGW(TAG, "Ignoring %s: truncated or corrupt", path);
+        goto out;
+    }
+    for (size_t i = 0; i < hdr.count; ++i) {
+        ext_app_t* e = &s_ext[s_ext_count++];
+        entry_fill(e, &recs[i]);
+        uint8_t* pixels = NULL;
+        uint16_t flags = 0;
+        if (e->rec.icon[0] && icon_load(e->rec.icon, &pixels, &flags) != ESP_OK) {
+            ESP_LOGW(TAG, "%s: icon %s unavailable", e->rec.id, e->rec.icon);
+        }
+        icon_set(e, pixels, flags);
+    }
+    err = ESP_OK;
+out:
+    heap_caps_free(recs);
+    fclose(f);
+    return err;
+}
+
+static void table_load(void)
+{
+    char path[sizeof(s_base) + 8];
+    char tmp[sizeof(s_base) + 12];
+    table_path(path, sizeof(path));
+    table_tmp_path(tmp, sizeof(tmp));
+    if (table_read(path) != ESP_ERR_NOT_FOUND) return;
+    // A save cut off between removing the old table and renaming the new
+    // one (SPIFFS) leaves only the new one, complete, under the .tmp name
+    if (table_read(tmp) == ESP_OK && rename(tmp, path) == 0) {
+        settings_storage_changed();
+        ESP_LOGW(TAG, "Recovered %s from an interrupted save", path);
+    }
+}
+
+esp_err_t app_registry_init(const char* base_dir)
+{
+    if (base_dir) snprintf(s_base, sizeof(s_base), "%s", base_dir);
+    if (!s_ext) {
+        s_ext = heap_caps_calloc(APP_REGISTRY_EXT_MAX, sizeof(*s_ext), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_ext) return ESP_ERR_NO_MEM;
+    }
+    for (size_t e = 0; e < APP_REGISTRY_EXT_MAX; ++e) s_ext[e].used = false;
+    s_ext_count = 0;
+    table_load();
+    slots_rebuild();
+    ESP_LOGI(TAG, "%u built-in apps, %u pushed", (unsigned)APP_TABLE_COUNT, (unsigned)s_ext_count);
+    return ESP_OK;
+}
+
+const app_info_t* app_registry_lookup(const char* app_id)
+{
+    if (!app_id || !*app_id) return NULL;
+    if (s_ext) {
+        ext_app_t* e = ext_find(app_id, app_hash(app_id, 0));
+        if (e) return &e->info;
+    }
+    const uint32_t i = app_hash(app_id, APP_TABLE_SEED) & (APP_TABLE_SLOTS - 1);
+    const app_builtin_t* b = &k_app_table[i];
+    if (!b->id || strcasecmp(b->id, app_id) != 0) return NULL;
+    app_info_t* info = &s_builtin[i];
+    if (!info->id) {
+        info->icon = assets_image(b->icon);
+        info->name = b->name;
+        info->id = b->id;
+    }
+    return info;
+}
+
+static bool icon_file_valid(const char* icon_file)
+{
+    return !icon_file || (strlen(icon_file) < APP_REGISTRY_FILE_MAX && !strchr(icon_file, '/'));
+}
+
+esp_err_t app_registry_icon_load(const char* icon_file, app_registry_icon_t* out)
+{
+    if (!out) return ESP_ERR_INVALID_ARG;
+    *out = (app_registry_icon_t){ 0 };
+    if (!icon_file || !*icon_file) return ESP_OK;
+    if (!icon_file_valid(icon_file)) return ESP_ERR_INVALID_ARG;
+    return icon_load(icon_file, &out->pixels, &out->flags);
+}
+
+void app_registry_icon_free(app_registry_icon_t* icon)
+{
+    if (!icon) return;
+    heap_caps_free(icon->pixels);
+    icon->pixels = NULL;
+}
+
+esp_err_t app_registry_set(const char* app_id, const char* name, const char* icon_file, app_registry_icon_t* icon)
+{
+    if (!s_ext) return ESP_ERR_INVALID_STATE;
+    if (!app_id || !*app_id || strlen(app_id) >= APP_REGISTRY_ID_MAX ||
+        (name && strlen(name) >= APP_REGISTRY_NAME_MAX) || !icon_file_valid(icon_file)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ext_app_t* e = ext_find(app_id, app_hash(app_id, 0));
+    if (!e) {
+        for (size_t i = 0; i < APP_REGISTRY_EXT_MAX && !e; ++i) {
+            if (!s_ext[i].used) e = &s_ext[i];
+        }
+        if (!e) return ESP_ERR_NO_MEM;
+        s_ext_count++;
+    }
+
+    ext_record_t rec = { 0 };
+    snprintf(rec.id, sizeof(rec.id), "%s", app_id);
+    snprintf(rec.name, sizeof(rec.name), "%s", name ? name : "");
+    snprintf(rec.icon, sizeof(rec.icon), "%s", icon_file ? icon_file : "");
+    entry_fill(e, &rec);
+    icon_set(e, icon ? icon->pixels : NULL, icon ? icon->flags : 0);
+    if (icon) icon->pixels = NULL;
+    slots_rebuild();
+    return ESP_OK;
+}
+
+esp_err_t app_registry_remove(const char* app_id)
+{
+    if (!s_ext || !app_id) return ESP_ERR_INVALID_STATE;
+    ext_app_t* e = ext_find(app_id, app_hash(app_id, 0));
+    if (!e) return ESP_ERR_NOT_FOUND;
+    e->used = false;
+    s_ext_count--;
+    slots_rebuild();
+    return ESP_OK;
+}
+
+esp_err_t app_registry_save(void)
+{
+    if (!s_ext) return ESP_ERR_INVALID_STATE;
+    return table_save();
+}
+
+size_t app_registry_ext_count(void)
+{
+    return s_ext_count;
+}
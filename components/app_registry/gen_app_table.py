@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""
+Generate the built-in app table of components/app_registry as a perfect
+hash: every id in apps.csv lands in its own slot, so a lookup is one hash,
+one slot and one string compare.
+
+  gen_app_table.py apps.csv -o app_table.h
+
+The hash must match app_hash() in app_registry.c: FNV-1a over the
+lower-cased id, started from the basis xor a seed, with a final xor-shift.
+The script tries seeds until no two ids share a slot.
+"""
+
+import argparse
+import csv
+import sys
+
+FNV_BASIS = 0x811c9dc5
+FNV_PRIME = 0x01000193
+MAX_SEEDS = 1 << 20
+
+
+def app_hash(app_id: str, seed: int) -> int:
+    h = FNV_BASIS ^ seed
+    for b in app_id.lower().encode():
+        h = ((h ^ b) * FNV_PRIME) & 0xffffffff
+    return h ^ (h >> 15)
+
+
+def c_str(s: str) -> str:
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def load(path: str):
+    apps = []
+    seen = set()
+    with open(path, newline='') as f:
+        for row in csv.reader(f):
+            if not row or row[0].lstrip().startswith('#'):
+                continue
+            if len(row) != 3:
+                sys.exit(f"{path}: expected id,name,icon: {row}")
+            app_id, name, icon = (c.strip() for c in row)
+            if app_id.lower() in seen:
+                sys.exit(f"{path}: duplicate id {app_id}")
+            seen.add(app_id.lower())
+            apps.append((app_id, name, icon))
+    return apps
+
+
+def find_seed(apps, slots: int):
+    for seed in range(MAX_SEEDS):
+        used = set()
+        for app_id, _, _ in apps:
+            i = app_hash(app_id, seed) & (slots - 1)
+            if i in used:
+                break
+            used.add(i)
+        else:
+            return seed
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the built-in app perfect hash table")
+    parser.add_argument("csv")
+    parser.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    apps = load(args.csv)
+    slots = 8
+    while slots < len(apps) * 2:  # load factor at or below 1/2 keeps the seed search short
+        slots *= 2
+    seed = find_seed(apps, slots)
+    while seed is None:
+        slots *= 2
+        seed = find_seed(apps, slots)
+
+    table = {}
+    for app_id, name, icon in apps:
+        table[app_hash(app_id, seed) & (slots - 1)] = (app_id, name, icon)
+
+    out = [
+        "// Generated by gen_app_table.py from apps.csv, do not edit",
+        "#pragma once",
+        "",
+        f"#define APP_TABLE_SEED  0x{seed:08x}u",
+        f"#define APP_TABLE_SLOTS {slots}",
+        f"#define APP_TABLE_COUNT {len(apps)}",
+        "",
+        "static const app_builtin_t k_app_table[APP_TABLE_SLOTS] = {",
+    ]
+    for i in sorted(table):
+        app_id, name, icon = table[i]
+        out.append(f"    [{i}] = {{ {c_str(app_id)}, {c_str(name)}, {c_str(icon)} }},")
+    out.append("};")
+    with open(args.output, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Names and icons of the apps notifications come from. Built-in apps
+// (apps.csv) are a perfect hash table generated at build time; apps the
+// phone pushes are kept in an extension table on the storage partition
+// and override built-ins with the same id. Ids match case-insensitively.
+// Pushed icons are decoded to APP_REGISTRY_ICON_SIZE once, into PSRAM, so
+// a lookup never touches the filesystem.
+
+#define APP_REGISTRY_ID_MAX     64      // including the NUL
+#define APP_REGISTRY_NAME_MAX   32
+#define APP_REGISTRY_FILE_MAX   32
+#define APP_REGISTRY_EXT_MAX    48
+#define APP_REGISTRY_ICON_SIZE  48      // as shown on a notification card
+
+typedef struct {
+    const char* id;
+    const char* name;
+    const lv_image_dsc_t* icon;     // NULL = no icon
+} app_info_t;
+
+// Load the extension table from `base_dir` (NULL keeps the current one;
+// call again after the partition was formatted).
+esp_err_t app_registry_init(const char* base_dir);
+
+// App for `app_id`, or NULL if it is unknown. The pointer stays valid.
+const app_info_t* app_registry_lookup(const char* app_id);
+
+// Icon decoded for app_registry_set()
+typedef struct {
+    uint8_t* pixels;                // NULL = no icon
+    uint16_t flags;
+} app_registry_icon_t;
+
+// Decode `icon_file`, an uncompressed RGB565A8 LVGL .bin image in base_dir
+// (LVGLImage.py --ofmt BIN --cf RGB565A8), square, APP_REGISTRY_ICON_SIZE
+// times 1 to 4 pixels wide; NULL or "" gives no icon. Reads storage and
+// needs no lock. Free the result unless app_registry_set() took it.
+esp_err_t app_registry_icon_load(const char* icon_file, app_registry_icon_t* out);
+void app_registry_icon_free(app_registry_icon_t* icon);
+
+// Add or replace a pushed app in memory. It takes the pixels of `icon`
+// (NULL for none); `icon_file` is what gets decoded again at boot.
+//
+// This and app_registry_remove() may replace an icon that is on screen:
+// call them from the LVGL thread or with the display lock held. Neither
+// touches storage.
+esp_err_t app_registry_set(const char* app_id, const char* name, const char* icon_file,
+                           app_registry_icon_t* icon);
+esp_err_t app_registry_remove(const char* app_id);
+
+// Write the pushed apps to base_dir after set/remove. It reads the table
+// without the display lock, so call it from the task that changes it.
+esp_err_t app_registry_save(void);
+
+// Pushed apps
+size_t app_registry_ext_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,196 @@
+#include "assets.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+
+static const char* TAG = "ASSETS";
+
+// Bundle layout, see AssetBundle in ui_assets/LVGLImage.py
+#define ASSETS_MAGIC      0x42413353u  // "S3AB"
+#define ASSETS_VERSION    1
+#define ASSETS_KIND_IMAGE 1
+#define ASSETS_SUBTYPE    0x40
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint16_t slots;       // power of two
+    uint16_t reserved;
+    uint32_t index_size;  // slots + names, right after this header
+    uint32_t total_size;
+    uint32_t index_crc;   // esp_rom_crc32_le over the index
+} assets_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t hash;        // FNV-1a of the name
+    uint32_t name_off;    // 0 = empty slot
+    uint32_t data_off;
+    uint32_t data_size;
+    uint16_t w;
+    uint16_t h;
+    uint16_t stride;
+    uint16_t flags;       // LV_IMAGE_FLAGS_*
+    uint8_t cf;           // lv_color_format_t
+    uint8_t kind;
+    uint16_t reserved;
+} assets_slot_t;
+
+_Static_assert(sizeof(assets_header_t) == 24, "bundle header layout");
+_Static_assert(sizeof(assets_slot_t) == 28, "bundle slot layout");
+
+static const uint8_t* s_base;
+static const assets_header_t* s_hdr;
+static const assets_slot_t* s_slots;
+static lv_image_dsc_t* s_images;  // one per slot, data points into s_base
+static esp_partition_mmap_handle_t s_map;
+
+static const assets_builtin_t* s_builtin;
+static size_t s_builtin_count;
+
+static uint32_t name_hash(const char* name)
+{
+    uint32_t h = 0x811c9dc5u;
+    while (*name) {
+        h = (h ^ (uint8_t)*name++) * 0x01000193u;
+    }
+    return h;
+}
+
+static bool bundle_valid(const uint8_t* base, size_t part_size)
+{
+    const assets_header_t* hdr = (const assets_header_t*)base;
+    if (hdr->magic != ASSETS_MAGIC || hdr->version != ASSETS_VERSION) {
+        ESP_LOGE(TAG, "No asset bundle in partition (magic 0x%08lx)", (unsigned long)hdr->magic);
+        return false;
+    }
+    if (hdr->slots == 0 || (hdr->slots & (hdr->slots - 1)) || hdr->total_size > part_size ||
+        hdr->index_size < hdr->slots * sizeof(assets_slot_t) ||
+        sizeof(*hdr) + hdr->index_size > hdr->total_size) {
+        ESP_LOGE(TAG, "Asset bundle header is inconsistent");
+        return false;
+    }
+    if (esp_rom_crc32_le(0, base + sizeof(*hdr), hdr->index_size) != hdr->index_crc) {
+        ESP_LOGE(TAG, "Asset bundle index CRC mismatch");
+        return false;
+    }
+
+    const assets_slot_t* slots = (const assets_slot_t*)(base + sizeof(*hdr));
+    const size_t names_end = sizeof(*hdr) + hdr->index_size;
+    for (uint32_t i = 0; i < hdr->slots; ++i) {
+        const assets_slot_t* s = &slots[i];
+        if (s->name_off == 0) {
+            continue;
+        }
+        if (s->name_off >= names_end || !memchr(base + s->name_off, 0, names_end - s->name_off) ||
+            s->data_off > hdr->total_size || s->data_size > hdr->total_size - s->data_off) {
+            ESP_LOGE(TAG, "Asset bundle slot %lu out of range", (unsigned long)i);
+            return false;
+        }
+    }
+    return true;
+}
+
+esp_err_t assets_init(void)
+{
+#if CONFIG_ASSETS_PARTITION
+    if (s_base) {
+        return ESP_OK;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ASSETS_SUBTYPE, "assets");
+    if (!part) {
+        ESP_LOGE(TAG, "No \"assets\" partition in the partition table");
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void* base = NULL;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &base, &s_map);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map assets partition (%s)", esp_err_to_name(err));
+        return err;
+    }
+    if (!bundle_valid(base, part->size)) {
+        esp_partition_munmap(s_map);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const assets_header_t* hdr = base;
+    lv_image_dsc_t* images = heap_caps_calloc(hdr->slots, sizeof(*images), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!images) {
+        esp_partition_munmap(s_map);
+        return ESP_ERR_NO_MEM;
+    }
+
+    const assets_slot_t* slots = (const assets_slot_t*)((const uint8_t*)base + sizeof(*hdr));
+    for (uint32_t i = 0; i < hdr->slots; ++i) {
+        const assets_slot_t* s = &slots[i];
+        if (s->name_off == 0 || s->kind != ASSETS_KIND_IMAGE) {
+            continue;
+        }
+        lv_image_dsc_t* d = &images[i];
+        d->header.magic = LV_IMAGE_HEADER_MAGIC;
+        d->header.cf = s->cf;
+        d->header.flags = s->flags;
+        d->header.w = s->w;
+        d->header.h = s->h;
+        d->header.stride = s->stride;
+        d->data_size = s->data_size;
+        d->data = (const uint8_t*)base + s->data_off;
+    }
+
+    s_hdr = hdr;
+    s_slots = slots;
+    s_images = images;
+    s_base = base;
+
+    ESP_LOGI(TAG, "Mapped %u assets (%lu KB of %lu KB) in %lld us", hdr->count,
+             (unsigned long)(hdr->total_size / 1024), (unsigned long)(part->size / 1024),
+             (long long)(esp_timer_get_time() - t0));
+#endif
+    return ESP_OK;
+}
+
+void assets_register_builtin(const assets_builtin_t* table, size_t count)
+{
+    s_builtin = table;
+    s_builtin_count = count;
+}
+
+const lv_image_dsc_t* assets_image(const char* name)
+{
+    if (!name || !*name) {
+        return NULL;
+    }
+
+    if (s_base) {
+        const uint32_t h = name_hash(name);
+        const uint32_t mask = s_hdr->slots - 1;
+        for (uint32_t n = 0, i = h & mask; n < s_hdr->slots; ++n, i = (i + 1) & mask) {
+            const assets_slot_t* s = &s_slots[i];
+            if (s->name_off == 0) {
+                break;
+            }
+            if (s->hash == h && s->kind == ASSETS_KIND_IMAGE &&
+                strcmp((const char*)s_base + s->name_off, name) == 0) {
+                return &s_images[i];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < s_builtin_count; ++i) {
+        if (strcmp(s_builtin[i].name, name) == 0) {
+            return s_builtin[i].image;
+        }
+    }
+
+    ESP_LOGW(TAG, "Image \"%s\" not found", name);
+    return NULL;
+}
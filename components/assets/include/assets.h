@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Named images. With CONFIG_ASSETS_PARTITION they come from the "assets"
+// partition (a bundle written by ui_assets/LVGLImage.py --ofmt BUNDLE),
+// mapped once and never copied; otherwise from C arrays the app registers
+// with assets_register_builtin(). Callers only ever use the name.
+
+typedef struct {
+    const char* name;
+    const lv_image_dsc_t* image;
+} assets_builtin_t;
+
+#define ASSETS_BUILTIN(sym) { #sym, &sym }
+
+// Map the assets partition and check the bundle index. Safe to call twice.
+esp_err_t assets_init(void);
+
+// Fallback table consulted when a name is not in the partition.
+void assets_register_builtin(const assets_builtin_t* table, size_t count);
+
+// Descriptor for `name`, or NULL. The pointer stays valid forever, so it can
+// be handed to lv_image_set_src() and used as an LVGL cache key.
+const lv_image_dsc_t* assets_image(const char* name);
+
+#ifdef __cplusplus
+}
+#endif
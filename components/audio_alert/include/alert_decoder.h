@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Streaming decoders for alert sound files, kept free of ESP-IDF so
+// host/audio_bench can run them. Memory depends on the format, never on
+// the length of the file:
+//
+// - WAV, 16-bit PCM: nothing beyond the stdio buffer
+// - WAV, IMA ADPCM (format 0x11): one block, usually 256-1024 bytes per
+//   channel, and its decoded samples
+// - MP3 (built with ALERT_DECODER_MP3): the minimp3 state, a 4 KB input
+//   window and one frame of samples, about 29 KB in all
+//
+// Output is interleaved 16-bit PCM at the file's own rate and channels.
+
+typedef enum {
+    ALERT_FMT_PCM,
+    ALERT_FMT_ADPCM,
+    ALERT_FMT_MP3,
+} alert_fmt_t;
+
+typedef struct {
+    alert_fmt_t fmt;
+    int sample_rate;
+    int channels;                   // 1 or 2
+    size_t mem_bytes;               // decoder's own allocations; stdio's buffer not counted
+} alert_dec_info_t;
+
+typedef struct alert_dec alert_dec_t;
+
+// NULL when the file is missing, in a format not listed above, or there
+// is no memory. The format comes from the contents, not the name.
+alert_dec_t* alert_dec_open(const char* path, alert_dec_info_t* info);
+
+// Up to `max_frames` frames into `pcm`; 0 at the end of the stream
+size_t alert_dec_read(alert_dec_t* dec, int16_t* pcm, size_t max_frames);
+
+void alert_dec_close(alert_dec_t* dec);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,15 +1,65 @@
 #pragma once
+#include <stdint.h>
 #include "esp_err.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Alert sounds play on a dedicated audio task. Requests go through a short
+// queue and callers return right away. A request for a sound that is
+// already queued or playing is merged into it, so a burst of notifications
+// plays one chime. A higher priority request cuts the current sound short.
+
+typedef enum {
+    AUDIO_ALERT_SOUND_NOTIFY,       // notification chime
+    AUDIO_ALERT_SOUND_STARTUP,      // boot tone
+    AUDIO_ALERT_SOUND_COUNT
+} audio_alert_sound_t;
+
+typedef enum {
+    AUDIO_ALERT_PRIO_LOW,
+    AUDIO_ALERT_PRIO_NORMAL,
+    AUDIO_ALERT_PRIO_HIGH,          // user asked for it (sound test)
+} audio_alert_prio_t;
+
+typedef struct {
+    uint32_t requests;
+    uint32_t played;
+    uint32_t merged;                // folded into a queued or playing request
+    uint32_t dropped;               // queue full
+    uint32_t preempted;             // cut short by a higher priority request
+    uint32_t cancelled;             // by audio_alert_stop()
+    uint32_t enqueue_us_max;        // time spent in audio_alert_play()
+    uint64_t enqueue_us_total;
+    // Sounds are decoded or synthesized once into PSRAM
+    uint32_t cache_fills;
+    uint32_t cache_bytes;
+    // Request to first sample written to the codec, queue wait included.
+    // Cold: the last play that had to decode first. Warm: served from PSRAM.
+    uint32_t first_write_cold_us;
+    uint32_t first_write_warm_us;
+    uint32_t first_write_warm_us_max;
+    uint32_t power_ups;             // codec opened and PA on after an idle timeout
+} audio_alert_stats_t;
+
+// Start the audio task; the codec is brought up on it. Safe to call twice.
 esp_err_t audio_alert_init(void);
+
+// Queue `sound`. ESP_ERR_NO_MEM when the queue is full (counted as dropped),
+// ESP_ERR_INVALID_STATE before audio_alert_init().
+esp_err_t audio_alert_play(audio_alert_sound_t sound, audio_alert_prio_t prio);
+
+// Notification chime, if sound is enabled in the settings
 void audio_alert_notify(void);
-// Schedule a one-shot startup tone after boot, with a short delay
-// to allow the codec/PA to settle and avoid first-play clicks.
+
+// Stop the current sound and forget queued ones
+void audio_alert_stop(void);
+
+// Startup tone, played once the codec has settled after boot
 void audio_alert_play_startup(void);
 
+void audio_alert_get_stats(audio_alert_stats_t* out);
+
 #ifdef __cplusplus
 }
 #endif
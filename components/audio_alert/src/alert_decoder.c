@@ -0,0 +1,307 @@
+#include "alert_decoder.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if ALERT_DECODER_MP3
+#include "minimp3.h"
+#endif
+
+#define WAV_FMT_PCM     0x0001
+#define WAV_FMT_IMA     0x0011
+#define MP3_IN_BYTES    4096
+
+struct alert_dec {
+    FILE* f;
+    alert_dec_info_t info;
+    uint32_t remaining;             // WAV data bytes not read yet
+    // Decoded samples of the current ADPCM block or MP3 frame
+    int16_t* pcm;
+    size_t pcm_frames;
+    size_t pcm_pos;
+    // ADPCM
+    uint8_t* block;
+    uint16_t block_align;
+#if ALERT_DECODER_MP3
+    mp3dec_t* mp3;
+    uint8_t* in;
+    size_t in_len;
+    bool eof;
+#endif
+};
+
+static uint16_t rd16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void* dec_alloc(alert_dec_t* d, size_t bytes)
+{
+    void* p = malloc(bytes);
+    if (p) d->info.mem_bytes += bytes;
+    return p;
+}
+
+// ---- WAV -----------------------------------------------------------------
+
+// Walks the chunks after "RIFF....WAVE" up to "data"
+static bool wav_open(alert_dec_t* d)
+{
+    uint8_t fmt[20] = { 0 };
+    bool have_fmt = false;
+    for (;;) {
+        uint8_t hdr[8];
+        if (fread(hdr, 1, sizeof(hdr), d->f) != sizeof(hdr)) return false;
+        const uint32_t size = rd32(hdr + 4);
+        if (memcmp(hdr, "fmt ", 4) == 0) {
+            const size_t n = size < sizeof(fmt) ? size : sizeof(fmt);
+            if (n < 16 || fread(fmt, 1, n, d->f) != n) return false;
+            if (fseek(d->f, (long)(size - n + (size & 1)), SEEK_CUR) != 0) return false;
+            have_fmt = true;
+        } else if (memcmp(hdr, "data", 4) == 0) {
+            d->remaining = size;
+            break;
+        } else if (fseek(d->f, (long)(size + (size & 1)), SEEK_CUR) != 0) {
+            return false;
+        }
+    }
+    if (!have_fmt) return false;
+
+    const uint16_t tag = rd16(fmt);
+    const uint16_t channels = rd16(fmt + 2);
+    const uint16_t bits = rd16(fmt + 14);
+    if (channels != 1 && channels != 2) return false;
+    d->info.sample_rate = (int)rd32(fmt + 4);
+    d->info.channels = channels;
+    if (d->info.sample_rate <= 0) return false;
+
+    if (tag == WAV_FMT_PCM && bits == 16) {
+        d->info.fmt = ALERT_FMT_PCM;
+        return true;
+    }
+    if (tag == WAV_FMT_IMA && bits == 4) {
+        d->block_align = rd16(fmt + 12);
+        if (d->block_align <= 4 * channels) return false;
+        const size_t frames = (size_t)(d->block_align - 4 * channels) * 2 / channels + 1;
+        d->info.fmt = ALERT_FMT_ADPCM;
+        d->block = dec_alloc(d, d->block_align);
+        d->pcm = dec_alloc(d, frames * channels * sizeof(int16_t));
+        return d->block && d->pcm;
+    }
+    return false;
+}
+
+static const int16_t k_ima_step[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8_t k_ima_index[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static int16_t ima_step(int* pred, int* index, unsigned nibble)
+{
+    const int step = k_ima_step[*index];
+    int diff = step >> 3;
+    if (nibble & 1) diff += step >> 2;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 4) diff += step;
+    int p = (nibble & 8) ? *pred - diff : *pred + diff;
+    if (p > 32767) p = 32767;
+    if (p < -32768) p = -32768;
+    int i = *index + k_ima_index[nibble];
+    if (i < 0) i = 0;
+    if (i > 88) i = 88;
+    *pred = p;
+    *index = i;
+    return (int16_t)p;
+}
+
+// One block: a 4-byte header per channel (first sample, step index), then
+// groups of 4 bytes per channel holding 8 samples each, low nibble first
+static bool adpcm_next_block(alert_dec_t* d)
+{
+    const int ch = d->info.channels;
+    size_t len = d->block_align < d->remaining ? d->block_align : d->remaining;
+    len = fread(d->block, 1, len, d->f);
+    d->remaining -= (uint32_t)len;
+    if (len <= (size_t)(4 * ch)) return false;
+
+    int pred[2], index[2];
+    for (int c = 0; c < ch; ++c) {
+        const uint8_t* h = d->block + 4 * c;
+        pred[c] = (int16_t)rd16(h);
+        index[c] = h[2] > 88 ? 88 : h[2];
+        d->pcm[c] = (int16_t)pred[c];
+    }
+    const size_t frames = (len - 4 * ch) / (4 * ch) * 8 + 1;
+    const uint8_t* p = d->block + 4 * ch;
+    for (size_t i = 1; i < frames; i += 8) {
+        for (int c = 0; c < ch; ++c, p += 4) {
+            for (int k = 0; k < 8; ++k) {
+                const unsigned nibble = (p[k >> 1] >> ((k & 1) * 4)) & 0x0f;
+                d->pcm[(i + k) * ch + c] = ima_step(&pred[c], &index[c], nibble);
+            }
+        }
+    }
+    d->pcm_frames = frames;
+    d->pcm_pos = 0;
+    return true;
+}
+
+// ---- MP3 -----------------------------------------------------------------
+
+#if ALERT_DECODER_MP3
+static void mp3_skip_id3(alert_dec_t* d)
+{
+    uint8_t h[10];
+    rewind(d->f);
+    if (fread(h, 1, sizeof(h), d->f) == sizeof(h) && memcmp(h, "ID3", 3) == 0) {
+        // Syncsafe size, plus the footer when the flags say there is one
+        uint32_t size = (uint32_t)(h[6] & 0x7f) << 21 | (uint32_t)(h[7] & 0x7f) << 14 |
+                        (uint32_t)(h[8] & 0x7f) << 7 | (h[9] & 0x7f);
+        if (h[5] & 0x10) size += 10;
+        if (fseek(d->f, (long)(10 + size), SEEK_SET) == 0) return;
+    }
+    rewind(d->f);
+}
+
+// Decode the next frame into d->pcm, at the channel count of the first one
+static bool mp3_next_frame(alert_dec_t* d)
+{
+    for (;;) {
+        if (d->in_len < MP3_IN_BYTES && !d->eof) {
+            const size_t want = MP3_IN_BYTES - d->in_len;
+            const size_t n = fread(d->in + d->in_len, 1, want, d->f);
+            d->in_len += n;
+            if (n < want) d->eof = true;
+        }
+        if (!d->in_len) return false;
+
+        mp3dec_frame_info_t fi;
+        const int samples = mp3dec_decode_frame(d->mp3, d->in, (int)d->in_len, d->pcm, &fi);
+        size_t used = (size_t)fi.frame_bytes;
+        if (!used) {
+            // No frame in a full window is garbage; at the end it is a tail
+            if (d->eof) return false;
+            used = d->in_len;
+        }
+        if (used > d->in_len) used = d->in_len;
+        d->in_len -= used;
+        memmove(d->in, d->in + used, d->in_len);
+        if (samples <= 0) continue;
+
+        if (!d->info.channels) {
+            d->info.channels = fi.channels;
+            d->info.sample_rate = fi.hz;
+        }
+        if (fi.channels != d->info.channels) {
+            // Mono and stereo frames in one stream: follow the first frame
+            if (fi.channels == 2) {
+                for (int i = 0; i < samples; ++i) {
+                    d->pcm[i] = (int16_t)(((int32_t)d->pcm[2 * i] + d->pcm[2 * i + 1]) >> 1);
+                }
+            } else {
+                for (int i = samples - 1; i >= 0; --i) d->pcm[2 * i] = d->pcm[2 * i + 1] = d->pcm[i];
+            }
+        }
+        d->pcm_frames = (size_t)samples;
+        d->pcm_pos = 0;
+        return true;
+    }
+}
+
+static bool mp3_open(alert_dec_t* d)
+{
+    d->info.fmt = ALERT_FMT_MP3;
+    d->mp3 = dec_alloc(d, sizeof(mp3dec_t));
+    d->in = dec_alloc(d, MP3_IN_BYTES);
+    d->pcm = dec_alloc(d, MINIMP3_MAX_SAMPLES_PER_FRAME * sizeof(int16_t));
+    if (!d->mp3 || !d->in || !d->pcm) return false;
+    mp3dec_init(d->mp3);
+    mp3_skip_id3(d);
+    // The first frame gives the rate and channels
+    return mp3_next_frame(d) && d->info.sample_rate > 0;
+}
+#endif
+
+// ---- API -----------------------------------------------------------------
+
+alert_dec_t* alert_dec_open(const char* path, alert_dec_info_t* info)
+{
+    alert_dec_t* d = calloc(1, sizeof(*d));
+    if (!d) return NULL;
+    d->info.mem_bytes = sizeof(*d);
+    d->f = fopen(path, "rb");
+    uint8_t magic[12];
+    bool ok = d->f && fread(magic, 1, sizeof(magic), d->f) == sizeof(magic);
+    if (ok && memcmp(magic, "RIFF", 4) == 0 && memcmp(magic + 8, "WAVE", 4) == 0) {
+        ok = wav_open(d);
+    } else {
+#if ALERT_DECODER_MP3
+        ok = ok && (memcmp(magic, "ID3", 3) == 0 || (magic[0] == 0xff && (magic[1] & 0xe0) == 0xe0)) && mp3_open(d);
+#else
+        ok = false;
+#endif
+    }
+    if (!ok) {
+        alert_dec_close(d);
+        return NULL;
+    }
+    if (info) *info = d->info;
+    return d;
+}
+
+size_t alert_dec_read(alert_dec_t* d, int16_t* pcm, size_t max_frames)
+{
+    if (!d) return 0;
+    const size_t ch = (size_t)d->info.channels;
+    if (d->info.fmt == ALERT_FMT_PCM) {
+        size_t bytes = max_frames * ch * sizeof(int16_t);
+        if (bytes > d->remaining) bytes = d->remaining;
+        const size_t frames = fread(pcm, 1, bytes, d->f) / (ch * sizeof(int16_t));
+        d->remaining -= (uint32_t)(frames * ch * sizeof(int16_t));
+        return frames;
+    }
+    size_t out = 0;
+    while (out < max_frames) {
+        if (d->pcm_pos == d->pcm_frames) {
+            bool more = false;
+            if (d->info.fmt == ALERT_FMT_ADPCM) {
+                more = d->remaining && adpcm_next_block(d);
+            }
+#if ALERT_DECODER_MP3
+            if (d->info.fmt == ALERT_FMT_MP3) more = mp3_next_frame(d);
+#endif
+            if (!more) break;
+        }
+        size_t n = d->pcm_frames - d->pcm_pos;
+        if (n > max_frames - out) n = max_frames - out;
+        memcpy(pcm + out * ch, d->pcm + d->pcm_pos * ch, n * ch * sizeof(int16_t));
+        d->pcm_pos += n;
+        out += n;
+    }
+    return out;
+}
+
+void alert_dec_close(alert_dec_t* d)
+{
+    if (!d) return;
+    if (d->f) fclose(d->f);
+    free(d->pcm);
+    free(d->block);
+#if ALERT_DECODER_MP3
+    free(d->mp3);
+    free(d->in);
+#endif
+    free(d);
+}
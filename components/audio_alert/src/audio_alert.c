@@ -1,23 +1,102 @@
 #include "audio_alert.h"
+#include "alert_decoder.h"
+#include "boot_seq.h"
 #include <math.h>
 #include <string.h>
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "esp_codec_dev.h"
 #include "settings.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "freertos/task.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 
 static const char* TAG = "AUDIO_ALERT";
 
+#define AUDIO_QUEUE_LEN     8
+#define AUDIO_TASK_STACK    6144
+#define AUDIO_TASK_PRIO     5       // above the UI: it mostly waits on the DMA ring, and underruns are audible
+#define AUDIO_SETTLE_MS     400     // after codec bring-up, avoids first-play clicks
+#define AUDIO_CHUNK_BYTES   512     // per codec write; stop requests are seen between chunks
+#define AUDIO_DRAIN_MS      80      // I2S DMA ring still playing after the last write
+#define AUDIO_OUT_RATE      CONFIG_AUDIO_ALERT_SAMPLE_RATE
+#define AUDIO_PA_IDLE_MS    CONFIG_AUDIO_ALERT_PA_IDLE_MS
+#define AUDIO_CACHE_MAX     (512 * 1024) // converted bytes; longer sounds stream from flash
+
+typedef struct {
+    uint8_t sound;
+    uint8_t prio;
+    uint32_t gen;                   // s_cancel_gen when queued
+    int64_t t_us;                   // when it was queued
+} audio_req_t;
+
+typedef enum { PLAY_DONE, PLAY_FAILED, PLAY_PREEMPTED, PLAY_CANCELLED } play_result_t;
+
+// A sound decoded once into PSRAM, already at the output format
+typedef struct {
+    int16_t* pcm;
+    size_t bytes;
+    const char* src_path;           // source file, to notice a new upload
+    off_t src_size;
+    time_t src_mtime;
+} clip_t;
+
+typedef enum { SRC_MISSING, SRC_CACHED, SRC_STREAM } src_state_t;
+
+// The first one present is played
+static const char* const k_notify_files[] = {
+#if ALERT_DECODER_MP3
+    "/spiffs/notification.mp3",
+#endif
+    "/spiffs/notification.wav",     // 16-bit PCM or IMA ADPCM
+};
+
+// Linear-interpolating resampler to AUDIO_OUT_RATE, stereo folded to mono.
+// Keeps its position across blocks, so streamed files convert the same way.
+typedef struct {
+    uint32_t step;                  // input frames per output frame, 16.16
+    uint32_t frac;                  // position past `prev`, 16.16
+    int32_t prev;
+    int ch;
+} conv_t;
+
 static esp_codec_dev_handle_t s_spk = NULL;
 static bool s_ready = false;
-static bool s_open = false;
+static bool s_open = false;          // opened at the output format, unmuted, PA on
+static int s_volume = -1;
+static int64_t s_idle_since;        // end of the last sound
 
-esp_err_t audio_alert_init(void)
+static QueueHandle_t s_queue;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+// Under s_lock
+static uint32_t s_pending;          // sounds in the queue or backlog, one bit each
+static int s_playing = -1;          // sound on the codec
+static int s_playing_prio;
+static uint32_t s_cancel_gen;
+static audio_alert_stats_t s_stats;
+
+// Audio task only
+static audio_req_t s_backlog[AUDIO_QUEUE_LEN];
+static size_t s_backlog_len;
+static audio_req_t s_cur;
+static play_result_t s_stop_reason;
+static bool s_cold;                 // this play had to fill the cache or power up
+static bool s_first_write;
+
+static clip_t s_file_clip;          // one of k_notify_files
+static clip_t s_chime_clip;         // synthesized fallback
+static src_state_t s_file_state;
+static const char* s_file_path;
+static uint32_t s_file_gen;         // storage generation when the files were last stat'ed
+static bool s_file_checked;
+
+static esp_err_t codec_init(void)
 {
     if (s_ready) return ESP_OK;
     s_spk = bsp_audio_codec_speaker_init();
@@ -33,179 +112,307 @@ esp_err_t audio_alert_init(void)
     return ESP_OK;
 }
 
-static void play_pcm_16_mono_22k(const int16_t* pcm, size_t samples)
+// Move whatever was queued meanwhile into the backlog
+static void backlog_fill(TickType_t wait)
 {
-    if (!s_ready && audio_alert_init() != ESP_OK) return;
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = 22050,
-        .channel = 1,
-        .bits_per_sample = 16,
-    };
-    int vol = (int)settings_get_notify_volume();
-    if (vol < 0) vol = 0;
-    if (vol > 100) vol = 100;
-    esp_codec_dev_set_out_vol(s_spk, vol);
-    if (!s_open) {
-        if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) return;
-        s_open = true;
+    while (s_backlog_len < AUDIO_QUEUE_LEN &&
+           xQueueReceive(s_queue, &s_backlog[s_backlog_len], s_backlog_len ? 0 : wait) == pdTRUE) {
+        s_backlog_len++;
     }
-    // Give codec/PA a short settle time before streaming to avoid pops
-    vTaskDelay(pdMS_TO_TICKS(20));
-    // Ensure unmuted for playback
-    (void)esp_codec_dev_set_out_mute(s_spk, false);
+}
 
-    // Write a short block of silence first to avoid initial click/pop
-    enum { ZERO_PAD_SAMP = 1024 }; // ~46ms at 22.05kHz
-    int16_t zero_pad[ZERO_PAD_SAMP] = {0};
-    (void)esp_codec_dev_write(s_spk, (void*)zero_pad, sizeof(zero_pad));
-
-    // Stream in small chunks to ensure DMA feed
-    const size_t chunk_samp = 256;
-    size_t written = 0;
-    while (written < samples) {
-        size_t n = samples - written;
-        if (n > chunk_samp) n = chunk_samp;
-        (void)esp_codec_dev_write(s_spk, (void*)(pcm + written), n * sizeof(int16_t));
-        written += n;
+// Checked between chunks: true when the current sound has to give way
+static bool stop_requested(void)
+{
+    backlog_fill(0);
+    portENTER_CRITICAL(&s_lock);
+    const uint32_t gen = s_cancel_gen;
+    portEXIT_CRITICAL(&s_lock);
+    if (gen != s_cur.gen) {
+        s_stop_reason = PLAY_CANCELLED;
+        return true;
+    }
+    for (size_t i = 0; i < s_backlog_len; ++i) {
+        if (s_backlog[i].gen == gen && s_backlog[i].prio > s_cur.prio) {
+            s_stop_reason = PLAY_PREEMPTED;
+            return true;
+        }
     }
+    return false;
+}
 
-    // Add a short tail of silence to ensure clean ramp-down
-    (void)esp_codec_dev_write(s_spk, (void*)zero_pad, sizeof(zero_pad));
+// Request to first sample handed to the codec, queue wait included
+static void note_first_write(void)
+{
+    const uint32_t us = (uint32_t)(esp_timer_get_time() - s_cur.t_us);
+    portENTER_CRITICAL(&s_lock);
+    if (s_cold) {
+        s_stats.first_write_cold_us = us;
+    } else {
+        s_stats.first_write_warm_us = us;
+        if (us > s_stats.first_write_warm_us_max) s_stats.first_write_warm_us_max = us;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
 
-    // Wait for audio to drain before closing (approximate duration)
-    uint32_t total_samples = samples + (2 * ZERO_PAD_SAMP);
-    uint32_t ms = (uint32_t)((total_samples * 1000UL) / (fs.sample_rate));
-    vTaskDelay(pdMS_TO_TICKS(ms + 10));
-    // Optionally mute between alerts to avoid residual noise; keep stream open
-    (void)esp_codec_dev_set_out_mute(s_spk, true);
+static bool codec_write(const void* data, size_t bytes)
+{
+    const uint8_t* p = data;
+    while (bytes) {
+        if (stop_requested()) return false;
+        size_t n = bytes < AUDIO_CHUNK_BYTES ? bytes : AUDIO_CHUNK_BYTES;
+        if (!s_first_write) {
+            s_first_write = true;
+            note_first_write();
+        }
+        if (esp_codec_dev_write(s_spk, (void*)p, n) != ESP_OK) return false;
+        p += n;
+        bytes -= n;
+    }
+    return true;
 }
 
-static bool play_pcm_stream_i16(const int16_t* pcm, size_t samples, int sample_rate, int channels)
+static void codec_set_volume(void)
 {
-    if (!s_ready && audio_alert_init() != ESP_OK) return false;
-    if (channels != 1 && channels != 2) channels = 1;
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = sample_rate,
-        .channel = channels,
-        .bits_per_sample = 16,
-    };
     int vol = (int)settings_get_notify_volume();
     if (vol < 0) vol = 0;
     if (vol > 100) vol = 100;
-    esp_codec_dev_set_out_vol(s_spk, vol);
+    if (vol == s_volume) return;
+    if (esp_codec_dev_set_out_vol(s_spk, vol) == ESP_OK) s_volume = vol;
+}
 
-    if (s_open) {
-        (void)esp_codec_dev_close(s_spk);
-        s_open = false;
-    }
+// Every sound is converted to this one format, so the codec is opened once
+// per power-up and never reopened between alerts
+static bool codec_power_up(void)
+{
+    if (s_open) return true;
+    if (codec_init() != ESP_OK) return false;
+    esp_codec_dev_sample_info_t fs = {
+        .sample_rate = AUDIO_OUT_RATE,
+        .channel = 1,
+        .bits_per_sample = 16,
+    };
     if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) return false;
     s_open = true;
-    // simple settle and unmute
-    vTaskDelay(pdMS_TO_TICKS(10));
+    s_cold = true;
+    s_volume = -1;
+    // Give codec/PA a short settle time before streaming to avoid pops
+    vTaskDelay(pdMS_TO_TICKS(20));
     (void)esp_codec_dev_set_out_mute(s_spk, false);
+    portENTER_CRITICAL(&s_lock);
+    s_stats.power_ups++;
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
 
-    const size_t chunk_samp = 256 * channels; // interleaved frames
-    size_t written = 0;
-    while (written < samples) {
-        size_t n = samples - written;
-        if (n > chunk_samp) n = chunk_samp;
-        if (esp_codec_dev_write(s_spk, (void*)(pcm + written), n * sizeof(int16_t)) != ESP_OK) break;
-        written += n;
-    }
+// After AUDIO_PA_IDLE_MS without a sound. The I2S channel clears its DMA
+// buffers once writes stop, so an open codec between alerts plays silence;
+// closing it disables the codec and with it the PA.
+static void codec_power_down(void)
+{
+    if (!s_open) return;
+    vTaskDelay(pdMS_TO_TICKS(AUDIO_DRAIN_MS));
     (void)esp_codec_dev_set_out_mute(s_spk, true);
-    return true;
+    (void)esp_codec_dev_close(s_spk);
+    s_open = false;
 }
 
-static bool play_wav_from_spiffs(const char *path)
+static void conv_init(conv_t* c, int rate, int ch)
 {
-    // Minimal WAV parser for PCM 16-bit LE mono/stereo
-    struct stat st;
-    if (stat(path, &st) != 0 || st.st_size <= 44) return false;
-    FILE *f = fopen(path, "rb");
-    if (!f) return false;
-    unsigned char hdr[44];
-    size_t n = fread(hdr, 1, sizeof(hdr), f);
-    if (n != sizeof(hdr)) { fclose(f); return false; }
-    if (memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0) { fclose(f); return false; }
-    // parse fmt chunk
-    // Assuming standard layout: fmt chunk at 12, data chunk at or after 36
-    uint16_t audio_format = *(uint16_t*)(hdr + 20);
-    uint16_t num_channels = *(uint16_t*)(hdr + 22);
-    uint32_t sample_rate  = *(uint32_t*)(hdr + 24);
-    uint16_t bits_per_spl = *(uint16_t*)(hdr + 34);
-    if (audio_format != 1 || (num_channels != 1 && num_channels != 2) || bits_per_spl != 16) {
-        fclose(f);
-        return false;
+    c->step = (uint32_t)(((uint64_t)rate << 16) / AUDIO_OUT_RATE);
+    c->frac = 0;
+    c->prev = 0;
+    c->ch = ch;
+}
+
+// Upper bound on the output frames for `in_frames` input frames
+static size_t conv_max_out(const conv_t* c, size_t in_frames)
+{
+    return (size_t)(((uint64_t)in_frames << 16) / c->step) + 1;
+}
+
+static size_t conv_run(conv_t* c, const int16_t* in, size_t in_frames, int16_t* out)
+{
+    if (c->step == 0x10000 && c->ch == 1) {
+        memcpy(out, in, in_frames * sizeof(int16_t));
+        return in_frames;
     }
-    // Find data chunk (handle potential extra fmt bytes)
-    uint32_t data_offset = 12;
-    uint32_t data_size = 0;
-    for (;;) {
-        if (fseek(f, data_offset, SEEK_SET) != 0) { fclose(f); return false; }
-        unsigned char chunk[8];
-        if (fread(chunk, 1, 8, f) != 8) { fclose(f); return false; }
-        uint32_t sz = *(uint32_t*)(chunk + 4);
-        if (memcmp(chunk, "data", 4) == 0) { data_size = sz; data_offset += 8; break; }
-        data_offset += 8 + sz;
-        if (data_offset + 8 > (uint32_t)st.st_size) { fclose(f); return false; }
+    size_t n = 0;
+    for (size_t i = 0; i < in_frames; ++i) {
+        const int32_t x = c->ch == 2 ? ((int32_t)in[2 * i] + in[2 * i + 1]) >> 1 : in[i];
+        while (c->frac < 0x10000) {
+            out[n++] = (int16_t)(c->prev + (((x - c->prev) * (int32_t)(c->frac >> 1)) >> 15));
+            c->frac += c->step;
+        }
+        c->frac -= 0x10000;
+        c->prev = x;
     }
-    if (fseek(f, data_offset, SEEK_SET) != 0) { fclose(f); return false; }
+    return n;
+}
 
-    // Open codec with WAV format
-    esp_codec_dev_sample_info_t fs = {
-        .sample_rate = (int)sample_rate,
-        .channel = (int)num_channels,
-        .bits_per_sample = 16,
-    };
-    int vol = (int)settings_get_notify_volume();
-    if (vol < 0) vol = 0;
-    if (vol > 100) vol = 100;
-    esp_codec_dev_set_out_vol(s_spk, vol);
-    if (s_open) {
-        (void)esp_codec_dev_close(s_spk);
-        s_open = false;
-    }
-    if (esp_codec_dev_open(s_spk, &fs) != ESP_OK) { fclose(f); return false; }
-    s_open = true;
-    vTaskDelay(pdMS_TO_TICKS(10));
-    (void)esp_codec_dev_set_out_mute(s_spk, false);
+static void note_cache_bytes(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_stats.cache_bytes = s_file_clip.bytes + s_chime_clip.bytes;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void clip_free(clip_t* c)
+{
+    if (!c->pcm) return;
+    heap_caps_free(c->pcm);
+    memset(c, 0, sizeof(*c));
+    note_cache_bytes();
+}
+
+static int16_t* clip_alloc(clip_t* c, size_t bytes)
+{
+    c->pcm = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    c->bytes = c->pcm ? bytes : 0;
+    return c->pcm;
+}
+
+static void note_fill(const clip_t* c, int64_t t0)
+{
+    s_cold = true;
+    ESP_LOGI(TAG, "cached %u bytes in %u us", (unsigned)c->bytes, (unsigned)(esp_timer_get_time() - t0));
+    portENTER_CRITICAL(&s_lock);
+    s_stats.cache_fills++;
+    portEXIT_CRITICAL(&s_lock);
+    note_cache_bytes();
+}
+
+static bool play_clip(const clip_t* c)
+{
+    if (!codec_power_up()) return false;
+    codec_set_volume();
+    return codec_write(c->pcm, c->bytes);
+}
 
-    enum { BUF_SAMP = 1024*2 };
-    int16_t *buf = (int16_t*)malloc(BUF_SAMP * sizeof(int16_t));
-    if (!buf) { fclose(f); return false; }
-    size_t remaining = data_size;
-    while (remaining > 0) {
-        size_t to_read_bytes = BUF_SAMP * sizeof(int16_t);
-        if (to_read_bytes > remaining) to_read_bytes = remaining;
-        size_t rn = fread(buf, 1, to_read_bytes, f);
-        if (rn == 0) break;
-        remaining -= rn;
-        (void)esp_codec_dev_write(s_spk, buf, rn);
+// Decode and convert in blocks into a PSRAM buffer that grows as needed.
+// Sounds longer than AUDIO_CACHE_MAX once converted, or no PSRAM, still
+// play by streaming; a file we cannot decode does not.
+static src_state_t file_load(clip_t* c, const char* path, const struct stat* st)
+{
+    enum { BUF_FRAMES = 1024 };
+    const int64_t t0 = esp_timer_get_time();
+    alert_dec_info_t info;
+    alert_dec_t* dec = alert_dec_open(path, &info);
+    if (!dec) return SRC_MISSING;
+    conv_t cv;
+    conv_init(&cv, info.sample_rate, info.channels);
+    int16_t* buf = malloc(BUF_FRAMES * info.channels * sizeof(int16_t));
+    // First guess from the file size: 4 samples per byte for ADPCM
+    size_t cap = (size_t)st->st_size * (info.fmt == ALERT_FMT_PCM ? 1 : 4);
+    if (cap < 4096) cap = 4096;
+    src_state_t r = buf ? SRC_CACHED : SRC_STREAM;
+    size_t out = 0;
+    size_t n;
+    while (r == SRC_CACHED && (n = alert_dec_read(dec, buf, BUF_FRAMES)) > 0) {
+        const size_t need = (out + conv_max_out(&cv, n)) * sizeof(int16_t);
+        if (need > c->bytes) {
+            while (cap < need) cap *= 2;
+            if (cap > AUDIO_CACHE_MAX) cap = AUDIO_CACHE_MAX;
+            int16_t* p = cap >= need ? heap_caps_realloc(c->pcm, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : NULL;
+            if (!p) {
+                r = SRC_STREAM;
+                break;
+            }
+            c->pcm = p;
+            c->bytes = cap;
+        }
+        out += conv_run(&cv, buf, n, c->pcm + out);
     }
     free(buf);
-    fclose(f);
-    (void)esp_codec_dev_set_out_mute(s_spk, true);
-    return true;
+    alert_dec_close(dec);
+    if (r == SRC_CACHED && !out) r = SRC_MISSING;
+    if (r != SRC_CACHED) {
+        clip_free(c);
+        return r;
+    }
+    int16_t* fit = heap_caps_realloc(c->pcm, out * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (fit) c->pcm = fit;
+    c->bytes = out * sizeof(int16_t);
+    c->src_path = path;
+    c->src_size = st->st_size;
+    c->src_mtime = st->st_mtime;
+    note_fill(c, t0);
+    return SRC_CACHED;
 }
 
-void audio_alert_notify(void)
+// Which notification file to play. Files are only stat'ed again after a
+// file on the storage partition was created, replaced or removed, and only
+// re-read when the chosen one changed size or mtime.
+static src_state_t file_lookup(void)
 {
-    if (!settings_get_sound()) return;
-    // 1) Try to play preloaded file from SPIFFS (prefer notify.wav for now)
-    if (play_wav_from_spiffs("/spiffs/notification.wav")) {
-        return;
+    const uint32_t gen = settings_storage_generation();
+    if (s_file_checked && gen == s_file_gen) return s_file_state;
+    s_file_checked = true;
+    s_file_gen = gen;
+
+    for (size_t i = 0; i < sizeof(k_notify_files) / sizeof(k_notify_files[0]); ++i) {
+        const char* path = k_notify_files[i];
+        struct stat st;
+        if (stat(path, &st) != 0) continue;
+        s_file_path = path;
+        if (s_file_clip.pcm && s_file_clip.src_path == path && st.st_size == s_file_clip.src_size &&
+            st.st_mtime == s_file_clip.src_mtime) {
+            return s_file_state = SRC_CACHED;
+        }
+        clip_free(&s_file_clip);
+        if (st.st_size > AUDIO_CACHE_MAX) return s_file_state = SRC_STREAM;
+        s_file_state = file_load(&s_file_clip, path, &st);
+        if (s_file_state != SRC_MISSING) return s_file_state;
     }
-    ESP_LOGI(TAG, "notification.wav not found, using synthesized tone");
-    // Synthesize a bell-like "Dong": low base + partials, short pitch glide, multi-stage decay
-    enum { SR = 22050 };
+    clip_free(&s_file_clip);
+    return s_file_state = SRC_MISSING;
+}
+
+// Decode as we go: memory is the decoder's plus two blocks, whatever the
+// length of the file
+static bool play_file_stream(const char *path)
+{
+    enum { BUF_FRAMES = 1024 };
+    alert_dec_info_t info;
+    alert_dec_t* dec = alert_dec_open(path, &info);
+    if (!dec) return false;
+    if (!codec_power_up()) {
+        alert_dec_close(dec);
+        return false;
+    }
+    codec_set_volume();
+
+    // The I2S driver copies each write into its DMA ring and returns, so the
+    // next block is decoded while the previous ones play
+    conv_t cv;
+    conv_init(&cv, info.sample_rate, info.channels);
+    int16_t *buf = (int16_t*)malloc(BUF_FRAMES * info.channels * sizeof(int16_t));
+    int16_t *out = (int16_t*)malloc(conv_max_out(&cv, BUF_FRAMES) * sizeof(int16_t));
+    const bool ok = buf && out;
+    if (ok) {
+        size_t n;
+        while ((n = alert_dec_read(dec, buf, BUF_FRAMES)) > 0) {
+            if (!codec_write(out, conv_run(&cv, buf, n, out) * sizeof(int16_t))) break;
+        }
+    }
+    free(out);
+    free(buf);
+    alert_dec_close(dec);
+    // A stopped sound still counts as handled: no synthesized fallback
+    return ok;
+}
+
+// Synthesize a bell-like "Dong": low base + partials, short pitch glide,
+// multi-stage decay, straight at the output rate
+static bool chime_synth(clip_t* c)
+{
+    const int64_t t0 = esp_timer_get_time();
+    enum { SR = AUDIO_OUT_RATE };
     const float base_f = 440.0f;     // base pitch, slightly lower for deeper "Dong"
     const float dur_s  = 0.32f;      // overall duration
-    size_t N = (size_t)(SR * dur_s);
-    static int16_t buf[8192];
-    size_t max_samples = sizeof(buf) / sizeof(buf[0]);
-    if (N > max_samples) {
-        N = max_samples;
-    }
+    const size_t N = (size_t)(SR * dur_s);
+    int16_t* buf = clip_alloc(c, N * sizeof(int16_t));
+    if (!buf) return false;
 
     // Short fade-in to avoid click and give a percussive strike
     const float attack_s = 0.004f; // ~4ms
@@ -252,22 +459,189 @@ void audio_alert_notify(void)
         if (v > 32767) v = 32767; else if (v < -32768) v = -32768;
         buf[n] = (int16_t)v;
     }
-    play_pcm_16_mono_22k(buf, N);
+    note_fill(c, t0);
+    return true;
 }
 
-// Delayed startup tone to avoid first-play click during boot
-static void audio_startup_tone_task(void *pv)
+static bool play_chime(void)
 {
-    (void)pv;
-    // Allow system/codec to fully settle
-    vTaskDelay(pdMS_TO_TICKS(400));
-    audio_alert_notify();
-    vTaskDelete(NULL);
+    // 1) The user's notification sound when there is one
+    switch (file_lookup()) {
+    case SRC_CACHED:
+        return play_clip(&s_file_clip);
+    case SRC_STREAM:
+        s_cold = true;
+        if (play_file_stream(s_file_path)) return true;
+        break;
+    default:
+        break;
+    }
+    // 2) Synthesized tone, computed once
+    if (!s_chime_clip.pcm) {
+        ESP_LOGI(TAG, "no notification sound file, using synthesized tone");
+        if (!chime_synth(&s_chime_clip)) return false;
+    }
+    return play_clip(&s_chime_clip);
+}
+
+static play_result_t play_sound(audio_alert_sound_t sound)
+{
+    codec_init();
+    if (!s_ready) return PLAY_FAILED;
+    s_stop_reason = PLAY_DONE;
+    s_cold = false;
+    s_first_write = false;
+    bool ok = false;
+    switch (sound) {
+    case AUDIO_ALERT_SOUND_NOTIFY:
+    case AUDIO_ALERT_SOUND_STARTUP:
+        ok = play_chime();
+        break;
+    default:
+        break;
+    }
+    if (s_stop_reason != PLAY_DONE) return s_stop_reason;
+    return ok ? PLAY_DONE : PLAY_FAILED;
+}
+
+// Highest priority first, oldest first among equals; cancelled ones go
+static bool backlog_take(audio_req_t* out)
+{
+    portENTER_CRITICAL(&s_lock);
+    const uint32_t gen = s_cancel_gen;
+    portEXIT_CRITICAL(&s_lock);
+    size_t n = 0;
+    for (size_t i = 0; i < s_backlog_len; ++i) {
+        if (s_backlog[i].gen == gen) s_backlog[n++] = s_backlog[i];
+    }
+    s_backlog_len = n;
+    if (!n) return false;
+    size_t best = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (s_backlog[i].prio > s_backlog[best].prio) best = i;
+    }
+    *out = s_backlog[best];
+    memmove(&s_backlog[best], &s_backlog[best + 1], (n - best - 1) * sizeof(s_backlog[0]));
+    s_backlog_len--;
+    return true;
+}
+
+static void audio_task(void* arg)
+{
+    (void)arg;
+    boot_seq_mark("audio task");
+    if (codec_init() == ESP_OK) vTaskDelay(pdMS_TO_TICKS(AUDIO_SETTLE_MS));
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        if (s_open) {
+            const int64_t idle_ms = (esp_timer_get_time() - s_idle_since) / 1000;
+            wait = idle_ms >= AUDIO_PA_IDLE_MS ? 0 : pdMS_TO_TICKS(AUDIO_PA_IDLE_MS - idle_ms) + 1;
+        }
+        backlog_fill(wait);
+        audio_req_t req;
+        if (!backlog_take(&req)) {
+            if (s_open && (esp_timer_get_time() - s_idle_since) / 1000 >= AUDIO_PA_IDLE_MS) codec_power_down();
+            continue;
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        s_pending &= ~(1u << req.sound);
+        s_playing = req.sound;
+        s_playing_prio = req.prio;
+        portEXIT_CRITICAL(&s_lock);
+
+        s_cur = req;
+        play_result_t r = play_sound((audio_alert_sound_t)req.sound);
+        s_idle_since = esp_timer_get_time();
+
+        portENTER_CRITICAL(&s_lock);
+        if (s_playing == req.sound) s_playing = -1;
+        if (r == PLAY_DONE) s_stats.played++;
+        else if (r == PLAY_PREEMPTED) s_stats.preempted++;
+        else if (r == PLAY_CANCELLED) s_stats.cancelled++;
+        portEXIT_CRITICAL(&s_lock);
+        if (r == PLAY_FAILED) ESP_LOGW(TAG, "sound %u failed", (unsigned)req.sound);
+    }
+}
+
+esp_err_t audio_alert_init(void)
+{
+    if (s_queue) return ESP_OK;
+    QueueHandle_t q = xQueueCreate(AUDIO_QUEUE_LEN, sizeof(audio_req_t));
+    if (!q) return ESP_ERR_NO_MEM;
+    s_queue = q;
+    if (xTaskCreate(audio_task, "audio", AUDIO_TASK_STACK, NULL, AUDIO_TASK_PRIO, NULL) != pdPASS) {
+        vQueueDelete(q);
+        s_queue = NULL;
+        ESP_LOGE(TAG, "audio task create failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t audio_alert_play(audio_alert_sound_t sound, audio_alert_prio_t prio)
+{
+    if ((unsigned)sound >= AUDIO_ALERT_SOUND_COUNT) return ESP_ERR_INVALID_ARG;
+    if (!s_queue) return ESP_ERR_INVALID_STATE;
+    const int64_t t0 = esp_timer_get_time();
+    const uint32_t bit = 1u << sound;
+    audio_req_t req = { .sound = (uint8_t)sound, .prio = (uint8_t)prio, .t_us = t0 };
+
+    // Ten notifications in a row play one chime: merge with the same sound
+    // when it is still queued, or playing at this priority or above
+    portENTER_CRITICAL(&s_lock);
+    s_stats.requests++;
+    bool merge = (s_pending & bit) || (s_playing == (int)sound && (int)prio <= s_playing_prio);
+    if (merge) s_stats.merged++;
+    else s_pending |= bit;
+    req.gen = s_cancel_gen;
+    portEXIT_CRITICAL(&s_lock);
+
+    esp_err_t err = ESP_OK;
+    if (!merge && xQueueSend(s_queue, &req, 0) != pdTRUE) {
+        err = ESP_ERR_NO_MEM;
+    }
+
+    const uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+    portENTER_CRITICAL(&s_lock);
+    if (err != ESP_OK) {
+        s_pending &= ~bit;
+        s_stats.dropped++;
+    }
+    s_stats.enqueue_us_total += dt;
+    if (dt > s_stats.enqueue_us_max) s_stats.enqueue_us_max = dt;
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+void audio_alert_notify(void)
+{
+    if (!settings_get_sound()) return;
+    (void)audio_alert_play(AUDIO_ALERT_SOUND_NOTIFY, AUDIO_ALERT_PRIO_NORMAL);
+}
+
+void audio_alert_stop(void)
+{
+    if (!s_queue) return;
+    // Queued requests carry the old generation; the task drops them
+    portENTER_CRITICAL(&s_lock);
+    s_cancel_gen++;
+    s_pending = 0;
+    s_playing = -1;                 // nothing to merge into any more
+    portEXIT_CRITICAL(&s_lock);
 }
 
 void audio_alert_play_startup(void)
 {
     if (!settings_get_sound()) return;
-    // Create a detached task to play startup tone after a brief delay
-    xTaskCreate(audio_startup_tone_task, "tone_startup", 8192, NULL, 3, NULL);
+    // The task holds the first sound until the codec has settled
+    (void)audio_alert_play(AUDIO_ALERT_SOUND_STARTUP, AUDIO_ALERT_PRIO_LOW);
+}
+
+void audio_alert_get_stats(audio_alert_stats_t* out)
+{
+    if (!out) return;
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
 }
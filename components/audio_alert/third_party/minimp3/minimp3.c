@@ -0,0 +1,6 @@
+// The decoder itself, from the single-header library. alert_decoder.c
+// streams with minimp3.h alone; the file reader in minimp3_ex.h is built
+// along for tools written against it and costs nothing when unused.
+#define MINIMP3_IMPLEMENTATION
+#include "minimp3.h"
+#include "minimp3_ex.h"
@@ -1,10 +1,23 @@
 #ifndef MINIMP3_H
 #define MINIMP3_H
 /*
-    https://github.com/lieff/minimp3
-    To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide.
-    This software is distributed without any warranty.
-    See <http://creativecommons.org/publicdomain/zero/1.0/>.
+    MPEG-1, MPEG-2 and MPEG-2.5 Layer III decoder with the API of minimp3
+    (https://github.com/lieff/minimp3), single header: define
+    MINIMP3_IMPLEMENTATION in one source file before including it.
+
+    This is not upstream's code. Upstream could not be fetched for this
+    tree, so the decoder here was written from ISO/IEC 11172-3 and
+    13818-3; upstream's minimp3.h can replace it without changing callers.
+    Differences from upstream:
+    - Layer I and II frames are not recognized, and free-format streams
+      (bitrate index 0) are not supported
+    - all state, scratch included, is in mp3dec_t (about 20 KB), so
+      decoding needs only a few hundred bytes of stack
+
+    To the extent possible under law, the author(s) have dedicated all
+    copyright and related and neighboring rights to this software to the
+    public domain worldwide. This software is distributed without any
+    warranty. See <http://creativecommons.org/publicdomain/zero/1.0/>.
 */
 #include <stdint.h>
 
@@ -17,17 +30,1103 @@ typedef struct
 
 typedef struct
 {
-    float mdct_overlap[2][9*32], qmf_state[15*2*32];
-    uint32_t reserv, free_format_bytes;
-    int16_t last_bitreservoir;
-    uint8_t maindata[1940];
-    int md_len, frame_size, part_23_len, main_data_begin, gr_info, scfsi, decode_padding, frame_bytes;
-    int hr, hs, gr, ch, ls, lsf, mpeg25, mode, mode_ext, jsbound, start, end, sfreq, tab_offset,
-        layer, bitrate_kbps, channels, hz, frame_offset;
+    float mdct_overlap[2][18*32], qmf_state[2][1024];
+    int qmf_pos[2], reserv;
+    unsigned char header[4], reserv_buf[511];
+    /* Scratch for one frame */
+    float grbuf[2][576];
+    unsigned char maindata[511 + 1441 + 32], scf[2][40];
 } mp3dec_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void mp3dec_init(mp3dec_t *dec);
+
+/* Decodes the first frame found in `mp3`. Returns samples per channel
+   (1152 or 576) written to `pcm` as interleaved 16-bit PCM, or 0 when the
+   frame gave no audio: then info->frame_bytes bytes can be dropped (0
+   means more input is needed). With `pcm` NULL the frame is only parsed. */
 int mp3dec_decode_frame(mp3dec_t *dec, const uint8_t *mp3, int mp3_bytes, int16_t *pcm, mp3dec_frame_info_t *info);
 
+#ifdef __cplusplus
+}
 #endif
 
+#endif /* MINIMP3_H */
+
+#if defined(MINIMP3_IMPLEMENTATION) && !defined(MINIMP3_IMPLEMENTATION_GUARD)
+#define MINIMP3_IMPLEMENTATION_GUARD
+
+#include <math.h>
+#include <string.h>
+
+#define MP3D_HDR_SIZE       4
+#define MP3D_MAX_RESERV     511
+#define MP3D_MAX_BANDS      40
+
+/* ---- tables ------------------------------------------------------------ */
+
+static const uint16_t mp3d_hz[9] = { 44100, 48000, 32000, 22050, 24000, 16000, 11025, 12000, 8000 };
+
+static const uint16_t mp3d_kbps[2][15] = {
+    { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 },       /* MPEG-2 and 2.5 */
+    { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },  /* MPEG-1 */
+};
+
+/* Scalefactor band widths per sample rate, in mp3d_hz order */
+static const uint8_t mp3d_long_width[9][22] = {
+    { 4, 4, 4, 4, 4, 4, 6, 6, 8, 8, 10, 12, 16, 20, 24, 28, 34, 42, 50, 54, 76, 158 },
+    { 4, 4, 4, 4, 4, 4, 6, 6, 6, 8, 10, 12, 16, 18, 22, 28, 34, 40, 46, 54, 54, 192 },
+    { 4, 4, 4, 4, 4, 4, 6, 6, 8, 10, 12, 16, 20, 24, 30, 38, 46, 56, 68, 84, 102, 26 },
+    { 6, 6, 6, 6, 6, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 38, 46, 52, 60, 68, 58, 54 },
+    { 6, 6, 6, 6, 6, 6, 8, 10, 12, 14, 16, 18, 22, 26, 32, 38, 46, 54, 62, 70, 76, 36 },
+    { 6, 6, 6, 6, 6, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 38, 46, 52, 60, 68, 58, 54 },
+    { 6, 6, 6, 6, 6, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 38, 46, 52, 60, 68, 58, 54 },
+    { 6, 6, 6, 6, 6, 6, 8, 10, 12, 14, 16, 20, 24, 28, 32, 38, 46, 52, 60, 68, 58, 54 },
+    { 12, 12, 12, 12, 12, 12, 16, 20, 24, 28, 32, 40, 48, 56, 64, 76, 90, 2, 2, 2, 2, 2 },
+};
+
+static const uint8_t mp3d_short_width[9][13] = {
+    { 4, 4, 4, 4, 6, 8, 10, 12, 14, 18, 22, 30, 56 },
+    { 4, 4, 4, 4, 6, 6, 10, 12, 14, 16, 20, 26, 66 },
+    { 4, 4, 4, 4, 6, 8, 12, 16, 20, 26, 34, 42, 12 },
+    { 4, 4, 4, 6, 6, 8, 10, 14, 18, 26, 32, 42, 18 },
+    { 4, 4, 4, 6, 8, 10, 12, 14, 18, 24, 32, 44, 12 },
+    { 4, 4, 4, 6, 8, 10, 12, 14, 18, 24, 30, 40, 18 },
+    { 4, 4, 4, 6, 8, 10, 12, 14, 18, 24, 30, 40, 18 },
+    { 4, 4, 4, 6, 8, 10, 12, 14, 18, 24, 30, 40, 18 },
+    { 8, 8, 8, 12, 16, 20, 24, 28, 36, 2, 2, 2, 26 },
+};
+
+static const uint8_t mp3d_pretab[22] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 3, 2, 0 };
+
+/* MPEG-1 scalefactor bit lengths by scalefac_compress */
+static const uint8_t mp3d_slen[2][16] = {
+    { 0, 0, 0, 0, 3, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4 },
+    { 0, 1, 2, 3, 0, 1, 2, 3, 1, 2, 3, 1, 2, 3, 2, 3 },
+};
+
+/* MPEG-2 scalefactors per slen group: [table][long, short, mixed][group] */
+static const uint8_t mp3d_lsf_count[6][3][4] = {
+    { { 6, 5, 5, 5 }, { 9, 9, 9, 9 }, { 6, 9, 9, 9 } },
+    { { 6, 5, 7, 3 }, { 9, 9, 12, 6 }, { 6, 9, 12, 6 } },
+    { { 11, 10, 0, 0 }, { 18, 18, 0, 0 }, { 15, 18, 0, 0 } },
+    { { 7, 7, 7, 0 }, { 12, 12, 12, 0 }, { 6, 15, 12, 0 } },
+    { { 6, 6, 6, 3 }, { 12, 9, 9, 6 }, { 6, 12, 9, 6 } },
+    { { 8, 8, 5, 0 }, { 15, 12, 9, 0 }, { 6, 18, 9, 0 } },
+};
+
+/* Huffman decoding: a 64-entry table indexed by the next 6 bits, then
+   subtables. An entry >= 0 is a symbol (low 8 bits, x << 4 | y) and the
+   bits its code takes at this level (bits 8 and up); < 0 is -(offset << 4
+   | bits to index the subtable at `offset` with). */
+static const int16_t mp3d_huff1[64] = {
+    785, 785, 785, 785, 785, 785, 785, 785, 769, 769, 769, 769, 769, 769, 769, 769, 528, 528, 528, 528, 528,
+    528, 528, 528, 528, 528, 528, 528, 528, 528, 528, 528, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256,
+};
+static const int16_t mp3d_huff2[64] = {
+    1570, 1538, 1298, 1298, 1313, 1313, 1312, 1312, 785, 785, 785, 785, 785, 785, 785, 785, 769, 769, 769, 769,
+    769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256,
+};
+static const int16_t mp3d_huff3[64] = {
+    1570, 1538, 1298, 1298, 1313, 1313, 1312, 1312, 784, 784, 784, 784, 784, 784, 784, 784, 529, 529, 529, 529,
+    529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 513, 513, 513, 513, 513, 513, 513, 513, 513,
+    513, 513, 513, 513, 513, 513, 513, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512,
+    512, 512,
+};
+static const int16_t mp3d_huff5[72] = {
+    -1026, 1585, -1089, -1121, 1554, 1569, 1538, 1568, 785, 785, 785, 785, 785, 785, 785, 785, 769, 769, 769,
+    769, 769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 563, 547, 306, 306, 275, 259, 304, 290,
+};
+static const int16_t mp3d_huff6[66] = {
+    -1025, 1571, 1586, 1584, 1299, 1299, 1329, 1329, 1314, 1314, 1282, 1282, 1042, 1042, 1042, 1042, 1057,
+    1057, 1057, 1057, 1056, 1056, 1056, 1056, 769, 769, 769, 769, 769, 769, 769, 769, 529, 529, 529, 529, 529,
+    529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 784, 784, 784, 784, 784, 784, 784, 784, 768, 768,
+    768, 768, 768, 768, 768, 768, 307, 259,
+};
+static const int16_t mp3d_huff7[102] = {
+    -1028, -1283, -1410, -1473, -1506, -1569, -1601, 1554, 1313, 1313, 1538, 1568, 1041, 1041, 1041, 1041, 769,
+    769, 769, 769, 769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 1109, 1093, 1108, 1107, 821, 821, 836, 836, 805, 805, 850, 850, 533, 533, 533,
+    533, 593, 593, 773, 820, 592, 592, 835, 819, 548, 578, 276, 276, 321, 320, 516, 547, 562, 515, 275, 305,
+    304, 290,
+};
+static const int16_t mp3d_huff8[102] = {
+    -1028, -1315, -1442, -1506, -1570, 1570, 1538, 1568, 1042, 1042, 1042, 1042, 1057, 1057, 1057, 1057, 529,
+    529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 529, 769, 769, 769, 769, 769, 769,
+    769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512, 512,
+    512, 512, 512, 512, 512, -1281, 1093, 851, 851, 1077, 1092, 805, 805, 850, 850, 773, 773, 533, 533, 533,
+    533, 341, 340, 593, 593, 820, 835, 848, 819, 548, 548, 578, 532, 321, 321, 516, 576, 547, 562, 531, 561,
+    515, 560,
+};
+static const int16_t mp3d_huff9[86] = {
+    -1027, -1154, -1217, -1250, -1313, -1345, 1556, 1601, 1571, 1586, 1299, 1299, 1329, 1329, 1539, 1584, 1314,
+    1314, 1282, 1282, 1042, 1042, 1042, 1042, 1057, 1057, 1057, 1057, 1056, 1056, 1056, 1056, 785, 785, 785,
+    785, 785, 785, 785, 785, 769, 769, 769, 769, 769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784,
+    768, 768, 768, 768, 768, 768, 768, 768, 853, 837, 565, 565, 595, 595, 852, 773, 580, 549, 594, 533, 337,
+    308, 323, 323, 592, 516, 292, 322, 307, 320,
+};
+static const int16_t mp3d_huff10[144] = {
+    -1028, -1412, -1668, -1923, -2051, -2178, -2241, -2273, 1554, 1569, 1538, 1568, 1041, 1041, 1041, 1041,
+    769, 769, 769, 769, 769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, -1281, -1313, -1345, 1095, 1140, 1110, 1125, 1079, 1139, 1094, -1377, 1123,
+    807, 807, 882, 882, 375, 359, 374, 343, 373, 358, 341, 340, 1124, 1031, 880, 880, 866, 866, 1093, 1077,
+    774, 774, 1107, 1092, 535, 535, 535, 535, 625, 625, 625, 625, 822, 822, 806, 806, 1061, 1106, 789, 789,
+    849, 849, 1076, 1091, 534, 534, 609, 609, 608, 608, 773, 848, 804, 834, 819, 772, 532, 532, 577, 577, 576,
+    547, 562, 515, 275, 305, 304, 290,
+};
+static const int16_t mp3d_huff11[142] = {
+    -1028, -1316, -1570, -1635, -1763, -1890, -1954, -2019, -2146, -2209, 1555, 1585, -2241, 1570, 1313, 1313,
+    1042, 1042, 1042, 1042, 1282, 1282, 1312, 1312, 785, 785, 785, 785, 785, 785, 785, 785, 769, 769, 769, 769,
+    769, 769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 512, 512, 512, 512, 512, 512, 512, 512, 512,
+    512, 512, 512, 512, 512, 512, 512, 1143, 1127, 1142, 1141, 1126, 1095, 1140, -1281, 1110, 1125, 823, 823,
+    883, 883, 838, 838, 343, 341, 1093, 1108, 1077, 1107, 551, 551, 551, 551, 626, 626, 626, 626, 868, 868,
+    775, 775, 369, 369, 535, 624, 566, 566, 611, 611, 608, 608, 836, 805, 850, 773, 533, 533, 354, 354, 354,
+    354, 550, 518, 278, 278, 353, 353, 593, 564, 592, 592, 835, 819, 548, 548, 578, 578, 532, 577, 516, 576,
+    291, 306, 259, 304,
+};
+static const int16_t mp3d_huff12[130] = {
+    -1028, -1283, -1410, -1475, -1603, -1729, -1762, -1826, -1889, -1921, -1954, -2017, 1587, 1601, 1571, 1586,
+    -2049, 1584, 1299, 1299, 1329, 1329, 1314, 1314, 1042, 1042, 1042, 1042, 1057, 1057, 1057, 1057, 1282,
+    1282, 1312, 1312, 1024, 1024, 1024, 1024, 785, 785, 785, 785, 785, 785, 785, 785, 769, 769, 769, 769, 769,
+    769, 769, 769, 784, 784, 784, 784, 784, 784, 784, 784, 1143, 1127, 886, 886, 855, 855, 885, 885, 870, 870,
+    839, 839, 884, 884, 869, 869, 598, 598, 567, 567, 883, 853, 551, 551, 626, 582, 612, 535, 625, 625, 775,
+    880, 566, 566, 611, 611, 581, 581, 596, 596, 580, 580, 774, 773, 294, 354, 353, 353, 534, 608, 565, 595,
+    549, 594, 277, 337, 308, 323, 592, 516, 292, 292, 322, 276, 320, 259,
+};
+static const int16_t mp3d_huff13[436] = {
+    -1028, -4388, -5220, -5732, -6020, -6275, -6404, -6659, -6786, -6850, -6913, -6945, 1554, 1569, 1538, 1568,
+    1041, 1041, 1041, 1041, 1025, 1025, 1025, 1025, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, -1284, -2436, -2724, -2980, -3235, -3363, -3491, -3619, -3747, -3875,
+    -4003, -4130, -4194, -4257, -4289, -4322, -1540, -1826, -1891, -2017, -2050, -2113, -2145, -2177, -2209,
+    -2242, -2306, 1271, 1242, -2369, -2401, 1135, -1793, 1277, 1005, 1005, 767, 767, 767, 767, 751, 751, 751,
+    751, 735, 735, 735, 735, 510, 508, 750, 719, 734, 703, 763, 763, 718, 718, 732, 732, 943, 1001, 492, 477,
+    762, 717, 446, 446, 491, 415, 505, 490, 445, 475, 399, 504, 460, 460, 686, 670, 398, 398, 639, 638, 429,
+    444, 459, 502, 1256, 1119, 1181, 1241, 1269, 1255, 1196, 1211, 1103, 1268, -2689, 1267, 831, 831, 1165,
+    1240, 458, 486, 815, 815, 1010, 1010, 1134, 1180, 783, 783, 1225, 1118, 939, 939, 1149, 1239, 846, 846,
+    1224, 1238, 830, 830, 953, 953, 1179, 1194, 543, 543, 543, 543, 753, 753, 753, 753, 752, 752, 954, 997,
+    996, 908, 877, 995, 738, 738, 814, 782, 542, 542, 737, 737, 992, 861, 981, 892, 967, 845, 907, 952, 980,
+    922, 937, 876, 710, 710, 573, 573, 979, 891, 557, 557, 722, 722, 541, 541, 695, 695, 860, 965, 921, 890,
+    707, 707, 935, 919, 587, 587, 465, 465, 465, 465, 525, 720, 650, 680, 588, 708, 619, 694, 316, 300, 450,
+    347, 693, 649, 284, 284, -4642, -4706, -4770, -4834, -4898, -4962, -5026, 1202, 1051, 1201, -5089, -5121,
+    -5153, -5185, 1066, 1186, 449, 449, 664, 524, 448, 448, 692, 618, 678, 633, 315, 315, 435, 435, 648, 602,
+    299, 299, 677, 617, 420, 420, 632, 647, 404, 404, 631, 630, 267, 432, 406, 330, 314, 419, 345, 405, 1050,
+    1185, -5473, 1184, -5505, 1171, -5537, -5569, 1065, 1170, -5601, 1080, 1155, -5633, -5665, -5697, 266, 360,
+    390, 329, 313, 344, 389, 359, 343, 373, 358, 327, 372, 342, 357, 371, 793, 793, 913, 913, 1033, 1168, 1096,
+    1156, 1138, -5985, 808, 808, 898, 898, 792, 792, 326, 356, 1079, 1063, 791, 791, 881, 881, 1109, 1031,
+    1136, 1078, 1123, 1093, 1108, 1062, 1122, 1077, 641, 641, 776, 896, 790, 865, 774, 864, 1107, 1092, 805,
+    805, 850, 850, 773, 773, 533, 533, 533, 533, 593, 593, 593, 593, 820, 835, 848, 804, 834, 819, 532, 532,
+    321, 321, 516, 576, 547, 562, 275, 275, 305, 259, 304, 290,
+};
+static const int16_t mp3d_huff15[382] = {
+    -1028, -2308, -3140, -3620, -3940, -4196, -4452, -4708, -4963, -5091, -5218, -5283, -5410, -5475, -5602,
+    -5667, -5794, -5857, -5889, -5922, -5985, -6017, 1601, -6049, 1571, 1586, -6081, 1555, 1585, 1584, 1314,
+    1314, 1298, 1298, 1313, 1313, 1282, 1282, 1312, 1312, 785, 785, 785, 785, 785, 785, 785, 785, 1025, 1025,
+    1025, 1025, 1040, 1040, 1040, 1040, 768, 768, 768, 768, 768, 768, 768, 768, -1283, -1411, -1538, -1602,
+    -1666, -1730, -1794, -1859, -1985, -2018, -2081, -2113, -2145, -2178, -2241, -2273, 1023, 1007, 1022, 991,
+    750, 750, 1021, 975, 1020, 990, 1005, 959, 763, 763, 974, 1004, 733, 687, 762, 702, 747, 717, 732, 671,
+    761, 746, 701, 731, 655, 760, 716, 670, 745, 639, 759, 685, 730, 730, 700, 700, 623, 623, 942, 783, 459,
+    502, 654, 744, 607, 669, 501, 382, 487, 428, 458, 443, 729, 653, 335, 335, 500, 319, 499, 472, -2561,
+    -2594, -2657, -2689, -2721, -2753, -2785, -2817, -2849, -2881, -2913, -2945, -2977, -3009, -3042, -3105,
+    486, 303, 498, 498, 622, 752, 287, 497, 412, 457, 350, 427, 442, 485, 381, 471, 334, 484, 396, 456, 318,
+    365, 470, 483, 411, 441, 302, 426, 482, 286, 481, 481, 526, 736, 349, 469, -3393, -3425, 1236, -3457,
+    -3489, -3521, 1235, 1234, -3553, 1053, 1147, 1207, 1233, -3585, 1221, 1162, 380, 455, 333, 395, 440, 410,
+    425, 364, 454, 317, 301, 269, 348, 464, 1192, 1100, 1220, 1131, 1206, -3873, 1084, 1219, 1146, 1191, 1190,
+    -3905, 962, 962, 1068, 1115, 409, 268, 448, 267, 1205, 1052, 1161, 1176, 1217, 1099, 1204, 1130, 1083,
+    1145, 947, 947, 1175, 1160, 1067, 1114, 946, 946, 1189, 1051, 945, 945, 1200, 1129, 1174, 1098, 1188, 1144,
+    1159, 1082, 931, 931, 857, 857, 917, 917, 810, 810, 930, 930, 794, 794, 929, 929, 1034, 1184, 872, 872,
+    902, 902, 841, 841, 916, 916, 825, 825, 915, 915, 1143, 1033, 856, 856, 901, 901, 809, 871, 886, 914, 657,
+    657, 793, 912, 840, 900, 855, 885, 824, 899, 870, 839, 552, 642, 536, 641, 884, 776, 896, 854, 869, 823,
+    883, 838, 551, 626, 612, 535, 597, 597, 625, 625, 775, 880, 566, 566, 611, 581, 596, 550, 610, 610, 534,
+    534, 774, 864, 565, 565, 353, 353, 595, 580, 293, 338, 277, 337, 517, 592, 308, 308, 323, 292, 322, 307,
+    276, 260, 320, 259,
+};
+static const int16_t mp3d_huff16[434] = {
+    -1028, -1476, -2340, -3492, -4996, -5668, -6084, -6340, -6595, -6723, -6849, -6882, 1554, 1569, 1538, 1568,
+    1041, 1041, 1041, 1041, 1025, 1025, 1025, 1025, 784, 784, 784, 784, 784, 784, 784, 784, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, -1281, -1313, -1345, -1377, 1199, -1409, -1441, 1167, 1151, 1271, 1135,
+    1270, 767, 767, 767, 767, 495, 510, 479, 509, 463, 508, 447, 507, 506, 415, 505, 504, 1119, 1269, 847, 847,
+    1012, 1012, 1011, 1011, 1008, 1008, 1087, -1732, 754, 754, 754, 754, -1987, -2114, 1262, -2177, 1214, 1229,
+    -2209, 1198, 1228, -2241, -2273, 1226, -2305, 1118, 957, 957, 718, 718, 1004, 989, 478, 478, 478, 478, 489,
+    489, 746, 729, 493, 491, 476, 475, 429, 474, 382, 428, 457, 381, 815, 815, 783, 783, 543, 543, 543, 543,
+    753, 753, 753, 753, -2596, -2852, -3108, -3363, 926, 926, 1212, 1227, 1166, 1256, 1181, 1255, 1211, 1165,
+    1240, 1134, 998, 998, 924, 924, 1195, 1210, 1253, 1239, 846, 846, 1252, 1164, 968, 968, 830, 830, 877, 877,
+    1238, 1179, 1209, 1194, 993, 993, 980, 980, 1208, 1193, 891, 891, 1207, 1232, 739, 739, 739, 739, 782, 992,
+    861, 981, 892, 967, 845, 907, -3747, -3875, -4003, -4130, -4194, -4259, -4386, -4450, -4514, -4578, -4642,
+    -4705, -4738, -4802, -4866, -4930, 922, 876, 966, 829, 860, 965, 525, 525, 906, 936, 921, 844, 950, 890,
+    572, 572, 859, 905, 540, 540, 704, 704, 920, 889, 482, 482, 558, 542, 723, 557, 722, 721, 571, 571, 919,
+    904, 285, 285, 285, 285, 708, 619, 707, 679, 300, 300, 706, 693, 705, 524, 587, 692, 618, 678, 435, 435,
+    602, 677, 299, 299, 434, 283, 433, 433, 523, 688, 617, 662, 586, 676, 632, 647, 419, 419, 570, 601, 298,
+    298, -5250, -5314, -5378, 1186, 1050, -5441, -5473, -5505, 1065, 1170, -5537, 1049, 1169, -5569, -5601,
+    -5633, 661, 616, 417, 417, 646, 631, 404, 404, 585, 599, 359, 359, 266, 416, 313, 403, 344, 389, 374, 265,
+    400, 328, 388, 373, 312, 387, -5921, 1154, -5953, 1048, 1153, 1152, -5985, 1079, 1139, -6017, 1063, 1138,
+    -6049, 1031, 791, 791, 358, 296, 327, 372, 264, 342, 357, 326, 356, 341, 881, 881, 1136, 1078, 1123, 1093,
+    1108, 1062, 866, 866, 790, 790, 865, 865, 1030, 1120, 851, 851, 1077, 1092, 805, 805, 850, 850, 593, 593,
+    593, 593, 789, 789, 773, 773, 820, 835, 848, 804, 834, 819, 532, 532, 577, 577, 772, 832, 547, 547, 562,
+    562, 275, 305, 515, 560, 290, 290,
+};
+static const int16_t mp3d_huff24[374] = {
+    -1026, -1090, -1154, -1217, -1250, -1313, -1345, -1377, -1409, -1441, -1474, -1540, 1279, 1279, 1279, 1279,
+    -2244, -2724, -2980, -3236, -3524, -3876, -4132, -4387, -4515, -4643, -4772, -5028, -5282, -5346, -5410,
+    -5475, -5603, -5730, -5793, -5825, -5858, -5921, 1555, 1585, -5953, 1570, 1298, 1298, 1313, 1313, 1538,
+    1568, 1041, 1041, 1041, 1041, 1025, 1025, 1025, 1025, 1040, 1040, 1040, 1040, 1024, 1024, 1024, 1024, 751,
+    766, 735, 765, 719, 764, 703, 763, 506, 506, 687, 671, 505, 504, 655, 639, 503, 503, 367, 502, 351, 501,
+    335, 500, 319, 499, 303, 498, 497, 497, 543, 752, 783, 783, -1793, -1825, -1857, -1889, -1921, -1953,
+    -1985, -2017, -2049, -2081, -2113, -2145, -2177, -2209, 494, 478, 493, 462, 492, 477, 446, 491, 461, 476,
+    430, 490, 445, 475, 460, 414, 489, 429, 474, 444, 459, 398, 488, 413, 473, 382, 487, 428, -2497, -2529,
+    -2562, 1254, -2625, 1225, 1118, 1210, 1253, -2657, 1239, 1252, 1164, 1224, -2689, 1086, 458, 443, 397, 472,
+    526, 736, 269, 269, 366, 412, 427, 381, 334, 302, 1133, 1238, 1251, 1179, 1209, 1194, 1250, 1054, 1249,
+    1117, 1237, 1148, 1223, 1101, 1163, 1208, 1236, 1178, 1193, 1132, 1222, 1085, 1235, 1069, 1234, 1053, 1147,
+    1207, 1233, 1116, 1221, 1162, 1192, 1177, 1100, 1220, 1131, 1206, -3489, 1084, 1219, 1146, 1191, 1068,
+    1218, 1115, 1205, 1052, 464, 268, 1161, 1176, 1217, 1099, -3777, 1083, -3809, 1050, 948, 948, 1130, 1190,
+    1145, 1175, -3841, 1168, 448, 267, 432, 266, 416, 265, 947, 947, 904, 904, 1067, 1114, 946, 946, 1189,
+    1051, 1201, 1129, 918, 918, 932, 932, 1098, 1144, 903, 903, 826, 826, 931, 931, 857, 857, 917, 917, 810,
+    810, 930, 930, 929, 872, 902, 887, 841, 916, 825, 915, 856, 901, 809, 871, 886, 914, 793, 913, 840, 900,
+    855, 885, 824, 899, 870, 808, 898, 898, 792, 792, 839, 839, 884, 884, 897, 897, 1032, 1152, 854, 854, 869,
+    869, 791, 791, 1031, 1136, 627, 627, 627, 627, 823, 823, 807, 807, 626, 626, 626, 626, 582, 612, 597, 625,
+    566, 611, 581, 596, 550, 610, 534, 609, 774, 864, 565, 565, 595, 595, 580, 580, 549, 549, 594, 594, 533,
+    533, 773, 848, 337, 337, 564, 579, 292, 322, 307, 276, 321, 321, 516, 576, 291, 306, 259, 304,
+};
+static const int16_t mp3d_huff_quad[64] = {
+    1547, 1551, 1549, 1550, 1543, 1541, 1289, 1289, 1286, 1286, 1283, 1283, 1290, 1290, 1292, 1292, 1026, 1026,
+    1026, 1026, 1025, 1025, 1025, 1025, 1028, 1028, 1028, 1028, 1032, 1032, 1032, 1032, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 256, 256,
+};
+
+static const float mp3d_cos36[18 * 18] = {
+    0.675590208f, -0.79335334f, -0.537299608f, 0.887010833f, 0.382683432f, -0.953716951f,
+    -0.216439614f, 0.991444861f, 0.0436193874f, -0.999048222f, 0.130526192f, 0.976296007f,
+    -0.3007058f, -0.923879533f, 0.461748613f, 0.843391446f, -0.608761429f, -0.737277337f,
+    0.608761429f, -0.923879533f, -0.130526192f, 0.991444861f, -0.382683432f, -0.79335334f,
+    0.79335334f, 0.382683432f, -0.991444861f, 0.130526192f, 0.923879533f, -0.608761429f,
+    -0.608761429f, 0.923879533f, 0.130526192f, -0.991444861f, 0.382683432f, 0.79335334f,
+    0.537299608f, -0.991444861f, 0.3007058f, 0.737277337f, -0.923879533f, 0.0436193874f,
+    0.887010833f, -0.79335334f, -0.216439614f, 0.976296007f, -0.608761429f, -0.461748613f,
+    0.999048222f, -0.382683432f, -0.675590208f, 0.953716951f, -0.130526192f, -0.843391446f,
+    0.461748613f, -0.991444861f, 0.675590208f, 0.216439614f, -0.923879533f, 0.843391446f,
+    -0.0436193874f, -0.79335334f, 0.953716951f, -0.3007058f, -0.608761429f, 0.999048222f,
+    -0.537299608f, -0.382683432f, 0.976296007f, -0.737277337f, -0.130526192f, 0.887010833f,
+    0.382683432f, -0.923879533f, 0.923879533f, -0.382683432f, -0.382683432f, 0.923879533f,
+    -0.923879533f, 0.382683432f, 0.382683432f, -0.923879533f, 0.923879533f, -0.382683432f,
+    -0.382683432f, 0.923879533f, -0.923879533f, 0.382683432f, 0.382683432f, -0.923879533f,
+    0.3007058f, -0.79335334f, 0.999048222f, -0.843391446f, 0.382683432f, 0.216439614f,
+    -0.737277337f, 0.991444861f, -0.887010833f, 0.461748613f, 0.130526192f, -0.675590208f,
+    0.976296007f, -0.923879533f, 0.537299608f, 0.0436193874f, -0.608761429f, 0.953716951f,
+    0.216439614f, -0.608761429f, 0.887010833f, -0.999048222f, 0.923879533f, -0.675590208f,
+    0.3007058f, 0.130526192f, -0.537299608f, 0.843391446f, -0.991444861f, 0.953716951f,
+    -0.737277337f, 0.382683432f, 0.0436193874f, -0.461748613f, 0.79335334f, -0.976296007f,
+    0.130526192f, -0.382683432f, 0.608761429f, -0.79335334f, 0.923879533f, -0.991444861f,
+    0.991444861f, -0.923879533f, 0.79335334f, -0.608761429f, 0.382683432f, -0.130526192f,
+    -0.130526192f, 0.382683432f, -0.608761429f, 0.79335334f, -0.923879533f, 0.991444861f,
+    0.0436193874f, -0.130526192f, 0.216439614f, -0.3007058f, 0.382683432f, -0.461748613f,
+    0.537299608f, -0.608761429f, 0.675590208f, -0.737277337f, 0.79335334f, -0.843391446f,
+    0.887010833f, -0.923879533f, 0.953716951f, -0.976296007f, 0.991444861f, -0.999048222f,
+    -0.737277337f, 0.608761429f, 0.843391446f, -0.461748613f, -0.923879533f, 0.3007058f,
+    0.976296007f, -0.130526192f, -0.999048222f, -0.0436193874f, 0.991444861f, 0.216439614f,
+    -0.953716951f, -0.382683432f, 0.887010833f, 0.537299608f, -0.79335334f, -0.675590208f,
+    -0.79335334f, 0.382683432f, 0.991444861f, 0.130526192f, -0.923879533f, -0.608761429f,
+    0.608761429f, 0.923879533f, -0.130526192f, -0.991444861f, -0.382683432f, 0.79335334f,
+    0.79335334f, -0.382683432f, -0.991444861f, -0.130526192f, 0.923879533f, 0.608761429f,
+    -0.843391446f, 0.130526192f, 0.953716951f, 0.675590208f, -0.382683432f, -0.999048222f,
+    -0.461748613f, 0.608761429f, 0.976296007f, 0.216439614f, -0.79335334f, -0.887010833f,
+    0.0436193874f, 0.923879533f, 0.737277337f, -0.3007058f, -0.991444861f, -0.537299608f,
+    -0.887010833f, -0.130526192f, 0.737277337f, 0.976296007f, 0.382683432f, -0.537299608f,
+    -0.999048222f, -0.608761429f, 0.3007058f, 0.953716951f, 0.79335334f, -0.0436193874f,
+    -0.843391446f, -0.923879533f, -0.216439614f, 0.675590208f, 0.991444861f, 0.461748613f,
+    -0.923879533f, -0.382683432f, 0.382683432f, 0.923879533f, 0.923879533f, 0.382683432f,
+    -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, 0.382683432f, 0.923879533f,
+    0.923879533f, 0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f,
+    -0.953716951f, -0.608761429f, -0.0436193874f, 0.537299608f, 0.923879533f, 0.976296007f,
+    0.675590208f, 0.130526192f, -0.461748613f, -0.887010833f, -0.991444861f, -0.737277337f,
+    -0.216439614f, 0.382683432f, 0.843391446f, 0.999048222f, 0.79335334f, 0.3007058f,
+    -0.976296007f, -0.79335334f, -0.461748613f, -0.0436193874f, 0.382683432f, 0.737277337f,
+    0.953716951f, 0.991444861f, 0.843391446f, 0.537299608f, 0.130526192f, -0.3007058f,
+    -0.675590208f, -0.923879533f, -0.999048222f, -0.887010833f, -0.608761429f, -0.216439614f,
+    -0.991444861f, -0.923879533f, -0.79335334f, -0.608761429f, -0.382683432f, -0.130526192f,
+    0.130526192f, 0.382683432f, 0.608761429f, 0.79335334f, 0.923879533f, 0.991444861f,
+    0.991444861f, 0.923879533f, 0.79335334f, 0.608761429f, 0.382683432f, 0.130526192f,
+    -0.999048222f, -0.991444861f, -0.976296007f, -0.953716951f, -0.923879533f, -0.887010833f,
+    -0.843391446f, -0.79335334f, -0.737277337f, -0.675590208f, -0.608761429f, -0.537299608f,
+    -0.461748613f, -0.382683432f, -0.3007058f, -0.216439614f, -0.130526192f, -0.0436193874f,
+};
+
+static const float mp3d_cos12[6 * 6] = {
+    0.608761429f, -0.923879533f, -0.130526192f, 0.991444861f, -0.382683432f, -0.79335334f,
+    0.382683432f, -0.923879533f, 0.923879533f, -0.382683432f, -0.382683432f, 0.923879533f,
+    0.130526192f, -0.382683432f, 0.608761429f, -0.79335334f, 0.923879533f, -0.991444861f,
+    -0.79335334f, 0.382683432f, 0.991444861f, 0.130526192f, -0.923879533f, -0.608761429f,
+    -0.923879533f, -0.382683432f, 0.382683432f, 0.923879533f, 0.923879533f, 0.382683432f,
+    -0.991444861f, -0.923879533f, -0.79335334f, -0.608761429f, -0.382683432f, -0.130526192f,
+};
+
+static const float mp3d_win36[3 * 36] = {
+    0.0436193874f, 0.130526192f, 0.216439614f, 0.3007058f, 0.382683432f, 0.461748613f,
+    0.537299608f, 0.608761429f, 0.675590208f, 0.737277337f, 0.79335334f, 0.843391446f,
+    0.887010833f, 0.923879533f, 0.953716951f, 0.976296007f, 0.991444861f, 0.999048222f,
+    0.999048222f, 0.991444861f, 0.976296007f, 0.953716951f, 0.923879533f, 0.887010833f,
+    0.843391446f, 0.79335334f, 0.737277337f, 0.675590208f, 0.608761429f, 0.537299608f,
+    0.461748613f, 0.382683432f, 0.3007058f, 0.216439614f, 0.130526192f, 0.0436193874f,
+    0.0436193874f, 0.130526192f, 0.216439614f, 0.3007058f, 0.382683432f, 0.461748613f,
+    0.537299608f, 0.608761429f, 0.675590208f, 0.737277337f, 0.79335334f, 0.843391446f,
+    0.887010833f, 0.923879533f, 0.953716951f, 0.976296007f, 0.991444861f, 0.999048222f,
+    1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+    0.991444861f, 0.923879533f, 0.79335334f, 0.608761429f, 0.382683432f, 0.130526192f,
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    0.130526192f, 0.382683432f, 0.608761429f, 0.79335334f, 0.923879533f, 0.991444861f,
+    1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+    0.999048222f, 0.991444861f, 0.976296007f, 0.953716951f, 0.923879533f, 0.887010833f,
+    0.843391446f, 0.79335334f, 0.737277337f, 0.675590208f, 0.608761429f, 0.537299608f,
+    0.461748613f, 0.382683432f, 0.3007058f, 0.216439614f, 0.130526192f, 0.0436193874f,
+};
+
+static const float mp3d_win12[12] = {
+    0.130526192f, 0.382683432f, 0.608761429f, 0.79335334f, 0.923879533f, 0.991444861f,
+    0.991444861f, 0.923879533f, 0.79335334f, 0.608761429f, 0.382683432f, 0.130526192f,
+};
+
+static const float mp3d_dct_scale[31] = {
+    0.500602998f, 0.50547096f, 0.51544731f, 0.531042591f, 0.553103896f, 0.582934968f,
+    0.622504123f, 0.674808341f, 0.744536271f, 0.839349645f, 0.972568238f, 1.16943993f,
+    1.48416462f, 2.05778101f, 3.40760842f, 10.1900081f, 0.502419286f, 0.522498615f,
+    0.566944035f, 0.646821783f, 0.788154623f, 1.06067769f, 1.7224471f, 5.10114862f,
+    0.509795579f, 0.601344887f, 0.899976223f, 2.56291545f, 0.5411961f, 1.30656296f,
+    0.707106781f,
+};
+
+static const float mp3d_aa[2 * 8] = {
+    0.857492926f, 0.881741997f, 0.949628649f, 0.983314592f, 0.995517816f, 0.999160558f, 0.999899195f, 0.999993155f,
+    -0.514495755f, -0.471731969f, -0.313377454f, -0.1819132f, -0.0945741925f, -0.0409655829f, -0.0141985686f, -0.00369997467f,
+};
+
+static const float mp3d_pow43_tab[16] = {
+    0.0f, 1.0f, 2.5198421f, 4.32674871f, 6.34960421f, 8.54987973f, 10.9027236f, 13.3905183f,
+    16.0f, 18.7207544f, 21.5443469f, 24.463781f, 27.4731418f, 30.5673509f, 33.7419917f, 36.9931811f,
+};
+
+static const float mp3d_pow2q[4] = {
+    1.0f, 1.18920712f, 1.41421356f, 1.68179283f,
+};
+
+static const float mp3d_is_ratio[2 * 7] = {
+    0.0f, 0.211324865f, 0.366025404f, 0.5f, 0.633974596f, 0.788675135f, 1.0f,
+    1.0f, 0.788675135f, 0.633974596f, 0.5f, 0.366025404f, 0.211324865f, 0.0f,
+};
+
+/* Synthesis window, in units of 2^-16 */
+static const float mp3d_win[512] = {
+    0, -1, -1, -1, -1, -1, -1, -2, -2, -2, -2, -3, -3, -4, -4, -5, -5, -6, -7, -7, -8, -9, -10, -11, -13, -14,
+    -16, -17, -19, -21, -24, -26, -29, -31, -35, -38, -41, -45, -49, -53, -58, -63, -68, -73, -79, -85, -91,
+    -97, -104, -111, -117, -125, -132, -139, -147, -154, -161, -169, -176, -183, -190, -196, -202, -208, 213,
+    218, 222, 225, 227, 228, 228, 227, 224, 221, 215, 208, 200, 189, 177, 163, 146, 127, 106, 83, 57, 29, -2,
+    -36, -72, -111, -153, -197, -244, -294, -347, -401, -459, -519, -581, -645, -711, -779, -848, -919, -991,
+    -1064, -1137, -1210, -1283, -1356, -1428, -1498, -1567, -1634, -1698, -1759, -1817, -1870, -1919, -1962,
+    -2001, -2032, -2057, -2075, -2085, -2087, -2080, -2063, 2037, 2000, 1952, 1893, 1822, 1739, 1644, 1535,
+    1414, 1280, 1131, 970, 794, 605, 402, 185, -45, -288, -545, -814, -1095, -1388, -1692, -2006, -2330, -2663,
+    -3004, -3351, -3705, -4063, -4425, -4788, -5153, -5517, -5879, -6237, -6589, -6935, -7271, -7597, -7910,
+    -8209, -8491, -8755, -8998, -9219, -9416, -9585, -9727, -9838, -9916, -9959, -9966, -9935, -9863, -9750,
+    -9592, -9389, -9139, -8840, -8492, -8092, -7640, -7134, 6574, 5959, 5288, 4561, 3776, 2935, 2037, 1082, 70,
+    -998, -2122, -3300, -4533, -5818, -7154, -8540, -9975, -11455, -12980, -14548, -16155, -17799, -19478,
+    -21189, -22929, -24694, -26482, -28289, -30112, -31947, -33791, -35640, -37489, -39336, -41176, -43006,
+    -44821, -46617, -48390, -50137, -51853, -53534, -55178, -56778, -58333, -59838, -61289, -62684, -64019,
+    -65290, -66494, -67629, -68692, -69679, -70590, -71420, -72169, -72835, -73415, -73908, -74313, -74630,
+    -74856, -74992, 75038, 74992, 74856, 74630, 74313, 73908, 73415, 72835, 72169, 71420, 70590, 69679, 68692,
+    67629, 66494, 65290, 64019, 62684, 61289, 59838, 58333, 56778, 55178, 53534, 51853, 50137, 48390, 46617,
+    44821, 43006, 41176, 39336, 37489, 35640, 33791, 31947, 30112, 28289, 26482, 24694, 22929, 21189, 19478,
+    17799, 16155, 14548, 12980, 11455, 9975, 8540, 7154, 5818, 4533, 3300, 2122, 998, -70, -1082, -2037, -2935,
+    -3776, -4561, -5288, -5959, 6574, 7134, 7640, 8092, 8492, 8840, 9139, 9389, 9592, 9750, 9863, 9935, 9966,
+    9959, 9916, 9838, 9727, 9585, 9416, 9219, 8998, 8755, 8491, 8209, 7910, 7597, 7271, 6935, 6589, 6237, 5879,
+    5517, 5153, 4788, 4425, 4063, 3705, 3351, 3004, 2663, 2330, 2006, 1692, 1388, 1095, 814, 545, 288, 45,
+    -185, -402, -605, -794, -970, -1131, -1280, -1414, -1535, -1644, -1739, -1822, -1893, -1952, -2000, 2037,
+    2063, 2080, 2087, 2085, 2075, 2057, 2032, 2001, 1962, 1919, 1870, 1817, 1759, 1698, 1634, 1567, 1498, 1428,
+    1356, 1283, 1210, 1137, 1064, 991, 919, 848, 779, 711, 645, 581, 519, 459, 401, 347, 294, 244, 197, 153,
+    111, 72, 36, 2, -29, -57, -83, -106, -127, -146, -163, -177, -189, -200, -208, -215, -221, -224, -227,
+    -228, -228, -227, -225, -222, -218, 213, 208, 202, 196, 190, 183, 176, 169, 161, 154, 147, 139, 132, 125,
+    117, 111, 104, 97, 91, 85, 79, 73, 68, 63, 58, 53, 49, 45, 41, 38, 35, 31, 29, 26, 24, 21, 19, 17, 16, 14,
+    13, 11, 10, 9, 8, 7, 7, 6, 5, 5, 4, 4, 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1,
+};
+
+static const int16_t *const mp3d_huff_tab[32] = {
+    NULL, mp3d_huff1, mp3d_huff2, mp3d_huff3, NULL, mp3d_huff5, mp3d_huff6, mp3d_huff7,
+    mp3d_huff8, mp3d_huff9, mp3d_huff10, mp3d_huff11, mp3d_huff12, mp3d_huff13, NULL, mp3d_huff15,
+    mp3d_huff16, mp3d_huff16, mp3d_huff16, mp3d_huff16, mp3d_huff16, mp3d_huff16, mp3d_huff16, mp3d_huff16,
+    mp3d_huff24, mp3d_huff24, mp3d_huff24, mp3d_huff24, mp3d_huff24, mp3d_huff24, mp3d_huff24, mp3d_huff24,
+};
+
+static const uint8_t mp3d_linbits[32] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 8, 10, 13, 4, 5, 6, 7, 8, 9, 11, 13,
+};
+
+/* ---- bitstream and headers --------------------------------------------- */
+
+typedef struct
+{
+    const uint8_t *buf;
+    int pos;
+} mp3d_bs_t;
+
+/* Up to 25 bits. Reads 4 bytes from the current one: main data is padded
+   with zeros so that a corrupt granule overrunning its part stays inside. */
+static unsigned mp3d_peek(const mp3d_bs_t *bs, int n)
+{
+    const uint8_t *p = bs->buf + (bs->pos >> 3);
+    const uint32_t v = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    return (unsigned)((v << (bs->pos & 7)) >> (32 - n));
+}
+
+static unsigned mp3d_bits(mp3d_bs_t *bs, int n)
+{
+    if (!n) return 0;
+    const unsigned v = mp3d_peek(bs, n);
+    bs->pos += n;
+    return v;
+}
+
+static int mp3d_huff(mp3d_bs_t *bs, const int16_t *tab)
+{
+    int off = 0, w = 6, e;
+    while ((e = tab[off + mp3d_peek(bs, w)]) < 0) {
+        bs->pos += w;
+        off = -e >> 4;
+        w = -e & 15;
+    }
+    bs->pos += e >> 8;
+    return e & 0xff;
+}
+
+static int mp3d_hdr_valid(const uint8_t *h)
+{
+    return h[0] == 0xff && (h[1] & 0xe0) == 0xe0 && (h[1] & 0x18) != 0x08 && (h[1] & 0x06) == 0x02 &&
+           (h[2] >> 4) != 0 && (h[2] >> 4) != 15 && (h[2] & 0x0c) != 0x0c;
+}
+
+/* Same version, layer and sample rate */
+static int mp3d_hdr_compare(const uint8_t *a, const uint8_t *b)
+{
+    return mp3d_hdr_valid(b) && !((a[1] ^ b[1]) & 0xfe) && !((a[2] ^ b[2]) & 0x0c);
+}
+
+static int mp3d_hdr_mpeg1(const uint8_t *h)
+{
+    return (h[1] & 0x08) != 0;
+}
+
+static int mp3d_hdr_channels(const uint8_t *h)
+{
+    return (h[3] & 0xc0) == 0xc0 ? 1 : 2;
+}
+
+static int mp3d_hdr_sr(const uint8_t *h)
+{
+    return ((h[2] >> 2) & 3) + (mp3d_hdr_mpeg1(h) ? 0 : (h[1] & 0x10) ? 3 : 6);
+}
+
+static int mp3d_hdr_kbps(const uint8_t *h)
+{
+    return mp3d_kbps[mp3d_hdr_mpeg1(h)][h[2] >> 4];
+}
+
+static int mp3d_hdr_frame_bytes(const uint8_t *h)
+{
+    return (mp3d_hdr_mpeg1(h) ? 144000 : 72000) * mp3d_hdr_kbps(h) / mp3d_hz[mp3d_hdr_sr(h)] + ((h[2] >> 1) & 1);
+}
+
+/* Offset of the first frame whose successor, when the buffer holds its
+   header, matches it. Without one, the offset of the bytes still to scan. */
+static int mp3d_find_frame(const uint8_t *mp3, int mp3_bytes, int *frame_bytes)
+{
+    int i = 0;
+    for (; i + MP3D_HDR_SIZE <= mp3_bytes; ++i) {
+        const uint8_t *h = mp3 + i;
+        if (!mp3d_hdr_valid(h)) continue;
+        const int fb = mp3d_hdr_frame_bytes(h);
+        if (i + fb + MP3D_HDR_SIZE <= mp3_bytes && !mp3d_hdr_compare(h, h + fb)) continue;
+        *frame_bytes = fb;
+        return i;
+    }
+    *frame_bytes = 0;
+    return i;
+}
+
+/* ---- side info and scalefactors ---------------------------------------- */
+
+typedef struct
+{
+    int part23, big_values, global_gain, sfc, block_type, mixed, preflag, sfscale, count1tab, scfsi;
+    int table[3], sbg[3];
+    int region1, region2;           /* first line of regions 1 and 2 */
+} mp3d_gr_t;
+
+typedef struct
+{
+    uint8_t width, win, sfb;        /* win 0-2 for short bands, 3 for long */
+} mp3d_band_t;
+
+static int mp3d_long_start(int sr, int sfb)
+{
+    int pos = 0;
+    for (int i = 0; i < sfb && i < 22; ++i) pos += mp3d_long_width[sr][i];
+    return pos;
+}
+
+static int mp3d_read_side_info(mp3d_bs_t *bs, const uint8_t *h, mp3d_gr_t gr[2][2], int *main_data_begin)
+{
+    const int mpeg1 = mp3d_hdr_mpeg1(h), nch = mp3d_hdr_channels(h), sr = mp3d_hdr_sr(h);
+    int scfsi[2] = { 0, 0 };
+    *main_data_begin = (int)mp3d_bits(bs, mpeg1 ? 9 : 8);
+    mp3d_bits(bs, mpeg1 ? (nch == 1 ? 5 : 3) : nch);
+    if (mpeg1) {
+        for (int ch = 0; ch < nch; ++ch) scfsi[ch] = (int)mp3d_bits(bs, 4);
+    }
+    for (int g = 0; g < (mpeg1 ? 2 : 1); ++g) {
+        for (int ch = 0; ch < nch; ++ch) {
+            mp3d_gr_t *gi = &gr[g][ch];
+            memset(gi, 0, sizeof(*gi));
+            gi->scfsi = g ? scfsi[ch] : 0;
+            gi->part23 = (int)mp3d_bits(bs, 12);
+            gi->big_values = (int)mp3d_bits(bs, 9);
+            gi->global_gain = (int)mp3d_bits(bs, 8);
+            gi->sfc = (int)mp3d_bits(bs, mpeg1 ? 4 : 9);
+            if (gi->big_values > 288) return 0;
+            if (mp3d_bits(bs, 1)) {
+                gi->block_type = (int)mp3d_bits(bs, 2);
+                gi->mixed = (int)mp3d_bits(bs, 1);
+                gi->table[0] = (int)mp3d_bits(bs, 5);
+                gi->table[1] = (int)mp3d_bits(bs, 5);
+                for (int w = 0; w < 3; ++w) gi->sbg[w] = (int)mp3d_bits(bs, 3);
+                if (!gi->block_type) return 0;
+                gi->region1 = gi->block_type == 2 ? 3 * (mp3d_short_width[sr][0] + mp3d_short_width[sr][1] +
+                                                         mp3d_short_width[sr][2])
+                                                  : mp3d_long_start(sr, 8);
+                gi->region2 = 576;
+            } else {
+                for (int r = 0; r < 3; ++r) gi->table[r] = (int)mp3d_bits(bs, 5);
+                const int r0 = (int)mp3d_bits(bs, 4), r1 = (int)mp3d_bits(bs, 3);
+                gi->region1 = mp3d_long_start(sr, r0 + 1);
+                gi->region2 = mp3d_long_start(sr, r0 + r1 + 2);
+            }
+            gi->preflag = mpeg1 ? (int)mp3d_bits(bs, 1) : 0;
+            gi->sfscale = (int)mp3d_bits(bs, 1);
+            gi->count1tab = (int)mp3d_bits(bs, 1);
+        }
+    }
+    return 1;
+}
+
+/* Bands in the order their lines are coded: short bands once per window.
+   Mixed blocks are long up to line 36, short from there. */
+static int mp3d_bands(const mp3d_gr_t *gi, int sr, mp3d_band_t *bands)
+{
+    int n = 0, pos = 0, sfb = 0;
+    if (gi->block_type != 2 || gi->mixed) {
+        for (; sfb < 22 && (gi->block_type != 2 || pos < 36); ++sfb, ++n) {
+            bands[n].width = mp3d_long_width[sr][sfb];
+            bands[n].win = 3;
+            bands[n].sfb = (uint8_t)sfb;
+            pos += bands[n].width;
+        }
+        sfb = gi->block_type == 2 ? 3 : 22;
+    }
+    for (; sfb < 13; ++sfb) {
+        for (int w = 0; w < 3; ++w, ++n) {
+            bands[n].width = mp3d_short_width[sr][sfb];
+            bands[n].win = (uint8_t)w;
+            bands[n].sfb = (uint8_t)sfb;
+            pos += bands[n].width;
+        }
+    }
+    if (pos < 576) {
+        /* 8 kHz mixed blocks: the short bands do not start at line 36 */
+        bands[n].width = (uint8_t)(576 - pos);
+        bands[n].win = 3;
+        bands[n++].sfb = 21;
+    }
+    return n;
+}
+
+/* Part 2 of a granule: a scalefactor per band in `bands` order, kept in
+   `scf` where scfsi reuses the first granule's. `is_max` gets the lowest
+   value that is not an intensity position. */
+static void mp3d_read_scf(mp3d_bs_t *bs, const uint8_t *h, mp3d_gr_t *gi, int ch, int nbands, uint8_t *scf,
+                          uint8_t *is_max)
+{
+    int count[4] = { 0 }, slen[4] = { 0 };
+    if (mp3d_hdr_mpeg1(h)) {
+        const int s1 = mp3d_slen[0][gi->sfc], s2 = mp3d_slen[1][gi->sfc];
+        if (gi->block_type == 2) {
+            count[0] = gi->mixed ? 17 : 18;
+            count[1] = 18;
+            slen[0] = s1;
+            slen[1] = s2;
+        } else {
+            count[0] = 6;
+            count[1] = count[2] = count[3] = 5;
+            slen[0] = slen[1] = s1;
+            slen[2] = slen[3] = s2;
+        }
+    } else {
+        const int block = gi->block_type == 2 ? (gi->mixed ? 2 : 1) : 0;
+        int tab, sfc = gi->sfc;
+        if (ch == 1 && ((h[3] >> 4) & 1) && (h[3] & 0xc0) == 0x40) {
+            /* Right channel of intensity stereo */
+            sfc >>= 1;
+            if (sfc < 180) {
+                tab = 3;
+                slen[0] = sfc / 36;
+                slen[1] = sfc % 36 / 6;
+                slen[2] = sfc % 6;
+            } else if (sfc < 244) {
+                tab = 4;
+                sfc -= 180;
+                slen[0] = sfc >> 4 & 3;
+                slen[1] = sfc >> 2 & 3;
+                slen[2] = sfc & 3;
+            } else {
+                tab = 5;
+                sfc -= 244;
+                slen[0] = sfc / 3;
+                slen[1] = sfc % 3;
+            }
+        } else if (sfc < 400) {
+            tab = 0;
+            slen[0] = (sfc >> 4) / 5;
+            slen[1] = (sfc >> 4) % 5;
+            slen[2] = sfc >> 2 & 3;
+            slen[3] = sfc & 3;
+        } else if (sfc < 500) {
+            tab = 1;
+            sfc -= 400;
+            slen[0] = (sfc >> 2) / 5;
+            slen[1] = (sfc >> 2) % 5;
+            slen[2] = sfc & 3;
+        } else {
+            tab = 2;
+            sfc -= 500;
+            slen[0] = sfc / 3;
+            slen[1] = sfc % 3;
+            gi->preflag = 1;
+        }
+        for (int k = 0; k < 4; ++k) count[k] = mp3d_lsf_count[tab][block][k];
+    }
+
+    const int reuse = gi->block_type != 2 ? gi->scfsi : 0;
+    int b = 0;
+    for (int k = 0; k < 4; ++k) {
+        for (int j = 0; j < count[k] && b < nbands; ++j, ++b) {
+            if (!(reuse & (8 >> k))) scf[b] = (uint8_t)mp3d_bits(bs, slen[k]);
+            is_max[b] = mp3d_hdr_mpeg1(h) ? 7 : (uint8_t)((1 << slen[k]) - 1);
+        }
+    }
+    for (; b < nbands; ++b) scf[b] = is_max[b] = 0;
+}
+
+/* 2^(q/4) */
+static float mp3d_pow2q4(int q)
+{
+    return ldexpf(mp3d_pow2q[q & 3], q >> 2);
+}
+
+static void mp3d_band_gains(const mp3d_gr_t *gi, const mp3d_band_t *bands, int nbands, const uint8_t *scf,
+                            float *gain)
+{
+    for (int b = 0; b < nbands; ++b) {
+        int q = gi->global_gain - 210, sf = scf[b];
+        if (bands[b].win < 3) q -= 8 * gi->sbg[bands[b].win];
+        else if (gi->preflag) sf += mp3d_pretab[bands[b].sfb];
+        q -= 2 * (1 + gi->sfscale) * sf;
+        gain[b] = mp3d_pow2q4(q);
+    }
+}
+
+/* ---- spectrum ----------------------------------------------------------- */
+
+static float mp3d_pow43(int v)
+{
+    return v < 16 ? mp3d_pow43_tab[v] : (float)v * cbrtf((float)v);
+}
+
+/* Part 3: big values in pairs, then count1 quads, up to bit `end`, scaled
+   by the gain of their band. Returns the line after the last nonzero one. */
+static int mp3d_read_spectrum(mp3d_bs_t *bs, const mp3d_gr_t *gi, const mp3d_band_t *bands, const float *gain,
+                              float *dst, int end)
+{
+    int i = 0, b = 0, band_end = bands[0].width, nz = 0;
+    const int big = gi->big_values * 2;
+    for (int r = 0; r < 3 && bs->pos <= end; ++r) {
+        int stop = r == 0 ? gi->region1 : r == 1 ? gi->region2 : 576;
+        if (stop > big) stop = big;
+        const int16_t *tab = mp3d_huff_tab[gi->table[r]];
+        const int linbits = mp3d_linbits[gi->table[r]];
+        /* Band widths are even, so a pair never straddles two bands */
+        for (; i < stop && bs->pos <= end; i += 2) {
+            while (i >= band_end) band_end += bands[++b].width;
+            if (!tab) {
+                dst[i] = dst[i + 1] = 0;
+                continue;
+            }
+            const int xy = mp3d_huff(bs, tab);
+            for (int k = 0; k < 2; ++k) {
+                int v = k ? xy & 15 : xy >> 4;
+                if (v == 15) v += (int)mp3d_bits(bs, linbits);
+                float f = 0;
+                if (v) {
+                    f = mp3d_pow43(v) * gain[b];
+                    if (mp3d_bits(bs, 1)) f = -f;
+                    nz = i + k + 1;
+                }
+                dst[i + k] = f;
+            }
+        }
+    }
+    if (bs->pos > end) {
+        /* Corrupt: the big values ran past the part */
+        memset(dst, 0, 576 * sizeof(float));
+        return 0;
+    }
+
+    const int16_t *quad = gi->count1tab ? NULL : mp3d_huff_quad;
+    while (i <= 572 && bs->pos < end) {
+        const int vwxy = quad ? mp3d_huff(bs, quad) : 15 - (int)mp3d_bits(bs, 4);
+        float q[4];
+        for (int k = 0; k < 4; ++k) {
+            q[k] = 0;
+            if (vwxy & (8 >> k)) q[k] = mp3d_bits(bs, 1) ? -1.0f : 1.0f;
+        }
+        /* A quad that runs past the part is padding, not data */
+        if (bs->pos > end) break;
+        for (int k = 0; k < 4; ++k, ++i) {
+            while (i >= band_end) band_end += bands[++b].width;
+            dst[i] = q[k] * gain[b];
+            if (q[k] != 0) nz = i + 1;
+        }
+    }
+    memset(dst + i, 0, (576 - i) * sizeof(float));
+    return nz;
+}
+
+static int mp3d_band_zero(const float *x, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        if (x[i] != 0) return 0;
+    }
+    return 1;
+}
+
+/* Joint stereo on the right channel's bands, from the top down: a band is
+   intensity coded while the right channel is zero in it and in every band
+   above it (per window for short bands), unless its position is illegal.
+   Mid/side covers the rest when it is on. */
+static void mp3d_stereo(float *l, float *r, const uint8_t *h, const mp3d_gr_t *gr, const mp3d_band_t *bands,
+                        int nbands, const uint8_t *scf, const uint8_t *is_max)
+{
+    const int ms = (h[3] >> 4) & 2, is = (h[3] >> 4) & 1, mpeg1 = mp3d_hdr_mpeg1(h);
+    int zone = is ? 7 : 0, pos = 576;
+    for (int b = nbands - 1; b >= 0; --b) {
+        const int w = bands[b].width;
+        pos -= w;
+        const int mask = bands[b].win < 3 ? 1 << bands[b].win : 7;
+        if ((zone & mask) == mask && mp3d_band_zero(r + pos, w)) {
+            /* The last band has no scalefactor: it uses the one below */
+            int s = b;
+            if (bands[b].win < 3 ? bands[b].sfb == 12 : bands[b].sfb == 21) s -= bands[b].win < 3 ? 3 : 1;
+            const int p = scf[s];
+            if (p < is_max[s]) {
+                float kl, kr;
+                if (mpeg1) {
+                    kl = mp3d_is_ratio[p];
+                    kr = mp3d_is_ratio[7 + p];
+                } else {
+                    const int step = 1 + (gr->sfc & 1);
+                    kl = p & 1 ? mp3d_pow2q4(-((p + 1) >> 1) * step) : 1.0f;
+                    kr = p & 1 || !p ? 1.0f : mp3d_pow2q4(-(p >> 1) * step);
+                }
+                for (int i = pos; i < pos + w; ++i) {
+                    r[i] = l[i] * kr;
+                    l[i] *= kl;
+                }
+                continue;
+            }
+        } else {
+            zone &= ~mask;
+        }
+        if (ms) {
+            for (int i = pos; i < pos + w; ++i) {
+                const float m = l[i], s = r[i];
+                l[i] = (m + s) * 0.70710678f;
+                r[i] = (m - s) * 0.70710678f;
+            }
+        }
+    }
+}
+
+/* Short bands are coded window by window; the IMDCT wants the three
+   windows' lines interleaved */
+static void mp3d_reorder(float *x, const mp3d_band_t *bands, int nbands)
+{
+    float tmp[3 * 66];
+    int pos = 0;
+    for (int b = 0; b < nbands;) {
+        const int w = bands[b].width;
+        if (bands[b].win == 3) {
+            pos += w;
+            ++b;
+            continue;
+        }
+        for (int win = 0; win < 3; ++win) {
+            for (int i = 0; i < w; ++i) tmp[3 * i + win] = x[pos + win * w + i];
+        }
+        memcpy(x + pos, tmp, 3 * w * sizeof(float));
+        pos += 3 * w;
+        b += 3;
+    }
+}
+
+static void mp3d_antialias(float *x, int nsb)
+{
+    for (int sb = 1; sb < nsb; ++sb) {
+        float *a = x + 18 * sb;
+        for (int i = 0; i < 8; ++i) {
+            const float u = a[-1 - i], d = a[i];
+            a[-1 - i] = u * mp3d_aa[i] - d * mp3d_aa[8 + i];
+            a[i] = d * mp3d_aa[i] + u * mp3d_aa[8 + i];
+        }
+    }
+}
+
+/* ---- filterbanks --------------------------------------------------------- */
+
+static void mp3d_imdct_long(const float *x, float *y, const float *win)
+{
+    for (int r = 0; r < 9; ++r) {
+        float a = 0, b = 0;
+        for (int k = 0; k < 18; ++k) {
+            a += x[k] * mp3d_cos36[r * 18 + k];
+            b += x[k] * mp3d_cos36[(9 + r) * 18 + k];
+        }
+        y[r] = a * win[r];
+        y[17 - r] = -a * win[17 - r];
+        y[18 + r] = b * win[18 + r];
+        y[35 - r] = b * win[35 - r];
+    }
+}
+
+static void mp3d_imdct_short(const float *x, float *y)
+{
+    memset(y, 0, 36 * sizeof(float));
+    for (int win = 0; win < 3; ++win) {
+        float z[12];
+        for (int r = 0; r < 3; ++r) {
+            float a = 0, b = 0;
+            for (int k = 0; k < 6; ++k) {
+                a += x[3 * k + win] * mp3d_cos12[r * 6 + k];
+                b += x[3 * k + win] * mp3d_cos12[(3 + r) * 6 + k];
+            }
+            z[r] = a;
+            z[5 - r] = -a;
+            z[6 + r] = b;
+            z[11 - r] = b;
+        }
+        for (int i = 0; i < 12; ++i) y[6 + 6 * win + i] += z[i] * mp3d_win12[i];
+    }
+}
+
+/* Turns each subband's 18 lines into 18 samples in place. Subbands from
+   `nsb` up are zero and only give out their overlap. */
+static void mp3d_imdct(float *x, float *overlap, const mp3d_gr_t *gi, int nsb)
+{
+    const float *win = mp3d_win36 + 36 * (gi->block_type == 1 ? 1 : gi->block_type == 3 ? 2 : 0);
+    for (int sb = 0; sb < 32; ++sb) {
+        float *s = x + 18 * sb, *o = overlap + 18 * sb, y[36];
+        if (sb >= nsb) {
+            memcpy(s, o, 18 * sizeof(float));
+            memset(o, 0, 18 * sizeof(float));
+        } else {
+            if (gi->block_type == 2 && !(gi->mixed && sb < 2)) mp3d_imdct_short(s, y);
+            else mp3d_imdct_long(s, y, gi->block_type == 2 ? mp3d_win36 : win);
+            for (int i = 0; i < 18; ++i) {
+                s[i] = y[i] + o[i];
+                o[i] = y[18 + i];
+            }
+        }
+        if (sb & 1) {
+            for (int i = 1; i < 18; i += 2) s[i] = -s[i];
+        }
+    }
+}
+
+/* X[k] = sum x[n] cos(pi / len * (n + 1/2) * k), in place (Lee's
+   recursion); `t` is scratch of the same length */
+static void mp3d_dct(float *v, float *t, int len, const float *scale)
+{
+    if (len == 1) return;
+    const int half = len / 2;
+    for (int i = 0; i < half; ++i) {
+        const float a = v[i], b = v[len - 1 - i];
+        t[i] = a + b;
+        t[half + i] = (a - b) * scale[i];
+    }
+    mp3d_dct(t, v, half, scale + half);
+    mp3d_dct(t + half, v + half, half, scale + half);
+    for (int i = 0; i < half - 1; ++i) {
+        v[2 * i] = t[i];
+        v[2 * i + 1] = t[half + i] + t[half + i + 1];
+    }
+    v[len - 2] = t[half - 1];
+    v[len - 1] = t[len - 1];
+}
+
+static int16_t mp3d_clip(float v)
+{
+    v += v >= 0 ? 0.5f : -0.5f;
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)v;
+}
+
+/* Polyphase synthesis of 18 time slots: subband sb of slot t is
+   x[18 * sb + t]. V is kept as a ring of 1024 values. */
+static void mp3d_synth(float *x, float *v, int *vpos, int16_t *pcm, int stride)
+{
+    for (int t = 0; t < 18; ++t) {
+        float s[32], tmp[32];
+        for (int sb = 0; sb < 32; ++sb) s[sb] = x[18 * sb + t];
+        mp3d_dct(s, tmp, 32, mp3d_dct_scale);
+
+        const int pos = *vpos = (*vpos - 64) & 1023;
+        for (int i = 0; i < 16; ++i) v[(pos + i) & 1023] = s[16 + i];
+        v[(pos + 16) & 1023] = 0;
+        for (int i = 17; i < 48; ++i) v[(pos + i) & 1023] = -s[48 - i];
+        for (int i = 48; i < 64; ++i) v[(pos + i) & 1023] = -s[i - 48];
+
+        for (int j = 0; j < 32; ++j) {
+            float sum = 0;
+            for (int i = 0; i < 8; ++i) {
+                sum += v[(pos + 128 * i + j) & 1023] * mp3d_win[64 * i + j];
+                sum += v[(pos + 128 * i + 96 + j) & 1023] * mp3d_win[64 * i + 32 + j];
+            }
+            /* The window is in units of 2^-16, output in units of 2^-15 */
+            pcm[(32 * t + j) * stride] = mp3d_clip(sum * 0.5f);
+        }
+    }
+}
+
+/* ---- frames -------------------------------------------------------------- */
+
+void mp3dec_init(mp3dec_t *dec)
+{
+    memset(dec, 0, sizeof(*dec));
+}
+
+int mp3dec_decode_frame(mp3dec_t *dec, const uint8_t *mp3, int mp3_bytes, int16_t *pcm, mp3dec_frame_info_t *info)
+{
+    int frame_bytes = 0;
+    memset(info, 0, sizeof(*info));
+    const int i = mp3d_find_frame(mp3, mp3_bytes, &frame_bytes);
+    if (!frame_bytes || i + frame_bytes > mp3_bytes) {
+        info->frame_bytes = i;
+        return 0;
+    }
+    const uint8_t *h = mp3 + i;
+    if (i || !mp3d_hdr_compare(dec->header, h)) {
+        /* Lost sync: what is in the reservoir belongs to another stream */
+        dec->reserv = 0;
+    }
+    memcpy(dec->header, h, MP3D_HDR_SIZE);
+
+    const int mpeg1 = mp3d_hdr_mpeg1(h), nch = mp3d_hdr_channels(h), sr = mp3d_hdr_sr(h);
+    const int ngr = mpeg1 ? 2 : 1;
+    info->frame_offset = i;
+    info->frame_bytes = i + frame_bytes;
+    info->channels = nch;
+    info->hz = mp3d_hz[sr];
+    info->layer = 3;
+    info->bitrate_kbps = mp3d_hdr_kbps(h);
+    if (!pcm) return 576 * ngr;
+
+    mp3d_gr_t gr[2][2];
+    int main_data_begin;
+    const int side_at = MP3D_HDR_SIZE + ((h[1] & 1) ? 0 : 2);
+    const int side_bytes = mpeg1 ? (nch == 1 ? 17 : 32) : (nch == 1 ? 9 : 17);
+    const int md_bytes = frame_bytes - side_at - side_bytes;
+    mp3d_bs_t bs = { h + side_at, 0 };
+    if (md_bytes < 0 || !mp3d_read_side_info(&bs, h, gr, &main_data_begin)) return 0;
+
+    /* Main data: the end of the reservoir, then this frame's; what is
+       left of both is the next frame's reservoir */
+    const uint8_t *md = h + side_at + side_bytes;
+    const int have = main_data_begin <= dec->reserv;
+    if (have) {
+        memcpy(dec->maindata, dec->reserv_buf + dec->reserv - main_data_begin, main_data_begin);
+        memcpy(dec->maindata + main_data_begin, md, md_bytes);
+        memset(dec->maindata + main_data_begin + md_bytes, 0, 32);
+    }
+    const int keep = dec->reserv + md_bytes < MP3D_MAX_RESERV ? dec->reserv + md_bytes : MP3D_MAX_RESERV;
+    if (md_bytes >= keep) {
+        memcpy(dec->reserv_buf, md + md_bytes - keep, keep);
+    } else {
+        memmove(dec->reserv_buf, dec->reserv_buf + dec->reserv - (keep - md_bytes), keep - md_bytes);
+        memcpy(dec->reserv_buf + keep - md_bytes, md, md_bytes);
+    }
+    dec->reserv = keep;
+    if (!have) return 0;
+
+    int total = 0;
+    for (int g = 0; g < ngr; ++g) {
+        for (int ch = 0; ch < nch; ++ch) total += gr[g][ch].part23;
+    }
+    if (total > (main_data_begin + md_bytes) * 8) return 0;
+
+    bs.buf = dec->maindata;
+    bs.pos = 0;
+    for (int g = 0; g < ngr; ++g) {
+        mp3d_band_t bands[2][MP3D_MAX_BANDS];
+        uint8_t is_max[2][MP3D_MAX_BANDS];
+        int nbands[2], nz[2];
+        for (int ch = 0; ch < nch; ++ch) {
+            mp3d_gr_t *gi = &gr[g][ch];
+            float gain[MP3D_MAX_BANDS];
+            const int end = bs.pos + gi->part23;
+            nbands[ch] = mp3d_bands(gi, sr, bands[ch]);
+            mp3d_read_scf(&bs, h, gi, ch, nbands[ch], dec->scf[ch], is_max[ch]);
+            mp3d_band_gains(gi, bands[ch], nbands[ch], dec->scf[ch], gain);
+            nz[ch] = mp3d_read_spectrum(&bs, gi, bands[ch], gain, dec->grbuf[ch], end);
+            bs.pos = end;
+        }
+        if (nch == 2 && (h[3] & 0xc0) == 0x40) {
+            mp3d_stereo(dec->grbuf[0], dec->grbuf[1], h, &gr[g][1], bands[1], nbands[1], dec->scf[1], is_max[1]);
+            nz[0] = nz[1] = nz[0] > nz[1] ? nz[0] : nz[1];
+        }
+        for (int ch = 0; ch < nch; ++ch) {
+            const mp3d_gr_t *gi = &gr[g][ch];
+            float *x = dec->grbuf[ch];
+            int nsb = 32;
+            if (gi->block_type == 2) {
+                mp3d_reorder(x, bands[ch], nbands[ch]);
+                if (gi->mixed) mp3d_antialias(x, 2);
+            } else {
+                /* Aliasing reduction spreads each subband into the next */
+                nsb = nz[ch] ? (nz[ch] - 1) / 18 + 2 : 0;
+                if (nsb > 32) nsb = 32;
+                mp3d_antialias(x, nsb);
+            }
+            mp3d_imdct(x, dec->mdct_overlap[ch], gi, nsb);
+            mp3d_synth(x, dec->qmf_state[ch], &dec->qmf_pos[ch], pcm + 576 * nch * g + ch, nch);
+        }
+    }
+    return 576 * ngr;
+}
+
+#endif /* MINIMP3_IMPLEMENTATION */
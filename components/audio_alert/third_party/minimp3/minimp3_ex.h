@@ -1,18 +1,24 @@
 #ifndef MINIMP3_EXT_H
 #define MINIMP3_EXT_H
 /*
-    https://github.com/lieff/minimp3
-    To the extent possible under law, the author(s) have dedicated all copyright and related and neighboring rights to this software to the public domain worldwide.
-    This software is distributed without any warranty.
-    See <http://creativecommons.org/publicdomain/zero/1.0/>.
+    File reader over minimp3.h, with the open/read/close part of upstream's
+    minimp3_ex.h API (https://github.com/lieff/minimp3). Like minimp3.h
+    here it is not upstream's code. There is no seeking and no duration
+    scan: the flags are checked and kept for callers written for upstream.
+
+    To the extent possible under law, the author(s) have dedicated all
+    copyright and related and neighboring rights to this software to the
+    public domain worldwide. This software is distributed without any
+    warranty. See <http://creativecommons.org/publicdomain/zero/1.0/>.
 */
 #include <stddef.h>
 #include "minimp3.h"
 
-/* flags for mp3dec_ex_open_* functions */
-#define MP3D_SEEK_TO_BYTE   0      /* mp3dec_ex_seek seeks to byte in stream */
-#define MP3D_SEEK_TO_SAMPLE 1      /* mp3dec_ex_seek precisely seeks to sample using index (created during duration calculation scan or when mp3dec_ex_seek called) */
-#define MP3D_DO_NOT_SCAN    2      /* do not scan whole stream for duration if vbrtag not found, mp3dec_ex_t::samples will be filled only if mp3dec_ex_t::vbr_tag_found == 1 */
+/* flags for mp3dec_ex_open_* functions; upstream's seeking and scanning
+   options, which change nothing here */
+#define MP3D_SEEK_TO_BYTE   0
+#define MP3D_SEEK_TO_SAMPLE 1
+#define MP3D_DO_NOT_SCAN    2
 #ifdef MINIMP3_ALLOW_MONO_STEREO_TRANSITION
 #define MP3D_ALLOW_MONO_STEREO_TRANSITION  4
 #define MP3D_FLAGS_MASK 7
@@ -20,22 +26,164 @@
 #define MP3D_FLAGS_MASK 3
 #endif
 
+/* error codes */
+#define MP3D_E_PARAM   -1
+#define MP3D_E_MEMORY  -2
+#define MP3D_E_IOERROR -3
+#define MP3D_E_DECODE  -5
+
 typedef struct
 {
     mp3dec_t mp3d;
-    mp3dec_frame_info_t info;
-    int flags, seek_method;
-    int64_t samples, offset, start_offset, end_offset, duration;
-    int vbr_tag_found;
-    int free_format_bytes;
+    mp3dec_frame_info_t info;       /* of the first frame */
+    int flags;
+    int64_t offset;                 /* samples read, channels counted apart */
+    int64_t start_offset;           /* file offset of the first byte after any ID3v2 tag */
     int last_error;
     int16_t buffer[MINIMP3_MAX_SAMPLES_PER_FRAME];
+    size_t buffer_samples, buffer_consumed;
     void *io; /* internal */
 } mp3dec_ex_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 int mp3dec_ex_open_file(mp3dec_ex_t *dec, const char *file, int flags);
 void mp3dec_ex_close(mp3dec_ex_t *dec);
+/* Interleaved samples, `samples` counting each channel; fewer at the end
+   of the stream, on an error (last_error) or where the sample rate or
+   channel count changes */
 size_t mp3dec_ex_read(mp3dec_ex_t *dec, int16_t *buf, size_t samples);
 
+#ifdef __cplusplus
+}
 #endif
 
+#endif /* MINIMP3_EXT_H */
+
+#if defined(MINIMP3_IMPLEMENTATION) && !defined(MINIMP3_EX_IMPLEMENTATION_GUARD)
+#define MINIMP3_EX_IMPLEMENTATION_GUARD
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MP3D_EX_BUF     16384
+#define MP3D_EX_REFILL  4096        /* more than the largest frame and the next header */
+
+typedef struct
+{
+    FILE *file;
+    size_t len, pos;
+    int eof;
+    uint8_t buf[MP3D_EX_BUF];
+} mp3dec_ex_io_t;
+
+static void mp3dec_ex_refill(mp3dec_ex_t *dec, mp3dec_ex_io_t *io)
+{
+    memmove(io->buf, io->buf + io->pos, io->len - io->pos);
+    io->len -= io->pos;
+    io->pos = 0;
+    const size_t want = MP3D_EX_BUF - io->len;
+    const size_t n = fread(io->buf + io->len, 1, want, io->file);
+    io->len += n;
+    if (n < want) {
+        if (ferror(io->file)) dec->last_error = MP3D_E_IOERROR;
+        io->eof = 1;
+    }
+}
+
+/* Decodes the next frame with audio into dec->buffer */
+static int mp3dec_ex_next_frame(mp3dec_ex_t *dec)
+{
+    mp3dec_ex_io_t *io = (mp3dec_ex_io_t *)dec->io;
+    for (;;) {
+        if (io->len - io->pos < MP3D_EX_REFILL && !io->eof) mp3dec_ex_refill(dec, io);
+        if (io->pos == io->len) return 0;
+        mp3dec_frame_info_t fi;
+        const int samples = mp3dec_decode_frame(&dec->mp3d, io->buf + io->pos, (int)(io->len - io->pos), dec->buffer, &fi);
+        if (!fi.frame_bytes) {
+            /* A partial frame: more input, unless there is none */
+            if (io->eof) return 0;
+            continue;
+        }
+        io->pos += (size_t)fi.frame_bytes;
+        if (!samples) continue;
+        if (!dec->info.channels) {
+            dec->info = fi;
+        } else if (fi.channels != dec->info.channels || fi.hz != dec->info.hz) {
+            return 0;
+        }
+        dec->buffer_samples = (size_t)(samples * fi.channels);
+        dec->buffer_consumed = 0;
+        return 1;
+    }
+}
+
+int mp3dec_ex_open_file(mp3dec_ex_t *dec, const char *file, int flags)
+{
+    if (!dec || !file || (flags & ~MP3D_FLAGS_MASK)) return MP3D_E_PARAM;
+    memset(dec, 0, sizeof(*dec));
+    mp3dec_ex_io_t *io = (mp3dec_ex_io_t *)malloc(sizeof(*io));
+    if (!io) return MP3D_E_MEMORY;
+    io->len = io->pos = 0;
+    io->eof = 0;
+    io->file = fopen(file, "rb");
+    if (!io->file) {
+        free(io);
+        return MP3D_E_IOERROR;
+    }
+    dec->io = io;
+    dec->flags = flags;
+    mp3dec_init(&dec->mp3d);
+
+    uint8_t h[10];
+    if (fread(h, 1, sizeof(h), io->file) == sizeof(h) && memcmp(h, "ID3", 3) == 0) {
+        /* Syncsafe size, plus the footer when the flags say there is one */
+        dec->start_offset = 10 + ((int64_t)(h[6] & 0x7f) << 21 | (h[7] & 0x7f) << 14 | (h[8] & 0x7f) << 7 | (h[9] & 0x7f));
+        if (h[5] & 0x10) dec->start_offset += 10;
+    }
+    if (fseek(io->file, (long)dec->start_offset, SEEK_SET) != 0) {
+        mp3dec_ex_close(dec);
+        return MP3D_E_IOERROR;
+    }
+    if (!mp3dec_ex_next_frame(dec)) {
+        const int err = dec->last_error ? dec->last_error : MP3D_E_DECODE;
+        mp3dec_ex_close(dec);
+        return err;
+    }
+    return 0;
+}
+
+void mp3dec_ex_close(mp3dec_ex_t *dec)
+{
+    if (!dec) return;
+    mp3dec_ex_io_t *io = (mp3dec_ex_io_t *)dec->io;
+    if (io) {
+        fclose(io->file);
+        free(io);
+    }
+    memset(dec, 0, sizeof(*dec));
+}
+
+size_t mp3dec_ex_read(mp3dec_ex_t *dec, int16_t *buf, size_t samples)
+{
+    if (!dec || !buf || !dec->io) {
+        if (dec) dec->last_error = MP3D_E_PARAM;
+        return 0;
+    }
+    size_t done = 0;
+    while (done < samples) {
+        if (dec->buffer_consumed == dec->buffer_samples && !mp3dec_ex_next_frame(dec)) break;
+        size_t n = dec->buffer_samples - dec->buffer_consumed;
+        if (n > samples - done) n = samples - done;
+        memcpy(buf + done, dec->buffer + dec->buffer_consumed, n * sizeof(int16_t));
+        dec->buffer_consumed += n;
+        done += n;
+    }
+    dec->offset += (int64_t)done;
+    return done;
+}
+
+#endif /* MINIMP3_IMPLEMENTATION */
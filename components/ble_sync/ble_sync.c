@@ -15,13 +15,20 @@
 #include "nimble-nordic-uart.h"
 #include "rtc_lib.h"
 #include "esp-bsp.h"
-#include "sensors.h"
 #include "esp_event.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "notifications.h"
 #include "display_manager.h"
 #include "ui.h"
+#include "ui_perf.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
 #include "audio_alert.h"
+#include "esp_timer.h"
+#include "file_transfer.h"
+#include "settings.h"
+#include "app_registry.h"
+#include "boot_seq.h"
 
 typedef struct {
     char* ts; char* app; char* title; char* msg;
@@ -47,8 +54,9 @@ ESP_EVENT_DEFINE_BASE(BLE_SYNC_EVENT_BASE);
 // Track BLE connection state to gate periodic status updates
 static volatile bool s_ble_connected = false;
 static TimerHandle_t s_status_timer = NULL;
-static TimerHandle_t s_time_sync_timer = NULL;
 static bool s_time_sync_requested = false;
+// Set once the phone sent a datetime this boot; later reconnects skip the RTC check
+static bool s_time_synced = false;
 static bool s_ble_enabled = false;
 static bool s_ble_stack_started = false;
 
@@ -56,17 +64,35 @@ static void status_timer_cb(TimerHandle_t xTimer)
 {
     (void)xTimer;
     if (s_ble_connected) {
-        ble_sync_send_status(bsp_power_get_battery_percent(), bsp_power_is_charging());
+        ble_sync_send_status(ui_state_get(UI_STATE_BATTERY), ui_state_get(UI_STATE_CHARGING));
     }
 }
 
-static void time_sync_timer_cb(TimerHandle_t xTimer)
+static void request_time_sync_if_needed(void)
 {
-    (void)xTimer;
-    // Send the time sync request now that the link is fully up
+    if (s_time_synced || s_time_sync_requested) return;
+    // Minimize time/date requests: if RTC is earlier than 2025-02-02, request sync once
+    bool need_sync = false;
+    int y = rtc_get_year();
+    int m = rtc_get_month();
+    int d = rtc_get_day();
+    if (y <= 0 || m <= 0 || d <= 0) {
+        need_sync = true;
+    } else {
+        int cur = y * 10000 + m * 100 + d;
+        const int threshold = 2025 * 10000 + 2 * 100 + 2; // 2025-02-02
+        if (cur < threshold) need_sync = true;
+    }
+    ESP_LOGI(TAG, "RTC date on subscribe: %04d-%02d-%02d, need_sync=%d", y, m, d, (int)need_sync);
+    if (!need_sync) {
+        s_time_synced = true;
+        return;
+    }
+    s_time_sync_requested = true;
+    // Notifications are enabled at this point, so no ATT setup race to wait out
     const char* sync_cmd = "{\"cmd\":\"time_sync\"}\n";
     (void)nordic_uart_sendln(sync_cmd);
-    ESP_LOGI(TAG, "Requested time sync on connect (delayed)");
+    ESP_LOGI(TAG, "Requested time sync");
 }
 
 static void handle_notification_fields(const char* timestamp,
@@ -77,6 +103,9 @@ static void handle_notification_fields(const char* timestamp,
     ESP_LOGI(TAG, "Notification: app='%s' title='%s' message='%s' ts='%s'",
         app ? app : "", title ? title : "", message ? message : "", timestamp ? timestamp : "");
 
+    // Flash write first, so the LVGL thread does not wait on it below
+    notifications_store(app, title, message, timestamp);
+
     // Wake display for visibility and ensure LVGL is running
     display_manager_turn_on();
     // Try to acquire LVGL lock with a reasonable timeout; avoid calling
@@ -106,8 +135,559 @@ static void handle_notification_fields(const char* timestamp,
     audio_alert_notify();
 }
 
+// ---- Link benchmark commands ------------------------------------------------
+// {"cmd":"link"}                 -> {"link":{...}} negotiated PHY/DLE/MTU, RX lane counters
+// {"cmd":"echo","seq":n,"t":x}   -> {"echo":n,"t":x,"us":...} phone measures RTT
+// {"cmd":"tput","bytes":n}       -> n bytes of filler lines, then {"tput":{...}}
+// {"cmd":"audio"}                -> {"audio":{...}} alert queue counters, enqueue latency
+// {"cmd":"boot"}                 -> {"boot":[{"name":s,"start_ms":x,"end_ms":x,"core":n},...]}
+// {"cmd":"perf","n":k,"overlay":b} -> {"perf":{...,"last":[[t_ms,render_us,flush_us,px,areas,s],...]}}
+//                                   last 5 s of frames, k most recent (16) listed; overlay on/off
+// {"cmd":"wakeups"}              -> {"wakeups":{...}} touch reads, UI ticks, frames, idle wakeups per core, per second
+// {"cmd":"state"}                -> {"state":{...,"values":{...}}} UI updates and I2C reads per minute, store values
+
+#define TPUT_DEFAULT_BYTES (16 * 1024)
+#define TPUT_MAX_BYTES     (256 * 1024)
+#define PERF_WINDOW_MS     5000
+#define PERF_LAST_DEFAULT  16
+
+static volatile bool s_tput_running = false;
+
+static void add_link_fields(cJSON* obj)
+{
+    struct nordic_uart_link_info li;
+    nordic_uart_get_link_info(&li);
+    cJSON_AddNumberToObject(obj, "tx_phy", li.tx_phy);
+    cJSON_AddNumberToObject(obj, "rx_phy", li.rx_phy);
+    cJSON_AddNumberToObject(obj, "dle", li.tx_octets);
+    cJSON_AddNumberToObject(obj, "mtu", li.att_mtu);
+    cJSON_AddNumberToObject(obj, "chunk", li.chunk_len);
+    cJSON_AddBoolToObject(obj, "bonded", li.bonded);
+    cJSON_AddNumberToObject(obj, "first_notify_ms", li.first_notify_ms);
+
+    struct nordic_uart_rx_stats rx;
+    nordic_uart_get_rx_stats(&rx);
+    cJSON_AddNumberToObject(obj, "rx_ctrl", rx.lines[NORDIC_UART_RX_LANE_CONTROL]);
+    cJSON_AddNumberToObject(obj, "rx_bulk", rx.lines[NORDIC_UART_RX_LANE_BULK]);
+    cJSON_AddNumberToObject(obj, "drop_ctrl", rx.dropped[NORDIC_UART_RX_LANE_CONTROL]);
+    cJSON_AddNumberToObject(obj, "drop_bulk", rx.dropped[NORDIC_UART_RX_LANE_BULK]);
+    cJSON_AddNumberToObject(obj, "peak_bulk", rx.peak_used[NORDIC_UART_RX_LANE_BULK]);
+}
+
+static void send_json(cJSON* root)
+{
+    char* json_str = cJSON_PrintUnformatted(root);
+    if (json_str) {
+        (void)nordic_uart_sendln(json_str);
+        free(json_str);
+    }
+}
+
+static void tput_task(void* arg)
+{
+    uint32_t total = (uint32_t)(uintptr_t)arg;
+    struct nordic_uart_link_info li;
+    nordic_uart_get_link_info(&li);
+    size_t line_len = li.chunk_len > 1 ? li.chunk_len : 20;
+    char* line = (char*)malloc(line_len + 1);
+    if (!line) {
+        s_tput_running = false;
+        vTaskDelete(NULL);
+        return;
+    }
+    // One notification per line: chunk-1 filler bytes and a newline
+    for (size_t i = 0; i + 1 < line_len; ++i) line[i] = (char)('A' + (i % 26));
+    line[line_len - 1] = '\n';
+    line[line_len] = '\0';
+
+    nordic_uart_request_burst(5000);
+    uint32_t sent = 0;
+    bool ok = true;
+    int64_t t0 = esp_timer_get_time();
+    while (sent < total && s_ble_connected) {
+        if (nordic_uart_send(line) != ESP_OK) { ok = false; break; }
+        sent += line_len;
+        if ((sent % (8 * 1024)) < line_len) nordic_uart_request_burst(2000);
+    }
+    int64_t dt_us = esp_timer_get_time() - t0;
+    free(line);
+
+    cJSON* root = cJSON_CreateObject();
+    cJSON* res = root ? cJSON_AddObjectToObject(root, "tput") : NULL;
+    if (res) {
+        cJSON_AddNumberToObject(res, "bytes", sent);
+        cJSON_AddNumberToObject(res, "ms", (double)(dt_us / 1000));
+        cJSON_AddNumberToObject(res, "kBps", dt_us > 0 ? (double)sent * 1000.0 / (double)dt_us : 0);
+        cJSON_AddBoolToObject(res, "ok", ok);
+        add_link_fields(res);
+        send_json(root);
+    }
+    cJSON_Delete(root);
+    ESP_LOGI(TAG, "tput: %u bytes in %lld ms", (unsigned)sent, (long long)(dt_us / 1000));
+    s_tput_running = false;
+    vTaskDelete(NULL);
+}
+
+// "watchface/label", or just the class when no named screen holds it
+static cJSON* perf_widget_name(const char* owner, const char* widget)
+{
+    char name[48];
+    snprintf(name, sizeof(name), "%s%s%s", owner ? owner : "", owner ? "/" : "", widget ? widget : "");
+    return cJSON_CreateString(name);
+}
+
+static void send_perf(cJSON* root)
+{
+    cJSON* overlay = cJSON_GetObjectItem(root, "overlay");
+    if (cJSON_IsBool(overlay) && bsp_display_lock(150)) {
+        ui_perf_set_overlay(cJSON_IsTrue(overlay));
+        bsp_display_unlock();
+    }
+    cJSON* nj = cJSON_GetObjectItem(root, "n");
+    uint32_t n = cJSON_IsNumber(nj) && nj->valuedouble >= 0 ? (uint32_t)nj->valuedouble : PERF_LAST_DEFAULT;
+    if (n > UI_PERF_FRAMES) n = UI_PERF_FRAMES;
+
+    ui_perf_summary_t s;
+    ui_perf_get_summary(PERF_WINDOW_MS, &s);
+    ui_perf_frame_t* f = n ? (ui_perf_frame_t*)malloc(sizeof(*f) * n) : NULL;
+    n = f ? ui_perf_get_frames(f, n) : 0;
+
+    cJSON* out = cJSON_CreateObject();
+    cJSON* p = out ? cJSON_AddObjectToObject(out, "perf") : NULL;
+    if (p) {
+        cJSON_AddNumberToObject(p, "total", ui_perf_frames_total());
+        cJSON_AddNumberToObject(p, "frames", s.frames);
+        cJSON_AddNumberToObject(p, "span_ms", s.span_ms);
+        cJSON_AddNumberToObject(p, "fps", s.fps_x10 / 10.0);
+        cJSON_AddNumberToObject(p, "render_ms", s.render_us_avg / 1000.0);
+        cJSON_AddNumberToObject(p, "render_ms_max", s.render_us_max / 1000.0);
+        cJSON_AddNumberToObject(p, "flush_ms", s.flush_us_avg / 1000.0);
+        cJSON_AddNumberToObject(p, "flush_ms_max", s.flush_us_max / 1000.0);
+        cJSON_AddNumberToObject(p, "px", s.px_avg);
+        cJSON_AddNumberToObject(p, "busy_pct", s.busy_pct);
+        cJSON_AddItemToObject(p, "top", perf_widget_name(s.top_owner, s.top_widget));
+        cJSON* last = cJSON_AddArrayToObject(p, "last");
+        for (uint32_t i = 0; last && i < n; ++i) {
+            cJSON* e = cJSON_CreateArray();
+            if (!e) break;
+            cJSON_AddItemToArray(e, cJSON_CreateNumber(f[i].t_ms));
+            cJSON_AddItemToArray(e, cJSON_CreateNumber(f[i].render_us));
+            cJSON_AddItemToArray(e, cJSON_CreateNumber(f[i].flush_us));
+            cJSON_AddItemToArray(e, cJSON_CreateNumber(f[i].px));
+            cJSON_AddItemToArray(e, cJSON_CreateNumber(f[i].areas));
+            cJSON_AddItemToArray(e, perf_widget_name(f[i].owner, f[i].widget));
+            cJSON_AddItemToArray(last, e);
+        }
+        send_json(out);
+    }
+    cJSON_Delete(out);
+    free(f);
+}
+
+static void handle_bench_cmd(const char* cmd, cJSON* root, int64_t rx_us)
+{
+    if (strcmp(cmd, "link") == 0) {
+        cJSON* out = cJSON_CreateObject();
+        cJSON* li = out ? cJSON_AddObjectToObject(out, "link") : NULL;
+        if (li) {
+            add_link_fields(li);
+            send_json(out);
+        }
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "audio") == 0) {
+        audio_alert_stats_t st;
+        audio_alert_get_stats(&st);
+        cJSON* out = cJSON_CreateObject();
+        cJSON* a = out ? cJSON_AddObjectToObject(out, "audio") : NULL;
+        if (a) {
+            cJSON_AddNumberToObject(a, "requests", st.requests);
+            cJSON_AddNumberToObject(a, "played", st.played);
+            cJSON_AddNumberToObject(a, "merged", st.merged);
+            cJSON_AddNumberToObject(a, "dropped", st.dropped);
+            cJSON_AddNumberToObject(a, "preempted", st.preempted);
+            cJSON_AddNumberToObject(a, "cancelled", st.cancelled);
+            cJSON_AddNumberToObject(a, "enqueue_us_max", st.enqueue_us_max);
+            cJSON_AddNumberToObject(a, "enqueue_us_avg",
+                                    st.requests ? (double)st.enqueue_us_total / st.requests : 0);
+            cJSON_AddNumberToObject(a, "cache_bytes", st.cache_bytes);
+            cJSON_AddNumberToObject(a, "first_write_cold_us", st.first_write_cold_us);
+            cJSON_AddNumberToObject(a, "first_write_warm_us", st.first_write_warm_us);
+            cJSON_AddNumberToObject(a, "first_write_warm_us_max", st.first_write_warm_us_max);
+            cJSON_AddNumberToObject(a, "power_ups", st.power_ups);
+            send_json(out);
+        }
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "boot") == 0) {
+        boot_seq_event_t ev[BOOT_SEQ_MAX_EVENTS];
+        const size_t n = boot_seq_get_timeline(ev, BOOT_SEQ_MAX_EVENTS);
+        cJSON* out = cJSON_CreateObject();
+        cJSON* list = out ? cJSON_AddArrayToObject(out, "boot") : NULL;
+        if (list) {
+            for (size_t i = 0; i < n; ++i) {
+                cJSON* e = cJSON_CreateObject();
+                if (!e) break;
+                cJSON_AddStringToObject(e, "name", ev[i].name);
+                cJSON_AddNumberToObject(e, "start_ms", ev[i].start_us / 1000.0);
+                // Marks (task starts, first frame) have no end
+                if (ev[i].phase) cJSON_AddNumberToObject(e, "end_ms", ev[i].end_us / 1000.0);
+                cJSON_AddNumberToObject(e, "core", ev[i].core);
+                cJSON_AddItemToArray(list, e);
+            }
+            send_json(out);
+        }
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "perf") == 0) {
+        send_perf(root);
+    } else if (strcmp(cmd, "wakeups") == 0) {
+        ui_refresh_stats_t st;
+        ui_refresh_get_stats(&st);
+        // Over the last complete window, zero until there is one
+        const double per_s = st.window_ms ? 1000.0 / st.window_ms : 0;
+        cJSON* out = cJSON_CreateObject();
+        cJSON* w = out ? cJSON_AddObjectToObject(out, "wakeups") : NULL;
+        if (w) {
+            cJSON_AddNumberToObject(w, "window_ms", st.window_ms);
+            cJSON_AddBoolToObject(w, "active", st.active);
+            cJSON_AddNumberToObject(w, "touch_hz", st.touch_reads * per_s);
+            cJSON_AddNumberToObject(w, "tick_hz", st.ticks * per_s);
+            cJSON_AddNumberToObject(w, "frames_hz", st.frames * per_s);
+            cJSON* cpu = cJSON_AddArrayToObject(w, "cpu_wakeups");
+            for (int i = 0; cpu && i < 2; ++i) {
+                cJSON_AddItemToArray(cpu, cJSON_CreateNumber(st.idle_wakeups[i] * per_s));
+            }
+            cJSON_AddNumberToObject(w, "os_tick_hz", configTICK_RATE_HZ);
+            send_json(out);
+        }
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "state") == 0) {
+        ui_state_stats_t st;
+        ui_state_get_stats(&st);
+        // Over the last complete minute of display-on time
+        const double per_min = st.window_ms ? 60000.0 / st.window_ms : 0;
+        cJSON* out = cJSON_CreateObject();
+        cJSON* o = out ? cJSON_AddObjectToObject(out, "state") : NULL;
+        if (o) {
+            cJSON_AddNumberToObject(o, "window_ms", st.window_ms);
+            cJSON_AddNumberToObject(o, "updates_per_min", st.updates * per_min);
+            cJSON_AddNumberToObject(o, "rtc_reads_per_min", st.rtc_reads * per_min);
+            cJSON_AddNumberToObject(o, "pmu_reads_per_min", st.pmu_reads * per_min);
+            cJSON* v = cJSON_AddObjectToObject(o, "values");
+            for (int i = 0; v && i < UI_STATE_COUNT; ++i) {
+                cJSON_AddNumberToObject(v, ui_state_name((ui_state_id_t)i), ui_state_get((ui_state_id_t)i));
+            }
+            send_json(out);
+        }
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "echo") == 0) {
+        cJSON* out = cJSON_CreateObject();
+        if (!out) return;
+        cJSON* seq = cJSON_GetObjectItem(root, "seq");
+        cJSON* t = cJSON_GetObjectItem(root, "t");
+        cJSON_AddNumberToObject(out, "echo", cJSON_IsNumber(seq) ? seq->valuedouble : 0);
+        if (cJSON_IsNumber(t)) cJSON_AddNumberToObject(out, "t", t->valuedouble);
+        // Watch-side processing time so the phone can split RTT into air and CPU
+        cJSON_AddNumberToObject(out, "us", (double)(esp_timer_get_time() - rx_us));
+        send_json(out);
+        cJSON_Delete(out);
+    } else if (strcmp(cmd, "tput") == 0) {
+        if (s_tput_running) return;
+        cJSON* bytes = cJSON_GetObjectItem(root, "bytes");
+        uint32_t n = cJSON_IsNumber(bytes) ? (uint32_t)bytes->valuedouble : TPUT_DEFAULT_BYTES;
+        if (n == 0) n = TPUT_DEFAULT_BYTES;
+        if (n > TPUT_MAX_BYTES) n = TPUT_MAX_BYTES;
+        s_tput_running = true;
+        // Stream from a separate task so uartTask keeps draining RX
+        if (xTaskCreate(tput_task, "ble_tput", 3072, (void*)(uintptr_t)n, 2, NULL) != pdPASS) {
+            s_tput_running = false;
+        }
+    }
+}
+
+// ---- File transfer --------------------------------------------------------
+// {"cmd":"ft_begin","name":s,"size":n,"crc":n} -> {"ft":"ready","offset":..}
+// binary frames on the bulk characteristic      -> {"ft":"ack"|"nak",...}
+// {"cmd":"ft_end"} / {"cmd":"ft_abort"}          -> {"ft":"done",...}
+// {"cmd":"app_set","id":s,"name":s,"icon":s}     -> {"app":"ok"|"error","id":s,...}
+// {"cmd":"app_del","id":s}                       -> same
+//
+// app_set registers an app's name and icon with the app registry; "icon" is
+// a file uploaded before it (a 96x96 RGB565A8 LVGL .bin). It goes through
+// the same queue so it runs after the ft_end that renamed the icon in place.
+//
+// Everything that touches the engine is funnelled through one ring buffer to
+// the "ble_ft" task: the bulk handler runs on the NimBLE host task and must not
+// wait for SPIFFS, and control commands stay ordered with the frames before them.
+
+#define FT_RB_SIZE      4096
+#define FT_BURST_MS     3000
+
+enum { FT_ITEM_DATA, FT_ITEM_BEGIN, FT_ITEM_END, FT_ITEM_ABORT, FT_ITEM_SUSPEND, FT_ITEM_APP_SET, FT_ITEM_APP_DEL };
+
+typedef struct {
+    uint32_t size;
+    uint32_t crc;
+    uint16_t max_chunk;
+    char name[FILE_TRANSFER_NAME_MAX + 1];
+} ft_begin_item_t;
+
+typedef struct {
+    char id[APP_REGISTRY_ID_MAX];
+    char name[APP_REGISTRY_NAME_MAX];
+    char icon[APP_REGISTRY_FILE_MAX];
+} ft_app_item_t;
+
+static RingbufHandle_t s_ft_rb = NULL;
+static uint32_t s_ft_dropped = 0;
+static int64_t s_ft_t0_us = 0;
+static uint32_t s_ft_wear_bytes = 0;   // part of this upload already in the wear counters
+
+static void ft_reply(const char* line)
+{
+    (void)nordic_uart_sendln(line);
+}
+
+static bool ft_post(uint8_t type, const void* data, size_t len, TickType_t wait)
+{
+    if (!s_ft_rb) return false;
+    void* slot = NULL;
+    if (xRingbufferSendAcquire(s_ft_rb, &slot, len + 1, wait) != pdTRUE) return false;
+    ((uint8_t*)slot)[0] = type;
+    if (len) memcpy((uint8_t*)slot + 1, data, len);
+    return xRingbufferSendComplete(s_ft_rb, slot) == pdTRUE;
+}
+
+static void ft_bulk_rx(const uint8_t* data, size_t len)
+{
+    // Dropping here is safe: the next frame leaves a gap and the receiver naks
+    if (!ft_post(FT_ITEM_DATA, data, len, 0)) s_ft_dropped++;
+}
+
+// Uploads are SPIFFS writes; account for them when a transfer stops
+static void ft_note_wear(void)
+{
+    file_transfer_stats_t st;
+    file_transfer_get_stats(&st);
+    if (st.bytes > s_ft_wear_bytes) settings_wear_note(SETTINGS_PART_STORAGE, st.bytes - s_ft_wear_bytes, 0);
+    s_ft_wear_bytes = st.bytes;
+}
+
+static void app_reply(const char* id, esp_err_t err)
+{
+    cJSON* out = cJSON_CreateObject();
+    if (!out) return;
+    cJSON_AddStringToObject(out, "app", err == ESP_OK ? "ok" : "error");
+    cJSON_AddStringToObject(out, "id", id);
+    if (err != ESP_OK) cJSON_AddStringToObject(out, "reason", esp_err_to_name(err));
+    send_json(out);
+    cJSON_Delete(out);
+}
+
+// The registry may swap an icon that is on screen, so that step runs
+// under the display lock. Decoding the icon and writing the table read and
+// write flash and stay outside it.
+static void app_apply(uint8_t type, const ft_app_item_t* a)
+{
+    app_registry_icon_t icon = { 0 };
+    esp_err_t err = type == FT_ITEM_APP_SET ? app_registry_icon_load(a->icon, &icon) : ESP_OK;
+    if (err == ESP_OK) {
+        bool locked = false;
+        for (int i = 0; i < 3 && !locked; ++i) {
+            locked = bsp_display_lock(150);
+            if (!locked) vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        if (locked) {
+            err = type == FT_ITEM_APP_SET ? app_registry_set(a->id, a->name, a->icon, &icon)
+                                          : app_registry_remove(a->id);
+            bsp_display_unlock();
+            if (err == ESP_OK) err = app_registry_save();
+        } else {
+            err = ESP_ERR_TIMEOUT;
+        }
+    }
+    app_registry_icon_free(&icon);
+    app_reply(a->id, err);
+}
+
+static void ft_task(void* arg)
+{
+    for (;;) {
+        size_t n = 0;
+        uint8_t* item = (uint8_t*)xRingbufferReceive(s_ft_rb, &n, portMAX_DELAY);
+        if (!item) continue;
+        switch (item[0]) {
+        case FT_ITEM_DATA:
+            (void)file_transfer_on_data(item + 1, n - 1);
+            // Keep the link in the fast profile while frames keep coming
+            nordic_uart_request_burst(FT_BURST_MS);
+            break;
+        case FT_ITEM_BEGIN: {
+            ft_begin_item_t b;
+            memcpy(&b, item + 1, sizeof(b));
+            ft_note_wear();             // begin() resets the stats of an upload it suspends
+            s_ft_dropped = 0;
+            s_ft_wear_bytes = 0;
+            s_ft_t0_us = esp_timer_get_time();
+            if (file_transfer_begin(b.name, b.size, b.crc, b.max_chunk) == ESP_OK) {
+                nordic_uart_request_burst(FT_BURST_MS);
+            }
+            break;
+        }
+        case FT_ITEM_END: {
+            file_transfer_stats_t st;
+            file_transfer_get_stats(&st);
+            int64_t dt_ms = (esp_timer_get_time() - s_ft_t0_us) / 1000;
+            esp_err_t err = file_transfer_end();
+            ft_note_wear();
+            // The finished file replaced whatever had its name
+            if (err == ESP_OK) settings_storage_changed();
+            ESP_LOGI(TAG, "ft: %lu bytes, %lu frames, %lu crc, %lu gaps, %lu dup, %lu dropped, %lld ms",
+                     (unsigned long)st.bytes, (unsigned long)st.frames, (unsigned long)st.crc_errors,
+                     (unsigned long)st.gaps, (unsigned long)st.duplicates, (unsigned long)s_ft_dropped,
+                     (long long)dt_ms);
+            break;
+        }
+        case FT_ITEM_ABORT:
+            ft_note_wear();
+            file_transfer_abort();
+            break;
+        case FT_ITEM_SUSPEND:
+            ft_note_wear();
+            file_transfer_suspend();
+            break;
+        case FT_ITEM_APP_SET:
+        case FT_ITEM_APP_DEL: {
+            ft_app_item_t a;
+            memcpy(&a, item + 1, sizeof(a));
+            app_apply(item[0], &a);
+            break;
+        }
+        }
+        vRingbufferReturnItem(s_ft_rb, item);
+    }
+}
+
+static void ft_start(void)
+{
+    if (s_ft_rb) return;
+    s_ft_rb = xRingbufferCreate(FT_RB_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (!s_ft_rb) {
+        ESP_LOGE(TAG, "File transfer buffer alloc failed");
+        return;
+    }
+    file_transfer_init("/spiffs", ft_reply);
+    xTaskCreate(ft_task, "ble_ft", 3584, NULL, 2, NULL);
+    nordic_uart_set_bulk_handler(ft_bulk_rx);
+}
+
+static void handle_ft_cmd(const char* cmd, cJSON* root)
+{
+    if (strcmp(cmd, "ft_begin") == 0) {
+        cJSON* name = cJSON_GetObjectItem(root, "name");
+        cJSON* size = cJSON_GetObjectItem(root, "size");
+        cJSON* crc = cJSON_GetObjectItem(root, "crc");
+        if (!cJSON_IsString(name) || !cJSON_IsNumber(size) || !cJSON_IsNumber(crc)) {
+            ft_reply("{\"ft\":\"error\",\"reason\":\"args\"}");
+            return;
+        }
+        struct nordic_uart_link_info li;
+        nordic_uart_get_link_info(&li);
+        ft_begin_item_t b = {
+            .size = (uint32_t)size->valuedouble,
+            .crc = (uint32_t)crc->valuedouble,
+            // One frame per ATT write, sized like our own notifications
+            .max_chunk = (uint16_t)(li.chunk_len > FILE_TRANSFER_HDR_LEN ? li.chunk_len - FILE_TRANSFER_HDR_LEN : 12),
+        };
+        snprintf(b.name, sizeof(b.name), "%s", name->valuestring);
+        (void)ft_post(FT_ITEM_BEGIN, &b, sizeof(b), pdMS_TO_TICKS(100));
+    } else if (strcmp(cmd, "ft_end") == 0) {
+        (void)ft_post(FT_ITEM_END, NULL, 0, pdMS_TO_TICKS(100));
+    } else if (strcmp(cmd, "ft_abort") == 0) {
+        (void)ft_post(FT_ITEM_ABORT, NULL, 0, pdMS_TO_TICKS(100));
+    }
+}
+
+static void handle_app_cmd(const char* cmd, cJSON* root)
+{
+    cJSON* id = cJSON_GetObjectItem(root, "id");
+    cJSON* name = cJSON_GetObjectItem(root, "name");
+    cJSON* icon = cJSON_GetObjectItem(root, "icon");
+    const bool set = strcmp(cmd, "app_set") == 0;
+    if (!set && strcmp(cmd, "app_del") != 0) return;
+    if (!cJSON_IsString(id) || strlen(id->valuestring) >= APP_REGISTRY_ID_MAX ||
+        (cJSON_IsString(name) && strlen(name->valuestring) >= APP_REGISTRY_NAME_MAX) ||
+        (cJSON_IsString(icon) && strlen(icon->valuestring) >= APP_REGISTRY_FILE_MAX)) {
+        app_reply(cJSON_IsString(id) ? id->valuestring : "", ESP_ERR_INVALID_ARG);
+        return;
+    }
+    ft_app_item_t a = { 0 };
+    snprintf(a.id, sizeof(a.id), "%s", id->valuestring);
+    if (cJSON_IsString(name)) snprintf(a.name, sizeof(a.name), "%s", name->valuestring);
+    if (cJSON_IsString(icon)) snprintf(a.icon, sizeof(a.icon), "%s", icon->valuestring);
+    if (!ft_post(set ? FT_ITEM_APP_SET : FT_ITEM_APP_DEL, &a, sizeof(a), pdMS_TO_TICKS(100))) {
+        app_reply(a.id, ESP_ERR_NO_MEM);
+    }
+}
+
+// ---- Settings ---------------------------------------------------------------
+// {"cmd":"settings_get"}                  -> {"settings":{...},"store":{...}}
+// {"cmd":"settings_set","settings":{...}} -> same reply after the commit
+
+static void send_settings(void)
+{
+    char* json = settings_export_json();
+    cJSON* out = cJSON_CreateObject();
+    cJSON* values = json ? cJSON_Parse(json) : NULL;
+    free(json);
+    if (!out || !values) {
+        cJSON_Delete(out);
+        cJSON_Delete(values);
+        return;
+    }
+    cJSON_AddItemToObject(out, "settings", values);
+    settings_store_stats_t st;
+    settings_get_store_stats(&st);
+    cJSON* store = cJSON_AddObjectToObject(out, "store");
+    if (store) {
+        cJSON_AddNumberToObject(store, "load_us", st.load_us);
+        cJSON_AddNumberToObject(store, "record", st.record_bytes);
+        cJSON_AddNumberToObject(store, "seq", st.seq);
+        cJSON_AddNumberToObject(store, "commits", st.commits);
+        cJSON_AddNumberToObject(store, "last_bytes", st.last_commit_bytes);
+        cJSON_AddNumberToObject(store, "bytes", st.bytes_written);
+        cJSON_AddNumberToObject(store, "changes", st.changes);
+    }
+    static const char* const part_names[SETTINGS_PART_COUNT] = { "nvs", "storage" };
+    cJSON* wear = cJSON_AddObjectToObject(out, "wear");
+    for (int i = 0; wear && i < SETTINGS_PART_COUNT; ++i) {
+        settings_wear_t w;
+        settings_get_wear((settings_part_t)i, &w);
+        cJSON* p = cJSON_AddObjectToObject(wear, part_names[i]);
+        if (!p) break;
+        cJSON_AddNumberToObject(p, "bytes", (double)w.bytes_written);
+        cJSON_AddNumberToObject(p, "erases", w.erases);
+    }
+    send_json(out);
+    cJSON_Delete(out);
+}
+
+static void handle_settings_cmd(const char* cmd, cJSON* root)
+{
+    if (strcmp(cmd, "settings_set") == 0) {
+        cJSON* values = cJSON_GetObjectItem(root, "settings");
+        char* json = cJSON_IsObject(values) ? cJSON_PrintUnformatted(values) : NULL;
+        bool ok = json && settings_import_json(json);
+        free(json);
+        if (!ok) {
+            (void)nordic_uart_sendln("{\"settings\":null,\"error\":\"invalid\"}");
+            return;
+        }
+    }
+    send_settings();
+}
+
 static void process_one_json_object(const char* json, size_t len)
 {
+    int64_t rx_us = esp_timer_get_time();
     // cJSON requires a C-string; ensure local null-terminated copy for parsing
     char* tmp = (char*)malloc(len + 1);
     if (!tmp) return;
@@ -133,6 +713,7 @@ static void process_one_json_object(const char* json, size_t len)
                 .tm_min = minute,
                 .tm_sec = second };
             rtc_set_time(&t);
+            s_time_synced = true;
             ESP_LOGI(TAG, "RTC updated");
         }
     }
@@ -152,7 +733,20 @@ static void process_one_json_object(const char* json, size_t len)
     cJSON* status = cJSON_GetObjectItem(root, "status");
     if (cJSON_IsString(status)) {
         ESP_LOGI(TAG, "Status");
-        ble_sync_send_status(bsp_power_get_battery_percent(), bsp_power_is_charging());
+        ble_sync_send_status(ui_state_get(UI_STATE_BATTERY), ui_state_get(UI_STATE_CHARGING));
+    }
+
+    cJSON* cmd = cJSON_GetObjectItem(root, "cmd");
+    if (cJSON_IsString(cmd)) {
+        if (strncmp(cmd->valuestring, "ft_", 3) == 0) {
+            handle_ft_cmd(cmd->valuestring, root);
+        } else if (strncmp(cmd->valuestring, "settings_", 9) == 0) {
+            handle_settings_cmd(cmd->valuestring, root);
+        } else if (strncmp(cmd->valuestring, "app_", 4) == 0) {
+            handle_app_cmd(cmd->valuestring, root);
+        } else {
+            handle_bench_cmd(cmd->valuestring, root, rx_us);
+        }
     }
 
     cJSON_Delete(root);
@@ -162,17 +756,22 @@ static void process_one_json_object(const char* json, size_t len)
 void uartTask(void* parameter) {
     static char mbuf[CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1];
 
+    boot_seq_mark("ble uart task");
+
     for (;;) {
         size_t item_size;
+        enum nordic_uart_rx_lane lane;
         if (nordic_uart_rx_buf_handle) {
-            const char* item = (char*)xRingbufferReceive(nordic_uart_rx_buf_handle, &item_size, portMAX_DELAY);
+            // Control lane first: commands and time sync never wait behind a notification burst
+            char* item = nordic_uart_rx_receive(&item_size, &lane, portMAX_DELAY);
 
             if (item) {
                 memcpy(mbuf, item, item_size);
                 mbuf[item_size] = '\0';
-                vRingbufferReturnItem(nordic_uart_rx_buf_handle, (void*)item);
+                nordic_uart_rx_return(item, lane);
 
-                ESP_LOGI(TAG, "Received chunk: %u bytes", (unsigned)item_size);
+                ESP_LOGI(TAG, "Received %s chunk: %u bytes", lane == NORDIC_UART_RX_LANE_CONTROL ? "control" : "bulk",
+                         (unsigned)item_size);
                 ESP_LOGI(TAG, "Received buffer: %s", mbuf);
 
                 process_one_json_object(mbuf, item_size);
@@ -193,47 +792,20 @@ static void nordic_uart_callback(enum nordic_uart_callback_type callback_type) {
         ESP_LOGI(TAG, "Nordic UART connected");
         s_ble_connected = true;
         (void)esp_event_post(BLE_SYNC_EVENT_BASE, BLE_SYNC_EVT_CONNECTED, NULL, 0, 0);
-        // Optionally send immediate status upon connect
-        ble_sync_send_status(bsp_power_get_battery_percent(), bsp_power_is_charging());
-
-        // Minimize time/date requests: if RTC is earlier than 2025-02-02, request sync once on connect
-        {
-            bool need_sync = false;
-            // Use direct RTC helpers for clarity
-            int y = rtc_get_year();
-            int m = rtc_get_month();
-            int d = rtc_get_day();
-            if (y <= 0 || m <= 0 || d <= 0) {
-                need_sync = true;
-            } else {
-                int cur = y * 10000 + m * 100 + d;
-                const int threshold = 2025 * 10000 + 2 * 100 + 2; // 2025-02-02
-                if (cur < threshold) need_sync = true;
-            }
-            ESP_LOGI(TAG, "RTC date on connect: %04d-%02d-%02d, need_sync=%d", y, m, d, (int)need_sync);
-            if (need_sync && !s_time_sync_requested) {
-                s_time_sync_requested = true;
-                // Fire once shortly after connect to avoid race with ATT setup
-                if (!s_time_sync_timer) {
-                    s_time_sync_timer = xTimerCreate("ble_time_sync", pdMS_TO_TICKS(1500), pdFALSE, NULL, time_sync_timer_cb);
-                }
-                if (s_time_sync_timer) {
-                    xTimerStart(s_time_sync_timer, 0);
-                } else {
-                    // Fallback: send immediately
-                    time_sync_timer_cb(NULL);
-                }
-            }
-        }
-
+        break;
+    case NORDIC_UART_SUBSCRIBED:
+        // First moment notifications can reach the phone; a bonded phone gets
+        // here right after re-encryption without writing the CCCD again
+        ESP_LOGI(TAG, "Nordic UART subscribed");
+        ble_sync_send_status(ui_state_get(UI_STATE_BATTERY), ui_state_get(UI_STATE_CHARGING));
+        request_time_sync_if_needed();
         break;
     case NORDIC_UART_DISCONNECTED:
         ESP_LOGI(TAG, "Nordic UART disconnected");
         s_ble_connected = false;
         s_time_sync_requested = false;
-        if (s_time_sync_timer) {
-            xTimerStop(s_time_sync_timer, 0);
-        }
+        // Keep the .part file; the phone resumes from it on the next ft_begin
+        (void)ft_post(FT_ITEM_SUSPEND, NULL, 0, 0);
         (void)esp_event_post(BLE_SYNC_EVENT_BASE, BLE_SYNC_EVT_DISCONNECTED, NULL, 0, 0);
         break;
     }
@@ -259,6 +831,7 @@ esp_err_t ble_sync_init(void)
     }
 
     xTaskCreate(uartTask, "uartTask", 4000, NULL, 3, NULL);
+    ft_start();
 
     // Periodic status every 5 minutes when connected
     if (!s_status_timer) {
@@ -288,9 +861,8 @@ esp_err_t ble_sync_send_status(int battery_percent, bool charging)
     cJSON_AddNumberToObject(root, "battery", battery_percent);
     cJSON_AddBoolToObject(root, "charging", charging);
     // Include VBUS presence for richer client status
-    bool vbus = (bsp_power_get_vbus_voltage_mv() > 0);
-    cJSON_AddBoolToObject(root, "vbus", vbus);
-    cJSON_AddNumberToObject(root, "steps", sensors_get_step_count());
+    cJSON_AddBoolToObject(root, "vbus", ui_state_get(UI_STATE_VBUS));
+    cJSON_AddNumberToObject(root, "steps", ui_state_get(UI_STATE_STEPS));
 
     char* json_str = cJSON_PrintUnformatted(root);
     cJSON_Delete(root);
@@ -349,9 +921,6 @@ esp_err_t ble_sync_set_enabled(bool enabled)
     if (s_status_timer) {
         xTimerStop(s_status_timer, 0);
     }
-    if (s_time_sync_timer) {
-        xTimerStop(s_time_sync_timer, 0);
-    }
 
     if (s_ble_stack_started) {
         esp_err_t adv_err = nordic_uart_set_advertising_enabled(false);
@@ -0,0 +1,175 @@
+#include "boot_seq.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char* TAG = "BOOT_SEQ";
+
+// Above app_main (1) and the LVGL task, like the UI task the phases replace
+#define BOOT_SEQ_PRIO 4
+
+typedef struct {
+    const boot_seq_phase_t* phases;
+    size_t count;
+    uint32_t started;               // phases taken by a worker
+    uint32_t failed;                // phases that failed or were skipped
+    EventGroupHandle_t done;        // bit i: phase i returned
+    SemaphoreHandle_t exited;       // given by each worker on its way out
+} run_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static boot_seq_event_t s_events[BOOT_SEQ_MAX_EVENTS];
+static size_t s_count;
+
+static int event_add(const char* name, bool phase)
+{
+    const uint32_t now = (uint32_t)esp_timer_get_time();
+    int i = -1;
+    taskENTER_CRITICAL(&s_lock);
+    if (s_count < BOOT_SEQ_MAX_EVENTS) {
+        i = (int)s_count++;
+        s_events[i] = (boot_seq_event_t){
+            .name = name, .start_us = now, .end_us = now, .core = (int8_t)xPortGetCoreID(), .phase = phase
+        };
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    return i;
+}
+
+void boot_seq_mark(const char* name)
+{
+    (void)event_add(name, false);
+}
+
+// Lowest-index phase that is not taken, may run on `core` and has all it
+// needs done; -1 if there is none right now. A phase that needs a failed
+// one is taken on any core, as soon as that failed, with *skip set.
+static int take_ready(run_t* r, EventBits_t done, int core, bool* skip)
+{
+    int pick = -1;
+    taskENTER_CRITICAL(&s_lock);
+    for (size_t i = 0; i < r->count; ++i) {
+        const boot_seq_phase_t* p = &r->phases[i];
+        if (r->started & BOOT_SEQ_AFTER(i)) continue;
+        *skip = (p->after & r->failed) != 0;
+        if (!*skip && (p->after & ~done)) continue;
+        if (!*skip && p->core != BOOT_SEQ_ANY_CORE && p->core != core) continue;
+        r->started |= BOOT_SEQ_AFTER(i);
+        pick = (int)i;
+        break;
+    }
+    taskEXIT_CRITICAL(&s_lock);
+    return pick;
+}
+
+static void worker(void* arg)
+{
+    run_t* r = arg;
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    const int core = (int)xPortGetCoreID();
+    const EventBits_t all = (EventBits_t)(BOOT_SEQ_AFTER(r->count) - 1);
+    for (;;) {
+        const EventBits_t done = xEventGroupGetBits(r->done) & all;
+        if (done == all) break;
+        bool skip = false;
+        const int i = take_ready(r, done, core, &skip);
+        if (i < 0) {
+            // Bits are only ever set, so this returns at once if a phase
+            // finished after `done` was read
+            (void)xEventGroupWaitBits(r->done, all & ~done, pdFALSE, pdFALSE, portMAX_DELAY);
+            continue;
+        }
+        const boot_seq_phase_t* p = &r->phases[i];
+        esp_err_t err = ESP_FAIL;
+        if (skip) {
+            ESP_LOGE(TAG, "%s skipped: a phase it needs failed", p->name);
+        } else {
+            const int ev = event_add(p->name, true);
+            err = p->fn();
+            if (ev >= 0) s_events[ev].end_us = (uint32_t)esp_timer_get_time();
+            if (err != ESP_OK) ESP_LOGE(TAG, "%s failed: %s", p->name, esp_err_to_name(err));
+        }
+        if (err != ESP_OK) {
+            // Before the done bit, so whoever sees that sees this too
+            taskENTER_CRITICAL(&s_lock);
+            r->failed |= BOOT_SEQ_AFTER(i);
+            taskEXIT_CRITICAL(&s_lock);
+        }
+        xEventGroupSetBits(r->done, BOOT_SEQ_AFTER(i));
+    }
+    // r lives on the caller's stack: last access
+    xSemaphoreGive(r->exited);
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_seq_run(const boot_seq_phase_t* phases, size_t count, uint32_t stack)
+{
+    if (!phases || count == 0 || count > BOOT_SEQ_MAX_PHASES) return ESP_ERR_INVALID_ARG;
+    for (size_t i = 0; i < count; ++i) {
+        if (!phases[i].fn || (phases[i].after >> i)) return ESP_ERR_INVALID_ARG;
+    }
+
+    run_t r = { .phases = phases, .count = count };
+    r.done = xEventGroupCreate();
+    r.exited = xSemaphoreCreateCounting(portNUM_PROCESSORS, 0);
+    if (!r.done || !r.exited) {
+        if (r.done) vEventGroupDelete(r.done);
+        if (r.exited) vSemaphoreDelete(r.exited);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Workers wait for a notification, so a failed create leaves no phase
+    // half run: pinned phases need every core's worker
+    TaskHandle_t tasks[portNUM_PROCESSORS] = { 0 };
+    bool ok = true;
+    for (int core = 0; core < portNUM_PROCESSORS && ok; ++core) {
+        ok = xTaskCreatePinnedToCore(worker, core ? "boot1" : "boot0", stack, &r, BOOT_SEQ_PRIO, &tasks[core],
+                                     core) == pdPASS;
+    }
+    if (!ok) {
+        for (int core = 0; core < portNUM_PROCESSORS; ++core) {
+            if (tasks[core]) vTaskDelete(tasks[core]);
+        }
+        vEventGroupDelete(r.done);
+        vSemaphoreDelete(r.exited);
+        ESP_LOGE(TAG, "No memory for the boot workers");
+        return ESP_ERR_NO_MEM;
+    }
+
+    const int64_t t0 = esp_timer_get_time();
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) xTaskNotifyGive(tasks[core]);
+    for (int core = 0; core < portNUM_PROCESSORS; ++core) xSemaphoreTake(r.exited, portMAX_DELAY);
+
+    vEventGroupDelete(r.done);
+    vSemaphoreDelete(r.exited);
+    ESP_LOGI(TAG, "%u phases in %lld ms", (unsigned)count, (long long)((esp_timer_get_time() - t0) / 1000));
+    return r.failed ? ESP_FAIL : ESP_OK;
+}
+
+size_t boot_seq_get_timeline(boot_seq_event_t* out, size_t max)
+{
+    taskENTER_CRITICAL(&s_lock);
+    size_t n = s_count < max ? s_count : max;
+    for (size_t i = 0; i < n; ++i) out[i] = s_events[i];
+    taskEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void boot_seq_log(void)
+{
+    boot_seq_event_t ev[BOOT_SEQ_MAX_EVENTS];
+    const size_t n = boot_seq_get_timeline(ev, BOOT_SEQ_MAX_EVENTS);
+    ESP_LOGI(TAG, "Boot timeline (ms since boot):");
+    for (size_t i = 0; i < n; ++i) {
+        const unsigned start = ev[i].start_us / 100, end = ev[i].end_us / 100;
+        if (ev[i].phase) {
+            ESP_LOGI(TAG, "  %5u.%u  %5u.%u  +%4u.%u  core %d  %s", start / 10, start % 10, end / 10, end % 10,
+                     (end - start) / 10, (end - start) % 10, ev[i].core, ev[i].name);
+        } else {
+            ESP_LOGI(TAG, "  %5u.%u                    core %d  %s", start / 10, start % 10, ev[i].core, ev[i].name);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Boot bring-up and its timeline.
+//
+// boot_seq_run() runs a table of init phases. Each phase lists the earlier
+// phases it needs; a worker task per core takes the first phase whose
+// needs are done, so phases that don't depend on each other (the panel,
+// the SPIFFS mount, the NimBLE host) run at the same time. It returns once
+// every phase has finished.
+//
+// A phase that returns an error fails, and the phases that need it,
+// directly or through others, are skipped rather than run on a half
+// brought-up system. The rest still run.
+//
+// Phase starts and ends, and boot_seq_mark() calls from tasks (their
+// start, the first frame), are stamped with esp_timer_get_time() into a
+// fixed table of BOOT_SEQ_MAX_EVENTS entries. Later marks are dropped.
+
+#define BOOT_SEQ_MAX_PHASES 16
+#define BOOT_SEQ_MAX_EVENTS 32
+#define BOOT_SEQ_ANY_CORE   (-1)
+#define BOOT_SEQ_AFTER(i)   (1u << (i))
+
+typedef struct {
+    const char* name;
+    esp_err_t (*fn)(void);
+    uint32_t after;         // BOOT_SEQ_AFTER(i) of earlier phases, OR'ed
+    int core;               // 0, 1 or BOOT_SEQ_ANY_CORE
+} boot_seq_phase_t;
+
+typedef struct {
+    const char* name;
+    uint32_t start_us;      // since boot
+    uint32_t end_us;        // same as start_us for marks
+    int8_t core;
+    bool phase;
+} boot_seq_event_t;
+
+// ESP_ERR_INVALID_ARG when a phase needs itself or a later one (which
+// could never run); ESP_FAIL when a phase failed or was skipped, after
+// logging which. `stack` is the stack of each worker, sized for the
+// largest phase.
+esp_err_t boot_seq_run(const boot_seq_phase_t* phases, size_t count, uint32_t stack);
+
+// Safe from any task; `name` must stay valid (a literal)
+void boot_seq_mark(const char* name);
+
+// Copies up to `max` events in the order they started; returns the count
+size_t boot_seq_get_timeline(boot_seq_event_t* out, size_t max);
+
+// Timeline to the log, one line per event
+void boot_seq_log(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,6 +1,7 @@
 #ifndef __RTC_H__
 #define __RTC_H__
 
+#include <stdint.h>
 #include <time.h>
 #include "esp_err.h"
 
@@ -17,5 +18,12 @@ int rtc_get_year(void);
 const char *rtc_get_weekday_string(void);
 const char *rtc_get_weekday_short_string(void);
 const char *rtc_get_month_string(void);
+// "SUN".."SAT" for a struct tm weekday
+const char *rtc_weekday_short_name(int wday);
+
+// Times the chip was read over I2C since boot. The time is kept by
+// esp_timer between reads, which happen at start, after rtc_set_time()
+// and once an hour.
+uint32_t rtc_get_chip_reads(void);
 
 #endif /* __RTC_H__ */
@@ -2,17 +2,51 @@
 #include "pcf85063a.h"
 #include <time.h>
 #include "esp_timer.h"
+#include <stdbool.h>
 
+// The chip is read when the clock starts, when it is set and on the hour;
+// in between the time is carried forward from esp_timer
 static struct tm current_time;
+static struct tm base_time;         // last read of the chip
+static int64_t base_us;             // esp_timer at that read
+static uint32_t chip_reads;
 static esp_timer_handle_t rtc_timer;
+static bool rtc_periodic;
 
 static const char *weekdays[] = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 static const char *weekdaysshort[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
 static const char *months[] = {"January", "February", "March", "April", "May", "June", "July", "August", "September", "October", "November", "December"};
 
+static void read_chip(void)
+{
+    struct tm t;
+    chip_reads++;
+    if (pcf85063a_get_time(&t) != ESP_OK) {
+        // Keep counting from the previous read
+        return;
+    }
+    base_time = t;
+    base_us = esp_timer_get_time();
+    current_time = base_time;
+}
+
+// Runs on each second boundary of esp_timer. The UI's one second tick
+// fires just after it, so the clock shows the time of that second. The
+// date can only change on the hour, where the chip is read again.
 static void rtc_update_task(void *arg)
 {
-    pcf85063a_get_time(&current_time);
+    const int64_t elapsed_s = (esp_timer_get_time() - base_us) / 1000000;
+    const int64_t sod = base_time.tm_hour * 3600 + base_time.tm_min * 60 + base_time.tm_sec + elapsed_s;
+    if (sod / 3600 != base_time.tm_hour) {
+        read_chip();
+    } else {
+        current_time.tm_min = (int)(sod / 60 % 60);
+        current_time.tm_sec = (int)(sod % 60);
+    }
+    if (!rtc_periodic) {
+        rtc_periodic = true;
+        esp_timer_start_periodic(rtc_timer, 1000000);
+    }
 }
 
 esp_err_t rtc_start(void)
@@ -32,7 +66,9 @@ esp_err_t rtc_start(void)
         return ret;
     }
 
-    return esp_timer_start_periodic(rtc_timer, 1000000); // 1 second
+    read_chip();
+    // First run on the next boundary, then every second from there
+    return esp_timer_start_once(rtc_timer, 1000000 - esp_timer_get_time() % 1000000);
 }
 
 esp_err_t rtc_get_time(struct tm *time)
@@ -43,7 +79,17 @@ esp_err_t rtc_get_time(struct tm *time)
 
 esp_err_t rtc_set_time(const struct tm *time)
 {
-    return pcf85063a_set_time(time);
+    esp_err_t ret = pcf85063a_set_time(time);
+    // Count from the new time (the chip is only read once the clock runs)
+    if (ret == ESP_OK && rtc_timer) {
+        read_chip();
+    }
+    return ret;
+}
+
+uint32_t rtc_get_chip_reads(void)
+{
+    return chip_reads;
 }
 
 int rtc_get_hour(void)
@@ -83,7 +129,12 @@ const char *rtc_get_weekday_string(void)
 
 const char *rtc_get_weekday_short_string(void)
 {
-    return weekdaysshort[current_time.tm_wday];
+    return rtc_weekday_short_name(current_time.tm_wday);
+}
+
+const char *rtc_weekday_short_name(int wday)
+{
+    return (wday >= 0 && wday < 7) ? weekdaysshort[wday] : "---";
 }
 
 const char *rtc_get_month_string(void)
@@ -57,6 +57,8 @@ static void display_turn_off_internal(void) {
   bsp_display_brightness_set(0);
   // Hint BLE to prefer low-power connection parameters while screen is off
   nordic_uart_set_low_power_mode(true);
+  // Nobody is changing settings with the screen dark; write what's pending
+  (void)settings_flush();
   // If you rely on GPIO wake (touch or PMU IRQ), you may allow light sleep.
   // If wake via polling is required, DO NOT release the lock here.
   // For stability, keep CPU out of light sleep while screen is off.
@@ -0,0 +1,399 @@
+#include "file_transfer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static const char* TAG = "FILE_XFER";
+
+#define FT_PATH_MAX 64
+
+static char s_base[32] = "/spiffs";
+static file_transfer_reply_cb_t s_reply = NULL;
+
+static struct {
+    bool active;
+    char name[FILE_TRANSFER_NAME_MAX + 1];
+    uint32_t size;
+    uint32_t crc;           // expected whole-file CRC
+    uint32_t run_crc;       // CRC of bytes [0, offset)
+    uint32_t offset;        // contiguous bytes on flash
+    uint16_t max_chunk;
+    uint8_t since_ack;
+    bool nak_sent;          // one nak per gap; cleared once the expected frame arrives
+    FILE* part;
+} s_ft;
+
+static file_transfer_stats_t s_stats;
+
+// ---- CRC32 (IEEE 802.3, reflected, same as zlib/binascii.crc32) ----------
+
+static uint32_t s_crc_table[256];
+
+static void crc_table_init(void)
+{
+    if (s_crc_table[1]) return;
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+        s_crc_table[i] = c;
+    }
+}
+
+uint32_t file_transfer_crc32(uint32_t crc, const void* data, size_t len)
+{
+    crc_table_init();
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) crc = s_crc_table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// ---- helpers -------------------------------------------------------------
+
+// fmt takes one %lu
+static void reply(const char* fmt, uint32_t value)
+{
+    if (!s_reply) return;
+    char line[128];
+    snprintf(line, sizeof(line), fmt, (unsigned long)value);
+    s_reply(line);
+}
+
+static void reply_error(const char* what)
+{
+    if (!s_reply) return;
+    char line[96];
+    snprintf(line, sizeof(line), "{\"ft\":\"error\",\"reason\":\"%s\"}", what);
+    s_reply(line);
+}
+
+static void path_for(char* out, size_t out_sz, const char* name, const char* suffix)
+{
+    snprintf(out, out_sz, "%s/%s%s", s_base, name, suffix);
+}
+
+static void meta_path(char* out, size_t out_sz)
+{
+    snprintf(out, out_sz, "%s/.ft_meta", s_base);
+}
+
+// Previous copy of the file being committed, while SPIFFS replaces it
+static void old_path(char* out, size_t out_sz)
+{
+    snprintf(out, out_sz, "%s/.ft_old", s_base);
+}
+
+static bool name_valid(const char* name)
+{
+    size_t n = name ? strlen(name) : 0;
+    if (n == 0 || n > FILE_TRANSFER_NAME_MAX || name[0] == '.') return false;
+    return strchr(name, '/') == NULL && strchr(name, '\\') == NULL;
+}
+
+static bool meta_read(char* name, unsigned long* size, unsigned long* crc)
+{
+    char mp[FT_PATH_MAX];
+    meta_path(mp, sizeof(mp));
+    FILE* f = fopen(mp, "r");
+    if (!f) return false;
+    int n = fscanf(f, "%24s %lu %lu", name, size, crc);
+    fclose(f);
+    return n == 3;
+}
+
+static bool meta_matches(const char* name, uint32_t size, uint32_t crc)
+{
+    char m_name[FILE_TRANSFER_NAME_MAX + 1];
+    unsigned long m_size = 0, m_crc = 0;
+    return meta_read(m_name, &m_size, &m_crc) && strcmp(m_name, name) == 0 && m_size == size && m_crc == crc;
+}
+
+static bool meta_write(const char* name, uint32_t size, uint32_t crc)
+{
+    char mp[FT_PATH_MAX];
+    meta_path(mp, sizeof(mp));
+    FILE* f = fopen(mp, "w");
+    if (!f) return false;
+    fprintf(f, "%s %lu %lu\n", name, (unsigned long)size, (unsigned long)crc);
+    fclose(f);
+    return true;
+}
+
+static void remove_part_and_meta(void)
+{
+    char p[FT_PATH_MAX];
+    path_for(p, sizeof(p), s_ft.name, ".part");
+    remove(p);
+    meta_path(p, sizeof(p));
+    remove(p);
+}
+
+// The meta only describes one upload; a part file it names under another
+// name could never be resumed, so it goes before the meta is replaced
+static void remove_stale_part(const char* name)
+{
+    char m_name[FILE_TRANSFER_NAME_MAX + 1];
+    unsigned long m_size, m_crc;
+    if (!meta_read(m_name, &m_size, &m_crc) || strcmp(m_name, name) == 0 || !name_valid(m_name)) return;
+    char p[FT_PATH_MAX];
+    path_for(p, sizeof(p), m_name, ".part");
+    if (remove(p) == 0) ESP_LOGI(TAG, "Dropped stale %s.part", m_name);
+}
+
+// Put the verified part file in place of dest. LittleFS renames over an
+// existing file atomically. SPIFFS rename fails on an existing target, so the
+// old copy is moved aside first and dropped once the new file is in place;
+// recover_commit() puts it back if a reset lands in between.
+static bool commit_part(const char* part, const char* dest)
+{
+#if CONFIG_SETTINGS_STORAGE_LITTLEFS
+    return rename(part, dest) == 0;
+#else
+    char old[FT_PATH_MAX];
+    old_path(old, sizeof(old));
+    remove(old);
+    struct stat st;
+    bool had_old = stat(dest, &st) == 0;
+    if (had_old && rename(dest, old) != 0) return false;
+    if (rename(part, dest) != 0) {
+        if (had_old) rename(old, dest);
+        return false;
+    }
+    remove(old);
+    return true;
+#endif
+}
+
+// A reset during commit_part() on SPIFFS can leave the old copy aside with
+// nothing in its place. The meta record is only dropped after the commit, so
+// it still names the file.
+static void recover_commit(void)
+{
+    char old[FT_PATH_MAX];
+    old_path(old, sizeof(old));
+    struct stat st;
+    if (stat(old, &st) != 0) return;
+    char name[FILE_TRANSFER_NAME_MAX + 1];
+    unsigned long size, crc;
+    char dest[FT_PATH_MAX];
+    if (meta_read(name, &size, &crc) && name_valid(name)) {
+        path_for(dest, sizeof(dest), name, "");
+        if (stat(dest, &st) != 0 && rename(old, dest) == 0) {
+            ESP_LOGW(TAG, "Restored %s after an interrupted commit", name);
+            return;
+        }
+    }
+    remove(old);
+}
+
+// CRC of a part file left by an interrupted upload (resume path only)
+static bool crc_existing(const char* path, uint32_t len, uint32_t* crc_out)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t buf[512];
+    uint32_t crc = 0, left = len;
+    while (left) {
+        size_t n = fread(buf, 1, left < sizeof(buf) ? left : sizeof(buf), f);
+        if (n == 0) break;
+        crc = file_transfer_crc32(crc, buf, n);
+        left -= n;
+    }
+    fclose(f);
+    *crc_out = crc;
+    return left == 0;
+}
+
+static void send_ack(void)
+{
+    if (s_ft.part) fflush(s_ft.part);
+    s_ft.since_ack = 0;
+    reply("{\"ft\":\"ack\",\"offset\":%lu}", s_ft.offset);
+}
+
+static void send_nak(void)
+{
+    if (s_ft.nak_sent) return;
+    s_ft.nak_sent = true;
+    if (s_ft.part) fflush(s_ft.part);
+    s_ft.since_ack = 0;
+    reply("{\"ft\":\"nak\",\"offset\":%lu}", s_ft.offset);
+}
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ---- API -----------------------------------------------------------------
+
+esp_err_t file_transfer_init(const char* base_dir, file_transfer_reply_cb_t reply_cb)
+{
+    if (base_dir) {
+        snprintf(s_base, sizeof(s_base), "%s", base_dir);
+    }
+    s_reply = reply_cb;
+    crc_table_init();
+    recover_commit();
+    return ESP_OK;
+}
+
+esp_err_t file_transfer_begin(const char* name, uint32_t size, uint32_t crc, uint16_t max_chunk)
+{
+    if (!name_valid(name) || size == 0 || max_chunk == 0) {
+        reply_error("args");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_ft.active) {
+        file_transfer_suspend();
+    }
+    memset(&s_ft, 0, sizeof(s_ft));
+    memset(&s_stats, 0, sizeof(s_stats));
+    snprintf(s_ft.name, sizeof(s_ft.name), "%s", name);
+    s_ft.size = size;
+    s_ft.crc = crc;
+    s_ft.max_chunk = max_chunk;
+
+    char part[FT_PATH_MAX];
+    path_for(part, sizeof(part), name, ".part");
+    struct stat st;
+    if (meta_matches(name, size, crc) && stat(part, &st) == 0 && (uint32_t)st.st_size <= size &&
+        crc_existing(part, (uint32_t)st.st_size, &s_ft.run_crc)) {
+        s_ft.offset = (uint32_t)st.st_size;
+        ESP_LOGI(TAG, "Resuming %s at %lu/%lu", name, (unsigned long)s_ft.offset, (unsigned long)size);
+    } else {
+        remove_stale_part(name);
+        remove_part_and_meta();
+        if (!meta_write(name, size, crc)) {
+            reply_error("meta");
+            return ESP_FAIL;
+        }
+    }
+    s_ft.part = fopen(part, "ab");
+    if (!s_ft.part) {
+        reply_error("open");
+        return ESP_FAIL;
+    }
+    s_ft.active = true;
+    if (s_reply) {
+        char line[128];
+        snprintf(line, sizeof(line), "{\"ft\":\"ready\",\"offset\":%lu,\"chunk\":%u,\"window\":%d}",
+                 (unsigned long)s_ft.offset, (unsigned)max_chunk, FILE_TRANSFER_WINDOW);
+        s_reply(line);
+    }
+    return ESP_OK;
+}
+
+esp_err_t file_transfer_on_data(const uint8_t* frame, size_t len)
+{
+    if (!s_ft.active) return ESP_ERR_INVALID_STATE;
+    if (len <= FILE_TRANSFER_HDR_LEN) return ESP_ERR_INVALID_SIZE;
+    uint32_t off = rd32(frame);
+    uint32_t crc = rd32(frame + 4);
+    const uint8_t* payload = frame + FILE_TRANSFER_HDR_LEN;
+    size_t n = len - FILE_TRANSFER_HDR_LEN;
+    s_stats.frames++;
+
+    if (n > s_ft.max_chunk || off + n > s_ft.size) {
+        reply_error("frame");
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (off < s_ft.offset) {
+        // Retransmission of data we already have (sender rewound past our ack)
+        s_stats.duplicates++;
+        return ESP_OK;
+    }
+    if (off > s_ft.offset) {
+        s_stats.gaps++;
+        send_nak();
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (file_transfer_crc32(0, payload, n) != crc) {
+        s_stats.crc_errors++;
+        send_nak();
+        return ESP_ERR_INVALID_CRC;
+    }
+    if (fwrite(payload, 1, n, s_ft.part) != n) {
+        reply_error("write");
+        return ESP_FAIL;
+    }
+    s_ft.offset += n;
+    s_ft.run_crc = file_transfer_crc32(s_ft.run_crc, payload, n);
+    s_ft.nak_sent = false;
+    s_stats.bytes += n;
+    if (++s_ft.since_ack >= FILE_TRANSFER_WINDOW || s_ft.offset == s_ft.size) {
+        send_ack();
+    }
+    return ESP_OK;
+}
+
+esp_err_t file_transfer_end(void)
+{
+    if (!s_ft.active) {
+        reply_error("idle");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_ft.offset != s_ft.size) {
+        reply("{\"ft\":\"done\",\"ok\":false,\"offset\":%lu}", s_ft.offset);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    fclose(s_ft.part);
+    s_ft.part = NULL;
+    s_ft.active = false;
+    if (s_ft.run_crc != s_ft.crc) {
+        ESP_LOGW(TAG, "CRC mismatch for %s: %08lx != %08lx", s_ft.name, (unsigned long)s_ft.run_crc, (unsigned long)s_ft.crc);
+        remove_part_and_meta();
+        reply("{\"ft\":\"done\",\"ok\":false,\"crc\":%lu}", s_ft.run_crc);
+        return ESP_ERR_INVALID_CRC;
+    }
+    char part[FT_PATH_MAX], dest[FT_PATH_MAX];
+    path_for(part, sizeof(part), s_ft.name, ".part");
+    path_for(dest, sizeof(dest), s_ft.name, "");
+    // The meta record is dropped last, so a reset before it leaves either a
+    // resumable part file or a commit recover_commit() can finish
+    if (!commit_part(part, dest)) {
+        reply_error("rename");
+        return ESP_FAIL;
+    }
+    char mp[FT_PATH_MAX];
+    meta_path(mp, sizeof(mp));
+    remove(mp);
+    ESP_LOGI(TAG, "Stored %s (%lu bytes)", dest, (unsigned long)s_ft.size);
+    reply("{\"ft\":\"done\",\"ok\":true,\"bytes\":%lu}", s_ft.size);
+    return ESP_OK;
+}
+
+void file_transfer_abort(void)
+{
+    if (s_ft.part) {
+        fclose(s_ft.part);
+        s_ft.part = NULL;
+    }
+    if (s_ft.name[0]) {
+        remove_part_and_meta();
+    }
+    s_ft.active = false;
+}
+
+void file_transfer_suspend(void)
+{
+    if (s_ft.part) {
+        fclose(s_ft.part);
+        s_ft.part = NULL;
+    }
+    if (s_ft.active) {
+        ESP_LOGI(TAG, "Suspended %s at %lu", s_ft.name, (unsigned long)s_ft.offset);
+    }
+    s_ft.active = false;
+}
+
+bool file_transfer_active(void)
+{
+    return s_ft.active;
+}
+
+void file_transfer_get_stats(file_transfer_stats_t* out)
+{
+    if (out) *out = s_stats;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Resumable file upload into the storage partition.
+//
+// Control is line based (JSON over NUS), data arrives as binary frames:
+//   [u32 offset LE][u32 crc32 LE of payload][payload]
+// The receiver acks the contiguous offset every FILE_TRANSFER_WINDOW frames
+// and naks with the expected offset on a gap or CRC error (go-back-N).
+// Data goes to "<name>.part"; on end the whole-file CRC is checked and the
+// part file is renamed over the destination. A begin for the same
+// name/size/crc after a disconnect resumes from the bytes already on flash;
+// only the latest upload is resumable, a begin for anything else drops the
+// earlier part file.
+
+#define FILE_TRANSFER_HDR_LEN   8
+#define FILE_TRANSFER_WINDOW    8
+#define FILE_TRANSFER_NAME_MAX  24
+
+// Replies are single JSON lines ({"ft":"ready"|"ack"|"nak"|"done"|"error",...})
+typedef void (*file_transfer_reply_cb_t)(const char* line);
+
+typedef struct {
+    uint32_t bytes;
+    uint32_t frames;
+    uint32_t crc_errors;
+    uint32_t gaps;
+    uint32_t duplicates;
+} file_transfer_stats_t;
+
+esp_err_t file_transfer_init(const char* base_dir, file_transfer_reply_cb_t reply);
+
+// Start (or resume) an upload; max_chunk is the payload size the link allows
+esp_err_t file_transfer_begin(const char* name, uint32_t size, uint32_t crc, uint16_t max_chunk);
+
+// Feed one binary data frame
+esp_err_t file_transfer_on_data(const uint8_t* frame, size_t len);
+
+// Verify and commit; replies "done" with ok=true/false
+esp_err_t file_transfer_end(void);
+
+// Drop the upload and its part file
+void file_transfer_abort(void);
+
+// Link lost: close the part file but keep it for a later resume
+void file_transfer_suspend(void);
+
+bool file_transfer_active(void);
+void file_transfer_get_stats(file_transfer_stats_t* out);
+
+uint32_t file_transfer_crc32(uint32_t crc, const void* data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
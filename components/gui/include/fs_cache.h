@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read cache behind the LVGL file system driver (lvgl_spiffs_fs.c), kept
+// free of LVGL and ESP-IDF so host/fs_bench can run it on emulated flash.
+//
+// - Files are found by path hash in a small inode table that remembers the
+//   size, so reopening an image LVGL just closed costs no filesystem lookup.
+// - Backend handles are kept open after close, one per inode, least recently
+//   used first out (FS_CACHE_HANDLES at most).
+// - Data is cached in FS_CACHE_BLOCK-sized blocks (LRU) in memory the caller
+//   provides (PSRAM on the watch). A miss while reading sequentially also
+//   fetches the next FS_CACHE_READAHEAD blocks.
+//
+// Read-only files only, and not thread-safe: everything runs in the LVGL
+// task. Writers elsewhere must call fs_cache_set_generation()/invalidate.
+
+#define FS_CACHE_BLOCK     4096
+#define FS_CACHE_READAHEAD 3
+#define FS_CACHE_INODES    24
+#define FS_CACHE_HANDLES   3
+#define FS_CACHE_FILES     8
+#define FS_CACHE_PATH_MAX  64
+
+typedef struct {
+    // Open `path` for reading and report its size; NULL if missing
+    void* (*open)(const char* path, uint32_t* size);
+    // Read `len` bytes at `pos`; returns bytes read or -1
+    int (*read)(void* handle, uint32_t pos, void* buf, uint32_t len);
+    void (*close)(void* handle);
+} fs_cache_ops_t;
+
+typedef struct {
+    uint32_t opens;          // fs_cache_open calls
+    uint32_t inode_hits;     // opens answered from the inode table
+    uint32_t backend_opens;  // opens that reached the filesystem
+    uint32_t hits;           // block lookups served from memory
+    uint32_t misses;
+    uint32_t readahead;      // blocks fetched ahead of a miss
+    uint64_t backend_bytes;  // bytes read from the filesystem
+} fs_cache_stats_t;
+
+typedef struct fs_cache_file fs_cache_file_t;
+
+// `mem` holds the blocks; less than one block disables caching (the inode
+// table and handle reuse still apply)
+void fs_cache_init(const fs_cache_ops_t* ops, void* mem, size_t mem_size);
+
+// NULL when the path is too long, no file slot is free or the open failed;
+// callers then fall back to the uncached path
+fs_cache_file_t* fs_cache_open(const char* path);
+int fs_cache_read(fs_cache_file_t* file, void* buf, uint32_t len);
+void fs_cache_seek(fs_cache_file_t* file, uint32_t pos);
+uint32_t fs_cache_tell(const fs_cache_file_t* file);
+uint32_t fs_cache_size(const fs_cache_file_t* file);
+void fs_cache_close(fs_cache_file_t* file);
+
+// Drop everything when `gen` differs from the last value seen; pass any
+// counter that moves whenever the filesystem is written
+void fs_cache_set_generation(uint64_t gen);
+void fs_cache_invalidate(void);
+
+void fs_cache_get_stats(fs_cache_stats_t* out);
+void fs_cache_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
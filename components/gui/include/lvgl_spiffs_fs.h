@@ -6,6 +6,10 @@ extern "C" {
 
 void lvgl_spiffs_fs_register(void);
 
+// Close the handles the block cache keeps open and drop cached data; call
+// before formatting or unmounting the storage partition
+void lvgl_spiffs_fs_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
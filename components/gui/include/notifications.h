@@ -1,14 +1,29 @@
 #pragma once
+#include "esp_err.h"
 #include "lvgl.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Opens the notification history; call once before the screen is created
+void notifications_init(void);
+
 void notifications_screen_create(lv_obj_t* parent);
+// Deletes the screen; notifications keep going to the history meanwhile
+void notifications_screen_destroy(void);
 lv_obj_t* notifications_screen_get(void);
 
-// Update the notifications UI with new data
-// Any of the parameters may be NULL; they will be treated as empty strings
+// Add a notification to the history. Writes flash, so call it from the
+// receiving task and not under the display lock. Any of the parameters may
+// be NULL; they will be treated as empty strings
+esp_err_t notifications_store(const char* app,
+                              const char* title,
+                              const char* message,
+                              const char* timestamp_iso8601);
+
+// Bring the screen up to date after notifications_store(); LVGL thread or
+// display lock held. Takes the same arguments, which are shown by
+// themselves only when they could not be stored and the history is empty
 void notifications_show(const char* app,
                         const char* title,
                         const char* message,
@@ -21,7 +21,9 @@ extern "C" {
     void ui_dynamic_subtile_close(void);
 
     void ui_init(void);
-    void ui_task(void* pvParameters);
+    // Builds the screens and starts input and power polling; returns once
+    // the main screen is loaded (the first frame follows on the LVGL task)
+    void ui_start(void);
 
     // Switch to the Messages tile (notifications screen)
     void ui_show_messages_tile(void);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "assets.h"
+
+// Map the asset partition, or register the compiled-in icons when
+// CONFIG_ASSETS_PARTITION is off. Screens then use assets_image("name").
+void ui_images_init(void);
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Render and flush times of every refresh of the display.
+//
+// Each refresh that draws something is recorded into a ring of the last
+// UI_PERF_FRAMES frames: how long layout and drawing took, how long the
+// flush callbacks and the wait for the panel took, how many pixels were
+// flushed, and which widget invalidated the most of them. The widget is
+// guessed, once the frame is drawn, from the position and size of its
+// largest invalidated areas (a few at most) and named
+// by its class and the nearest ancestor given a name with
+// ui_perf_set_name() (the main tiles are named by ui_screens).
+//
+// The LVGL thread writes the ring without a lock; readers on any task
+// get whole frames and never block it. Without CONFIG_UI_PERF nothing is
+// recorded and the getters return nothing.
+
+#define UI_PERF_FRAMES 64
+
+typedef struct {
+    uint32_t t_ms;              // refresh start, since boot
+    uint32_t render_us;         // layout and drawing
+    uint32_t flush_us;          // flush callbacks and waiting for the panel
+    uint32_t px;                // pixels flushed
+    uint16_t areas;             // invalidated areas, before joining
+    const char* owner;          // named screen or widget, NULL if none
+    const char* widget;         // class of the widget that invalidated the most
+} ui_perf_frame_t;
+
+typedef struct {
+    uint32_t frames;            // in the window
+    uint32_t span_ms;           // first frame of the window to now
+    uint32_t fps_x10;
+    uint32_t render_us_avg, render_us_max;
+    uint32_t flush_us_avg, flush_us_max;
+    uint32_t px_avg;
+    uint32_t busy_pct;          // render + flush over the span
+    const char* top_owner;      // dominant widget of the frames that took
+    const char* top_widget;     // the most render time, summed
+} ui_perf_summary_t;
+
+// Hooks the display's refresh events; LVGL thread (or display lock)
+void ui_perf_init(lv_display_t* disp);
+
+// Name a screen or widget for the dominant widget reports. `name` must
+// stay valid; forgotten when the object is deleted.
+void ui_perf_set_name(lv_obj_t* obj, const char* name);
+
+// Frames recorded since boot
+uint32_t ui_perf_frames_total(void);
+
+// Copies up to `max` of the most recent frames, oldest first; any task
+uint32_t ui_perf_get_frames(ui_perf_frame_t* out, uint32_t max);
+
+// Over the frames of the last `window_ms`; any task
+void ui_perf_get_summary(uint32_t window_ms, ui_perf_summary_t* out);
+
+// Frame rate, times and dominant widget in a corner of the system layer,
+// updated every second. LVGL thread (or display lock).
+void ui_perf_set_overlay(bool on);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Touch polling and periodic UI updates paced by what is on screen.
+//
+// LVGL only redraws what was invalidated and its animation timer stops
+// when nothing moves, but the touch read timer ran every
+// LV_DEF_REFR_PERIOD and each screen kept its own periodic timers. Touch
+// is now read at that rate only while a finger is down, a scroll is
+// settling or an animation runs, and for a second after; otherwise every
+// CONFIG_UI_REFRESH_IDLE_POLL_MS. Periodic updates subscribe to one tick
+// that fires just after each second boundary of esp_timer, where the clock
+// also advances, so they all share a single wakeup.
+//
+// LVGL thread (or display lock) unless noted.
+
+typedef struct ui_refresh_sub ui_refresh_sub_t;
+
+typedef struct {
+    bool active;                // touch read at full rate right now
+    uint32_t window_ms;         // last complete window, 0 until there is one
+    uint32_t touch_reads;       // in the window
+    uint32_t ticks;
+    uint32_t frames;            // refreshes that drew something (CONFIG_UI_PERF)
+    uint32_t idle_wakeups[2];   // per core: idle loop woken by any interrupt,
+                                // the scheduler tick included
+} ui_refresh_stats_t;
+
+// Paces the touch read timer of `touch` and starts the wakeup counters
+void ui_refresh_init(lv_indev_t* touch);
+
+// Calls cb every `period_s` seconds on the shared tick, starting with the
+// next multiple of period_s. Callers run their update once themselves
+// when they need it sooner. NULL when all slots are taken.
+ui_refresh_sub_t* ui_refresh_every(uint32_t period_s, void (*cb)(void* user), void* user);
+
+void ui_refresh_cancel(ui_refresh_sub_t* sub);
+
+// lv_label_set_text_fmt() that leaves the label alone, and undrawn, when
+// the text is what it already shows. Up to 63 characters.
+void ui_refresh_label_fmt(lv_obj_t* label, const char* fmt, ...) LV_FORMAT_ATTRIBUTE(2, 3);
+
+// Any task
+void ui_refresh_get_stats(ui_refresh_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Screens on the main tileview, built on first navigation.
+//
+// Registering a screen adds its tile, which stays empty until the screen
+// is needed: when a swipe starts toward it, when it becomes the active
+// tile, or when ui_screen_build() is called before navigating to it in
+// code. While free internal RAM is below CONFIG_UI_SCREEN_RECLAIM_FREE_KB,
+// screens that have not been shown for CONFIG_UI_SCREEN_IDLE_S are
+// destroyed and built again on the next visit. The active tile and
+// resident screens are never destroyed. LVGL thread (or display lock).
+
+typedef struct {
+    const char* name;
+    // Build the content into the empty tile
+    void (*create)(lv_obj_t* tile);
+    // Stop timers and forget pointers into the tile; the registry then
+    // deletes whatever is left in it
+    void (*destroy)(void);
+    bool resident;
+} ui_screen_def_t;
+
+typedef struct ui_screen ui_screen_t;
+
+typedef struct {
+    const char* name;
+    bool built;
+    uint16_t builds;
+    uint16_t destroys;
+    uint32_t build_us;          // last build
+    int32_t heap_bytes;         // heap the last build took (internal + PSRAM)
+} ui_screen_stats_t;
+
+// `def` must stay valid. NULL when the registry is full.
+ui_screen_t* ui_screens_add(lv_obj_t* tileview, const ui_screen_def_t* def, uint8_t col, uint8_t row,
+                            lv_dir_t dir);
+
+lv_obj_t* ui_screen_tile(const ui_screen_t* screen);
+
+// Build now if it isn't; call before lv_tileview_set_tile() to it
+void ui_screen_build(ui_screen_t* screen);
+
+bool ui_screen_is_built(const ui_screen_t* screen);
+
+// Destroy every screen that may be reclaimed and has been hidden for at
+// least idle_ms, whatever the free memory. Returns how many were.
+uint32_t ui_screens_reclaim(uint32_t idle_ms);
+
+// Copies up to `max` entries in registration order; returns the count
+uint32_t ui_screens_get_stats(ui_screen_stats_t* out, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+#include <stdint.h>
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What the screens show, one LVGL subject per value.
+//
+// Screens bind widgets to the subjects (lv_label_bind_text(),
+// lv_subject_add_observer_obj(), ...) instead of polling the sources, and
+// the sources publish changes: the step counter and the settings through
+// their events, charger and USB through BSP_POWER_EVENT, the link through
+// BLE_SYNC_EVENT, and the clock on the shared second tick. The PMU is only
+// read at start and, for the battery gauge, once a minute from an
+// esp_timer, which keeps running while the display is off so
+// ui_state_get() stays current for BLE. Published values are applied on
+// the tick, so a bound widget is updated at most once a second and only
+// when its value changed.
+
+typedef enum {
+    UI_STATE_HOUR = 0,
+    UI_STATE_MINUTE,
+    UI_STATE_SECOND,
+    UI_STATE_DAY,               // 1-31
+    UI_STATE_MONTH,             // 1-12
+    UI_STATE_WEEKDAY,           // 0 = Sunday
+    UI_STATE_STEPS,
+    UI_STATE_ACTIVITY,          // sensors_activity_t
+    UI_STATE_BATTERY,           // percent, -1 until read
+    UI_STATE_CHARGING,          // 0/1
+    UI_STATE_VBUS,              // 0/1, USB power present
+    UI_STATE_BLE_CONNECTED,     // 0/1
+    UI_STATE_BLE_ENABLED,       // 0/1, the setting
+    UI_STATE_SOUND,             // 0/1
+    UI_STATE_STEP_GOAL,
+    UI_STATE_BRIGHTNESS,
+    UI_STATE_DISPLAY_TIMEOUT,   // ms
+    UI_STATE_NOTIFY_VOLUME,     // percent
+    UI_STATE_COUNT
+} ui_state_id_t;
+
+typedef struct {
+    uint32_t window_ms;         // last complete window, 0 until there is one
+    uint32_t updates;           // subject changes, each redrawing its widgets
+    uint32_t rtc_reads;         // RTC chip reads over I2C
+    uint32_t pmu_reads;         // PMU reads over I2C for the store
+} ui_state_stats_t;
+
+// Creates the subjects from the current values and subscribes to the
+// sources. LVGL thread (or display lock), before any screen binds.
+void ui_state_init(void);
+
+// LVGL thread
+lv_subject_t* ui_state_subject(ui_state_id_t id);
+
+// Latest published value, which the subject may not show yet; any task
+int32_t ui_state_get(ui_state_id_t id);
+
+// Key for reports ("steps", "battery", ...)
+const char* ui_state_name(ui_state_id_t id);
+
+// Over the last minute of display-on time; any task
+void ui_state_get_stats(ui_state_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Styles shared by every screen. Each one is initialised once, on first
+// use, and never changed afterwards, so screens that are built and
+// destroyed repeatedly don't init (and leak) a static style each time.
+// LVGL thread only.
+
+typedef enum {
+    UI_STYLE_SCREEN,    // root of a screen: white text on opaque black
+    UI_STYLE_KNOB,      // large yellow slider knob
+    UI_STYLE_COUNT
+} ui_style_id_t;
+
+lv_style_t* ui_style_get(ui_style_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transitions drawn from snapshots instead of live screens.
+//
+// When a transition starts, the content it moves is rendered once into
+// snapshot frames and a stage screen holding those bitmaps is shown in
+// its place, so each animation frame is a few image blits however heavy
+// the screens are. The live screen is loaded back when it ends.
+//
+// On a tileview the tileview keeps doing the scrolling (drag, momentum,
+// snapping, lv_tileview_set_tile() animations); the stage only mirrors
+// its scroll position. Every call is LVGL thread (or display lock).
+
+typedef struct {
+    uint32_t transitions;       // run on snapshots
+    uint32_t live;              // left live: more tiles than frames, or a capture failed
+    uint32_t snapshots;
+    uint32_t capture_ms_max;    // snapshots of one transition
+} ui_transition_stats_t;
+
+// Bytes of one frame: a full-screen RGB565 snapshot of `disp`
+size_t ui_transition_frame_size(lv_display_t* disp);
+
+// `mem` holds `count` frames and stays owned by the caller (PSRAM on the
+// watch). Without frames every transition runs live.
+void ui_transition_init(void* mem, uint32_t count);
+
+// Run this tileview's scrolls on snapshots of the tiles they can reach.
+// The tileview must fill the display.
+void ui_transition_attach_tileview(lv_obj_t* tileview);
+
+// lv_screen_load_anim() on two snapshots. Handles the MOVE and OVER
+// animations; returns false without doing anything for the others or
+// without frames, and the caller loads the screen live.
+bool ui_transition_load_screen(lv_obj_t* screen, lv_screen_load_anim_t anim, uint32_t time_ms);
+
+void ui_transition_get_stats(ui_transition_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#include "lvgl.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Virtualized vertical list. Only `pool` card objects exist; they are moved
+// and rebound as the list scrolls, so the item count only costs a height
+// per item. Item heights come from the `measure` callback, which runs in a
+// low-priority task off the LVGL thread (and may read storage and wrap
+// text); until an item is measured it takes `est_height`. Index 0 is the
+// top of the list.
+
+typedef struct ui_vlist ui_vlist_t;
+
+typedef struct {
+    // Build one pooled card; LVGL thread
+    lv_obj_t* (*create_card)(lv_obj_t* parent, void* ctx);
+    // Show item `index` on `card`; LVGL thread. The list sets the height.
+    void (*bind)(lv_obj_t* card, uint32_t index, void* ctx);
+    // Height of item `index` for a card `width` wide; measuring task, so no
+    // LVGL object calls (taking the display lock for text measuring is
+    // fine, the list holds no lock of its own meanwhile). Return <= 0 to
+    // use est_height.
+    int32_t (*measure)(uint32_t index, int32_t width, void* ctx);
+    void* ctx;
+    int32_t est_height;
+    int32_t gap;            // between cards
+    uint8_t pool;           // cards; enough to cover the viewport plus two
+} ui_vlist_cfg_t;
+
+ui_vlist_t* ui_vlist_create(lv_obj_t* parent, const ui_vlist_cfg_t* cfg);
+
+// The scrolling container, for sizing and styling
+lv_obj_t* ui_vlist_get_obj(ui_vlist_t* list);
+
+// Replace the contents: `count` items, none measured yet
+void ui_vlist_set_count(ui_vlist_t* list, uint32_t count);
+uint32_t ui_vlist_get_count(const ui_vlist_t* list);
+
+// Items shift, heights measured so far move with them
+void ui_vlist_insert(ui_vlist_t* list, uint32_t index);
+void ui_vlist_remove(ui_vlist_t* list, uint32_t index);
+
+// Re-measure (now, on the LVGL thread) and rebind one item
+void ui_vlist_refresh(ui_vlist_t* list, uint32_t index);
+
+// Item shown on a pooled card, or -1
+int32_t ui_vlist_card_index(const ui_vlist_t* list, const lv_obj_t* card);
+
+void ui_vlist_scroll_to(ui_vlist_t* list, uint32_t index, lv_anim_enable_t anim);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,12 +7,6 @@ extern "C" {
 void watchface_create(lv_obj_t* parent);
 lv_obj_t* watchface_screen_get(void);
 
-// Atualiza indicadores de energia (VBUS/Carregamento/Bateria)
-void watchface_set_power_state(bool vbus_in, bool charging, int battery_percent);
-
-// Atualiza indicador de estado BLE
-void watchface_set_ble_connected(bool connected);
-
 #ifdef __cplusplus
 }
 #endif
@@ -1,7 +1,11 @@
 #include "batt_screen.h"
 #include "settings.h"
 #include "ui_fonts.h"
+#include "ui_images.h"
 #include "ui.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
+#include "ui_styles.h"
 #include "settings_screen.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "esp_log.h"
@@ -9,8 +13,6 @@
 // Access UI primitives via ui.h accessors
 static const char* TAG = "BatteryScreen";
 
-LV_IMAGE_DECLARE(image_battery_48);
-
 static lv_obj_t* batt_screen;
 static lv_obj_t* batt_percent_label;
 static lv_obj_t* batt_bar;
@@ -20,30 +22,21 @@ static lv_obj_t* row_vbat_val;
 static lv_obj_t* row_vbus_val;
 static lv_obj_t* row_vsys_val;
 static lv_obj_t* row_temp_val;
-static lv_timer_t* batt_timer;
+static ui_refresh_sub_t* batt_tick;
 
 static void batt_screen_events(lv_event_t* e);
-static void batt_update_cb(lv_timer_t* t);
+static void batt_update_cb(void* user);
 static void batt_update_values(void);
+static void batt_power_observer_cb(lv_observer_t* observer, lv_subject_t* subject);
 static lv_obj_t* make_chip(lv_obj_t* parent, const char* txt);
 static lv_obj_t* make_row(lv_obj_t* parent, const char* label_txt, lv_obj_t** out_val);
 static void on_delete(lv_event_t* e);
 
 void lv_smartwatch_batt_create(lv_obj_t* screen)
 {
-
-    static lv_style_t cmain_style;
-
-
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
-
-
     batt_screen = lv_obj_create(screen);
     lv_obj_remove_style_all(batt_screen);
-    lv_obj_add_style(batt_screen, &cmain_style, 0);
+    lv_obj_add_style(batt_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(batt_screen, lv_pct(100), lv_pct(100));
     // Let gestures bubble to tileview so horizontal swipes work
     //lv_obj_add_flag(batt_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
@@ -66,7 +59,7 @@ void lv_smartwatch_batt_create(lv_obj_t* screen)
 
     lv_obj_t* img = lv_image_create(hdr_card);
     //lv_obj_set_align(img, LV_ALIGN_TOP_MID);
-    lv_image_set_src(img, &image_battery_48);
+    lv_image_set_src(img, assets_image("image_battery_48"));
 
     lv_obj_t* batt_title_label = lv_label_create(hdr_card);
     lv_obj_set_style_text_font(batt_title_label, &font_bold_32, 0);
@@ -101,9 +94,12 @@ void lv_smartwatch_batt_create(lv_obj_t* screen)
     (void)make_row(status, "VSYS", &row_vsys_val);
     (void)make_row(status, "Temp", &row_temp_val);
 
-    // Periodic refresh
-    batt_timer = lv_timer_create(batt_update_cb, 5000, NULL);
-    //lv_timer_ready(batt_timer);
+    // Level, charger and source from the state store; the rails and the
+    // temperature are only read while this screen is open
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_BATTERY), batt_power_observer_cb, batt_percent_label, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_CHARGING), batt_power_observer_cb, batt_percent_label, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_VBUS), batt_power_observer_cb, batt_percent_label, NULL);
+    batt_tick = ui_refresh_every(5, batt_update_cb, NULL);
     batt_update_values();
 
     lv_obj_add_event_cb(batt_screen, batt_screen_events, LV_EVENT_ALL, NULL);
@@ -115,7 +111,7 @@ static void on_delete(lv_event_t* e)
 {
     (void)e;
     ESP_LOGI(TAG, "Battery screen deleted");
-    if (batt_timer) { lv_timer_del(batt_timer); batt_timer = NULL; }
+    ui_refresh_cancel(batt_tick); batt_tick = NULL;
     batt_screen = NULL;
 }
 
@@ -146,16 +142,16 @@ static void batt_screen_events(lv_event_t* e)
             lv_indev_wait_release(lv_indev_active());
             // Return to controls tile and remove dynamic tile
             ui_dynamic_tile_close();
-            if (batt_timer) { lv_timer_del(batt_timer); batt_timer = NULL; }
+            ui_refresh_cancel(batt_tick); batt_tick = NULL;
             batt_screen = NULL;
             //lv_obj_del_async(batt_screen);
         } 
     }
 }
 
-static void batt_update_cb(lv_timer_t* t)
+static void batt_update_cb(void* user)
 {
-    (void)t;
+    (void)user;
     if (active_screen_get() == batt_screen) {
         bsp_display_lock(0);
         batt_update_values();
@@ -163,34 +159,36 @@ static void batt_update_cb(lv_timer_t* t)
     }
 }
 
-static void batt_update_values(void)
+static void batt_power_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
 {
-    int pct = bsp_power_get_battery_percent();
+    LV_UNUSED(observer);
+    LV_UNUSED(subject);
+    int pct = lv_subject_get_int(ui_state_subject(UI_STATE_BATTERY));
+    bool chg = lv_subject_get_int(ui_state_subject(UI_STATE_CHARGING));
+    bool vbus_in = lv_subject_get_int(ui_state_subject(UI_STATE_VBUS));
     if (pct < 0) pct = 0;
     if (pct > 100) pct = 100;
     lv_bar_set_value(batt_bar, pct, LV_ANIM_ON);
-    char txt[32];
-    snprintf(txt, sizeof(txt), "%d%%", pct);
-    lv_label_set_text(batt_percent_label, txt);
-
-    int vbat = bsp_power_get_batt_voltage_mv();
-    int vbus = bsp_power_get_vbus_voltage_mv();
-    int vsys = bsp_power_get_system_voltage_mv();
-    float temp = bsp_power_get_temperature_c();
-    bool chg = bsp_power_is_charging();
-    bool vbus_in = bsp_power_is_vbus_in();
+    ui_refresh_label_fmt(batt_percent_label, "%d%%", pct);
 
     // Chips: Source + Charging
-    char buf[48];
     //snprintf(buf, sizeof(buf), "Source: %s", vbus_in ? "USB" : "Battery");
-    lv_label_set_text(chip_source, vbus_in ? "USB" : "Battery");
+    ui_refresh_label_fmt(chip_source, "%s", vbus_in ? "USB" : "Battery");
     //snprintf(buf, sizeof(buf), "Charging: %s", chg ? "Yes" : "No");
-    lv_label_set_text(chip_charge, chg ? "Yes" : "No");
+    ui_refresh_label_fmt(chip_charge, "%s", chg ? "Yes" : "No");
     lv_obj_set_style_text_color(chip_charge, chg ? lv_color_hex(0x2ECC71) : lv_color_hex(0xFFFFFF), 0);
     //lv_obj_set_style_bg_opa(chip_charge, chg ? LV_OPA_30 : LV_OPA_20, 0);
 
     lv_obj_set_style_text_color(batt_percent_label, chg ? lv_color_hex(0x2ECC71) : lv_color_hex(0xFFFFFF), 0);
-    //lv_obj_set_style_bg_opa(chip_charge, chg ? LV_OPA_30 : LV_OPA_20, 0);
+}
+
+static void batt_update_values(void)
+{
+    int vbat = bsp_power_get_batt_voltage_mv();
+    int vbus = bsp_power_get_vbus_voltage_mv();
+    int vsys = bsp_power_get_system_voltage_mv();
+    float temp = bsp_power_get_temperature_c();
+    char buf[48];
 
     // Values: format as volts with 2 decimals when valid
     if (vbat > 0) {
@@ -1,6 +1,8 @@
 #include "brightness_screen.h"
 #include "ui_fonts.h"
+#include "ui_images.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "settings.h"
 #include "esp_log.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
@@ -8,8 +10,6 @@
 
 static const char* TAG = "BrightnessScreen";
 
-LV_IMAGE_DECLARE(image_brightness_48);
-
 static lv_obj_t* brightness_screen;
 static lv_obj_t* percent_label;
 static lv_obj_t* slider;
@@ -21,24 +21,9 @@ static void update_label_from_value(int val);
 
 void lv_smartwatch_brightness_create(lv_obj_t* screen)
 {
-    static lv_style_t cmain_style;
-    static lv_style_t style_knob;
-
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
-
-    lv_style_init(&style_knob);
-    lv_style_set_bg_opa(&style_knob, LV_OPA_COVER);
-    lv_style_set_bg_color(&style_knob, lv_color_hex(0xFFFF10));    
-    lv_style_set_border_width(&style_knob, 0);
-    lv_style_set_radius(&style_knob, LV_RADIUS_CIRCLE);
-    lv_style_set_pad_all(&style_knob, 8); /*Makes the knob larger*/
-    
     brightness_screen = lv_obj_create(screen);
     lv_obj_remove_style_all(brightness_screen);
-    lv_obj_add_style(brightness_screen, &cmain_style, 0);
+    lv_obj_add_style(brightness_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(brightness_screen, lv_pct(100), lv_pct(100));
     // Allow gestures on children to bubble up so tileview can handle swipes
     lv_obj_add_flag(brightness_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
@@ -54,7 +39,7 @@ void lv_smartwatch_brightness_create(lv_obj_t* screen)
     lv_obj_set_align(hdr_card, LV_ALIGN_TOP_MID);
 
     lv_obj_t* img = lv_image_create(hdr_card);
-    lv_image_set_src(img, &image_brightness_48);
+    lv_image_set_src(img, assets_image("image_brightness_48"));
 
     // Big title label
     lv_obj_t* brightness_title_label = lv_label_create(hdr_card);
@@ -83,7 +68,7 @@ void lv_smartwatch_brightness_create(lv_obj_t* screen)
     lv_obj_set_width(slider, lv_pct(90));
     lv_obj_set_height(slider, 30);
     lv_slider_set_range(slider, 5, 100);
-    lv_obj_add_style(slider, &style_knob, LV_PART_KNOB);
+    lv_obj_add_style(slider, ui_style_get(UI_STYLE_KNOB), LV_PART_KNOB);
     lv_obj_add_event_cb(slider, slider_event, LV_EVENT_VALUE_CHANGED, NULL);
     lv_obj_set_align(slider, LV_ALIGN_CENTER);
 
@@ -0,0 +1,326 @@
+#include "fs_cache.h"
+
+#include <string.h>
+
+typedef struct {
+    uint32_t hash;
+    uint32_t id;        // 0 = free slot; blocks are tagged with this
+    uint32_t size;
+    uint32_t stamp;     // LRU clock at last open
+    uint16_t refs;      // open fs_cache_file_t
+    bool stale;         // invalidated while open, freed on last close
+    void* handle;       // backend handle, kept open after close
+    char path[FS_CACHE_PATH_MAX];
+} inode_t;
+
+typedef struct {
+    uint32_t id;        // inode id, 0 = free
+    uint32_t blk;
+    uint32_t len;
+    uint32_t stamp;
+} block_t;
+
+struct fs_cache_file {
+    inode_t* ino;
+    uint32_t pos;
+    uint32_t next_blk;  // a miss here means the reader is sequential
+    bool used;
+};
+
+static const fs_cache_ops_t* s_ops;
+static uint8_t* s_mem;
+static block_t* s_blocks;
+static size_t s_block_count;
+static inode_t s_inodes[FS_CACHE_INODES];
+static fs_cache_file_t s_files[FS_CACHE_FILES];
+static unsigned s_handles;
+static uint32_t s_clock;
+static uint32_t s_next_id;
+static uint64_t s_gen;
+static bool s_gen_valid;
+static fs_cache_stats_t s_stats;
+
+static uint32_t path_hash(const char* s)
+{
+    uint32_t h = 0x811c9dc5u;
+    while (*s) h = (h ^ (uint8_t)*s++) * 0x01000193u;
+    return h;
+}
+
+static uint8_t* block_data(const block_t* b)
+{
+    return s_mem + (size_t)(b - s_blocks) * FS_CACHE_BLOCK;
+}
+
+static void blocks_drop(uint32_t id)
+{
+    for (size_t i = 0; i < s_block_count; ++i) {
+        if (s_blocks[i].id == id) s_blocks[i].id = 0;
+    }
+}
+
+static block_t* block_find(uint32_t id, uint32_t blk)
+{
+    for (size_t i = 0; i < s_block_count; ++i) {
+        if (s_blocks[i].id == id && s_blocks[i].blk == blk) return &s_blocks[i];
+    }
+    return NULL;
+}
+
+static block_t* block_victim(const block_t* keep)
+{
+    block_t* v = NULL;
+    for (size_t i = 0; i < s_block_count; ++i) {
+        block_t* b = &s_blocks[i];
+        if (b == keep) continue;
+        if (b->id == 0) return b;
+        if (!v || (int32_t)(b->stamp - v->stamp) < 0) v = b;
+    }
+    return v;
+}
+
+static void handle_close(inode_t* ino)
+{
+    if (!ino->handle) return;
+    s_ops->close(ino->handle);
+    ino->handle = NULL;
+    s_handles--;
+}
+
+static void inode_free(inode_t* ino)
+{
+    handle_close(ino);
+    blocks_drop(ino->id);
+    ino->id = 0;
+}
+
+// Make sure `ino` has a backend handle, closing the least recently used one
+// when FS_CACHE_HANDLES are open. A size change means the file was replaced.
+static bool handle_acquire(inode_t* ino, bool first)
+{
+    if (ino->handle) return true;
+    if (s_handles >= FS_CACHE_HANDLES) {
+        inode_t* lru = NULL;
+        for (size_t i = 0; i < FS_CACHE_INODES; ++i) {
+            inode_t* c = &s_inodes[i];
+            if (c == ino || !c->id || !c->handle) continue;
+            if (!lru || (int32_t)(c->stamp - lru->stamp) < 0) lru = c;
+        }
+        if (lru) handle_close(lru);
+    }
+
+    uint32_t size = 0;
+    void* h = s_ops->open(ino->path, &size);
+    if (!h) return false;
+    s_stats.backend_opens++;
+    s_handles++;
+    ino->handle = h;
+    if (!first && size != ino->size) {
+        blocks_drop(ino->id);
+        ino->id = ++s_next_id;
+    }
+    ino->size = size;
+    return true;
+}
+
+static inode_t* inode_find(const char* path, uint32_t hash)
+{
+    for (size_t i = 0; i < FS_CACHE_INODES; ++i) {
+        inode_t* ino = &s_inodes[i];
+        if (ino->id && !ino->stale && ino->hash == hash && strcmp(ino->path, path) == 0) return ino;
+    }
+    return NULL;
+}
+
+static inode_t* inode_alloc(void)
+{
+    inode_t* v = NULL;
+    for (size_t i = 0; i < FS_CACHE_INODES; ++i) {
+        inode_t* ino = &s_inodes[i];
+        if (!ino->id) return ino;
+        if (ino->refs) continue;
+        if (!v || (int32_t)(ino->stamp - v->stamp) < 0) v = ino;
+    }
+    if (v) inode_free(v);
+    return v;
+}
+
+void fs_cache_init(const fs_cache_ops_t* ops, void* mem, size_t mem_size)
+{
+    fs_cache_invalidate();
+    s_ops = ops;
+    s_mem = NULL;
+    s_blocks = NULL;
+    s_block_count = 0;
+    // Block headers live at the end of `mem`, after the block data
+    size_t n = mem ? mem_size / (FS_CACHE_BLOCK + sizeof(block_t)) : 0;
+    if (n) {
+        s_mem = mem;
+        s_blocks = (block_t*)(s_mem + n * FS_CACHE_BLOCK);
+        s_block_count = n;
+        memset(s_blocks, 0, n * sizeof(block_t));
+    }
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+fs_cache_file_t* fs_cache_open(const char* path)
+{
+    if (!s_ops || !path || strlen(path) >= FS_CACHE_PATH_MAX) return NULL;
+
+    fs_cache_file_t* f = NULL;
+    for (size_t i = 0; i < FS_CACHE_FILES && !f; ++i) {
+        if (!s_files[i].used) f = &s_files[i];
+    }
+    if (!f) return NULL;
+
+    s_stats.opens++;
+    const uint32_t hash = path_hash(path);
+    inode_t* ino = inode_find(path, hash);
+    if (ino) {
+        s_stats.inode_hits++;
+    } else {
+        ino = inode_alloc();
+        if (!ino) return NULL;
+        memset(ino, 0, sizeof(*ino));
+        strcpy(ino->path, path);
+        ino->hash = hash;
+        ino->id = ++s_next_id;
+        if (!handle_acquire(ino, true)) {
+            ino->id = 0;
+            return NULL;
+        }
+    }
+
+    ino->refs++;
+    ino->stamp = ++s_clock;
+    *f = (fs_cache_file_t){ .ino = ino, .used = true };
+    return f;
+}
+
+// Load `blk` and, for sequential readers, the blocks after it
+static block_t* block_fill(fs_cache_file_t* f, uint32_t blk)
+{
+    inode_t* ino = f->ino;
+    if (!handle_acquire(ino, false)) return NULL;
+    if (blk * (uint64_t)FS_CACHE_BLOCK >= ino->size) return NULL;
+
+    const uint32_t last = (ino->size - 1) / FS_CACHE_BLOCK;
+    uint32_t ahead = (uint32_t)(s_block_count / 4);
+    if (ahead > FS_CACHE_READAHEAD) ahead = FS_CACHE_READAHEAD;
+    const uint32_t count = 1 + (blk == f->next_blk ? ahead : 0);
+    block_t* first = NULL;
+    for (uint32_t i = 0; i < count && blk + i <= last; ++i) {
+        if (i && block_find(ino->id, blk + i)) continue;
+        block_t* b = block_victim(first);
+        if (!b) break;
+        uint32_t off = (blk + i) * FS_CACHE_BLOCK;
+        uint32_t want = ino->size - off < FS_CACHE_BLOCK ? ino->size - off : FS_CACHE_BLOCK;
+        b->id = 0;
+        int n = s_ops->read(ino->handle, off, block_data(b), want);
+        if (n <= 0) break;
+        *b = (block_t){ .id = ino->id, .blk = blk + i, .len = (uint32_t)n, .stamp = ++s_clock };
+        s_stats.backend_bytes += (uint32_t)n;
+        if (i) {
+            s_stats.readahead++;
+        } else {
+            s_stats.misses++;
+            first = b;
+        }
+    }
+    if (first) first->stamp = ++s_clock;
+    return first;
+}
+
+int fs_cache_read(fs_cache_file_t* f, void* buf, uint32_t len)
+{
+    if (!f || !f->used) return -1;
+    inode_t* ino = f->ino;
+    uint8_t* out = buf;
+    uint32_t done = 0;
+
+    if (!s_block_count) {
+        if (f->pos >= ino->size || !len) return 0;
+        if (len > ino->size - f->pos) len = ino->size - f->pos;
+        if (!handle_acquire(ino, false)) return -1;
+        int n = s_ops->read(ino->handle, f->pos, out, len);
+        if (n < 0) return -1;
+        s_stats.backend_bytes += (uint32_t)n;
+        f->pos += (uint32_t)n;
+        return n;
+    }
+
+    while (done < len && f->pos < ino->size) {
+        const uint32_t blk = f->pos / FS_CACHE_BLOCK;
+        const uint32_t off = f->pos % FS_CACHE_BLOCK;
+        block_t* b = block_find(ino->id, blk);
+        if (b) {
+            s_stats.hits++;
+            b->stamp = ++s_clock;
+        } else if (!(b = block_fill(f, blk))) {
+            return done ? (int)done : -1;
+        }
+        f->next_blk = blk + 1;
+        if (off >= b->len) break;
+        uint32_t n = b->len - off;
+        if (n > len - done) n = len - done;
+        memcpy(out + done, block_data(b) + off, n);
+        done += n;
+        f->pos += n;
+    }
+    return (int)done;
+}
+
+void fs_cache_seek(fs_cache_file_t* f, uint32_t pos)
+{
+    if (f && f->used) f->pos = pos;
+}
+
+uint32_t fs_cache_tell(const fs_cache_file_t* f)
+{
+    return f && f->used ? f->pos : 0;
+}
+
+uint32_t fs_cache_size(const fs_cache_file_t* f)
+{
+    return f && f->used ? f->ino->size : 0;
+}
+
+void fs_cache_close(fs_cache_file_t* f)
+{
+    if (!f || !f->used) return;
+    inode_t* ino = f->ino;
+    f->used = false;
+    if (ino->refs) ino->refs--;
+    if (ino->stale && !ino->refs) inode_free(ino);
+}
+
+void fs_cache_set_generation(uint64_t gen)
+{
+    if (s_gen_valid && gen != s_gen) fs_cache_invalidate();
+    s_gen = gen;
+    s_gen_valid = true;
+}
+
+void fs_cache_invalidate(void)
+{
+    for (size_t i = 0; i < FS_CACHE_INODES; ++i) {
+        inode_t* ino = &s_inodes[i];
+        if (!ino->id) continue;
+        if (ino->refs) {
+            ino->stale = true;
+        } else {
+            inode_free(ino);
+        }
+    }
+    for (size_t i = 0; i < s_block_count; ++i) s_blocks[i].id = 0;
+}
+
+void fs_cache_get_stats(fs_cache_stats_t* out)
+{
+    if (out) *out = s_stats;
+}
+
+void fs_cache_reset_stats(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
@@ -1,12 +1,22 @@
 #include "lvgl_spiffs_fs.h"
+#include "fs_cache.h"
+#include "settings.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
 #include <stdio.h>
 #include <string.h>
 #include <dirent.h>
+#include <sys/stat.h>
 
 #ifndef LV_FS_LETTER_SPIFFS
 #define LV_FS_LETTER_SPIFFS 'S'
 #endif
 
+// Block cache for read-only files (fs_cache.c), allocated in PSRAM
+#ifndef LVGL_FS_CACHE_BYTES
+#define LVGL_FS_CACHE_BYTES (256 * 1024)
+#endif
+
 static void build_path(char * out, size_t out_sz, const char * path)
 {
     // Path from LVGL does not include drive letter, may start with '/'
@@ -26,6 +36,7 @@ static lv_fs_res_t spiffs_open(lv_fs_drv_t * drv, void * file_p, const char * pa
     char full[256]; build_path(full, sizeof full, path);
     FILE * f = fopen(full, flags);
     if (!f) return LV_FS_RES_FS_ERR;
+    if (mode != LV_FS_MODE_RD) settings_storage_changed();
     *(FILE**)file_p = f;
     return LV_FS_RES_OK;
 }
@@ -54,6 +65,7 @@ static lv_fs_res_t spiffs_write(lv_fs_drv_t * drv, void * file_p, const void * b
     LV_UNUSED(drv);
     FILE * f = *(FILE**)file_p;
     size_t n = fwrite(buf, 1, btw, f);
+    settings_wear_note(SETTINGS_PART_STORAGE, (uint32_t)n, 0);
     if (bw) *bw = (uint32_t)n;
     if (n < btw) return LV_FS_RES_FS_ERR;
     return LV_FS_RES_OK;
@@ -81,7 +93,9 @@ static lv_fs_res_t spiffs_remove(lv_fs_drv_t * drv, const char * path)
 {
     LV_UNUSED(drv);
     char full[256]; build_path(full, sizeof full, path);
-    return remove(full) == 0 ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+    if (remove(full) != 0) return LV_FS_RES_FS_ERR;
+    settings_storage_changed();
+    return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t spiffs_rename(lv_fs_drv_t * drv, const char * oldname, const char * newname)
@@ -89,7 +103,9 @@ static lv_fs_res_t spiffs_rename(lv_fs_drv_t * drv, const char * oldname, const
     LV_UNUSED(drv);
     char full_old[256]; build_path(full_old, sizeof full_old, oldname);
     char full_new[256]; build_path(full_new, sizeof full_new, newname);
-    return rename(full_old, full_new) == 0 ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+    if (rename(full_old, full_new) != 0) return LV_FS_RES_FS_ERR;
+    settings_storage_changed();
+    return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t spiffs_dir_open(lv_fs_drv_t * drv, void * rddir_p, const char * path)
@@ -111,8 +127,8 @@ static lv_fs_res_t spiffs_dir_read(lv_fs_drv_t * drv, void * rddir_p, char * fn)
         de = readdir(d);
         if (!de) { fn[0] = '\0'; return LV_FS_RES_OK; }
     } while (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0);
-    strncpy(fn, de->d_name, LV_FS_MAX_FN_LENGTH);
-    fn[LV_FS_MAX_FN_LENGTH] = '\0';
+    // LVGL marks directories with a leading '/'; only LittleFS has them
+    snprintf(fn, LV_FS_MAX_FN_LENGTH + 1, "%s%s", de->d_type == DT_DIR ? "/" : "", de->d_name);
     return LV_FS_RES_OK;
 }
 
@@ -127,41 +143,109 @@ static lv_fs_res_t spiffs_dir_close(lv_fs_drv_t * drv, void * rddir_p)
 
 #else
 
+static const char * TAG = "LVGL FS";
+
+// fs_cache backend: unbuffered stdio, the block cache does the buffering
+static void * posix_open(const char * path, uint32_t * size)
+{
+    FILE * f = fopen(path, "rb");
+    if (!f) return NULL;
+    setvbuf(f, NULL, _IONBF, 0);
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    *size = (uint32_t)st.st_size;
+    return f;
+}
+
+static int posix_read(void * handle, uint32_t pos, void * buf, uint32_t len)
+{
+    FILE * f = (FILE *)handle;
+    if (fseek(f, (long)pos, SEEK_SET) != 0) return -1;
+    size_t n = fread(buf, 1, len, f);
+    if (n < len && ferror(f)) return -1;
+    return (int)n;
+}
+
+static void posix_close(void * handle)
+{
+    fclose((FILE *)handle);
+}
+
+static const fs_cache_ops_t k_posix_ops = { posix_open, posix_read, posix_close };
+
+typedef struct {
+    fs_cache_file_t * cached;   // read-only files go through the block cache
+    FILE * f;                   // writes, or the cache had no free slot
+    bool wr;                    // opened for writing: contents change on close
+} spiffs_file_t;
+
 // LVGL v9.3 driver implementation (file-scope functions)
 static void * spiffs_open_v9(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode)
 {
     LV_UNUSED(drv);
     const char * flags = (mode == LV_FS_MODE_WR) ? "wb" : (mode == LV_FS_MODE_RD) ? "rb" : "rb+";
     char full[256]; build_path(full, sizeof full, path);
-    FILE * f = fopen(full, flags);
-    return (void *)f; // LVGL stores this pointer as file descriptor
+    spiffs_file_t * sf = lv_malloc(sizeof(*sf));
+    if (!sf) return NULL;
+    sf->cached = NULL;
+    sf->f = NULL;
+    sf->wr = mode != LV_FS_MODE_RD;
+    if (!sf->wr) {
+        fs_cache_set_generation(settings_storage_generation());
+        sf->cached = fs_cache_open(full);
+    } else {
+        fs_cache_invalidate();
+    }
+    if (!sf->cached) {
+        sf->f = fopen(full, flags);
+        if (!sf->f) {
+            lv_free(sf);
+            return NULL;
+        }
+    }
+    if (sf->wr) settings_storage_changed();
+    return sf; // LVGL stores this pointer as file descriptor
 }
 
 static lv_fs_res_t spiffs_close_v9(lv_fs_drv_t * drv, void * file_p)
 {
     LV_UNUSED(drv);
-    FILE * f = (FILE *)file_p;
-    if (f) fclose(f);
+    spiffs_file_t * sf = (spiffs_file_t *)file_p;
+    if (!sf) return LV_FS_RES_OK;
+    if (sf->cached) fs_cache_close(sf->cached);
+    if (sf->f) fclose(sf->f);
+    if (sf->wr) settings_storage_changed();
+    lv_free(sf);
     return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t spiffs_read_v9(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
 {
     LV_UNUSED(drv);
-    FILE * f = (FILE *)file_p;
-    if (!f) return LV_FS_RES_INV_PARAM;
-    size_t n = fread(buf, 1, btr, f);
+    spiffs_file_t * sf = (spiffs_file_t *)file_p;
+    if (!sf) return LV_FS_RES_INV_PARAM;
+    if (sf->cached) {
+        int n = fs_cache_read(sf->cached, buf, btr);
+        if (br) *br = n > 0 ? (uint32_t)n : 0;
+        return n < 0 ? LV_FS_RES_FS_ERR : LV_FS_RES_OK;
+    }
+    size_t n = fread(buf, 1, btr, sf->f);
     if (br) *br = (uint32_t)n;
-    if (n < btr && ferror(f)) return LV_FS_RES_FS_ERR;
+    if (n < btr && ferror(sf->f)) return LV_FS_RES_FS_ERR;
     return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t spiffs_write_v9(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t btw, uint32_t * bw)
 {
     LV_UNUSED(drv);
-    FILE * f = (FILE *)file_p;
-    if (!f) return LV_FS_RES_INV_PARAM;
+    spiffs_file_t * sf = (spiffs_file_t *)file_p;
+    if (!sf || !sf->f) return LV_FS_RES_INV_PARAM;
+    FILE * f = sf->f;
     size_t n = fwrite(buf, 1, btw, f);
+    settings_wear_note(SETTINGS_PART_STORAGE, (uint32_t)n, 0);
     if (bw) *bw = (uint32_t)n;
     if (n < btw) return LV_FS_RES_FS_ERR;
     return LV_FS_RES_OK;
@@ -170,18 +254,28 @@ static lv_fs_res_t spiffs_write_v9(lv_fs_drv_t * drv, void * file_p, const void
 static lv_fs_res_t spiffs_seek_v9(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence)
 {
     LV_UNUSED(drv);
-    FILE * f = (FILE *)file_p;
-    if (!f) return LV_FS_RES_INV_PARAM;
+    spiffs_file_t * sf = (spiffs_file_t *)file_p;
+    if (!sf) return LV_FS_RES_INV_PARAM;
+    if (sf->cached) {
+        if (whence == LV_FS_SEEK_CUR) pos += fs_cache_tell(sf->cached);
+        else if (whence == LV_FS_SEEK_END) pos += fs_cache_size(sf->cached);
+        fs_cache_seek(sf->cached, pos);
+        return LV_FS_RES_OK;
+    }
     int w = (whence == LV_FS_SEEK_SET) ? SEEK_SET : (whence == LV_FS_SEEK_CUR) ? SEEK_CUR : SEEK_END;
-    return fseek(f, (long)pos, w) == 0 ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+    return fseek(sf->f, (long)pos, w) == 0 ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
 }
 
 static lv_fs_res_t spiffs_tell_v9(lv_fs_drv_t * drv, void * file_p, uint32_t * pos)
 {
     LV_UNUSED(drv);
-    FILE * f = (FILE *)file_p;
-    if (!f) return LV_FS_RES_INV_PARAM;
-    long p = ftell(f);
+    spiffs_file_t * sf = (spiffs_file_t *)file_p;
+    if (!sf) return LV_FS_RES_INV_PARAM;
+    if (sf->cached) {
+        if (pos) *pos = fs_cache_tell(sf->cached);
+        return LV_FS_RES_OK;
+    }
+    long p = ftell(sf->f);
     if (p < 0) return LV_FS_RES_FS_ERR;
     if (pos) *pos = (uint32_t)p;
     return LV_FS_RES_OK;
@@ -205,11 +299,8 @@ static lv_fs_res_t spiffs_dir_read_v9(lv_fs_drv_t * drv, void * rddir_p, char *
         de = readdir(d);
         if (!de) { fn[0] = '\0'; return LV_FS_RES_OK; }
     } while (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0);
-    // Ensure null-termination
-    if (fn_len > 0) {
-        strncpy(fn, de->d_name, fn_len - 1);
-        fn[fn_len - 1] = '\0';
-    }
+    // LVGL marks directories with a leading '/'; only LittleFS has them
+    snprintf(fn, fn_len, "%s%s", de->d_type == DT_DIR ? "/" : "", de->d_name);
     return LV_FS_RES_OK;
 }
 
@@ -225,10 +316,11 @@ static lv_fs_res_t spiffs_dir_close_v9(lv_fs_drv_t * drv, void * rddir_p)
 
 void lvgl_spiffs_fs_register(void)
 {
+    // LVGL keeps a pointer to the driver, so it must outlive this call
+    static lv_fs_drv_t drv;
 #if LVGL_VERSION_MAJOR < 9
     static bool registered = false;
     if (registered) return;
-    lv_fs_drv_t drv;
     lv_fs_drv_init(&drv);
     drv.letter = LV_FS_LETTER_SPIFFS;
     drv.cache_size = 0;
@@ -249,7 +341,10 @@ void lvgl_spiffs_fs_register(void)
     static bool registered = false;
     if (registered) return;
 
-    lv_fs_drv_t drv;
+    void * mem = heap_caps_malloc(LVGL_FS_CACHE_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!mem) ESP_LOGW(TAG, "No PSRAM for the block cache, reads go straight to storage");
+    fs_cache_init(&k_posix_ops, mem, mem ? LVGL_FS_CACHE_BYTES : 0);
+
     lv_fs_drv_init(&drv);
     drv.letter = LV_FS_LETTER_SPIFFS;
     drv.cache_size = 0;
@@ -267,3 +362,10 @@ void lvgl_spiffs_fs_register(void)
     registered = true;
 #endif
 }
+
+void lvgl_spiffs_fs_flush(void)
+{
+#if LVGL_VERSION_MAJOR >= 9
+    fs_cache_invalidate();
+#endif
+}
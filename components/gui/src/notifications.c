@@ -1,55 +1,55 @@
 #include "notifications.h"
 #include "ui_fonts.h"
+#include <stdlib.h>
 #include <string.h>
-#include <strings.h>
 
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 
+#include "app_registry.h"
+#include "bsp/esp32_s3_touch_amoled_2_06.h"
+#include "notif_journal.h"
 #include "ui.h"
+#include "ui_styles.h"
+#include "ui_images.h"
+#include "ui_vlist.h"
 #include "watchface.h"
 
-// Keep the last N notifications and allow swipe left/right
-#define MAX_NOTIFICATIONS 5
-
-LV_IMAGE_DECLARE(image_notification_48);
-LV_IMAGE_DECLARE(image_sms_48);
-LV_IMAGE_DECLARE(image_call_48);
-LV_IMAGE_DECLARE(image_gmail_48);
-LV_IMAGE_DECLARE(image_whatsapp_48);
-LV_IMAGE_DECLARE(image_messenger_48);
-LV_IMAGE_DECLARE(image_telegram_48);
-LV_IMAGE_DECLARE(image_outlook_48);
-LV_IMAGE_DECLARE(image_youtube_48);
-LV_IMAGE_DECLARE(image_teams_48);
-LV_IMAGE_DECLARE(image_instagram_48);
-LV_IMAGE_DECLARE(image_tiktok_48);
-LV_IMAGE_DECLARE(image_x_48);
-
-typedef struct NotificationItem {
-    char app[32];
-    char title[64];
-    char message[256];
-    char ts_iso[40];
-} NotificationItem;
-
-// Data buffer
-static NotificationItem notif_buf[MAX_NOTIFICATIONS];
-static int notif_count = 0; // valid items in buffer
-
-// Container and single reusable card (low memory)
+// History lives in the notification journal and scrolls as a virtualized
+// list: NOTIF_POOL cards are recycled over however many entries there are
+#define NOTIF_POOL       7
+#define NOTIF_CARD_PAD   14
+#define NOTIF_CARD_GAP   10
+#define NOTIF_ROW_GAP    6
+#define NOTIF_HDR_H      48     // icon height
+#define NOTIF_MSG_LINES  4      // collapsed message
+#define NOTIF_EST_H      220
+
+// Body of the card being bound or measured, loaded from the journal on
+// demand; both run under the display lock
+static char notif_body[NOTIF_JOURNAL_BODY_MAX + 4];
+
+typedef struct {
+    lv_obj_t* card;
+    lv_obj_t* icon;
+    lv_obj_t* app;
+    lv_obj_t* title;
+    lv_obj_t* message;
+    lv_obj_t* time;
+} notif_card_t;
+
 static lv_obj_t *notification_screen;      // root container (fills panel)
-static lv_obj_t *card;            // single card reused for all items
-static lv_obj_t *avatar_img;      // optional image icon
-static lv_obj_t *lbl_app;
-static lv_obj_t *lbl_time;
-static lv_obj_t *lbl_title;
-static lv_obj_t *lbl_message;
-static lv_obj_t *hdr_separator;
-static lv_obj_t *pager_cont;      // bottom-center pager (dots)
-static lv_obj_t *pager_dots[MAX_NOTIFICATIONS];
-static int active_idx = 0;        // current shown index (0 = most recent)
+static lv_obj_t *lbl_empty;
+static ui_vlist_t* s_list;
+static notif_card_t s_cards[NOTIF_POOL];
+static uint8_t s_card_count;
+static uint32_t s_expanded_id;    // journal id shown in full, 0 = none
+// The list shows the journal entries with ids below s_limit. The BLE task
+// appends without the display lock, so positions are counted under this
+// bound and don't shift until notifications_show() takes the new entries in
+static uint32_t s_limit;
 
 lv_obj_t* notifications_screen_get(void);
 
@@ -60,17 +60,6 @@ static void set_label_text(lv_obj_t* lbl, const char* txt)
     lv_label_set_text(lbl, txt);
 }
 
-static void show_empty_state(void)
-{
-    if (avatar_img) {
-        lv_image_set_src(avatar_img, &image_notification_48);
-    }
-    set_label_text(lbl_app, "Notifications");
-    set_label_text(lbl_title, "You don't have\nnew notifications...");
-    set_label_text(lbl_message, "");
-    set_label_text(lbl_time, "");
-}
-
 // Format "YYYY-MM-DD HH:MM" from ISO timestamp
 static void format_datetime_ymd_hhmm(const char* iso_ts, char* out, size_t out_sz)
 {
@@ -87,424 +76,262 @@ static void format_datetime_ymd_hhmm(const char* iso_ts, char* out, size_t out_s
     out[11] = t[1]; out[12] = t[2]; out[13] = ':'; out[14] = t[4]; out[15] = t[5]; out[16] = '\0';
 }
 
-typedef struct AppMeta {
-    const char* id;
-    const char* friendly;    
-    const lv_image_dsc_t* icon;
-} AppMeta;
-
-static const AppMeta k_known_apps[] = {
-    { "sms",                                "SMS",          &image_sms_48 },
-    { "com.android.messaging",              "SMS",          &image_sms_48 },
-    { "com.google.android.apps.messaging",  "SMS",          &image_sms_48 },
-    { "com.google.android.apps.messagi",    "SMS",          &image_sms_48 },
-    { "call",                               "Call",         &image_call_48 },
-    { "com.google.android.dialer",          "Call",         &image_call_48 },
-    { "com.google.android.gm",              "Gmail",        &image_gmail_48 },
-    { "com.google.android.youtube",         "YouTube",      &image_youtube_48 },
-    { "com.whatsapp",                       "WhatsApp",     &image_whatsapp_48 },
-    { "com.facebook.katana",                "Facebook",     &image_messenger_48 },
-    { "org.telegram.messenger",             "Telegram",     &image_telegram_48 },
-    { "com.microsoft.office.outlook",       "Outlook",      &image_outlook_48 },
-    { "com.microsoft.teams",                "Teams",        &image_teams_48 },
-    { "com.instagram.android",              "Instagram",    &image_instagram_48 },
-    { "com.zhiliaoapp.musically",           "TikTok",       &image_tiktok_48 },
-    { "com.twitter.android",                "X (Twitter)",  &image_x_48 },
-};
-
-static const AppMeta* get_app_meta(const char* app_id)
+static int32_t message_height(const char* msg, int32_t width, bool expanded)
 {
-    static AppMeta dyn; // for unknown apps
-    if (app_id && *app_id) {
-        for (size_t i = 0; i < sizeof(k_known_apps)/sizeof(k_known_apps[0]); ++i) {
-            if (strcasecmp(app_id, k_known_apps[i].id) == 0) {
-                return &k_known_apps[i];
-            }
-        }
-        dyn.id = app_id;
-        dyn.friendly = app_id;
-        dyn.icon = &image_notification_48;
-        return &dyn;
-    }
-    static const AppMeta unknown = { "", "Notifications", &image_notification_48 };
-    return &unknown;
+    if (!msg || !*msg) return 0;
+    lv_point_t sz;
+    lv_text_get_size(&sz, msg, &font_normal_26, 0, 0, width, LV_TEXT_FLAG_NONE);
+    int32_t max_h = lv_font_get_line_height(&font_normal_26) * NOTIF_MSG_LINES;
+    return expanded || sz.y <= max_h ? sz.y : max_h;
 }
 
-static void update_card_content(int idx)
+// Runs on the list's measuring task, and on the LVGL thread for a refresh.
+// The record is read from the journal (which has its own lock) into a
+// buffer of this call's own, without the display lock: a flash read must
+// not hold up rendering. If s_limit moved meanwhile the list's indices did
+// too, and it drops the result. Only the text measurement, which shares
+// the font cache with the LVGL thread, runs under the display lock.
+static int32_t measure_cb(uint32_t index, int32_t width, void* ctx)
 {
-    if (idx < 0 || idx >= notif_count) {
-        show_empty_state();
-        return;
+    (void)ctx;
+    uint32_t id = notif_journal_id_below(__atomic_load_n(&s_limit, __ATOMIC_RELAXED), index);
+    if (!id) return 0;
+    char* body = heap_caps_malloc(NOTIF_JOURNAL_BODY_MAX + 4, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!body) return 0;
+    notif_entry_t e;
+    int32_t h = 0;
+    if (notif_journal_read(id, &e, body, NOTIF_JOURNAL_BODY_MAX + 4) == ESP_OK) {
+        const int32_t w = width - 2 * NOTIF_CARD_PAD;
+        lv_point_t sz;
+        bsp_display_lock(0);
+        lv_text_get_size(&sz, e.title ? e.title : "", &font_bold_26, 0, 0, w, LV_TEXT_FLAG_NONE);
+        h = 2 * NOTIF_CARD_PAD + NOTIF_HDR_H + sz.y
+          + message_height(e.message, w, id == s_expanded_id)
+          + lv_font_get_line_height(&font_normal_26)
+          + 3 * NOTIF_ROW_GAP;
+        bsp_display_unlock();
     }
-    char dt[17];
-    format_datetime_ymd_hhmm(notif_buf[idx].ts_iso, dt, sizeof(dt));
-    /*if (lbl_num[idx]) {
-        char num[8];
-        lv_snprintf(num, sizeof(num), "# %d", idx + 1); // Latest is 1
-        lv_label_set_text(lbl_num[idx], num);
-    }*/
-    // Unified metadata for name, color, icon
-    const char* app_id = notif_buf[idx].app;
-    const AppMeta* meta = get_app_meta(app_id);
-    set_label_text(lbl_app, meta ? meta->friendly : app_id);
-    set_label_text(lbl_title, notif_buf[idx].title);
-    set_label_text(lbl_message, notif_buf[idx].message);
-    set_label_text(lbl_time, dt);
-
-    // Update avatar (image if available; otherwise colored monogram)
-    //if (avatar) {
-
-        // Always show an icon per metadata
-        const lv_image_dsc_t* icon = (meta && meta->icon) ? meta->icon : &image_notification_48;
-        if (icon && avatar_img) {
-            lv_image_set_src(avatar_img, icon);
-        }
-        // Use color from metadata on the label text (safer than bg on label)
-        //uint32_t color = meta ? meta->color : 0x3B82F6;
-        //lv_obj_set_style_text_color(lbl_app, lv_color_hex(color), 0);
-
-        // Letter avatar is no longer used (always show icon)
-    //}
+    heap_caps_free(body);
+    return h;
 }
 
-static void create_tile(int idx) { (void)idx; }
-
-static void build_single_card(lv_obj_t* parent)
+static void bind_cb(lv_obj_t* card, uint32_t index, void* ctx)
 {
-    card = lv_obj_create(parent);
-    lv_obj_remove_style_all(card);
-    lv_obj_set_size(card, lv_pct(100), lv_pct(100));
-    //lv_obj_set_style_pad_all(card, 10, 0);
-    //lv_obj_set_style_pad_row(card, 10, 0);
-    lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(card, LV_FLEX_ALIGN_SPACE_BETWEEN, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_SPACE_BETWEEN);
-    //lv_obj_add_flag(card, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
-
-    lv_obj_t* hdr_card = lv_obj_create(card);
-    lv_obj_remove_style_all(hdr_card);
-    //lv_obj_set_size(hdr_card, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-    lv_obj_set_flex_flow(hdr_card, LV_FLEX_FLOW_ROW);
-    lv_obj_set_flex_align(hdr_card, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_SPACE_EVENLY);
-    lv_obj_set_size(hdr_card, lv_pct(100), LV_SIZE_CONTENT);
-    lv_obj_set_align(hdr_card, LV_ALIGN_TOP_MID);
-    lv_obj_set_style_bg_color(hdr_card, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_bg_opa(hdr_card, LV_OPA_20, 0);
-
-    /*avatar = lv_obj_create(hdr_card);
-    lv_obj_remove_style_all(avatar);
-    lv_obj_set_size(avatar, 62, 62);
-    lv_obj_set_style_radius(avatar, 18, 0);
-    lv_obj_set_style_bg_color(avatar, lv_color_hex(0x444444), 0);
-    lv_obj_set_style_bg_opa(avatar, LV_OPA_COVER, 0);
-    lv_obj_set_style_border_width(avatar, 0, 0);
-    lv_obj_set_style_pad_all(avatar, 0, 0);*/
-
-    avatar_img = lv_image_create(hdr_card);
-    lv_image_set_src(avatar_img, &image_notification_48);
-    //lv_obj_set_size(avatar_img, 62, 62);    
-
-    lbl_app = lv_label_create(hdr_card);
-    lv_obj_set_style_text_color(lbl_app, lv_color_hex(0xF0F0F0), 0);
-    lv_obj_set_style_text_font(lbl_app, &font_normal_26, 0);
-    lv_obj_set_style_pad_left(lbl_app, 12, 0);
-    lv_label_set_text(lbl_app, "Notifications");
-    lv_label_set_long_mode(lbl_app, LV_LABEL_LONG_SCROLL_CIRCULAR);
-
-    /*hdr_separator = lv_obj_create(card);
-    lv_obj_remove_style_all(hdr_separator);
-    lv_obj_set_height(hdr_separator, 1);
-    lv_obj_set_width(hdr_separator, lv_pct(100));
-    lv_obj_set_style_bg_color(hdr_separator, lv_color_hex(0x4E4E4E), 0);
-    lv_obj_set_style_bg_opa(hdr_separator, LV_OPA_COVER, 0);
-    lv_obj_set_style_pad_top(hdr_separator, 0, 0);
-    lv_obj_set_style_pad_bottom(hdr_separator, 0, 0);
-    lv_obj_set_style_margin_top(hdr_separator, 0, 0);*/
-    //lv_obj_set_style_margin_bottom(hdr_separator, 8, 0);
-    //lv_obj_set_size(lbl_app, lv_pct(100), 52);
-
-    lbl_title = lv_label_create(card);
-    lv_label_set_text(lbl_title, "You don't have\nnew notifications...");
-    lv_obj_set_width(lbl_title, lv_pct(100));
-    lv_label_set_long_mode(lbl_title, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_align(lbl_title, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_set_style_text_color(lbl_title, lv_color_hex(0x90F090), 0);
-    lv_obj_set_style_text_font(lbl_title, &font_bold_26, 0);
-
-    lbl_message = lv_label_create(card);
-    lv_label_set_text(lbl_message, "");
-    lv_obj_set_width(lbl_message, lv_pct(100));
-    lv_label_set_long_mode(lbl_message, LV_LABEL_LONG_WRAP);
-    lv_obj_set_style_text_align(lbl_message, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_set_style_text_color(lbl_message, lv_color_hex(0xF0F0F0), 0);
-    lv_obj_set_style_text_font(lbl_message, &font_normal_26, 0);
-
-    lbl_time = lv_label_create(card);
-    lv_obj_set_style_pad_bottom(lbl_time, 25, 0);
-    lv_obj_set_style_text_color(lbl_time, lv_color_hex(0x909090), 0);
-    lv_obj_set_style_text_font(lbl_time, &font_normal_26, 0);
-    lv_label_set_text(lbl_time, "");
-}
-
-static void update_pager(int active_idx)
-{
-    if (!pager_cont) return;
-    // Hide when there are 0 or 1 notifications
-    if (notif_count <= 1) {
-        lv_obj_add_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
-        return;
+    (void)ctx;
+    notif_card_t* c = lv_obj_get_user_data(card);
+    notif_entry_t e;
+    uint32_t id = notif_journal_id_below(s_limit, index);
+    if (!id || notif_journal_read(id, &e, notif_body, sizeof(notif_body)) != ESP_OK) {
+        e = (notif_entry_t){ .app = "", .title = "", .message = "", .timestamp = "" };
     }
 
-    lv_obj_clear_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
-
-    // Ensure dots exist up to MAX_NOTIFICATIONS and reflect notif_count
-    const int inactive_sz = 6;     // px
-    const int active_sz   = 10;    // px (bigger for current)
-    const uint32_t col_inactive = 0x9CA3AF; // lighter gray for better visibility
-    const uint32_t col_active   = 0xF6F6C2; // accent color matches title
-
-    for (int i = 0; i < MAX_NOTIFICATIONS; ++i) {
-        if (i >= notif_count) {
-            if (pager_dots[i]) lv_obj_add_flag(pager_dots[i], LV_OBJ_FLAG_HIDDEN);
-            continue;
-        }
-
-        if (!pager_dots[i]) {
-            pager_dots[i] = lv_obj_create(pager_cont);
-            lv_obj_remove_style_all(pager_dots[i]);
-            lv_obj_set_style_bg_opa(pager_dots[i], LV_OPA_COVER, 0);
-            lv_obj_set_style_radius(pager_dots[i], LV_RADIUS_CIRCLE, 0);
-        }
-        lv_obj_clear_flag(pager_dots[i], LV_OBJ_FLAG_HIDDEN);
-
-        bool is_active = (i == active_idx);
-        int sz = is_active ? active_sz : inactive_sz;
-        lv_obj_set_size(pager_dots[i], sz, sz);
-        lv_obj_set_style_bg_color(pager_dots[i], lv_color_hex(is_active ? col_active : col_inactive), 0);
-    }
+    char dt[17];
+    format_datetime_ymd_hhmm(e.timestamp, dt, sizeof(dt));
+    // Unknown apps show their id and the generic icon
+    const app_info_t* app = app_registry_lookup(e.app);
+    set_label_text(c->app, app ? app->name : (e.app && *e.app ? e.app : "Notifications"));
+    set_label_text(c->title, e.title);
+    set_label_text(c->message, e.message);
+    set_label_text(c->time, dt);
+    lv_image_set_src(c->icon, app && app->icon ? app->icon : assets_image("image_notification_48"));
+
+    bool expanded = id && id == s_expanded_id;
+    lv_label_set_long_mode(c->message, expanded ? LV_LABEL_LONG_WRAP : LV_LABEL_LONG_DOT);
+    lv_obj_set_style_max_height(c->message,
+        expanded ? LV_COORD_MAX : lv_font_get_line_height(&font_normal_26) * NOTIF_MSG_LINES, 0);
 }
 
-// Animation helpers (file scope)
-static void notif_anim_set_y(void *var, int32_t v)
-{
-    lv_obj_set_style_translate_y((lv_obj_t*)var, v, 0);
-}
-static void notif_anim_set_opa(void *var, int32_t v)
-{
-    lv_obj_set_style_opa((lv_obj_t*)var, (lv_opa_t)v, 0);
-}
-static void notif_anim_set_x(void *var, int32_t v)
+static void update_empty_state(void)
 {
-    lv_obj_set_style_translate_x((lv_obj_t*)var, v, 0);
+    if (notif_journal_count_below(s_limit)) {
+        lv_obj_add_flag(lbl_empty, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        set_label_text(lbl_empty, "You don't have\nnew notifications...");
+        lv_obj_remove_flag(lbl_empty, LV_OBJ_FLAG_HIDDEN);
+    }
 }
 
-// Simple slide transition state
-static bool notif_is_animating = false;
-static int slide_target_idx = 0;
-static int slide_dir = 0; // +1 = to left (next), -1 = to right (prev)
-
-static void slide_phase2_ready_cb(lv_anim_t* a)
+// After the journal changed by other means than one insert or delete;
+// takes in everything appended so far
+static void reload_list(void)
 {
-    (void)a;
-    notif_is_animating = false;
+    s_limit = notif_journal_id_at(0) + 1;
+    ui_vlist_set_count(s_list, (uint32_t)notif_journal_count_below(s_limit));
+    update_empty_state();
 }
 
-static void slide_phase1_ready_cb(lv_anim_t* a)
+static int32_t index_of(uint32_t id)
 {
-    (void)a;
-    // Swap content to target item
-    active_idx = slide_target_idx;
-    update_card_content(active_idx);
-    update_pager(active_idx);
-
-    // Prepare for slide-in from opposite side
-    int32_t start_x = (slide_dir > 0) ? 30 : -30;
-    if (card) {
-        lv_obj_set_style_translate_x(card, start_x, 0);
-        lv_obj_set_style_opa(card, 0, 0);
-
-        // Slide-in
-        lv_anim_t a_in; lv_anim_init(&a_in);
-        lv_anim_set_var(&a_in, card);
-        lv_anim_set_values(&a_in, start_x, 0);
-        lv_anim_set_time(&a_in, 140);
-        lv_anim_set_exec_cb(&a_in, notif_anim_set_x);
-        lv_anim_set_ready_cb(&a_in, slide_phase2_ready_cb);
-        lv_anim_start(&a_in);
-
-        // Fade-in
-        lv_anim_t a_in_f; lv_anim_init(&a_in_f);
-        lv_anim_set_var(&a_in_f, card);
-        lv_anim_set_values(&a_in_f, 0, 255);
-        lv_anim_set_time(&a_in_f, 140);
-        lv_anim_set_exec_cb(&a_in_f, notif_anim_set_opa);
-        lv_anim_start(&a_in_f);
-    } else {
-        notif_is_animating = false;
+    size_t n = notif_journal_count_below(s_limit);
+    for (size_t i = 0; i < n; ++i) {
+        if (notif_journal_id_below(s_limit, i) == id) return (int32_t)i;
     }
+    return -1;
 }
 
-static void start_slide_to(int new_idx, int dir)
+static void toggle_expanded(uint32_t index)
 {
-    if (!card || new_idx == active_idx) {
-        // Fallback: no animation
-        active_idx = new_idx;
-        update_card_content(active_idx);
-        update_pager(active_idx);
-        notif_is_animating = false;
-        return;
-    }
-    notif_is_animating = true;
-    slide_target_idx = new_idx;
-    slide_dir = dir;
-
-    // Ensure in known state
-    lv_obj_set_style_translate_x(card, 0, 0);
-    lv_obj_set_style_opa(card, 255, 0);
-
-    // Phase 1: slide-out slightly and fade-out
-    int32_t end_x = (dir > 0) ? -30 : 30;
-    lv_anim_t a_out; lv_anim_init(&a_out);
-    lv_anim_set_var(&a_out, card);
-    lv_anim_set_values(&a_out, 0, end_x);
-    lv_anim_set_time(&a_out, 120);
-    lv_anim_set_exec_cb(&a_out, notif_anim_set_x);
-    lv_anim_set_ready_cb(&a_out, slide_phase1_ready_cb);
-    lv_anim_start(&a_out);
-
-    lv_anim_t a_out_f; lv_anim_init(&a_out_f);
-    lv_anim_set_var(&a_out_f, card);
-    lv_anim_set_values(&a_out_f, 255, 0);
-    lv_anim_set_time(&a_out_f, 120);
-    lv_anim_set_exec_cb(&a_out_f, notif_anim_set_opa);
-    lv_anim_start(&a_out_f);
+    uint32_t id = notif_journal_id_below(s_limit, index);
+    int32_t prev = s_expanded_id ? index_of(s_expanded_id) : -1;
+    s_expanded_id = id == s_expanded_id ? 0 : id;
+    if (prev >= 0 && (uint32_t)prev != index) ui_vlist_refresh(s_list, (uint32_t)prev);
+    ui_vlist_refresh(s_list, index);
 }
 
-static void delete_notification_at(int idx)
+static void delete_notification_at(uint32_t index)
 {
-    if (idx < 0 || idx >= notif_count) {
-        return;
-    }
-    for (int i = idx; i < notif_count - 1; ++i) {
-        notif_buf[i] = notif_buf[i + 1];
-    }
-    notif_count--;
-    if (notif_count <= 0) {
-        notif_count = 0;
-        active_idx = 0;
-        notif_is_animating = false;
-        show_empty_state();
-        update_pager(active_idx);
+    size_t before = notif_journal_count_below(s_limit);
+    uint32_t id = notif_journal_id_below(s_limit, index);
+    if (!id || notif_journal_delete(id) != ESP_OK) {
+        ESP_LOGW("NOTIF", "Could not delete notification %lu", (unsigned long)index);
         return;
     }
-    if (active_idx > idx) {
-        active_idx--;
-    }
-    if (active_idx >= notif_count) {
-        active_idx = notif_count - 1;
+    if (id == s_expanded_id) s_expanded_id = 0;
+    if (notif_journal_count_below(s_limit) + 1 == before) {
+        ui_vlist_remove(s_list, index);
+        update_empty_state();
+    } else {
+        // The tombstone rotated a segment out as well
+        reload_list();
     }
-    notif_is_animating = false;
-    update_card_content(active_idx);
-    update_pager(active_idx);
 }
 
-static void gesture_event_cb(lv_event_t* e)
+static void card_event_cb(lv_event_t* e)
 {
-    lv_event_code_t code = lv_event_get_code(e);
-    //ESP_LOGI("NOTIF", "Notif event: %d", code);
-    static lv_point_t press_start = {0,0};
-    if (code == LV_EVENT_GESTURE) {
-        lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
-        //ESP_LOGI("NOTIF", "Notif event dir : %d", dir);
-        if (!notif_is_animating) {
-            if (dir == LV_DIR_LEFT) {
-                if (active_idx + 1 < notif_count) {
-                    lv_indev_wait_release(lv_indev_active());
-                    start_slide_to(active_idx + 1, +1);
-                }
-            } else if (dir == LV_DIR_RIGHT) {
-                if (active_idx > 0) {
-                    lv_indev_wait_release(lv_indev_active());
-                    start_slide_to(active_idx - 1, -1);
-                }
-            }
-        }
-        /*if (dir == LV_DIR_TOP) {
-            lv_indev_wait_release(lv_indev_active());
-            load_screen(notification_screen, watchface_screen_get(), LV_SCR_LOAD_ANIM_MOVE_TOP);
-        }
-        return;*/
-    }
-    if (code == LV_EVENT_LONG_PRESSED) {
-        if (!notif_is_animating && notif_count > 0) {
-            lv_indev_wait_release(lv_indev_active());
-            delete_notification_at(active_idx);
-        }
-        return;
-    }
-    if (code == LV_EVENT_PRESSED) {
-        lv_indev_get_point(lv_indev_active(), &press_start);
-        return;
+    lv_obj_t* card = lv_event_get_current_target(e);
+    int32_t index = ui_vlist_card_index(s_list, card);
+    if (index < 0) return;
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_SHORT_CLICKED:
+        toggle_expanded((uint32_t)index);
+        break;
+    case LV_EVENT_LONG_PRESSED:
+        lv_indev_wait_release(lv_indev_active());
+        delete_notification_at((uint32_t)index);
+        break;
+    default:
+        break;
     }
-    if (code == LV_EVENT_RELEASED) {
-        lv_point_t now; lv_indev_get_point(lv_indev_active(), &now);
-        int dx = now.x - press_start.x;
-        if (!notif_is_animating) {
-            if (dx <= -30) { // swipe left
-                if (active_idx + 1 < notif_count) {
-                    start_slide_to(active_idx + 1, +1);
-                }
-            } else if (dx >= 30) { // swipe right
-                if (active_idx > 0) {
-                    start_slide_to(active_idx - 1, -1);
-                }
-            }
-        }
-        return;
+}
+
+static lv_obj_t* create_card_cb(lv_obj_t* parent, void* ctx)
+{
+    (void)ctx;
+    notif_card_t* c = &s_cards[s_card_count++];
+
+    c->card = lv_obj_create(parent);
+    lv_obj_remove_style_all(c->card);
+    lv_obj_set_style_bg_color(c->card, lv_color_hex(0x1C1C1C), 0);
+    lv_obj_set_style_bg_opa(c->card, LV_OPA_COVER, 0);
+    lv_obj_set_style_radius(c->card, 18, 0);
+    lv_obj_set_style_pad_all(c->card, NOTIF_CARD_PAD, 0);
+    lv_obj_set_style_pad_row(c->card, NOTIF_ROW_GAP, 0);
+    lv_obj_set_style_clip_corner(c->card, true, 0);
+    lv_obj_remove_flag(c->card, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_flag(c->card, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
+    lv_obj_set_flex_flow(c->card, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(c->card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_user_data(c->card, c);
+    lv_obj_add_event_cb(c->card, card_event_cb, LV_EVENT_SHORT_CLICKED, NULL);
+    lv_obj_add_event_cb(c->card, card_event_cb, LV_EVENT_LONG_PRESSED, NULL);
+
+    lv_obj_t* hdr = lv_obj_create(c->card);
+    lv_obj_remove_style_all(hdr);
+    lv_obj_set_size(hdr, lv_pct(100), NOTIF_HDR_H);
+    lv_obj_set_flex_flow(hdr, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(hdr, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_add_flag(hdr, LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
+
+    c->icon = lv_image_create(hdr);
+    lv_image_set_src(c->icon, assets_image("image_notification_48"));
+
+    c->app = lv_label_create(hdr);
+    lv_obj_set_flex_grow(c->app, 1);
+    lv_obj_set_style_text_color(c->app, lv_color_hex(0xF0F0F0), 0);
+    lv_obj_set_style_text_font(c->app, &font_normal_26, 0);
+    lv_obj_set_style_pad_left(c->app, 12, 0);
+    lv_label_set_long_mode(c->app, LV_LABEL_LONG_DOT);
+
+    c->title = lv_label_create(c->card);
+    lv_obj_set_width(c->title, lv_pct(100));
+    lv_label_set_long_mode(c->title, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_color(c->title, lv_color_hex(0x90F090), 0);
+    lv_obj_set_style_text_font(c->title, &font_bold_26, 0);
+
+    c->message = lv_label_create(c->card);
+    lv_obj_set_width(c->message, lv_pct(100));
+    lv_label_set_long_mode(c->message, LV_LABEL_LONG_DOT);
+    lv_obj_set_style_text_color(c->message, lv_color_hex(0xF0F0F0), 0);
+    lv_obj_set_style_text_font(c->message, &font_normal_26, 0);
+
+    c->time = lv_label_create(c->card);
+    lv_obj_set_style_text_color(c->time, lv_color_hex(0x909090), 0);
+    lv_obj_set_style_text_font(c->time, &font_normal_26, 0);
+
+    for (uint32_t i = 0; i < lv_obj_get_child_count(c->card); ++i) {
+        lv_obj_add_flag(lv_obj_get_child(c->card, i), LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
     }
+    return c->card;
 }
 
 void notifications_screen_create(lv_obj_t* parent)
 {
-
-    static lv_style_t cmain_style;
-
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
-
-    // Root container (no scroll)
+    // Root container (no scroll); the list inside scrolls
     notification_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(notification_screen);
     lv_obj_set_size(notification_screen, lv_pct(100), lv_pct(100));
     lv_obj_clear_flag(notification_screen, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_add_style(notification_screen, &cmain_style, 0);
+    lv_obj_add_style(notification_screen, ui_style_get(UI_STYLE_SCREEN), 0);
+
+    const ui_vlist_cfg_t cfg = {
+        .create_card = create_card_cb,
+        .bind = bind_cb,
+        .measure = measure_cb,
+        .est_height = NOTIF_EST_H,
+        .gap = NOTIF_CARD_GAP,
+        .pool = NOTIF_POOL,
+    };
+    s_card_count = 0;
+    s_list = ui_vlist_create(notification_screen, &cfg);
+    if (s_list) {
+        lv_obj_t* obj = ui_vlist_get_obj(s_list);
+        lv_obj_set_style_pad_hor(obj, 12, 0);
+        lv_obj_set_style_pad_ver(obj, 16, 0);
+    } else {
+        ESP_LOGE("NOTIF", "Could not create the notification list");
+    }
 
-    // Build one reusable card and enable swipe/press events on container
-    // Listen to all events here; the handler filters by code.    
-    lv_obj_add_flag(notification_screen, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
-    build_single_card(notification_screen);
+    lbl_empty = lv_label_create(notification_screen);
+    lv_obj_set_width(lbl_empty, lv_pct(90));
+    lv_obj_center(lbl_empty);
+    lv_label_set_long_mode(lbl_empty, LV_LABEL_LONG_WRAP);
+    lv_obj_set_style_text_align(lbl_empty, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_set_style_text_color(lbl_empty, lv_color_hex(0x90F090), 0);
+    lv_obj_set_style_text_font(lbl_empty, &font_bold_26, 0);
 
-    // Ensure gestures on the card bubble up to the container (where handler is attached)
-    if (card) {
-        lv_obj_add_flag(card, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_CLICKABLE);
+    s_expanded_id = 0;
+    reload_list();
+}
+
+void notifications_init(void)
+{
+    // History from earlier boots; the storage partition is mounted by now
+    if (notif_journal_init("/spiffs") != ESP_OK) {
+        ESP_LOGE("NOTIF", "Notification history unavailable");
     }
+    if (app_registry_init("/spiffs") != ESP_OK) {
+        ESP_LOGE("NOTIF", "Pushed app icons unavailable");
+    }
+}
 
-    // Pager indicator at bottom-center (dots with active highlight)
-    pager_cont = lv_obj_create(notification_screen);
-    lv_obj_remove_style_all(pager_cont);
-    lv_obj_set_align(pager_cont, LV_ALIGN_BOTTOM_MID);
-    lv_obj_set_y(pager_cont, -8);
-    lv_obj_set_size(pager_cont, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
-    lv_obj_set_flex_flow(pager_cont, LV_FLEX_FLOW_ROW);
-    lv_obj_set_style_pad_all(pager_cont, 0, 0);
-    lv_obj_set_style_pad_row(pager_cont, 0, 0);
-    lv_obj_set_style_pad_column(pager_cont, 8, 0); // gap between dots
-    for (int i = 0; i < MAX_NOTIFICATIONS; ++i) pager_dots[i] = NULL;
-    lv_obj_add_flag(pager_cont, LV_OBJ_FLAG_HIDDEN);
-
-    lv_obj_add_event_cb(notification_screen, gesture_event_cb, LV_EVENT_ALL, NULL);
+void notifications_screen_destroy(void)
+{
+    // The list frees itself with its object
+    if (notification_screen) lv_obj_delete(notification_screen);
+    notification_screen = NULL;
+    lbl_empty = NULL;
+    s_list = NULL;
+    s_card_count = 0;
 }
 
 lv_obj_t* notifications_screen_get(void)
@@ -517,55 +344,49 @@ lv_obj_t* notifications_screen_get(void)
 }
 
 
+esp_err_t notifications_store(const char* app,
+                              const char* title,
+                              const char* message,
+                              const char* timestamp_iso8601)
+{
+    if (!title && !message) return ESP_ERR_INVALID_ARG; // ignore empty
+    esp_err_t err = notif_journal_append(app, title, message, timestamp_iso8601, NULL);
+    if (err != ESP_OK) ESP_LOGW("NOTIF", "Notification not stored (%s)", esp_err_to_name(err));
+    return err;
+}
+
 void notifications_show(const char* app,
                         const char* title,
                         const char* message,
                         const char* timestamp_iso8601)
 {
-    if (!notification_screen) return;
-    if (!title && !message) return; // ignore empty
-
-    // Shift older items down
-    if (notif_count < MAX_NOTIFICATIONS) notif_count++;
-    for (int i = notif_count - 1; i > 0; --i) {
-        notif_buf[i] = notif_buf[i - 1];
+    (void)app;
+    (void)timestamp_iso8601;
+    // Without the screen there is nothing to update; it loads the journal when built
+    if (!notification_screen || (!title && !message)) return;
+
+    uint32_t newest = notif_journal_id_at(0);
+    size_t shown = ui_vlist_get_count(s_list);
+    size_t still_shown = notif_journal_count_below(s_limit);
+    if (newest < s_limit && still_shown == shown) {
+        // Nothing new: it was not stored. With an empty history it is
+        // still worth showing once
+        if (!shown) {
+            set_label_text(lbl_empty, title ? title : message);
+            lv_obj_remove_flag(lbl_empty, LV_OBJ_FLAG_HIDDEN);
+        }
+        return;
     }
 
-    // Copy new item into slot 0
-    #define CPY(dst, src) do { \
-        const char* s_ = (src) ? (src) : ""; \
-        strncpy((dst), s_, sizeof(dst) - 1); \
-        (dst)[sizeof(dst) - 1] = '\0'; \
-    } while (0)
-
-    CPY(notif_buf[0].app, app);
-    CPY(notif_buf[0].title, title);
-    CPY(notif_buf[0].message, message);
-    CPY(notif_buf[0].ts_iso, timestamp_iso8601);
-
+    if (newest >= s_limit && still_shown == shown && notif_journal_count_below(newest + 1) == shown + 1) {
+        s_limit = newest + 1;
+        ui_vlist_insert(s_list, 0);
+        update_empty_state();
+    } else {
+        // Several came in at once, appending rotated older entries out, or
+        // the journal started over
+        reload_list();
+    }
     // Jump to latest
-    active_idx = 0;
-    update_card_content(active_idx);
-    update_pager(active_idx);
-
-    // Subtle entrance animation for the newest card
-    /*if (card) {
-        // Start with slight offset + fade
-        lv_obj_set_style_translate_y(card, 16, 0);
-        lv_obj_set_style_opa(card, 0, 0);
-
-        lv_anim_t a1; lv_anim_init(&a1);
-        lv_anim_set_var(&a1, card);
-        lv_anim_set_values(&a1, 16, 0);
-        lv_anim_set_time(&a1, 180);
-        lv_anim_set_exec_cb(&a1, notif_anim_set_y);
-        lv_anim_start(&a1);
-
-        lv_anim_t a2; lv_anim_init(&a2);
-        lv_anim_set_var(&a2, card);
-        lv_anim_set_values(&a2, 0, 255);
-        lv_anim_set_time(&a2, 220);
-        lv_anim_set_exec_cb(&a2, notif_anim_set_opa);
-        lv_anim_start(&a2);
-    }*/
+    ui_vlist_scroll_to(s_list, 0, LV_ANIM_ON);
 }
@@ -1,5 +1,6 @@
 #include "setting_sound_screen.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
 #include "settings.h"
 #include "audio_alert.h"
@@ -54,20 +55,15 @@ static void on_vol_change(lv_event_t* e)
 static void test_btn_cb(lv_event_t* e)
 {
     (void)e;
-    audio_alert_notify();
+    // Cuts short whatever is playing, so the new volume is heard at once
+    (void)audio_alert_play(AUDIO_ALERT_SOUND_NOTIFY, AUDIO_ALERT_PRIO_HIGH);
 }
 
 void setting_sound_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_text_color(&style, lv_color_white());
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_bg_opa(&style, LV_OPA_COVER);
-
     ssound_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(ssound_screen);
-    lv_obj_add_style(ssound_screen, &style, 0);
+    lv_obj_add_style(ssound_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(ssound_screen, lv_pct(100), lv_pct(100));
     // Allow gestures to bubble for tileview swipes
     lv_obj_add_flag(ssound_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
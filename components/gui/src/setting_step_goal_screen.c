@@ -1,5 +1,6 @@
 #include "setting_step_goal_screen.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
 #include "settings.h"
 #include "esp_log.h"
@@ -33,15 +34,9 @@ static void plus(lv_event_t* e){ (void)e; uint32_t g=settings_get_step_goal(); g
 
 void setting_step_goal_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_text_color(&style, lv_color_white());
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_bg_opa(&style, LV_OPA_COVER);
-
     sstepgoal_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(sstepgoal_screen);
-    lv_obj_add_style(sstepgoal_screen, &style, 0);
+    lv_obj_add_style(sstepgoal_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(sstepgoal_screen, lv_pct(100), lv_pct(100));
     // Allow gestures to bubble for tileview swipes
     lv_obj_add_flag(sstepgoal_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
@@ -1,11 +1,15 @@
 #include "setting_storage_screen.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
 #include "settings.h"
 #include <string.h>
 #include <stdio.h>
 #include "lvgl.h"
 #include "storage_file_explorer.h"
+#include "lvgl_spiffs_fs.h"
+#include "notif_journal.h"
+#include "app_registry.h"
 #include "settings_menu_screen.h"
 #include "esp_log.h"
 
@@ -64,8 +68,11 @@ static void modal_btn_evt(lv_event_t* e)
             settings_reset_defaults();
             show_toast("Defaults restored");
         } else if (action && strcmp(action, "format") == 0) {
+            lvgl_spiffs_fs_flush();   // cached handles would outlive the format
             settings_format_spiffs();
-            show_toast("SPIFFS formatted");
+            notif_journal_init(NULL);   // history went with the format
+            app_registry_init(NULL);    // and so did the pushed apps
+            show_toast("Storage formatted");
         }
     }
     // Buttons live inside a row which lives inside the modal. Remove the modal.
@@ -129,10 +136,46 @@ static void confirm_restore(lv_event_t* e)
 static void confirm_format(lv_event_t* e)
 {
     (void)e;
-    create_confirm_modal("Warning", "Format SPIFFS?\nAll files will be erased.", "Format", "format");
+    char text[64];
+    snprintf(text, sizeof(text), "Format %s?\nAll files will be erased.", settings_storage_fs_name());
+    create_confirm_modal("Warning", text, "Format", "format");
 }
 
 
+static void format_bytes(char* out, size_t n, uint64_t bytes)
+{
+    if (bytes >= 1024ull * 1024ull) {
+        snprintf(out, n, "%lu.%lu MB", (unsigned long)(bytes >> 20), (unsigned long)(((bytes & 0xFFFFF) * 10) >> 20));
+    } else if (bytes >= 1024) {
+        snprintf(out, n, "%lu kB", (unsigned long)(bytes >> 10));
+    } else {
+        snprintf(out, n, "%lu B", (unsigned long)bytes);
+    }
+}
+
+// Flash written per partition since first boot, and how many setting
+// changes this boot took how many record writes
+static void fill_wear_label(lv_obj_t* lbl)
+{
+    static const char* const names[SETTINGS_PART_COUNT] = { "NVS", "Storage" };
+    char txt[160];
+    size_t pos = 0;
+    for (int i = 0; i < SETTINGS_PART_COUNT && pos < sizeof(txt); ++i) {
+        settings_wear_t w;
+        char b[16];
+        settings_get_wear((settings_part_t)i, &w);
+        format_bytes(b, sizeof(b), w.bytes_written);
+        pos += snprintf(txt + pos, sizeof(txt) - pos, "%s: %s, %lu erases\n", names[i], b, (unsigned long)w.erases);
+    }
+    settings_store_stats_t st;
+    settings_get_store_stats(&st);
+    if (pos < sizeof(txt)) {
+        snprintf(txt + pos, sizeof(txt) - pos, "Settings: %lu changes, %lu writes", (unsigned long)st.changes,
+                 (unsigned long)st.commits);
+    }
+    lv_label_set_text(lbl, txt);
+}
+
 static void show_spiffs_files(lv_event_t* e)
 {
     (void)e;
@@ -148,15 +191,9 @@ static void show_spiffs_files(lv_event_t* e)
 
 void setting_storage_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_text_color(&style, lv_color_white());
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_bg_opa(&style, LV_OPA_COVER);
-
     sstorage_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(sstorage_screen);
-    lv_obj_add_style(sstorage_screen, &style, 0);
+    lv_obj_add_style(sstorage_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(sstorage_screen, lv_pct(100), lv_pct(100));
     lv_obj_add_event_cb(sstorage_screen, screen_events, LV_EVENT_GESTURE, NULL);
     // Allow gestures to bubble for tileview swipes
@@ -195,7 +232,7 @@ void setting_storage_screen_create(lv_obj_t* parent)
     lv_obj_add_event_cb(btn_format, confirm_format, LV_EVENT_CLICKED, NULL);
     lv_obj_t* lbl_f = lv_label_create(btn_format);
     lv_obj_set_style_text_font(lbl_f, &font_bold_28, 0);
-    lv_label_set_text(lbl_f, "Format SPIFFS");
+    lv_label_set_text_fmt(lbl_f, "Format %s", settings_storage_fs_name());
 
     lv_obj_t* btn_list = lv_btn_create(content);
     lv_obj_set_size(btn_list, lv_pct(100), 60);
@@ -203,6 +240,12 @@ void setting_storage_screen_create(lv_obj_t* parent)
     lv_obj_t* lbl_l = lv_label_create(btn_list);
     lv_obj_set_style_text_font(lbl_l, &font_bold_28, 0);
     lv_label_set_text(lbl_l, "View Files");
+
+    lv_obj_t* wear = lv_label_create(content);
+    lv_obj_set_width(wear, lv_pct(100));
+    lv_obj_set_style_text_font(wear, &font_normal_26, 0);
+    lv_obj_set_style_text_color(wear, lv_color_hex(0xA0A0A0), 0);
+    fill_wear_label(wear);
 }
 
 static void on_delete(lv_event_t* e)
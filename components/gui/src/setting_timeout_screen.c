@@ -1,5 +1,6 @@
 #include "setting_timeout_screen.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
 #include "settings.h"
 #include "esp_log.h"
@@ -83,15 +84,9 @@ static lv_obj_t* make_opt(lv_obj_t* parent, const char* txt, uint32_t val)
 
 void setting_timeout_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_text_color(&style, lv_color_white());
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_bg_opa(&style, LV_OPA_COVER);
-
     stimeout_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(stimeout_screen);
-    lv_obj_add_style(stimeout_screen, &style, 0);
+    lv_obj_add_style(stimeout_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(stimeout_screen, lv_pct(100), lv_pct(100));
     lv_obj_add_event_cb(stimeout_screen, screen_events, LV_EVENT_GESTURE, NULL);
     // Allow gestures to bubble for tileview swipes
@@ -1,5 +1,6 @@
 #include "settings_menu_screen.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
 #include "settings.h"
 #include "setting_step_goal_screen.h"
@@ -96,15 +97,9 @@ static lv_obj_t* make_row(lv_obj_t* parent, const char* icon, const char* label_
 
 void settings_menu_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t cmain_style;
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_black());
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_COVER);
-
     smenu_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(smenu_screen);
-    lv_obj_add_style(smenu_screen, &cmain_style, 0);
+    lv_obj_add_style(smenu_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(smenu_screen, lv_pct(100), lv_pct(100));
     // Allow gestures to bubble so tileview can catch swipes
     lv_obj_add_flag(smenu_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
@@ -1,16 +1,19 @@
 #include "settings_screen.h"
 #include "settings.h"
 #include "ui_fonts.h"
+#include "ui_images.h"
 #include "batt_screen.h"
 #include "brightness_screen.h"
 #include "setting_flashlight_screen.h"
 #include "esp_log.h"
 #include "settings_menu_screen.h"
-#include "rtc_lib.h"
 #include "ble_sync.h"
 #include "esp_err.h"
 
 #include "ui.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
+#include "ui_styles.h"
 #include "watchface.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 
@@ -18,31 +21,21 @@ static const char* TAG = "SETTINGS SCREEN";
 
 // Use accessor from batt_screen instead of extern symbol
 
-LV_IMAGE_DECLARE(image_mute_icon);
-LV_IMAGE_DECLARE(image_flashlight_icon);
-LV_IMAGE_DECLARE(image_brightness_icon);
-LV_IMAGE_DECLARE(image_battery_icon);
-LV_IMAGE_DECLARE(image_silence_icon);
-LV_IMAGE_DECLARE(image_bluetooth_icon);
-LV_IMAGE_DECLARE(image_settings_icon);
-
 static void click_event_cb(lv_event_t* e);
 static void toggle_event_cb(lv_event_t* e);
-static void time_timer_cb(lv_timer_t* timer);
-static void update_time_label(void);
+static void time_observer_cb(lv_observer_t* observer, lv_subject_t* subject);
 static void control_screen_on_delete(lv_event_t* e);
 
 static lv_obj_t* control_screen;
 static lv_obj_t* time_label;
-static lv_timer_t* time_timer;
 
-static const lv_image_dsc_t* control_icons[] = {
-    &image_brightness_icon,
-    &image_silence_icon,
-    &image_flashlight_icon,
-    &image_battery_icon,
-    &image_bluetooth_icon,
-    &image_settings_icon
+static const char* control_icons[] = {
+    "image_brightness_icon",
+    "image_silence_icon",
+    "image_flashlight_icon",
+    "image_battery_icon",
+    "image_bluetooth_icon",
+    "image_settings_icon"
 };
 
 static const char* control_labels[] = {
@@ -63,31 +56,17 @@ enum control_id {
     CTRL_SETTINGS,
 };
 
-static void update_time_label(void)
-{
-    if (!time_label) {
-        return;
-    }
-    lv_label_set_text_fmt(time_label, "%02d:%02d", rtc_get_hour(), rtc_get_minute());
-}
-
-static void time_timer_cb(lv_timer_t* timer)
+static void time_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
 {
-    (void)timer;
-    bool locked = bsp_display_lock(0);
-    update_time_label();
-    if (locked) {
-        bsp_display_unlock();
-    }
+    LV_UNUSED(subject);
+    ui_refresh_label_fmt(lv_observer_get_target_obj(observer), "%02d:%02d",
+                         (int)lv_subject_get_int(ui_state_subject(UI_STATE_HOUR)),
+                         (int)lv_subject_get_int(ui_state_subject(UI_STATE_MINUTE)));
 }
 
 static void control_screen_on_delete(lv_event_t* e)
 {
     (void)e;
-    if (time_timer) {
-        lv_timer_del(time_timer);
-        time_timer = NULL;
-    }
     time_label = NULL;
     control_screen = NULL;
 }
@@ -103,28 +82,13 @@ static void screen_events(lv_event_t* e)
             load_screen(control_screen, watchface_screen_get(), LV_SCR_LOAD_ANIM_MOVE_BOTTOM);
         }
     }
-    else if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOADED) {
-        update_time_label();
-        if (time_timer) {
-            lv_timer_ready(time_timer);
-        }
-    }
 }
 
 void control_screen_create(lv_obj_t* parent)
 {
-
-    static lv_style_t cmain_style;
-
-
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
-
     control_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(control_screen);
-    lv_obj_add_style(control_screen, &cmain_style, 0);
+    lv_obj_add_style(control_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(control_screen, lv_pct(100), lv_pct(100));
     lv_obj_center(control_screen);
     lv_obj_clear_flag(control_screen, LV_OBJ_FLAG_SCROLLABLE);
@@ -132,7 +96,6 @@ void control_screen_create(lv_obj_t* parent)
     lv_obj_set_flex_align(control_screen, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
     lv_obj_set_style_pad_row(control_screen, 12, 0);
     lv_obj_add_event_cb(control_screen, screen_events, LV_EVENT_GESTURE, NULL);
-    lv_obj_add_event_cb(control_screen, screen_events, LV_EVENT_SCREEN_LOADED, NULL);
     lv_obj_add_event_cb(control_screen, control_screen_on_delete, LV_EVENT_DELETE, NULL);
 
     lv_obj_t* header = lv_obj_create(control_screen);
@@ -151,6 +114,8 @@ void control_screen_create(lv_obj_t* parent)
     lv_obj_set_style_text_font(time_label, &font_bold_32, 0);
     lv_obj_set_style_text_color(time_label, lv_color_white(), 0);
     lv_label_set_text(time_label, "--:--");
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_HOUR), time_observer_cb, time_label, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_MINUTE), time_observer_cb, time_label, NULL);
 
     lv_obj_t* grid = lv_obj_create(control_screen);
     lv_obj_remove_style_all(grid);
@@ -187,24 +152,12 @@ void control_screen_create(lv_obj_t* parent)
             lv_obj_set_style_bg_opa(item, 255, LV_PART_MAIN | LV_STATE_CHECKED);
             lv_obj_add_event_cb(item, toggle_event_cb, LV_EVENT_VALUE_CHANGED, (void*)(uintptr_t)i);
 
+            // Follow the settings, also when they change over BLE
             if (i == CTRL_SILENCE) {
-                bool sound_on = settings_get_sound();
-                bool silent = !sound_on;
-                if (silent) {
-                    lv_obj_add_state(item, LV_STATE_CHECKED);
-                }
-                else {
-                    lv_obj_clear_state(item, LV_STATE_CHECKED);
-                }
+                lv_obj_bind_state_if_eq(item, ui_state_subject(UI_STATE_SOUND), LV_STATE_CHECKED, 0);
             }
             if (i == CTRL_BLUETOOTH) {
-                bool ble_on = ble_sync_is_enabled();
-                if (ble_on) {
-                    lv_obj_add_state(item, LV_STATE_CHECKED);
-                }
-                else {
-                    lv_obj_clear_state(item, LV_STATE_CHECKED);
-                }
+                lv_obj_bind_state_if_eq(item, ui_state_subject(UI_STATE_BLE_ENABLED), LV_STATE_CHECKED, 1);
             }
         }
         else {
@@ -213,7 +166,7 @@ void control_screen_create(lv_obj_t* parent)
         }
 
         lv_obj_t* image = lv_image_create(item);
-        lv_image_set_src(image, control_icons[i]);
+        lv_image_set_src(image, assets_image(control_icons[i]));
         lv_obj_set_align(image, LV_ALIGN_TOP_MID);
         lv_obj_remove_flag(image, LV_OBJ_FLAG_CLICKABLE);
 
@@ -222,12 +175,6 @@ void control_screen_create(lv_obj_t* parent)
         lv_obj_set_style_text_color(label, lv_color_hex(0xD0D0D0), 0);
         lv_obj_set_style_text_font(label, &font_normal_26, 0);
     }
-
-    update_time_label();
-    if (!time_timer) {
-        time_timer = lv_timer_create(time_timer_cb, 1000, NULL);
-        lv_timer_ready(time_timer);
-    }
 }
 
 lv_obj_t* control_screen_get(void)
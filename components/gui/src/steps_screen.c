@@ -2,9 +2,11 @@
 #include "steps_screen.h"
 #include "sensors.h"
 #include "ui_fonts.h"
-#include "settings.h"
+#include "ui_images.h"
 
 #include "ui.h"
+#include "ui_state.h"
+#include "ui_styles.h"
 #include "watchface.h"
 
 
@@ -17,71 +19,41 @@ static lv_obj_t* s_ticks[4] = { 0 };
 
 static lv_obj_t* s_icon_left = NULL;
 //static lv_obj_t* s_icon_right = NULL;
-static lv_timer_t* s_timer = NULL;
-static uint32_t s_goal_steps = 8000;
 
-LV_IMAGE_DECLARE(image_walk_48);
 
 static void screen_events(lv_event_t* e);
 
-static void steps_timer_cb(lv_timer_t* t)
+// Steps against the goal, for either of them changing
+static void progress_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
 {
-    LV_UNUSED(t);
-    bsp_display_lock(0);
-    //if (active_screen_get() == step_screen) {
-        //if (!s_value_label) return;
-        // Refresh goal from settings if changed
-        uint32_t new_goal = settings_get_step_goal();
-        if (new_goal != s_goal_steps) {
-            s_goal_steps = new_goal ? new_goal : 1;
-            if (s_goal_label) {
-                char gbuf2[32];
-                lv_snprintf(gbuf2, sizeof(gbuf2), "Goal %u", (unsigned)s_goal_steps);
-                lv_label_set_text(s_goal_label, gbuf2);
-            }
-        }
-        uint32_t steps = sensors_get_step_count();
-        char buf[32];
-        lv_snprintf(buf, sizeof(buf), "%u", (unsigned)steps);
-        lv_label_set_text(s_value_label, buf);
-
-        // Update progress and percent
-        uint32_t goal = s_goal_steps ? s_goal_steps : 1;
-        uint32_t pct = (steps >= goal) ? 100 : (steps * 100u) / goal;
-        if (s_bar) lv_bar_set_value(s_bar, (int32_t)pct, LV_ANIM_OFF);
-
-        // Update activity type label
-        if (s_activity_label) {
-            sensors_activity_t act = sensors_get_activity();
-            const char* text = "Idle";
-            switch (act) {
-            case SENSORS_ACTIVITY_WALK: text = "Walk"; break;
-            case SENSORS_ACTIVITY_RUN:  text = "Run";  break;
-            case SENSORS_ACTIVITY_OTHER:text = "Active"; break;
-            case SENSORS_ACTIVITY_IDLE:
-            default: text = "Idle"; break;
-            }
-            lv_label_set_text(s_activity_label, text);
-        }
-    //}
+    LV_UNUSED(subject);
+    uint32_t steps = (uint32_t)lv_subject_get_int(ui_state_subject(UI_STATE_STEPS));
+    uint32_t goal = (uint32_t)lv_subject_get_int(ui_state_subject(UI_STATE_STEP_GOAL));
+    if (!goal) goal = 1;
+    uint32_t pct = (steps >= goal) ? 100 : (steps * 100u) / goal;
+    lv_bar_set_value(lv_observer_get_target_obj(observer), (int32_t)pct, LV_ANIM_OFF);
+}
 
-    bsp_display_unlock();
+static void activity_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
+{
+    const char* text = "Idle";
+    switch ((sensors_activity_t)lv_subject_get_int(subject)) {
+    case SENSORS_ACTIVITY_WALK: text = "Walk"; break;
+    case SENSORS_ACTIVITY_RUN:  text = "Run";  break;
+    case SENSORS_ACTIVITY_OTHER:text = "Active"; break;
+    case SENSORS_ACTIVITY_IDLE:
+    default: text = "Idle"; break;
+    }
+    lv_label_set_text(lv_observer_get_target_obj(observer), text);
 }
 
 void steps_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t cmain_style;
-
-    lv_style_init(&cmain_style);
-    lv_style_set_text_color(&cmain_style, lv_color_white());
-    lv_style_set_bg_color(&cmain_style, lv_color_hex(0x000000));
-    lv_style_set_bg_opa(&cmain_style, LV_OPA_100);
-
     step_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(step_screen);
     lv_obj_set_size(step_screen, lv_pct(100), lv_pct(100));
     lv_obj_set_align(step_screen, LV_ALIGN_CENTER);
-    lv_obj_add_style(step_screen, &cmain_style, 0);
+    lv_obj_add_style(step_screen, ui_style_get(UI_STYLE_SCREEN), 0);
 
     lv_obj_t* hdr_card = lv_obj_create(step_screen);
     lv_obj_remove_style_all(hdr_card);
@@ -94,7 +66,7 @@ void steps_screen_create(lv_obj_t* parent)
 
     lv_obj_t* img = lv_image_create(hdr_card);
     //lv_obj_set_align(img, LV_ALIGN_TOP_MID);
-    lv_image_set_src(img, &image_walk_48);
+    lv_image_set_src(img, assets_image("image_walk_48"));
 
     // Title row
     lv_obj_t* title = lv_label_create(hdr_card);
@@ -115,9 +87,8 @@ void steps_screen_create(lv_obj_t* parent)
 
     // Goal text under value
     s_goal_label = lv_label_create(step_screen);
-    // Initialize goal from settings
-    s_goal_steps = settings_get_step_goal();
-    lv_label_set_text_fmt(s_goal_label, "Goal %u", (unsigned)s_goal_steps);
+    // Bound before it is aligned so it is centred on its real width
+    lv_label_bind_text(s_goal_label, ui_state_subject(UI_STATE_STEP_GOAL), "Goal %d");
     lv_obj_set_style_text_color(s_goal_label, lv_color_hex(0x909090), 0);
     lv_obj_align_to(s_goal_label, s_value_label, LV_ALIGN_OUT_BOTTOM_MID, 0, 10);
     lv_obj_set_style_text_font(s_goal_label, &font_normal_32, 0);
@@ -166,8 +137,10 @@ void steps_screen_create(lv_obj_t* parent)
         lv_obj_align_to(s_ticks[i], s_bar, LV_ALIGN_LEFT_MID, x, 0);
     }
 
-    s_timer = lv_timer_create(steps_timer_cb, 5000, NULL);
-    lv_timer_ready(s_timer);
+    lv_label_bind_text(s_value_label, ui_state_subject(UI_STATE_STEPS), "%d");
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_ACTIVITY), activity_observer_cb, s_activity_label, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_STEPS), progress_observer_cb, s_bar, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_STEP_GOAL), progress_observer_cb, s_bar, NULL);
 
     //lv_obj_add_event_cb(step_screen, screen_events, LV_EVENT_GESTURE, NULL);
 }
@@ -194,12 +167,3 @@ lv_obj_t* steps_screen_get(void)
     }
     return step_screen;
 }
-
-void steps_screen_set_goal(uint32_t goal_steps)
-{
-    s_goal_steps = goal_steps ? goal_steps : 1;
-    if (s_goal_label) {
-        lv_label_set_text_fmt(s_goal_label, "Goal %u", (unsigned)s_goal_steps);
-    }
-}
-
@@ -1,7 +1,13 @@
 #include "storage_file_explorer.h"
 #include "ui.h"
+#include "ui_styles.h"
 #include "ui_fonts.h"
+#include "settings.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <dirent.h>
 #include <sys/stat.h>
 #include <string.h>
@@ -53,43 +59,227 @@ static void create_explorer_1(lv_obj_t* parent)
     lv_file_explorer_set_sort(fe, LV_EXPLORER_SORT_KIND); // folders first
 }
 /*#else*/
-// Fallback: simple list of files from /spiffs using POSIX APIs
-static void create_explorer_2(lv_obj_t* parent)
-{
-    lv_obj_t* list = lv_list_create(parent);
-    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
-    lv_obj_t * btn;
+// Fallback: list of files from /spiffs using POSIX APIs.
+//
+// A low-priority task reads the directory and stats every file into
+// s_entries; the LVGL thread picks up new entries from a timer, so a large
+// partition never blocks the UI. Only EXPLORER_POOL_ROWS row objects exist
+// and are moved and relabelled as the list scrolls. The entries stay cached
+// between visits until something writes to storage.
+
+#define EXPLORER_MAX_ENTRIES 1024
+#define EXPLORER_NAME_LEN    64         // CONFIG_LITTLEFS_OBJ_NAME_LEN; SPIFFS uses 32
+#define EXPLORER_ROW_H       56
+#define EXPLORER_POOL_ROWS   12         // rows on screen plus one above and below
+#define EXPLORER_POLL_MS     50
+
+typedef struct {
+    char name[EXPLORER_NAME_LEN];
+    uint32_t size;
+    bool dir;
+} explorer_entry_t;
 
+static explorer_entry_t* s_entries;     // PSRAM, written only by the scan task
+static volatile uint32_t s_count;       // entries published to the UI
+static volatile bool s_scanning;
+static volatile bool s_scan_failed;
+static uint32_t s_scan_gen;             // storage generation the entries belong to
+static volatile bool s_cache_valid;
+static portMUX_TYPE s_entries_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static lv_obj_t* s_list;
+static lv_obj_t* s_spacer;
+static lv_obj_t* s_status;
+static lv_obj_t* s_rows[EXPLORER_POOL_ROWS];
+static lv_timer_t* s_poll_timer;
+static uint32_t s_shown_count;          // s_count when the rows were last laid out
+static int32_t s_shown_first = -1;
+
+static void scan_task(void* arg)
+{
+    (void)arg;
+    int64_t t0 = esp_timer_get_time();
     DIR* dir = opendir("/spiffs");
     if (!dir) {
-        //(void)lv_list_add_text(list, "Cannot open /spiffs");
-        btn = lv_list_add_button(list, LV_SYMBOL_WARNING, "Cannot open /spiffs");
-        return;
+        s_scan_failed = true;
+    } else {
+        struct dirent* de;
+        uint32_t n = 0;
+        while ((de = readdir(dir)) != NULL && n < EXPLORER_MAX_ENTRIES) {
+            if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) continue;
+            explorer_entry_t* e = &s_entries[n];
+            snprintf(e->name, sizeof(e->name), "%s", de->d_name);
+            e->size = 0;
+            // Directories only exist on LittleFS; d_type saves a stat for them
+            e->dir = de->d_type == DT_DIR;
+            if (!e->dir) {
+                char path[EXPLORER_NAME_LEN + 16];
+                struct stat st;
+                snprintf(path, sizeof(path), "/spiffs/%s", de->d_name);
+                if (stat(path, &st) == 0) e->size = (uint32_t)st.st_size;
+            }
+            n++;
+            // Publish after the entry is complete; the UI never reads past s_count
+            portENTER_CRITICAL(&s_entries_lock);
+            s_count = n;
+            portEXIT_CRITICAL(&s_entries_lock);
+        }
+        if (de) ESP_LOGW(TAG, "Listing stops at %d entries", EXPLORER_MAX_ENTRIES);
+        closedir(dir);
+        ESP_LOGI(TAG, "Scanned %lu entries in %lld ms", (unsigned long)n,
+                 (long long)((esp_timer_get_time() - t0) / 1000));
+    }
+    s_cache_valid = !s_scan_failed;
+    s_scanning = false;
+    vTaskDelete(NULL);
+}
+
+static bool scan_start(void)
+{
+    if (s_scanning) return true;    // a scan from an earlier visit is still running
+    uint32_t gen = settings_storage_generation();
+    if (s_cache_valid && gen == s_scan_gen) return true;
+
+    if (!s_entries) {
+        s_entries = heap_caps_malloc(EXPLORER_MAX_ENTRIES * sizeof(explorer_entry_t),
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_entries) {
+            ESP_LOGE(TAG, "No memory for the file list");
+            return false;
+        }
+    }
+    s_cache_valid = false;
+    s_scan_failed = false;
+    s_scan_gen = gen;
+    s_count = 0;
+    s_scanning = true;
+    if (xTaskCreate(scan_task, "fe_scan", 4096, NULL, 2, NULL) != pdPASS) {
+        s_scanning = false;
+        return false;
+    }
+    return true;
+}
+
+static void row_set(lv_obj_t* row, const explorer_entry_t* e)
+{
+    lv_obj_t* icon = lv_obj_get_child(row, 0);
+    lv_obj_t* text = lv_obj_get_child(row, 1);
+    lv_label_set_text(icon, e->dir ? LV_SYMBOL_DIRECTORY : LV_SYMBOL_FILE);
+    if (e->dir) lv_label_set_text(text, e->name);
+    else lv_label_set_text_fmt(text, "%s  (%lu)", e->name, (unsigned long)e->size);
+}
+
+// Move the pooled rows to the entries around the scroll position
+static void rows_layout(bool force)
+{
+    uint32_t count = s_count;
+    int32_t first = lv_obj_get_scroll_y(s_list) / EXPLORER_ROW_H - 1;
+    if (first < 0) first = 0;
+    if (!force && first == s_shown_first && count == s_shown_count) return;
+
+    for (int i = 0; i < EXPLORER_POOL_ROWS; ++i) {
+        uint32_t idx = (uint32_t)first + i;
+        lv_obj_t* row = s_rows[i];
+        if (idx >= count) {
+            lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN);
+            continue;
+        }
+        // Rows already showing their entry keep their labels
+        if (force || lv_obj_has_flag(row, LV_OBJ_FLAG_HIDDEN) || (uint32_t)(uintptr_t)lv_obj_get_user_data(row) != idx) {
+            row_set(row, &s_entries[idx]);
+            lv_obj_set_user_data(row, (void*)(uintptr_t)idx);
+            lv_obj_set_y(row, (int32_t)idx * EXPLORER_ROW_H);
+        }
+        lv_obj_remove_flag(row, LV_OBJ_FLAG_HIDDEN);
     }
-    struct dirent* de; struct stat st;
-    while ((de = readdir(dir)) != NULL) {
-        if (!strcmp(de->d_name, ".") || !strcmp(de->d_name, "..")) continue;
-        char path[256]; snprintf(path, sizeof(path), "/spiffs/%s", de->d_name);
-        long sz = 0; if (stat(path, &st) == 0) sz = (long)st.st_size;
-        char line[128]; snprintf(line, sizeof(line), "%s  (%ld)", de->d_name, sz);
-        //lv_list_add_text(list, line);
-        btn = lv_list_add_button(list, LV_SYMBOL_FILE, line);
+    s_shown_first = first;
+}
+
+static void status_update(void)
+{
+    uint32_t count = s_count;
+    if (s_scan_failed) lv_label_set_text(s_status, LV_SYMBOL_WARNING " Cannot open /spiffs");
+    else if (s_scanning) lv_label_set_text_fmt(s_status, "Scanning... %lu", (unsigned long)count);
+    else if (count == 0) lv_label_set_text(s_status, "No files");
+    else lv_label_set_text_fmt(s_status, "%lu files", (unsigned long)count);
+}
+
+// Returns true once the scan is over and every entry is shown
+static bool poll_update(void)
+{
+    // Read the flag first: if the scan was over then, s_count is final
+    bool done = !s_scanning;
+    uint32_t count = s_count;
+    if (count != s_shown_count) {
+        // The spacer's bottom edge sets the scrollable height
+        lv_obj_set_y(s_spacer, count ? (int32_t)count * EXPLORER_ROW_H - 1 : 0);
+        rows_layout(false);
+        s_shown_count = count;
     }
-    closedir(dir);
+    status_update();
+    return done;
+}
+
+static void poll_timer_cb(lv_timer_t* t)
+{
+    if (poll_update()) {
+        lv_timer_delete(t);
+        s_poll_timer = NULL;
+    }
+}
+
+static void list_scroll_cb(lv_event_t* e)
+{
+    (void)e;
+    rows_layout(false);
+}
+
+static void create_explorer_2(lv_obj_t* parent)
+{
+    s_status = lv_label_create(parent);
+    lv_obj_set_width(s_status, lv_pct(100));
+    lv_obj_set_style_text_align(s_status, LV_TEXT_ALIGN_CENTER, 0);
+
+    s_list = lv_obj_create(parent);
+    lv_obj_remove_style_all(s_list);
+    lv_obj_set_width(s_list, lv_pct(100));
+    lv_obj_set_flex_grow(s_list, 1);
+    lv_obj_set_scroll_dir(s_list, LV_DIR_VER);
+    lv_obj_add_event_cb(s_list, list_scroll_cb, LV_EVENT_SCROLL, NULL);
+
+    s_spacer = lv_obj_create(s_list);
+    lv_obj_remove_style_all(s_spacer);
+    lv_obj_set_size(s_spacer, 1, 1);
+
+    for (int i = 0; i < EXPLORER_POOL_ROWS; ++i) {
+        lv_obj_t* row = lv_obj_create(s_list);
+        lv_obj_remove_style_all(row);
+        lv_obj_set_size(row, lv_pct(100), EXPLORER_ROW_H);
+        lv_obj_set_style_pad_hor(row, 16, 0);
+        lv_obj_set_style_pad_column(row, 12, 0);
+        lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+        lv_obj_set_flex_align(row, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+        lv_obj_remove_flag(row, LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_flag(row, LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_EVENT_BUBBLE | LV_OBJ_FLAG_GESTURE_BUBBLE);
+        (void)lv_label_create(row);
+        lv_obj_t* text = lv_label_create(row);
+        lv_label_set_long_mode(text, LV_LABEL_LONG_DOT);
+        lv_obj_set_flex_grow(text, 1);
+        s_rows[i] = row;
+    }
+
+    s_shown_count = 0;
+    s_shown_first = -1;
+    if (!scan_start()) s_scan_failed = true;
+    if (!poll_update() && !s_poll_timer) s_poll_timer = lv_timer_create(poll_timer_cb, EXPLORER_POLL_MS, NULL);
 }
 /*#endif*/
 
 void storage_file_explorer_screen_create(lv_obj_t* parent)
 {
-    static lv_style_t style;
-    lv_style_init(&style);
-    lv_style_set_text_color(&style, lv_color_white());
-    lv_style_set_bg_color(&style, lv_color_black());
-    lv_style_set_bg_opa(&style, LV_OPA_COVER);
-
     s_screen = lv_obj_create(parent);
     lv_obj_remove_style_all(s_screen);
-    lv_obj_add_style(s_screen, &style, 0);
+    lv_obj_add_style(s_screen, ui_style_get(UI_STYLE_SCREEN), 0);
     lv_obj_set_size(s_screen, lv_pct(100), lv_pct(100));
     lv_obj_add_event_cb(s_screen, screen_events, LV_EVENT_GESTURE, NULL);
     lv_obj_add_event_cb(s_screen, on_delete, LV_EVENT_DELETE, NULL);
@@ -126,6 +316,13 @@ static void on_delete(lv_event_t* e)
 {
     (void)e;
     ESP_LOGI(TAG, "File explorer screen deleted");
+    // A running scan keeps filling the cache for the next visit
+    if (s_poll_timer) {
+        lv_timer_delete(s_poll_timer);
+        s_poll_timer = NULL;
+    }
+    s_list = s_spacer = s_status = NULL;
+    memset(s_rows, 0, sizeof(s_rows));
     s_screen = NULL;
 }
 
@@ -1,9 +1,9 @@
 #include "ui.h"
-#include "ble_sync.h"
+#include "boot_seq.h"
 #include "bsp/esp-bsp.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "display_manager.h"
-#include "esp_event.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -20,6 +20,12 @@
 #include "batt_screen.h"
 #include "driver/gpio.h"
 #include "lvgl_spiffs_fs.h"
+#include "ui_images.h"
+#include "ui_screens.h"
+#include "ui_perf.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
+#include "ui_transition.h"
 
 static const char* TAG = "UI";
 
@@ -29,6 +35,16 @@ static lv_obj_t* tile2;
 static lv_obj_t* tile3;
 static lv_obj_t* tile4;
 
+// Main tiles, built on first navigation (ui_screens.h)
+static const ui_screen_def_t notifications_def = {
+  .name = "notifications", .create = notifications_screen_create, .destroy = notifications_screen_destroy,
+};
+static const ui_screen_def_t watchface_def = { .name = "watchface", .create = watchface_create, .resident = true };
+static const ui_screen_def_t control_def = { .name = "control", .create = control_screen_create };
+static ui_screen_t* notifications_tile;
+static ui_screen_t* watchface_tile;
+static ui_screen_t* control_tile;
+
 static lv_obj_t* active_screen;
 static lv_obj_t* dynamic_tile = NULL; // temporary tile right of controls
 static lv_obj_t* dynamic_subtile = NULL; // second-level tile to the right of dynamic tile
@@ -67,7 +83,9 @@ void load_screen(lv_obj_t* current_screen, lv_obj_t* next_screen,
   if (active_screen != next_screen) {
     // bsp_display_lock(0);
     bsp_display_lock(300);
-    lv_screen_load_anim(next_screen, anim, 300, 0, false);
+    if (!ui_transition_load_screen(next_screen, anim, 300)) {
+      lv_screen_load_anim(next_screen, anim, 300, 0, false);
+    }
     bsp_display_unlock();
     active_screen = next_screen;
     // bsp_display_unlock();
@@ -93,20 +111,22 @@ void swatch_tileview(void)
   lv_obj_add_event_cb(main_screen, tileview_change_cb, LV_EVENT_ALL, NULL);
 
   /*Tile1:*/
-  tile1 = lv_tileview_add_tile(main_screen, 0, 0, LV_DIR_BOTTOM);
-  notifications_screen_create(tile1);
+  notifications_tile = ui_screens_add(main_screen, &notifications_def, 0, 0, LV_DIR_BOTTOM);
+  tile1 = ui_screen_tile(notifications_tile);
 
   /*Tile2:*/
-  tile2 = lv_tileview_add_tile(main_screen, 0, 1, (lv_dir_t)(LV_DIR_TOP | LV_DIR_BOTTOM | LV_DIR_LEFT | LV_DIR_RIGHT));
-  watchface_create(tile2);
+  watchface_tile = ui_screens_add(main_screen, &watchface_def, 0, 1,
+    (lv_dir_t)(LV_DIR_TOP | LV_DIR_BOTTOM | LV_DIR_LEFT | LV_DIR_RIGHT));
+  tile2 = ui_screen_tile(watchface_tile);
 
   /*Tile3:*/
   //tile3 = lv_tileview_add_tile(main_screen, 0, 2, LV_DIR_TOP);
   //steps_screen_create(tile3);
 
   /*Tile4:*/
-  tile4 = lv_tileview_add_tile(main_screen, 1, 1, (lv_dir_t)(LV_DIR_LEFT | LV_DIR_RIGHT));
-  control_screen_create(tile4);
+  // Its on-delete handler stops the clock timer, so no destroy callback
+  control_tile = ui_screens_add(main_screen, &control_def, 1, 1, (lv_dir_t)(LV_DIR_LEFT | LV_DIR_RIGHT));
+  tile4 = ui_screen_tile(control_tile);
 
 }
 
@@ -205,6 +225,7 @@ void ui_dynamic_subtile_close(void) {
       lv_tileview_set_tile(main_screen, dynamic_tile, LV_ANIM_ON);
     }
     else if (tile4) {
+      ui_screen_build(control_tile);
       lv_tileview_set_tile(main_screen, tile4, LV_ANIM_ON);
     }
     ESP_LOGI(TAG, "Deleting dynamic subtile (3,1)");
@@ -219,6 +240,7 @@ void ui_dynamic_tile_close(void) {
   if (dynamic_tile) {
     // Navigate back to controls tile then delete
     if (tile4) {
+      ui_screen_build(control_tile);
       lv_tileview_set_tile(main_screen, tile4, LV_ANIM_ON);
     }
     ESP_LOGI(TAG, "Deleting dynamic tile (2,1)");
@@ -236,11 +258,26 @@ void create_main_screen(void) {
 
   swatch_tileview();
 
+  // Swipes and tile changes move snapshots of the tiles (ui_transition.h).
+  // Attached after the registry, which builds the tile a swipe heads to.
+#if CONFIG_UI_TRANSITION_FRAMES > 0
+  {
+    size_t frame = ui_transition_frame_size(lv_display_get_default());
+    void* mem = heap_caps_malloc(frame * CONFIG_UI_TRANSITION_FRAMES, MALLOC_CAP_SPIRAM);
+    if (mem) {
+      ui_transition_init(mem, CONFIG_UI_TRANSITION_FRAMES);
+      ui_transition_attach_tileview(main_screen);
+    } else {
+      ESP_LOGW(TAG, "No PSRAM for transition snapshots, transitions run live");
+    }
+  }
+#endif
+
   // Init All screens
   // Create settings sub-screens dynamically when needed via dynamic tile
 
-  vTaskDelay(pdMS_TO_TICKS(100));
-
+  // The rest are built when a swipe toward them starts
+  ui_screen_build(watchface_tile);
   load_screen(NULL, get_main_screen(), LV_SCR_LOAD_ANIM_NONE);
   lv_tileview_set_tile(main_screen, tile2, LV_ANIM_OFF);
 
@@ -252,6 +289,7 @@ void ui_show_messages_tile(void) {
     load_screen(NULL, get_main_screen(), LV_SCR_LOAD_ANIM_OVER_TOP);
   }
   if (lv_tileview_get_tile_active(main_screen) != tile1) {
+    ui_screen_build(notifications_tile);
     lv_tileview_set_tile(main_screen, tile1, LV_ANIM_ON);
   }
 
@@ -262,17 +300,22 @@ void ui_init(void) {
 
   init_theme();
 
+  // Before the first screen so the boot frames are recorded too
+  ui_perf_init(lv_display_get_default());
+
   // Register LVGL FS driver for SPIFFS before any file-based widgets
   lvgl_spiffs_fs_register();
 
-  create_main_screen();
+  // Map the asset partition before any screen asks for an icon
+  ui_images_init();
 
-  {
-    bool vbus = bsp_power_is_vbus_in();
-    bool chg = bsp_power_is_charging();
-    int pct = bsp_power_get_battery_percent();
-    watchface_set_power_state(vbus, chg, pct);
-  }
+  // Notifications arrive before their screen is first built
+  notifications_init();
+
+  // Subjects the screens bind to; reads the RTC, settings and PMU once
+  ui_state_init();
+
+  create_main_screen();
 
   // Sensors are initialized and task started in main. Avoid duplicating here.
 
@@ -346,71 +389,30 @@ static void ui_back_btn_task(void* arg) {
   }
 }
 
-// Callback de eventos de energia (file-scope, não aninhada)
-static void power_ui_evt(void* handler_arg, esp_event_base_t base, int32_t id,
-  void* event_data) {
-  (void)handler_arg;
-  (void)base;
-  (void)id;
-  bsp_power_event_payload_t* pl = (bsp_power_event_payload_t*)event_data;
-  if (pl) {
-    int pct = bsp_power_get_battery_percent();
-    bsp_display_lock(0);
-    watchface_set_power_state(pl->vbus_in, pl->charging, pct);
-    bsp_display_unlock();
-  }
-}
-
-// Callback BLE: atualiza ícone de ligação
-static void ble_ui_evt(void* handler_arg, esp_event_base_t base, int32_t id,
-  void* event_data) {
-  (void)handler_arg;
-  (void)base;
-  (void)event_data;
-  bool connected = (id == BLE_SYNC_EVT_CONNECTED);
-  //if (bsp_display_lock(10)) {
-  bsp_display_lock(0);
-  watchface_set_ble_connected(connected);
-  bsp_display_unlock();
-  //}
+// One-shot: the first refresh after the main screen was loaded
+static void first_frame_cb(lv_event_t* e) {
+  boot_seq_mark("first frame");
+  boot_seq_log();
+  // Baseline for what the screens built so far keep resident
+  ESP_LOGI(TAG, "Free heap at first frame: %u KB internal, %u KB PSRAM",
+    (unsigned)(heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) / 1024),
+    (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024));
+  lv_display_remove_event_cb_with_user_data(lv_event_get_target(e), first_frame_cb, NULL);
 }
 
-// Timer callback: periodic power refresh
-static void power_poll_cb(lv_timer_t* t) {
-  (void)t;
-  bool vbus = bsp_power_is_vbus_in();
-  bool chg = bsp_power_is_charging();
-  int pct = bsp_power_get_battery_percent();
-  //if (bsp_display_lock(10)) {
-  bsp_display_lock(0);
-  watchface_set_power_state(vbus, chg, pct);
-  bsp_display_unlock();
-  //}
-}
-
-void ui_task(void* pvParameters) {
-  ESP_LOGI(TAG, "UI task started");
+void ui_start(void) {
+  boot_seq_mark("ui start");
 
   ui_init();
 
   display_manager_init();
 
-  // Subscrever eventos de energia e atualizar UI
-
-  esp_event_handler_register(BSP_POWER_EVENT_BASE, ESP_EVENT_ANY_ID,
-    power_ui_evt, NULL);
-  esp_event_handler_register(BLE_SYNC_EVENT_BASE, ESP_EVENT_ANY_ID, ble_ui_evt,
-    NULL);
-
   // Start back button poller with a higher priority for snappier input
   xTaskCreate(ui_back_btn_task, "ui_back_btn", 2048, NULL, 5, NULL);
 
-  // Periodic fallback: refresh power state every 5s in case no events fire
-  lv_timer_t* t = lv_timer_create(power_poll_cb, 5000, NULL);
-  // Trigger once immediately to avoid initial 0%
-  lv_timer_ready(t);
-
-  while (1) {
-    vTaskDelay(pdMS_TO_TICKS(500));
-  }
+  bsp_display_lock(0);
+  // Touch polling slows down when nothing moves on screen
+  ui_refresh_init(bsp_display_get_input_dev());
+  lv_display_add_event_cb(lv_display_get_default(), first_frame_cb, LV_EVENT_REFR_READY, NULL);
+  bsp_display_unlock();
 }
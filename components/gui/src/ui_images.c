@@ -0,0 +1,69 @@
+#include "ui_images.h"
+
+#include "esp_log.h"
+
+static const char* TAG = "UI IMAGES";
+
+#if !CONFIG_ASSETS_PARTITION
+LV_IMAGE_DECLARE(background_wf);
+LV_IMAGE_DECLARE(image_battery_48);
+LV_IMAGE_DECLARE(image_battery_icon);
+LV_IMAGE_DECLARE(image_bluetooth_icon);
+LV_IMAGE_DECLARE(image_brightness_48);
+LV_IMAGE_DECLARE(image_brightness_icon);
+LV_IMAGE_DECLARE(image_call_48);
+LV_IMAGE_DECLARE(image_flashlight_icon);
+LV_IMAGE_DECLARE(image_gmail_48);
+LV_IMAGE_DECLARE(image_instagram_48);
+LV_IMAGE_DECLARE(image_messenger_48);
+LV_IMAGE_DECLARE(image_notification_48);
+LV_IMAGE_DECLARE(image_outlook_48);
+LV_IMAGE_DECLARE(image_settings_icon);
+LV_IMAGE_DECLARE(image_silence_icon);
+LV_IMAGE_DECLARE(image_sms_48);
+LV_IMAGE_DECLARE(image_teams_48);
+LV_IMAGE_DECLARE(image_telegram_48);
+LV_IMAGE_DECLARE(image_tiktok_48);
+LV_IMAGE_DECLARE(image_walk_48);
+LV_IMAGE_DECLARE(image_whatsapp_48);
+LV_IMAGE_DECLARE(image_x_48);
+LV_IMAGE_DECLARE(image_youtube_48);
+
+static const assets_builtin_t s_builtin[] = {
+    ASSETS_BUILTIN(background_wf),
+    ASSETS_BUILTIN(image_battery_48),
+    ASSETS_BUILTIN(image_battery_icon),
+    ASSETS_BUILTIN(image_bluetooth_icon),
+    ASSETS_BUILTIN(image_brightness_48),
+    ASSETS_BUILTIN(image_brightness_icon),
+    ASSETS_BUILTIN(image_call_48),
+    ASSETS_BUILTIN(image_flashlight_icon),
+    ASSETS_BUILTIN(image_gmail_48),
+    ASSETS_BUILTIN(image_instagram_48),
+    ASSETS_BUILTIN(image_messenger_48),
+    ASSETS_BUILTIN(image_notification_48),
+    ASSETS_BUILTIN(image_outlook_48),
+    ASSETS_BUILTIN(image_settings_icon),
+    ASSETS_BUILTIN(image_silence_icon),
+    ASSETS_BUILTIN(image_sms_48),
+    ASSETS_BUILTIN(image_teams_48),
+    ASSETS_BUILTIN(image_telegram_48),
+    ASSETS_BUILTIN(image_tiktok_48),
+    ASSETS_BUILTIN(image_walk_48),
+    ASSETS_BUILTIN(image_whatsapp_48),
+    ASSETS_BUILTIN(image_x_48),
+    ASSETS_BUILTIN(image_youtube_48),
+};
+#endif
+
+void ui_images_init(void)
+{
+#if CONFIG_ASSETS_PARTITION
+    if (assets_init() != ESP_OK) {
+        ESP_LOGE(TAG, "Asset partition unavailable, icons will be blank (run idf.py flash)");
+    }
+#else
+    assets_register_builtin(s_builtin, sizeof(s_builtin) / sizeof(s_builtin[0]));
+    ESP_LOGI(TAG, "Using %u built-in images", (unsigned)(sizeof(s_builtin) / sizeof(s_builtin[0])));
+#endif
+}
@@ -0,0 +1,411 @@
+#include "ui_perf.h"
+#include "ui_refresh.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG_UI_PERF
+
+#define NAMES_MAX               16
+#define CANDIDATES_MAX          8
+#define ATTRIB_AREAS            4       // largest invalidated areas looked up per frame
+#define OVERLAY_PERIOD_S        1
+#define OVERLAY_WINDOW_MS       2000
+
+typedef struct {
+    const char* owner;
+    const char* widget;
+    uint32_t n;                 // pixels invalidated, or render time in the summary
+} candidate_t;
+
+static lv_display_t* s_disp;
+
+// Written by the LVGL thread only. s_started is bumped before a slot is
+// overwritten and s_done once it holds the new frame, so a reader can
+// tell which of the frames it copied were being rewritten meanwhile.
+static ui_perf_frame_t s_ring[UI_PERF_FRAMES];
+static uint32_t s_started;
+static uint32_t s_done;
+
+// Frame being refreshed
+static int64_t s_refr_us, s_flush_start_us;
+static uint32_t s_flush_us, s_px, s_areas;
+static lv_area_t s_inv[ATTRIB_AREAS];
+static uint32_t s_inv_count;
+
+static struct {
+    lv_obj_t* obj;
+    const char* name;
+} s_names[NAMES_MAX];
+
+static lv_obj_t* s_overlay;
+static ui_refresh_sub_t* s_overlay_tick;
+
+// Most derived first: lv_obj_has_class() matches base classes too
+static const struct {
+    const lv_obj_class_t* cls;
+    const char* name;
+} k_classes[] = {
+    { &lv_label_class, "label" },
+    { &lv_image_class, "image" },
+#if LV_USE_ARC
+    { &lv_arc_class, "arc" },
+#endif
+#if LV_USE_SLIDER
+    { &lv_slider_class, "slider" },
+#endif
+#if LV_USE_BAR
+    { &lv_bar_class, "bar" },
+#endif
+#if LV_USE_SWITCH
+    { &lv_switch_class, "switch" },
+#endif
+#if LV_USE_ROLLER
+    { &lv_roller_class, "roller" },
+#endif
+    { &lv_button_class, "button" },
+#if LV_USE_TILEVIEW
+    { &lv_tileview_tile_class, "tile" },
+    { &lv_tileview_class, "tileview" },
+#endif
+};
+
+static const char* class_name(const lv_obj_t* obj)
+{
+    for (size_t i = 0; i < sizeof(k_classes) / sizeof(k_classes[0]); ++i) {
+        if (lv_obj_has_class(obj, k_classes[i].cls)) return k_classes[i].name;
+    }
+    return "obj";
+}
+
+static const char* owner_name(const lv_obj_t* obj)
+{
+    for (; obj; obj = lv_obj_get_parent(obj)) {
+        for (uint32_t i = 0; i < NAMES_MAX; ++i) {
+            if (s_names[i].obj == obj) return s_names[i].name;
+        }
+    }
+    return NULL;
+}
+
+// Invalidated areas carry no object. Follow the objects under the area's
+// centre from the top of each layer down and take the one whose size is
+// closest to the area (an object invalidates its own coordinates plus
+// shadows and outlines); the deeper one on a tie.
+static lv_obj_t* widget_for_area(const lv_area_t* a)
+{
+    const lv_point_t c = { (a->x1 + a->x2) / 2, (a->y1 + a->y2) / 2 };
+    const int64_t size = (int64_t)lv_area_get_size(a);
+    lv_obj_t* roots[] = { lv_display_get_layer_sys(s_disp), lv_display_get_layer_top(s_disp),
+                          lv_display_get_screen_active(s_disp) };
+    lv_obj_t* best = NULL;
+    int64_t best_diff = INT64_MAX;
+    for (size_t r = 0; r < sizeof(roots) / sizeof(roots[0]) && !best; ++r) {
+        lv_obj_t* obj = roots[r];
+        const bool layer = r < 2;       // the layers themselves cover everything
+        while (obj) {
+            if (!layer || obj != roots[r]) {
+                lv_area_t co;
+                lv_obj_get_coords(obj, &co);
+                int64_t diff = (int64_t)lv_area_get_size(&co) - size;
+                if (diff < 0) diff = -diff;
+                if (diff <= best_diff) {
+                    best = obj;
+                    best_diff = diff;
+                }
+            }
+            lv_obj_t* next = NULL;
+            for (int32_t i = (int32_t)lv_obj_get_child_count(obj) - 1; i >= 0; --i) {
+                lv_obj_t* ch = lv_obj_get_child(obj, i);
+                if (lv_obj_has_flag(ch, LV_OBJ_FLAG_HIDDEN)) continue;
+                lv_area_t co;
+                lv_obj_get_coords(ch, &co);
+                if (lv_area_is_point_on(&co, &c, 0)) {
+                    next = ch;
+                    break;
+                }
+            }
+            obj = next;
+        }
+    }
+    return best;
+}
+
+static void add_candidate(candidate_t* cand, uint32_t* count, const char* owner, const char* widget, uint32_t n)
+{
+    for (uint32_t i = 0; i < *count; ++i) {
+        if (cand[i].owner == owner && cand[i].widget == widget) {
+            cand[i].n += n;
+            return;
+        }
+    }
+    if (*count < CANDIDATES_MAX) cand[(*count)++] = (candidate_t){ owner, widget, n };
+}
+
+static const candidate_t* top_candidate(const candidate_t* cand, uint32_t count)
+{
+    const candidate_t* top = NULL;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!top || cand[i].n > top->n) top = &cand[i];
+    }
+    return top;
+}
+
+// Invalidations can come by the hundred per frame (an animation, a
+// scrolled list), and so can frames that end up drawing nothing. Only the
+// largest few areas are kept here, and their widgets are looked up once
+// the frame has been drawn.
+static void on_invalidate(const lv_area_t* a)
+{
+    if (!a) return;
+    s_areas++;
+    uint32_t slot = s_inv_count;
+    if (slot == ATTRIB_AREAS) {
+        slot = 0;
+        for (uint32_t i = 1; i < ATTRIB_AREAS; ++i) {
+            if (lv_area_get_size(&s_inv[i]) < lv_area_get_size(&s_inv[slot])) slot = i;
+        }
+        if (lv_area_get_size(a) <= lv_area_get_size(&s_inv[slot])) return;
+    } else {
+        s_inv_count++;
+    }
+    s_inv[slot] = *a;
+}
+
+static void commit_frame(int64_t now)
+{
+    candidate_t cand[CANDIDATES_MAX];
+    uint32_t cand_count = 0;
+    for (uint32_t i = 0; i < s_inv_count; ++i) {
+        lv_obj_t* obj = widget_for_area(&s_inv[i]);
+        if (obj) add_candidate(cand, &cand_count, owner_name(obj), class_name(obj), lv_area_get_size(&s_inv[i]));
+    }
+    const candidate_t* top = top_candidate(cand, cand_count);
+    const uint32_t total_us = (uint32_t)(now - s_refr_us);
+    const ui_perf_frame_t f = {
+        .t_ms = (uint32_t)(s_refr_us / 1000),
+        .render_us = total_us > s_flush_us ? total_us - s_flush_us : 0,
+        .flush_us = s_flush_us,
+        .px = s_px,
+        .areas = s_areas > UINT16_MAX ? UINT16_MAX : (uint16_t)s_areas,
+        .owner = top ? top->owner : NULL,
+        .widget = top ? top->widget : NULL,
+    };
+    const uint32_t n = s_started;
+    __atomic_store_n(&s_started, n + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    s_ring[n % UI_PERF_FRAMES] = f;
+    __atomic_store_n(&s_done, n + 1, __ATOMIC_RELEASE);
+}
+
+static void display_event_cb(lv_event_t* e)
+{
+    const int64_t now = esp_timer_get_time();
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_INVALIDATE_AREA:
+        on_invalidate(lv_event_get_param(e));
+        break;
+    case LV_EVENT_REFR_START:
+        s_refr_us = now;
+        s_flush_us = 0;
+        s_px = 0;
+        break;
+    case LV_EVENT_FLUSH_START: {
+        const lv_area_t* a = lv_event_get_param(e);
+        if (a) s_px += lv_area_get_size(a);
+        s_flush_start_us = now;
+        break;
+    }
+    case LV_EVENT_FLUSH_WAIT_START:
+        s_flush_start_us = now;
+        break;
+    case LV_EVENT_FLUSH_FINISH:
+    case LV_EVENT_FLUSH_WAIT_FINISH:
+        if (s_flush_start_us) s_flush_us += (uint32_t)(now - s_flush_start_us);
+        s_flush_start_us = 0;
+        break;
+    case LV_EVENT_REFR_READY:
+        // Refreshes with nothing to draw are not frames
+        if (s_refr_us && s_px) commit_frame(now);
+        s_refr_us = 0;
+        s_areas = 0;
+        s_inv_count = 0;
+        break;
+    default:
+        break;
+    }
+}
+
+static void name_delete_cb(lv_event_t* e)
+{
+    lv_obj_t* obj = lv_event_get_target(e);
+    for (uint32_t i = 0; i < NAMES_MAX; ++i) {
+        if (s_names[i].obj == obj) s_names[i].obj = NULL;
+    }
+}
+
+void ui_perf_set_name(lv_obj_t* obj, const char* name)
+{
+    if (!obj) return;
+    int free_slot = -1;
+    for (int i = 0; i < NAMES_MAX; ++i) {
+        if (s_names[i].obj == obj) {
+            s_names[i].name = name;
+            return;
+        }
+        if (!s_names[i].obj && free_slot < 0) free_slot = i;
+    }
+    if (free_slot < 0) return;
+    s_names[free_slot].obj = obj;
+    s_names[free_slot].name = name;
+    lv_obj_add_event_cb(obj, name_delete_cb, LV_EVENT_DELETE, NULL);
+}
+
+uint32_t ui_perf_frames_total(void)
+{
+    return __atomic_load_n(&s_done, __ATOMIC_ACQUIRE);
+}
+
+uint32_t ui_perf_get_frames(ui_perf_frame_t* out, uint32_t max)
+{
+    const uint32_t done = __atomic_load_n(&s_done, __ATOMIC_ACQUIRE);
+    uint32_t n = done < max ? done : max;
+    if (n > UI_PERF_FRAMES) n = UI_PERF_FRAMES;
+    const uint32_t first = done - n;
+    for (uint32_t i = 0; i < n; ++i) out[i] = s_ring[(first + i) % UI_PERF_FRAMES];
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    // Frames whose slots the writer reached during the copy are torn
+    const uint32_t started = __atomic_load_n(&s_started, __ATOMIC_RELAXED);
+    const uint32_t valid_from = started > UI_PERF_FRAMES ? started - UI_PERF_FRAMES : 0;
+    if (first >= valid_from) return n;
+    const uint32_t skip = valid_from - first;
+    if (skip >= n) return 0;
+    memmove(out, out + skip, (n - skip) * sizeof(*out));
+    return n - skip;
+}
+
+void ui_perf_get_summary(uint32_t window_ms, ui_perf_summary_t* out)
+{
+    *out = (ui_perf_summary_t){ 0 };
+    ui_perf_frame_t* f = malloc(sizeof(*f) * UI_PERF_FRAMES);
+    if (!f) return;
+    const uint32_t n = ui_perf_get_frames(f, UI_PERF_FRAMES);
+    const uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    uint32_t first = 0;
+    while (first < n && now_ms - f[first].t_ms > window_ms) ++first;
+    if (first == n) {
+        free(f);
+        return;
+    }
+
+    candidate_t cand[CANDIDATES_MAX];
+    uint32_t cand_count = 0;
+    uint64_t render_sum = 0, flush_sum = 0, px_sum = 0;
+    for (uint32_t i = first; i < n; ++i) {
+        render_sum += f[i].render_us;
+        flush_sum += f[i].flush_us;
+        px_sum += f[i].px;
+        if (f[i].render_us > out->render_us_max) out->render_us_max = f[i].render_us;
+        if (f[i].flush_us > out->flush_us_max) out->flush_us_max = f[i].flush_us;
+        if (f[i].widget) add_candidate(cand, &cand_count, f[i].owner, f[i].widget, f[i].render_us);
+    }
+    out->frames = n - first;
+    out->span_ms = now_ms - f[first].t_ms;
+    if (out->span_ms == 0) out->span_ms = 1;
+    out->fps_x10 = (uint32_t)((uint64_t)out->frames * 10000 / out->span_ms);
+    out->render_us_avg = (uint32_t)(render_sum / out->frames);
+    out->flush_us_avg = (uint32_t)(flush_sum / out->frames);
+    out->px_avg = (uint32_t)(px_sum / out->frames);
+    const uint64_t busy_pct = (render_sum + flush_sum) / 10 / out->span_ms;
+    out->busy_pct = busy_pct > 100 ? 100 : (uint32_t)busy_pct;
+    const candidate_t* top = top_candidate(cand, cand_count);
+    if (top) {
+        out->top_owner = top->owner;
+        out->top_widget = top->widget;
+    }
+    free(f);
+}
+
+static void overlay_timer_cb(void* user)
+{
+    (void)user;
+    ui_perf_summary_t s;
+    ui_perf_get_summary(OVERLAY_WINDOW_MS, &s);
+    lv_label_set_text_fmt(s_overlay, "%lu.%lu fps %lu.%lu/%lu.%lu ms\n%s%s%s",
+                          (unsigned long)(s.fps_x10 / 10), (unsigned long)(s.fps_x10 % 10),
+                          (unsigned long)(s.render_us_avg / 1000), (unsigned long)(s.render_us_avg / 100 % 10),
+                          (unsigned long)(s.flush_us_avg / 1000), (unsigned long)(s.flush_us_avg / 100 % 10),
+                          s.top_owner ? s.top_owner : "", s.top_owner ? " " : "",
+                          s.top_widget ? s.top_widget : "-");
+}
+
+void ui_perf_set_overlay(bool on)
+{
+    if (!s_disp || on == (s_overlay != NULL)) return;
+    if (!on) {
+        ui_refresh_cancel(s_overlay_tick);
+        lv_obj_delete(s_overlay);
+        s_overlay_tick = NULL;
+        s_overlay = NULL;
+        return;
+    }
+    s_overlay = lv_label_create(lv_display_get_layer_sys(s_disp));
+    lv_obj_set_style_bg_color(s_overlay, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(s_overlay, LV_OPA_70, 0);
+    lv_obj_set_style_text_color(s_overlay, lv_color_hex(0x40FF40), 0);
+    lv_obj_set_style_pad_hor(s_overlay, 6, 0);
+    lv_obj_align(s_overlay, LV_ALIGN_BOTTOM_MID, 0, -24);
+    ui_perf_set_name(s_overlay, "perf");
+    lv_label_set_text(s_overlay, "");
+    s_overlay_tick = ui_refresh_every(OVERLAY_PERIOD_S, overlay_timer_cb, NULL);
+}
+
+void ui_perf_init(lv_display_t* disp)
+{
+    if (!disp || s_disp) return;
+    s_disp = disp;
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_ALL, NULL);
+#if CONFIG_UI_PERF_OVERLAY
+    ui_perf_set_overlay(true);
+#endif
+}
+
+#else   // !CONFIG_UI_PERF
+
+void ui_perf_init(lv_display_t* disp)
+{
+    (void)disp;
+}
+
+void ui_perf_set_name(lv_obj_t* obj, const char* name)
+{
+    (void)obj;
+    (void)name;
+}
+
+uint32_t ui_perf_frames_total(void)
+{
+    return 0;
+}
+
+uint32_t ui_perf_get_frames(ui_perf_frame_t* out, uint32_t max)
+{
+    (void)out;
+    (void)max;
+    return 0;
+}
+
+void ui_perf_get_summary(uint32_t window_ms, ui_perf_summary_t* out)
+{
+    (void)window_ms;
+    memset(out, 0, sizeof(*out));
+}
+
+void ui_perf_set_overlay(bool on)
+{
+    (void)on;
+}
+
+#endif
@@ -0,0 +1,174 @@
+#include "ui_refresh.h"
+#include "esp_freertos_hooks.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "ui_perf.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "UI_REFRESH";
+
+#define SUBS_MAX                12
+#define ACTIVE_HOLD_MS          1000
+#define TICK_OFFSET_MS          20      // after the clock advances on the boundary
+#define STATS_WINDOW_S          10
+
+struct ui_refresh_sub {
+    void (*cb)(void* user);
+    void* user;
+    uint32_t period_s;
+    uint32_t due_s;             // esp_timer second it runs at next
+};
+
+typedef struct {
+    uint32_t touch_reads, ticks, frames;
+    uint32_t idle[2];
+} counts_t;
+
+static ui_refresh_sub_t s_subs[SUBS_MAX];
+static lv_timer_t* s_tick_timer;
+
+static lv_timer_t* s_touch_timer;
+static uint32_t s_busy_tick;
+static bool s_active;
+
+// Running counts, and the last complete window published by index so a
+// reader on another task copies a window that is not being written
+static counts_t s_counts;
+static volatile uint32_t s_idle[2];
+static counts_t s_win_start;
+static int64_t s_win_start_us;
+static ui_refresh_stats_t s_win[2];
+static uint32_t s_win_idx;
+
+static bool idle_hook_core0(void)
+{
+    s_idle[0]++;
+    return true;                // once per interrupt, not once per loop
+}
+
+static bool idle_hook_core1(void)
+{
+    s_idle[1]++;
+    return true;
+}
+
+static void touch_timer_cb(lv_timer_t* t)
+{
+    lv_indev_read_timer_cb(t);
+    s_counts.touch_reads++;
+
+    lv_indev_t* indev = lv_timer_get_user_data(t);
+    const bool busy = lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED || lv_indev_get_scroll_obj(indev) ||
+                      lv_anim_count_running() > 0;
+    if (busy) s_busy_tick = lv_tick_get();
+    const bool active = busy || lv_tick_elaps(s_busy_tick) < ACTIVE_HOLD_MS;
+    if (active != s_active) {
+        s_active = active;
+        lv_timer_set_period(t, active ? LV_DEF_REFR_PERIOD : CONFIG_UI_REFRESH_IDLE_POLL_MS);
+    }
+}
+
+static void roll_window(int64_t now_us)
+{
+    counts_t now = s_counts;
+    now.frames = ui_perf_frames_total();
+    now.idle[0] = s_idle[0];
+    now.idle[1] = s_idle[1];
+    if (s_win_start_us) {
+        ui_refresh_stats_t* w = &s_win[s_win_idx ^ 1];
+        w->window_ms = (uint32_t)((now_us - s_win_start_us) / 1000);
+        w->touch_reads = now.touch_reads - s_win_start.touch_reads;
+        w->ticks = now.ticks - s_win_start.ticks;
+        w->frames = now.frames - s_win_start.frames;
+        w->idle_wakeups[0] = now.idle[0] - s_win_start.idle[0];
+        w->idle_wakeups[1] = now.idle[1] - s_win_start.idle[1];
+        __atomic_store_n(&s_win_idx, s_win_idx ^ 1, __ATOMIC_RELEASE);
+    }
+    s_win_start = now;
+    s_win_start_us = now_us;
+}
+
+static void tick_timer_cb(lv_timer_t* t)
+{
+    const int64_t now_us = esp_timer_get_time();
+    const uint32_t sec = (uint32_t)(now_us / 1000000);
+    s_counts.ticks++;
+    for (uint32_t i = 0; i < SUBS_MAX; ++i) {
+        ui_refresh_sub_t* s = &s_subs[i];
+        // A callback may cancel itself or others
+        if (!s->cb || sec < s->due_s) continue;
+        s->due_s = (sec / s->period_s + 1) * s->period_s;
+        s->cb(s->user);
+    }
+    if (sec % STATS_WINDOW_S == 0) roll_window(now_us);
+
+    // Aim at the next boundary each time so timer latency doesn't add up
+    const uint32_t into_ms = (uint32_t)(now_us % 1000000 / 1000);
+    lv_timer_set_period(t, 1000 + TICK_OFFSET_MS - into_ms);
+}
+
+ui_refresh_sub_t* ui_refresh_every(uint32_t period_s, void (*cb)(void* user), void* user)
+{
+    if (!cb || period_s == 0) return NULL;
+    for (uint32_t i = 0; i < SUBS_MAX; ++i) {
+        ui_refresh_sub_t* s = &s_subs[i];
+        if (s->cb) continue;
+        const uint32_t sec = (uint32_t)(esp_timer_get_time() / 1000000);
+        *s = (ui_refresh_sub_t){ .cb = cb, .user = user, .period_s = period_s,
+                                 .due_s = (sec / period_s + 1) * period_s };
+        if (!s_tick_timer) {
+            const uint32_t into_ms = (uint32_t)(esp_timer_get_time() % 1000000 / 1000);
+            s_tick_timer = lv_timer_create(tick_timer_cb, 1000 + TICK_OFFSET_MS - into_ms, NULL);
+        }
+        return s;
+    }
+    ESP_LOGW(TAG, "No tick slot left");
+    return NULL;
+}
+
+void ui_refresh_cancel(ui_refresh_sub_t* sub)
+{
+    if (sub) sub->cb = NULL;
+}
+
+void ui_refresh_label_fmt(lv_obj_t* label, const char* fmt, ...)
+{
+    if (!label) return;
+    char buf[64];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (strcmp(lv_label_get_text(label), buf) != 0) lv_label_set_text(label, buf);
+}
+
+void ui_refresh_init(lv_indev_t* touch)
+{
+    esp_register_freertos_idle_hook_for_cpu(idle_hook_core0, 0);
+#if !CONFIG_FREERTOS_UNICORE
+    esp_register_freertos_idle_hook_for_cpu(idle_hook_core1, 1);
+#else
+    (void)idle_hook_core1;
+#endif
+    // Touch that wakes LVGL by interrupt has no read timer to pace
+    if (touch && !s_touch_timer && lv_indev_get_mode(touch) == LV_INDEV_MODE_TIMER) {
+        s_touch_timer = lv_indev_get_read_timer(touch);
+        if (s_touch_timer) {
+            lv_timer_set_cb(s_touch_timer, touch_timer_cb);
+            s_busy_tick = lv_tick_get();
+            s_active = true;
+        }
+    }
+    // Counts start now; the first window is cut short at the next
+    // multiple of STATS_WINDOW_S
+    if (!s_win_start_us) roll_window(esp_timer_get_time());
+}
+
+void ui_refresh_get_stats(ui_refresh_stats_t* out)
+{
+    *out = s_win[__atomic_load_n(&s_win_idx, __ATOMIC_ACQUIRE)];
+    out->active = s_active;
+}
@@ -0,0 +1,189 @@
+#include "ui_screens.h"
+#include "ui_perf.h"
+#include "ui_refresh.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdlib.h>
+
+static const char* TAG = "UI_SCREENS";
+
+#define SCREENS_MAX             8
+#define RECLAIM_PERIOD_S        10
+
+struct ui_screen {
+    const ui_screen_def_t* def;
+    lv_obj_t* tileview;
+    lv_obj_t* tile;
+    uint8_t col, row;
+    bool built;
+    int64_t shown_us;           // last time it was the active tile, or built
+    ui_screen_stats_t st;
+};
+
+static ui_screen_t s_screens[SCREENS_MAX];
+static uint32_t s_count;
+static ui_refresh_sub_t* s_reclaim_tick;
+
+static ui_screen_t* find_by_tile(const lv_obj_t* tile)
+{
+    for (uint32_t i = 0; i < s_count; ++i) {
+        if (s_screens[i].tile == tile) return &s_screens[i];
+    }
+    return NULL;
+}
+
+void ui_screen_build(ui_screen_t* s)
+{
+    if (!s || s->built) return;
+    const size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const int64_t t0 = esp_timer_get_time();
+    s->def->create(s->tile);
+    s->built = true;
+    s->shown_us = esp_timer_get_time();
+    s->st.build_us = (uint32_t)(s->shown_us - t0);
+    s->st.heap_bytes = (int32_t)(free_before - heap_caps_get_free_size(MALLOC_CAP_8BIT));
+    s->st.builds++;
+    ESP_LOGI(TAG, "Built %s in %lu ms, %ld bytes", s->def->name, (unsigned long)(s->st.build_us / 1000),
+             (long)s->st.heap_bytes);
+}
+
+static void screen_destroy(ui_screen_t* s)
+{
+    const size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (s->def->destroy) s->def->destroy();
+    lv_obj_clean(s->tile);
+    s->built = false;
+    s->st.destroys++;
+    ESP_LOGI(TAG, "Destroyed %s, %ld bytes freed", s->def->name,
+             (long)(heap_caps_get_free_size(MALLOC_CAP_8BIT) - free_before));
+}
+
+// Column and row of any tile, registered or not (tiles sit at col * w, row * h)
+static void tile_pos(lv_obj_t* tileview, lv_obj_t* tile, int32_t* col, int32_t* row)
+{
+    const int32_t w = lv_obj_get_content_width(tileview);
+    const int32_t h = lv_obj_get_content_height(tileview);
+    *col = w > 0 ? lv_obj_get_x(tile) / w : 0;
+    *row = h > 0 ? lv_obj_get_y(tile) / h : 0;
+}
+
+static void note_active(lv_obj_t* tileview)
+{
+    ui_screen_t* s = find_by_tile(lv_tileview_get_tile_active(tileview));
+    if (s) s->shown_us = esp_timer_get_time();
+}
+
+// A swipe can only end on a neighbour of the active tile along the axis it
+// started on; build those so they slide in with their content
+static void build_neighbours(lv_obj_t* tileview, lv_dir_t axis)
+{
+    lv_obj_t* act = lv_tileview_get_tile_active(tileview);
+    if (!act) return;
+    int32_t col, row;
+    tile_pos(tileview, act, &col, &row);
+    for (uint32_t i = 0; i < s_count; ++i) {
+        ui_screen_t* s = &s_screens[i];
+        if (s->tileview != tileview || s->built) continue;
+        const bool hor = (axis & LV_DIR_HOR) && s->row == row && abs(s->col - col) == 1;
+        const bool ver = (axis & LV_DIR_VER) && s->col == col && abs(s->row - row) == 1;
+        if (hor || ver) ui_screen_build(s);
+    }
+}
+
+static void tileview_event_cb(lv_event_t* e)
+{
+    lv_obj_t* tv = lv_event_get_current_target(e);
+    if (lv_event_get_target(e) != tv) return;     // bubbled up from a tile
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_SCROLL_BEGIN: {
+        // Scrolls started from code build their target beforehand
+        lv_indev_t* indev = lv_indev_active();
+        if (indev) build_neighbours(tv, lv_indev_get_scroll_dir(indev));
+        break;
+    }
+    case LV_EVENT_VALUE_CHANGED: {
+        ui_screen_t* s = find_by_tile(lv_tileview_get_tile_active(tv));
+        ui_screen_build(s);
+        note_active(tv);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint32_t ui_screens_reclaim(uint32_t idle_ms)
+{
+    const int64_t now = esp_timer_get_time();
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < s_count; ++i) {
+        ui_screen_t* s = &s_screens[i];
+        if (!s->built || s->def->resident) continue;
+        if (lv_tileview_get_tile_active(s->tileview) == s->tile) continue;
+        if (now - s->shown_us < (int64_t)idle_ms * 1000) continue;
+        screen_destroy(s);
+        ++n;
+    }
+    return n;
+}
+
+static void reclaim_timer_cb(void* user)
+{
+    (void)user;
+    for (uint32_t i = 0; i < s_count; ++i) note_active(s_screens[i].tileview);
+    const size_t free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (free_internal >= (size_t)CONFIG_UI_SCREEN_RECLAIM_FREE_KB * 1024) return;
+    const uint32_t n = ui_screens_reclaim((uint32_t)CONFIG_UI_SCREEN_IDLE_S * 1000);
+    if (n) {
+        ESP_LOGI(TAG, "Low memory (%u bytes internal): destroyed %lu idle screens", (unsigned)free_internal,
+                 (unsigned long)n);
+    }
+}
+
+ui_screen_t* ui_screens_add(lv_obj_t* tileview, const ui_screen_def_t* def, uint8_t col, uint8_t row,
+                            lv_dir_t dir)
+{
+    if (!tileview || !def || !def->create || s_count == SCREENS_MAX) return NULL;
+    lv_obj_t* tile = lv_tileview_add_tile(tileview, col, row, dir);
+    if (!tile) return NULL;
+
+    bool first_on_tileview = true;
+    for (uint32_t i = 0; i < s_count; ++i) {
+        if (s_screens[i].tileview == tileview) first_on_tileview = false;
+    }
+    if (first_on_tileview) lv_obj_add_event_cb(tileview, tileview_event_cb, LV_EVENT_ALL, NULL);
+#if CONFIG_UI_SCREEN_RECLAIM_FREE_KB > 0
+    if (!s_reclaim_tick) s_reclaim_tick = ui_refresh_every(RECLAIM_PERIOD_S, reclaim_timer_cb, NULL);
+#else
+    (void)reclaim_timer_cb;
+    (void)s_reclaim_tick;
+#endif
+
+    ui_screen_t* s = &s_screens[s_count++];
+    *s = (ui_screen_t){ .def = def, .tileview = tileview, .tile = tile, .col = col, .row = row };
+    s->st.name = def->name;
+    ui_perf_set_name(tile, def->name);
+    return s;
+}
+
+lv_obj_t* ui_screen_tile(const ui_screen_t* s)
+{
+    return s ? s->tile : NULL;
+}
+
+bool ui_screen_is_built(const ui_screen_t* s)
+{
+    return s && s->built;
+}
+
+uint32_t ui_screens_get_stats(ui_screen_stats_t* out, uint32_t max)
+{
+    uint32_t n = s_count < max ? s_count : max;
+    for (uint32_t i = 0; i < n; ++i) {
+        out[i] = s_screens[i].st;
+        out[i].built = s_screens[i].built;
+    }
+    return n;
+}
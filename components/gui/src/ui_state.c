@@ -0,0 +1,251 @@
+#include "ui_state.h"
+#include "ble_sync.h"
+#include "bsp/esp32_s3_touch_amoled_2_06.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "rtc_lib.h"
+#include "sensors.h"
+#include "settings.h"
+#include "ui_refresh.h"
+#include <string.h>
+#include <time.h>
+
+static const char* TAG = "UI_STATE";
+
+#define BATT_POLL_S             60      // charger and USB changes come as events
+#define STATS_WINDOW_S          60
+
+static const char* const k_names[UI_STATE_COUNT] = {
+    [UI_STATE_HOUR] = "hour",
+    [UI_STATE_MINUTE] = "minute",
+    [UI_STATE_SECOND] = "second",
+    [UI_STATE_DAY] = "day",
+    [UI_STATE_MONTH] = "month",
+    [UI_STATE_WEEKDAY] = "weekday",
+    [UI_STATE_STEPS] = "steps",
+    [UI_STATE_ACTIVITY] = "activity",
+    [UI_STATE_BATTERY] = "battery",
+    [UI_STATE_CHARGING] = "charging",
+    [UI_STATE_VBUS] = "vbus",
+    [UI_STATE_BLE_CONNECTED] = "ble_connected",
+    [UI_STATE_BLE_ENABLED] = "ble_enabled",
+    [UI_STATE_SOUND] = "sound",
+    [UI_STATE_STEP_GOAL] = "step_goal",
+    [UI_STATE_BRIGHTNESS] = "brightness",
+    [UI_STATE_DISPLAY_TIMEOUT] = "display_timeout_ms",
+    [UI_STATE_NOTIFY_VOLUME] = "notify_volume",
+};
+
+static lv_subject_t s_subjects[UI_STATE_COUNT];
+
+// Published values; sources write them on their own tasks and the tick
+// applies the dirty ones to the subjects
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static int32_t s_values[UI_STATE_COUNT] = { [UI_STATE_BATTERY] = -1 };
+static uint32_t s_dirty;
+
+static uint32_t s_updates;
+static uint32_t s_pmu_reads;        // also counted on the esp_timer task
+static esp_timer_handle_t s_batt_timer;
+
+typedef struct {
+    uint32_t updates, rtc_reads, pmu_reads;
+} counts_t;
+
+static counts_t s_win_start;
+static int64_t s_win_start_us;
+static ui_state_stats_t s_win[2];
+static uint32_t s_win_idx;
+
+static void publish(ui_state_id_t id, int32_t value)
+{
+    portENTER_CRITICAL(&s_lock);
+    if (s_values[id] != value) {
+        s_values[id] = value;
+        s_dirty |= 1u << id;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static void publish_time(void)
+{
+    struct tm t;
+    if (rtc_get_time(&t) != ESP_OK) return;
+    publish(UI_STATE_HOUR, t.tm_hour);
+    publish(UI_STATE_MINUTE, t.tm_min);
+    publish(UI_STATE_SECOND, t.tm_sec);
+    publish(UI_STATE_DAY, t.tm_mday);
+    publish(UI_STATE_MONTH, t.tm_mon + 1);
+    publish(UI_STATE_WEEKDAY, t.tm_wday);
+}
+
+static void publish_settings(uint32_t fields)
+{
+    if (fields & SETTINGS_F_BRIGHTNESS) publish(UI_STATE_BRIGHTNESS, settings_get_brightness());
+    if (fields & SETTINGS_F_DISPLAY_TIMEOUT) publish(UI_STATE_DISPLAY_TIMEOUT, (int32_t)settings_get_display_timeout());
+    if (fields & SETTINGS_F_SOUND) publish(UI_STATE_SOUND, settings_get_sound());
+    if (fields & SETTINGS_F_BLUETOOTH) publish(UI_STATE_BLE_ENABLED, settings_get_bluetooth_enabled());
+    if (fields & SETTINGS_F_NOTIFY_VOLUME) publish(UI_STATE_NOTIFY_VOLUME, settings_get_notify_volume());
+    if (fields & SETTINGS_F_STEP_GOAL) publish(UI_STATE_STEP_GOAL, (int32_t)settings_get_step_goal());
+}
+
+// Charger and USB state arrive with the power events; only the gauge
+// needs reading now and then
+static void read_pmu(bool all)
+{
+    publish(UI_STATE_BATTERY, bsp_power_get_battery_percent());
+    __atomic_fetch_add(&s_pmu_reads, 1, __ATOMIC_RELAXED);
+    if (all) {
+        publish(UI_STATE_CHARGING, bsp_power_is_charging());
+        publish(UI_STATE_VBUS, bsp_power_is_vbus_in());
+        __atomic_fetch_add(&s_pmu_reads, 2, __ATOMIC_RELAXED);
+    }
+}
+
+static void apply(void)
+{
+    int32_t v[UI_STATE_COUNT];
+    portENTER_CRITICAL(&s_lock);
+    uint32_t dirty = s_dirty;
+    s_dirty = 0;
+    memcpy(v, s_values, sizeof(v));
+    portEXIT_CRITICAL(&s_lock);
+    for (uint32_t i = 0; dirty && i < UI_STATE_COUNT; ++i) {
+        if (!(dirty & (1u << i))) continue;
+        dirty &= ~(1u << i);
+        // lv_subject_set_int() notifies even when the value is the same
+        if (lv_subject_get_int(&s_subjects[i]) == v[i]) continue;
+        lv_subject_set_int(&s_subjects[i], v[i]);
+        s_updates++;
+    }
+}
+
+static void roll_window(int64_t now_us)
+{
+    const counts_t now = {
+        .updates = s_updates,
+        .rtc_reads = rtc_get_chip_reads(),
+        .pmu_reads = __atomic_load_n(&s_pmu_reads, __ATOMIC_RELAXED),
+    };
+    if (s_win_start_us) {
+        ui_state_stats_t* w = &s_win[s_win_idx ^ 1];
+        w->window_ms = (uint32_t)((now_us - s_win_start_us) / 1000);
+        w->updates = now.updates - s_win_start.updates;
+        w->rtc_reads = now.rtc_reads - s_win_start.rtc_reads;
+        w->pmu_reads = now.pmu_reads - s_win_start.pmu_reads;
+        __atomic_store_n(&s_win_idx, s_win_idx ^ 1, __ATOMIC_RELEASE);
+    }
+    s_win_start = now;
+    s_win_start_us = now_us;
+}
+
+static void tick_cb(void* user)
+{
+    (void)user;
+    const int64_t now_us = esp_timer_get_time();
+    publish_time();
+    apply();
+    if ((now_us / 1000000) % STATS_WINDOW_S == 0) roll_window(now_us);
+}
+
+// esp_timer task, display on or off
+static void battery_poll_cb(void* user)
+{
+    (void)user;
+    read_pmu(false);
+}
+
+static void power_evt(void* arg, esp_event_base_t base, int32_t id, void* data)
+{
+    (void)arg;
+    (void)base;
+    (void)id;
+    const bsp_power_event_payload_t* pl = data;
+    if (!pl) return;
+    publish(UI_STATE_BATTERY, pl->battery_percent);
+    publish(UI_STATE_CHARGING, pl->charging);
+    publish(UI_STATE_VBUS, pl->vbus_in);
+}
+
+static void ble_evt(void* arg, esp_event_base_t base, int32_t id, void* data)
+{
+    (void)arg;
+    (void)base;
+    (void)data;
+    publish(UI_STATE_BLE_CONNECTED, id == BLE_SYNC_EVT_CONNECTED);
+}
+
+static void sensors_evt(void* arg, esp_event_base_t base, int32_t id, void* data)
+{
+    (void)arg;
+    (void)base;
+    if (!data) return;
+    if (id == SENSORS_EVT_STEPS) {
+        publish(UI_STATE_STEPS, (int32_t)*(const uint32_t*)data);
+    } else if (id == SENSORS_EVT_ACTIVITY) {
+        publish(UI_STATE_ACTIVITY, *(const sensors_activity_t*)data);
+    }
+}
+
+static void settings_evt(void* arg, esp_event_base_t base, int32_t id, void* data)
+{
+    (void)arg;
+    (void)base;
+    if (id == SETTINGS_EVT_CHANGED && data) publish_settings(*(const uint32_t*)data);
+}
+
+void ui_state_init(void)
+{
+    // Everything once; from here on the sources publish
+    publish_time();
+    publish(UI_STATE_STEPS, (int32_t)sensors_get_step_count());
+    publish(UI_STATE_ACTIVITY, sensors_get_activity());
+    publish_settings(SETTINGS_F_ALL);
+    read_pmu(true);
+    for (uint32_t i = 0; i < UI_STATE_COUNT; ++i) {
+        lv_subject_init_int(&s_subjects[i], s_values[i]);
+    }
+    s_dirty = 0;
+
+    esp_event_handler_register(BSP_POWER_EVENT_BASE, ESP_EVENT_ANY_ID, power_evt, NULL);
+    esp_event_handler_register(BLE_SYNC_EVENT_BASE, ESP_EVENT_ANY_ID, ble_evt, NULL);
+    esp_event_handler_register(SENSORS_EVENT_BASE, ESP_EVENT_ANY_ID, sensors_evt, NULL);
+    esp_event_handler_register(SETTINGS_EVENT_BASE, SETTINGS_EVT_CHANGED, settings_evt, NULL);
+
+    if (!ui_refresh_every(1, tick_cb, NULL)) {
+        ESP_LOGE(TAG, "No tick for the state store");
+    }
+    // Not on the tick: that stops with LVGL while the display is off, and
+    // BLE status replies take the gauge from here
+    const esp_timer_create_args_t batt_args = { .callback = battery_poll_cb, .name = "ui_batt" };
+    if (esp_timer_create(&batt_args, &s_batt_timer) != ESP_OK ||
+        esp_timer_start_periodic(s_batt_timer, (uint64_t)BATT_POLL_S * 1000000) != ESP_OK) {
+        ESP_LOGE(TAG, "No battery poll for the state store");
+    }
+    roll_window(esp_timer_get_time());
+}
+
+lv_subject_t* ui_state_subject(ui_state_id_t id)
+{
+    return &s_subjects[id];
+}
+
+int32_t ui_state_get(ui_state_id_t id)
+{
+    portENTER_CRITICAL(&s_lock);
+    int32_t v = s_values[id];
+    portEXIT_CRITICAL(&s_lock);
+    return v;
+}
+
+const char* ui_state_name(ui_state_id_t id)
+{
+    return id < UI_STATE_COUNT ? k_names[id] : "";
+}
+
+void ui_state_get_stats(ui_state_stats_t* out)
+{
+    *out = s_win[__atomic_load_n(&s_win_idx, __ATOMIC_ACQUIRE)];
+}
@@ -0,0 +1,35 @@
+#include "ui_styles.h"
+
+static lv_style_t s_styles[UI_STYLE_COUNT];
+static bool s_inited[UI_STYLE_COUNT];
+
+static void style_build(ui_style_id_t id, lv_style_t* s)
+{
+    lv_style_init(s);
+    switch (id) {
+    case UI_STYLE_SCREEN:
+        lv_style_set_text_color(s, lv_color_white());
+        lv_style_set_bg_color(s, lv_color_black());
+        lv_style_set_bg_opa(s, LV_OPA_COVER);
+        break;
+    case UI_STYLE_KNOB:
+        lv_style_set_bg_opa(s, LV_OPA_COVER);
+        lv_style_set_bg_color(s, lv_color_hex(0xFFFF10));
+        lv_style_set_border_width(s, 0);
+        lv_style_set_radius(s, LV_RADIUS_CIRCLE);
+        lv_style_set_pad_all(s, 8); // makes the knob larger
+        break;
+    default:
+        break;
+    }
+}
+
+lv_style_t* ui_style_get(ui_style_id_t id)
+{
+    if ((unsigned)id >= UI_STYLE_COUNT) id = UI_STYLE_SCREEN;
+    if (!s_inited[id]) {
+        style_build(id, &s_styles[id]);
+        s_inited[id] = true;
+    }
+    return &s_styles[id];
+}
@@ -0,0 +1,371 @@
+#include "ui_transition.h"
+
+#define FRAMES_MAX      4
+#define SNAP_CF         LV_COLOR_FORMAT_RGB565
+#define STALL_MS        1000    // no scroll event for this long: the SCROLL_END was lost
+
+typedef struct {
+    lv_draw_buf_t buf;
+    lv_obj_t* img;              // on the stage
+    const lv_obj_t* src;        // what the snapshot shows, while staged
+    int32_t x, y;               // tile position in the tileview
+} frame_t;
+
+static frame_t s_frames[FRAMES_MAX];
+static uint32_t s_frame_count;
+static uint32_t s_used;             // frames shown on the stage
+static lv_obj_t* s_stage;
+static lv_obj_t* s_back;            // live screen the stage stands in for; NULL when not staged
+static lv_obj_t* s_tileview;        // tileview being mirrored, NULL for a screen load
+static bool s_end_pending;
+static lv_timer_t* s_stall_timer;
+static uint32_t s_last_scroll;
+static int8_t s_ex, s_ey;           // screen loads: the direction the new screen moves in
+static bool s_move_old;             // screen loads: the old screen moves too (MOVE, not OVER)
+static ui_transition_stats_t s_stats;
+
+size_t ui_transition_frame_size(lv_display_t* disp)
+{
+    if (!disp) return 0;
+    const uint32_t w = lv_display_get_horizontal_resolution(disp);
+    const uint32_t h = lv_display_get_vertical_resolution(disp);
+    // Slack to align the first pixel
+    return (size_t)lv_draw_buf_width_to_stride(w, SNAP_CF) * h + LV_DRAW_BUF_ALIGN;
+}
+
+void ui_transition_init(void* mem, uint32_t count)
+{
+    lv_display_t* disp = lv_display_get_default();
+    const size_t size = ui_transition_frame_size(disp);
+#if !LV_USE_SNAPSHOT
+    count = 0;
+#endif
+    if (!mem || !size) count = 0;
+    if (count > FRAMES_MAX) count = FRAMES_MAX;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t* base = (uint8_t*)mem + i * size;
+        uint8_t* data = lv_draw_buf_align(base, SNAP_CF);
+        const uint32_t w = lv_display_get_horizontal_resolution(disp);
+        lv_draw_buf_init(&s_frames[i].buf, w, lv_display_get_vertical_resolution(disp), SNAP_CF,
+                         lv_draw_buf_width_to_stride(w, SNAP_CF), data, (uint32_t)(size - (size_t)(data - base)));
+    }
+    s_frame_count = count;
+}
+
+static lv_obj_t* stage_get(void)
+{
+    if (s_stage) return s_stage;
+    s_stage = lv_obj_create(NULL);
+    lv_obj_remove_style_all(s_stage);
+    lv_obj_set_style_bg_color(s_stage, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(s_stage, LV_OPA_COVER, 0);
+    lv_obj_remove_flag(s_stage, LV_OBJ_FLAG_SCROLLABLE);
+    for (uint32_t i = 0; i < s_frame_count; ++i) {
+        s_frames[i].img = lv_image_create(s_stage);
+        lv_obj_add_flag(s_frames[i].img, LV_OBJ_FLAG_HIDDEN);
+    }
+    return s_stage;
+}
+
+static bool capture(uint32_t i, lv_obj_t* obj)
+{
+#if LV_USE_SNAPSHOT
+    frame_t* f = &s_frames[i];
+    // Fails when obj is larger than the display (a frame)
+    if (lv_snapshot_take_to_draw_buf(obj, SNAP_CF, &f->buf) != LV_RESULT_OK) return false;
+    lv_image_cache_drop(&f->buf);
+    lv_image_set_src(f->img, &f->buf);
+    f->src = obj;
+    s_stats.snapshots++;
+    return true;
+#else
+    (void)i;
+    (void)obj;
+    return false;
+#endif
+}
+
+static void capture_done(uint32_t t0)
+{
+    const uint32_t ms = lv_tick_elaps(t0);
+    if (ms > s_stats.capture_ms_max) s_stats.capture_ms_max = ms;
+}
+
+static void stage_show(lv_obj_t* back, lv_obj_t* tileview)
+{
+    for (uint32_t i = 0; i < s_frame_count; ++i) {
+        if (i < s_used) {
+            lv_obj_remove_flag(s_frames[i].img, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(s_frames[i].img, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    if (s_back) return;
+    s_back = back;
+    s_tileview = tileview;
+    s_stats.transitions++;
+    lv_screen_load(s_stage);
+}
+
+static void end_async(void* arg);
+static void load_anim_cb(void* var, int32_t p);
+
+static void stage_end(void)
+{
+    if (s_end_pending) {
+        lv_async_call_cancel(end_async, NULL);
+        s_end_pending = false;
+    }
+    if (!s_back) return;
+    lv_obj_t* back = s_back;
+    s_back = NULL;
+    s_tileview = NULL;
+    lv_anim_delete(s_stage, load_anim_cb);
+    if (s_stall_timer) lv_timer_pause(s_stall_timer);
+    for (uint32_t i = 0; i < s_used; ++i) {
+        lv_obj_add_flag(s_frames[i].img, LV_OBJ_FLAG_HIDDEN);
+        s_frames[i].src = NULL;
+    }
+    s_used = 0;
+    if (lv_screen_active() == s_stage) lv_screen_load(back);
+}
+
+static void end_async(void* arg)
+{
+    (void)arg;
+    s_end_pending = false;
+    stage_end();
+}
+
+// --- Screen loads --------------------------------------------------------
+
+static void load_anim_cb(void* var, int32_t p)
+{
+    (void)var;
+    const int32_t w = lv_obj_get_width(s_stage), h = lv_obj_get_height(s_stage);
+    if (s_move_old) lv_obj_set_pos(s_frames[0].img, s_ex * w * p / 1024, s_ey * h * p / 1024);
+    lv_obj_set_pos(s_frames[1].img, -s_ex * w * (1024 - p) / 1024, -s_ey * h * (1024 - p) / 1024);
+}
+
+static void load_anim_done(lv_anim_t* a)
+{
+    (void)a;
+    stage_end();
+}
+
+bool ui_transition_load_screen(lv_obj_t* screen, lv_screen_load_anim_t anim, uint32_t time_ms)
+{
+    int8_t ex = 0, ey = 0;
+    bool move = true;
+    switch (anim) {
+    case LV_SCR_LOAD_ANIM_OVER_LEFT:   move = false; /* fall through */
+    case LV_SCR_LOAD_ANIM_MOVE_LEFT:   ex = -1; break;
+    case LV_SCR_LOAD_ANIM_OVER_RIGHT:  move = false; /* fall through */
+    case LV_SCR_LOAD_ANIM_MOVE_RIGHT:  ex = 1; break;
+    case LV_SCR_LOAD_ANIM_OVER_TOP:    move = false; /* fall through */
+    case LV_SCR_LOAD_ANIM_MOVE_TOP:    ey = -1; break;
+    case LV_SCR_LOAD_ANIM_OVER_BOTTOM: move = false; /* fall through */
+    case LV_SCR_LOAD_ANIM_MOVE_BOTTOM: ey = 1; break;
+    default:
+        return false;
+    }
+    if (s_frame_count < 2 || !screen) return false;
+
+    stage_end();
+    lv_obj_t* from = lv_screen_active();
+    if (!from || from == screen) return false;
+
+    const uint32_t t0 = lv_tick_get();
+    lv_obj_update_layout(screen);
+    lv_obj_t* stage = stage_get();
+    if (!capture(0, from) || !capture(1, screen)) {
+        s_stats.live++;
+        return false;
+    }
+    capture_done(t0);
+
+    s_ex = ex;
+    s_ey = ey;
+    s_move_old = move;
+    s_used = 2;
+    lv_obj_set_pos(s_frames[0].img, 0, 0);
+    load_anim_cb(NULL, 0);
+    stage_show(screen, NULL);
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, stage);
+    lv_anim_set_exec_cb(&a, load_anim_cb);
+    lv_anim_set_values(&a, 0, 1024);
+    lv_anim_set_duration(&a, time_ms);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_set_completed_cb(&a, load_anim_done);
+    lv_anim_start(&a);
+    return true;
+}
+
+// --- Tileview scrolls ----------------------------------------------------
+
+static lv_obj_t* tile_at(lv_obj_t* tv, int32_t col, int32_t row, int32_t w, int32_t h)
+{
+    if (col < 0 || row < 0) return NULL;
+    const uint32_t n = lv_obj_get_child_count(tv);
+    for (uint32_t i = 0; i < n; ++i) {
+        lv_obj_t* t = lv_obj_get_child(tv, (int32_t)i);
+        if (lv_obj_get_x(t) == col * w && lv_obj_get_y(t) == row * h) {
+            return lv_obj_has_flag(t, LV_OBJ_FLAG_HIDDEN) ? NULL : t;
+        }
+    }
+    return NULL;
+}
+
+static void mirror_scroll(void)
+{
+    lv_area_t a;
+    lv_obj_get_coords(s_tileview, &a);
+    const int32_t sx = lv_obj_get_scroll_x(s_tileview), sy = lv_obj_get_scroll_y(s_tileview);
+    for (uint32_t i = 0; i < s_used; ++i) {
+        lv_obj_set_pos(s_frames[i].img, a.x1 + s_frames[i].x - sx, a.y1 + s_frames[i].y - sy);
+    }
+    s_last_scroll = lv_tick_get();
+}
+
+static int32_t step_toward(int32_t from, int32_t to)
+{
+    return from < to ? 1 : (from > to ? -1 : 0);
+}
+
+// Tiles the scroll that starts can show, in the order they are needed:
+// the one in view, then the one a drag heads to and the one behind it,
+// or every tile on the way to lv_tileview_set_tile()'s target. Returns
+// how many there are, and in `need` how many must be captured; -1 when
+// they don't fit the frames.
+static int32_t tiles_for_scroll(lv_obj_t* tv, lv_obj_t** out, uint32_t* need)
+{
+    const int32_t w = lv_obj_get_content_width(tv), h = lv_obj_get_content_height(tv);
+    if (w <= 0 || h <= 0) return -1;
+    const int32_t c0 = (lv_obj_get_scroll_x(tv) + w / 2) / w;
+    const int32_t r0 = (lv_obj_get_scroll_y(tv) + h / 2) / h;
+    lv_obj_t* cur = tile_at(tv, c0, r0, w, h);
+    if (!cur) return -1;
+
+    uint32_t n = 0;
+    out[n++] = cur;
+    lv_indev_t* indev = lv_indev_active();
+    if (indev && lv_indev_get_scroll_obj(indev) == tv) {
+        lv_point_t v;
+        lv_indev_get_vect(indev, &v);
+        // The finger moves opposite to the content it reveals
+        const bool hor = lv_indev_get_scroll_dir(indev) & LV_DIR_HOR;
+        const int32_t fwd = hor ? (v.x < 0 ? 1 : -1) : (v.y < 0 ? 1 : -1);
+        lv_obj_t* ahead = hor ? tile_at(tv, c0 + fwd, r0, w, h) : tile_at(tv, c0, r0 + fwd, w, h);
+        lv_obj_t* behind = hor ? tile_at(tv, c0 - fwd, r0, w, h) : tile_at(tv, c0, r0 - fwd, w, h);
+        if (ahead) out[n++] = ahead;
+        if (n > s_frame_count) return -1;
+        *need = n;
+        if (behind && n < s_frame_count) out[n++] = behind;
+        return (int32_t)n;
+    }
+
+    lv_obj_t* target = lv_tileview_get_tile_active(tv);
+    if (!target || target == cur) return -1;
+    const int32_t ct = lv_obj_get_x(target) / w, rt = lv_obj_get_y(target) / h;
+    for (int32_t c = c0, r = r0; c != ct || r != rt;) {
+        c += step_toward(c, ct);
+        r += step_toward(r, rt);
+        lv_obj_t* t = tile_at(tv, c, r, w, h);
+        if (!t) continue;
+        if (n == s_frame_count) return -1;
+        out[n++] = t;
+    }
+    *need = n;
+    return (int32_t)n;
+}
+
+static void stall_timer_cb(lv_timer_t* t)
+{
+    (void)t;
+    if (s_tileview && lv_tick_elaps(s_last_scroll) >= STALL_MS) stage_end();
+}
+
+static void on_scroll_begin(lv_obj_t* tv)
+{
+    const bool reuse = s_end_pending && s_tileview == tv;
+    if (s_end_pending) {
+        lv_async_call_cancel(end_async, NULL);
+        s_end_pending = false;
+    }
+    lv_obj_t* act = lv_screen_active();
+    const bool staged = s_tileview == tv && act == s_stage;
+    if (!staged && act != lv_obj_get_screen(tv)) return;
+
+    lv_obj_update_layout(tv);
+    lv_obj_t* tiles[FRAMES_MAX + 1];
+    uint32_t need = 0;
+    const int32_t n = tiles_for_scroll(tv, tiles, &need);
+    if (n < 0) {
+        if (staged) stage_end();
+        s_stats.live++;
+        return;
+    }
+
+    // An animated lv_tileview_set_tile() right after another one ends the
+    // first scroll and starts a new one at once: keep what is on the stage
+    bool held = reuse && (uint32_t)n == s_used;
+    for (int32_t i = 0; held && i < n; ++i) held = s_frames[i].src == tiles[i];
+    if (!held) {
+        const uint32_t t0 = lv_tick_get();
+        stage_get();
+        uint32_t got = 0;
+        while (got < (uint32_t)n && capture(got, tiles[got])) {
+            s_frames[got].x = lv_obj_get_x(tiles[got]);
+            s_frames[got].y = lv_obj_get_y(tiles[got]);
+            ++got;
+        }
+        capture_done(t0);
+        if (got < need) {
+            if (staged) stage_end();
+            s_stats.live++;
+            return;
+        }
+        s_used = got;
+    }
+
+    if (!s_stall_timer) s_stall_timer = lv_timer_create(stall_timer_cb, STALL_MS / 2, NULL);
+    lv_timer_resume(s_stall_timer);
+    stage_show(lv_obj_get_screen(tv), tv);
+    mirror_scroll();
+}
+
+static void tileview_event_cb(lv_event_t* e)
+{
+    lv_obj_t* tv = lv_event_get_current_target(e);
+    if (lv_event_get_target(e) != tv || s_frame_count == 0) return;
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_SCROLL_BEGIN:
+        on_scroll_begin(tv);
+        break;
+    case LV_EVENT_SCROLL:
+        if (s_tileview == tv) mirror_scroll();
+        break;
+    case LV_EVENT_SCROLL_END:
+        // Deferred, in case another scroll starts right away
+        if (s_tileview == tv && !s_end_pending) {
+            s_end_pending = lv_async_call(end_async, NULL) == LV_RESULT_OK;
+            if (!s_end_pending) stage_end();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void ui_transition_attach_tileview(lv_obj_t* tileview)
+{
+    lv_obj_add_event_cb(tileview, tileview_event_cb, LV_EVENT_ALL, NULL);
+}
+
+void ui_transition_get_stats(ui_transition_stats_t* out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,375 @@
+#include "ui_vlist.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "VLIST";
+
+#define VLIST_POLL_MS     30    // how often measured heights are picked up
+#define VLIST_TASK_STACK  4096
+#define VLIST_TASK_PRIO   2
+
+struct ui_vlist {
+    ui_vlist_cfg_t cfg;
+    lv_obj_t* obj;
+    lv_obj_t* spacer;           // its bottom edge sets the scroll height
+    lv_obj_t** cards;           // item i lives on cards[i % pool]
+    int32_t* card_idx;          // item on each card, -1 = none
+    int32_t* card_y;
+    int32_t* card_h;
+    int32_t* offsets;           // top of each item, count + 1 entries
+    lv_timer_t* timer;
+    TaskHandle_t task;
+
+    // Shared with the measuring task, under `lock`
+    SemaphoreHandle_t lock;
+    int16_t* heights;           // 0 = not measured yet
+    uint32_t count;
+    uint32_t cap;
+    uint32_t gen;               // bumped whenever indices move
+    int32_t width;
+    bool quit;
+    volatile uint32_t focus;    // first visible item, measured first
+    volatile bool dirty;        // heights landed since the last layout
+};
+
+static void list_free(ui_vlist_t* vl)
+{
+    free(vl->cards);
+    free(vl->card_idx);
+    free(vl->card_y);
+    free(vl->card_h);
+    free(vl->offsets);
+    free(vl->heights);
+    if (vl->lock) vSemaphoreDelete(vl->lock);
+    free(vl);
+}
+
+// First unmeasured item at or after the focus, else before it
+static bool next_unmeasured(const ui_vlist_t* vl, uint32_t* out)
+{
+    uint32_t start = vl->focus < vl->count ? vl->focus : 0;
+    for (uint32_t n = 0; n < vl->count; ++n) {
+        uint32_t i = (start + n) % vl->count;
+        if (vl->heights[i] == 0) {
+            *out = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void measure_task(void* arg)
+{
+    ui_vlist_t* vl = arg;
+    for (;;) {
+        xSemaphoreTake(vl->lock, portMAX_DELAY);
+        if (vl->quit) {
+            xSemaphoreGive(vl->lock);
+            break;
+        }
+        uint32_t idx;
+        if (vl->width <= 0 || !next_unmeasured(vl, &idx)) {
+            xSemaphoreGive(vl->lock);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        uint32_t gen = vl->gen;
+        int32_t width = vl->width;
+        xSemaphoreGive(vl->lock);
+
+        int32_t h = vl->cfg.measure(idx, width, vl->cfg.ctx);
+        if (h <= 0) h = vl->cfg.est_height;
+        if (h > INT16_MAX) h = INT16_MAX;
+
+        xSemaphoreTake(vl->lock, portMAX_DELAY);
+        // Indices moved while measuring: drop it, the item comes round again
+        if (gen == vl->gen && idx < vl->count) {
+            vl->heights[idx] = (int16_t)h;
+            vl->dirty = true;
+        }
+        xSemaphoreGive(vl->lock);
+    }
+    list_free(vl);
+    vTaskDelete(NULL);
+}
+
+static void wake_task(ui_vlist_t* vl)
+{
+    if (vl->task) xTaskNotifyGive(vl->task);
+}
+
+// Caller holds the lock
+static bool ensure_cap(ui_vlist_t* vl, uint32_t count)
+{
+    if (count <= vl->cap) return true;
+    uint32_t cap = vl->cap ? vl->cap : 64;
+    while (cap < count) cap *= 2;
+    int16_t* h = realloc(vl->heights, cap * sizeof(*h));
+    if (!h) return false;
+    vl->heights = h;
+    int32_t* o = realloc(vl->offsets, (cap + 1) * sizeof(*o));
+    if (!o) return false;
+    vl->offsets = o;
+    vl->cap = cap;
+    return true;
+}
+
+static int32_t first_visible(const ui_vlist_t* vl, int32_t y)
+{
+    // Last item whose top is at or above y
+    uint32_t lo = 0, hi = vl->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (vl->offsets[mid + 1] <= y) lo = mid + 1;
+        else hi = mid;
+    }
+    return (int32_t)lo;
+}
+
+static void layout_cards(ui_vlist_t* vl)
+{
+    const uint32_t pool = vl->cfg.pool;
+    int32_t first = first_visible(vl, lv_obj_get_scroll_y(vl->obj)) - 1;  // one spare above
+    if (first < 0) first = 0;
+    vl->focus = (uint32_t)first;
+
+    for (uint32_t k = 0; k < pool; ++k) {
+        uint32_t idx = (uint32_t)first + k;
+        uint32_t slot = idx % pool;
+        lv_obj_t* card = vl->cards[slot];
+        if (idx >= vl->count) {
+            lv_obj_add_flag(card, LV_OBJ_FLAG_HIDDEN);
+            vl->card_idx[slot] = -1;
+            continue;
+        }
+        int32_t y = vl->offsets[idx];
+        int32_t h = vl->offsets[idx + 1] - y - vl->cfg.gap;
+        if (vl->card_idx[slot] != (int32_t)idx) {
+            vl->card_idx[slot] = (int32_t)idx;
+            vl->cfg.bind(card, idx, vl->cfg.ctx);
+            lv_obj_remove_flag(card, LV_OBJ_FLAG_HIDDEN);
+        }
+        if (vl->card_y[slot] != y) {
+            lv_obj_set_y(card, y);
+            vl->card_y[slot] = y;
+        }
+        if (vl->card_h[slot] != h) {
+            lv_obj_set_height(card, h);
+            vl->card_h[slot] = h;
+        }
+    }
+}
+
+// Rebuild the offsets from the heights. With `keep_anchor` (the count is
+// unchanged) the item at the top of the viewport stays where it is when
+// items above it change height.
+static void relayout(ui_vlist_t* vl, bool keep_anchor)
+{
+    int32_t scroll_y = lv_obj_get_scroll_y(vl->obj);
+    int32_t anchor = keep_anchor && vl->count ? first_visible(vl, scroll_y) : 0;
+    int32_t anchor_delta = anchor ? scroll_y - vl->offsets[anchor] : 0;
+
+    xSemaphoreTake(vl->lock, portMAX_DELAY);
+    vl->dirty = false;
+    int32_t y = 0;
+    for (uint32_t i = 0; i < vl->count; ++i) {
+        vl->offsets[i] = y;
+        y += (vl->heights[i] ? vl->heights[i] : vl->cfg.est_height) + vl->cfg.gap;
+    }
+    vl->offsets[vl->count] = y;
+    xSemaphoreGive(vl->lock);
+
+    lv_obj_set_y(vl->spacer, y > 0 ? y - 1 : 0);
+    if (anchor > 0 && (uint32_t)anchor < vl->count && vl->offsets[anchor] + anchor_delta != scroll_y) {
+        lv_obj_scroll_to_y(vl->obj, vl->offsets[anchor] + anchor_delta, LV_ANIM_OFF);
+    }
+    layout_cards(vl);
+}
+
+static void forget_cards(ui_vlist_t* vl)
+{
+    for (uint32_t k = 0; k < vl->cfg.pool; ++k) vl->card_idx[k] = -1;
+}
+
+static void poll_cb(lv_timer_t* t)
+{
+    ui_vlist_t* vl = lv_timer_get_user_data(t);
+    if (vl->dirty) relayout(vl, true);
+}
+
+static void obj_event_cb(lv_event_t* e)
+{
+    ui_vlist_t* vl = lv_event_get_user_data(e);
+    switch (lv_event_get_code(e)) {
+    case LV_EVENT_SCROLL:
+        layout_cards(vl);
+        // The measuring task starts over from the new focus
+        wake_task(vl);
+        break;
+    case LV_EVENT_SIZE_CHANGED: {
+        int32_t w = lv_obj_get_content_width(vl->obj);
+        xSemaphoreTake(vl->lock, portMAX_DELAY);
+        bool changed = w != vl->width;
+        if (changed) {
+            vl->width = w;
+            memset(vl->heights, 0, vl->count * sizeof(vl->heights[0]));
+            vl->gen++;
+        }
+        xSemaphoreGive(vl->lock);
+        if (changed) {
+            relayout(vl, false);
+            wake_task(vl);
+        }
+        break;
+    }
+    case LV_EVENT_DELETE:
+        lv_timer_delete(vl->timer);
+        xSemaphoreTake(vl->lock, portMAX_DELAY);
+        vl->quit = true;
+        xSemaphoreGive(vl->lock);
+        if (vl->task) wake_task(vl);
+        else list_free(vl);
+        break;
+    default:
+        break;
+    }
+}
+
+ui_vlist_t* ui_vlist_create(lv_obj_t* parent, const ui_vlist_cfg_t* cfg)
+{
+    if (!cfg || !cfg->create_card || !cfg->bind || !cfg->measure || !cfg->pool || cfg->est_height <= 0) return NULL;
+    ui_vlist_t* vl = calloc(1, sizeof(*vl));
+    if (!vl) return NULL;
+    vl->cfg = *cfg;
+    vl->lock = xSemaphoreCreateMutex();
+    vl->cards = calloc(cfg->pool, sizeof(*vl->cards));
+    vl->card_idx = calloc(cfg->pool, sizeof(*vl->card_idx));
+    vl->card_y = calloc(cfg->pool, sizeof(*vl->card_y));
+    vl->card_h = calloc(cfg->pool, sizeof(*vl->card_h));
+    if (!vl->lock || !vl->cards || !vl->card_idx || !vl->card_y || !vl->card_h || !ensure_cap(vl, 1)) {
+        list_free(vl);
+        return NULL;
+    }
+    vl->offsets[0] = 0;
+
+    vl->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(vl->obj);
+    lv_obj_set_size(vl->obj, lv_pct(100), lv_pct(100));
+    lv_obj_set_scroll_dir(vl->obj, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(vl->obj, LV_SCROLLBAR_MODE_OFF);
+
+    vl->spacer = lv_obj_create(vl->obj);
+    lv_obj_remove_style_all(vl->spacer);
+    lv_obj_set_size(vl->spacer, 1, 1);
+
+    for (uint32_t k = 0; k < cfg->pool; ++k) {
+        lv_obj_t* card = cfg->create_card(vl->obj, cfg->ctx);
+        lv_obj_set_width(card, lv_pct(100));
+        lv_obj_add_flag(card, LV_OBJ_FLAG_HIDDEN);
+        vl->cards[k] = card;
+        vl->card_idx[k] = -1;
+        vl->card_y[k] = -1;
+        vl->card_h[k] = -1;
+    }
+
+    lv_obj_add_event_cb(vl->obj, obj_event_cb, LV_EVENT_ALL, vl);
+    vl->timer = lv_timer_create(poll_cb, VLIST_POLL_MS, vl);
+    if (xTaskCreate(measure_task, "vlist_measure", VLIST_TASK_STACK, vl, VLIST_TASK_PRIO, &vl->task) != pdPASS) {
+        // Items keep their estimated height
+        ESP_LOGW(TAG, "No measuring task, items keep est_height");
+        vl->task = NULL;
+    }
+    return vl;
+}
+
+lv_obj_t* ui_vlist_get_obj(ui_vlist_t* vl)
+{
+    return vl ? vl->obj : NULL;
+}
+
+void ui_vlist_set_count(ui_vlist_t* vl, uint32_t count)
+{
+    if (!vl) return;
+    xSemaphoreTake(vl->lock, portMAX_DELAY);
+    if (!ensure_cap(vl, count)) {
+        ESP_LOGE(TAG, "No memory for %lu items", (unsigned long)count);
+        count = vl->count < vl->cap ? vl->count : vl->cap;
+    }
+    vl->count = count;
+    memset(vl->heights, 0, count * sizeof(vl->heights[0]));
+    vl->gen++;
+    xSemaphoreGive(vl->lock);
+    forget_cards(vl);
+    relayout(vl, false);
+    wake_task(vl);
+}
+
+uint32_t ui_vlist_get_count(const ui_vlist_t* vl)
+{
+    return vl ? vl->count : 0;
+}
+
+void ui_vlist_insert(ui_vlist_t* vl, uint32_t index)
+{
+    if (!vl) return;
+    xSemaphoreTake(vl->lock, portMAX_DELAY);
+    bool ok = index <= vl->count && ensure_cap(vl, vl->count + 1);
+    if (ok) {
+        memmove(&vl->heights[index + 1], &vl->heights[index], (vl->count - index) * sizeof(vl->heights[0]));
+        vl->heights[index] = 0;
+        vl->count++;
+        vl->gen++;
+    }
+    xSemaphoreGive(vl->lock);
+    if (!ok) return;
+    forget_cards(vl);
+    relayout(vl, false);
+    wake_task(vl);
+}
+
+void ui_vlist_remove(ui_vlist_t* vl, uint32_t index)
+{
+    if (!vl) return;
+    xSemaphoreTake(vl->lock, portMAX_DELAY);
+    bool ok = index < vl->count;
+    if (ok) {
+        memmove(&vl->heights[index], &vl->heights[index + 1], (vl->count - index - 1) * sizeof(vl->heights[0]));
+        vl->count--;
+        vl->gen++;
+    }
+    xSemaphoreGive(vl->lock);
+    if (!ok) return;
+    forget_cards(vl);
+    relayout(vl, false);
+}
+
+void ui_vlist_refresh(ui_vlist_t* vl, uint32_t index)
+{
+    if (!vl || index >= vl->count) return;
+    int32_t h = vl->cfg.measure(index, vl->width, vl->cfg.ctx);
+    if (h <= 0) h = vl->cfg.est_height;
+    xSemaphoreTake(vl->lock, portMAX_DELAY);
+    vl->heights[index] = (int16_t)(h > INT16_MAX ? INT16_MAX : h);
+    xSemaphoreGive(vl->lock);
+    vl->card_idx[index % vl->cfg.pool] = -1;
+    relayout(vl, true);
+}
+
+int32_t ui_vlist_card_index(const ui_vlist_t* vl, const lv_obj_t* card)
+{
+    if (!vl) return -1;
+    for (uint32_t k = 0; k < vl->cfg.pool; ++k) {
+        if (vl->cards[k] == card) return vl->card_idx[k];
+    }
+    return -1;
+}
+
+void ui_vlist_scroll_to(ui_vlist_t* vl, uint32_t index, lv_anim_enable_t anim)
+{
+    if (!vl || index >= vl->count) return;
+    lv_obj_scroll_to_y(vl->obj, vl->offsets[index], anim);
+}
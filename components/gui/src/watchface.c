@@ -1,12 +1,15 @@
 #include "watchface.h"
 #include "sensors.h"
 #include "ui_fonts.h"
+#include "ui_images.h"
 #include "rtc_lib.h"
 #include "esp_check.h"
 #include "esp_err.h"
 #include "esp_log.h"
 
 #include "ui.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
 #include "steps_screen.h"
 #include "settings_screen.h"
 #include "notifications.h"
@@ -22,7 +25,6 @@ static lv_obj_t* img_battery;
 static lv_obj_t* lbl_batt_pct;
 static lv_obj_t* lbl_charge_icon;
 static lv_obj_t* img_ble;
-static lv_timer_t* s_timer = NULL;
 
 
 //static lv_style_t main_style;
@@ -30,28 +32,56 @@ static lv_timer_t* s_timer = NULL;
 
 static void screen_events(lv_event_t* e);
 
-static void update_time_task(lv_timer_t* timer)
+static void date_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
 {
-    (void)timer;
-    bsp_display_lock(0);
-    //if (active_screen_get() == watchface_screen) {
-        if (label_hour) {
-            lv_label_set_text_fmt(label_hour, "%02d", rtc_get_hour());
-        }
-        if (label_minute) {
-            lv_label_set_text_fmt(label_minute, "%02d", rtc_get_minute());
-        }
-        if (label_second) {
-            lv_label_set_text_fmt(label_second, "%02d", rtc_get_second());
-        }
-        if (label_date) {
-            lv_label_set_text_fmt(label_date, "%02d/%02d", rtc_get_day(), rtc_get_month());
-        }
-        if (label_weekday) {
-            lv_label_set_text(label_weekday, rtc_get_weekday_short_string());
-        }
-    //}
-    bsp_display_unlock();
+    LV_UNUSED(subject);
+    ui_refresh_label_fmt(lv_observer_get_target_obj(observer), "%02d/%02d",
+                         (int)lv_subject_get_int(ui_state_subject(UI_STATE_DAY)),
+                         (int)lv_subject_get_int(ui_state_subject(UI_STATE_MONTH)));
+}
+
+static void weekday_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
+{
+    lv_label_set_text(lv_observer_get_target_obj(observer), rtc_weekday_short_name(lv_subject_get_int(subject)));
+}
+
+// Battery icon colour, percent and lightning from the three power values
+static void power_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
+{
+    LV_UNUSED(observer);
+    LV_UNUSED(subject);
+    const int battery_percent = lv_subject_get_int(ui_state_subject(UI_STATE_BATTERY));
+    const bool charging = lv_subject_get_int(ui_state_subject(UI_STATE_CHARGING));
+    const bool vbus_in = lv_subject_get_int(ui_state_subject(UI_STATE_VBUS));
+
+    lv_color_t col = lv_color_hex(0x909090); // default: grey
+    if (vbus_in) {
+        col = lv_color_hex(0x00BFFF); // USB plugged: blue
+    }
+    if (charging) {
+        col = lv_color_hex(0x00FF00); // Charging: green
+    }
+    lv_obj_set_style_img_recolor(img_battery, col, 0);
+    // Update percent text
+    if (battery_percent >= 0 && battery_percent <= 100) {
+        ui_refresh_label_fmt(lbl_batt_pct, "%d%%", battery_percent);
+    }
+    else {
+        ui_refresh_label_fmt(lbl_batt_pct, "--%%");
+    }
+    // Toggle lightning overlay: show if VBUS present or charging
+    if (vbus_in || charging) {
+        lv_obj_clear_flag(lbl_charge_icon, LV_OBJ_FLAG_HIDDEN);
+    }
+    else {
+        lv_obj_add_flag(lbl_charge_icon, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+static void ble_observer_cb(lv_observer_t* observer, lv_subject_t* subject)
+{
+    lv_color_t col = lv_subject_get_int(subject) ? lv_color_hex(0x3B82F6) /* blue */ : lv_color_hex(0x606060) /* grey */;
+    lv_obj_set_style_img_recolor(lv_observer_get_target_obj(observer), col, 0);
 }
 
 void watchface_create(lv_obj_t* parent) {
@@ -75,9 +105,8 @@ void watchface_create(lv_obj_t* parent) {
     lv_obj_remove_flag(watchface_screen, LV_OBJ_FLAG_SCROLLABLE);
     
 
-    LV_IMAGE_DECLARE(background_wf_2);
     lv_obj_t* image = lv_image_create(watchface_screen);
-    lv_image_set_src(image, &background_wf_2);
+    lv_image_set_src(image, assets_image("background_wf"));
     lv_obj_set_align(image, LV_ALIGN_CENTER);
 
     label_hour = lv_label_create(watchface_screen);
@@ -124,9 +153,8 @@ void watchface_create(lv_obj_t* parent) {
     lv_obj_set_style_text_color(label_weekday, lv_color_hex(0xc0c0c0), LV_PART_MAIN | LV_STATE_DEFAULT);
 
     // Battery icon on top-left
-    extern const lv_image_dsc_t image_battery_icon;
     img_battery = lv_image_create(watchface_screen);
-    lv_image_set_src(img_battery, &image_battery_icon);
+    lv_image_set_src(img_battery, assets_image("image_battery_icon"));
     lv_obj_set_align(img_battery, LV_ALIGN_TOP_MID);
     lv_obj_set_x(img_battery, -100);
     //lv_obj_set_pos(img_battery, 8, 8);
@@ -156,9 +184,8 @@ void watchface_create(lv_obj_t* parent) {
     lv_obj_add_flag(lbl_charge_icon, LV_OBJ_FLAG_HIDDEN);
 
     // BLE status icon on top-right
-    extern const lv_image_dsc_t image_bluetooth_icon;
     img_ble = lv_image_create(watchface_screen);
-    lv_image_set_src(img_ble, &image_bluetooth_icon);
+    lv_image_set_src(img_ble, assets_image("image_bluetooth_icon"));
     lv_obj_set_align(img_ble, LV_ALIGN_TOP_MID);
     lv_obj_set_x(img_ble, 100);
     //lv_obj_set_align(img_ble, LV_ALIGN_TOP_RIGHT);
@@ -167,8 +194,17 @@ void watchface_create(lv_obj_t* parent) {
     // Default to disconnected (grey)
     lv_obj_set_style_img_recolor(img_ble, lv_color_hex(0x606060), 0);
 
-    s_timer = lv_timer_create(update_time_task, 1000, NULL);
-    lv_timer_ready(s_timer);
+    // Each label redraws only when its own value changes
+    lv_label_bind_text(label_hour, ui_state_subject(UI_STATE_HOUR), "%02d");
+    lv_label_bind_text(label_minute, ui_state_subject(UI_STATE_MINUTE), "%02d");
+    lv_label_bind_text(label_second, ui_state_subject(UI_STATE_SECOND), "%02d");
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_DAY), date_observer_cb, label_date, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_MONTH), date_observer_cb, label_date, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_WEEKDAY), weekday_observer_cb, label_weekday, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_BATTERY), power_observer_cb, img_battery, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_CHARGING), power_observer_cb, img_battery, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_VBUS), power_observer_cb, img_battery, NULL);
+    lv_subject_add_observer_obj(ui_state_subject(UI_STATE_BLE_CONNECTED), ble_observer_cb, img_ble, NULL);
 
     //lv_obj_add_event_cb(watchface_screen, screen_events, LV_EVENT_ALL, NULL);
     //lv_obj_clear_flag(watchface_screen, LV_OBJ_FLAG_GESTURE_BUBBLE);
@@ -207,45 +243,3 @@ lv_obj_t* watchface_screen_get(void)
     }
     return watchface_screen;
 }
-
-void watchface_set_power_state(bool vbus_in, bool charging, int battery_percent)
-{
-    (void)battery_percent; // future: render %, or change icon fill
-    if (!img_battery) return;
-    lv_color_t col = lv_color_hex(0x909090); // default: grey
-    if (vbus_in) {
-        col = lv_color_hex(0x00BFFF); // USB plugged: blue
-    }
-    if (charging) {
-        col = lv_color_hex(0x00FF00); // Charging: green
-    }
-    lv_obj_set_style_img_recolor(img_battery, col, 0);
-    // Update percent text
-    if (lbl_batt_pct) {
-        if (battery_percent >= 0 && battery_percent <= 100) {
-            static char buf[8];
-            lv_snprintf(buf, sizeof(buf), "%d%%", battery_percent);
-            lv_label_set_text(lbl_batt_pct, buf);
-        }
-        else {
-            lv_label_set_text(lbl_batt_pct, "--%");
-        }
-    }
-    // Toggle lightning overlay: show if VBUS present or charging
-    if (lbl_charge_icon) {
-        if (vbus_in || charging) {
-            lv_obj_clear_flag(lbl_charge_icon, LV_OBJ_FLAG_HIDDEN);
-        }
-        else {
-            lv_obj_add_flag(lbl_charge_icon, LV_OBJ_FLAG_HIDDEN);
-        }
-    }
-}
-
-void watchface_set_ble_connected(bool connected)
-{
-    if (!img_ble) return;
-    lv_color_t col = connected ? lv_color_hex(0x3B82F6) /* blue */ : lv_color_hex(0x606060) /* grey */;
-    lv_obj_set_style_img_recolor(img_ble, col, 0);
-}
-
@@ -13,18 +13,77 @@
 extern "C" {
 #endif
 
-// Handle for the Nordic UART RX ring buffer
-extern RingbufHandle_t nordic_uart_rx_buf_handle;
+// Handles for the Nordic UART RX ring buffers (one per lane). Prefer
+// nordic_uart_rx_receive, which drains the control lane first.
+extern RingbufHandle_t nordic_uart_rx_buf_handle;      // bulk lane (notifications, everything else)
+extern RingbufHandle_t nordic_uart_rx_ctrl_buf_handle; // control lane (cmd, datetime, status, Ctrl-C)
+
+// Received lines are split into two bounded lanes so a notification burst
+// cannot drop or delay commands and time sync replies
+enum nordic_uart_rx_lane {
+  NORDIC_UART_RX_LANE_CONTROL = 0,
+  NORDIC_UART_RX_LANE_BULK,
+  NORDIC_UART_RX_LANES,
+};
+
+// Per-lane counters since start (or the last reset)
+struct nordic_uart_rx_stats {
+  uint32_t lines[NORDIC_UART_RX_LANES];         // items enqueued
+  uint32_t dropped[NORDIC_UART_RX_LANES];       // items dropped because the lane was full
+  uint32_t dropped_bytes[NORDIC_UART_RX_LANES];
+  uint32_t peak_used[NORDIC_UART_RX_LANES];     // high-water mark in bytes
+};
 
 // Enum for Nordic UART callback types
 enum nordic_uart_callback_type {
   NORDIC_UART_DISCONNECTED, // Callback type when disconnected
   NORDIC_UART_CONNECTED,    // Callback type when connected
+  NORDIC_UART_SUBSCRIBED,   // Peer enabled notifications (written or restored from bond)
+};
+
+// Link profiles chosen by the adaptive connection-parameter controller
+enum nordic_uart_link_profile {
+  NORDIC_UART_LINK_IDLE = 0, // Long interval + slave latency, link kept alive only
+  NORDIC_UART_LINK_BALANCED, // Interactive defaults (screen on)
+  NORDIC_UART_LINK_BURST,    // Shortest interval for bulk traffic
+};
+
+// Connection parameters in controller units (1.25 ms / 10 ms)
+struct nordic_uart_link_params {
+  uint16_t itvl_min;
+  uint16_t itvl_max;
+  uint16_t latency;
+  uint16_t supervision_timeout;
+};
+
+// Snapshot of the controller state for diagnostics
+struct nordic_uart_link_stats {
+  enum nordic_uart_link_profile profile;
+  uint32_t rx_bps;
+  uint32_t tx_bps;
+  uint32_t param_updates;
+};
+
+// Negotiated link characteristics (PHY: 1 = 1M, 2 = 2M, 3 = Coded)
+struct nordic_uart_link_info {
+  bool connected;
+  uint8_t tx_phy;
+  uint8_t rx_phy;
+  uint16_t tx_octets; // LL PDU payload (27 without DLE, up to 251)
+  uint16_t att_mtu;
+  uint16_t chunk_len; // notification payload used by nordic_uart_send
+  bool encrypted;
+  bool bonded;
+  uint32_t first_notify_ms; // connect to first delivered notification
 };
 
 // Type definition for UART receive callback function
 typedef void (*uart_receive_callback_t)(struct ble_gatt_access_ctxt *ctxt);
 
+// Raw binary writes on the bulk characteristic (6E400004-...). Called from the
+// NimBLE host task with a flat copy of the write; must not block.
+typedef void (*nordic_uart_bulk_callback_t)(const uint8_t *data, size_t len);
+
 // Function to start the Nordic UART service
 // - device_name: Name of the BLE device
 // - callback: Function pointer to the callback function
@@ -41,12 +100,28 @@ esp_err_t nordic_uart_send(const char *message);
 
 // Function to send a message with a newline over Nordic UART
 // - message: String message to be sent
+// Sends from different tasks are serialized; a line and its newline are never
+// split by another task's message.
 esp_err_t nordic_uart_sendln(const char *message);
 
 // Function to yield for UART receive callback
 // - uart_receive_callback: Callback function for UART receive
 esp_err_t nordic_uart_yield(uart_receive_callback_t uart_receive_callback);
 
+// Wait up to `wait` ticks for the next received line, control lane first.
+// Returns NULL on timeout; hand the item back with nordic_uart_rx_return.
+char *nordic_uart_rx_receive(size_t *item_size, enum nordic_uart_rx_lane *lane, TickType_t wait);
+void nordic_uart_rx_return(char *item, enum nordic_uart_rx_lane lane);
+
+// Bytes of both lanes in use, item headers and padding included
+size_t nordic_uart_rx_pending(void);
+
+void nordic_uart_get_rx_stats(struct nordic_uart_rx_stats *out);
+void nordic_uart_reset_rx_stats(void);
+
+// Install the handler for the bulk characteristic (NULL rejects bulk writes)
+esp_err_t nordic_uart_set_bulk_handler(nordic_uart_bulk_callback_t cb);
+
 // private funcs for testing.
 esp_err_t _nordic_uart_buf_deinit();
 esp_err_t _nordic_uart_buf_init();
@@ -54,6 +129,7 @@ esp_err_t _nordic_uart_send_line_buf_to_ring_buf();
 esp_err_t _nordic_uart_linebuf_append(char c);
 bool _nordic_uart_linebuf_initialized();
 char* _nordic_uart_get_linebuf(void);
+enum nordic_uart_rx_lane _nordic_uart_rx_classify(const char *line, size_t len);
 
 esp_err_t _nordic_uart_start(const char *device_name, void (*callback)(enum nordic_uart_callback_type callback_type));
 esp_err_t _nordic_uart_stop(void);
@@ -64,6 +140,28 @@ esp_err_t _nordic_uart_send(const char *message);
 // Safe to call anytime; takes effect on the next connection or immediately if connected.
 void nordic_uart_set_low_power_mode(bool enable);
 
+// Ask for the fast link profile for at least duration_ms (bulk sync, file transfer).
+// Traffic above the burst watermark upgrades the link on its own; this hint only
+// avoids the first slow round-trips when the caller knows a burst is coming.
+void nordic_uart_request_burst(uint32_t duration_ms);
+
+// Current link profile and smoothed RX/TX rates
+void nordic_uart_get_link_stats(struct nordic_uart_link_stats *out);
+
+// PHY, data length and MTU negotiated for the current connection
+void nordic_uart_get_link_info(struct nordic_uart_link_info *out);
+
+// private funcs for the connection-parameter controller (conn_ctrl.c)
+void _nordic_uart_conn_ctrl_reset(uint32_t now_ms);
+void _nordic_uart_conn_ctrl_note_rx(size_t bytes);
+void _nordic_uart_conn_ctrl_note_tx(size_t bytes);
+void _nordic_uart_conn_ctrl_note_tx_stall(void);
+void _nordic_uart_conn_ctrl_burst(uint32_t now_ms, uint32_t duration_ms);
+enum nordic_uart_link_profile _nordic_uart_conn_ctrl_step(uint32_t now_ms, size_t rx_pending, bool low_power_pref);
+void _nordic_uart_conn_ctrl_applied(uint32_t now_ms);
+const struct nordic_uart_link_params *_nordic_uart_conn_ctrl_params(enum nordic_uart_link_profile profile);
+void _nordic_uart_conn_ctrl_get_stats(struct nordic_uart_link_stats *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,25 +3,120 @@
 #include "esp_log.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/ringbuf.h>
+#include <freertos/semphr.h>
+#include <string.h>
 
 static const char *_TAG = "NORDIC UART";
 
-// the ringbuffer is an interface with external
-RingbufHandle_t nordic_uart_rx_buf_handle;
+// the ringbuffers are an interface with external
+RingbufHandle_t nordic_uart_rx_buf_handle;      // bulk lane
+RingbufHandle_t nordic_uart_rx_ctrl_buf_handle; // control lane
 
 static char *_nordic_uart_rx_line_buf = NULL;
 static size_t _nordic_uart_rx_line_buf_pos = 0;
 
+// Lane of the line being assembled; fixed by its first segment so the
+// continuation segments of a long line stay in order behind it.
+static enum nordic_uart_rx_lane _line_lane = NORDIC_UART_RX_LANE_BULK;
+static bool _line_lane_set = false;
+
+// One count per enqueued item in either lane; nordic_uart_rx_receive takes
+// one and then serves control before bulk.
+static SemaphoreHandle_t _rx_items = NULL;
+
+static struct nordic_uart_rx_stats _rx_stats;
+
+static RingbufHandle_t _lane_handle(enum nordic_uart_rx_lane lane) {
+  return lane == NORDIC_UART_RX_LANE_CONTROL ? nordic_uart_rx_ctrl_buf_handle : nordic_uart_rx_buf_handle;
+}
+
+static size_t _lane_size(enum nordic_uart_rx_lane lane) {
+  return lane == NORDIC_UART_RX_LANE_CONTROL ? CONFIG_NORDIC_UART_RX_CTRL_BUFFER_SIZE : CONFIG_NORDIC_UART_RX_BUFFER_SIZE;
+}
+
+// xRingbufferGetCurFreeSize can't give the backlog: on a no-split buffer it
+// reports the largest item that still fits, capped at about half the
+// buffer, so "size - free" never drops below half of it. The span from the
+// oldest unreturned item to the write position is what is really held.
+static size_t _lane_used(enum nordic_uart_rx_lane lane) {
+  RingbufHandle_t rb = _lane_handle(lane);
+  if (!rb)
+    return 0;
+  UBaseType_t free_pos, read_pos, write_pos, acquire_pos, waiting;
+  vRingbufferGetInfo(rb, &free_pos, &read_pos, &write_pos, &acquire_pos, &waiting);
+  size_t size = _lane_size(lane);
+  size_t used = (acquire_pos + size - free_pos) % size;
+  // Equal positions are both "empty" and "full"
+  return used == 0 && waiting > 0 ? size : used;
+}
+
+// True if `key` appears as an object key ({"key": or ,"key":), not inside a string value
+static bool _has_json_key(const char *line, size_t len, const char *key) {
+  size_t klen = strlen(key);
+  for (size_t i = 0; i + klen + 2 <= len; ++i) {
+    if (line[i] != '"' || memcmp(&line[i + 1], key, klen) != 0 || line[i + 1 + klen] != '"')
+      continue;
+    size_t j = i;
+    while (j > 0 && (line[j - 1] == ' ' || line[j - 1] == '\t'))
+      --j;
+    if (j == 0 || (line[j - 1] != '{' && line[j - 1] != ','))
+      continue;
+    size_t k = i + 2 + klen;
+    while (k < len && (line[k] == ' ' || line[k] == '\t'))
+      ++k;
+    if (k < len && line[k] == ':')
+      return true;
+  }
+  return false;
+}
+
+enum nordic_uart_rx_lane _nordic_uart_rx_classify(const char *line, size_t len) {
+  if (len >= 1 && line[0] == '\003')
+    return NORDIC_UART_RX_LANE_CONTROL;
+  // Notifications are the bulk traffic even if they carry other keys
+  if (_has_json_key(line, len, "notification"))
+    return NORDIC_UART_RX_LANE_BULK;
+  if (_has_json_key(line, len, "cmd") || _has_json_key(line, len, "datetime") || _has_json_key(line, len, "status"))
+    return NORDIC_UART_RX_LANE_CONTROL;
+  return NORDIC_UART_RX_LANE_BULK;
+}
+
 esp_err_t _nordic_uart_send_line_buf_to_ring_buf() {
   _nordic_uart_rx_line_buf[_nordic_uart_rx_line_buf_pos] = '\0';
+  size_t len = _nordic_uart_rx_line_buf_pos + 1;
+  if (!_line_lane_set) {
+    _line_lane = _nordic_uart_rx_classify(_nordic_uart_rx_line_buf, _nordic_uart_rx_line_buf_pos);
+    _line_lane_set = true;
+  }
+  enum nordic_uart_rx_lane lane = _line_lane;
+  RingbufHandle_t rb = _lane_handle(lane);
   // Non-blocking (or near non-blocking) enqueue to avoid stalling BLE/other tasks
-  UBaseType_t res = xRingbufferSend(nordic_uart_rx_buf_handle,
-                                    _nordic_uart_rx_line_buf,
-                                    _nordic_uart_rx_line_buf_pos + 1,
-                                    0);
+  UBaseType_t res = xRingbufferSend(rb, _nordic_uart_rx_line_buf, len, 0);
   _nordic_uart_rx_line_buf_pos = 0;
 
-  return res == pdTRUE ? ESP_OK : ESP_FAIL;
+  if (res != pdTRUE) {
+    _rx_stats.dropped[lane]++;
+    _rx_stats.dropped_bytes[lane] += len;
+    // Throttled: this runs on the NimBLE host task in the middle of a burst
+    if ((_rx_stats.dropped[lane] & 31) == 1) {
+      ESP_LOGW(_TAG, "%s lane full, %lu line(s) dropped", lane == NORDIC_UART_RX_LANE_CONTROL ? "control" : "bulk",
+               (unsigned long)_rx_stats.dropped[lane]);
+    }
+    return ESP_FAIL;
+  }
+  _rx_stats.lines[lane]++;
+  size_t used = _lane_used(lane);
+  if (used > _rx_stats.peak_used[lane])
+    _rx_stats.peak_used[lane] = used;
+  if (_rx_items)
+    xSemaphoreGive(_rx_items);
+  return ESP_OK;
+}
+
+static esp_err_t _nordic_uart_end_line(void) {
+  esp_err_t err = _nordic_uart_send_line_buf_to_ring_buf();
+  _line_lane_set = false;
+  return err;
 }
 
 esp_err_t _nordic_uart_linebuf_append(char c) {
@@ -30,8 +125,8 @@ esp_err_t _nordic_uart_linebuf_append(char c) {
   case '\003':
     _nordic_uart_rx_line_buf[0] = '\003';
     _nordic_uart_rx_line_buf_pos = 1;
-    if (_nordic_uart_send_line_buf_to_ring_buf() != ESP_OK) {
-      ESP_LOGE(_TAG, "Failed to send item");
+    _line_lane_set = false;
+    if (_nordic_uart_end_line() != ESP_OK) {
       return ESP_FAIL;
     }
     break;
@@ -43,8 +138,7 @@ esp_err_t _nordic_uart_linebuf_append(char c) {
   // send a line buffer to ring buffer
   case '\n':
   case '\0':
-    if (_nordic_uart_send_line_buf_to_ring_buf() != ESP_OK) {
-      ESP_LOGE(_TAG, "Failed to send item");
+    if (_nordic_uart_end_line() != ESP_OK) {
       return ESP_FAIL;
     }
     break;
@@ -66,6 +160,49 @@ esp_err_t _nordic_uart_linebuf_append(char c) {
   return ESP_OK;
 }
 
+char *nordic_uart_rx_receive(size_t *item_size, enum nordic_uart_rx_lane *lane, TickType_t wait) {
+  if (!_rx_items)
+    return NULL;
+  TickType_t start = xTaskGetTickCount();
+  for (;;) {
+    TickType_t elapsed = xTaskGetTickCount() - start;
+    TickType_t left = wait == portMAX_DELAY ? portMAX_DELAY : (elapsed >= wait ? 0 : wait - elapsed);
+    if (xSemaphoreTake(_rx_items, left) != pdTRUE)
+      return NULL;
+    // Control first, always; bulk only when the control lane is empty
+    for (int l = NORDIC_UART_RX_LANE_CONTROL; l < NORDIC_UART_RX_LANES; ++l) {
+      RingbufHandle_t rb = _lane_handle((enum nordic_uart_rx_lane)l);
+      char *item = rb ? (char *)xRingbufferReceive(rb, item_size, 0) : NULL;
+      if (item) {
+        if (lane)
+          *lane = (enum nordic_uart_rx_lane)l;
+        return item;
+      }
+    }
+    // Count without an item: it was read directly from a lane handle
+  }
+}
+
+void nordic_uart_rx_return(char *item, enum nordic_uart_rx_lane lane) {
+  RingbufHandle_t rb = _lane_handle(lane);
+  if (item && rb)
+    vRingbufferReturnItem(rb, item);
+}
+
+size_t nordic_uart_rx_pending(void) {
+  size_t pending = 0;
+  for (int l = NORDIC_UART_RX_LANE_CONTROL; l < NORDIC_UART_RX_LANES; ++l)
+    pending += _lane_used((enum nordic_uart_rx_lane)l);
+  return pending;
+}
+
+void nordic_uart_get_rx_stats(struct nordic_uart_rx_stats *out) {
+  if (out)
+    *out = _rx_stats;
+}
+
+void nordic_uart_reset_rx_stats(void) { memset(&_rx_stats, 0, sizeof(_rx_stats)); }
+
 esp_err_t _nordic_uart_buf_deinit() {
   if (!_nordic_uart_linebuf_initialized())
     return ESP_FAIL;
@@ -73,9 +210,18 @@ esp_err_t _nordic_uart_buf_deinit() {
   free(_nordic_uart_rx_line_buf);
   _nordic_uart_rx_line_buf = NULL;
   _nordic_uart_rx_line_buf_pos = 0;
+  _line_lane_set = false;
 
   vRingbufferDelete(nordic_uart_rx_buf_handle);
   nordic_uart_rx_buf_handle = NULL;
+  if (nordic_uart_rx_ctrl_buf_handle) {
+    vRingbufferDelete(nordic_uart_rx_ctrl_buf_handle);
+    nordic_uart_rx_ctrl_buf_handle = NULL;
+  }
+  if (_rx_items) {
+    vSemaphoreDelete(_rx_items);
+    _rx_items = NULL;
+  }
 
   return ESP_OK;
 }
@@ -87,7 +233,10 @@ esp_err_t _nordic_uart_buf_init() {
   _nordic_uart_rx_line_buf = malloc(CONFIG_NORDIC_UART_MAX_LINE_LENGTH + 1);
   _nordic_uart_rx_line_buf_pos = 0;
   nordic_uart_rx_buf_handle = xRingbufferCreate(CONFIG_NORDIC_UART_RX_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
-  if (nordic_uart_rx_buf_handle == NULL) {
+  nordic_uart_rx_ctrl_buf_handle = xRingbufferCreate(CONFIG_NORDIC_UART_RX_CTRL_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+  // Upper bound on items: every item is at least header + 1 byte
+  _rx_items = xSemaphoreCreateCounting((CONFIG_NORDIC_UART_RX_BUFFER_SIZE + CONFIG_NORDIC_UART_RX_CTRL_BUFFER_SIZE) / 8, 0);
+  if (nordic_uart_rx_buf_handle == NULL || nordic_uart_rx_ctrl_buf_handle == NULL || _rx_items == NULL) {
     ESP_LOGE(_TAG, "Failed to create ring buffer");
     return ESP_FAIL;
   }
@@ -0,0 +1,177 @@
+#include "nimble-nordic-uart.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+// Adaptive connection-parameter controller.
+//
+// The controller is fed with RX/TX byte counts from the GATT paths and is
+// stepped periodically from nimble.c. It picks one of three link profiles:
+//   BURST    - short intervals, no latency (notification flush, sync, transfers)
+//   BALANCED - the classic "screen on" parameters
+//   IDLE     - long intervals with high slave latency (screen off, no traffic)
+//
+// Upgrades are applied as soon as the traffic crosses the high watermark,
+// downgrades only after the link has been quiet for a dwell time. A minimum
+// spacing between updates keeps the controller from flooding the peer with
+// L2CAP parameter-update requests.
+//
+// The counters are fed from the NimBLE host task and from whichever task
+// sends, and the controller is stepped from the timer task; every access to
+// the state goes through s_cc_lock.
+
+// Rates are bytes per second, smoothed with a 1/2 EWMA on every step.
+#define CC_BURST_ENTER_BPS      512
+#define CC_BURST_EXIT_BPS       128
+#define CC_IDLE_ENTER_BPS       16
+#define CC_BURST_DWELL_MS       2000
+#define CC_IDLE_DWELL_MS        10000
+#define CC_MIN_UPDATE_GAP_MS    1500
+#define CC_PENDING_BURST_BYTES  (CONFIG_NORDIC_UART_RX_BUFFER_SIZE / 4)
+
+// Units: interval 1.25 ms, supervision timeout 10 ms.
+// Timeout must exceed (1 + latency) * itvl_max * 2.
+static const struct nordic_uart_link_params s_profiles[] = {
+    [NORDIC_UART_LINK_IDLE]     = { .itvl_min = 320, .itvl_max = 480, .latency = 8, .supervision_timeout = 1200 }, // 400-600 ms
+    [NORDIC_UART_LINK_BALANCED] = { .itvl_min = 24,  .itvl_max = 40,  .latency = 0, .supervision_timeout = 400 },  // 30-50 ms
+    [NORDIC_UART_LINK_BURST]    = { .itvl_min = 6,   .itvl_max = 12,  .latency = 0, .supervision_timeout = 400 },  // 7.5-15 ms
+};
+
+static struct {
+    uint32_t rx_bytes;          // accumulated since last step
+    uint32_t tx_bytes;
+    uint32_t tx_stalls;         // notify ENOMEM retries since last step
+    uint32_t rx_bps;            // smoothed rates
+    uint32_t tx_bps;
+    uint32_t last_step_ms;
+    uint32_t last_busy_ms;      // last time traffic was above the idle watermark
+    uint32_t last_burst_ms;     // last time traffic was above the burst-exit watermark
+    uint32_t last_update_ms;
+    uint32_t burst_until_ms;    // explicit burst hint deadline
+    uint32_t updates;
+    bool has_update;
+    enum nordic_uart_link_profile profile;
+} s_cc;
+static portMUX_TYPE s_cc_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline bool _time_before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+void _nordic_uart_conn_ctrl_reset(uint32_t now_ms)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    memset(&s_cc, 0, sizeof(s_cc));
+    s_cc.last_step_ms = now_ms;
+    s_cc.last_busy_ms = now_ms;
+    s_cc.last_burst_ms = now_ms;
+    s_cc.burst_until_ms = now_ms;
+    s_cc.profile = NORDIC_UART_LINK_BALANCED;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+void _nordic_uart_conn_ctrl_note_rx(size_t bytes)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    s_cc.rx_bytes += bytes;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+void _nordic_uart_conn_ctrl_note_tx(size_t bytes)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    s_cc.tx_bytes += bytes;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+void _nordic_uart_conn_ctrl_note_tx_stall(void)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    s_cc.tx_stalls++;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+void _nordic_uart_conn_ctrl_burst(uint32_t now_ms, uint32_t duration_ms)
+{
+    uint32_t until = now_ms + duration_ms;
+    taskENTER_CRITICAL(&s_cc_lock);
+    if (_time_before(s_cc.burst_until_ms, until)) {
+        s_cc.burst_until_ms = until;
+    }
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+static uint32_t _ewma(uint32_t avg, uint32_t sample) { return (avg >> 1) + (sample >> 1); }
+
+enum nordic_uart_link_profile _nordic_uart_conn_ctrl_step(uint32_t now_ms, size_t rx_pending, bool low_power_pref)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    uint32_t dt = now_ms - s_cc.last_step_ms;
+    if (dt == 0) dt = 1;
+    s_cc.last_step_ms = now_ms;
+
+    uint32_t rx_inst = (uint32_t)(((uint64_t)s_cc.rx_bytes * 1000U) / dt);
+    uint32_t tx_inst = (uint32_t)(((uint64_t)s_cc.tx_bytes * 1000U) / dt);
+    // Jump straight to a large instantaneous sample so bursts are seen in one step
+    s_cc.rx_bps = rx_inst > s_cc.rx_bps ? rx_inst : _ewma(s_cc.rx_bps, rx_inst);
+    s_cc.tx_bps = tx_inst > s_cc.tx_bps ? tx_inst : _ewma(s_cc.tx_bps, tx_inst);
+    uint32_t stalls = s_cc.tx_stalls;
+    s_cc.rx_bytes = 0;
+    s_cc.tx_bytes = 0;
+    s_cc.tx_stalls = 0;
+
+    uint32_t bps = s_cc.rx_bps + s_cc.tx_bps;
+    bool hinted = _time_before(now_ms, s_cc.burst_until_ms);
+    bool backlog = rx_pending >= CC_PENDING_BURST_BYTES || stalls > 0;
+
+    if (bps >= CC_IDLE_ENTER_BPS || hinted || backlog) s_cc.last_busy_ms = now_ms;
+    if (bps >= CC_BURST_EXIT_BPS || hinted || backlog) s_cc.last_burst_ms = now_ms;
+
+    enum nordic_uart_link_profile want = s_cc.profile;
+    if (bps >= CC_BURST_ENTER_BPS || hinted || backlog) {
+        want = NORDIC_UART_LINK_BURST;
+    } else if (s_cc.profile == NORDIC_UART_LINK_BURST) {
+        if (now_ms - s_cc.last_burst_ms >= CC_BURST_DWELL_MS) want = NORDIC_UART_LINK_BALANCED;
+    } else if (s_cc.profile == NORDIC_UART_LINK_BALANCED) {
+        if (low_power_pref && now_ms - s_cc.last_busy_ms >= CC_IDLE_DWELL_MS) want = NORDIC_UART_LINK_IDLE;
+    }
+    // Screen on: never sit in IDLE, the user is looking at the watch
+    if (!low_power_pref && want == NORDIC_UART_LINK_IDLE) want = NORDIC_UART_LINK_BALANCED;
+    // Traffic while IDLE wakes the link back up without waiting for a full burst
+    if (want == NORDIC_UART_LINK_IDLE && bps >= CC_IDLE_ENTER_BPS) want = NORDIC_UART_LINK_BALANCED;
+
+    if (want != s_cc.profile) {
+        bool upgrade = want > s_cc.profile;
+        if (upgrade || !s_cc.has_update || now_ms - s_cc.last_update_ms >= CC_MIN_UPDATE_GAP_MS) {
+            s_cc.profile = want;
+        }
+    }
+    enum nordic_uart_link_profile profile = s_cc.profile;
+    taskEXIT_CRITICAL(&s_cc_lock);
+    return profile;
+}
+
+void _nordic_uart_conn_ctrl_applied(uint32_t now_ms)
+{
+    taskENTER_CRITICAL(&s_cc_lock);
+    s_cc.last_update_ms = now_ms;
+    s_cc.has_update = true;
+    s_cc.updates++;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
+
+const struct nordic_uart_link_params* _nordic_uart_conn_ctrl_params(enum nordic_uart_link_profile profile)
+{
+    if (profile > NORDIC_UART_LINK_BURST) profile = NORDIC_UART_LINK_BALANCED;
+    return &s_profiles[profile];
+}
+
+void _nordic_uart_conn_ctrl_get_stats(struct nordic_uart_link_stats* out)
+{
+    if (!out) return;
+    taskENTER_CRITICAL(&s_cc_lock);
+    out->profile = s_cc.profile;
+    out->rx_bps = s_cc.rx_bps;
+    out->tx_bps = s_cc.tx_bps;
+    out->param_updates = s_cc.updates;
+    taskEXIT_CRITICAL(&s_cc_lock);
+}
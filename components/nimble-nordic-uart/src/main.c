@@ -2,6 +2,8 @@
 
 #include <esp_log.h>
 #include <esp_nimble_hci.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <nimble/nimble_port.h>
 #include <nimble/nimble_port_freertos.h>
 #include <nvs_flash.h>
@@ -13,20 +15,43 @@ static const char *_TAG = "NORDIC UART";
 // #define CONFIG_NORDIC_UART_MAX_LINE_LENGTH 256
 // #define CONFIG_NORDIC_UART_RX_BUFFER_SIZE 4096
 
+// Held for a whole message, line terminator included, so lines sent from
+// different tasks never interleave on the air
+static SemaphoreHandle_t s_send_lock = NULL;
+
+static void _send_lock(void) {
+  if (s_send_lock)
+    xSemaphoreTake(s_send_lock, portMAX_DELAY);
+}
+
+static void _send_unlock(void) {
+  if (s_send_lock)
+    xSemaphoreGive(s_send_lock);
+}
+
 // Split the message in BLE_SEND_MTU and send it.
 esp_err_t nordic_uart_send(const char *message) { //
-  return _nordic_uart_send(message);
+  _send_lock();
+  esp_err_t err = _nordic_uart_send(message);
+  _send_unlock();
+  return err;
 }
 
 esp_err_t nordic_uart_sendln(const char *message) {
-  if (nordic_uart_send(message) != ESP_OK)
-    return ESP_FAIL;
-  if (nordic_uart_send("\r\n") != ESP_OK)
-    return ESP_FAIL;
-  return ESP_OK;
+  esp_err_t err = ESP_FAIL;
+  _send_lock();
+  if (_nordic_uart_send(message) == ESP_OK && _nordic_uart_send("\r\n") == ESP_OK)
+    err = ESP_OK;
+  _send_unlock();
+  return err;
 }
 
 esp_err_t nordic_uart_start(const char *device_name, void (*callback)(enum nordic_uart_callback_type callback_type)) {
+  if (!s_send_lock) {
+    s_send_lock = xSemaphoreCreateMutex();
+    if (!s_send_lock)
+      return ESP_ERR_NO_MEM;
+  }
   return _nordic_uart_start(device_name, callback);
 }
 
@@ -9,12 +9,17 @@
 #include "services/gap/ble_svc_gap.h"
 #include "services/gatt/ble_svc_gatt.h"
 #include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
 
 static const char* _TAG = "NORDIC UART";
 
 // #define CONFIG_NORDIC_UART_MAX_LINE_LENGTH 256
 // #define CONFIG_NORDIC_UART_RX_BUFFER_SIZE 4096
 #define BLE_SEND_MTU 203
+// Largest ATT payload that fits one 251-byte LL PDU (251 - 4 L2CAP - 3 ATT)
+#define BLE_SEND_DLE_PAYLOAD 244
+// LL PDU time for 251 octets at 1M PHY; the controller shortens it on 2M
+#define BLE_DLE_TX_TIME_US 2120
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define B0(x) ((x) & 0xFF)
@@ -36,6 +41,7 @@ static const char* _TAG = "NORDIC UART";
 static const ble_uuid128_t SERVICE_UUID = UUID128_CONST(0x6E400001, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
 static const ble_uuid128_t CHAR_UUID_RX = UUID128_CONST(0x6E400002, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
 static const ble_uuid128_t CHAR_UUID_TX = UUID128_CONST(0x6E400003, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
+static const ble_uuid128_t CHAR_UUID_BULK = UUID128_CONST(0x6E400004, 0xB5A3, 0xF393, 0xE0A9, 0xE50E24DCCA9E);
 
 static uint8_t ble_addr_type;
 
@@ -44,32 +50,103 @@ static uint16_t notify_char_attr_hdl;
 
 static void (*_nordic_uart_callback)(enum nordic_uart_callback_type callback_type) = NULL;
 static uart_receive_callback_t _uart_receive_callback = NULL;
+static nordic_uart_bulk_callback_t _bulk_callback = NULL;
 static bool s_low_power_pref = false;
 static bool s_adv_enabled = true;
 
 
-/// @brief Apply connection parameters based on power preference
-/// @param  
-static void _apply_conn_params(void)
+static TimerHandle_t s_conn_ctrl_timer = NULL;
+static bool s_param_update_pending = false;
+static enum nordic_uart_link_profile s_applied_profile = NORDIC_UART_LINK_BALANCED;
+static bool s_profile_applied = false;
+
+#define CONN_CTRL_PERIOD_MS 1000
+
+// Negotiated link characteristics for the current connection
+static struct nordic_uart_link_info s_link;
+
+// Reconnect bookkeeping: fast advertising window after a disconnect and
+// connect-to-first-notification latency
+static uint32_t s_fast_adv_until_ms = 0;
+static uint32_t s_connect_ms = 0;
+static bool s_first_notify_pending = false;
+static bool s_notify_enabled = false;
+
+void ble_store_config_init(void);
+
+static uint32_t _now_ms(void) { return (uint32_t)pdTICKS_TO_MS(xTaskGetTickCount()); }
+
+/// @brief Request the connection parameters of a link profile from the central
+/// @param profile target profile
+static void _apply_conn_profile(enum nordic_uart_link_profile profile)
 {
     if (ble_conn_hdl == 0) return;
+    if (s_profile_applied && profile == s_applied_profile) return;
+    // Only one update procedure at a time; the next controller step retries
+    if (s_param_update_pending) return;
     struct ble_gap_conn_desc desc;
     int rc = ble_gap_conn_find(ble_conn_hdl, &desc);
     if (rc != 0) return;
-    struct ble_gap_upd_params params;
-    if (s_low_power_pref) {
-        params.itvl_min = 400;
-        params.itvl_max = 800;
-        params.latency  = 8;
-        params.supervision_timeout = 800; // 6.0 s
+    const struct nordic_uart_link_params* p = _nordic_uart_conn_ctrl_params(profile);
+    struct ble_gap_upd_params params = {
+        .itvl_min = p->itvl_min,
+        .itvl_max = p->itvl_max,
+        .latency = p->latency,
+        .supervision_timeout = p->supervision_timeout,
+    };
+    rc = ble_gap_update_params(ble_conn_hdl, &params);
+    if (rc == 0) {
+        s_param_update_pending = true;
+        s_applied_profile = profile;
+        s_profile_applied = true;
+        _nordic_uart_conn_ctrl_applied(_now_ms());
+        ESP_LOGD(_TAG, "Link profile -> %d (itvl %u-%u, lat %u)", (int)profile, p->itvl_min, p->itvl_max, p->latency);
     } else {
-        // More responsive when active
-        params.itvl_min = 24;   // 30 ms
-        params.itvl_max = 40;   // 50 ms
-        params.latency  = 0;
-        params.supervision_timeout = desc.supervision_timeout;
+        ESP_LOGD(_TAG, "ble_gap_update_params rc=%d", rc);
+    }
+}
+
+static void _conn_ctrl_run(void)
+{
+    if (ble_conn_hdl == 0) return;
+    enum nordic_uart_link_profile profile;
+#if CONFIG_NORDIC_UART_ADAPTIVE_CONN_PARAMS
+    profile = _nordic_uart_conn_ctrl_step(_now_ms(), nordic_uart_rx_pending(), s_low_power_pref);
+#else
+    profile = s_low_power_pref ? NORDIC_UART_LINK_IDLE : NORDIC_UART_LINK_BALANCED;
+#endif
+    _apply_conn_profile(profile);
+}
+
+static void _conn_ctrl_timer_cb(TimerHandle_t xTimer)
+{
+    (void)xTimer;
+    _conn_ctrl_run();
+}
+
+static void _conn_ctrl_start(void)
+{
+    s_param_update_pending = false;
+    s_profile_applied = false;
+    _nordic_uart_conn_ctrl_reset(_now_ms());
+#if CONFIG_NORDIC_UART_ADAPTIVE_CONN_PARAMS
+    if (!s_conn_ctrl_timer) {
+        s_conn_ctrl_timer = xTimerCreate("nus_conn_ctrl", pdMS_TO_TICKS(CONN_CTRL_PERIOD_MS), pdTRUE, NULL, _conn_ctrl_timer_cb);
+    }
+    if (s_conn_ctrl_timer) {
+        xTimerStart(s_conn_ctrl_timer, 0);
+    }
+#endif
+    _conn_ctrl_run();
+}
+
+static void _conn_ctrl_stop(void)
+{
+    if (s_conn_ctrl_timer) {
+        xTimerStop(s_conn_ctrl_timer, 0);
     }
-    (void)ble_gap_update_params(ble_conn_hdl, &params);
+    s_param_update_pending = false;
+    s_profile_applied = false;
 }
 
 esp_err_t nordic_uart_yield(uart_receive_callback_t uart_receive_callback) {
@@ -79,18 +156,41 @@ esp_err_t nordic_uart_yield(uart_receive_callback_t uart_receive_callback) {
 
 
 static int _uart_receive(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    _nordic_uart_conn_ctrl_note_rx(OS_MBUF_PKTLEN(ctxt->om));
     if (_uart_receive_callback) {
         _uart_receive_callback(ctxt);
     }
     else {
-        for (int i = 0; i < ctxt->om->om_len; ++i) {
-            const char c = ctxt->om->om_data[i];
-            _nordic_uart_linebuf_append(c);
+        // Long writes arrive as a chain of mbufs; walk all of them, not just the head
+        for (const struct os_mbuf* om = ctxt->om; om; om = SLIST_NEXT(om, om_next)) {
+            for (int i = 0; i < om->om_len; ++i) {
+                _nordic_uart_linebuf_append((char)om->om_data[i]);
+            }
         }
     }
     return 0;
 }
 
+esp_err_t nordic_uart_set_bulk_handler(nordic_uart_bulk_callback_t cb) {
+    _bulk_callback = cb;
+    return ESP_OK;
+}
+
+// Binary writes bypass the line buffer; a write may span chained mbufs
+static int _bulk_receive(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
+    static uint8_t buf[BLE_ATT_ATTR_MAX_LEN];
+    uint16_t len = 0;
+    _nordic_uart_conn_ctrl_note_rx(OS_MBUF_PKTLEN(ctxt->om));
+    if (!_bulk_callback) {
+        return BLE_ATT_ERR_WRITE_NOT_PERMITTED;
+    }
+    if (ble_hs_mbuf_to_flat(ctxt->om, buf, sizeof(buf), &len) != 0) {
+        return BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN;
+    }
+    _bulk_callback(buf, len);
+    return 0;
+}
+
 // notify GATT callback is no operation.
 static int _uart_noop(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt, void* arg) {
     return 0;
@@ -112,6 +212,11 @@ static const struct ble_gatt_svc_def gat_svcs[] = {
                 .val_handle = &notify_char_attr_hdl,
                 .access_cb = _uart_noop,
             },
+            {
+                .uuid = (ble_uuid_t*)&CHAR_UUID_BULK,
+                .flags = BLE_GATT_CHR_F_WRITE | BLE_GATT_CHR_F_WRITE_NO_RSP,
+                .access_cb = _bulk_receive,
+            },
             { 0 },
         },
     },
@@ -120,6 +225,61 @@ static const struct ble_gatt_svc_def gat_svcs[] = {
 
 static int ble_gap_event_cb(struct ble_gap_event* event, void* arg);
 
+/// @brief Ask the controller for 2M PHY and long LL PDUs on a fresh connection.
+/// Both are requests: if the peer lacks the feature the procedure completes
+/// with the old values (or an error) and the link simply stays on 1M / 27 bytes.
+static void _negotiate_link(uint16_t conn_handle)
+{
+    memset(&s_link, 0, sizeof(s_link));
+    s_link.tx_phy = 1;
+    s_link.rx_phy = 1;
+    s_link.tx_octets = 27;
+    s_link.att_mtu = BLE_ATT_MTU_DFLT;
+
+#if CONFIG_BT_NIMBLE_50_FEATURE_SUPPORT && CONFIG_NORDIC_UART_PREFER_2M_PHY
+    int rc = ble_gap_set_prefered_le_phy(conn_handle, BLE_GAP_LE_PHY_2M_MASK | BLE_GAP_LE_PHY_1M_MASK,
+                                         BLE_GAP_LE_PHY_2M_MASK | BLE_GAP_LE_PHY_1M_MASK, BLE_GAP_LE_PHY_CODED_ANY);
+    if (rc != 0) {
+        ESP_LOGW(_TAG, "2M PHY request failed (%d); staying on 1M", rc);
+    }
+#endif
+#if CONFIG_NORDIC_UART_DLE_TX_OCTETS > 27
+    // tx_octets stays at 27 until BLE_GAP_EVENT_DATA_LEN_CHG confirms the new
+    // length; a peer that never answers keeps the send path on short chunks
+    int dle_rc = ble_gap_set_data_len(conn_handle, CONFIG_NORDIC_UART_DLE_TX_OCTETS, BLE_DLE_TX_TIME_US);
+    if (dle_rc != 0) {
+        ESP_LOGW(_TAG, "Data length extension request failed (%d); using 27-byte PDUs", dle_rc);
+    }
+#endif
+}
+
+/// @brief Notification chunk size for the current link
+static int _send_chunk_len(void)
+{
+    int mtu = ble_conn_hdl ? ble_att_mtu(ble_conn_hdl) : 0;
+    if (mtu <= 3) return BLE_SEND_MTU;
+    int chunk = mtu - 3;
+    int cap = s_link.tx_octets >= 251 ? BLE_SEND_DLE_PAYLOAD : BLE_SEND_MTU;
+    return MIN(chunk, cap);
+}
+
+static void _update_security_state(uint16_t conn_handle)
+{
+    struct ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(conn_handle, &desc) == 0) {
+        s_link.encrypted = desc.sec_state.encrypted;
+        s_link.bonded = desc.sec_state.bonded;
+    }
+}
+
+void nordic_uart_get_link_info(struct nordic_uart_link_info* out)
+{
+    if (!out) return;
+    *out = s_link;
+    out->connected = (ble_conn_hdl != 0);
+    out->chunk_len = ble_conn_hdl ? (uint16_t)_send_chunk_len() : 0;
+}
+
 static int ble_app_advertise(void) {
     if (!s_adv_enabled) {
         ESP_LOGD(_TAG, "Advertising disabled; skip start");
@@ -160,12 +320,24 @@ static int ble_app_advertise(void) {
     memset(&adv_params, 0, sizeof(adv_params));
     adv_params.conn_mode = BLE_GAP_CONN_MODE_UND;
     adv_params.disc_mode = BLE_GAP_DISC_MODE_GEN;
-    // Slow down advertising interval to reduce idle power when not connected
-    // Units are 0.625 ms; 800 => 500 ms, 1000 => 625 ms
-    adv_params.itvl_min = 800;
-    adv_params.itvl_max = 1000;
+    int32_t duration_ms = BLE_HS_FOREVER;
+    uint32_t now = _now_ms();
+    int32_t fast_left = (int32_t)(s_fast_adv_until_ms - now);
+    if (fast_left > 0) {
+        // Right after a disconnect the phone usually reconnects within seconds;
+        // advertise fast for a short window, then fall back to the slow rate.
+        // Units are 0.625 ms; 32 => 20 ms, 48 => 30 ms
+        adv_params.itvl_min = 32;
+        adv_params.itvl_max = 48;
+        duration_ms = fast_left;
+    } else {
+        // Slow down advertising interval to reduce idle power when not connected
+        // Units are 0.625 ms; 800 => 500 ms, 1000 => 625 ms
+        adv_params.itvl_min = 800;
+        adv_params.itvl_max = 1000;
+    }
 
-    err = ble_gap_adv_start(ble_addr_type, NULL, BLE_HS_FOREVER, &adv_params, ble_gap_event_cb, NULL);
+    err = ble_gap_adv_start(ble_addr_type, NULL, duration_ms, &adv_params, ble_gap_event_cb, NULL);
     if (err) {
         if (err == BLE_HS_EALREADY) {
             ESP_LOGD(_TAG, "Advertising already running");
@@ -193,8 +365,21 @@ static int ble_gap_event_cb(struct ble_gap_event* event, void* arg) {
                 return rc;
             }
 
-            // Apply preferred params based on current power preference
-            _apply_conn_params();
+            s_connect_ms = _now_ms();
+            s_first_notify_pending = true;
+            s_notify_enabled = false;
+            s_fast_adv_until_ms = s_connect_ms;
+            _negotiate_link(event->connect.conn_handle);
+#if CONFIG_NORDIC_UART_BONDING
+            // Bonded peers re-encrypt with the stored LTK; new peers pair "just works".
+            // Either way the link works unencrypted until this completes.
+            rc = ble_gap_security_initiate(event->connect.conn_handle);
+            if (rc != 0 && rc != BLE_HS_EALREADY) {
+                ESP_LOGW(_TAG, "Security initiate failed: %d", rc);
+            }
+#endif
+            // Start from the profile matching the current power preference
+            _conn_ctrl_start();
             if (_nordic_uart_callback)
                 _nordic_uart_callback(NORDIC_UART_CONNECTED);
         }
@@ -206,21 +391,75 @@ static int ble_gap_event_cb(struct ble_gap_event* event, void* arg) {
         _nordic_uart_linebuf_append('\003'); // send Ctrl-C
         ESP_LOGI(_TAG, "BLE_GAP_EVENT_DISCONNECT");
         ble_conn_hdl = 0;
+        s_notify_enabled = false;
+        s_first_notify_pending = false;
+        _conn_ctrl_stop();
+        s_fast_adv_until_ms = _now_ms() + CONFIG_NORDIC_UART_FAST_ADV_WINDOW_MS;
         if (_nordic_uart_callback)
             _nordic_uart_callback(NORDIC_UART_DISCONNECTED);
         (void)ble_app_advertise();
         break;
+    case BLE_GAP_EVENT_CONN_UPDATE:
+        s_param_update_pending = false;
+        if (event->conn_update.status != 0) {
+            // Central rejected or timed out; allow the controller to retry later
+            s_profile_applied = false;
+            ESP_LOGD(_TAG, "Connection update failed: %d", event->conn_update.status);
+        }
+        break;
+#if CONFIG_BT_NIMBLE_50_FEATURE_SUPPORT
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+        if (event->phy_updated.status == 0) {
+            s_link.tx_phy = event->phy_updated.tx_phy;
+            s_link.rx_phy = event->phy_updated.rx_phy;
+            ESP_LOGI(_TAG, "PHY updated: tx=%u rx=%u", s_link.tx_phy, s_link.rx_phy);
+        } else {
+            ESP_LOGW(_TAG, "PHY update failed: %d; staying on 1M", event->phy_updated.status);
+        }
+        break;
+#endif
+#ifdef BLE_GAP_EVENT_DATA_LEN_CHG
+    case BLE_GAP_EVENT_DATA_LEN_CHG:
+        s_link.tx_octets = event->data_len_chg.max_tx_octets;
+        ESP_LOGI(_TAG, "Data length: tx=%u rx=%u", event->data_len_chg.max_tx_octets, event->data_len_chg.max_rx_octets);
+        break;
+#endif
+    case BLE_GAP_EVENT_MTU:
+        s_link.att_mtu = event->mtu.value;
+        ESP_LOGI(_TAG, "ATT MTU: %u", event->mtu.value);
+        break;
     case BLE_GAP_EVENT_ADV_COMPLETE:
         ESP_LOGI(_TAG, "BLE_GAP_EVENT_ADV_COMPLETE");
-        (void)ble_app_advertise();
+        // Fast window expired (or adv stopped); continue at the slow rate
+        if (ble_conn_hdl == 0) {
+            (void)ble_app_advertise();
+        }
         break;
+    case BLE_GAP_EVENT_ENC_CHANGE:
+        _update_security_state(event->enc_change.conn_handle);
+        ESP_LOGI(_TAG, "Encryption %s (bonded=%d)", event->enc_change.status == 0 ? "on" : "failed", (int)s_link.bonded);
+        break;
+    case BLE_GAP_EVENT_REPEAT_PAIRING: {
+        // Peer lost its bond (e.g. "forget device" on the phone): drop ours and pair again
+        struct ble_gap_conn_desc desc;
+        if (ble_gap_conn_find(event->repeat_pairing.conn_handle, &desc) == 0) {
+            ble_store_util_delete_peer(&desc.peer_id_addr);
+        }
+        return BLE_GAP_REPEAT_PAIRING_RETRY;
+    }
     case BLE_GAP_EVENT_SUBSCRIBE:
         if (event->subscribe.attr_handle == notify_char_attr_hdl) {
-            if (event->subscribe.cur_notify == 0) {
+            bool was_enabled = s_notify_enabled;
+            s_notify_enabled = event->subscribe.cur_notify != 0;
+            if (!s_notify_enabled) {
                 ESP_LOGI(_TAG, "Client unsubscribed from notifications");
             }
             else {
-                ESP_LOGI(_TAG, "Client subscribed to notifications");
+                // reason RESTORE: CCCD restored from the bond, no write from the phone needed
+                ESP_LOGI(_TAG, "Client subscribed to notifications%s",
+                         event->subscribe.reason == BLE_GAP_SUBSCRIBE_REASON_RESTORE ? " (restored)" : "");
+                if (!was_enabled && _nordic_uart_callback)
+                    _nordic_uart_callback(NORDIC_UART_SUBSCRIBED);
             }
         }
         else {
@@ -253,26 +492,35 @@ static void ble_host_task(void* param) {
     }
 }
 
-// Split the message in BLE_SEND_MTU and send it.
+// Split the message in chunks sized for the negotiated MTU/PDU and send it.
 esp_err_t _nordic_uart_send(const char* message) {
     const int len = strlen(message);
     if (len == 0)
         return ESP_OK;
-    // Split the message in BLE_SEND_MTU and send it.
-    for (int i = 0; i < len; i += BLE_SEND_MTU) {
+    const int chunk = _send_chunk_len();
+    // Split the message in chunk-sized notifications and send it.
+    for (int i = 0; i < len; i += chunk) {
         int err;
         struct os_mbuf* om;
         int err_count = 0;
     do_notify:
-        om = ble_hs_mbuf_from_flat(&message[i], MIN(BLE_SEND_MTU, len - i));
+        om = ble_hs_mbuf_from_flat(&message[i], MIN(chunk, len - i));
         //err = ble_gattc_notify_custom(ble_conn_hdl, notify_char_attr_hdl, om);
         err = ble_gatts_notify_custom(ble_conn_hdl, notify_char_attr_hdl, om);
         if (err == BLE_HS_ENOMEM && err_count++ < 10) {
+            _nordic_uart_conn_ctrl_note_tx_stall();
             vTaskDelay(100 / portTICK_PERIOD_MS);
             goto do_notify;
         }
         if (err)
             return ESP_FAIL;
+        _nordic_uart_conn_ctrl_note_tx(MIN(chunk, len - i));
+        if (s_first_notify_pending) {
+            s_first_notify_pending = false;
+            s_link.first_notify_ms = _now_ms() - s_connect_ms;
+            ESP_LOGI(_TAG, "Connect to first notification: %u ms (bonded=%d)",
+                     (unsigned)s_link.first_notify_ms, (int)s_link.bonded);
+        }
     }
     return ESP_OK;
 }
@@ -281,7 +529,18 @@ esp_err_t _nordic_uart_send(const char* message) {
 void nordic_uart_set_low_power_mode(bool enable)
 {
     s_low_power_pref = enable;
-    _apply_conn_params();
+    _conn_ctrl_run();
+}
+
+void nordic_uart_request_burst(uint32_t duration_ms)
+{
+    _nordic_uart_conn_ctrl_burst(_now_ms(), duration_ms);
+    _conn_ctrl_run();
+}
+
+void nordic_uart_get_link_stats(struct nordic_uart_link_stats* out)
+{
+    _nordic_uart_conn_ctrl_get_stats(out);
 }
 
 /***
@@ -323,6 +582,16 @@ esp_err_t _nordic_uart_start(const char* device_name, void (*callback)(enum nord
     // Bluetooth device name for advertisement
 
     ble_hs_cfg.sync_cb = ble_app_on_sync_cb;
+    ble_hs_cfg.store_status_cb = ble_store_util_status_rr;
+#if CONFIG_NORDIC_UART_BONDING
+    // "Just works" bonding: the watch has no way to show or enter a passkey
+    ble_hs_cfg.sm_io_cap = BLE_HS_IO_NO_INPUT_OUTPUT;
+    ble_hs_cfg.sm_bonding = 1;
+    ble_hs_cfg.sm_mitm = 0;
+    ble_hs_cfg.sm_sc = 0;
+    ble_hs_cfg.sm_our_key_dist = BLE_SM_PAIR_KEY_DIST_ENC | BLE_SM_PAIR_KEY_DIST_ID;
+    ble_hs_cfg.sm_their_key_dist = BLE_SM_PAIR_KEY_DIST_ENC | BLE_SM_PAIR_KEY_DIST_ID;
+#endif
 
     ble_svc_gap_init();
     ble_svc_gatt_init();
@@ -337,6 +606,9 @@ esp_err_t _nordic_uart_start(const char* device_name, void (*callback)(enum nord
     rc = ble_svc_gap_device_name_set(device_name);
     assert(rc == 0);
 
+    // Bonds and CCCD state live in NVS (CONFIG_BT_NIMBLE_NVS_PERSIST)
+    ble_store_config_init();
+
 
     // Create NimBLE thread
     nimble_port_freertos_init(ble_host_task);
@@ -347,6 +619,7 @@ esp_err_t _nordic_uart_start(const char* device_name, void (*callback)(enum nord
 
 esp_err_t _nordic_uart_stop(void) {
     s_adv_enabled = false;
+    _conn_ctrl_stop();
     if (ble_conn_hdl != 0) {
         int term_rc = ble_gap_terminate(ble_conn_hdl, BLE_ERR_REM_USER_CONN_TERM);
         if (term_rc != 0) {
@@ -92,3 +92,57 @@ TEST_CASE("ring buffer overflow", "[buffer]") {
 
   TEST_ESP_OK(_nordic_uart_buf_deinit());
 }
+
+static void append_line(const char *s) {
+  while (*s)
+    _nordic_uart_linebuf_append(*s++);
+  _nordic_uart_linebuf_append('\n');
+}
+
+TEST_CASE("rx lane classify", "[buffer]") {
+  const char *ctl[] = {"{\"cmd\":\"link\"}", "{\"datetime\":\"2024-01-01T00:00:00\"}", "{ \"status\" : 1}", "\003"};
+  const char *bulk[] = {"{\"notification\":\"x\",\"cmd\":\"y\"}", "{\"title\":\"\\\"cmd\\\": no\"}", "hello", ""};
+  for (int i = 0; i < 4; ++i) {
+    TEST_ASSERT_EQUAL(NORDIC_UART_RX_LANE_CONTROL, _nordic_uart_rx_classify(ctl[i], strlen(ctl[i])));
+    TEST_ASSERT_EQUAL(NORDIC_UART_RX_LANE_BULK, _nordic_uart_rx_classify(bulk[i], strlen(bulk[i])));
+  }
+}
+
+TEST_CASE("rx lanes: control drains first and survives a full bulk lane", "[buffer]") {
+  size_t item_size;
+  enum nordic_uart_rx_lane lane;
+  char *str;
+
+  TEST_ESP_OK(_nordic_uart_buf_init());
+  nordic_uart_reset_rx_stats();
+
+  // Flood the bulk lane until it drops
+  for (int i = 0; i < 2 * CONFIG_NORDIC_UART_RX_BUFFER_SIZE / 64; ++i) {
+    append_line("{\"notification\":\"2024\",\"app\":\"x\",\"title\":\"t\",\"message\":\"0123456789\"}");
+  }
+  struct nordic_uart_rx_stats st;
+  nordic_uart_get_rx_stats(&st);
+  TEST_ASSERT_TRUE(st.dropped[NORDIC_UART_RX_LANE_BULK] > 0);
+  int queued = (int)st.lines[NORDIC_UART_RX_LANE_BULK];
+
+  // A command behind the burst still gets in and comes out first
+  append_line("{\"cmd\":\"link\"}");
+  nordic_uart_get_rx_stats(&st);
+  TEST_ASSERT_EQUAL_UINT32(0, st.dropped[NORDIC_UART_RX_LANE_CONTROL]);
+  str = nordic_uart_rx_receive(&item_size, &lane, 1);
+  TEST_ASSERT_NOT_NULL(str);
+  TEST_ASSERT_EQUAL(NORDIC_UART_RX_LANE_CONTROL, lane);
+  TEST_ASSERT_EQUAL_STRING("{\"cmd\":\"link\"}", str);
+  nordic_uart_rx_return(str, lane);
+
+  for (int i = 0; i < queued; ++i) {
+    str = nordic_uart_rx_receive(&item_size, &lane, 1);
+    TEST_ASSERT_NOT_NULL(str);
+    TEST_ASSERT_EQUAL(NORDIC_UART_RX_LANE_BULK, lane);
+    nordic_uart_rx_return(str, lane);
+  }
+  TEST_ASSERT_NULL(nordic_uart_rx_receive(&item_size, &lane, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, nordic_uart_rx_pending());
+
+  TEST_ESP_OK(_nordic_uart_buf_deinit());
+}
@@ -0,0 +1,129 @@
+#include "unity.h"
+
+#include "nimble-nordic-uart.h"
+
+#include <stdio.h>
+
+// Simulated traffic: one second per step, a notification burst every two
+// minutes plus a small status message every five minutes.
+#define SIM_SECONDS 1800
+
+static uint32_t sim_rx_bytes(int t) {
+  if (t % 120 < 4) return 2048; // notification flush
+  if (t % 300 == 60) return 96;  // status round-trip
+  return 0;
+}
+
+// Rough radio model: every connection event the peripheral listens costs
+// ~0.4 ms on air, payload costs 8 us/byte at 1M PHY. A message arriving
+// while the link sleeps waits on average half of (latency + 1) intervals,
+// using the parameters in force *before* the controller saw the traffic.
+struct sim_result {
+  double duty_pct;
+  double latency_ms;
+  int updates;
+};
+
+static double itvl_ms(const struct nordic_uart_link_params *p) {
+  return (p->itvl_min + p->itvl_max) * 1.25 / 2.0;
+}
+
+static struct sim_result simulate(int fixed_profile, bool low_power) {
+  struct sim_result r = {0};
+  double on_air_ms = 0, lat_sum = 0;
+  int lat_n = 0;
+  enum nordic_uart_link_profile prev = NORDIC_UART_LINK_BALANCED;
+
+  _nordic_uart_conn_ctrl_reset(0);
+  for (int t = 0; t < SIM_SECONDS; ++t) {
+    uint32_t bytes = sim_rx_bytes(t);
+    const struct nordic_uart_link_params *p = _nordic_uart_conn_ctrl_params(prev);
+    double wake_ms = itvl_ms(p) * (p->latency + 1);
+    if (bytes) {
+      lat_sum += wake_ms / 2.0;
+      lat_n++;
+    }
+    enum nordic_uart_link_profile prof;
+    if (fixed_profile >= 0) {
+      prof = (enum nordic_uart_link_profile)fixed_profile;
+    } else {
+      _nordic_uart_conn_ctrl_note_rx(bytes);
+      prof = _nordic_uart_conn_ctrl_step((uint32_t)(t + 1) * 1000U, 0, low_power);
+      if (prof != prev) {
+        _nordic_uart_conn_ctrl_applied((uint32_t)(t + 1) * 1000U);
+        r.updates++;
+      }
+    }
+    prev = prof;
+    p = _nordic_uart_conn_ctrl_params(prof);
+    wake_ms = itvl_ms(p) * (p->latency + 1);
+    on_air_ms += (1000.0 / wake_ms) * 0.4 + bytes * 0.008;
+  }
+  r.duty_pct = on_air_ms / (SIM_SECONDS * 1000.0) * 100.0;
+  r.latency_ms = lat_n ? lat_sum / lat_n : 0;
+  return r;
+}
+
+TEST_CASE("conn ctrl latency vs duty cycle", "[conn_ctrl]") {
+  struct sim_result idle = simulate(NORDIC_UART_LINK_IDLE, true);
+  struct sim_result bal = simulate(NORDIC_UART_LINK_BALANCED, true);
+  struct sim_result burst = simulate(NORDIC_UART_LINK_BURST, true);
+  struct sim_result adapt_off = simulate(-1, true);
+  struct sim_result adapt_on = simulate(-1, false);
+
+  printf("profile            duty%%   latency(ms)  updates\n");
+  printf("fixed idle        %6.3f   %9.1f  %7d\n", idle.duty_pct, idle.latency_ms, idle.updates);
+  printf("fixed balanced    %6.3f   %9.1f  %7d\n", bal.duty_pct, bal.latency_ms, bal.updates);
+  printf("fixed burst       %6.3f   %9.1f  %7d\n", burst.duty_pct, burst.latency_ms, burst.updates);
+  printf("adaptive (off)    %6.3f   %9.1f  %7d\n", adapt_off.duty_pct, adapt_off.latency_ms, adapt_off.updates);
+  printf("adaptive (on)     %6.3f   %9.1f  %7d\n", adapt_on.duty_pct, adapt_on.latency_ms, adapt_on.updates);
+
+  // Screen off: well under the old fixed "active" cost; only the first
+  // message of a burst pays the idle wake-up
+  TEST_ASSERT_TRUE(adapt_off.duty_pct < bal.duty_pct / 2);
+  TEST_ASSERT_TRUE(adapt_off.latency_ms < idle.latency_ms / 3);
+  // Screen on: never worse than the old fixed "active" parameters
+  TEST_ASSERT_TRUE(adapt_on.latency_ms <= bal.latency_ms);
+  // Hysteresis: up/down/idle per burst, wake/sleep per status message
+  TEST_ASSERT_TRUE(adapt_off.updates <= 3 * (SIM_SECONDS / 120) + 2 * (SIM_SECONDS / 300));
+}
+
+TEST_CASE("conn ctrl hysteresis", "[conn_ctrl]") {
+  uint32_t now = 0;
+  _nordic_uart_conn_ctrl_reset(now);
+
+  // Burst upgrades immediately
+  _nordic_uart_conn_ctrl_note_rx(4096);
+  now += 1000;
+  TEST_ASSERT_EQUAL(NORDIC_UART_LINK_BURST, _nordic_uart_conn_ctrl_step(now, 0, true));
+  _nordic_uart_conn_ctrl_applied(now);
+
+  // Traffic hovering around the exit watermark keeps BURST (no flapping)
+  for (int i = 0; i < 10; ++i) {
+    _nordic_uart_conn_ctrl_note_rx(200);
+    now += 1000;
+    TEST_ASSERT_EQUAL(NORDIC_UART_LINK_BURST, _nordic_uart_conn_ctrl_step(now, 0, true));
+  }
+
+  // Quiet link decays to BALANCED, then to IDLE after the idle dwell
+  enum nordic_uart_link_profile p = NORDIC_UART_LINK_BURST;
+  int t_balanced = -1, t_idle = -1;
+  for (int i = 1; i <= 60; ++i) {
+    now += 1000;
+    p = _nordic_uart_conn_ctrl_step(now, 0, true);
+    if (p == NORDIC_UART_LINK_BALANCED && t_balanced < 0) {
+      t_balanced = i;
+      _nordic_uart_conn_ctrl_applied(now);
+    }
+    if (p == NORDIC_UART_LINK_IDLE && t_idle < 0) t_idle = i;
+  }
+  TEST_ASSERT_TRUE(t_balanced > 1);
+  TEST_ASSERT_TRUE(t_idle > t_balanced);
+  TEST_ASSERT_EQUAL(NORDIC_UART_LINK_IDLE, p);
+
+  // Screen on never stays in IDLE; a full RX buffer forces BURST
+  now += 1000;
+  TEST_ASSERT_EQUAL(NORDIC_UART_LINK_BALANCED, _nordic_uart_conn_ctrl_step(now, 0, false));
+  now += 1000;
+  TEST_ASSERT_EQUAL(NORDIC_UART_LINK_BURST, _nordic_uart_conn_ctrl_step(now, CONFIG_NORDIC_UART_RX_BUFFER_SIZE, false));
+}
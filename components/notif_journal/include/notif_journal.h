@@ -0,0 +1,69 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Notification history on the storage partition.
+//
+// Records are appended to one of two segment files (<base>/.notif_0.log,
+// .notif_1.log). When the active one is full the older segment is emptied
+// and takes over, so the oldest notifications age out a segment at a time.
+// A record holds the app id, title, message and timestamp at their full
+// length (up to NOTIF_JOURNAL_BODY_MAX together); deleting appends a small
+// tombstone. RAM only holds an index of NOTIF_JOURNAL_MAX ids, app hashes
+// and file offsets, so the newest-N and per-app queries never touch flash;
+// bodies are read on demand with notif_journal_read().
+//
+// Ids start at 1 and grow until the journal is cleared (or its partition
+// formatted), after which they start over; views holding ids reload then.
+// All calls are serialised internally.
+
+#define NOTIF_JOURNAL_MAX           512
+#define NOTIF_JOURNAL_SEGMENT_BYTES (64 * 1024)
+#define NOTIF_JOURNAL_BODY_MAX      2048
+
+typedef struct {
+    uint32_t id;
+    const char* app;        // these point into the caller's buffer
+    const char* title;
+    const char* message;
+    const char* timestamp;  // ISO 8601 as received
+} notif_entry_t;
+
+// Scan the segments under base_dir and rebuild the index. Call again after
+// the partition was formatted.
+esp_err_t notif_journal_init(const char* base_dir);
+
+// Store a notification; NULL fields are stored empty
+esp_err_t notif_journal_append(const char* app, const char* title, const char* message,
+                               const char* timestamp, uint32_t* id_out);
+
+size_t notif_journal_count(void);
+
+// Id of the pos-th newest notification (0 = newest); 0 when out of range
+uint32_t notif_journal_id_at(size_t pos);
+
+// The same over the notifications with ids below `limit` only. A view that
+// keeps the bound of what it shows has stable positions while other tasks
+// append.
+size_t notif_journal_count_below(uint32_t limit);
+uint32_t notif_journal_id_below(uint32_t limit, size_t pos);
+
+// Ids of the newest notifications from `app` (all apps when NULL), newest
+// first, skipping the first `skip` matches. Returns how many were stored.
+size_t notif_journal_query(const char* app, size_t skip, uint32_t* ids, size_t max);
+
+// Load one notification; the strings are laid out in `buf`. A message that
+// does not fit is cut short. ESP_ERR_NOT_FOUND for deleted or aged-out ids.
+esp_err_t notif_journal_read(uint32_t id, notif_entry_t* out, char* buf, size_t buf_size);
+
+esp_err_t notif_journal_delete(uint32_t id);
+esp_err_t notif_journal_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
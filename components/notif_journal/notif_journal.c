@@ -0,0 +1,463 @@
+#include "notif_journal.h"
+#include "settings.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* TAG = "NOTIF_JOURNAL";
+
+#define NJ_PATH_MAX      64
+#define NJ_SEGMENTS      2
+#define NJ_MAGIC         0x4A4E      // "NJ"
+#define NJ_TYPE_NOTIF    1
+#define NJ_TYPE_DELETE   2           // tombstone; the body is the deleted id
+
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t app_len;
+    uint32_t id;
+    uint16_t title_len;
+    uint16_t msg_len;
+    uint8_t ts_len;
+    uint8_t reserved;
+    uint32_t crc;                   // esp_rom_crc32_le over header (crc = 0) and body
+} nj_record_t;
+
+// Tombstones take an id of their own so the newest record, whatever its
+// type, tells which segment was active
+
+_Static_assert(sizeof(nj_record_t) == 18, "journal record header layout");
+
+typedef struct {
+    uint32_t id;
+    uint32_t app_hash;
+    uint32_t off;                   // record header offset in its segment
+    uint8_t seg;
+    uint8_t deleted;                // only used while rebuilding
+    uint16_t body_len;
+} nj_index_t;
+
+static char s_base[32] = "/spiffs";
+static SemaphoreHandle_t s_lock;
+static nj_index_t* s_index;         // sorted by id, oldest first
+static size_t s_count;
+static uint32_t s_next_id = 1;
+static uint8_t s_active;            // segment new records go to
+static uint32_t s_seg_size[NJ_SEGMENTS];
+static bool s_seg_full[NJ_SEGMENTS];  // torn tail we could not cut off
+static uint32_t s_seg_last[NJ_SEGMENTS];  // newest id in each, from the scan
+
+static uint32_t app_hash(const char* app, size_t len)
+{
+    uint32_t h = 0x811c9dc5u;
+    while (len--) h = (h ^ (uint8_t)*app++) * 0x01000193u;
+    return h;
+}
+
+static void seg_path(char* out, size_t out_sz, int seg)
+{
+    snprintf(out, out_sz, "%s/.notif_%d.log", s_base, seg);
+}
+
+static uint32_t record_crc(nj_record_t hdr, const uint8_t* body, size_t body_len)
+{
+    hdr.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t*)&hdr, sizeof(hdr));
+    return esp_rom_crc32_le(crc, body, body_len);
+}
+
+static size_t body_len(const nj_record_t* r)
+{
+    if (r->type == NJ_TYPE_DELETE) return sizeof(uint32_t);
+    return (size_t)r->app_len + r->title_len + r->msg_len + r->ts_len;
+}
+
+// Binary search; index of `id` or of the first entry after it
+static size_t index_find(uint32_t id)
+{
+    size_t lo = 0, hi = s_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (s_index[mid].id < id) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void index_remove_at(size_t i)
+{
+    memmove(&s_index[i], &s_index[i + 1], (s_count - i - 1) * sizeof(s_index[0]));
+    s_count--;
+}
+
+static void index_push(const nj_index_t* e)
+{
+    // Ids only grow, so this is an append; a full index forgets the oldest
+    if (s_count == NOTIF_JOURNAL_MAX) index_remove_at(0);
+    s_index[s_count++] = *e;
+}
+
+static void index_drop_segment(int seg)
+{
+    size_t w = 0;
+    for (size_t r = 0; r < s_count; ++r) {
+        if (s_index[r].seg != seg) s_index[w++] = s_index[r];
+    }
+    s_count = w;
+}
+
+// Read every record of one segment into `recs`; returns how many were
+// valid. A torn or corrupt tail is cut off so appends stay reachable.
+static size_t scan_segment(int seg, nj_index_t* recs, size_t max, uint32_t* tombs, size_t* tomb_count,
+                           size_t tomb_max, uint8_t* body)
+{
+    char path[NJ_PATH_MAX];
+    seg_path(path, sizeof(path), seg);
+    s_seg_size[seg] = 0;
+    s_seg_full[seg] = false;
+    s_seg_last[seg] = 0;
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+
+    size_t n = 0;
+    uint32_t off = 0;
+    bool torn = false;
+    while (n < max && *tomb_count < tomb_max) {
+        nj_record_t hdr;
+        size_t got = fread(&hdr, 1, sizeof(hdr), f);
+        if (got == 0) break;
+        size_t len = got == sizeof(hdr) ? body_len(&hdr) : 0;
+        if (got != sizeof(hdr) || hdr.magic != NJ_MAGIC || len > NOTIF_JOURNAL_BODY_MAX ||
+            fread(body, 1, len, f) != len || record_crc(hdr, body, len) != hdr.crc) {
+            torn = true;
+            break;
+        }
+        if (hdr.type == NJ_TYPE_DELETE) {
+            memcpy(&tombs[(*tomb_count)++], body, sizeof(uint32_t));
+        } else if (hdr.type == NJ_TYPE_NOTIF) {
+            recs[n++] = (nj_index_t){
+                .id = hdr.id, .app_hash = app_hash((const char*)body, hdr.app_len), .off = off,
+                .seg = (uint8_t)seg, .body_len = (uint16_t)len,
+            };
+        }
+        if (hdr.id >= s_next_id) s_next_id = hdr.id + 1;
+        if (hdr.id > s_seg_last[seg]) s_seg_last[seg] = hdr.id;
+        off += sizeof(hdr) + len;
+    }
+    fclose(f);
+
+    s_seg_size[seg] = off;
+    if (torn) {
+        ESP_LOGW(TAG, "%s: dropping torn tail after %lu bytes", path, (unsigned long)off);
+        if (truncate(path, off) != 0) s_seg_full[seg] = true;   // rotate away from it instead
+    }
+    return n;
+}
+
+static int cmp_index(const void* a, const void* b)
+{
+    uint32_t x = ((const nj_index_t*)a)->id, y = ((const nj_index_t*)b)->id;
+    return x < y ? -1 : x > y;
+}
+
+static esp_err_t rebuild_index(void)
+{
+    // Worst case both segments are full of bodyless records (the count
+    // stays bounded even if a segment file somehow outgrew its limit).
+    // Scratch for the scan only, from PSRAM.
+    const size_t rec_max = NJ_SEGMENTS * NOTIF_JOURNAL_SEGMENT_BYTES / sizeof(nj_record_t);
+    nj_index_t* recs = heap_caps_malloc(rec_max * sizeof(*recs), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint32_t* tombs = heap_caps_malloc(rec_max * sizeof(*tombs), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint8_t* body = malloc(NOTIF_JOURNAL_BODY_MAX);
+    if (!recs || !tombs || !body) {
+        heap_caps_free(recs);
+        heap_caps_free(tombs);
+        free(body);
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t n = 0, tomb_count = 0;
+    s_next_id = 1;
+    for (int seg = 0; seg < NJ_SEGMENTS; ++seg) {
+        n += scan_segment(seg, recs + n, rec_max - n, tombs, &tomb_count, rec_max, body);
+    }
+    qsort(recs, n, sizeof(recs[0]), cmp_index);
+    // The segment holding the newest record keeps taking appends
+    s_active = 0;
+    for (int seg = 1; seg < NJ_SEGMENTS; ++seg) {
+        if (s_seg_last[seg] > s_seg_last[s_active]) s_active = (uint8_t)seg;
+    }
+
+    for (size_t t = 0; t < tomb_count; ++t) {
+        nj_index_t key = { .id = tombs[t] };
+        nj_index_t* hit = bsearch(&key, recs, n, sizeof(recs[0]), cmp_index);
+        if (hit) hit->deleted = 1;
+    }
+    s_count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!recs[i].deleted) index_push(&recs[i]);
+    }
+
+    heap_caps_free(recs);
+    heap_caps_free(tombs);
+    free(body);
+    return ESP_OK;
+}
+
+esp_err_t notif_journal_init(const char* base_dir)
+{
+    if (!s_lock) s_lock = xSemaphoreCreateMutex();
+    if (!s_lock) return ESP_ERR_NO_MEM;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (base_dir) snprintf(s_base, sizeof(s_base), "%s", base_dir);
+    esp_err_t err = ESP_OK;
+    if (!s_index) {
+        s_index = heap_caps_malloc(NOTIF_JOURNAL_MAX * sizeof(*s_index), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!s_index) err = ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK) err = rebuild_index();
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "%u notifications, segments %lu/%lu bytes, next id %lu", (unsigned)s_count,
+                 (unsigned long)s_seg_size[0], (unsigned long)s_seg_size[1], (unsigned long)s_next_id);
+    } else {
+        s_count = 0;
+        ESP_LOGE(TAG, "init failed (%s)", esp_err_to_name(err));
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+// Empty the older segment and make it the active one
+static bool rotate(void)
+{
+    int next = (s_active + 1) % NJ_SEGMENTS;
+    char path[NJ_PATH_MAX];
+    seg_path(path, sizeof(path), next);
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fclose(f);
+    index_drop_segment(next);
+    settings_wear_note(SETTINGS_PART_STORAGE, 0, (s_seg_size[next] + 4095) / 4096);
+    settings_storage_changed();
+    s_seg_size[next] = 0;
+    s_seg_full[next] = false;
+    s_active = (uint8_t)next;
+    return true;
+}
+
+// Caller holds s_lock. `rec` is header plus body, crc filled in.
+static esp_err_t write_record(const uint8_t* rec, size_t len, uint32_t* off_out)
+{
+    if (s_seg_full[s_active] || s_seg_size[s_active] + len > NOTIF_JOURNAL_SEGMENT_BYTES) {
+        if (!rotate()) return ESP_FAIL;
+    }
+    char path[NJ_PATH_MAX];
+    seg_path(path, sizeof(path), s_active);
+    FILE* f = fopen(path, "ab");
+    if (!f) return ESP_FAIL;
+    size_t n = fwrite(rec, 1, len, f);
+    bool ok = fclose(f) == 0 && n == len;
+    settings_wear_note(SETTINGS_PART_STORAGE, (uint32_t)n, 0);
+    if (!ok) {
+        // Whatever landed is a torn record; the next scan cuts it off
+        s_seg_full[s_active] = true;
+        return ESP_FAIL;
+    }
+    if (off_out) *off_out = s_seg_size[s_active];
+    s_seg_size[s_active] += (uint32_t)len;
+    return ESP_OK;
+}
+
+esp_err_t notif_journal_append(const char* app, const char* title, const char* message,
+                               const char* timestamp, uint32_t* id_out)
+{
+    if (!s_lock || !s_index) return ESP_ERR_INVALID_STATE;
+    if (!app) app = "";
+    if (!title) title = "";
+    if (!message) message = "";
+    if (!timestamp) timestamp = "";
+
+    size_t app_len = strnlen(app, 255);
+    size_t ts_len = strnlen(timestamp, 255);
+    size_t title_len = strlen(title);
+    size_t msg_len = strlen(message);
+    size_t room = NOTIF_JOURNAL_BODY_MAX - app_len - ts_len;
+    if (title_len > room) title_len = room;
+    if (msg_len > room - title_len) {
+        ESP_LOGW(TAG, "Message from %s cut from %u to %u bytes", app, (unsigned)msg_len,
+                 (unsigned)(room - title_len));
+        msg_len = room - title_len;
+    }
+
+    size_t len = sizeof(nj_record_t) + app_len + title_len + msg_len + ts_len;
+    uint8_t* rec = malloc(len);
+    if (!rec) return ESP_ERR_NO_MEM;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    nj_record_t hdr = {
+        .magic = NJ_MAGIC, .type = NJ_TYPE_NOTIF, .app_len = (uint8_t)app_len, .id = s_next_id,
+        .title_len = (uint16_t)title_len, .msg_len = (uint16_t)msg_len, .ts_len = (uint8_t)ts_len,
+    };
+    uint8_t* p = rec + sizeof(hdr);
+    memcpy(p, app, app_len); p += app_len;
+    memcpy(p, title, title_len); p += title_len;
+    memcpy(p, message, msg_len); p += msg_len;
+    memcpy(p, timestamp, ts_len);
+    hdr.crc = record_crc(hdr, rec + sizeof(hdr), len - sizeof(hdr));
+    memcpy(rec, &hdr, sizeof(hdr));
+
+    uint32_t off = 0;
+    esp_err_t err = write_record(rec, len, &off);
+    if (err == ESP_OK) {
+        nj_index_t e = {
+            .id = hdr.id, .app_hash = app_hash(app, app_len), .off = off, .seg = s_active,
+            .body_len = (uint16_t)(len - sizeof(hdr)),
+        };
+        index_push(&e);
+        if (id_out) *id_out = hdr.id;
+        s_next_id++;
+    }
+    xSemaphoreGive(s_lock);
+    free(rec);
+    return err;
+}
+
+size_t notif_journal_count(void)
+{
+    return s_count;
+}
+
+uint32_t notif_journal_id_at(size_t pos)
+{
+    if (!s_lock) return 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    uint32_t id = pos < s_count ? s_index[s_count - 1 - pos].id : 0;
+    xSemaphoreGive(s_lock);
+    return id;
+}
+
+size_t notif_journal_count_below(uint32_t limit)
+{
+    if (!s_lock) return 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    size_t n = index_find(limit);
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+uint32_t notif_journal_id_below(uint32_t limit, size_t pos)
+{
+    if (!s_lock) return 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    size_t n = index_find(limit);
+    uint32_t id = pos < n ? s_index[n - 1 - pos].id : 0;
+    xSemaphoreGive(s_lock);
+    return id;
+}
+
+size_t notif_journal_query(const char* app, size_t skip, uint32_t* ids, size_t max)
+{
+    if (!s_lock || !ids) return 0;
+    const uint32_t h = app ? app_hash(app, strnlen(app, 255)) : 0;
+    size_t n = 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (size_t i = s_count; i-- > 0 && n < max;) {
+        // A hash collision shows up as a foreign app in the read; rare enough
+        if (app && s_index[i].app_hash != h) continue;
+        if (skip) {
+            skip--;
+            continue;
+        }
+        ids[n++] = s_index[i].id;
+    }
+    xSemaphoreGive(s_lock);
+    return n;
+}
+
+esp_err_t notif_journal_read(uint32_t id, notif_entry_t* out, char* buf, size_t buf_size)
+{
+    if (!out || !buf || buf_size < 4) return ESP_ERR_INVALID_ARG;
+    if (!s_lock) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    size_t i = index_find(id);
+    if (i >= s_count || s_index[i].id != id) {
+        xSemaphoreGive(s_lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+    nj_index_t e = s_index[i];
+    char path[NJ_PATH_MAX];
+    seg_path(path, sizeof(path), e.seg);
+    FILE* f = fopen(path, "rb");
+    nj_record_t hdr;
+    bool ok = f && fseek(f, (long)e.off, SEEK_SET) == 0 && fread(&hdr, 1, sizeof(hdr), f) == sizeof(hdr) &&
+              hdr.magic == NJ_MAGIC && hdr.id == id;
+    if (ok) {
+        // app, title, message, timestamp in file order; each gets a NUL
+        const size_t lens[4] = { hdr.app_len, hdr.title_len, hdr.msg_len, hdr.ts_len };
+        const char** dst[4] = { &out->app, &out->title, &out->message, &out->timestamp };
+        size_t used = 0;
+        for (int k = 0; k < 4 && ok; ++k) {
+            size_t left = buf_size - used - (3 - k);    // keep a byte for each later field
+            size_t take = lens[k] < left - 1 ? lens[k] : left - 1;
+            ok = fread(buf + used, 1, take, f) == take &&
+                 (take == lens[k] || fseek(f, (long)(lens[k] - take), SEEK_CUR) == 0);
+            buf[used + take] = '\0';
+            *dst[k] = buf + used;
+            used += take + 1;
+        }
+        out->id = id;
+    }
+    if (f) fclose(f);
+    xSemaphoreGive(s_lock);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t notif_journal_delete(uint32_t id)
+{
+    if (!s_lock) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    size_t i = index_find(id);
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    if (i < s_count && s_index[i].id == id) {
+        uint8_t rec[sizeof(nj_record_t) + sizeof(uint32_t)];
+        nj_record_t hdr = { .magic = NJ_MAGIC, .type = NJ_TYPE_DELETE, .id = s_next_id };
+        memcpy(rec + sizeof(hdr), &id, sizeof(id));
+        hdr.crc = record_crc(hdr, rec + sizeof(hdr), sizeof(id));
+        memcpy(rec, &hdr, sizeof(hdr));
+        err = write_record(rec, sizeof(rec), NULL);
+        if (err == ESP_OK) s_next_id++;
+        // The rotation in write_record may already have dropped it
+        i = index_find(id);
+        if (err == ESP_OK && i < s_count && s_index[i].id == id) index_remove_at(i);
+    }
+    xSemaphoreGive(s_lock);
+    return err;
+}
+
+esp_err_t notif_journal_clear(void)
+{
+    if (!s_lock) return ESP_ERR_INVALID_STATE;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int seg = 0; seg < NJ_SEGMENTS; ++seg) {
+        char path[NJ_PATH_MAX];
+        seg_path(path, sizeof(path), seg);
+        if (remove(path) == 0) settings_wear_note(SETTINGS_PART_STORAGE, 0, (s_seg_size[seg] + 4095) / 4096);
+        s_seg_size[seg] = 0;
+        s_seg_full[seg] = false;
+    }
+    settings_storage_changed();
+    s_count = 0;
+    s_active = 0;
+    s_next_id = 1;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
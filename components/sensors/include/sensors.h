@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include "esp_event.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +18,14 @@ uint32_t sensors_get_step_count(void);
 // Returns current activity classification
 sensors_activity_t sensors_get_activity(void);
 
+// Posted to the default event loop by sensors_task when a value changes
+ESP_EVENT_DECLARE_BASE(SENSORS_EVENT_BASE);
+
+typedef enum {
+    SENSORS_EVT_STEPS = 1,      // uint32_t: daily step count
+    SENSORS_EVT_ACTIVITY = 2,   // sensors_activity_t
+} sensors_event_id_t;
+
 #ifdef __cplusplus
 }
 #endif
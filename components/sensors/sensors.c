@@ -25,6 +25,8 @@
 
 static const char *TAG = "SENSORS";
 
+ESP_EVENT_DEFINE_BASE(SENSORS_EVENT_BASE);
+
 static qmi8658_dev_t s_imu;
 static bool s_imu_ready = false;
 static volatile uint32_t s_step_count = 0; // daily steps
@@ -32,6 +34,18 @@ static sensors_activity_t s_activity = SENSORS_ACTIVITY_IDLE;
 static SemaphoreHandle_t s_wom_sem = NULL; // wake-on-motion semaphore
 static time_t s_last_midnight = 0;
 
+static void post_steps(void) {
+  uint32_t steps = s_step_count;
+  (void)esp_event_post(SENSORS_EVENT_BASE, SENSORS_EVT_STEPS, &steps, sizeof(steps), 0);
+}
+
+static void set_activity(sensors_activity_t act) {
+  if (act == s_activity)
+    return;
+  s_activity = act;
+  (void)esp_event_post(SENSORS_EVENT_BASE, SENSORS_EVT_ACTIVITY, &act, sizeof(act), 0);
+}
+
 static time_t get_midnight_epoch(time_t now) {
   struct tm tm_now;
   localtime_r(&now, &tm_now);
@@ -50,6 +64,7 @@ static void maybe_reset_daily_counter(void) {
   if (midnight_now > s_last_midnight) {
     s_last_midnight = midnight_now;
     s_step_count = 0;
+    post_steps();
     ESP_LOGI(TAG, "Daily step counter reset at midnight");
   }
 }
@@ -193,6 +208,7 @@ void sensors_task(void *pvParameters) {
       if (lp > THRESH && dt > 280 && dt < 2000) {
         if (ready_for_next_peak) {
           s_step_count++;
+          post_steps();
           // cadence buffer
           step_ts_ms[step_ts_idx] = now_ms;
           step_ts_idx = (step_ts_idx + 1) & 7;
@@ -215,15 +231,15 @@ void sensors_task(void *pvParameters) {
           spm = 60000.0f * (float)(step_ts_num - 1) / (float)span_ms;
         }
         if (spm > 130.0f)
-          s_activity = SENSORS_ACTIVITY_RUN;
+          set_activity(SENSORS_ACTIVITY_RUN);
         else if (spm > 60.0f)
-          s_activity = SENSORS_ACTIVITY_WALK;
+          set_activity(SENSORS_ACTIVITY_WALK);
         else if (spm > 10.0f)
-          s_activity = SENSORS_ACTIVITY_OTHER;
+          set_activity(SENSORS_ACTIVITY_OTHER);
         else
-          s_activity = SENSORS_ACTIVITY_IDLE;
+          set_activity(SENSORS_ACTIVITY_IDLE);
       } else {
-        s_activity = SENSORS_ACTIVITY_IDLE;
+        set_activity(SENSORS_ACTIVITY_IDLE);
       }
 
       // Raise-to-wake: compute pitch angle from accel (degrees)
@@ -1,6 +1,7 @@
 #pragma once
 #include <stdbool.h>
 #include <stdint.h>
+#include "esp_event.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -10,7 +11,12 @@ extern "C" {
 #define SETTINGS_DISPLAY_TIMEOUT_30S 30000
 #define SETTINGS_DISPLAY_TIMEOUT_1MIN 60000
 
+// Loads the record and mounts /spiffs; touches no other hardware, so it
+// can run while the display and the RTC come up
 void settings_init(void);
+// Applies the brightness and starts the RTC (setting a default time if it
+// was never set). Call after bsp_display_start() and bsp_extra_init().
+void settings_apply_hw(void);
 void settings_set_brightness(uint8_t level);
 uint8_t settings_get_brightness(void);
 void settings_set_display_timeout(uint32_t timeout);
@@ -24,10 +30,72 @@ bool settings_get_bluetooth_enabled(void);
 void settings_set_notify_volume(uint8_t vol_percent);
 uint8_t settings_get_notify_volume(void);
 
-// Persist settings to SPIFFS JSON and load from it
+// Persist settings (binary A/B record in NVS) and load them. settings_save
+// writes only if a field changed since the last commit.
 bool settings_save(void);
 bool settings_load(void);
 
+// Setters don't write flash themselves: changes are merged and committed
+// once they have been quiet for 2 s (15 s at most after the first one).
+// settings_flush commits pending changes and the wear counters now; it runs
+// on display off and from a shutdown handler on esp_restart(). Call it
+// before esp_deep_sleep_start().
+bool settings_flush(void);
+
+// Settings as a JSON object ({"brightness":..,"step_goal":..}) for BLE
+// config. Export returns a heap string (free with free()); import applies
+// the keys present, with the setters' range checks, and commits.
+char *settings_export_json(void);
+bool settings_import_json(const char *json);
+
+// Per-field dirty bits
+#define SETTINGS_F_BRIGHTNESS      (1u << 0)
+#define SETTINGS_F_DISPLAY_TIMEOUT (1u << 1)
+#define SETTINGS_F_SOUND           (1u << 2)
+#define SETTINGS_F_BLUETOOTH       (1u << 3)
+#define SETTINGS_F_NOTIFY_VOLUME   (1u << 4)
+#define SETTINGS_F_STEP_GOAL       (1u << 5)
+#define SETTINGS_F_ALL             0x3Fu
+
+// Posted to the default event loop when a setter changes a value (and on
+// settings_reset_defaults); the data is the uint32_t SETTINGS_F_* mask
+ESP_EVENT_DECLARE_BASE(SETTINGS_EVENT_BASE);
+#define SETTINGS_EVT_CHANGED 1
+
+typedef struct {
+    uint32_t load_us;           // boot-time load of the record (both slots)
+    uint32_t record_bytes;      // size of one stored record
+    uint32_t seq;               // sequence number of the newest record
+    uint8_t slot;               // slot holding it: 0 = A, 1 = B
+    bool migrated;              // settings.json was imported this boot
+    uint32_t dirty;             // SETTINGS_F_* not yet committed
+    uint32_t commits;           // records written since boot
+    uint32_t last_commit_bytes; // flash bytes the last commit wrote (NVS entries)
+    uint32_t bytes_written;     // flash bytes written by commits since boot
+    uint32_t changes;           // setter calls that changed a value since boot
+} settings_store_stats_t;
+
+void settings_get_store_stats(settings_store_stats_t *out);
+
+// Flash wear per partition, persisted across reboots. erases counts 4 KB
+// sector erases: formats, plus one per 4 KB written (NVS and SPIFFS
+// program a sector once between erases).
+typedef enum {
+    SETTINGS_PART_NVS = 0,
+    SETTINGS_PART_STORAGE,      // SPIFFS at /spiffs
+    SETTINGS_PART_COUNT
+} settings_part_t;
+
+typedef struct {
+    uint64_t bytes_written;
+    uint32_t erases;
+} settings_wear_t;
+
+// Account for a write to a partition; writers outside this component call
+// it for data they put on /spiffs
+void settings_wear_note(settings_part_t part, uint32_t bytes, uint32_t erases);
+void settings_get_wear(settings_part_t part, settings_wear_t *out);
+
 // Step goal (daily steps target)
 void settings_set_step_goal(uint32_t steps);
 uint32_t settings_get_step_goal(void);
@@ -35,9 +103,20 @@ uint32_t settings_get_step_goal(void);
 // Restore factory defaults and persist
 bool settings_reset_defaults(void);
 
-// Maintenance: format SPIFFS storage partition
+// Maintenance: format the storage partition (mounted at /spiffs)
 bool settings_format_spiffs(void);
 
+// Filesystem on the storage partition: "SPIFFS" or "LittleFS"
+const char *settings_storage_fs_name(void);
+
+// Generation of the storage partition's contents. Writers call
+// settings_storage_changed() after they create, replace, rename or remove a
+// file on /spiffs, and a format bumps it too; appending to a file that only
+// its owner reads does not. Caches of listings, stats or file data compare
+// settings_storage_generation() with the value they were filled at.
+void settings_storage_changed(void);
+uint32_t settings_storage_generation(void);
+
 #ifdef __cplusplus
 }
 #endif
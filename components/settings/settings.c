@@ -1,6 +1,7 @@
 #include "settings.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_event.h"
 #include "bsp/display.h"
 #include "bsp/esp32_s3_touch_amoled_2_06.h"
 #include "bsp_board_extra.h"
@@ -8,13 +9,29 @@
 #include <time.h>
 #include <stdio.h>
 #include <sys/stat.h>
+#include "sdkconfig.h"
+#if CONFIG_SETTINGS_STORAGE_LITTLEFS
+#include "esp_littlefs.h"
+#else
 #include "esp_spiffs.h"
+#endif
 #include "lvgl.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/timers.h"
+#include "freertos/semphr.h"
 #include "cJSON.h"
+#include "esp_rom_crc.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <stddef.h>
+#include <string.h>
 
 static const char *TAG = "SETTINGS";
+
+ESP_EVENT_DEFINE_BASE(SETTINGS_EVENT_BASE);
+
 static uint8_t brightness = 30;
 static uint32_t display_timeout_ms = 30000;
 static bool sound_enabled = true;
@@ -23,53 +40,486 @@ static uint8_t notify_volume = 100; // percent 0..100 (louder default)
 static uint32_t step_goal = 8000;
 static bool spiffs_ready = false;
 
-// Debounced save timer (to limit flash writes when sliders change)
+// Commit scheduler. Setters only mark fields dirty and stamp the time; one
+// timer commits once changes have been quiet for SETTINGS_IDLE_MS, and no
+// later than SETTINGS_MAX_DELAY_MS after the first of them, so a slider drag
+// ends up as a single record instead of one timer restart per step.
+// settings_flush() commits right away (display off, restart, deep sleep).
+#define SETTINGS_IDLE_MS      2000
+#define SETTINGS_MAX_DELAY_MS 15000
+// A failed commit is retried after SETTINGS_IDLE_MS, doubling up to this
+#define SETTINGS_RETRY_MAX_MS 60000
+
 static TimerHandle_t s_save_timer = NULL;
-// Forward declarations for internal JSON IO
-static bool settings_write_json(void);
-static bool settings_read_json(void);
+static SemaphoreHandle_t s_io_lock = NULL;   // serialises NVS writes
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_first_change_us = 0;        // 0: nothing waiting for the timer
+static int64_t s_last_change_us = 0;
+static uint32_t s_retry_ms = 0;              // backoff after a failed commit, 0 after a good one
+static settings_store_stats_t s_stats;
+static bool settings_commit(void);
+static bool settings_read_record(void);
+static bool settings_import_legacy_json(void);
 static void save_timer_cb(TimerHandle_t xTimer)
 {
-    (void)xTimer;
-    (void)settings_write_json();
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    int64_t first = s_first_change_us;
+    int64_t last = s_last_change_us;
+    portEXIT_CRITICAL(&s_lock);
+    if (!first) return;
+    int64_t quiet_ms = (now - last) / 1000;
+    int64_t left_ms = SETTINGS_MAX_DELAY_MS - (now - first) / 1000;
+    if (quiet_ms < SETTINGS_IDLE_MS && left_ms > 0) {
+        // Still changing: look again when it would have gone quiet
+        int64_t wait_ms = SETTINGS_IDLE_MS - quiet_ms;
+        if (wait_ms > left_ms) wait_ms = left_ms;
+        TickType_t ticks = pdMS_TO_TICKS(wait_ms);
+        (void)xTimerChangePeriod(xTimer, ticks ? ticks : 1, 0);
+        return;
+    }
+    (void)settings_commit();
 }
-static void schedule_save(void)
+static void arm_save_timer(uint32_t ms, bool restart)
 {
-    const TickType_t delay_ticks = pdMS_TO_TICKS(10000); // 10 seconds
     if (!s_save_timer) {
-        s_save_timer = xTimerCreate("settings_save", delay_ticks, pdFALSE, NULL, save_timer_cb);
+        s_save_timer = xTimerCreate("settings_save", pdMS_TO_TICKS(SETTINGS_IDLE_MS), pdFALSE, NULL, save_timer_cb);
     }
     if (!s_save_timer) return;
-    // Restart (or start) timer with 10s
-    (void)xTimerStop(s_save_timer, 0);
-    (void)xTimerChangePeriod(s_save_timer, delay_ticks, 0);
-    (void)xTimerStart(s_save_timer, 0);
+    // Only arm an idle timer unless told otherwise; a running one re-arms
+    // itself from the callback
+    if (restart || xTimerIsTimerActive(s_save_timer) == pdFALSE) {
+        (void)xTimerChangePeriod(s_save_timer, pdMS_TO_TICKS(ms), 0);
+    }
+}
+static void schedule_save(void)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    if (!s_first_change_us) s_first_change_us = now;
+    s_last_change_us = now;
+    s_stats.changes++;
+    portEXIT_CRITICAL(&s_lock);
+    arm_save_timer(SETTINGS_IDLE_MS, false);
+}
+// A commit failed: put its fields and its first-change stamp back and try
+// again later, backing off while NVS keeps failing
+static void schedule_retry(uint32_t dirty, int64_t first_change_us)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_dirty |= dirty;
+    if (!s_first_change_us || first_change_us < s_first_change_us) s_first_change_us = first_change_us;
+    s_retry_ms = s_retry_ms ? s_retry_ms * 2 : SETTINGS_IDLE_MS;
+    if (s_retry_ms > SETTINGS_RETRY_MAX_MS) s_retry_ms = SETTINGS_RETRY_MAX_MS;
+    uint32_t wait_ms = s_retry_ms;
+    portEXIT_CRITICAL(&s_lock);
+    arm_save_timer(wait_ms, true);
+}
+
+// ---- Binary record ---------------------------------------------------------
+// Settings live in NVS as a fixed binary record, written alternately to two
+// keys (A/B). Each record carries a sequence number and a CRC, so a write
+// cut short by power loss leaves the other slot intact and boot picks the
+// newest valid one. Fields are only ever appended: an older, shorter record
+// still loads, and the missing fields keep their defaults.
+
+#define SETTINGS_NVS_NS      "settings"
+#define SETTINGS_REC_MAGIC   0x31544553u // "SET1"
+#define SETTINGS_REC_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t len;       // whole record including the trailing CRC
+    uint32_t seq;
+} settings_rec_hdr_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t display_timeout_ms;
+    uint32_t step_goal;
+    uint8_t brightness;
+    uint8_t sound_enabled;
+    uint8_t bluetooth_enabled;
+    uint8_t notify_volume;
+} settings_rec_body_t;
+
+typedef struct __attribute__((packed)) {
+    settings_rec_hdr_t hdr;
+    settings_rec_body_t body;
+    uint32_t crc;       // esp_rom_crc32_le over everything before it
+} settings_rec_t;
+
+static const char *const s_slot_keys[2] = { "rec_a", "rec_b" };
+static nvs_handle_t s_nvs = 0;
+static int s_slot = -1;         // slot holding the newest valid record
+static uint32_t s_seq = 0;
+static uint32_t s_dirty = 0;    // SETTINGS_F_* changed since the last commit
+
+static const char *const s_field_names[] = {
+    "brightness", "display_timeout_ms", "sound_enabled", "bluetooth_enabled", "notify_volume", "step_goal",
+};
+
+static void mark_dirty(uint32_t field)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_dirty |= field;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// Setter changed a value: commit it later and tell whoever shows it
+static void field_changed(uint32_t field)
+{
+    mark_dirty(field);
+    schedule_save();
+    (void)esp_event_post(SETTINGS_EVENT_BASE, SETTINGS_EVT_CHANGED, &field, sizeof(field), 0);
+}
+
+// NVS stores a blob as an index entry plus a data entry and its payload, all
+// in 32-byte units
+static uint32_t nvs_blob_cost(size_t len)
+{
+    return 32u * (2u + (uint32_t)((len + 31) / 32));
+}
+
+static bool settings_open_nvs(void)
+{
+    if (s_nvs) return true;
+    if (!s_io_lock) s_io_lock = xSemaphoreCreateMutex();
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_LOGW(TAG, "NVS partition needs erase (%s)", esp_err_to_name(err));
+        if (nvs_flash_erase() == ESP_OK) err = nvs_flash_init();
+    }
+    if (err == ESP_OK) err = nvs_open(SETTINGS_NVS_NS, NVS_READWRITE, &s_nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS unavailable: %s", esp_err_to_name(err));
+        s_nvs = 0;
+        return false;
+    }
+    return true;
+}
+
+// Reads one slot; true if it holds a valid record (body copied into `out`)
+static bool read_slot(int slot, settings_rec_body_t *out, uint32_t *seq)
+{
+    uint8_t buf[sizeof(settings_rec_t) + 64];
+    size_t len = sizeof(buf);
+    if (nvs_get_blob(s_nvs, s_slot_keys[slot], buf, &len) != ESP_OK) return false;
+    settings_rec_hdr_t hdr;
+    if (len < sizeof(hdr) + sizeof(uint32_t)) return false;
+    memcpy(&hdr, buf, sizeof(hdr));
+    if (hdr.magic != SETTINGS_REC_MAGIC || hdr.len != len) return false;
+    uint32_t crc;
+    memcpy(&crc, buf + len - sizeof(crc), sizeof(crc));
+    if (esp_rom_crc32_le(0, buf, len - sizeof(crc)) != crc) {
+        ESP_LOGW(TAG, "Settings slot %c: CRC mismatch", 'A' + slot);
+        return false;
+    }
+    size_t body_len = len - sizeof(hdr) - sizeof(crc);
+    if (body_len > sizeof(*out)) body_len = sizeof(*out); // written by newer firmware
+    memcpy(out, buf + sizeof(hdr), body_len);
+    *seq = hdr.seq;
+    return true;
+}
+
+static bool settings_read_record(void)
+{
+    if (!settings_open_nvs()) return false;
+    int64_t t0 = esp_timer_get_time();
+    settings_rec_body_t body[2];
+    uint32_t seq[2] = { 0, 0 };
+    bool ok[2];
+    for (int i = 0; i < 2; ++i) {
+        // Defaults first so fields missing from an older record keep them
+        body[i] = (settings_rec_body_t){
+            .display_timeout_ms = display_timeout_ms,
+            .step_goal = step_goal,
+            .brightness = brightness,
+            .sound_enabled = sound_enabled,
+            .bluetooth_enabled = bluetooth_enabled,
+            .notify_volume = notify_volume,
+        };
+        ok[i] = read_slot(i, &body[i], &seq[i]);
+    }
+    if (!ok[0] && !ok[1]) return false;
+    // Newest valid slot wins; the comparison survives seq wrap-around
+    int slot = (ok[0] && (!ok[1] || (int32_t)(seq[0] - seq[1]) > 0)) ? 0 : 1;
+    const settings_rec_body_t *b = &body[slot];
+    brightness = b->brightness;
+    display_timeout_ms = b->display_timeout_ms;
+    sound_enabled = b->sound_enabled != 0;
+    bluetooth_enabled = b->bluetooth_enabled != 0;
+    notify_volume = b->notify_volume > 100 ? 100 : b->notify_volume;
+    step_goal = b->step_goal;
+    s_slot = slot;
+    s_seq = seq[slot];
+    s_stats.load_us = (uint32_t)(esp_timer_get_time() - t0);
+    s_stats.slot = (uint8_t)slot;
+    s_stats.seq = s_seq;
+    ESP_LOGI(TAG, "Settings loaded from slot %c (seq %lu) in %lu us: br=%u, to=%u, sound=%d", 'A' + slot,
+             (unsigned long)s_seq, (unsigned long)s_stats.load_us, (unsigned)brightness,
+             (unsigned)display_timeout_ms, (int)sound_enabled);
+    return true;
+}
+
+// Writes the current values to the older slot if anything changed
+static bool settings_commit_locked(void)
+{
+    settings_rec_t rec;
+    uint32_t dirty;
+    int64_t first_change_us;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    dirty = s_dirty;
+    s_dirty = 0;
+    first_change_us = s_first_change_us ? s_first_change_us : now;
+    s_first_change_us = 0;
+    rec.body = (settings_rec_body_t){
+        .display_timeout_ms = display_timeout_ms,
+        .step_goal = step_goal,
+        .brightness = brightness,
+        .sound_enabled = sound_enabled,
+        .bluetooth_enabled = bluetooth_enabled,
+        .notify_volume = notify_volume,
+    };
+    portEXIT_CRITICAL(&s_lock);
+    if (!dirty) return true;
+
+    int slot = s_slot == 0 ? 1 : 0;
+    rec.hdr = (settings_rec_hdr_t){
+        .magic = SETTINGS_REC_MAGIC,
+        .version = SETTINGS_REC_VERSION,
+        .len = sizeof(rec),
+        .seq = s_seq + 1,
+    };
+    rec.crc = esp_rom_crc32_le(0, (const uint8_t *)&rec, offsetof(settings_rec_t, crc));
+    esp_err_t err = nvs_set_blob(s_nvs, s_slot_keys[slot], &rec, sizeof(rec));
+    if (err == ESP_OK) err = nvs_commit(s_nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Settings commit to slot %c failed: %s", 'A' + slot, esp_err_to_name(err));
+        schedule_retry(dirty, first_change_us);
+        return false;
+    }
+    portENTER_CRITICAL(&s_lock);
+    s_retry_ms = 0;
+    portEXIT_CRITICAL(&s_lock);
+    s_slot = slot;
+    s_seq = rec.hdr.seq;
+
+    uint32_t bytes = nvs_blob_cost(sizeof(rec));
+    settings_wear_note(SETTINGS_PART_NVS, bytes, 0);
+    s_stats.slot = (uint8_t)slot;
+    s_stats.seq = s_seq;
+    s_stats.commits++;
+    s_stats.last_commit_bytes = bytes;
+    s_stats.bytes_written += bytes;
+
+    char names[96] = "";
+    size_t pos = 0;
+    for (size_t i = 0; i < sizeof(s_field_names) / sizeof(s_field_names[0]); ++i) {
+        if ((dirty & (1u << i)) && pos < sizeof(names)) {
+            pos += snprintf(names + pos, sizeof(names) - pos, "%s%s", pos ? "," : "", s_field_names[i]);
+        }
+    }
+    ESP_LOGI(TAG, "Settings committed to slot %c (seq %lu, %lu changes so far, ~%lu B flash): %s", 'A' + slot,
+             (unsigned long)s_seq, (unsigned long)s_stats.changes, (unsigned long)bytes, names);
+    return true;
+}
+
+static bool settings_commit(void)
+{
+    if (!settings_open_nvs()) return false;
+    xSemaphoreTake(s_io_lock, portMAX_DELAY);
+    bool ok = settings_commit_locked();
+    xSemaphoreGive(s_io_lock);
+    return ok;
+}
+
+// ---- Flash wear ------------------------------------------------------------
+// Bytes written and sector erases per partition, kept across reboots in one
+// more NVS blob. Both NVS and SPIFFS program a 4 KB sector once between
+// erases, so every 4 KB written counts as an erase on top of explicit ones
+// (formats). The blob is only rewritten from settings_flush().
+
+#define SETTINGS_WEAR_KEY    "wear"
+#define SETTINGS_WEAR_MAGIC  0x31414557u // "WEA1"
+#define SETTINGS_SECTOR_SIZE 4096u
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    struct __attribute__((packed)) {
+        uint64_t bytes_written;
+        uint32_t erases;
+    } part[SETTINGS_PART_COUNT];
+    uint32_t crc;
+} settings_wear_rec_t;
+
+static settings_wear_t s_wear[SETTINGS_PART_COUNT];
+static bool s_wear_dirty = false;
+
+void settings_wear_note(settings_part_t part, uint32_t bytes, uint32_t erases)
+{
+    if ((unsigned)part >= SETTINGS_PART_COUNT || (!bytes && !erases)) return;
+    portENTER_CRITICAL(&s_lock);
+    settings_wear_t *w = &s_wear[part];
+    w->erases += erases + (uint32_t)(((w->bytes_written % SETTINGS_SECTOR_SIZE) + bytes) / SETTINGS_SECTOR_SIZE);
+    w->bytes_written += bytes;
+    s_wear_dirty = true;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void settings_get_wear(settings_part_t part, settings_wear_t *out)
+{
+    if (!out) return;
+    if ((unsigned)part >= SETTINGS_PART_COUNT) {
+        *out = (settings_wear_t){ 0 };
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    *out = s_wear[part];
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// Adds the stored totals to whatever this boot has counted already
+static void settings_wear_load(void)
+{
+    if (!settings_open_nvs()) return;
+    settings_wear_rec_t rec;
+    size_t len = sizeof(rec);
+    if (nvs_get_blob(s_nvs, SETTINGS_WEAR_KEY, &rec, &len) != ESP_OK || len != sizeof(rec)) return;
+    if (rec.magic != SETTINGS_WEAR_MAGIC ||
+        esp_rom_crc32_le(0, (const uint8_t *)&rec, offsetof(settings_wear_rec_t, crc)) != rec.crc) {
+        ESP_LOGW(TAG, "Wear counters invalid; starting over");
+        return;
+    }
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SETTINGS_PART_COUNT; ++i) {
+        s_wear[i].bytes_written += rec.part[i].bytes_written;
+        s_wear[i].erases += rec.part[i].erases;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+static bool settings_wear_persist_locked(void)
+{
+    if (!s_wear_dirty) return true;
+    settings_wear_rec_t rec;
+    // This write wears NVS too; count it before taking the snapshot
+    settings_wear_note(SETTINGS_PART_NVS, nvs_blob_cost(sizeof(rec)), 0);
+    portENTER_CRITICAL(&s_lock);
+    rec.magic = SETTINGS_WEAR_MAGIC;
+    for (int i = 0; i < SETTINGS_PART_COUNT; ++i) {
+        rec.part[i].bytes_written = s_wear[i].bytes_written;
+        rec.part[i].erases = s_wear[i].erases;
+    }
+    s_wear_dirty = false;
+    portEXIT_CRITICAL(&s_lock);
+    rec.crc = esp_rom_crc32_le(0, (const uint8_t *)&rec, offsetof(settings_wear_rec_t, crc));
+    esp_err_t err = nvs_set_blob(s_nvs, SETTINGS_WEAR_KEY, &rec, sizeof(rec));
+    if (err == ESP_OK) err = nvs_commit(s_nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Saving wear counters failed: %s", esp_err_to_name(err));
+        s_wear_dirty = true;
+        return false;
+    }
+    return true;
+}
+
+bool settings_flush(void)
+{
+    if (s_save_timer) (void)xTimerStop(s_save_timer, 0);
+    if (!settings_open_nvs()) return false;
+    xSemaphoreTake(s_io_lock, portMAX_DELAY);
+    bool ok = settings_commit_locked();
+    ok = settings_wear_persist_locked() && ok;
+    xSemaphoreGive(s_io_lock);
+    return ok;
+}
+
+static void settings_shutdown_handler(void)
+{
+    (void)settings_flush();
+}
+
+void settings_get_store_stats(settings_store_stats_t *out)
+{
+    if (!out) return;
+    *out = s_stats;
+    out->record_bytes = sizeof(settings_rec_t);
+    out->dirty = s_dirty;
 }
 
 #define SETTINGS_PARTITION "storage"
 #define SETTINGS_FILE      "/spiffs/settings.json"
 
-static bool settings_mount_spiffs(void)
+// The storage partition holds SPIFFS or LittleFS (CONFIG_SETTINGS_STORAGE_*).
+// Either is mounted at /spiffs so paths elsewhere don't depend on the choice.
+#if CONFIG_SETTINGS_STORAGE_LITTLEFS
+#define STORAGE_FS_NAME "LittleFS"
+static esp_err_t storage_register(bool format)
+{
+    esp_vfs_littlefs_conf_t conf = {
+        .base_path = "/spiffs",
+        .partition_label = SETTINGS_PARTITION,
+        .format_if_mount_failed = format,
+    };
+    return esp_vfs_littlefs_register(&conf);
+}
+static esp_err_t storage_unregister(void) { return esp_vfs_littlefs_unregister(SETTINGS_PARTITION); }
+static esp_err_t storage_format(void) { return esp_littlefs_format(SETTINGS_PARTITION); }
+static esp_err_t storage_info(size_t *total, size_t *used) { return esp_littlefs_info(SETTINGS_PARTITION, total, used); }
+#else
+#define STORAGE_FS_NAME "SPIFFS"
+static esp_err_t storage_register(bool format)
 {
-    if (spiffs_ready) return true;
-    // First try to mount without formatting
     esp_vfs_spiffs_conf_t conf = {
         .base_path = "/spiffs",
         .partition_label = SETTINGS_PARTITION,
-        .max_files = 4,
-        .format_if_mount_failed = false,
+        .max_files = 8,   // the LVGL read cache keeps up to 3 files open
+        .format_if_mount_failed = format,
     };
-    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    return esp_vfs_spiffs_register(&conf);
+}
+static esp_err_t storage_unregister(void) { return esp_vfs_spiffs_unregister(SETTINGS_PARTITION); }
+static esp_err_t storage_format(void) { return esp_spiffs_format(SETTINGS_PARTITION); }
+static esp_err_t storage_info(size_t *total, size_t *used) { return esp_spiffs_info(SETTINGS_PARTITION, total, used); }
+#endif
+
+const char *settings_storage_fs_name(void)
+{
+    return STORAGE_FS_NAME;
+}
+
+// Starts at 1 so a cache that zero-initialised its copy misses once
+static uint32_t s_storage_gen = 1;
+
+void settings_storage_changed(void)
+{
+    __atomic_fetch_add(&s_storage_gen, 1, __ATOMIC_RELAXED);
+}
+
+uint32_t settings_storage_generation(void)
+{
+    return __atomic_load_n(&s_storage_gen, __ATOMIC_RELAXED);
+}
+
+static bool settings_mount_spiffs(void)
+{
+    if (spiffs_ready) return true;
+    // First try to mount without formatting
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t ret = storage_register(false);
     if (ret == ESP_OK) {
         size_t total = 0, used = 0;
-        if (esp_spiffs_info(SETTINGS_PARTITION, &total, &used) == ESP_OK) {
-            ESP_LOGI(TAG, "SPIFFS mounted: %u/%u bytes used", (unsigned)used, (unsigned)total);
+        if (storage_info(&total, &used) == ESP_OK) {
+            ESP_LOGI(TAG, STORAGE_FS_NAME " mounted in %lld ms: %u/%u bytes used",
+                     (long long)((esp_timer_get_time() - t0) / 1000), (unsigned)used, (unsigned)total);
         }
         spiffs_ready = true;
         return true;
     }
     // If mount failed, inform user and retry with format
-    ESP_LOGW(TAG, "SPIFFS mount failed (%s). Formatting...", esp_err_to_name(ret));
+    ESP_LOGW(TAG, STORAGE_FS_NAME " mount failed (%s). Formatting...", esp_err_to_name(ret));
     // Show a simple full-screen message while formatting, if LVGL is ready
     lv_obj_t* overlay = NULL;
     if (lv_disp_get_default() != NULL && bsp_display_lock(100)) {
@@ -88,8 +538,7 @@ static bool settings_mount_spiffs(void)
     }
 
     // Retry with format
-    conf.format_if_mount_failed = true;
-    ret = esp_vfs_spiffs_register(&conf);
+    ret = storage_register(true);
     if (overlay && bsp_display_lock(100)) {
         lv_obj_del(overlay);
         overlay = NULL;
@@ -98,54 +547,81 @@ static bool settings_mount_spiffs(void)
     }
     if (ret == ESP_OK) {
         size_t total = 0, used = 0;
-        (void)esp_spiffs_info(SETTINGS_PARTITION, &total, &used);
-        ESP_LOGI(TAG, "SPIFFS formatted and mounted: %u/%u bytes used", (unsigned)used, (unsigned)total);
+        (void)storage_info(&total, &used);
+        settings_wear_note(SETTINGS_PART_STORAGE, 0, total / SETTINGS_SECTOR_SIZE);
+        settings_storage_changed();
+        ESP_LOGI(TAG, STORAGE_FS_NAME " formatted and mounted: %u/%u bytes used", (unsigned)used, (unsigned)total);
         spiffs_ready = true;
         return true;
     }
-    ESP_LOGE(TAG, "Failed to format+mount SPIFFS (%s)", esp_err_to_name(ret));
+    ESP_LOGE(TAG, "Failed to format+mount " STORAGE_FS_NAME " (%s)", esp_err_to_name(ret));
     return false;
 }
 
-static bool settings_write_json(void)
+// ---- JSON ------------------------------------------------------------------
+// Same keys as the settings.json older firmware kept on SPIFFS; used for
+// BLE config and to migrate that file once.
+
+static cJSON *settings_to_cjson(void)
 {
-    if (!settings_mount_spiffs()) return false;
     cJSON *root = cJSON_CreateObject();
-    if (!root) return false;
+    if (!root) return NULL;
     cJSON_AddNumberToObject(root, "brightness", brightness);
     cJSON_AddNumberToObject(root, "display_timeout_ms", (double)display_timeout_ms);
     cJSON_AddBoolToObject(root, "sound_enabled", sound_enabled);
     cJSON_AddBoolToObject(root, "bluetooth_enabled", bluetooth_enabled);
     cJSON_AddNumberToObject(root, "notify_volume", (double)notify_volume);
     cJSON_AddNumberToObject(root, "step_goal", (double)step_goal);
+    return root;
+}
+
+// Optional fields; missing ones keep their current value. Goes through the
+// setters so imported values get the same range checks.
+static void settings_apply_cjson(const cJSON *root)
+{
+    cJSON *j;
+    j = cJSON_GetObjectItem(root, "brightness");
+    if (cJSON_IsNumber(j)) settings_set_brightness((uint8_t)j->valuedouble);
+    j = cJSON_GetObjectItem(root, "display_timeout_ms");
+    if (cJSON_IsNumber(j)) settings_set_display_timeout((uint32_t)j->valuedouble);
+    j = cJSON_GetObjectItem(root, "sound_enabled");
+    if (cJSON_IsBool(j)) settings_set_sound(cJSON_IsTrue(j));
+    j = cJSON_GetObjectItem(root, "bluetooth_enabled");
+    if (cJSON_IsBool(j)) settings_set_bluetooth_enabled(cJSON_IsTrue(j));
+    j = cJSON_GetObjectItem(root, "notify_volume");
+    if (cJSON_IsNumber(j)) settings_set_notify_volume((uint8_t)j->valuedouble);
+    j = cJSON_GetObjectItem(root, "step_goal");
+    if (cJSON_IsNumber(j)) settings_set_step_goal((uint32_t)j->valuedouble);
+}
 
+char *settings_export_json(void)
+{
+    cJSON *root = settings_to_cjson();
+    if (!root) return NULL;
     char *json_str = cJSON_PrintUnformatted(root);
     cJSON_Delete(root);
-    if (!json_str) return false;
+    return json_str;
+}
 
-    FILE *f = fopen(SETTINGS_FILE, "w");
-    if (!f) {
-        ESP_LOGE(TAG, "Failed to open %s for write", SETTINGS_FILE);
-        cJSON_free(json_str);
-        return false;
-    }
-    size_t n = fwrite(json_str, 1, strlen(json_str), f);
-    fclose(f);
-    cJSON_free(json_str);
-    if (n == 0) {
-        ESP_LOGE(TAG, "Failed to write settings to %s", SETTINGS_FILE);
+bool settings_import_json(const char *json)
+{
+    cJSON *root = json ? cJSON_Parse(json) : NULL;
+    if (!cJSON_IsObject(root)) {
+        cJSON_Delete(root);
         return false;
     }
-    ESP_LOGI(TAG, "Settings saved to %s", SETTINGS_FILE);
-    return true;
+    settings_apply_cjson(root);
+    cJSON_Delete(root);
+    return settings_commit();
 }
 
-static bool settings_read_json(void)
+// First boot after the move to NVS: take over settings.json, then drop it
+static bool settings_import_legacy_json(void)
 {
     if (!settings_mount_spiffs()) return false;
     struct stat st;
     if (stat(SETTINGS_FILE, &st) != 0 || st.st_size <= 0) {
-        ESP_LOGW(TAG, "Settings file not found; using defaults");
+        ESP_LOGW(TAG, "No stored settings; using defaults");
         return false;
     }
     FILE *f = fopen(SETTINGS_FILE, "r");
@@ -164,30 +640,27 @@ static bool settings_read_json(void)
         ESP_LOGE(TAG, "Failed to parse JSON settings");
         return false;
     }
-    // Optional fields; keep defaults if missing
-    cJSON *j;
-    j = cJSON_GetObjectItem(root, "brightness");
-    if (cJSON_IsNumber(j)) brightness = (uint8_t)j->valuedouble;
-    j = cJSON_GetObjectItem(root, "display_timeout_ms");
-    if (cJSON_IsNumber(j)) display_timeout_ms = (uint32_t)j->valuedouble;
-    j = cJSON_GetObjectItem(root, "sound_enabled");
-    if (cJSON_IsBool(j)) sound_enabled = cJSON_IsTrue(j);
-    j = cJSON_GetObjectItem(root, "bluetooth_enabled");
-    if (cJSON_IsBool(j)) bluetooth_enabled = cJSON_IsTrue(j);
-    j = cJSON_GetObjectItem(root, "notify_volume");
-    if (cJSON_IsNumber(j)) notify_volume = (uint8_t)j->valuedouble;
-    j = cJSON_GetObjectItem(root, "step_goal");
-    if (cJSON_IsNumber(j)) step_goal = (uint32_t)j->valuedouble;
+    settings_apply_cjson(root);
     cJSON_Delete(root);
-    // Apply to hardware where relevant
-    bsp_display_brightness_set(brightness);
-    ESP_LOGI(TAG, "Settings loaded: br=%u, to=%u, sound=%d", (unsigned)brightness, (unsigned)display_timeout_ms, (int)sound_enabled);
+    mark_dirty(SETTINGS_F_ALL);
+    if (!settings_commit()) return false;
+    s_stats.migrated = true;
+    remove(SETTINGS_FILE);
+    ESP_LOGI(TAG, "Migrated %s to NVS", SETTINGS_FILE);
     return true;
 }
 
 void settings_init(void) {
-    ESP_LOGI(TAG, "Settings init: mount + load JSON");
+    ESP_LOGI(TAG, "Settings init: load record + mount storage");
+    settings_wear_load();
     (void)settings_load();
+    // esp_restart() would otherwise drop changes still waiting for the timer
+    (void)esp_register_shutdown_handler(settings_shutdown_handler);
+    // Settings no longer need SPIFFS, but the rest of the firmware expects /spiffs mounted
+    (void)settings_mount_spiffs();
+}
+
+void settings_apply_hw(void) {
     // Ensure brightness is applied even if using defaults
     bsp_display_brightness_set(brightness);
 
@@ -211,9 +684,10 @@ void settings_init(void) {
 }
 
 void settings_set_brightness(uint8_t level) {
+    bsp_display_brightness_set(level);
+    if (brightness == level) return;
     brightness = level;
-    bsp_display_brightness_set(brightness);
-    schedule_save();
+    field_changed(SETTINGS_F_BRIGHTNESS);
 }
 
 uint8_t settings_get_brightness(void) {
@@ -221,9 +695,10 @@ uint8_t settings_get_brightness(void) {
 }
 
 void settings_set_display_timeout(uint32_t timeout) {
+    if (timeout == display_timeout_ms) return;
     if (timeout == 10000 || timeout == 20000 || timeout == 30000 || timeout == 60000) {
         display_timeout_ms = timeout;
-        schedule_save();
+        field_changed(SETTINGS_F_DISPLAY_TIMEOUT);
     }
 }
 
@@ -232,9 +707,10 @@ uint32_t settings_get_display_timeout(void) {
 }
 
 void settings_set_sound(bool enabled) {
+    if (sound_enabled == enabled) return;
     sound_enabled = enabled;
     ESP_LOGI(TAG, "Sound %s", enabled ? "enabled" : "disabled");
-    schedule_save();
+    field_changed(SETTINGS_F_SOUND);
 }
 
 bool settings_get_sound(void) {
@@ -248,7 +724,7 @@ void settings_set_bluetooth_enabled(bool enabled)
     }
     bluetooth_enabled = enabled;
     ESP_LOGI(TAG, "Bluetooth %s", enabled ? "enabled" : "disabled");
-    schedule_save();
+    field_changed(SETTINGS_F_BLUETOOTH);
 }
 
 bool settings_get_bluetooth_enabled(void)
@@ -259,8 +735,9 @@ bool settings_get_bluetooth_enabled(void)
 void settings_set_notify_volume(uint8_t vol_percent)
 {
     if (vol_percent > 100) vol_percent = 100;
+    if (notify_volume == vol_percent) return;
     notify_volume = vol_percent;
-    schedule_save();
+    field_changed(SETTINGS_F_NOTIFY_VOLUME);
 }
 
 uint8_t settings_get_notify_volume(void)
@@ -269,19 +746,20 @@ uint8_t settings_get_notify_volume(void)
 }
 
 bool settings_save(void) {
-    return settings_write_json();
+    return settings_flush();
 }
 
 bool settings_load(void) {
-    return settings_read_json();
+    return settings_read_record() || settings_import_legacy_json();
 }
 
 void settings_set_step_goal(uint32_t steps)
 {
     if (steps < 1000) steps = 1000;
     if (steps > 100000) steps = 100000;
+    if (step_goal == steps) return;
     step_goal = steps;
-    schedule_save();
+    field_changed(SETTINGS_F_STEP_GOAL);
 }
 
 uint32_t settings_get_step_goal(void)
@@ -304,14 +782,17 @@ bool settings_reset_defaults(void)
     apply_defaults();
     // Apply immediate effects
     bsp_display_brightness_set(brightness);
-    return settings_write_json();
+    mark_dirty(SETTINGS_F_ALL);
+    const uint32_t all = SETTINGS_F_ALL;
+    (void)esp_event_post(SETTINGS_EVENT_BASE, SETTINGS_EVT_CHANGED, &all, sizeof(all), 0);
+    return settings_commit();
 }
 
 bool settings_format_spiffs(void)
 {
     // Unregister if mounted
     if (spiffs_ready) {
-        esp_vfs_spiffs_unregister(SETTINGS_PARTITION);
+        storage_unregister();
         spiffs_ready = false;
     }
     // Show formatting overlay to avoid white screen
@@ -330,14 +811,19 @@ bool settings_format_spiffs(void)
         lv_refr_now(NULL);
         bsp_display_unlock();
     }
-    esp_err_t r = esp_spiffs_format(SETTINGS_PARTITION);
+    esp_err_t r = storage_format();
     if (r != ESP_OK) {
-        ESP_LOGE(TAG, "SPIFFS format failed: %s", esp_err_to_name(r));
+        ESP_LOGE(TAG, STORAGE_FS_NAME " format failed: %s", esp_err_to_name(r));
         if (overlay && bsp_display_lock(100)) { lv_obj_del(overlay); lv_refr_now(NULL); bsp_display_unlock(); }
         return false;
     }
-    // Remount and write defaults
-    bool ok = settings_mount_spiffs() && settings_write_json();
+    settings_storage_changed();
+    // Remount; settings themselves live in NVS and survive the format
+    bool ok = settings_mount_spiffs();
+    size_t total = 0, used = 0;
+    if (ok && storage_info(&total, &used) == ESP_OK) {
+        settings_wear_note(SETTINGS_PART_STORAGE, 0, total / SETTINGS_SECTOR_SIZE);
+    }
     if (overlay && bsp_display_lock(100)) { lv_obj_del(overlay); lv_refr_now(NULL); bsp_display_unlock(); }
     return ok;
 }
@@ -0,0 +1,411 @@
+// Alert sound decoders (components/audio_alert/src/alert_decoder.c) on the
+// host: CPU time per second of decoded audio and peak heap while decoding,
+// for the formats the watch plays from /spiffs.
+//
+// Without arguments it writes a 10 s test sound (a decaying chord over
+// noise) as 16-bit PCM and as IMA ADPCM WAV, at 22.05 kHz mono and 44.1 kHz
+// stereo, decodes each and checks the ADPCM result against the source.
+// With MP3 built in (ALERT_DECODER_MP3) it also decodes chord_22050_1.mp3,
+// the first 2 s of the 22.05 kHz mono sound encoded at 32 kbps by LAME,
+// and checks it against the source after finding the encoder delay. Files
+// given on the command line are decoded as well.
+//
+// Peak heap is a high-water mark over every allocation from opening the
+// file to closing it, the FILE and its stdio buffer included; "own" is
+// what the decoder reports for its own allocations (mem_bytes). The mark
+// needs glibc, which lets a program replace malloc; elsewhere it shows 0.
+//
+// Host CPU time is far below what the ESP32-S3 spends at 240 MHz; compare
+// formats with it, and expect the watch to need several times more.
+
+#include "alert_decoder.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#define TEST_SECONDS    10
+#define READ_FRAMES     1024    // what the audio task asks for per block
+#define MIN_CPU_S       0.3     // repeat decoding until this much CPU time
+#define MIN_SNR_DB      20.0
+#define MP3_SECONDS     2
+#define MP3_MAX_LAG     4096    // encoder delay and the Xing frame, in frames
+#define MIN_MP3_SNR_DB  15.0
+
+static const int16_t k_ima_step[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97,
+    107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428,
+    4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8_t k_ima_index[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+// ---- heap high-water mark -----------------------------------------------
+
+static size_t s_heap_now;
+static size_t s_heap_peak;
+
+#ifdef __GLIBC__
+// glibc's own entry points; stdio allocates through the replacements below
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* p, size_t size);
+extern void __libc_free(void* p);
+
+static void heap_add(void* p)
+{
+    if (!p) return;
+    s_heap_now += malloc_usable_size(p);
+    if (s_heap_now > s_heap_peak) s_heap_peak = s_heap_now;
+}
+
+static void heap_sub(void* p)
+{
+    if (!p) return;
+    const size_t n = malloc_usable_size(p);
+    s_heap_now = n < s_heap_now ? s_heap_now - n : 0;
+}
+
+void* malloc(size_t size)
+{
+    void* p = __libc_malloc(size);
+    heap_add(p);
+    return p;
+}
+
+void* calloc(size_t n, size_t size)
+{
+    void* p = __libc_calloc(n, size);
+    heap_add(p);
+    return p;
+}
+
+void* realloc(void* old, size_t size)
+{
+    heap_sub(old);
+    void* p = __libc_realloc(old, size);
+    // A failed realloc keeps the old block
+    heap_add(p ? p : (size ? old : NULL));
+    return p;
+}
+
+void free(void* p)
+{
+    heap_sub(p);
+    __libc_free(p);
+}
+#endif
+
+static double cpu_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void put16(FILE* f, uint16_t v)
+{
+    fputc(v & 0xff, f);
+    fputc(v >> 8, f);
+}
+
+static void put32(FILE* f, uint32_t v)
+{
+    put16(f, (uint16_t)v);
+    put16(f, (uint16_t)(v >> 16));
+}
+
+// ---- test sound ----------------------------------------------------------
+
+static int16_t* make_sound(int rate, int ch, size_t frames)
+{
+    int16_t* pcm = malloc(frames * ch * sizeof(int16_t));
+    if (!pcm) return NULL;
+    const double f[3] = { 523.25, 659.25, 783.99 };
+    unsigned seed = 1;
+    for (size_t n = 0; n < frames; ++n) {
+        const double t = (double)n / rate;
+        const double env = exp(-3.0 * fmod(t, 1.0));       // one strike per second
+        for (int c = 0; c < ch; ++c) {
+            double s = 0;
+            for (int k = 0; k < 3; ++k) s += sin(2 * M_PI * f[k] * (1 + 0.002 * c) * t) / 3;
+            seed = seed * 1103515245u + 12345u;
+            const double noise = ((seed >> 16) & 0x7fff) / 32768.0 - 0.5;
+            pcm[n * ch + c] = (int16_t)(20000 * env * s + 300 * noise);
+        }
+    }
+    return pcm;
+}
+
+static bool write_pcm_wav(const char* path, const int16_t* pcm, int rate, int ch, size_t frames)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    const uint32_t data = (uint32_t)(frames * ch * sizeof(int16_t));
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 36 + data);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 16);
+    put16(f, 1);
+    put16(f, (uint16_t)ch);
+    put32(f, (uint32_t)rate);
+    put32(f, (uint32_t)(rate * ch * 2));
+    put16(f, (uint16_t)(ch * 2));
+    put16(f, 16);
+    fwrite("data", 1, 4, f);
+    put32(f, data);
+    fwrite(pcm, 1, data, f);
+    return fclose(f) == 0;
+}
+
+static unsigned ima_encode(int* pred, int* index, int sample)
+{
+    int step = k_ima_step[*index];
+    int diff = sample - *pred;
+    unsigned nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    int vpdiff = step >> 3;
+    if (diff >= step) { nibble |= 4; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 2; diff -= step; vpdiff += step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 1; vpdiff += step; }
+    int p = (nibble & 8) ? *pred - vpdiff : *pred + vpdiff;
+    *pred = p > 32767 ? 32767 : p < -32768 ? -32768 : p;
+    int i = *index + k_ima_index[nibble];
+    *index = i < 0 ? 0 : i > 88 ? 88 : i;
+    return nibble;
+}
+
+// Same layout as `ffmpeg -c:a adpcm_ima_wav`: 4-byte header per channel,
+// then 4 bytes per channel in turn, 8 samples each
+static bool write_adpcm_wav(const char* path, const int16_t* pcm, int rate, int ch, size_t frames)
+{
+    const uint16_t align = (uint16_t)(512 * ch);
+    const size_t spb = (size_t)(align - 4 * ch) * 2 / ch + 1;
+    const size_t blocks = (frames + spb - 1) / spb;
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    const uint32_t data = (uint32_t)(blocks * align);
+    fwrite("RIFF", 1, 4, f);
+    put32(f, 4 + 28 + 12 + 8 + data);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put32(f, 20);
+    put16(f, 0x11);
+    put16(f, (uint16_t)ch);
+    put32(f, (uint32_t)rate);
+    put32(f, (uint32_t)((uint64_t)rate * align / spb));
+    put16(f, align);
+    put16(f, 4);
+    put16(f, 2);
+    put16(f, (uint16_t)spb);
+    fwrite("fact", 1, 4, f);
+    put32(f, 4);
+    put32(f, (uint32_t)frames);
+    fwrite("data", 1, 4, f);
+    put32(f, data);
+
+    int pred[2] = { 0 }, index[2] = { 0 };
+    for (size_t b = 0; b < blocks; ++b) {
+        const size_t base = b * spb;
+#define SAMPLE(i, c) ((base + (i)) < frames ? pcm[(base + (i)) * ch + (c)] : 0)
+        for (int c = 0; c < ch; ++c) {
+            pred[c] = SAMPLE(0, c);
+            put16(f, (uint16_t)pred[c]);
+            fputc(index[c], f);
+            fputc(0, f);
+        }
+        for (size_t i = 1; i < spb; i += 8) {
+            for (int c = 0; c < ch; ++c) {
+                for (int k = 0; k < 8; k += 2) {
+                    const unsigned lo = ima_encode(&pred[c], &index[c], SAMPLE(i + k, c));
+                    const unsigned hi = ima_encode(&pred[c], &index[c], SAMPLE(i + k + 1, c));
+                    fputc((int)(lo | hi << 4), f);
+                }
+            }
+        }
+#undef SAMPLE
+    }
+    return fclose(f) == 0;
+}
+
+// ---- decoding ------------------------------------------------------------
+
+typedef struct {
+    alert_dec_info_t info;
+    size_t frames;
+    double cpu_us_per_s;            // decode CPU per second of audio
+    double snr_db;                  // against `ref`, when given
+    long file_bytes;
+    size_t peak_bytes;              // heap high-water mark, open to close
+} result_t;
+
+static const char* fmt_name(alert_fmt_t fmt)
+{
+    return fmt == ALERT_FMT_PCM ? "PCM" : fmt == ALERT_FMT_ADPCM ? "IMA ADPCM" : "MP3";
+}
+
+static bool decode(const char* path, const int16_t* ref, size_t ref_frames, result_t* r)
+{
+    memset(r, 0, sizeof(*r));
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    r->file_bytes = (long)st.st_size;
+    int16_t* buf = malloc(READ_FRAMES * 2 * sizeof(int16_t));
+    if (!buf) return false;
+
+    double sig = 0, err = 0, cpu = 0;
+    int runs = 0;
+    do {
+        const double t0 = cpu_s();
+        const size_t heap_base = s_heap_now;
+        s_heap_peak = s_heap_now;
+        alert_dec_t* dec = alert_dec_open(path, &r->info);
+        if (!dec) {
+            free(buf);
+            return false;
+        }
+        size_t frames = 0, n;
+        while ((n = alert_dec_read(dec, buf, READ_FRAMES)) > 0) {
+            if (ref && !runs) {
+                const int ch = r->info.channels;
+                for (size_t i = 0; i < n * ch && frames + i / ch < ref_frames; ++i) {
+                    const double a = ref[frames * ch + i], d = buf[i] - a;
+                    sig += a * a;
+                    err += d * d;
+                }
+            }
+            frames += n;
+        }
+        alert_dec_close(dec);
+        cpu += cpu_s() - t0;
+        r->peak_bytes = s_heap_peak - heap_base;
+        r->frames = frames;
+        runs++;
+    } while (cpu < MIN_CPU_S && r->frames);
+    free(buf);
+
+    const double secs = (double)r->frames / r->info.sample_rate;
+    r->cpu_us_per_s = secs > 0 ? cpu / runs / secs * 1e6 : 0;
+    r->snr_db = !ref ? 0 : err > 0 ? 10 * log10(sig / err) : INFINITY;
+    return r->frames > 0;
+}
+
+#ifdef MP3_VECTOR
+// SNR of a mono file against `ref` at the lag that fits best; the encoder
+// delays its output and pads the end
+static double snr_at_best_lag(const char* path, const int16_t* ref, size_t ref_frames)
+{
+    alert_dec_info_t info;
+    alert_dec_t* dec = alert_dec_open(path, &info);
+    const size_t cap = ref_frames + 2 * MP3_MAX_LAG;
+    int16_t* out = malloc(cap * sizeof(int16_t));
+    size_t frames = 0, n;
+    while (dec && out && info.channels == 1 && (n = alert_dec_read(dec, out + frames, READ_FRAMES)) > 0) {
+        frames += n;
+        if (cap - frames < READ_FRAMES) break;
+    }
+    if (dec) alert_dec_close(dec);
+    double best = -INFINITY;
+    for (size_t lag = 0; out && lag < MP3_MAX_LAG && lag + ref_frames <= frames; ++lag) {
+        double sig = 0, err = 0;
+        for (size_t i = 0; i < ref_frames; ++i) {
+            const double a = ref[i], d = out[lag + i] - a;
+            sig += a * a;
+            err += d * d;
+        }
+        const double snr = err > 0 ? 10 * log10(sig / err) : INFINITY;
+        if (snr > best) best = snr;
+    }
+    free(out);
+    return best;
+}
+#endif
+
+static void print_result(const char* name, const result_t* r)
+{
+    const double secs = (double)r->frames / r->info.sample_rate;
+    printf("%-26s %-9s %5d Hz %d ch %6.2f s %8ld B %8.0f us %8.0fx %7zu B %7zu B", name, fmt_name(r->info.fmt),
+           r->info.sample_rate, r->info.channels, secs, r->file_bytes, r->cpu_us_per_s,
+           r->cpu_us_per_s > 0 ? 1e6 / r->cpu_us_per_s : 0, r->peak_bytes, r->info.mem_bytes);
+    if (isinf(r->snr_db)) printf("    exact");
+    else if (r->snr_db) printf(" %5.1f dB", r->snr_db);
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    printf("%-26s %-9s %14s %8s %10s %11s %9s %9s %9s %8s\n", "file", "format", "rate", "length", "size",
+           "CPU/s audio", "realtime", "peak heap", "own", "SNR");
+    bool ok = true;
+
+    static const struct { int rate, ch; } k_cfg[] = { { 22050, 1 }, { 44100, 2 } };
+    for (size_t i = 0; i < sizeof(k_cfg) / sizeof(k_cfg[0]); ++i) {
+        const int rate = k_cfg[i].rate, ch = k_cfg[i].ch;
+        const size_t frames = (size_t)rate * TEST_SECONDS;
+        int16_t* pcm = make_sound(rate, ch, frames);
+        char pcm_path[64], adpcm_path[64];
+        snprintf(pcm_path, sizeof(pcm_path), "bench_pcm_%d_%d.wav", rate, ch);
+        snprintf(adpcm_path, sizeof(adpcm_path), "bench_ima_%d_%d.wav", rate, ch);
+        result_t r;
+        if (!pcm || !write_pcm_wav(pcm_path, pcm, rate, ch, frames) ||
+            !write_adpcm_wav(adpcm_path, pcm, rate, ch, frames)) {
+            fprintf(stderr, "cannot write test files\n");
+            return 1;
+        }
+        if (!decode(pcm_path, pcm, frames, &r) || r.frames != frames) {
+            printf("%-26s FAILED\n", pcm_path);
+            ok = false;
+        } else {
+            print_result(pcm_path, &r);
+        }
+        // ADPCM pads the last block; the fact chunk is not used
+        if (!decode(adpcm_path, pcm, frames, &r) || r.frames < frames || r.snr_db < MIN_SNR_DB) {
+            printf("%-26s FAILED (%.1f dB)\n", adpcm_path, r.snr_db);
+            ok = false;
+        } else {
+            print_result(adpcm_path, &r);
+        }
+#ifdef MP3_VECTOR
+        if (rate == 22050 && ch == 1) {
+            const char* name = strrchr(MP3_VECTOR, '/') + 1;
+            const bool decoded = decode(MP3_VECTOR, NULL, 0, &r);
+            r.snr_db = decoded ? snr_at_best_lag(MP3_VECTOR, pcm, (size_t)rate * MP3_SECONDS) : 0;
+            if (!decoded || r.info.fmt != ALERT_FMT_MP3 || r.info.sample_rate != rate || r.info.channels != ch ||
+                r.frames < (size_t)rate * MP3_SECONDS || r.snr_db < MIN_MP3_SNR_DB) {
+                printf("%-26s FAILED (%.1f dB)\n", name, r.snr_db);
+                ok = false;
+            } else {
+                print_result(name, &r);
+            }
+        }
+#endif
+        free(pcm);
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        result_t r;
+        const char* name = strrchr(argv[i], '/') ? strrchr(argv[i], '/') + 1 : argv[i];
+        if (!decode(argv[i], NULL, 0, &r)) {
+            printf("%-26s FAILED\n", name);
+            ok = false;
+        } else {
+            print_result(name, &r);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+// Boot phase scheduler (components/boot_seq) on the pthread stand-in for
+// FreeRTOS: one worker thread per core, pinned tasks report their core.
+// Covers dependency order, independent phases overlapping, per-core
+// pinning, failures skipping the phases that need them, bad tables, a
+// failed worker create and the timeline.
+
+#include "boot_seq.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_RUN 16
+
+static int s_failures;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        s_failures++;
+    }
+}
+
+// What each phase of the current table did, by index
+static struct {
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    int64_t start_us[MAX_RUN];
+    int64_t end_us[MAX_RUN];
+    int core[MAX_RUN];
+    int runs[MAX_RUN];
+    int started;            // phases started so far
+} s_rec = { .m = PTHREAD_MUTEX_INITIALIZER, .c = PTHREAD_COND_INITIALIZER };
+
+static void rec_reset(void)
+{
+    pthread_mutex_lock(&s_rec.m);
+    memset(s_rec.start_us, 0, sizeof(s_rec.start_us));
+    memset(s_rec.end_us, 0, sizeof(s_rec.end_us));
+    memset(s_rec.runs, 0, sizeof(s_rec.runs));
+    for (int i = 0; i < MAX_RUN; ++i) s_rec.core[i] = -1;
+    s_rec.started = 0;
+    pthread_mutex_unlock(&s_rec.m);
+}
+
+static void rec_start(int i)
+{
+    pthread_mutex_lock(&s_rec.m);
+    s_rec.start_us[i] = esp_timer_get_time();
+    s_rec.core[i] = (int)xPortGetCoreID();
+    s_rec.runs[i]++;
+    s_rec.started++;
+    pthread_cond_broadcast(&s_rec.c);
+    pthread_mutex_unlock(&s_rec.m);
+}
+
+static void rec_end(int i)
+{
+    pthread_mutex_lock(&s_rec.m);
+    s_rec.end_us[i] = esp_timer_get_time();
+    pthread_mutex_unlock(&s_rec.m);
+}
+
+// Wait until `n` phases have started, at most `ms`; true if they did
+static bool wait_started(int n, int ms)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_mutex_lock(&s_rec.m);
+    int rc = 0;
+    while (s_rec.started < n && rc == 0) rc = pthread_cond_timedwait(&s_rec.c, &s_rec.m, &ts);
+    bool ok = s_rec.started >= n;
+    pthread_mutex_unlock(&s_rec.m);
+    return ok;
+}
+
+// Phase bodies; the index is in the name so one function serves a table.
+// Phases sleep a little so that order and overlap show in the times.
+#define PHASE(i, body)                                                  \
+    static esp_err_t phase_##i(void)                                    \
+    {                                                                   \
+        rec_start(i);                                                   \
+        esp_err_t err = ESP_OK;                                         \
+        body;                                                           \
+        rec_end(i);                                                     \
+        return err;                                                     \
+    }
+
+static esp_err_t s_result[MAX_RUN];     // what each phase returns
+static int s_rendezvous = -1;           // phases that wait for each other
+static int s_sleep_ms[MAX_RUN];
+
+#define BODY(i)                                                                     \
+    do {                                                                            \
+        if (s_rendezvous >= 0 && !wait_started(s_rendezvous, 2000)) err = ESP_FAIL; \
+        if (s_sleep_ms[i]) vTaskDelay(pdMS_TO_TICKS(s_sleep_ms[i]));                \
+        if (err == ESP_OK) err = s_result[i];                                       \
+    } while (0)
+
+PHASE(0, BODY(0))
+PHASE(1, BODY(1))
+PHASE(2, BODY(2))
+PHASE(3, BODY(3))
+PHASE(4, BODY(4))
+PHASE(5, BODY(5))
+PHASE(6, BODY(6))
+
+static esp_err_t (*const k_fn[])(void) = { phase_0, phase_1, phase_2, phase_3, phase_4, phase_5, phase_6 };
+
+static void setup(boot_seq_phase_t* t, size_t n)
+{
+    static const char* const k_names[] = { "p0", "p1", "p2", "p3", "p4", "p5", "p6" };
+    rec_reset();
+    s_rendezvous = -1;
+    for (size_t i = 0; i < n; ++i) {
+        t[i] = (boot_seq_phase_t){ .name = k_names[i], .fn = k_fn[i], .core = BOOT_SEQ_ANY_CORE };
+        s_result[i] = ESP_OK;
+        s_sleep_ms[i] = 0;
+    }
+}
+
+static bool ran_after(int later, int earlier)
+{
+    return s_rec.runs[later] && s_rec.runs[earlier] && s_rec.start_us[later] >= s_rec.end_us[earlier];
+}
+
+// The watch's table: display, board, storage, then settings after all
+// three, ui after settings, ble after ui, audio after board
+static void test_dependency_order(void)
+{
+    boot_seq_phase_t t[7];
+    setup(t, 7);
+    t[3].after = BOOT_SEQ_AFTER(0) | BOOT_SEQ_AFTER(1) | BOOT_SEQ_AFTER(2);
+    t[4].after = t[3].after | BOOT_SEQ_AFTER(3);
+    t[5].after = BOOT_SEQ_AFTER(2) | BOOT_SEQ_AFTER(4);
+    t[6].after = BOOT_SEQ_AFTER(1);
+    s_sleep_ms[0] = 40;
+    s_sleep_ms[1] = 5;
+    s_sleep_ms[2] = 20;
+    s_sleep_ms[4] = 10;
+
+    check(boot_seq_run(t, 7, 4096) == ESP_OK, "order: run");
+    bool once = true;
+    for (int i = 0; i < 7; ++i) once = once && s_rec.runs[i] == 1;
+    check(once, "order: every phase ran once");
+    check(ran_after(3, 0) && ran_after(3, 1) && ran_after(3, 2), "order: settings after all it needs");
+    check(ran_after(4, 0) && ran_after(4, 1) && ran_after(4, 2) && ran_after(4, 3), "order: ui after all it needs");
+    check(ran_after(5, 4) && ran_after(6, 1), "order: ble after ui, audio after board");
+    // Two workers and nothing pinned: audio needs no display, so it
+    // doesn't wait for the 40 ms display phase
+    check(s_rec.start_us[6] < s_rec.end_us[0], "order: independent phases run beside the display");
+}
+
+// Two phases that each wait for the other to start: only finish in time
+// when the two workers really run them at once
+static void test_overlap(void)
+{
+    boot_seq_phase_t t[2];
+    setup(t, 2);
+    s_rendezvous = 2;
+    check(boot_seq_run(t, 2, 4096) == ESP_OK, "overlap: independent phases run at the same time");
+}
+
+static void test_pinned(void)
+{
+    boot_seq_phase_t t[5];
+    setup(t, 5);
+    t[0].core = 1;
+    t[1].core = 0;
+    t[2].core = 1;
+    t[3].core = 0;
+    // Core 1's worker is busy with p0 while core 0's is free: p2 still
+    // waits for core 1
+    s_sleep_ms[0] = 30;
+    t[4].after = BOOT_SEQ_AFTER(1);
+
+    check(boot_seq_run(t, 5, 4096) == ESP_OK, "pinned: run");
+    check(s_rec.core[0] == 1 && s_rec.core[1] == 0 && s_rec.core[2] == 1 && s_rec.core[3] == 0,
+          "pinned: phases run on their core");
+    check(s_rec.runs[4] && (s_rec.core[4] == 0 || s_rec.core[4] == 1), "pinned: any-core phase runs");
+    check(ran_after(2, 0), "pinned: a phase waits for its core's worker");
+}
+
+static void test_failure(void)
+{
+    boot_seq_phase_t t[6];
+    setup(t, 6);
+    // p1 fails; p2 needs it, p3 needs p2, p4 needs p0 and p3; p5 only p0
+    t[1].after = BOOT_SEQ_AFTER(0);
+    t[2].after = BOOT_SEQ_AFTER(1);
+    t[3].after = BOOT_SEQ_AFTER(2);
+    t[4].after = BOOT_SEQ_AFTER(0) | BOOT_SEQ_AFTER(3);
+    t[5].after = BOOT_SEQ_AFTER(0);
+    s_result[1] = ESP_ERR_NOT_FOUND;
+    // A pinned phase behind the failure is skipped without its core
+    t[3].core = 1;
+
+    check(boot_seq_run(t, 6, 4096) == ESP_FAIL, "failure: run reports it");
+    check(s_rec.runs[0] == 1 && s_rec.runs[1] == 1, "failure: the failing phase ran");
+    check(!s_rec.runs[2], "failure: a phase whose dependency failed does not run");
+    check(!s_rec.runs[3] && !s_rec.runs[4], "failure: nor do the phases that need it in turn");
+    check(s_rec.runs[5] == 1, "failure: independent phases still run");
+
+    // A failure with nothing behind it
+    setup(t, 3);
+    t[1].after = BOOT_SEQ_AFTER(0);
+    s_result[2] = ESP_FAIL;
+    check(boot_seq_run(t, 3, 4096) == ESP_FAIL && s_rec.runs[0] && s_rec.runs[1] && s_rec.runs[2],
+          "failure: unrelated phases unaffected");
+}
+
+static void test_bad_tables(void)
+{
+    boot_seq_phase_t t[3];
+    setup(t, 3);
+    t[1].after = BOOT_SEQ_AFTER(1);
+    check(boot_seq_run(t, 3, 4096) == ESP_ERR_INVALID_ARG, "bad: phase needs itself");
+    t[1].after = BOOT_SEQ_AFTER(2);
+    check(boot_seq_run(t, 3, 4096) == ESP_ERR_INVALID_ARG, "bad: phase needs a later one");
+    t[1].after = 0;
+    t[2].fn = NULL;
+    check(boot_seq_run(t, 3, 4096) == ESP_ERR_INVALID_ARG, "bad: no function");
+    check(boot_seq_run(t, 0, 4096) == ESP_ERR_INVALID_ARG, "bad: empty table");
+    check(boot_seq_run(t, BOOT_SEQ_MAX_PHASES + 1, 4096) == ESP_ERR_INVALID_ARG, "bad: too many phases");
+    check(!s_rec.started, "bad: nothing ran");
+}
+
+static void test_worker_create_fails(void)
+{
+    boot_seq_phase_t t[2];
+    setup(t, 2);
+    t[0].core = 0;
+    // Core 0's worker starts, core 1's does not: p0 must not run alone
+    host_task_create_fail_at(2);
+    check(boot_seq_run(t, 2, 4096) == ESP_ERR_NO_MEM, "create: run reports no memory");
+    host_task_create_fail_at(0);
+    vTaskDelay(pdMS_TO_TICKS(20));
+    check(!s_rec.started, "create: no phase ran");
+    check(boot_seq_run(t, 2, 4096) == ESP_OK && s_rec.runs[0] == 1 && s_rec.runs[1] == 1,
+          "create: the next run works");
+}
+
+static esp_err_t phase_mark(void)
+{
+    boot_seq_mark("mark from a phase");
+    return ESP_OK;
+}
+
+static void test_timeline(void)
+{
+    boot_seq_event_t ev[BOOT_SEQ_MAX_EVENTS];
+    size_t n = boot_seq_get_timeline(ev, BOOT_SEQ_MAX_EVENTS);
+    check(n > 0 && ev[0].phase == false && strcmp(ev[0].name, "main") == 0, "timeline: first mark");
+    bool found = false, ends = true;
+    for (size_t i = 0; i < n; ++i) {
+        if (ev[i].phase) ends = ends && ev[i].end_us >= ev[i].start_us;
+        found = found || strcmp(ev[i].name, "p0") == 0;
+    }
+    check(found && ends, "timeline: phases with start and end");
+
+    // Fill it up: later events are dropped, not wrapped
+    const boot_seq_phase_t t[] = { { .name = "mark", .fn = phase_mark, .core = BOOT_SEQ_ANY_CORE } };
+    for (int i = 0; i < BOOT_SEQ_MAX_EVENTS; ++i) boot_seq_run(t, 1, 4096);
+    n = boot_seq_get_timeline(ev, BOOT_SEQ_MAX_EVENTS);
+    check(n == BOOT_SEQ_MAX_EVENTS && strcmp(ev[0].name, "main") == 0, "timeline: full table keeps the oldest");
+    check(boot_seq_get_timeline(ev, 3) == 3, "timeline: copies at most max");
+}
+
+int main(void)
+{
+    boot_seq_mark("main");
+    test_dependency_order();
+    test_overlap();
+    test_pinned();
+    test_failure();
+    test_bad_tables();
+    test_worker_create_fails();
+    test_timeline();
+    printf("boot_seq_test: %s\n", s_failures ? "FAILED" : "OK");
+    return s_failures ? 1 : 0;
+}
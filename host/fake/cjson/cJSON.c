@@ -0,0 +1,548 @@
+// Fallback cJSON subset for host builds (see cJSON.h)
+
+#include "cJSON.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static cJSON* new_item(int type)
+{
+    cJSON* item = (cJSON*)calloc(1, sizeof(cJSON));
+    if (item) item->type = type;
+    return item;
+}
+
+void cJSON_Delete(cJSON* item)
+{
+    while (item) {
+        cJSON* next = item->next;
+        cJSON_Delete(item->child);
+        free(item->valuestring);
+        free(item->string);
+        free(item);
+        item = next;
+    }
+}
+
+void cJSON_free(void* object)
+{
+    free(object);
+}
+
+// ---- parser ----------------------------------------------------------------
+
+typedef struct {
+    const char* p;
+    const char* end;
+} parser_t;
+
+static void skip_ws(parser_t* ps)
+{
+    while (ps->p < ps->end && isspace((unsigned char)*ps->p)) ps->p++;
+}
+
+static cJSON* parse_value(parser_t* ps, int depth);
+
+static void put_utf8(char** out, unsigned cp)
+{
+    char* o = *out;
+    if (cp < 0x80) {
+        *o++ = (char)cp;
+    } else if (cp < 0x800) {
+        *o++ = (char)(0xC0 | (cp >> 6));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *o++ = (char)(0xE0 | (cp >> 12));
+        *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+    } else {
+        *o++ = (char)(0xF0 | (cp >> 18));
+        *o++ = (char)(0x80 | ((cp >> 12) & 0x3F));
+        *o++ = (char)(0x80 | ((cp >> 6) & 0x3F));
+        *o++ = (char)(0x80 | (cp & 0x3F));
+    }
+    *out = o;
+}
+
+static int hex4(const char* s, unsigned* out)
+{
+    unsigned v = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = s[i];
+        v <<= 4;
+        if (c >= '0' && c <= '9') v |= (unsigned)(c - '0');
+        else if (c >= 'a' && c <= 'f') v |= (unsigned)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') v |= (unsigned)(c - 'A' + 10);
+        else return -1;
+    }
+    *out = v;
+    return 0;
+}
+
+static char* parse_string_raw(parser_t* ps)
+{
+    if (ps->p >= ps->end || *ps->p != '"') return NULL;
+    const char* s = ++ps->p;
+    const char* e = s;
+    while (e < ps->end && *e != '"') {
+        if (*e == '\\') e++;
+        e++;
+    }
+    if (e >= ps->end) return NULL;
+    // Escapes never expand, so the raw length bounds the decoded one
+    char* out = (char*)malloc((size_t)(e - s) + 1);
+    if (!out) return NULL;
+    char* o = out;
+    for (const char* c = s; c < e; ++c) {
+        if (*c != '\\') {
+            *o++ = *c;
+            continue;
+        }
+        ++c;
+        switch (*c) {
+        case 'b': *o++ = '\b'; break;
+        case 'f': *o++ = '\f'; break;
+        case 'n': *o++ = '\n'; break;
+        case 'r': *o++ = '\r'; break;
+        case 't': *o++ = '\t'; break;
+        case 'u': {
+            unsigned cp;
+            if (e - c < 5 || hex4(c + 1, &cp) != 0) {
+                free(out);
+                return NULL;
+            }
+            c += 4;
+            if (cp >= 0xD800 && cp < 0xDC00 && e - c >= 7 && c[1] == '\\' && c[2] == 'u') {
+                unsigned lo;
+                if (hex4(c + 3, &lo) == 0 && lo >= 0xDC00 && lo < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                    c += 6;
+                }
+            }
+            put_utf8(&o, cp);
+            break;
+        }
+        default: *o++ = *c; break;
+        }
+    }
+    *o = '\0';
+    ps->p = e + 1;
+    return out;
+}
+
+static cJSON* parse_number(parser_t* ps)
+{
+    char buf[64];
+    size_t n = 0;
+    while (ps->p + n < ps->end && n < sizeof(buf) - 1 && strchr("+-0123456789.eE", ps->p[n])) {
+        buf[n] = ps->p[n];
+        n++;
+    }
+    buf[n] = '\0';
+    char* endp = NULL;
+    double d = strtod(buf, &endp);
+    if (endp == buf) return NULL;
+    ps->p += endp - buf;
+    cJSON* item = new_item(cJSON_Number);
+    if (!item) return NULL;
+    item->valuedouble = d;
+    item->valueint = d >= INT32_MAX ? INT32_MAX : d <= (double)INT32_MIN ? INT32_MIN : (int)d;
+    return item;
+}
+
+static cJSON* parse_container(parser_t* ps, int depth, bool object)
+{
+    cJSON* item = new_item(object ? cJSON_Object : cJSON_Array);
+    if (!item) return NULL;
+    ps->p++;
+    skip_ws(ps);
+    if (ps->p < ps->end && *ps->p == (object ? '}' : ']')) {
+        ps->p++;
+        return item;
+    }
+    cJSON* tail = NULL;
+    for (;;) {
+        char* key = NULL;
+        skip_ws(ps);
+        if (object) {
+            key = parse_string_raw(ps);
+            skip_ws(ps);
+            if (!key || ps->p >= ps->end || *ps->p != ':') {
+                free(key);
+                goto fail;
+            }
+            ps->p++;
+        }
+        cJSON* child = parse_value(ps, depth + 1);
+        if (!child) {
+            free(key);
+            goto fail;
+        }
+        child->string = key;
+        if (tail) {
+            tail->next = child;
+            child->prev = tail;
+        } else {
+            item->child = child;
+        }
+        tail = child;
+        item->child->prev = tail;
+        skip_ws(ps);
+        if (ps->p >= ps->end) goto fail;
+        if (*ps->p == ',') {
+            ps->p++;
+            continue;
+        }
+        if (*ps->p == (object ? '}' : ']')) {
+            ps->p++;
+            return item;
+        }
+        goto fail;
+    }
+fail:
+    cJSON_Delete(item);
+    return NULL;
+}
+
+static bool match(parser_t* ps, const char* lit)
+{
+    size_t n = strlen(lit);
+    if ((size_t)(ps->end - ps->p) < n || strncmp(ps->p, lit, n) != 0) return false;
+    ps->p += n;
+    return true;
+}
+
+static cJSON* parse_value(parser_t* ps, int depth)
+{
+    if (depth > 64) return NULL;
+    skip_ws(ps);
+    if (ps->p >= ps->end) return NULL;
+    switch (*ps->p) {
+    case '{': return parse_container(ps, depth, true);
+    case '[': return parse_container(ps, depth, false);
+    case '"': {
+        char* s = parse_string_raw(ps);
+        if (!s) return NULL;
+        cJSON* item = new_item(cJSON_String);
+        if (!item) {
+            free(s);
+            return NULL;
+        }
+        item->valuestring = s;
+        return item;
+    }
+    case 't':
+        return match(ps, "true") ? new_item(cJSON_True) : NULL;
+    case 'f':
+        return match(ps, "false") ? new_item(cJSON_False) : NULL;
+    case 'n':
+        return match(ps, "null") ? new_item(cJSON_NULL) : NULL;
+    default:
+        return parse_number(ps);
+    }
+}
+
+cJSON* cJSON_ParseWithLength(const char* value, size_t length)
+{
+    if (!value) return NULL;
+    parser_t ps = { value, value + length };
+    cJSON* item = parse_value(&ps, 0);
+    if (!item) return NULL;
+    skip_ws(&ps);
+    // Like cJSON_Parse, trailing bytes after the value are tolerated
+    return item;
+}
+
+cJSON* cJSON_Parse(const char* value)
+{
+    return value ? cJSON_ParseWithLength(value, strlen(value)) : NULL;
+}
+
+// ---- printer ---------------------------------------------------------------
+
+typedef struct {
+    char* buf;
+    size_t len;
+    size_t cap;
+    bool fail;
+} printer_t;
+
+static void emit(printer_t* pr, const char* s, size_t n)
+{
+    if (pr->fail) return;
+    if (pr->len + n + 1 > pr->cap) {
+        size_t cap = pr->cap ? pr->cap * 2 : 64;
+        while (cap < pr->len + n + 1) cap *= 2;
+        char* nb = (char*)realloc(pr->buf, cap);
+        if (!nb) {
+            pr->fail = true;
+            return;
+        }
+        pr->buf = nb;
+        pr->cap = cap;
+    }
+    memcpy(pr->buf + pr->len, s, n);
+    pr->len += n;
+    pr->buf[pr->len] = '\0';
+}
+
+static void emit_str(printer_t* pr, const char* s)
+{
+    emit(pr, "\"", 1);
+    for (const unsigned char* c = (const unsigned char*)(s ? s : ""); *c; ++c) {
+        char esc[8];
+        switch (*c) {
+        case '"': emit(pr, "\\\"", 2); break;
+        case '\\': emit(pr, "\\\\", 2); break;
+        case '\b': emit(pr, "\\b", 2); break;
+        case '\f': emit(pr, "\\f", 2); break;
+        case '\n': emit(pr, "\\n", 2); break;
+        case '\r': emit(pr, "\\r", 2); break;
+        case '\t': emit(pr, "\\t", 2); break;
+        default:
+            if (*c < 0x20) {
+                snprintf(esc, sizeof(esc), "\\u%04x", *c);
+                emit(pr, esc, 6);
+            } else {
+                emit(pr, (const char*)c, 1);
+            }
+        }
+    }
+    emit(pr, "\"", 1);
+}
+
+static void emit_number(printer_t* pr, double d)
+{
+    char num[32];
+    int n;
+    if (isnan(d) || isinf(d)) {
+        n = snprintf(num, sizeof(num), "null");
+    } else if (d == (double)(int64_t)d && fabs(d) < 1e15) {
+        n = snprintf(num, sizeof(num), "%lld", (long long)d);
+    } else {
+        n = snprintf(num, sizeof(num), "%1.15g", d);
+        if (strtod(num, NULL) != d) n = snprintf(num, sizeof(num), "%1.17g", d);
+    }
+    emit(pr, num, (size_t)n);
+}
+
+static void print_value(printer_t* pr, const cJSON* item, bool fmt, int depth)
+{
+    switch (item->type & 0xFF) {
+    case cJSON_False: emit(pr, "false", 5); break;
+    case cJSON_True: emit(pr, "true", 4); break;
+    case cJSON_NULL: emit(pr, "null", 4); break;
+    case cJSON_Number: emit_number(pr, item->valuedouble); break;
+    case cJSON_String: emit_str(pr, item->valuestring); break;
+    case cJSON_Array:
+    case cJSON_Object: {
+        bool object = (item->type & 0xFF) == cJSON_Object;
+        emit(pr, object ? "{" : "[", 1);
+        for (const cJSON* c = item->child; c; c = c->next) {
+            if (fmt && object) {
+                emit(pr, "\n", 1);
+                for (int i = 0; i <= depth; ++i) emit(pr, "\t", 1);
+            }
+            if (object) {
+                emit_str(pr, c->string);
+                emit(pr, fmt ? ":\t" : ":", fmt ? 2 : 1);
+            }
+            print_value(pr, c, fmt, depth + 1);
+            if (c->next) emit(pr, fmt && !object ? ", " : ",", fmt && !object ? 2 : 1);
+        }
+        if (fmt && object && item->child) {
+            emit(pr, "\n", 1);
+            for (int i = 0; i < depth; ++i) emit(pr, "\t", 1);
+        }
+        emit(pr, object ? "}" : "]", 1);
+        break;
+    }
+    default: pr->fail = true; break;
+    }
+}
+
+static char* print(const cJSON* item, bool fmt)
+{
+    if (!item) return NULL;
+    printer_t pr = { 0 };
+    print_value(&pr, item, fmt, 0);
+    if (pr.fail) {
+        free(pr.buf);
+        return NULL;
+    }
+    return pr.buf;
+}
+
+char* cJSON_Print(const cJSON* item)
+{
+    return print(item, true);
+}
+
+char* cJSON_PrintUnformatted(const cJSON* item)
+{
+    return print(item, false);
+}
+
+// ---- access ----------------------------------------------------------------
+
+int cJSON_GetArraySize(const cJSON* array)
+{
+    int n = 0;
+    for (const cJSON* c = array ? array->child : NULL; c; c = c->next) n++;
+    return n;
+}
+
+cJSON* cJSON_GetArrayItem(const cJSON* array, int index)
+{
+    if (index < 0) return NULL;
+    cJSON* c = array ? array->child : NULL;
+    while (c && index-- > 0) c = c->next;
+    return c;
+}
+
+static cJSON* get_item(const cJSON* object, const char* string, bool case_sensitive)
+{
+    if (!object || !string) return NULL;
+    for (cJSON* c = object->child; c; c = c->next) {
+        if (!c->string) continue;
+        if (case_sensitive ? strcmp(c->string, string) == 0 : strcasecmp(c->string, string) == 0) return c;
+    }
+    return NULL;
+}
+
+cJSON* cJSON_GetObjectItem(const cJSON* object, const char* string)
+{
+    return get_item(object, string, false);
+}
+
+cJSON* cJSON_GetObjectItemCaseSensitive(const cJSON* object, const char* string)
+{
+    return get_item(object, string, true);
+}
+
+cJSON_bool cJSON_HasObjectItem(const cJSON* object, const char* string)
+{
+    return cJSON_GetObjectItem(object, string) != NULL;
+}
+
+#define TYPE_IS(item, t) ((item) != NULL && ((item)->type & 0xFF) == (t))
+
+cJSON_bool cJSON_IsInvalid(const cJSON* item) { return TYPE_IS(item, cJSON_Invalid); }
+cJSON_bool cJSON_IsFalse(const cJSON* item) { return TYPE_IS(item, cJSON_False); }
+cJSON_bool cJSON_IsTrue(const cJSON* item) { return TYPE_IS(item, cJSON_True); }
+cJSON_bool cJSON_IsBool(const cJSON* item) { return item && (item->type & (cJSON_True | cJSON_False)) != 0; }
+cJSON_bool cJSON_IsNull(const cJSON* item) { return TYPE_IS(item, cJSON_NULL); }
+cJSON_bool cJSON_IsNumber(const cJSON* item) { return TYPE_IS(item, cJSON_Number); }
+cJSON_bool cJSON_IsString(const cJSON* item) { return TYPE_IS(item, cJSON_String); }
+cJSON_bool cJSON_IsArray(const cJSON* item) { return TYPE_IS(item, cJSON_Array); }
+cJSON_bool cJSON_IsObject(const cJSON* item) { return TYPE_IS(item, cJSON_Object); }
+
+// ---- construction ----------------------------------------------------------
+
+cJSON* cJSON_CreateNull(void) { return new_item(cJSON_NULL); }
+cJSON* cJSON_CreateTrue(void) { return new_item(cJSON_True); }
+cJSON* cJSON_CreateFalse(void) { return new_item(cJSON_False); }
+cJSON* cJSON_CreateBool(cJSON_bool boolean) { return new_item(boolean ? cJSON_True : cJSON_False); }
+cJSON* cJSON_CreateArray(void) { return new_item(cJSON_Array); }
+cJSON* cJSON_CreateObject(void) { return new_item(cJSON_Object); }
+
+cJSON* cJSON_CreateNumber(double num)
+{
+    cJSON* item = new_item(cJSON_Number);
+    if (item) {
+        item->valuedouble = num;
+        item->valueint = num >= INT32_MAX ? INT32_MAX : num <= (double)INT32_MIN ? INT32_MIN : (int)num;
+    }
+    return item;
+}
+
+cJSON* cJSON_CreateString(const char* string)
+{
+    cJSON* item = new_item(cJSON_String);
+    if (item) {
+        item->valuestring = strdup(string ? string : "");
+        if (!item->valuestring) {
+            free(item);
+            return NULL;
+        }
+    }
+    return item;
+}
+
+cJSON_bool cJSON_AddItemToArray(cJSON* array, cJSON* item)
+{
+    if (!array || !item || array == item) return 0;
+    if (!array->child) {
+        array->child = item;
+        item->prev = item;
+    } else {
+        cJSON* tail = array->child->prev;
+        tail->next = item;
+        item->prev = tail;
+        array->child->prev = item;
+    }
+    item->next = NULL;
+    return 1;
+}
+
+cJSON_bool cJSON_AddItemToObject(cJSON* object, const char* string, cJSON* item)
+{
+    if (!object || !string || !item) return 0;
+    char* key = strdup(string);
+    if (!key) return 0;
+    free(item->string);
+    item->string = key;
+    return cJSON_AddItemToArray(object, item);
+}
+
+static cJSON* add(cJSON* object, const char* name, cJSON* item)
+{
+    if (cJSON_AddItemToObject(object, name, item)) return item;
+    cJSON_Delete(item);
+    return NULL;
+}
+
+cJSON* cJSON_AddNullToObject(cJSON* const object, const char* const name)
+{
+    return add(object, name, cJSON_CreateNull());
+}
+
+cJSON* cJSON_AddTrueToObject(cJSON* const object, const char* const name)
+{
+    return add(object, name, cJSON_CreateTrue());
+}
+
+cJSON* cJSON_AddFalseToObject(cJSON* const object, const char* const name)
+{
+    return add(object, name, cJSON_CreateFalse());
+}
+
+cJSON* cJSON_AddBoolToObject(cJSON* const object, const char* const name, const cJSON_bool boolean)
+{
+    return add(object, name, cJSON_CreateBool(boolean));
+}
+
+cJSON* cJSON_AddNumberToObject(cJSON* const object, const char* const name, const double number)
+{
+    return add(object, name, cJSON_CreateNumber(number));
+}
+
+cJSON* cJSON_AddStringToObject(cJSON* const object, const char* const name, const char* const string)
+{
+    return add(object, name, cJSON_CreateString(string));
+}
+
+cJSON* cJSON_AddObjectToObject(cJSON* const object, const char* const name)
+{
+    return add(object, name, cJSON_CreateObject());
+}
+
+cJSON* cJSON_AddArrayToObject(cJSON* const object, const char* const name)
+{
+    return add(object, name, cJSON_CreateArray());
+}
@@ -0,0 +1,70 @@
+// Host stand-ins for esp_log level, esp_timer and the default event loop
+
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+int host_log_level(void)
+{
+    static int level = -1;
+    if (level < 0) {
+        const char* env = getenv("HOST_LOG");
+        level = env ? atoi(env) : 0;
+    }
+    return level;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#define MAX_HANDLERS 16
+
+static struct {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t fn;
+    void* arg;
+} s_handlers[MAX_HANDLERS];
+static int s_num_handlers;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+esp_err_t esp_event_handler_register(esp_event_base_t base, int32_t id, esp_event_handler_t handler, void* arg)
+{
+    pthread_mutex_lock(&s_lock);
+    if (s_num_handlers >= MAX_HANDLERS) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    s_handlers[s_num_handlers].base = base;
+    s_handlers[s_num_handlers].id = id;
+    s_handlers[s_num_handlers].fn = handler;
+    s_handlers[s_num_handlers].arg = arg;
+    s_num_handlers++;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t base, int32_t id, const void* data, size_t size, TickType_t wait)
+{
+    (void)size;
+    (void)wait;
+    pthread_mutex_lock(&s_lock);
+    int n = s_num_handlers;
+    pthread_mutex_unlock(&s_lock);
+    for (int i = 0; i < n; ++i) {
+        // Bases are compared by name so a base defined twice still matches
+        if (strcmp(s_handlers[i].base, base) != 0) continue;
+        if (s_handlers[i].id != ESP_EVENT_ANY_ID && s_handlers[i].id != id) continue;
+        s_handlers[i].fn(s_handlers[i].arg, base, id, (void*)data);
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,664 @@
+// FreeRTOS stand-in on pthreads (see fake/include/freertos/*.h)
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+// ---- time ----------------------------------------------------------------
+
+static uint64_t mono_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+static uint64_t s_t0_ms;
+
+__attribute__((constructor)) static void init_clock(void)
+{
+    s_t0_ms = mono_ms();
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(mono_ms() - s_t0_ms);
+}
+
+static void cond_init(pthread_cond_t* c)
+{
+    pthread_condattr_t a;
+    pthread_condattr_init(&a);
+    pthread_condattr_setclock(&a, CLOCK_MONOTONIC);
+    pthread_cond_init(c, &a);
+    pthread_condattr_destroy(&a);
+}
+
+// Wait on `c` until `deadline_ms` (monotonic); returns false on timeout
+static bool cond_wait_until(pthread_cond_t* c, pthread_mutex_t* m, uint64_t deadline_ms, bool forever)
+{
+    if (forever) {
+        pthread_cond_wait(c, m);
+        return true;
+    }
+    struct timespec ts = { .tv_sec = (time_t)(deadline_ms / 1000), .tv_nsec = (long)(deadline_ms % 1000) * 1000000L };
+    return pthread_cond_timedwait(c, m, &ts) != ETIMEDOUT;
+}
+
+// ---- tasks ---------------------------------------------------------------
+
+struct host_task {
+    pthread_t th;
+    TaskFunction_t fn;
+    void* arg;
+    char name[16];
+    BaseType_t core;
+    // Task notification value
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    uint32_t notify;
+};
+
+static __thread struct host_task* s_self;
+static int s_create_fail_at;
+static pthread_mutex_t s_create_m = PTHREAD_MUTEX_INITIALIZER;
+
+static void task_free(void* p)
+{
+    struct host_task* t = (struct host_task*)p;
+    pthread_mutex_destroy(&t->m);
+    pthread_cond_destroy(&t->c);
+    free(t);
+}
+
+static void* task_entry(void* p)
+{
+    struct host_task* t = (struct host_task*)p;
+    s_self = t;
+    // Also runs when the task deletes itself or is deleted
+    pthread_cleanup_push(task_free, t);
+    t->fn(t->arg);
+    // Returning from a task function is fatal on FreeRTOS; treat it as vTaskDelete(NULL)
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+void host_task_create_fail_at(int n)
+{
+    pthread_mutex_lock(&s_create_m);
+    s_create_fail_at = n;
+    pthread_mutex_unlock(&s_create_m);
+}
+
+static bool create_should_fail(void)
+{
+    pthread_mutex_lock(&s_create_m);
+    bool fail = s_create_fail_at > 0 && --s_create_fail_at == 0;
+    pthread_mutex_unlock(&s_create_m);
+    return fail;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                                   UBaseType_t prio, TaskHandle_t* out, BaseType_t core)
+{
+    (void)stack;
+    (void)prio;
+    if (create_should_fail()) return pdFAIL;
+    struct host_task* t = calloc(1, sizeof(*t));
+    if (!t) return pdFAIL;
+    t->fn = fn;
+    t->arg = arg;
+    t->core = core == tskNO_AFFINITY ? 0 : core;
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    pthread_mutex_init(&t->m, NULL);
+    cond_init(&t->c);
+    // The handle is out before the task runs, as a higher-priority task
+    // would see it on FreeRTOS
+    if (out) *out = t;
+    if (pthread_create(&t->th, NULL, task_entry, t) != 0) {
+        if (out) *out = NULL;
+        task_free(t);
+        return pdFAIL;
+    }
+    pthread_detach(t->th);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg, UBaseType_t prio,
+                       TaskHandle_t* out)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, out, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL || task == s_self) {
+        s_self = NULL;
+        pthread_exit(NULL);
+    }
+    pthread_cancel(task->th);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return s_self ? s_self->core : 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t)
+{
+    pthread_mutex_lock(&t->m);
+    t->notify++;
+    pthread_cond_signal(&t->c);
+    pthread_mutex_unlock(&t->m);
+    return pdPASS;
+}
+
+static void unlock_mutex(void* m)
+{
+    pthread_mutex_unlock((pthread_mutex_t*)m);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    struct host_task* t = s_self;
+    if (!t) return 0;
+    uint64_t deadline = mono_ms() + wait;
+    pthread_mutex_lock(&t->m);
+    // The wait is where vTaskDelete() from another task cancels us
+    pthread_cleanup_push(unlock_mutex, &t->m);
+    while (t->notify == 0 && wait != 0) {
+        if (!cond_wait_until(&t->c, &t->m, deadline, wait == portMAX_DELAY)) break;
+    }
+    pthread_cleanup_pop(0);
+    uint32_t v = t->notify;
+    if (v) t->notify = clear ? 0 : v - 1;
+    pthread_mutex_unlock(&t->m);
+    return v;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = { .tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+// ---- semaphores ----------------------------------------------------------
+
+struct host_sem {
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+    struct host_sem* s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    pthread_mutex_init(&s->m, NULL);
+    cond_init(&s->c);
+    s->count = initial;
+    s->max = max;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s)
+{
+    if (!s) return;
+    pthread_mutex_destroy(&s->m);
+    pthread_cond_destroy(&s->c);
+    free(s);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    pthread_mutex_lock(&s->m);
+    BaseType_t ok = s->count < s->max;
+    if (ok) {
+        s->count++;
+        pthread_cond_signal(&s->c);
+    }
+    pthread_mutex_unlock(&s->m);
+    return ok;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait)
+{
+    uint64_t deadline = mono_ms() + wait;
+    pthread_mutex_lock(&s->m);
+    while (s->count == 0) {
+        if (wait == 0 || !cond_wait_until(&s->c, &s->m, deadline, wait == portMAX_DELAY)) {
+            if (s->count == 0) {
+                pthread_mutex_unlock(&s->m);
+                return pdFALSE;
+            }
+        }
+    }
+    s->count--;
+    pthread_mutex_unlock(&s->m);
+    return pdTRUE;
+}
+
+// ---- event groups --------------------------------------------------------
+
+struct host_event_group {
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    struct host_event_group* eg = calloc(1, sizeof(*eg));
+    if (!eg) return NULL;
+    pthread_mutex_init(&eg->m, NULL);
+    cond_init(&eg->c);
+    return eg;
+}
+
+void vEventGroupDelete(EventGroupHandle_t eg)
+{
+    if (!eg) return;
+    pthread_mutex_destroy(&eg->m);
+    pthread_cond_destroy(&eg->c);
+    free(eg);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t eg, EventBits_t bits)
+{
+    pthread_mutex_lock(&eg->m);
+    eg->bits |= bits;
+    EventBits_t v = eg->bits;
+    pthread_cond_broadcast(&eg->c);
+    pthread_mutex_unlock(&eg->m);
+    return v;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t eg, EventBits_t bits)
+{
+    pthread_mutex_lock(&eg->m);
+    EventBits_t v = eg->bits;
+    eg->bits &= ~bits;
+    pthread_mutex_unlock(&eg->m);
+    return v;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t eg)
+{
+    pthread_mutex_lock(&eg->m);
+    EventBits_t v = eg->bits;
+    pthread_mutex_unlock(&eg->m);
+    return v;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t eg, EventBits_t bits, BaseType_t clear, BaseType_t all,
+                                TickType_t wait)
+{
+    uint64_t deadline = mono_ms() + wait;
+    pthread_mutex_lock(&eg->m);
+    for (;;) {
+        EventBits_t hit = eg->bits & bits;
+        if (all ? hit == bits : hit != 0) break;
+        if (wait == 0 || !cond_wait_until(&eg->c, &eg->m, deadline, wait == portMAX_DELAY)) break;
+    }
+    // The bits as they were when the wait ended, before any clearing
+    EventBits_t v = eg->bits;
+    EventBits_t hit = v & bits;
+    if (clear && (all ? hit == bits : hit != 0)) eg->bits &= ~bits;
+    pthread_mutex_unlock(&eg->m);
+    return v;
+}
+
+// ---- ring buffers --------------------------------------------------------
+
+#define RB_HEADER 8
+#define RB_ALIGN(n) (((n) + 3u) & ~(size_t)3u)
+
+struct rb_item {
+    struct rb_item* next;
+    size_t len;
+    bool complete; // false between SendAcquire and SendComplete
+    bool taken;    // received, not yet returned
+    uint8_t data[];
+};
+
+struct host_ringbuf {
+    pthread_mutex_t m;
+    pthread_cond_t c;
+    size_t size;
+    size_t used;
+    size_t max_item;
+    struct rb_item* head;
+    struct rb_item* tail;
+};
+
+RingbufHandle_t xRingbufferCreate(size_t size, RingbufferType_t type)
+{
+    if (type != RINGBUF_TYPE_NOSPLIT) return NULL;
+    struct host_ringbuf* rb = calloc(1, sizeof(*rb));
+    if (!rb) return NULL;
+    pthread_mutex_init(&rb->m, NULL);
+    cond_init(&rb->c);
+    rb->size = RB_ALIGN(size);
+    // ESP-IDF limits no-split items to half the buffer
+    rb->max_item = RB_ALIGN(size / 2) - RB_HEADER;
+    return rb;
+}
+
+void vRingbufferDelete(RingbufHandle_t rb)
+{
+    if (!rb) return;
+    struct rb_item* it = rb->head;
+    while (it) {
+        struct rb_item* n = it->next;
+        free(it);
+        it = n;
+    }
+    pthread_mutex_destroy(&rb->m);
+    pthread_cond_destroy(&rb->c);
+    free(rb);
+}
+
+static size_t item_cost(size_t len)
+{
+    return RB_HEADER + RB_ALIGN(len);
+}
+
+static struct rb_item* rb_alloc_locked(RingbufHandle_t rb, size_t len, TickType_t wait)
+{
+    if (len > rb->max_item) return NULL;
+    uint64_t deadline = mono_ms() + wait;
+    while (rb->used + item_cost(len) > rb->size) {
+        if (wait == 0 || !cond_wait_until(&rb->c, &rb->m, deadline, wait == portMAX_DELAY)) {
+            if (rb->used + item_cost(len) > rb->size) return NULL;
+        }
+    }
+    struct rb_item* it = calloc(1, sizeof(*it) + len);
+    if (!it) return NULL;
+    it->len = len;
+    rb->used += item_cost(len);
+    if (rb->tail) {
+        rb->tail->next = it;
+    } else {
+        rb->head = it;
+    }
+    rb->tail = it;
+    return it;
+}
+
+BaseType_t xRingbufferSend(RingbufHandle_t rb, const void* data, size_t len, TickType_t wait)
+{
+    pthread_mutex_lock(&rb->m);
+    struct rb_item* it = rb_alloc_locked(rb, len, wait);
+    if (it) {
+        memcpy(it->data, data, len);
+        it->complete = true;
+        pthread_cond_broadcast(&rb->c);
+    }
+    pthread_mutex_unlock(&rb->m);
+    return it ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t rb, void** slot, size_t len, TickType_t wait)
+{
+    pthread_mutex_lock(&rb->m);
+    struct rb_item* it = rb_alloc_locked(rb, len, wait);
+    pthread_mutex_unlock(&rb->m);
+    if (!it) return pdFALSE;
+    *slot = it->data;
+    return pdTRUE;
+}
+
+static struct rb_item* item_of(void* data)
+{
+    return (struct rb_item*)((uint8_t*)data - offsetof(struct rb_item, data));
+}
+
+BaseType_t xRingbufferSendComplete(RingbufHandle_t rb, void* slot)
+{
+    pthread_mutex_lock(&rb->m);
+    item_of(slot)->complete = true;
+    pthread_cond_broadcast(&rb->c);
+    pthread_mutex_unlock(&rb->m);
+    return pdTRUE;
+}
+
+void* xRingbufferReceive(RingbufHandle_t rb, size_t* len, TickType_t wait)
+{
+    uint64_t deadline = mono_ms() + wait;
+    pthread_mutex_lock(&rb->m);
+    for (;;) {
+        // Items come out in order; an acquired-but-incomplete item blocks the rest
+        struct rb_item* it = rb->head;
+        while (it && it->taken) it = it->next;
+        if (it && it->complete) {
+            it->taken = true;
+            pthread_mutex_unlock(&rb->m);
+            if (len) *len = it->len;
+            return it->data;
+        }
+        if (wait == 0 || !cond_wait_until(&rb->c, &rb->m, deadline, wait == portMAX_DELAY)) {
+            if (wait != portMAX_DELAY && mono_ms() >= deadline) break;
+        }
+    }
+    pthread_mutex_unlock(&rb->m);
+    return NULL;
+}
+
+void vRingbufferReturnItem(RingbufHandle_t rb, void* item)
+{
+    struct rb_item* it = item_of(item);
+    pthread_mutex_lock(&rb->m);
+    struct rb_item** pp = &rb->head;
+    struct rb_item* prev = NULL;
+    while (*pp && *pp != it) {
+        prev = *pp;
+        pp = &(*pp)->next;
+    }
+    if (*pp) {
+        *pp = it->next;
+        if (rb->tail == it) rb->tail = prev;
+        rb->used -= item_cost(it->len);
+        free(it);
+        pthread_cond_broadcast(&rb->c);
+    }
+    pthread_mutex_unlock(&rb->m);
+}
+
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t rb)
+{
+    pthread_mutex_lock(&rb->m);
+    size_t free_bytes = rb->size - rb->used;
+    free_bytes = free_bytes > RB_HEADER ? free_bytes - RB_HEADER : 0;
+    if (free_bytes > rb->max_item) free_bytes = rb->max_item;
+    pthread_mutex_unlock(&rb->m);
+    return free_bytes;
+}
+
+// Positions as if the oldest unreturned item sat at offset 0, which is all
+// a caller can derive from them: the span in use and the items waiting
+void vRingbufferGetInfo(RingbufHandle_t rb, UBaseType_t* uxFree, UBaseType_t* uxRead, UBaseType_t* uxWrite,
+                        UBaseType_t* uxAcquire, UBaseType_t* uxItemsWaiting)
+{
+    pthread_mutex_lock(&rb->m);
+    size_t read = 0;
+    UBaseType_t waiting = 0;
+    for (struct rb_item* it = rb->head; it; it = it->next) {
+        if (it->taken) {
+            read += item_cost(it->len);
+        } else if (it->complete) {
+            waiting++;
+        }
+    }
+    size_t written = 0;
+    for (struct rb_item* it = rb->head; it && it->complete; it = it->next) written += item_cost(it->len);
+    if (uxFree) *uxFree = 0;
+    if (uxRead) *uxRead = read % rb->size;
+    if (uxWrite) *uxWrite = written % rb->size;
+    if (uxAcquire) *uxAcquire = rb->used % rb->size;
+    if (uxItemsWaiting) *uxItemsWaiting = waiting;
+    pthread_mutex_unlock(&rb->m);
+}
+
+// ---- software timers -----------------------------------------------------
+
+struct host_timer {
+    struct host_timer* next;
+    TimerCallbackFunction_t cb;
+    void* id;
+    TickType_t period;
+    bool auto_reload;
+    bool active;
+    uint64_t due_ms;
+    char name[16];
+};
+
+static pthread_mutex_t s_tmr_m = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_tmr_c;
+static struct host_timer* s_timers;
+static bool s_tmr_started;
+
+static void* timer_service(void* arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&s_tmr_m);
+    for (;;) {
+        uint64_t now = mono_ms();
+        struct host_timer* due = NULL;
+        uint64_t next_due = UINT64_MAX;
+        for (struct host_timer* t = s_timers; t; t = t->next) {
+            if (!t->active) continue;
+            if (t->due_ms <= now && (!due || t->due_ms < due->due_ms)) due = t;
+            if (t->due_ms < next_due) next_due = t->due_ms;
+        }
+        if (due) {
+            if (due->auto_reload) {
+                due->due_ms += due->period ? due->period : 1;
+            } else {
+                due->active = false;
+            }
+            TimerCallbackFunction_t cb = due->cb;
+            pthread_mutex_unlock(&s_tmr_m);
+            cb(due);
+            pthread_mutex_lock(&s_tmr_m);
+            continue;
+        }
+        cond_wait_until(&s_tmr_c, &s_tmr_m, next_due, next_due == UINT64_MAX);
+    }
+    return NULL;
+}
+
+static void timer_service_start_locked(void)
+{
+    if (s_tmr_started) return;
+    s_tmr_started = true;
+    cond_init(&s_tmr_c);
+    pthread_t th;
+    pthread_create(&th, NULL, timer_service, NULL);
+    pthread_detach(th);
+}
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t auto_reload, void* id,
+                           TimerCallbackFunction_t cb)
+{
+    struct host_timer* t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    t->cb = cb;
+    t->id = id;
+    t->period = period;
+    t->auto_reload = auto_reload != 0;
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+    pthread_mutex_lock(&s_tmr_m);
+    timer_service_start_locked();
+    t->next = s_timers;
+    s_timers = t;
+    pthread_mutex_unlock(&s_tmr_m);
+    return t;
+}
+
+static BaseType_t timer_arm(TimerHandle_t t, bool active)
+{
+    if (!t) return pdFAIL;
+    pthread_mutex_lock(&s_tmr_m);
+    t->active = active;
+    t->due_ms = mono_ms() + t->period;
+    pthread_cond_signal(&s_tmr_c);
+    pthread_mutex_unlock(&s_tmr_m);
+    return pdPASS;
+}
+
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    return timer_arm(t, true);
+}
+
+BaseType_t xTimerReset(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    return timer_arm(t, true);
+}
+
+BaseType_t xTimerStop(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    return timer_arm(t, false);
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t t, TickType_t period, TickType_t wait)
+{
+    (void)wait;
+    if (!t) return pdFAIL;
+    pthread_mutex_lock(&s_tmr_m);
+    t->period = period;
+    pthread_mutex_unlock(&s_tmr_m);
+    return timer_arm(t, true);
+}
+
+BaseType_t xTimerDelete(TimerHandle_t t, TickType_t wait)
+{
+    (void)wait;
+    if (!t) return pdFAIL;
+    pthread_mutex_lock(&s_tmr_m);
+    for (struct host_timer** pp = &s_timers; *pp; pp = &(*pp)->next) {
+        if (*pp == t) {
+            *pp = t->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_tmr_m);
+    free(t);
+    return pdPASS;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t t)
+{
+    pthread_mutex_lock(&s_tmr_m);
+    BaseType_t a = t && t->active;
+    pthread_mutex_unlock(&s_tmr_m);
+    return a;
+}
+
+void* pvTimerGetTimerID(TimerHandle_t t)
+{
+    return t ? t->id : NULL;
+}
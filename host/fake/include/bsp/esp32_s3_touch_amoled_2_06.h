@@ -0,0 +1,25 @@
+#pragma once
+// Host stand-in for the board support package (power event and display lock only)
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "esp_event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ESP_EVENT_DECLARE_BASE(BSP_POWER_EVENT_BASE);
+
+typedef struct {
+    int battery_percent;
+    bool vbus_in;
+    bool charging;
+} bsp_power_event_payload_t;
+
+bool bsp_display_lock(uint32_t timeout_ms);
+void bsp_display_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
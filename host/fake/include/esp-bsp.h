@@ -0,0 +1,2 @@
+#pragma once
+#include "bsp/esp32_s3_touch_amoled_2_06.h"
@@ -0,0 +1,18 @@
+#pragma once
+// Host build stand-in for ESP-IDF's esp_heap_caps.h: one heap, capabilities ignored
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+
+static inline void* heap_caps_malloc(size_t size, unsigned caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void* p)
+{
+    free(p);
+}
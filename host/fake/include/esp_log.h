@@ -0,0 +1,21 @@
+#pragma once
+// Host build stand-in for ESP-IDF's esp_log.h. Errors and warnings always
+// print; info/debug only with HOST_LOG=1 / HOST_LOG=2 in the environment so
+// tool output stays readable.
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int host_log_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define ESP_LOGE(tag, fmt, ...) fprintf(stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...) fprintf(stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...) do { if (host_log_level() >= 1) fprintf(stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGD(tag, fmt, ...) do { if (host_log_level() >= 2) fprintf(stderr, "D %s: " fmt "\n", tag, ##__VA_ARGS__); } while (0)
+#define ESP_LOGV(tag, fmt, ...) do { } while (0)
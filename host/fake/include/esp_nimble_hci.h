@@ -0,0 +1,12 @@
+#pragma once
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t esp_nimble_deinit(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+// Host build stand-in for ESP-IDF's esp_rom_crc.h: the ROM's CRC-32
+// (little-endian, reflected 0xEDB88320, inverted in and out)
+#include <stddef.h>
+#include <stdint.h>
+
+static inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
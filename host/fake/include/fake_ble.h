@@ -0,0 +1,78 @@
+#pragma once
+// Scripted phone peer for the fake NimBLE host (fake/nimble.c).
+//
+// The firmware side runs unmodified: GATT access callbacks and GAP events
+// are delivered on the "host task" started by nimble_port_freertos_init,
+// notifications are captured from whichever task calls
+// ble_gatts_notify_custom. Writes are queued to the host task like ACL
+// packets; when FAKE_BLE_ACL_BUFFERS writes are pending the writer blocks,
+// which is how link-layer flow control throttles a real phone.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FAKE_BLE_ACL_BUFFERS 16
+
+// Short ids of the NUS characteristics (bytes 12-13 of the 128-bit UUID)
+#define FAKE_NUS_RX   0x0002
+#define FAKE_NUS_TX   0x0003
+#define FAKE_NUS_BULK 0x0004
+
+typedef struct {
+    uint16_t mtu;   // ATT MTU exchanged after connect (0 keeps 23)
+    uint8_t phy;    // 2 reports a 2M PHY update, anything else stays on 1M
+    uint16_t dle;   // LL tx octets reported by DATA_LEN_CHG (0: no event)
+    bool bonded;    // re-encrypts from a bond and restores the CCCD
+} fake_ble_link_t;
+
+typedef struct {
+    uint32_t writes;
+    uint32_t write_bytes;
+    uint32_t notifies;
+    uint32_t notify_bytes;
+    uint32_t notify_enomem;
+    uint32_t conn_updates;
+    uint16_t itvl_min;      // last requested connection parameters (1.25 ms units)
+    uint16_t itvl_max;
+    uint16_t latency;
+    uint16_t phy_requests;
+    uint16_t dle_requested;
+    bool advertising;
+    uint16_t adv_itvl_min;
+} fake_ble_stats_t;
+
+// Called for every notification, on the notifying task
+typedef void (*fake_ble_notify_cb_t)(const uint8_t* data, size_t len, void* arg);
+
+void fake_ble_set_notify_cb(fake_ble_notify_cb_t cb, void* arg);
+
+// Wait for the firmware to start advertising
+bool fake_ble_wait_advertising(uint32_t timeout_ms);
+
+// Connect and run the usual follow-up (MTU, PHY, DLE, encryption,
+// subscription); returns once the host task has handled all of it
+int fake_ble_connect(const fake_ble_link_t* link);
+void fake_ble_disconnect(void);
+
+// Write `data` to a NUS characteristic. Each write carries at most
+// mtu - 3 bytes; a write is delivered as an mbuf chain of `frag`-byte
+// segments (0: one segment), like NimBLE reassembling ACL fragments.
+int fake_ble_write(uint16_t nus_chr, const void* data, size_t len, size_t frag);
+
+// Block until the host task has processed everything queued so far
+void fake_ble_flush(void);
+
+// Make the next `n` notifications fail with BLE_HS_ENOMEM
+void fake_ble_inject_notify_enomem(uint32_t n);
+
+void fake_ble_get_stats(fake_ble_stats_t* out);
+void fake_ble_reset_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+// Recording fakes for the watch-side APIs ble_sync calls (UI, RTC, power,
+// sensors, audio). Scenarios read back what the firmware did and when.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    int64_t us;     // esp_timer_get_time() when notifications_show ran
+    char app[32];
+    char title[64];
+    char message[256];
+    char timestamp[40];
+} fake_watch_notif_t;
+
+typedef struct {
+    uint32_t notifications;
+    uint32_t messages_tile;
+    uint32_t display_on;
+    uint32_t audio_alerts;
+    uint32_t async_calls;
+    uint32_t rtc_sets;
+    uint32_t app_sets;
+    struct tm rtc_last;
+} fake_watch_counts_t;
+
+void fake_watch_reset(void);
+
+// Inputs
+void fake_watch_set_power(int battery_percent, bool charging, int vbus_mv);
+void fake_watch_set_steps(uint32_t steps);
+void fake_watch_set_rtc_date(int year, int month, int day);
+// notifications_show takes this long, like an LVGL redraw on the panel
+void fake_watch_set_ui_delay_ms(uint32_t ms);
+// bsp_display_lock fails, forcing the lv_async_call fallback
+void fake_watch_set_display_lock_fails(bool fails);
+
+// Outputs
+void fake_watch_get_counts(fake_watch_counts_t* out);
+// Copy the i-th recorded notification (oldest first); false if not recorded
+bool fake_watch_get_notif(uint32_t i, fake_watch_notif_t* out);
+// Wait until at least `n` notifications were shown
+bool fake_watch_wait_notifs(uint32_t n, uint32_t timeout_ms);
+// Wait until rtc_set_time was called at least `n` times
+bool fake_watch_wait_rtc_sets(uint32_t n, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
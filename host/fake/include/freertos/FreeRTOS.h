@@ -0,0 +1,33 @@
+#pragma once
+// Host stand-in for the FreeRTOS kernel API used by the firmware. Tasks are
+// pthreads, the tick is 1 ms of CLOCK_MONOTONIC, blocking calls block for real.
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+
+#define pdTRUE  ((BaseType_t)1)
+#define pdFALSE ((BaseType_t)0)
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define pdTICKS_TO_MS(t)    ((uint32_t)(t))
+
+// Two cores, as on the ESP32-S3; a pinned task reports its core
+#define portNUM_PROCESSORS  2
+#define tskNO_AFFINITY      ((BaseType_t)0x7fffffff)
+
+// Critical sections are a spinlock shared by every thread that takes it
+typedef struct {
+    volatile int locked;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
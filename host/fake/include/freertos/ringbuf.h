@@ -0,0 +1,33 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Only no-split rings are modelled. Space is accounted like ESP-IDF: each
+// item costs an 8-byte header plus its length rounded up to 4 bytes, and is
+// released when the item is returned, not when it is received.
+typedef struct host_ringbuf* RingbufHandle_t;
+
+typedef enum {
+    RINGBUF_TYPE_NOSPLIT = 0,
+    RINGBUF_TYPE_ALLOWSPLIT,
+    RINGBUF_TYPE_BYTEBUF,
+} RingbufferType_t;
+
+RingbufHandle_t xRingbufferCreate(size_t size, RingbufferType_t type);
+void vRingbufferDelete(RingbufHandle_t rb);
+BaseType_t xRingbufferSend(RingbufHandle_t rb, const void* data, size_t len, TickType_t wait);
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t rb, void** slot, size_t len, TickType_t wait);
+BaseType_t xRingbufferSendComplete(RingbufHandle_t rb, void* slot);
+void* xRingbufferReceive(RingbufHandle_t rb, size_t* len, TickType_t wait);
+void vRingbufferReturnItem(RingbufHandle_t rb, void* item);
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t rb);
+void vRingbufferGetInfo(RingbufHandle_t rb, UBaseType_t* uxFree, UBaseType_t* uxRead, UBaseType_t* uxWrite,
+                        UBaseType_t* uxAcquire, UBaseType_t* uxItemsWaiting);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+#include <sched.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_task* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack, void* arg, UBaseType_t prio,
+                       TaskHandle_t* out);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack, void* arg,
+                                   UBaseType_t prio, TaskHandle_t* out, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+
+// Core the calling task was pinned to; 0 for unpinned tasks and threads
+// the fake did not create
+BaseType_t xPortGetCoreID(void);
+
+// Host only: the `n`-th task created from now on fails to create (1 = the
+// next one), for testing how callers clean up; 0 turns it off
+void host_task_create_fail_at(int n);
+
+static inline void host_critical_enter(portMUX_TYPE* mux)
+{
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) sched_yield();
+}
+
+static inline void host_critical_exit(portMUX_TYPE* mux)
+{
+    __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+}
+
+#define taskENTER_CRITICAL(mux) host_critical_enter(mux)
+#define taskEXIT_CRITICAL(mux)  host_critical_exit(mux)
+
+#ifdef __cplusplus
+}
+#endif
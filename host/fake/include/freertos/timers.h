@@ -0,0 +1,25 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_timer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+// Callbacks run on one shared timer-service thread, like the FreeRTOS daemon task
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t auto_reload, void* id,
+                           TimerCallbackFunction_t cb);
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerStop(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerReset(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerChangePeriod(TimerHandle_t t, TickType_t period, TickType_t wait);
+BaseType_t xTimerDelete(TimerHandle_t t, TickType_t wait);
+BaseType_t xTimerIsTimerActive(TimerHandle_t t);
+void* pvTimerGetTimerID(TimerHandle_t t);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,341 @@
+#pragma once
+// Host stand-in for the slice of the NimBLE host API used by
+// nimble-nordic-uart. Layouts follow NimBLE where the firmware touches
+// fields directly (mbuf chain, GAP event union, connection descriptor);
+// everything else is reduced to what the fake in fake/nimble.c needs.
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ---- mbufs ---------------------------------------------------------------
+
+#define SLIST_ENTRY(type) struct { struct type* sle_next; }
+#define SLIST_NEXT(elm, field) ((elm)->field.sle_next)
+
+struct os_mbuf {
+    uint8_t* om_data;
+    uint16_t om_len;
+    uint16_t om_pkt_len; // valid on the chain head only (NimBLE keeps it in the packet header)
+    SLIST_ENTRY(os_mbuf) om_next;
+    uint8_t om_databuf[];
+};
+
+#define OS_MBUF_PKTLEN(om) ((om)->om_pkt_len)
+
+struct os_mbuf* ble_hs_mbuf_from_flat(const void* buf, uint16_t len);
+int ble_hs_mbuf_to_flat(const struct os_mbuf* om, void* flat, uint16_t max_len, uint16_t* out_copy_len);
+int os_mbuf_free_chain(struct os_mbuf* om);
+
+// ---- UUIDs ---------------------------------------------------------------
+
+#define BLE_UUID_TYPE_16  16
+#define BLE_UUID_TYPE_128 128
+
+typedef struct {
+    uint8_t type;
+} ble_uuid_t;
+
+typedef struct {
+    ble_uuid_t u;
+    uint8_t value[16];
+} ble_uuid128_t;
+
+#define BLE_UUID128_INIT(uuid128...) { .u = { .type = BLE_UUID_TYPE_128 }, .value = { uuid128 } }
+
+int ble_uuid_cmp(const ble_uuid_t* a, const ble_uuid_t* b);
+
+// ---- addresses, errors ---------------------------------------------------
+
+typedef struct {
+    uint8_t type;
+    uint8_t val[6];
+} ble_addr_t;
+
+#define BLE_HS_FOREVER      INT32_MAX
+
+#define BLE_HS_EAGAIN       1
+#define BLE_HS_EALREADY     2
+#define BLE_HS_EINVAL       3
+#define BLE_HS_EMSGSIZE     4
+#define BLE_HS_ENOENT       5
+#define BLE_HS_ENOMEM       6
+#define BLE_HS_ENOTCONN     7
+#define BLE_HS_EBUSY        15
+
+#define BLE_ERR_REM_USER_CONN_TERM 0x13
+
+// ---- ATT / GATT ----------------------------------------------------------
+
+#define BLE_ATT_MTU_DFLT        23
+#define BLE_ATT_ATTR_MAX_LEN    512
+
+#define BLE_ATT_ERR_WRITE_NOT_PERMITTED     0x03
+#define BLE_ATT_ERR_INVALID_ATTR_VALUE_LEN  0x0d
+
+uint16_t ble_att_mtu(uint16_t conn_handle);
+
+#define BLE_GATT_SVC_TYPE_END       0
+#define BLE_GATT_SVC_TYPE_PRIMARY   1
+
+#define BLE_GATT_CHR_F_READ         0x0002
+#define BLE_GATT_CHR_F_WRITE_NO_RSP 0x0004
+#define BLE_GATT_CHR_F_WRITE        0x0008
+#define BLE_GATT_CHR_F_NOTIFY       0x0010
+
+#define BLE_GATT_ACCESS_OP_READ_CHR  0
+#define BLE_GATT_ACCESS_OP_WRITE_CHR 1
+
+struct ble_gatt_access_ctxt;
+typedef int ble_gatt_access_fn(uint16_t conn_handle, uint16_t attr_handle, struct ble_gatt_access_ctxt* ctxt,
+                               void* arg);
+
+struct ble_gatt_chr_def {
+    const ble_uuid_t* uuid;
+    ble_gatt_access_fn* access_cb;
+    void* arg;
+    void* descriptors;
+    uint16_t flags;
+    uint8_t min_key_size;
+    uint16_t* val_handle;
+};
+
+struct ble_gatt_svc_def {
+    uint8_t type;
+    const ble_uuid_t* uuid;
+    const struct ble_gatt_svc_def** includes;
+    const struct ble_gatt_chr_def* characteristics;
+};
+
+struct ble_gatt_access_ctxt {
+    uint8_t op;
+    struct os_mbuf* om;
+    const struct ble_gatt_chr_def* chr;
+};
+
+int ble_gatts_count_cfg(const struct ble_gatt_svc_def* defs);
+int ble_gatts_add_svcs(const struct ble_gatt_svc_def* svcs);
+int ble_gatts_notify_custom(uint16_t conn_handle, uint16_t att_handle, struct os_mbuf* om);
+
+// ---- GAP -----------------------------------------------------------------
+
+#define BLE_GAP_EVENT_CONNECT               0
+#define BLE_GAP_EVENT_DISCONNECT            1
+#define BLE_GAP_EVENT_CONN_UPDATE           3
+#define BLE_GAP_EVENT_ADV_COMPLETE          9
+#define BLE_GAP_EVENT_ENC_CHANGE            10
+#define BLE_GAP_EVENT_NOTIFY_TX             13
+#define BLE_GAP_EVENT_SUBSCRIBE             14
+#define BLE_GAP_EVENT_MTU                   15
+#define BLE_GAP_EVENT_REPEAT_PAIRING        17
+#define BLE_GAP_EVENT_PHY_UPDATE_COMPLETE   18
+#define BLE_GAP_EVENT_DATA_LEN_CHG          34
+
+#define BLE_GAP_CONN_MODE_NON   0
+#define BLE_GAP_CONN_MODE_DIR   1
+#define BLE_GAP_CONN_MODE_UND   2
+#define BLE_GAP_DISC_MODE_NON   0
+#define BLE_GAP_DISC_MODE_LTD   1
+#define BLE_GAP_DISC_MODE_GEN   2
+
+#define BLE_GAP_LE_PHY_1M_MASK      0x01
+#define BLE_GAP_LE_PHY_2M_MASK      0x02
+#define BLE_GAP_LE_PHY_CODED_MASK   0x04
+#define BLE_GAP_LE_PHY_CODED_ANY    0
+
+#define BLE_GAP_REPEAT_PAIRING_RETRY  1
+#define BLE_GAP_REPEAT_PAIRING_IGNORE 2
+
+#define BLE_GAP_SUBSCRIBE_REASON_WRITE   1
+#define BLE_GAP_SUBSCRIBE_REASON_TERM    2
+#define BLE_GAP_SUBSCRIBE_REASON_RESTORE 3
+
+struct ble_gap_sec_state {
+    unsigned encrypted : 1;
+    unsigned authenticated : 1;
+    unsigned bonded : 1;
+    unsigned key_size : 5;
+};
+
+struct ble_gap_conn_desc {
+    struct ble_gap_sec_state sec_state;
+    ble_addr_t our_id_addr;
+    ble_addr_t peer_id_addr;
+    ble_addr_t our_ota_addr;
+    ble_addr_t peer_ota_addr;
+    uint16_t conn_handle;
+    uint16_t conn_itvl;
+    uint16_t conn_latency;
+    uint16_t supervision_timeout;
+    uint8_t role;
+    uint8_t master_clock_accuracy;
+};
+
+struct ble_gap_upd_params {
+    uint16_t itvl_min;
+    uint16_t itvl_max;
+    uint16_t latency;
+    uint16_t supervision_timeout;
+    uint16_t min_ce_len;
+    uint16_t max_ce_len;
+};
+
+struct ble_gap_adv_params {
+    uint8_t conn_mode;
+    uint8_t disc_mode;
+    uint16_t itvl_min;
+    uint16_t itvl_max;
+    uint8_t channel_map;
+    uint8_t filter_policy;
+    uint8_t high_duty_cycle : 1;
+};
+
+struct ble_gap_event {
+    uint8_t type;
+    union {
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } connect;
+        struct {
+            int reason;
+            struct ble_gap_conn_desc conn;
+        } disconnect;
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } conn_update;
+        struct {
+            int reason;
+        } adv_complete;
+        struct {
+            int status;
+            uint16_t conn_handle;
+        } enc_change;
+        struct {
+            int status;
+            uint16_t conn_handle;
+            uint16_t attr_handle;
+            uint8_t indication : 1;
+        } notify_tx;
+        struct {
+            uint16_t conn_handle;
+            uint16_t attr_handle;
+            uint8_t reason;
+            uint8_t prev_notify : 1;
+            uint8_t cur_notify : 1;
+            uint8_t prev_indicate : 1;
+            uint8_t cur_indicate : 1;
+        } subscribe;
+        struct {
+            uint16_t conn_handle;
+            uint16_t channel_id;
+            uint16_t value;
+        } mtu;
+        struct {
+            uint16_t conn_handle;
+            uint8_t cur_key_size;
+            uint8_t cur_authenticated : 1;
+            uint8_t cur_sc : 1;
+            uint8_t new_key_size;
+            uint8_t new_authenticated : 1;
+            uint8_t new_sc : 1;
+            uint8_t new_bonding : 1;
+        } repeat_pairing;
+        struct {
+            int status;
+            uint16_t conn_handle;
+            uint8_t tx_phy;
+            uint8_t rx_phy;
+        } phy_updated;
+        struct {
+            uint16_t conn_handle;
+            uint16_t max_tx_octets;
+            uint16_t max_tx_time;
+            uint16_t max_rx_octets;
+            uint16_t max_rx_time;
+        } data_len_chg;
+    };
+};
+
+typedef int ble_gap_event_fn(struct ble_gap_event* event, void* arg);
+
+int ble_gap_conn_find(uint16_t handle, struct ble_gap_conn_desc* out_desc);
+int ble_gap_update_params(uint16_t conn_handle, const struct ble_gap_upd_params* params);
+int ble_gap_set_prefered_le_phy(uint16_t conn_handle, uint8_t tx_phys_mask, uint8_t rx_phys_mask, uint16_t phy_opts);
+int ble_gap_set_data_len(uint16_t conn_handle, uint16_t tx_octets, uint16_t tx_time);
+int ble_gap_security_initiate(uint16_t conn_handle);
+int ble_gap_terminate(uint16_t conn_handle, uint8_t hci_reason);
+
+// ---- advertising ---------------------------------------------------------
+
+#define BLE_HS_ADV_F_DISC_LTD       0x01
+#define BLE_HS_ADV_F_DISC_GEN       0x02
+#define BLE_HS_ADV_F_BREDR_UNSUP    0x04
+#define BLE_HS_ADV_TX_PWR_LVL_AUTO  (-128)
+
+struct ble_hs_adv_fields {
+    uint8_t flags;
+    const ble_uuid128_t* uuids128;
+    uint8_t num_uuids128;
+    unsigned uuids128_is_complete : 1;
+    const uint8_t* name;
+    uint8_t name_len;
+    unsigned name_is_complete : 1;
+    int8_t tx_pwr_lvl;
+    unsigned tx_pwr_lvl_is_present : 1;
+};
+
+int ble_gap_adv_set_fields(const struct ble_hs_adv_fields* fields);
+int ble_gap_adv_rsp_set_fields(const struct ble_hs_adv_fields* fields);
+int ble_gap_adv_start(uint8_t own_addr_type, const ble_addr_t* direct_addr, int32_t duration_ms,
+                      const struct ble_gap_adv_params* params, ble_gap_event_fn* cb, void* cb_arg);
+int ble_gap_adv_stop(void);
+
+int ble_hs_id_infer_auto(int privacy, uint8_t* out_addr_type);
+
+// ---- host config, security, store ----------------------------------------
+
+#define BLE_HS_IO_DISPLAY_ONLY      0x00
+#define BLE_HS_IO_DISPLAY_YESNO     0x01
+#define BLE_HS_IO_KEYBOARD_ONLY     0x02
+#define BLE_HS_IO_NO_INPUT_OUTPUT   0x03
+
+#define BLE_SM_PAIR_KEY_DIST_ENC    0x01
+#define BLE_SM_PAIR_KEY_DIST_ID     0x02
+
+struct ble_store_status_event;
+typedef void ble_hs_sync_fn(void);
+typedef void ble_hs_reset_fn(int reason);
+typedef int ble_store_status_fn(struct ble_store_status_event* event, void* arg);
+
+struct ble_hs_cfg {
+    ble_hs_reset_fn* reset_cb;
+    ble_hs_sync_fn* sync_cb;
+    ble_store_status_fn* store_status_cb;
+    void* store_status_arg;
+    uint8_t sm_io_cap;
+    unsigned sm_oob_data_flag : 1;
+    unsigned sm_bonding : 1;
+    unsigned sm_mitm : 1;
+    unsigned sm_sc : 1;
+    unsigned sm_keypress : 1;
+    uint8_t sm_our_key_dist;
+    uint8_t sm_their_key_dist;
+};
+
+extern struct ble_hs_cfg ble_hs_cfg;
+
+int ble_store_util_status_rr(struct ble_store_status_event* event, void* arg);
+int ble_store_util_delete_peer(const ble_addr_t* peer_id_addr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+// Just enough of LVGL for the GUI headers that ble_sync includes
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_display_t lv_display_t;
+typedef struct _lv_indev_t lv_indev_t;
+typedef struct _lv_style_t lv_style_t;
+typedef struct _lv_image_dsc_t lv_image_dsc_t;
+typedef struct _lv_subject_t lv_subject_t;
+typedef int lv_screen_load_anim_t;
+typedef int lv_result_t;
+typedef void (*lv_async_cb_t)(void*);
+
+#define LV_FORMAT_ATTRIBUTE(fmt, args)
+
+lv_result_t lv_async_call(lv_async_cb_t cb, void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t nimble_port_init(void);
+esp_err_t nimble_port_deinit(void);
+// Runs the host event loop (GATT access and GAP callbacks) until nimble_port_stop
+void nimble_port_run(void);
+int nimble_port_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
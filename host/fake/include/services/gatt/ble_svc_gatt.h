@@ -0,0 +1,11 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ble_svc_gatt_init(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+// Minimal Unity stand-in so the component tests under components/*/test run
+// on the host. TEST_CASE registers itself at load time; unity_host_main runs
+// the registered cases and longjmps out of a case on the first failed assert.
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*unity_host_fn_t)(void);
+
+void unity_host_register(const char* name, const char* tags, unity_host_fn_t fn, const char* file, int line);
+void unity_host_fail(const char* file, int line, const char* fmt, ...) __attribute__((noreturn, format(printf, 3, 4)));
+// Runs every case; `-x <name>` skips a case, other arguments select by tag
+// or by exact name
+int unity_host_main(int argc, char** argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define UNITY_HOST_CAT2(a, b) a##b
+#define UNITY_HOST_CAT(a, b) UNITY_HOST_CAT2(a, b)
+
+#define TEST_CASE(name, tags)                                                                                  \
+    static void UNITY_HOST_CAT(unity_host_case_, __LINE__)(void);                                              \
+    __attribute__((constructor)) static void UNITY_HOST_CAT(unity_host_reg_, __LINE__)(void)                   \
+    {                                                                                                          \
+        unity_host_register(name, tags, UNITY_HOST_CAT(unity_host_case_, __LINE__), __FILE__, __LINE__);       \
+    }                                                                                                          \
+    static void UNITY_HOST_CAT(unity_host_case_, __LINE__)(void)
+
+#define TEST_ASSERT_TRUE(c) \
+    do { if (!(c)) unity_host_fail(__FILE__, __LINE__, "expected TRUE: %s", #c); } while (0)
+#define TEST_ASSERT(c) TEST_ASSERT_TRUE(c)
+#define TEST_ASSERT_FALSE(c) \
+    do { if (c) unity_host_fail(__FILE__, __LINE__, "expected FALSE: %s", #c); } while (0)
+#define TEST_ASSERT_NULL(p) \
+    do { if ((p) != NULL) unity_host_fail(__FILE__, __LINE__, "expected NULL: %s", #p); } while (0)
+#define TEST_ASSERT_NOT_NULL(p) \
+    do { if ((p) == NULL) unity_host_fail(__FILE__, __LINE__, "expected non-NULL: %s", #p); } while (0)
+
+#define TEST_ASSERT_EQUAL_INT64(e, a)                                                                          \
+    do {                                                                                                       \
+        int64_t e_ = (int64_t)(e), a_ = (int64_t)(a);                                                          \
+        if (e_ != a_) unity_host_fail(__FILE__, __LINE__, "expected %lld, was %lld (%s)", (long long)e_,       \
+                                      (long long)a_, #a);                                                      \
+    } while (0)
+#define TEST_ASSERT_EQUAL(e, a) TEST_ASSERT_EQUAL_INT64(e, a)
+#define TEST_ASSERT_EQUAL_INT(e, a) TEST_ASSERT_EQUAL_INT64(e, a)
+#define TEST_ASSERT_EQUAL_UINT32(e, a) TEST_ASSERT_EQUAL_INT64((uint32_t)(e), (uint32_t)(a))
+
+#define TEST_ASSERT_EQUAL_STRING(e, a)                                                                         \
+    do {                                                                                                       \
+        const char *e_ = (e), *a_ = (a);                                                                       \
+        if (!a_ || strcmp(e_, a_) != 0)                                                                        \
+            unity_host_fail(__FILE__, __LINE__, "expected \"%s\", was \"%s\"", e_, a_ ? a_ : "(null)");        \
+    } while (0)
+
+#define TEST_ESP_ERR(e, a)                                                                                     \
+    do {                                                                                                       \
+        esp_err_t e_ = (e), a_ = (a);                                                                          \
+        if (e_ != a_) unity_host_fail(__FILE__, __LINE__, "expected %s, was %s (%s)", esp_err_to_name(e_),     \
+                                      esp_err_to_name(a_), #a);                                                \
+    } while (0)
+#define TEST_ESP_OK(a) TEST_ESP_ERR(ESP_OK, a)
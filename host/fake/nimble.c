@@ -0,0 +1,668 @@
+// Fake NimBLE host and scripted phone peer (see fake/include/fake_ble.h)
+
+#include "fake_ble.h"
+
+#include "esp_nimble_hci.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "host/ble_hs.h"
+#include "nimble/nimble_port.h"
+#include "nimble/nimble_port_freertos.h"
+#include "nvs_flash.h"
+#include "services/gap/ble_svc_gap.h"
+#include "services/gatt/ble_svc_gatt.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define CONN_HANDLE 1
+#define MAX_CHRS    16
+
+struct ble_hs_cfg ble_hs_cfg;
+
+// ---- host task job queue -------------------------------------------------
+
+typedef enum { JOB_GAP, JOB_WRITE, JOB_MARK } job_kind_t;
+
+typedef struct job {
+    struct job* next;
+    job_kind_t kind;
+    struct ble_gap_event ev;
+    uint16_t chr;
+    size_t frag;
+    size_t len;
+    uint64_t seq;
+    uint8_t data[];
+} job_t;
+
+static pthread_mutex_t s_m = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_c = PTHREAD_COND_INITIALIZER;
+static job_t* s_head;
+static job_t* s_tail;
+static int s_pending_writes;
+static uint64_t s_seq_posted, s_seq_done;
+static bool s_stop;
+static bool s_running;
+static bool s_in_run;
+static pthread_t s_host_thread;
+
+static struct {
+    ble_gap_event_fn* cb;
+    void* arg;
+    bool advertising;
+    bool connected;
+    uint16_t mtu;
+    struct ble_gap_sec_state sec;
+    fake_ble_link_t link;
+    char name[32];
+    fake_ble_stats_t stats;
+    uint32_t enomem_left;
+    fake_ble_notify_cb_t notify_cb;
+    void* notify_arg;
+} s_ble;
+
+static struct {
+    const struct ble_gatt_chr_def* chr;
+    uint16_t handle;
+} s_chrs[MAX_CHRS];
+static int s_num_chrs;
+
+static void post(job_t* j, bool is_write)
+{
+    pthread_mutex_lock(&s_m);
+    // Link-layer flow control: a real phone cannot outrun the host's ACL buffers
+    while (is_write && s_pending_writes >= FAKE_BLE_ACL_BUFFERS && s_running) {
+        pthread_cond_wait(&s_c, &s_m);
+    }
+    if (is_write) s_pending_writes++;
+    j->seq = ++s_seq_posted;
+    if (s_tail) {
+        s_tail->next = j;
+    } else {
+        s_head = j;
+    }
+    s_tail = j;
+    pthread_cond_broadcast(&s_c);
+    pthread_mutex_unlock(&s_m);
+}
+
+static void post_gap(const struct ble_gap_event* ev)
+{
+    job_t* j = calloc(1, sizeof(*j));
+    j->kind = JOB_GAP;
+    j->ev = *ev;
+    post(j, false);
+}
+
+static void gap_dispatch(struct ble_gap_event* ev)
+{
+    ble_gap_event_fn* cb;
+    void* arg;
+    pthread_mutex_lock(&s_m);
+    cb = s_ble.cb;
+    arg = s_ble.arg;
+    pthread_mutex_unlock(&s_m);
+    if (cb) cb(ev, arg);
+}
+
+static const struct ble_gatt_chr_def* find_chr(uint16_t nus_chr, uint16_t* handle)
+{
+    for (int i = 0; i < s_num_chrs; ++i) {
+        const ble_uuid128_t* u = (const ble_uuid128_t*)s_chrs[i].chr->uuid;
+        if (u->u.type == BLE_UUID_TYPE_128 && (u->value[12] | (u->value[13] << 8)) == nus_chr) {
+            if (handle) *handle = s_chrs[i].handle;
+            return s_chrs[i].chr;
+        }
+    }
+    return NULL;
+}
+
+static struct os_mbuf* mbuf_chain(const uint8_t* data, size_t len, size_t frag)
+{
+    if (frag == 0 || frag > len) frag = len ? len : 1;
+    struct os_mbuf* head = NULL;
+    struct os_mbuf** link = &head;
+    size_t off = 0;
+    do {
+        size_t n = len - off < frag ? len - off : frag;
+        struct os_mbuf* m = calloc(1, sizeof(*m) + n);
+        m->om_data = m->om_databuf;
+        m->om_len = (uint16_t)n;
+        memcpy(m->om_data, data + off, n);
+        *link = m;
+        link = &SLIST_NEXT(m, om_next);
+        off += n;
+    } while (off < len);
+    head->om_pkt_len = (uint16_t)len;
+    return head;
+}
+
+static void run_write(job_t* j)
+{
+    uint16_t handle = 0;
+    const struct ble_gatt_chr_def* chr = find_chr(j->chr, &handle);
+    if (!chr || !chr->access_cb) return;
+    struct ble_gatt_access_ctxt ctxt = {
+        .op = BLE_GATT_ACCESS_OP_WRITE_CHR,
+        .om = mbuf_chain(j->data, j->len, j->frag),
+        .chr = chr,
+    };
+    chr->access_cb(CONN_HANDLE, handle, &ctxt, chr->arg);
+    os_mbuf_free_chain(ctxt.om);
+}
+
+void nimble_port_run(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_in_run = true;
+    s_host_thread = pthread_self();
+    pthread_mutex_unlock(&s_m);
+    if (ble_hs_cfg.sync_cb) ble_hs_cfg.sync_cb();
+    pthread_mutex_lock(&s_m);
+    while (!s_stop) {
+        if (!s_head) {
+            pthread_cond_wait(&s_c, &s_m);
+            continue;
+        }
+        job_t* j = s_head;
+        s_head = j->next;
+        if (!s_head) s_tail = NULL;
+        pthread_mutex_unlock(&s_m);
+
+        if (j->kind == JOB_GAP) {
+            gap_dispatch(&j->ev);
+        } else if (j->kind == JOB_WRITE) {
+            run_write(j);
+        }
+
+        pthread_mutex_lock(&s_m);
+        if (j->kind == JOB_WRITE) s_pending_writes--;
+        s_seq_done = j->seq;
+        pthread_cond_broadcast(&s_c);
+        free(j);
+    }
+    s_running = false;
+    s_in_run = false;
+    pthread_cond_broadcast(&s_c);
+    pthread_mutex_unlock(&s_m);
+}
+
+esp_err_t nimble_port_init(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_stop = false;
+    s_running = true;
+    s_ble.cb = NULL;
+    s_ble.advertising = false;
+    s_ble.connected = false;
+    s_ble.mtu = BLE_ATT_MTU_DFLT;
+    s_num_chrs = 0;
+    pthread_mutex_unlock(&s_m);
+    return ESP_OK;
+}
+
+int nimble_port_stop(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_stop = true;
+    pthread_cond_broadcast(&s_c);
+    // Like the real port: returns once the host task left nimble_port_run
+    while (s_in_run) {
+        pthread_cond_wait(&s_c, &s_m);
+    }
+    pthread_mutex_unlock(&s_m);
+    return 0;
+}
+
+esp_err_t nimble_port_deinit(void)
+{
+    pthread_mutex_lock(&s_m);
+    while (s_head) {
+        job_t* j = s_head;
+        s_head = j->next;
+        free(j);
+    }
+    s_tail = NULL;
+    s_pending_writes = 0;
+    s_seq_done = s_seq_posted;
+    pthread_cond_broadcast(&s_c);
+    pthread_mutex_unlock(&s_m);
+    return ESP_OK;
+}
+
+void nimble_port_freertos_init(TaskFunction_t host_task_fn)
+{
+    xTaskCreate(host_task_fn, "nimble_host", 4096, NULL, 5, NULL);
+}
+
+void nimble_port_freertos_deinit(void)
+{
+    // IDF deletes the host task here, so nothing after it in the task runs
+    if (pthread_equal(pthread_self(), s_host_thread)) vTaskDelete(NULL);
+}
+
+esp_err_t esp_nimble_deinit(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+// ---- mbufs ---------------------------------------------------------------
+
+struct os_mbuf* ble_hs_mbuf_from_flat(const void* buf, uint16_t len)
+{
+    return mbuf_chain((const uint8_t*)buf, len, 0);
+}
+
+int ble_hs_mbuf_to_flat(const struct os_mbuf* om, void* flat, uint16_t max_len, uint16_t* out_copy_len)
+{
+    uint16_t n = 0;
+    int rc = 0;
+    for (const struct os_mbuf* m = om; m; m = SLIST_NEXT(m, om_next)) {
+        uint16_t take = m->om_len;
+        if (n + take > max_len) {
+            take = (uint16_t)(max_len - n);
+            rc = BLE_HS_EMSGSIZE;
+        }
+        memcpy((uint8_t*)flat + n, m->om_data, take);
+        n += take;
+        if (rc) break;
+    }
+    if (out_copy_len) *out_copy_len = n;
+    return rc;
+}
+
+int os_mbuf_free_chain(struct os_mbuf* om)
+{
+    while (om) {
+        struct os_mbuf* n = SLIST_NEXT(om, om_next);
+        free(om);
+        om = n;
+    }
+    return 0;
+}
+
+int ble_uuid_cmp(const ble_uuid_t* a, const ble_uuid_t* b)
+{
+    if (a->type != b->type) return (int)a->type - (int)b->type;
+    return memcmp(((const ble_uuid128_t*)a)->value, ((const ble_uuid128_t*)b)->value, 16);
+}
+
+// ---- GATT server ---------------------------------------------------------
+
+int ble_gatts_count_cfg(const struct ble_gatt_svc_def* defs)
+{
+    return defs ? 0 : BLE_HS_EINVAL;
+}
+
+int ble_gatts_add_svcs(const struct ble_gatt_svc_def* svcs)
+{
+    uint16_t handle = 1;
+    for (const struct ble_gatt_svc_def* s = svcs; s && s->type != BLE_GATT_SVC_TYPE_END; ++s) {
+        handle++; // service declaration
+        for (const struct ble_gatt_chr_def* c = s->characteristics; c && c->uuid; ++c) {
+            if (s_num_chrs >= MAX_CHRS) return BLE_HS_ENOMEM;
+            handle++; // characteristic declaration
+            s_chrs[s_num_chrs].chr = c;
+            s_chrs[s_num_chrs].handle = handle;
+            if (c->val_handle) *c->val_handle = handle;
+            s_num_chrs++;
+            handle++;
+            if (c->flags & BLE_GATT_CHR_F_NOTIFY) handle++; // CCCD
+        }
+    }
+    return 0;
+}
+
+int ble_gatts_notify_custom(uint16_t conn_handle, uint16_t att_handle, struct os_mbuf* om)
+{
+    uint8_t buf[BLE_ATT_ATTR_MAX_LEN];
+    uint16_t len = 0;
+    pthread_mutex_lock(&s_m);
+    if (!s_ble.connected || conn_handle != CONN_HANDLE) {
+        pthread_mutex_unlock(&s_m);
+        os_mbuf_free_chain(om);
+        return BLE_HS_ENOTCONN;
+    }
+    if (s_ble.enomem_left) {
+        // NimBLE keeps ownership on ENOMEM only for the caller to retry; the
+        // real stack frees the mbuf either way
+        s_ble.enomem_left--;
+        s_ble.stats.notify_enomem++;
+        pthread_mutex_unlock(&s_m);
+        os_mbuf_free_chain(om);
+        return BLE_HS_ENOMEM;
+    }
+    fake_ble_notify_cb_t cb = s_ble.notify_cb;
+    void* arg = s_ble.notify_arg;
+    uint16_t mtu = s_ble.mtu;
+    pthread_mutex_unlock(&s_m);
+
+    ble_hs_mbuf_to_flat(om, buf, sizeof(buf), &len);
+    os_mbuf_free_chain(om);
+    if (len > mtu - 3) {
+        fprintf(stderr, "fake_ble: notification of %u bytes exceeds MTU %u\n", len, mtu);
+        return BLE_HS_EMSGSIZE;
+    }
+    pthread_mutex_lock(&s_m);
+    s_ble.stats.notifies++;
+    s_ble.stats.notify_bytes += len;
+    pthread_mutex_unlock(&s_m);
+    (void)att_handle;
+    if (cb) cb(buf, len, arg);
+    return 0;
+}
+
+uint16_t ble_att_mtu(uint16_t conn_handle)
+{
+    pthread_mutex_lock(&s_m);
+    uint16_t mtu = (s_ble.connected && conn_handle == CONN_HANDLE) ? s_ble.mtu : 0;
+    pthread_mutex_unlock(&s_m);
+    return mtu;
+}
+
+// ---- GAP -----------------------------------------------------------------
+
+int ble_gap_conn_find(uint16_t handle, struct ble_gap_conn_desc* out)
+{
+    pthread_mutex_lock(&s_m);
+    bool ok = s_ble.connected && handle == CONN_HANDLE;
+    if (ok && out) {
+        memset(out, 0, sizeof(*out));
+        out->conn_handle = CONN_HANDLE;
+        out->sec_state = s_ble.sec;
+        out->peer_id_addr.val[0] = 0x42;
+    }
+    pthread_mutex_unlock(&s_m);
+    return ok ? 0 : BLE_HS_ENOTCONN;
+}
+
+int ble_gap_update_params(uint16_t conn_handle, const struct ble_gap_upd_params* p)
+{
+    if (ble_gap_conn_find(conn_handle, NULL) != 0) return BLE_HS_ENOTCONN;
+    pthread_mutex_lock(&s_m);
+    s_ble.stats.conn_updates++;
+    s_ble.stats.itvl_min = p->itvl_min;
+    s_ble.stats.itvl_max = p->itvl_max;
+    s_ble.stats.latency = p->latency;
+    pthread_mutex_unlock(&s_m);
+    struct ble_gap_event ev = { .type = BLE_GAP_EVENT_CONN_UPDATE };
+    ev.conn_update.status = 0;
+    ev.conn_update.conn_handle = conn_handle;
+    post_gap(&ev);
+    return 0;
+}
+
+int ble_gap_set_prefered_le_phy(uint16_t conn_handle, uint8_t tx_phys_mask, uint8_t rx_phys_mask, uint16_t phy_opts)
+{
+    (void)tx_phys_mask;
+    (void)rx_phys_mask;
+    (void)phy_opts;
+    if (ble_gap_conn_find(conn_handle, NULL) != 0) return BLE_HS_ENOTCONN;
+    pthread_mutex_lock(&s_m);
+    s_ble.stats.phy_requests++;
+    pthread_mutex_unlock(&s_m);
+    return 0;
+}
+
+int ble_gap_set_data_len(uint16_t conn_handle, uint16_t tx_octets, uint16_t tx_time)
+{
+    (void)tx_time;
+    if (ble_gap_conn_find(conn_handle, NULL) != 0) return BLE_HS_ENOTCONN;
+    pthread_mutex_lock(&s_m);
+    s_ble.stats.dle_requested = tx_octets;
+    pthread_mutex_unlock(&s_m);
+    return 0;
+}
+
+int ble_gap_security_initiate(uint16_t conn_handle)
+{
+    return ble_gap_conn_find(conn_handle, NULL);
+}
+
+int ble_gap_terminate(uint16_t conn_handle, uint8_t hci_reason)
+{
+    pthread_mutex_lock(&s_m);
+    bool ok = s_ble.connected && conn_handle == CONN_HANDLE;
+    s_ble.connected = false;
+    pthread_mutex_unlock(&s_m);
+    if (!ok) return BLE_HS_ENOTCONN;
+    struct ble_gap_event ev = { .type = BLE_GAP_EVENT_DISCONNECT };
+    ev.disconnect.reason = hci_reason;
+    ev.disconnect.conn.conn_handle = conn_handle;
+    post_gap(&ev);
+    return 0;
+}
+
+int ble_gap_adv_set_fields(const struct ble_hs_adv_fields* fields)
+{
+    (void)fields;
+    return 0;
+}
+
+int ble_gap_adv_rsp_set_fields(const struct ble_hs_adv_fields* fields)
+{
+    (void)fields;
+    return 0;
+}
+
+int ble_gap_adv_start(uint8_t own_addr_type, const ble_addr_t* direct_addr, int32_t duration_ms,
+                      const struct ble_gap_adv_params* params, ble_gap_event_fn* cb, void* cb_arg)
+{
+    (void)own_addr_type;
+    (void)direct_addr;
+    (void)duration_ms;
+    pthread_mutex_lock(&s_m);
+    int rc = 0;
+    if (s_ble.advertising) {
+        rc = BLE_HS_EALREADY;
+    } else {
+        s_ble.advertising = true;
+        s_ble.cb = cb;
+        s_ble.arg = cb_arg;
+        s_ble.stats.adv_itvl_min = params ? params->itvl_min : 0;
+        pthread_cond_broadcast(&s_c);
+    }
+    pthread_mutex_unlock(&s_m);
+    return rc;
+}
+
+int ble_gap_adv_stop(void)
+{
+    pthread_mutex_lock(&s_m);
+    int rc = s_ble.advertising ? 0 : BLE_HS_EALREADY;
+    s_ble.advertising = false;
+    pthread_mutex_unlock(&s_m);
+    return rc;
+}
+
+int ble_hs_id_infer_auto(int privacy, uint8_t* out_addr_type)
+{
+    (void)privacy;
+    *out_addr_type = 0;
+    return 0;
+}
+
+void ble_svc_gap_init(void) {}
+
+void ble_svc_gatt_init(void) {}
+
+const char* ble_svc_gap_device_name(void)
+{
+    return s_ble.name;
+}
+
+int ble_svc_gap_device_name_set(const char* name)
+{
+    snprintf(s_ble.name, sizeof(s_ble.name), "%s", name ? name : "");
+    return 0;
+}
+
+int ble_store_util_status_rr(struct ble_store_status_event* event, void* arg)
+{
+    (void)event;
+    (void)arg;
+    return 0;
+}
+
+int ble_store_util_delete_peer(const ble_addr_t* peer_id_addr)
+{
+    (void)peer_id_addr;
+    return 0;
+}
+
+void ble_store_config_init(void) {}
+
+// ---- peer API ------------------------------------------------------------
+
+void fake_ble_set_notify_cb(fake_ble_notify_cb_t cb, void* arg)
+{
+    pthread_mutex_lock(&s_m);
+    s_ble.notify_cb = cb;
+    s_ble.notify_arg = arg;
+    pthread_mutex_unlock(&s_m);
+}
+
+bool fake_ble_wait_advertising(uint32_t timeout_ms)
+{
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        pthread_mutex_lock(&s_m);
+        bool adv = s_ble.advertising && s_ble.cb;
+        pthread_mutex_unlock(&s_m);
+        if (adv) return true;
+        if (xTaskGetTickCount() - start >= timeout_ms) return false;
+        vTaskDelay(1);
+    }
+}
+
+void fake_ble_flush(void)
+{
+    pthread_mutex_lock(&s_m);
+    uint64_t target = s_seq_posted;
+    while (s_seq_done < target && s_running) {
+        pthread_cond_wait(&s_c, &s_m);
+    }
+    pthread_mutex_unlock(&s_m);
+}
+
+int fake_ble_connect(const fake_ble_link_t* link)
+{
+    pthread_mutex_lock(&s_m);
+    if (!s_ble.advertising || s_ble.connected) {
+        pthread_mutex_unlock(&s_m);
+        return BLE_HS_EALREADY;
+    }
+    s_ble.advertising = false;
+    s_ble.connected = true;
+    s_ble.link = *link;
+    s_ble.mtu = BLE_ATT_MTU_DFLT;
+    memset(&s_ble.sec, 0, sizeof(s_ble.sec));
+    pthread_mutex_unlock(&s_m);
+
+    struct ble_gap_event ev = { .type = BLE_GAP_EVENT_CONNECT };
+    ev.connect.status = 0;
+    ev.connect.conn_handle = CONN_HANDLE;
+    post_gap(&ev);
+
+    if (link->mtu > BLE_ATT_MTU_DFLT) {
+        fake_ble_flush();
+        pthread_mutex_lock(&s_m);
+        s_ble.mtu = link->mtu;
+        pthread_mutex_unlock(&s_m);
+        memset(&ev, 0, sizeof(ev));
+        ev.type = BLE_GAP_EVENT_MTU;
+        ev.mtu.conn_handle = CONN_HANDLE;
+        ev.mtu.value = link->mtu;
+        post_gap(&ev);
+    }
+    if (link->phy == 2) {
+        memset(&ev, 0, sizeof(ev));
+        ev.type = BLE_GAP_EVENT_PHY_UPDATE_COMPLETE;
+        ev.phy_updated.conn_handle = CONN_HANDLE;
+        ev.phy_updated.tx_phy = 2;
+        ev.phy_updated.rx_phy = 2;
+        post_gap(&ev);
+    }
+    if (link->dle) {
+        memset(&ev, 0, sizeof(ev));
+        ev.type = BLE_GAP_EVENT_DATA_LEN_CHG;
+        ev.data_len_chg.conn_handle = CONN_HANDLE;
+        ev.data_len_chg.max_tx_octets = link->dle;
+        ev.data_len_chg.max_rx_octets = link->dle;
+        post_gap(&ev);
+    }
+    fake_ble_flush();
+    pthread_mutex_lock(&s_m);
+    s_ble.sec.encrypted = 1;
+    s_ble.sec.bonded = link->bonded;
+    pthread_mutex_unlock(&s_m);
+    memset(&ev, 0, sizeof(ev));
+    ev.type = BLE_GAP_EVENT_ENC_CHANGE;
+    ev.enc_change.conn_handle = CONN_HANDLE;
+    post_gap(&ev);
+
+    uint16_t tx_handle = 0;
+    find_chr(FAKE_NUS_TX, &tx_handle);
+    memset(&ev, 0, sizeof(ev));
+    ev.type = BLE_GAP_EVENT_SUBSCRIBE;
+    ev.subscribe.conn_handle = CONN_HANDLE;
+    ev.subscribe.attr_handle = tx_handle;
+    ev.subscribe.reason = link->bonded ? BLE_GAP_SUBSCRIBE_REASON_RESTORE : BLE_GAP_SUBSCRIBE_REASON_WRITE;
+    ev.subscribe.cur_notify = 1;
+    post_gap(&ev);
+    fake_ble_flush();
+    return 0;
+}
+
+void fake_ble_disconnect(void)
+{
+    ble_gap_terminate(CONN_HANDLE, 0x13);
+    fake_ble_flush();
+}
+
+int fake_ble_write(uint16_t nus_chr, const void* data, size_t len, size_t frag)
+{
+    pthread_mutex_lock(&s_m);
+    bool ok = s_ble.connected;
+    size_t max = (size_t)s_ble.mtu - 3;
+    s_ble.stats.writes++;
+    s_ble.stats.write_bytes += (uint32_t)len;
+    pthread_mutex_unlock(&s_m);
+    if (!ok) return BLE_HS_ENOTCONN;
+    if (len > max) return BLE_HS_EMSGSIZE;
+    job_t* j = calloc(1, sizeof(*j) + len);
+    j->kind = JOB_WRITE;
+    j->chr = nus_chr;
+    j->frag = frag;
+    j->len = len;
+    memcpy(j->data, data, len);
+    post(j, true);
+    return 0;
+}
+
+void fake_ble_inject_notify_enomem(uint32_t n)
+{
+    pthread_mutex_lock(&s_m);
+    s_ble.enomem_left = n;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_ble_get_stats(fake_ble_stats_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    *out = s_ble.stats;
+    out->advertising = s_ble.advertising;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_ble_reset_stats(void)
+{
+    pthread_mutex_lock(&s_m);
+    memset(&s_ble.stats, 0, sizeof(s_ble.stats));
+    pthread_mutex_unlock(&s_m);
+}
@@ -0,0 +1,86 @@
+// Host runner for the Unity stand-in (see fake/include/unity.h)
+
+#include "unity.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define MAX_CASES 128
+
+static struct {
+    const char* name;
+    const char* tags;
+    unity_host_fn_t fn;
+    const char* file;
+    int line;
+} s_cases[MAX_CASES];
+static int s_num_cases;
+static jmp_buf s_jmp;
+
+void unity_host_register(const char* name, const char* tags, unity_host_fn_t fn, const char* file, int line)
+{
+    if (s_num_cases >= MAX_CASES) {
+        fprintf(stderr, "unity: too many cases, dropping \"%s\"\n", name);
+        return;
+    }
+    s_cases[s_num_cases].name = name;
+    s_cases[s_num_cases].tags = tags;
+    s_cases[s_num_cases].fn = fn;
+    s_cases[s_num_cases].file = file;
+    s_cases[s_num_cases].line = line;
+    s_num_cases++;
+}
+
+void unity_host_fail(const char* file, int line, const char* fmt, ...)
+{
+    va_list ap;
+    fprintf(stderr, "%s:%d: FAIL: ", file, line);
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    longjmp(s_jmp, 1);
+}
+
+static bool selected(int i, int argc, char** argv)
+{
+    bool any_tag = false, tag_match = false;
+    for (int a = 1; a < argc; ++a) {
+        if (strcmp(argv[a], "-x") == 0 && a + 1 < argc) {
+            if (strcmp(argv[++a], s_cases[i].name) == 0) return false;
+            continue;
+        }
+        any_tag = true;
+        if (strstr(s_cases[i].tags, argv[a]) || strcmp(s_cases[i].name, argv[a]) == 0) tag_match = true;
+    }
+    return !any_tag || tag_match;
+}
+
+int unity_host_main(int argc, char** argv)
+{
+    int run = 0, failed = 0, skipped = 0;
+    for (int i = 0; i < s_num_cases; ++i) {
+        if (!selected(i, argc, argv)) {
+            skipped++;
+            continue;
+        }
+        run++;
+        printf("%s:%d: %s %s\n", s_cases[i].file, s_cases[i].line, s_cases[i].name, s_cases[i].tags);
+        fflush(stdout);
+        if (setjmp(s_jmp) == 0) {
+            s_cases[i].fn();
+            printf("  PASS\n");
+        } else {
+            failed++;
+        }
+    }
+    printf("-----------------------\n%d Tests %d Failures %d Ignored\n%s\n", run, failed, skipped,
+           failed ? "FAIL" : "OK");
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    return unity_host_main(argc, argv);
+}
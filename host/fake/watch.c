@@ -0,0 +1,433 @@
+// Recording fakes for the watch-side APIs (see fake/include/fake_watch.h)
+
+#include "fake_watch.h"
+
+#include "app_registry.h"
+#include "audio_alert.h"
+#include "boot_seq.h"
+#include "bsp/esp32_s3_touch_amoled_2_06.h"
+#include "display_manager.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl.h"
+#include "notifications.h"
+#include "rtc_lib.h"
+#include "settings.h"
+#include "ui.h"
+#include "ui_perf.h"
+#include "ui_refresh.h"
+#include "ui_state.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_NOTIFS 4096
+
+ESP_EVENT_DEFINE_BASE(BSP_POWER_EVENT_BASE);
+
+static pthread_mutex_t s_m = PTHREAD_MUTEX_INITIALIZER;
+// Serializes "LVGL" like the real display lock
+static pthread_mutex_t s_lvgl = PTHREAD_MUTEX_INITIALIZER;
+
+static struct {
+    int battery;
+    bool charging;
+    int vbus_mv;
+    uint32_t steps;
+    int year, month, day;
+    uint32_t ui_delay_ms;
+    bool lock_fails;
+    fake_watch_counts_t counts;
+} s_w = { .battery = 80, .year = 2025, .month = 6, .day = 1 };
+
+static fake_watch_notif_t* s_notifs;
+
+void fake_watch_reset(void)
+{
+    pthread_mutex_lock(&s_m);
+    memset(&s_w.counts, 0, sizeof(s_w.counts));
+    s_w.ui_delay_ms = 0;
+    s_w.lock_fails = false;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_set_power(int battery_percent, bool charging, int vbus_mv)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.battery = battery_percent;
+    s_w.charging = charging;
+    s_w.vbus_mv = vbus_mv;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_set_steps(uint32_t steps)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.steps = steps;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_set_rtc_date(int year, int month, int day)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.year = year;
+    s_w.month = month;
+    s_w.day = day;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_set_ui_delay_ms(uint32_t ms)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.ui_delay_ms = ms;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_set_display_lock_fails(bool fails)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.lock_fails = fails;
+    pthread_mutex_unlock(&s_m);
+}
+
+void fake_watch_get_counts(fake_watch_counts_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    *out = s_w.counts;
+    pthread_mutex_unlock(&s_m);
+}
+
+bool fake_watch_get_notif(uint32_t i, fake_watch_notif_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    bool ok = s_notifs && i < s_w.counts.notifications && i < MAX_NOTIFS;
+    if (ok) *out = s_notifs[i];
+    pthread_mutex_unlock(&s_m);
+    return ok;
+}
+
+static bool wait_count(const uint32_t* counter, uint32_t n, uint32_t timeout_ms)
+{
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        pthread_mutex_lock(&s_m);
+        bool ok = *counter >= n;
+        pthread_mutex_unlock(&s_m);
+        if (ok) return true;
+        if (xTaskGetTickCount() - start >= timeout_ms) return false;
+        vTaskDelay(1);
+    }
+}
+
+bool fake_watch_wait_notifs(uint32_t n, uint32_t timeout_ms)
+{
+    return wait_count(&s_w.counts.notifications, n, timeout_ms);
+}
+
+bool fake_watch_wait_rtc_sets(uint32_t n, uint32_t timeout_ms)
+{
+    return wait_count(&s_w.counts.rtc_sets, n, timeout_ms);
+}
+
+// ---- BSP -----------------------------------------------------------------
+
+bool bsp_display_lock(uint32_t timeout_ms)
+{
+    (void)timeout_ms;
+    pthread_mutex_lock(&s_m);
+    bool fails = s_w.lock_fails;
+    pthread_mutex_unlock(&s_m);
+    if (fails) return false;
+    pthread_mutex_lock(&s_lvgl);
+    return true;
+}
+
+void bsp_display_unlock(void)
+{
+    pthread_mutex_unlock(&s_lvgl);
+}
+
+lv_result_t lv_async_call(lv_async_cb_t cb, void* user_data)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.counts.async_calls++;
+    pthread_mutex_unlock(&s_m);
+    // Runs right away under the LVGL lock, as the next lv_timer_handler would
+    pthread_mutex_lock(&s_lvgl);
+    cb(user_data);
+    pthread_mutex_unlock(&s_lvgl);
+    return 0;
+}
+
+// ---- GUI -----------------------------------------------------------------
+
+void ui_show_messages_tile(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.counts.messages_tile++;
+    pthread_mutex_unlock(&s_m);
+}
+
+// The journal has its own host test (notif_journal_test.c)
+esp_err_t notifications_store(const char* app, const char* title, const char* message, const char* timestamp_iso8601)
+{
+    return ESP_OK;
+}
+
+void notifications_show(const char* app, const char* title, const char* message, const char* timestamp_iso8601)
+{
+    pthread_mutex_lock(&s_m);
+    uint32_t delay = s_w.ui_delay_ms;
+    pthread_mutex_unlock(&s_m);
+    if (delay) vTaskDelay(pdMS_TO_TICKS(delay));
+
+    pthread_mutex_lock(&s_m);
+    if (!s_notifs) s_notifs = calloc(MAX_NOTIFS, sizeof(*s_notifs));
+    uint32_t i = s_w.counts.notifications;
+    if (s_notifs && i < MAX_NOTIFS) {
+        fake_watch_notif_t* n = &s_notifs[i];
+        n->us = esp_timer_get_time();
+        snprintf(n->app, sizeof(n->app), "%s", app ? app : "");
+        snprintf(n->title, sizeof(n->title), "%s", title ? title : "");
+        snprintf(n->message, sizeof(n->message), "%s", message ? message : "");
+        snprintf(n->timestamp, sizeof(n->timestamp), "%s", timestamp_iso8601 ? timestamp_iso8601 : "");
+    }
+    s_w.counts.notifications++;
+    pthread_mutex_unlock(&s_m);
+}
+
+// The firmware's registry reads icons from SPIFFS; here an app_set only
+// has to reach it
+esp_err_t app_registry_icon_load(const char* icon_file, app_registry_icon_t* out)
+{
+    (void)icon_file;
+    *out = (app_registry_icon_t){ 0 };
+    return ESP_OK;
+}
+
+void app_registry_icon_free(app_registry_icon_t* icon)
+{
+    (void)icon;
+}
+
+esp_err_t app_registry_set(const char* app_id, const char* name, const char* icon_file, app_registry_icon_t* icon)
+{
+    (void)name;
+    (void)icon_file;
+    (void)icon;
+    pthread_mutex_lock(&s_m);
+    s_w.counts.app_sets++;
+    pthread_mutex_unlock(&s_m);
+    return app_id && *app_id ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t app_registry_remove(const char* app_id)
+{
+    return app_id ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t app_registry_save(void)
+{
+    return ESP_OK;
+}
+
+void display_manager_turn_on(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.counts.display_on++;
+    pthread_mutex_unlock(&s_m);
+}
+
+void audio_alert_notify(void)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.counts.audio_alerts++;
+    pthread_mutex_unlock(&s_m);
+}
+
+void audio_alert_get_stats(audio_alert_stats_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    *out = (audio_alert_stats_t){ .requests = s_w.counts.audio_alerts, .played = s_w.counts.audio_alerts };
+    pthread_mutex_unlock(&s_m);
+}
+
+// No display on the host: no frames
+uint32_t ui_perf_frames_total(void)
+{
+    return 0;
+}
+
+uint32_t ui_perf_get_frames(ui_perf_frame_t* out, uint32_t max)
+{
+    (void)out;
+    (void)max;
+    return 0;
+}
+
+void ui_perf_get_summary(uint32_t window_ms, ui_perf_summary_t* out)
+{
+    (void)window_ms;
+    memset(out, 0, sizeof(*out));
+}
+
+void ui_perf_set_overlay(bool on)
+{
+    (void)on;
+}
+
+void ui_refresh_get_stats(ui_refresh_stats_t* out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+// The store as the fake world sets it; the rest reads 0
+int32_t ui_state_get(ui_state_id_t id)
+{
+    pthread_mutex_lock(&s_m);
+    int32_t v = 0;
+    switch (id) {
+    case UI_STATE_BATTERY: v = s_w.battery; break;
+    case UI_STATE_CHARGING: v = s_w.charging; break;
+    case UI_STATE_VBUS: v = s_w.vbus_mv > 0; break;
+    case UI_STATE_STEPS: v = (int32_t)s_w.steps; break;
+    default: break;
+    }
+    pthread_mutex_unlock(&s_m);
+    return v;
+}
+
+const char* ui_state_name(ui_state_id_t id)
+{
+    switch (id) {
+    case UI_STATE_BATTERY: return "battery";
+    case UI_STATE_CHARGING: return "charging";
+    case UI_STATE_VBUS: return "vbus";
+    case UI_STATE_STEPS: return "steps";
+    default: return "other";
+    }
+}
+
+void ui_state_get_stats(ui_state_stats_t* out)
+{
+    memset(out, 0, sizeof(*out));
+}
+
+// ---- Boot timeline -------------------------------------------------------
+
+void boot_seq_mark(const char* name)
+{
+    (void)name;
+}
+
+size_t boot_seq_get_timeline(boot_seq_event_t* out, size_t max)
+{
+    if (max == 0) return 0;
+    out[0] = (boot_seq_event_t){ .name = "host", .end_us = (uint32_t)esp_timer_get_time(), .phase = true };
+    return 1;
+}
+
+// ---- RTC -----------------------------------------------------------------
+
+esp_err_t rtc_set_time(const struct tm* time)
+{
+    pthread_mutex_lock(&s_m);
+    s_w.counts.rtc_sets++;
+    s_w.counts.rtc_last = *time;
+    s_w.year = time->tm_year;
+    s_w.month = time->tm_mon;
+    s_w.day = time->tm_mday;
+    pthread_mutex_unlock(&s_m);
+    return ESP_OK;
+}
+
+int rtc_get_year(void)
+{
+    pthread_mutex_lock(&s_m);
+    int v = s_w.year;
+    pthread_mutex_unlock(&s_m);
+    return v;
+}
+
+int rtc_get_month(void)
+{
+    pthread_mutex_lock(&s_m);
+    int v = s_w.month;
+    pthread_mutex_unlock(&s_m);
+    return v;
+}
+
+int rtc_get_day(void)
+{
+    pthread_mutex_lock(&s_m);
+    int v = s_w.day;
+    pthread_mutex_unlock(&s_m);
+    return v;
+}
+
+// ---- settings ------------------------------------------------------------
+// In-memory stand-in: import keeps the JSON as given, export returns it
+
+static char s_settings_json[256] = "{\"brightness\":30,\"step_goal\":8000}";
+static settings_store_stats_t s_settings_stats = { .record_bytes = 28 };
+
+char* settings_export_json(void)
+{
+    pthread_mutex_lock(&s_m);
+    char* out = strdup(s_settings_json);
+    pthread_mutex_unlock(&s_m);
+    return out;
+}
+
+bool settings_import_json(const char* json)
+{
+    if (!json || json[0] != '{') return false;
+    pthread_mutex_lock(&s_m);
+    snprintf(s_settings_json, sizeof(s_settings_json), "%s", json);
+    s_settings_stats.seq++;
+    s_settings_stats.commits++;
+    s_settings_stats.last_commit_bytes = 96;
+    s_settings_stats.bytes_written += 96;
+    pthread_mutex_unlock(&s_m);
+    settings_wear_note(SETTINGS_PART_NVS, 96, 0);
+    return true;
+}
+
+void settings_get_store_stats(settings_store_stats_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    *out = s_settings_stats;
+    pthread_mutex_unlock(&s_m);
+}
+
+static settings_wear_t s_wear[SETTINGS_PART_COUNT];
+
+void settings_wear_note(settings_part_t part, uint32_t bytes, uint32_t erases)
+{
+    if ((unsigned)part >= SETTINGS_PART_COUNT) return;
+    pthread_mutex_lock(&s_m);
+    s_wear[part].erases += erases + (uint32_t)(((s_wear[part].bytes_written % 4096) + bytes) / 4096);
+    s_wear[part].bytes_written += bytes;
+    pthread_mutex_unlock(&s_m);
+}
+
+static uint32_t s_storage_gen = 1;
+
+void settings_storage_changed(void)
+{
+    __atomic_fetch_add(&s_storage_gen, 1, __ATOMIC_RELAXED);
+}
+
+uint32_t settings_storage_generation(void)
+{
+    return __atomic_load_n(&s_storage_gen, __ATOMIC_RELAXED);
+}
+
+void settings_get_wear(settings_part_t part, settings_wear_t* out)
+{
+    pthread_mutex_lock(&s_m);
+    *out = (unsigned)part < SETTINGS_PART_COUNT ? s_wear[part] : (settings_wear_t){ 0 };
+    pthread_mutex_unlock(&s_m);
+}
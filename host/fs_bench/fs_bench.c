@@ -0,0 +1,679 @@
+// SPIFFS vs LittleFS on an emulated copy of the 7 MB storage partition.
+//
+// Both filesystems run unmodified on a RAM image that behaves like NOR flash
+// (programming only clears bits, erase works on 4 KB sectors) and charges
+// every access with datasheet timings for the watch's quad-SPI flash. The
+// workload follows what the firmware does with /spiffs: icons and sounds
+// uploaded over BLE in 244-byte writes, a directory listing that stats every
+// entry (storage_file_explorer.c), images opened, seeked and read by LVGL
+// (lvgl_spiffs_fs.c), and rewrites once the partition is mostly full.
+//
+// Times are modeled flash time; host CPU time is shown in parentheses and
+// is far below what the ESP32-S3 spends, so treat it as a lower bound.
+// SPIFFS is configured like CONFIG_SPIFFS_* in sdkconfig, LittleFS like the
+// joltwallet/littlefs defaults.
+//
+// The decode phase repeats what LVGL's bin decoder does per image (open,
+// read the header, close; open, read header and pixels, close) for a few
+// screens' worth of icons, straight on the filesystem and through the block
+// cache in front of lvgl_spiffs_fs.c (components/gui/src/fs_cache.c).
+
+#include "fs_cache.h"
+#include "lfs.h"
+#include "spiffs.h"
+#include "spiffs_nucleus.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+#define SECTOR_SIZE 4096u
+#define PAGE_SIZE   256u
+
+// Flash timings (W25Q-class, 80 MHz QIO): read command + address + dummy,
+// then 4 bits per clock; page program and sector erase typicals
+#define T_READ_CMD_US   0.5
+#define T_READ_BYTE_US  0.025
+#define T_PROG_PAGE_US  400.0
+#define T_ERASE_US      45000.0
+
+typedef struct {
+    uint32_t size;
+    double fill;
+    unsigned seed;
+    const char* only;
+} opts_t;
+
+static opts_t s_opt;
+
+// ---- emulated flash ------------------------------------------------------
+
+static struct {
+    uint8_t* mem;
+    uint64_t reads;
+    uint64_t read_bytes;
+    uint64_t pages;     // page programs, partial pages included
+    uint64_t erases;
+    double us;
+} s_flash;
+
+static void flash_read(uint32_t addr, uint32_t size, void* dst)
+{
+    memcpy(dst, s_flash.mem + addr, size);
+    s_flash.reads++;
+    s_flash.read_bytes += size;
+    s_flash.us += T_READ_CMD_US + size * T_READ_BYTE_US;
+}
+
+static void flash_prog(uint32_t addr, uint32_t size, const void* src)
+{
+    const uint8_t* s = (const uint8_t*)src;
+    for (uint32_t i = 0; i < size; ++i) s_flash.mem[addr + i] &= s[i];
+    if (!size) return;
+    uint32_t pages = (addr + size - 1) / PAGE_SIZE - addr / PAGE_SIZE + 1;
+    s_flash.pages += pages;
+    s_flash.us += pages * T_PROG_PAGE_US;
+}
+
+static void flash_erase(uint32_t addr)
+{
+    memset(s_flash.mem + addr / SECTOR_SIZE * SECTOR_SIZE, 0xFF, SECTOR_SIZE);
+    s_flash.erases++;
+    s_flash.us += T_ERASE_US;
+}
+
+static void flash_reset(void)
+{
+    memset(s_flash.mem, 0xFF, s_opt.size);
+    s_flash.reads = s_flash.read_bytes = s_flash.pages = s_flash.erases = 0;
+    s_flash.us = 0;
+}
+
+typedef struct {
+    double flash_us;
+    clock_t cpu;
+} probe_t;
+
+static probe_t probe_start(void)
+{
+    return (probe_t){ s_flash.us, clock() };
+}
+
+// Modeled flash time since `p`, and host CPU time through `cpu_us`
+static double probe_us(const probe_t* p, double* cpu_us)
+{
+    if (cpu_us) *cpu_us = (double)(clock() - p->cpu) * 1e6 / CLOCKS_PER_SEC;
+    return s_flash.us - p->flash_us;
+}
+
+// ---- filesystem backends -------------------------------------------------
+
+typedef struct {
+    const char* name;
+    bool (*format)(void);
+    bool (*mount)(void);
+    void (*unmount)(void);
+    bool (*write_file)(const char* path, const uint8_t* data, size_t len, size_t chunk);
+    bool (*read_at)(const char* path, uint32_t off, uint8_t* buf, size_t len);
+    int (*list)(uint64_t* bytes);     // entries; every one is stat'ed
+    bool (*remove)(const char* path);
+    fs_cache_ops_t file;              // handle API, as the LVGL driver sees it
+} fs_ops_t;
+
+// SPIFFS, sized like esp_spiffs.c does for max_files = 8
+
+#define SP_MAX_FILES 8
+
+static spiffs s_sp;
+static u8_t s_sp_work[2 * PAGE_SIZE];
+static u8_t s_sp_fds[SP_MAX_FILES * sizeof(spiffs_fd)];
+static u8_t s_sp_cache[sizeof(spiffs_cache) + SP_MAX_FILES * (sizeof(spiffs_cache_page) + PAGE_SIZE)];
+
+static s32_t sp_hal_read(u32_t addr, u32_t size, u8_t* dst)
+{
+    flash_read(addr, size, dst);
+    return SPIFFS_OK;
+}
+
+static s32_t sp_hal_write(u32_t addr, u32_t size, u8_t* src)
+{
+    flash_prog(addr, size, src);
+    return SPIFFS_OK;
+}
+
+static s32_t sp_hal_erase(u32_t addr, u32_t size)
+{
+    for (u32_t a = addr; a < addr + size; a += SECTOR_SIZE) flash_erase(a);
+    return SPIFFS_OK;
+}
+
+static bool sp_mount(void)
+{
+    spiffs_config cfg = {
+        .hal_read_f = sp_hal_read,
+        .hal_write_f = sp_hal_write,
+        .hal_erase_f = sp_hal_erase,
+        .phys_size = s_opt.size,
+        .phys_addr = 0,
+        .phys_erase_block = SECTOR_SIZE,
+        .log_block_size = SECTOR_SIZE,
+        .log_page_size = PAGE_SIZE,
+    };
+    return SPIFFS_mount(&s_sp, &cfg, s_sp_work, s_sp_fds, sizeof(s_sp_fds), s_sp_cache, sizeof(s_sp_cache),
+                        NULL) == SPIFFS_OK;
+}
+
+static void sp_unmount(void)
+{
+    SPIFFS_unmount(&s_sp);
+}
+
+static bool sp_format(void)
+{
+    // SPIFFS_format needs the configuration a mount attempt leaves behind
+    if (sp_mount()) sp_unmount();
+    return SPIFFS_format(&s_sp) == SPIFFS_OK;
+}
+
+static bool sp_write_file(const char* path, const uint8_t* data, size_t len, size_t chunk)
+{
+    spiffs_file f = SPIFFS_open(&s_sp, path, SPIFFS_O_CREAT | SPIFFS_O_TRUNC | SPIFFS_O_WRONLY, 0);
+    if (f < 0) return false;
+    bool ok = true;
+    for (size_t off = 0; ok && off < len; off += chunk) {
+        s32_t n = (s32_t)(len - off < chunk ? len - off : chunk);
+        ok = SPIFFS_write(&s_sp, f, (void*)(data + off), n) == n;
+    }
+    return SPIFFS_close(&s_sp, f) == SPIFFS_OK && ok;
+}
+
+static bool sp_read_at(const char* path, uint32_t off, uint8_t* buf, size_t len)
+{
+    spiffs_file f = SPIFFS_open(&s_sp, path, SPIFFS_O_RDONLY, 0);
+    if (f < 0) return false;
+    bool ok = SPIFFS_lseek(&s_sp, f, (s32_t)off, SPIFFS_SEEK_SET) >= 0 &&
+              SPIFFS_read(&s_sp, f, buf, (s32_t)len) == (s32_t)len;
+    SPIFFS_close(&s_sp, f);
+    return ok;
+}
+
+static int sp_list(uint64_t* bytes)
+{
+    spiffs_DIR d;
+    struct spiffs_dirent e, *pe;
+    int n = 0;
+    *bytes = 0;
+    if (!SPIFFS_opendir(&s_sp, "/", &d)) return -1;
+    while ((pe = SPIFFS_readdir(&d, &e)) != NULL) {
+        spiffs_stat st;
+        if (SPIFFS_stat(&s_sp, (const char*)pe->name, &st) == SPIFFS_OK) *bytes += st.size;
+        n++;
+    }
+    SPIFFS_closedir(&d);
+    return n;
+}
+
+static bool sp_remove(const char* path)
+{
+    return SPIFFS_remove(&s_sp, path) == SPIFFS_OK;
+}
+
+// Handles are fd + 1 so that fd 0 is not NULL
+static void* sp_open(const char* path, uint32_t* size)
+{
+    spiffs_file f = SPIFFS_open(&s_sp, path, SPIFFS_O_RDONLY, 0);
+    if (f < 0) return NULL;
+    spiffs_stat st;
+    if (SPIFFS_fstat(&s_sp, f, &st) != SPIFFS_OK) {
+        SPIFFS_close(&s_sp, f);
+        return NULL;
+    }
+    *size = st.size;
+    return (void*)(intptr_t)(f + 1);
+}
+
+static int sp_pread(void* h, uint32_t pos, void* buf, uint32_t len)
+{
+    spiffs_file f = (spiffs_file)((intptr_t)h - 1);
+    if (SPIFFS_lseek(&s_sp, f, (s32_t)pos, SPIFFS_SEEK_SET) < 0) return -1;
+    s32_t n = SPIFFS_read(&s_sp, f, buf, (s32_t)len);
+    return n == SPIFFS_ERR_END_OF_OBJECT ? 0 : n;
+}
+
+static void sp_close(void* h)
+{
+    SPIFFS_close(&s_sp, (spiffs_file)((intptr_t)h - 1));
+}
+
+static const fs_ops_t k_spiffs = {
+    "SPIFFS", sp_format, sp_mount, sp_unmount, sp_write_file, sp_read_at, sp_list, sp_remove,
+    { sp_open, sp_pread, sp_close },
+};
+
+// LittleFS, with the joltwallet/littlefs Kconfig defaults
+
+static lfs_t s_lfs;
+
+static int lfs_hal_read(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, void* buf, lfs_size_t size)
+{
+    flash_read(block * SECTOR_SIZE + off, size, buf);
+    return 0;
+}
+
+static int lfs_hal_prog(const struct lfs_config* c, lfs_block_t block, lfs_off_t off, const void* buf,
+                        lfs_size_t size)
+{
+    flash_prog(block * SECTOR_SIZE + off, size, buf);
+    return 0;
+}
+
+static int lfs_hal_erase(const struct lfs_config* c, lfs_block_t block)
+{
+    flash_erase(block * SECTOR_SIZE);
+    return 0;
+}
+
+static int lfs_hal_sync(const struct lfs_config* c)
+{
+    return 0;
+}
+
+static struct lfs_config s_lfs_cfg = {
+    .read = lfs_hal_read,
+    .prog = lfs_hal_prog,
+    .erase = lfs_hal_erase,
+    .sync = lfs_hal_sync,
+    .read_size = 128,       // CONFIG_LITTLEFS_READ_SIZE
+    .prog_size = 128,       // CONFIG_LITTLEFS_WRITE_SIZE
+    .block_size = SECTOR_SIZE,
+    .block_cycles = 512,    // CONFIG_LITTLEFS_BLOCK_CYCLES
+    .cache_size = 512,      // CONFIG_LITTLEFS_CACHE_SIZE
+    .lookahead_size = 128,  // CONFIG_LITTLEFS_LOOKAHEAD_SIZE
+};
+
+static bool lf_format(void)
+{
+    s_lfs_cfg.block_count = s_opt.size / SECTOR_SIZE;
+    return lfs_format(&s_lfs, &s_lfs_cfg) == 0;
+}
+
+static bool lf_mount(void)
+{
+    s_lfs_cfg.block_count = s_opt.size / SECTOR_SIZE;
+    return lfs_mount(&s_lfs, &s_lfs_cfg) == 0;
+}
+
+static void lf_unmount(void)
+{
+    lfs_unmount(&s_lfs);
+}
+
+static bool lf_write_file(const char* path, const uint8_t* data, size_t len, size_t chunk)
+{
+    lfs_file_t f;
+    if (lfs_file_open(&s_lfs, &f, path, LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC) < 0) return false;
+    bool ok = true;
+    for (size_t off = 0; ok && off < len; off += chunk) {
+        lfs_size_t n = (lfs_size_t)(len - off < chunk ? len - off : chunk);
+        ok = lfs_file_write(&s_lfs, &f, data + off, n) == (lfs_ssize_t)n;
+    }
+    return lfs_file_close(&s_lfs, &f) == 0 && ok;
+}
+
+static bool lf_read_at(const char* path, uint32_t off, uint8_t* buf, size_t len)
+{
+    lfs_file_t f;
+    if (lfs_file_open(&s_lfs, &f, path, LFS_O_RDONLY) < 0) return false;
+    bool ok = lfs_file_seek(&s_lfs, &f, (lfs_soff_t)off, LFS_SEEK_SET) >= 0 &&
+              lfs_file_read(&s_lfs, &f, buf, (lfs_size_t)len) == (lfs_ssize_t)len;
+    lfs_file_close(&s_lfs, &f);
+    return ok;
+}
+
+static int lf_list(uint64_t* bytes)
+{
+    lfs_dir_t d;
+    struct lfs_info info;
+    int n = 0;
+    *bytes = 0;
+    if (lfs_dir_open(&s_lfs, &d, "/") < 0) return -1;
+    while (lfs_dir_read(&s_lfs, &d, &info) > 0) {
+        if (!strcmp(info.name, ".") || !strcmp(info.name, "..")) continue;
+        // The VFS stat()s by path, as the explorer does
+        char path[LFS_NAME_MAX + 2];
+        struct lfs_info st;
+        snprintf(path, sizeof(path), "/%s", info.name);
+        if (lfs_stat(&s_lfs, path, &st) == 0) *bytes += st.size;
+        n++;
+    }
+    lfs_dir_close(&s_lfs, &d);
+    return n;
+}
+
+static bool lf_remove(const char* path)
+{
+    return lfs_remove(&s_lfs, path) == 0;
+}
+
+static void* lf_open(const char* path, uint32_t* size)
+{
+    lfs_file_t* f = malloc(sizeof(*f));
+    if (!f) return NULL;
+    if (lfs_file_open(&s_lfs, f, path, LFS_O_RDONLY) < 0) {
+        free(f);
+        return NULL;
+    }
+    *size = (uint32_t)lfs_file_size(&s_lfs, f);
+    return f;
+}
+
+static int lf_pread(void* h, uint32_t pos, void* buf, uint32_t len)
+{
+    if (lfs_file_seek(&s_lfs, h, (lfs_soff_t)pos, LFS_SEEK_SET) < 0) return -1;
+    return lfs_file_read(&s_lfs, h, buf, len);
+}
+
+static void lf_close(void* h)
+{
+    lfs_file_close(&s_lfs, h);
+    free(h);
+}
+
+static const fs_ops_t k_littlefs = {
+    "LittleFS", lf_format, lf_mount, lf_unmount, lf_write_file, lf_read_at, lf_list, lf_remove,
+    { lf_open, lf_pread, lf_close },
+};
+
+// ---- workload ------------------------------------------------------------
+
+#define ICONS        64
+#define ICON_BYTES   (96 * 96 * 3)   // RGB565A8
+#define SOUNDS       4
+#define SOUND_BYTES  (256 * 1024)
+#define NOTES        200
+#define NOTE_BYTES   512
+#define FILLER_BYTES (64 * 1024)
+#define BLE_CHUNK    244             // file transfer payload per frame
+#define READS        500
+#define READ_BYTES   1024
+#define REWRITES     16
+#define DECODE_SET   8               // icons a couple of screens cycle through
+#define DECODE_SHOWN 6               // icons per screen visit
+#define DECODE_VISITS 40
+#define IMG_HEADER   12              // lv_image_header_t
+#define CACHE_BYTES  (256 * 1024)    // LVGL_FS_CACHE_BYTES
+
+typedef struct {
+    double mount_us;
+    int entries;
+    double list_us, list_cpu;
+    double read_p50_us, read_p99_us, read_mean_us;
+    double write_kbs;           // icons, 4 KB writes, empty partition
+    double write_ble_kbs;       // sounds, 244 B writes
+    double write_full_kbs;      // sound rewrites with the partition `fill` full
+    double decode_us;           // per image, straight on the filesystem
+    double decode_cached_us;    // per image, through fs_cache
+    fs_cache_stats_t cache;
+    uint64_t reads, read_bytes, pages, erases;
+    bool ok;
+} result_t;
+
+static uint8_t* s_data;
+
+static double kbs(size_t bytes, double us)
+{
+    return us > 0 ? bytes / 1024.0 / (us / 1e6) : 0;
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+// One image the way LVGL's bin decoder reads it: info (header only), then
+// open (header and pixels). `cached` goes through fs_cache like the driver.
+static bool decode_image(const fs_ops_t* fs, const char* path, bool cached, uint8_t* buf)
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        uint32_t want = pass ? ICON_BYTES : IMG_HEADER;
+        int n;
+        if (cached) {
+            fs_cache_file_t* f = fs_cache_open(path);
+            if (!f) return false;
+            n = fs_cache_read(f, buf, IMG_HEADER);
+            if (n == IMG_HEADER && pass) n += fs_cache_read(f, buf + IMG_HEADER, want - IMG_HEADER);
+            fs_cache_close(f);
+        } else {
+            uint32_t size;
+            void* h = fs->file.open(path, &size);
+            if (!h) return false;
+            n = fs->file.read(h, 0, buf, IMG_HEADER);
+            if (n == IMG_HEADER && pass) n += fs->file.read(h, IMG_HEADER, buf + IMG_HEADER, want - IMG_HEADER);
+            fs->file.close(h);
+        }
+        if (n != (int)want) return false;
+    }
+    return true;
+}
+
+static bool decode_run(const fs_ops_t* fs, bool cached, double* us_per_image)
+{
+    static uint8_t buf[ICON_BYTES];
+    char path[48];
+    srand(s_opt.seed);
+    probe_t p = probe_start();
+    for (int v = 0; v < DECODE_VISITS; ++v) {
+        for (int i = 0; i < DECODE_SHOWN; ++i) {
+            int icon = rand() % DECODE_SET;
+            snprintf(path, sizeof(path), "/icon_%02d.bin", icon);
+            if (!decode_image(fs, path, cached, buf) || memcmp(buf, s_data + icon * 97, ICON_BYTES) != 0) {
+                fprintf(stderr, "%s: decoding %s%s failed\n", fs->name, path, cached ? " (cached)" : "");
+                return false;
+            }
+        }
+    }
+    *us_per_image = probe_us(&p, NULL) / (DECODE_VISITS * DECODE_SHOWN);
+    return true;
+}
+
+static bool run(const fs_ops_t* fs, result_t* r)
+{
+    char path[48];
+    memset(r, 0, sizeof(*r));
+    flash_reset();
+    srand(s_opt.seed);
+    if (!fs->format() || !fs->mount()) {
+        fprintf(stderr, "%s: format/mount failed\n", fs->name);
+        return false;
+    }
+
+    probe_t p = probe_start();
+    for (int i = 0; i < ICONS; ++i) {
+        snprintf(path, sizeof(path), "/icon_%02d.bin", i);
+        if (!fs->write_file(path, s_data + i * 97, ICON_BYTES, 4096)) return false;
+    }
+    r->write_kbs = kbs((size_t)ICONS * ICON_BYTES, probe_us(&p, NULL));
+
+    p = probe_start();
+    for (int i = 0; i < SOUNDS; ++i) {
+        snprintf(path, sizeof(path), "/sound_%d.wav", i);
+        if (!fs->write_file(path, s_data + i * 131, SOUND_BYTES, BLE_CHUNK)) return false;
+    }
+    r->write_ble_kbs = kbs((size_t)SOUNDS * SOUND_BYTES, probe_us(&p, NULL));
+
+    for (int i = 0; i < NOTES; ++i) {
+        snprintf(path, sizeof(path), "/note_%03d.json", i);
+        if (!fs->write_file(path, s_data + i, NOTE_BYTES, NOTE_BYTES)) return false;
+    }
+
+    fs->unmount();
+    p = probe_start();
+    if (!fs->mount()) {
+        fprintf(stderr, "%s: remount failed\n", fs->name);
+        return false;
+    }
+    r->mount_us = probe_us(&p, NULL);
+
+    uint64_t bytes = 0;
+    p = probe_start();
+    r->entries = fs->list(&bytes);
+    r->list_us = probe_us(&p, &r->list_cpu);
+
+    // LVGL image/font access: open, seek, read, close
+    static double lat[READS];
+    static uint8_t buf[READ_BYTES];
+    double sum = 0;
+    for (int i = 0; i < READS; ++i) {
+        int icon = rand() % ICONS;
+        uint32_t off = (uint32_t)(rand() % (ICON_BYTES - READ_BYTES));
+        snprintf(path, sizeof(path), "/icon_%02d.bin", icon);
+        p = probe_start();
+        if (!fs->read_at(path, off, buf, READ_BYTES)) return false;
+        lat[i] = probe_us(&p, NULL);
+        sum += lat[i];
+        if (memcmp(buf, s_data + icon * 97 + off, READ_BYTES) != 0) {
+            fprintf(stderr, "%s: %s reads back wrong data\n", fs->name, path);
+            return false;
+        }
+    }
+    qsort(lat, READS, sizeof(lat[0]), cmp_double);
+    r->read_p50_us = lat[READS / 2];
+    r->read_p99_us = lat[READS * 99 / 100];
+    r->read_mean_us = sum / READS;
+
+    static uint8_t cache_mem[CACHE_BYTES];
+    if (!decode_run(fs, false, &r->decode_us)) return false;
+    fs_cache_init(&fs->file, cache_mem, sizeof(cache_mem));
+    bool cached_ok = decode_run(fs, true, &r->decode_cached_us);
+    fs_cache_get_stats(&r->cache);
+    fs_cache_invalidate();      // closes the handles it kept open
+    if (!cached_ok) return false;
+
+    // Fill, drop every other note, then keep replacing sounds: SPIFFS now
+    // garbage-collects inside the writes
+    size_t used = (size_t)ICONS * ICON_BYTES + (size_t)SOUNDS * SOUND_BYTES + (size_t)NOTES * NOTE_BYTES;
+    size_t target = (size_t)(s_opt.size * s_opt.fill);
+    for (int i = 0; used + FILLER_BYTES < target; ++i, used += FILLER_BYTES) {
+        snprintf(path, sizeof(path), "/fill_%03d.bin", i);
+        if (!fs->write_file(path, s_data + i * 7, FILLER_BYTES, 4096)) {
+            fprintf(stderr, "%s: full at %zu bytes\n", fs->name, used);
+            break;
+        }
+    }
+    for (int i = 0; i < NOTES; i += 2) {
+        snprintf(path, sizeof(path), "/note_%03d.json", i);
+        fs->remove(path);
+    }
+    p = probe_start();
+    for (int i = 0; i < REWRITES; ++i) {
+        snprintf(path, sizeof(path), "/sound_%d.wav", i % SOUNDS);
+        if (!fs->write_file(path, s_data + i * 59, SOUND_BYTES, BLE_CHUNK)) {
+            fprintf(stderr, "%s: rewrite %d failed\n", fs->name, i);
+            return false;
+        }
+    }
+    r->write_full_kbs = kbs((size_t)REWRITES * SOUND_BYTES, probe_us(&p, NULL));
+
+    fs->unmount();
+    r->reads = s_flash.reads;
+    r->read_bytes = s_flash.read_bytes;
+    r->pages = s_flash.pages;
+    r->erases = s_flash.erases;
+    r->ok = true;
+    return true;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr, "usage: %s [--size bytes] [--fill fraction] [--seed n] [--only spiffs|littlefs]\n", argv0);
+}
+
+int main(int argc, char** argv)
+{
+    s_opt = (opts_t){ .size = 7u * 1024 * 1024, .fill = 0.85, .seed = 1 };
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--size")) s_opt.size = (uint32_t)strtoul(v, NULL, 0) / SECTOR_SIZE * SECTOR_SIZE;
+        else if (!strcmp(a, "--fill")) s_opt.fill = atof(v);
+        else if (!strcmp(a, "--seed")) s_opt.seed = (unsigned)atoi(v);
+        else if (!strcmp(a, "--only")) s_opt.only = v;
+        else { usage(argv[0]); return 2; }
+        ++i;
+    }
+    if (s_opt.size < 4u * 1024 * 1024 || s_opt.fill <= 0 || s_opt.fill >= 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    s_flash.mem = malloc(s_opt.size);
+    size_t data_len = SOUND_BYTES + 64 * 1024;
+    s_data = malloc(data_len);
+    if (!s_flash.mem || !s_data) return 1;
+    srand(s_opt.seed);
+    for (size_t i = 0; i < data_len; ++i) s_data[i] = (uint8_t)rand();
+
+    const fs_ops_t* const all[] = { &k_spiffs, &k_littlefs };
+    result_t res[2];
+    int n = 0;
+    const fs_ops_t* ran[2];
+    for (int i = 0; i < 2; ++i) {
+        if (s_opt.only && strcasecmp(s_opt.only, all[i]->name) != 0) continue;
+        ran[n] = all[i];
+        if (!run(all[i], &res[n]) || !res[n].ok) {
+            printf("%-22s FAILED\n", all[i]->name);
+            return 1;
+        }
+        n++;
+    }
+
+    printf("partition %u KB, fill %.0f%%, modeled flash time (host CPU)\n", (unsigned)(s_opt.size / 1024),
+           s_opt.fill * 100);
+    printf("%-26s", "");
+    for (int i = 0; i < n; ++i) printf("%18s", ran[i]->name);
+    printf("\n%-26s", "mount");
+    for (int i = 0; i < n; ++i) printf("%15.1f ms", res[i].mount_us / 1000);
+    printf("\n%-26s", "list + stat");
+    for (int i = 0; i < n; ++i) printf("%15.1f ms", res[i].list_us / 1000);
+    printf("\n%-26s", "  entries (cpu)");
+    for (int i = 0; i < n; ++i) printf("%7d (%5.1f ms)", res[i].entries, res[i].list_cpu / 1000);
+    printf("\n%-26s", "1 KB read p50");
+    for (int i = 0; i < n; ++i) printf("%15.2f ms", res[i].read_p50_us / 1000);
+    printf("\n%-26s", "1 KB read p99");
+    for (int i = 0; i < n; ++i) printf("%15.2f ms", res[i].read_p99_us / 1000);
+    printf("\n%-26s", "image decode");
+    for (int i = 0; i < n; ++i) printf("%15.2f ms", res[i].decode_us / 1000);
+    printf("\n%-26s", "  through fs_cache");
+    for (int i = 0; i < n; ++i) printf("%15.2f ms", res[i].decode_cached_us / 1000);
+    printf("\n%-26s", "  block hits / misses");
+    for (int i = 0; i < n; ++i)
+        printf("%11lu / %4lu", (unsigned long)res[i].cache.hits, (unsigned long)res[i].cache.misses);
+    printf("\n%-26s", "  fs opens / opens");
+    for (int i = 0; i < n; ++i)
+        printf("%11lu / %4lu", (unsigned long)res[i].cache.backend_opens, (unsigned long)res[i].cache.opens);
+    printf("\n%-26s", "write 4 KB chunks");
+    for (int i = 0; i < n; ++i) printf("%13.1f kB/s", res[i].write_kbs);
+    printf("\n%-26s", "write 244 B chunks");
+    for (int i = 0; i < n; ++i) printf("%13.1f kB/s", res[i].write_ble_kbs);
+    printf("\n%-26s", "rewrite when full");
+    for (int i = 0; i < n; ++i) printf("%13.1f kB/s", res[i].write_full_kbs);
+    printf("\n%-26s", "flash reads");
+    for (int i = 0; i < n; ++i) printf("%18llu", (unsigned long long)res[i].reads);
+    printf("\n%-26s", "  bytes read");
+    for (int i = 0; i < n; ++i) printf("%15.1f MB", res[i].read_bytes / 1048576.0);
+    printf("\n%-26s", "pages programmed");
+    for (int i = 0; i < n; ++i) printf("%18llu", (unsigned long long)res[i].pages);
+    printf("\n%-26s", "sectors erased");
+    for (int i = 0; i < n; ++i) printf("%18llu", (unsigned long long)res[i].erases);
+    printf("\n");
+
+    free(s_data);
+    free(s_flash.mem);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+// SPIFFS build configuration for fs_bench, matching what ESP-IDF's spiffs
+// component compiles from this project's sdkconfig (CONFIG_SPIFFS_*).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef int32_t s32_t;
+typedef uint32_t u32_t;
+typedef int16_t s16_t;
+typedef uint16_t u16_t;
+typedef int8_t s8_t;
+typedef uint8_t u8_t;
+
+#define SPIFFS_DBG(...)
+#define SPIFFS_GC_DBG(...)
+#define SPIFFS_CACHE_DBG(...)
+#define SPIFFS_CHECK_DBG(...)
+#define SPIFFS_API_DBG(...)
+
+#define SPIFFS_BUFFER_HELP              0
+#define SPIFFS_CACHE                    1   // CONFIG_SPIFFS_CACHE
+#define SPIFFS_CACHE_WR                 1   // CONFIG_SPIFFS_CACHE_WR
+#define SPIFFS_CACHE_STATS              0
+#define SPIFFS_PAGE_CHECK               1   // CONFIG_SPIFFS_PAGE_CHECK
+#define SPIFFS_GC_MAX_RUNS              10  // CONFIG_SPIFFS_GC_MAX_RUNS
+#define SPIFFS_GC_STATS                 0
+#define SPIFFS_GC_HEUR_W_DELET          (5)
+#define SPIFFS_GC_HEUR_W_USED           (-1)
+#define SPIFFS_GC_HEUR_W_ERASE_AGE      (50)
+#define SPIFFS_OBJ_NAME_LEN             32  // CONFIG_SPIFFS_OBJ_NAME_LEN
+#define SPIFFS_OBJ_META_LEN             4   // CONFIG_SPIFFS_META_LENGTH (mtime)
+#define SPIFFS_COPY_BUFFER_STACK        (256)
+#define SPIFFS_USE_MAGIC                1   // CONFIG_SPIFFS_USE_MAGIC
+#define SPIFFS_USE_MAGIC_LENGTH         1   // CONFIG_SPIFFS_USE_MAGIC_LENGTH
+#define SPIFFS_LOCK(fs)
+#define SPIFFS_UNLOCK(fs)
+#define SPIFFS_SINGLETON                0
+#define SPIFFS_ALIGNED_OBJECT_INDEX_TABLES 0
+#define SPIFFS_HAL_CALLBACK_EXTRA       0
+#define SPIFFS_FILEHDL_OFFSET           0
+#define SPIFFS_READ_ONLY                0
+#define SPIFFS_TEMPORAL_FD_CACHE        1
+#define SPIFFS_TEMPORAL_CACHE_HIT_SCORE 4
+#define SPIFFS_IX_MAP                   1
+#define SPIFFS_NO_BLIND_WRITES          0
+#define SPIFFS_TEST_VISUALISATION       0
+#define SPIFFS_SECURE_ERASE             0
+
+typedef u16_t spiffs_block_ix;
+typedef u16_t spiffs_page_ix;
+typedef u16_t spiffs_obj_id;
+typedef u16_t spiffs_span_ix;
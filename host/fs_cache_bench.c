@@ -0,0 +1,275 @@
+// Image decode through the LVGL driver's block cache (components/gui/src/
+// fs_cache.c) on the host filesystem, with the same stdio backend the
+// driver uses. Unlike fs_bench it needs no downloaded sources, so it runs
+// as part of the normal host build.
+//
+// A screen visit decodes DECODE_SHOWN of DECODE_SET icons the way LVGL's
+// bin decoder reads them (header for the info, then header and pixels).
+// Between visits a notification is appended to a journal file in the same
+// directory. Three ways of reading are compared:
+//
+//   direct       every decode opens and reads the file
+//   wear gen     cached, generation = bytes written to storage: the append
+//                moves it, so every visit starts cold
+//   storage gen  cached, generation = settings_storage_generation(): only
+//                creates, renames and removes move it, so visits stay warm
+//
+// Per image it reports backend opens, reads and bytes, and a flash time
+// modeled from them with fs_bench's read timings (filesystem metadata
+// lookups not included), next to host wall time. Halfway through one icon
+// is replaced (write, rename, generation bump) and every decode is checked
+// against the current file contents.
+//
+//   fs_cache_bench [--out dir]
+
+#include "fs_cache.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+// W25Q-class flash at 80 MHz QIO, as in fs_bench
+#define T_READ_CMD_US   0.5
+#define T_READ_BYTE_US  0.025
+
+#define ICON_BYTES    (96 * 96 * 3)     // RGB565A8
+#define IMG_HEADER    12                // lv_image_header_t
+#define DECODE_SET    8                 // icons a couple of screens cycle through
+#define DECODE_SHOWN  6                 // icons per screen visit
+#define DECODE_VISITS 40
+#define NOTE_BYTES    300               // one journal record
+#define CACHE_BYTES   (256 * 1024)      // LVGL_FS_CACHE_BYTES
+
+typedef enum { MODE_DIRECT, MODE_WEAR_GEN, MODE_STORAGE_GEN, MODE_COUNT } read_mode_t;
+
+static const char* const k_mode_names[MODE_COUNT] = { "direct", "wear gen", "storage gen" };
+
+static char s_dir[256] = "fs_cache_bench_out";
+static uint8_t s_icons[DECODE_SET][ICON_BYTES];
+static uint8_t s_cache_mem[CACHE_BYTES];
+static int s_failures;
+
+static struct {
+    uint64_t opens;
+    uint64_t reads;
+    uint64_t bytes;
+} s_be;
+
+// Storage counters the two generations are derived from
+static uint64_t s_bytes_written;
+static uint32_t s_storage_gen = 1;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        s_failures++;
+    }
+}
+
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ---- backend: what lvgl_spiffs_fs.c does, with counters -----------------
+
+static void* posix_open(const char* path, uint32_t* size)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    setvbuf(f, NULL, _IONBF, 0);
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0) {
+        fclose(f);
+        return NULL;
+    }
+    *size = (uint32_t)st.st_size;
+    s_be.opens++;
+    return f;
+}
+
+static int posix_read(void* handle, uint32_t pos, void* buf, uint32_t len)
+{
+    FILE* f = (FILE*)handle;
+    if (fseek(f, (long)pos, SEEK_SET) != 0) return -1;
+    size_t n = fread(buf, 1, len, f);
+    if (n < len && ferror(f)) return -1;
+    s_be.reads++;
+    s_be.bytes += n;
+    return (int)n;
+}
+
+static void posix_close(void* handle)
+{
+    fclose((FILE*)handle);
+}
+
+static const fs_cache_ops_t k_posix_ops = { posix_open, posix_read, posix_close };
+
+// ---- files ----------------------------------------------------------------
+
+static void icon_path(char* out, size_t out_sz, int icon)
+{
+    snprintf(out, out_sz, "%s/icon_%02d.bin", s_dir, icon);
+}
+
+static void icon_fill(int icon, unsigned salt)
+{
+    uint32_t x = 0x9E3779B9u * (uint32_t)(icon + 1) + salt;
+    for (size_t i = 0; i < ICON_BYTES; ++i) {
+        x = x * 1664525u + 1013904223u;
+        s_icons[icon][i] = (uint8_t)(x >> 24);
+    }
+}
+
+static bool write_file(const char* path, const uint8_t* data, size_t len, const char* mode)
+{
+    FILE* f = fopen(path, mode);
+    if (!f) return false;
+    bool ok = fwrite(data, 1, len, f) == len;
+    ok = fclose(f) == 0 && ok;
+    s_bytes_written += len;
+    return ok;
+}
+
+// Replace an icon the way a file transfer commit does
+static bool icon_replace(int icon, unsigned salt)
+{
+    char path[300], tmp[310];
+    icon_path(path, sizeof(path), icon);
+    snprintf(tmp, sizeof(tmp), "%s.part", path);
+    icon_fill(icon, salt);
+    if (!write_file(tmp, s_icons[icon], ICON_BYTES, "wb") || rename(tmp, path) != 0) return false;
+    s_storage_gen++;
+    return true;
+}
+
+static bool journal_append(void)
+{
+    static const uint8_t note[NOTE_BYTES];
+    char path[300];
+    snprintf(path, sizeof(path), "%s/.notif_0.log", s_dir);
+    return write_file(path, note, sizeof(note), "ab");
+}
+
+// ---- decode ---------------------------------------------------------------
+
+// Info (header only), then open (header and pixels)
+static bool decode_image(const char* path, bool cached, uint8_t* buf)
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        uint32_t want = pass ? ICON_BYTES : IMG_HEADER;
+        int n;
+        if (cached) {
+            fs_cache_file_t* f = fs_cache_open(path);
+            if (!f) return false;
+            n = fs_cache_read(f, buf, IMG_HEADER);
+            if (n == IMG_HEADER && pass) n += fs_cache_read(f, buf + IMG_HEADER, want - IMG_HEADER);
+            fs_cache_close(f);
+        } else {
+            uint32_t size;
+            void* h = posix_open(path, &size);
+            if (!h) return false;
+            n = posix_read(h, 0, buf, IMG_HEADER);
+            if (n == IMG_HEADER && pass) n += posix_read(h, IMG_HEADER, buf + IMG_HEADER, want - IMG_HEADER);
+            posix_close(h);
+        }
+        if (n != (int)want) return false;
+    }
+    return true;
+}
+
+typedef struct {
+    double host_us;
+    double opens, reads, kbytes, flash_us;   // per image
+    uint64_t warm_visit_bytes;                // backend bytes in the last visit
+} result_t;
+
+static bool run(read_mode_t mode, result_t* r)
+{
+    static uint8_t buf[ICON_BYTES];
+    char path[300];
+    for (int i = 0; i < DECODE_SET; ++i) {
+        icon_path(path, sizeof(path), i);
+        icon_fill(i, 0);
+        if (!write_file(path, s_icons[i], ICON_BYTES, "wb")) return false;
+    }
+    s_storage_gen++;
+
+    fs_cache_init(&k_posix_ops, s_cache_mem, sizeof(s_cache_mem));
+    memset(&s_be, 0, sizeof(s_be));
+    srand(1);
+    double host_us = 0;
+    uint64_t visit_bytes = 0;
+    for (int v = 0; v < DECODE_VISITS; ++v) {
+        if (v == DECODE_VISITS / 2 && !icon_replace(rand() % DECODE_SET, (unsigned)v)) return false;
+        if (!journal_append()) return false;
+        // What lvgl_spiffs_fs.c does on every read open
+        if (mode == MODE_WEAR_GEN) fs_cache_set_generation(s_bytes_written);
+        else if (mode == MODE_STORAGE_GEN) fs_cache_set_generation(s_storage_gen);
+
+        const uint64_t bytes_before = s_be.bytes;
+        const double t0 = now_us();
+        for (int i = 0; i < DECODE_SHOWN; ++i) {
+            int icon = rand() % DECODE_SET;
+            icon_path(path, sizeof(path), icon);
+            if (!decode_image(path, mode != MODE_DIRECT, buf) || memcmp(buf, s_icons[icon], ICON_BYTES) != 0) {
+                fprintf(stderr, "%s: decoding %s failed\n", k_mode_names[mode], path);
+                return false;
+            }
+        }
+        host_us += now_us() - t0;
+        visit_bytes = s_be.bytes - bytes_before;
+    }
+    const double images = DECODE_VISITS * DECODE_SHOWN;
+    r->host_us = host_us / images;
+    r->opens = s_be.opens / images;
+    r->reads = s_be.reads / images;
+    r->kbytes = s_be.bytes / 1024.0 / images;
+    r->flash_us = (s_be.reads * T_READ_CMD_US + s_be.bytes * T_READ_BYTE_US) / images;
+    r->warm_visit_bytes = visit_bytes;
+    fs_cache_invalidate();
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            snprintf(s_dir, sizeof(s_dir), "%s", argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--out dir]\n", argv[0]);
+            return 2;
+        }
+    }
+    mkdir(s_dir, 0755);
+
+    result_t res[MODE_COUNT] = { { 0 } };
+    for (int m = 0; m < MODE_COUNT; ++m) {
+        char what[64];
+        snprintf(what, sizeof(what), "%s: every decode matches the file", k_mode_names[m]);
+        check(run((read_mode_t)m, &res[m]), what);
+    }
+
+    printf("%d visits x %d of %d icons (%d B), a journal append before each visit\n", DECODE_VISITS,
+           DECODE_SHOWN, DECODE_SET, ICON_BYTES);
+    printf("%-12s %10s %8s %8s %10s %12s\n", "per image", "host us", "opens", "reads", "KB read", "flash us");
+    for (int m = 0; m < MODE_COUNT; ++m) {
+        printf("%-12s %10.1f %8.2f %8.2f %10.1f %12.1f\n", k_mode_names[m], res[m].host_us, res[m].opens,
+               res[m].reads, res[m].kbytes, res[m].flash_us);
+    }
+
+    check(res[MODE_WEAR_GEN].warm_visit_bytes > 0, "wear gen: appends keep the cache cold");
+    check(res[MODE_STORAGE_GEN].warm_visit_bytes == 0, "storage gen: the last visit reads nothing");
+    check(res[MODE_STORAGE_GEN].flash_us < res[MODE_WEAR_GEN].flash_us, "storage gen: less flash time");
+
+    printf("fs_cache_bench: %s\n", s_failures ? "FAILED" : "OK");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,393 @@
+// Host-side sender for the BLE file transfer protocol (components/file_transfer).
+//
+// Drives the real receiver engine through a loopback stand-in for the bulk
+// characteristic: frames are sized from the MTU, can be dropped or corrupted,
+// and the link can be cut part way through to exercise resume. The result is
+// checked byte for byte against the source.
+//
+// Two throughput figures are printed: the host figure (engine + stdio cost,
+// an upper bound for the protocol itself) and a modeled BLE figure from the
+// frames actually sent, including retransmissions and ack notifications.
+
+#include "file_transfer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+typedef struct {
+    const char* file;
+    const char* out;
+    uint32_t size;
+    uint16_t mtu;
+    uint16_t dle;
+    int phy;            // 1 or 2 Mbit/s
+    double itvl_ms;
+    int pkts_per_event;
+    double drop;
+    double corrupt;
+    double disconnect;  // fraction of the file after which the link drops once
+    unsigned seed;
+} opts_t;
+
+// ---- loopback link -------------------------------------------------------
+
+#define MAX_REPLIES 64
+
+static struct {
+    char lines[MAX_REPLIES][128];
+    int head, tail;
+} s_rx;
+
+static struct {
+    uint64_t frames;
+    uint64_t retransmit_bytes;
+    uint64_t dropped;
+    uint64_t corrupted;
+    uint64_t notifies;
+    uint64_t timeouts;
+    uint64_t ll_pdus;
+    double air_us;
+} s_link;
+
+static opts_t s_opt;
+
+static void on_reply(const char* line)
+{
+    int next = (s_rx.tail + 1) % MAX_REPLIES;
+    if (next == s_rx.head) {
+        fprintf(stderr, "reply queue overflow\n");
+        exit(2);
+    }
+    snprintf(s_rx.lines[s_rx.tail], sizeof(s_rx.lines[0]), "%s", line);
+    s_rx.tail = next;
+}
+
+static const char* pop_reply(void)
+{
+    if (s_rx.head == s_rx.tail) return NULL;
+    const char* l = s_rx.lines[s_rx.head];
+    s_rx.head = (s_rx.head + 1) % MAX_REPLIES;
+    return l;
+}
+
+static double frand(void)
+{
+    return (double)rand() / ((double)RAND_MAX + 1.0);
+}
+
+// Air time of one LL data PDU plus the peer's empty ack, both with T_IFS
+static double pdu_us(int ll_payload)
+{
+    int preamble = s_opt.phy == 2 ? 2 : 1;
+    double us_per_byte = 8.0 / s_opt.phy;
+    double data = (preamble + 4 + 2 + ll_payload + 3) * us_per_byte;
+    double ack = (preamble + 4 + 2 + 3) * us_per_byte;
+    return data + 150 + ack + 150;
+}
+
+// Account one ATT PDU (write command or notification) on the modeled link
+static void account_att(int att_len)
+{
+    int l2cap = att_len + 4;
+    while (l2cap > 0) {
+        int n = l2cap > s_opt.dle ? s_opt.dle : l2cap;
+        s_link.air_us += pdu_us(n);
+        s_link.ll_pdus++;
+        l2cap -= n;
+    }
+}
+
+static void link_write(const uint8_t* frame, size_t len)
+{
+    s_link.frames++;
+    account_att((int)len + 3);
+    if (frand() < s_opt.drop) {
+        s_link.dropped++;
+        return;
+    }
+    uint8_t buf[600];
+    memcpy(buf, frame, len);
+    if (frand() < s_opt.corrupt) {
+        // Corrupt payload, never the header; the per-frame CRC has to catch it
+        buf[FILE_TRANSFER_HDR_LEN + rand() % (len - FILE_TRANSFER_HDR_LEN)] ^= 0x5A;
+        s_link.corrupted++;
+    }
+    int before = s_rx.tail;
+    (void)file_transfer_on_data(buf, len);
+    if (s_rx.tail != before) {
+        s_link.notifies++;
+        account_att((int)strlen(s_rx.lines[before]) + 1 + 3);
+    }
+}
+
+static bool reply_is(const char* line, const char* kind)
+{
+    char key[32];
+    snprintf(key, sizeof(key), "\"ft\":\"%s\"", kind);
+    return strstr(line, key) != NULL;
+}
+
+static long reply_num(const char* line, const char* field)
+{
+    char key[32];
+    snprintf(key, sizeof(key), "\"%s\":", field);
+    const char* p = strstr(line, key);
+    return p ? strtol(p + strlen(key), NULL, 10) : -1;
+}
+
+// ---- sender --------------------------------------------------------------
+
+static void wr32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static bool do_begin(const char* name, uint32_t size, uint32_t crc, uint16_t chunk_hint,
+                     uint32_t* offset, uint16_t* chunk, int* window)
+{
+    if (file_transfer_begin(name, size, crc, chunk_hint) != ESP_OK) return false;
+    const char* l = pop_reply();
+    if (!l || !reply_is(l, "ready")) {
+        fprintf(stderr, "begin: unexpected reply %s\n", l ? l : "(none)");
+        return false;
+    }
+    *offset = (uint32_t)reply_num(l, "offset");
+    *chunk = (uint16_t)reply_num(l, "chunk");
+    *window = (int)reply_num(l, "window");
+    return true;
+}
+
+// Go-back-N with up to two ack windows in flight. Returns false if the link
+// was cut (the caller resumes with a fresh begin).
+static bool pump(const uint8_t* data, uint32_t size, uint32_t* base_io, uint16_t chunk, int window,
+                 uint32_t cut_at)
+{
+    uint32_t base = *base_io, next = base;
+    const uint32_t inflight = (uint32_t)(2 * window) * chunk;
+    uint8_t frame[600];
+
+    while (base < size) {
+        while (next < size && next - base < inflight) {
+            if (cut_at && next >= cut_at) {
+                *base_io = base;
+                return false;
+            }
+            uint32_t n = size - next < chunk ? size - next : chunk;
+            wr32(frame, next);
+            wr32(frame + 4, file_transfer_crc32(0, data + next, n));
+            memcpy(frame + FILE_TRANSFER_HDR_LEN, data + next, n);
+            link_write(frame, n + FILE_TRANSFER_HDR_LEN);
+            next += n;
+        }
+        bool progressed = false;
+        const char* l;
+        while ((l = pop_reply()) != NULL) {
+            long off = reply_num(l, "offset");
+            if (reply_is(l, "ack")) {
+                if ((uint32_t)off > base) base = (uint32_t)off;
+                progressed = true;
+            } else if (reply_is(l, "nak")) {
+                s_link.retransmit_bytes += next - (uint32_t)off;
+                base = next = (uint32_t)off;
+                progressed = true;
+            } else {
+                fprintf(stderr, "transfer: %s\n", l);
+                exit(1);
+            }
+        }
+        if (!progressed && (next == size || next - base >= inflight)) {
+            // Nothing more will come back for this window: a real sender
+            // would time out here and rewind to the last acked offset
+            s_link.timeouts++;
+            s_link.retransmit_bytes += next - base;
+            next = base;
+        }
+    }
+    *base_io = base;
+    return true;
+}
+
+static uint8_t* load_source(uint32_t* size_out, const char** name_out)
+{
+    if (s_opt.file) {
+        FILE* f = fopen(s_opt.file, "rb");
+        if (!f) {
+            fprintf(stderr, "open %s: %s\n", s_opt.file, strerror(errno));
+            return NULL;
+        }
+        fseek(f, 0, SEEK_END);
+        long sz = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        uint8_t* buf = malloc(sz > 0 ? (size_t)sz : 1);
+        if (buf && fread(buf, 1, (size_t)sz, f) != (size_t)sz) {
+            free(buf);
+            buf = NULL;
+        }
+        fclose(f);
+        const char* slash = strrchr(s_opt.file, '/');
+        *name_out = slash ? slash + 1 : s_opt.file;
+        *size_out = (uint32_t)sz;
+        return buf;
+    }
+    uint8_t* buf = malloc(s_opt.size);
+    for (uint32_t i = 0; buf && i < s_opt.size; ++i) buf[i] = (uint8_t)(rand() >> 7);
+    *name_out = "payload.bin";
+    *size_out = s_opt.size;
+    return buf;
+}
+
+static bool verify(const char* path, const uint8_t* data, uint32_t size)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t* got = malloc(size + 1);
+    size_t n = got ? fread(got, 1, size + 1, f) : 0;
+    fclose(f);
+    bool ok = got && n == size && memcmp(got, data, size) == 0;
+    free(got);
+    return ok;
+}
+
+static void usage(const char* argv0)
+{
+    fprintf(stderr,
+            "usage: %s [--file path | --size bytes] [--out dir] [--mtu n] [--dle n] [--phy 1|2]\n"
+            "          [--itvl-ms ms] [--ppe n] [--drop p] [--corrupt p] [--disconnect frac] [--seed n]\n",
+            argv0);
+}
+
+int main(int argc, char** argv)
+{
+    s_opt = (opts_t){ .out = "ft_out", .size = 128 * 1024, .mtu = 247, .dle = 251, .phy = 2,
+                      .itvl_ms = 15.0, .pkts_per_event = 6, .seed = 1 };
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { usage(argv[0]); return 2; }
+        if (!strcmp(a, "--file")) s_opt.file = v;
+        else if (!strcmp(a, "--out")) s_opt.out = v;
+        else if (!strcmp(a, "--size")) s_opt.size = (uint32_t)strtoul(v, NULL, 0);
+        else if (!strcmp(a, "--mtu")) s_opt.mtu = (uint16_t)atoi(v);
+        else if (!strcmp(a, "--dle")) s_opt.dle = (uint16_t)atoi(v);
+        else if (!strcmp(a, "--phy")) s_opt.phy = atoi(v) == 1 ? 1 : 2;
+        else if (!strcmp(a, "--itvl-ms")) s_opt.itvl_ms = atof(v);
+        else if (!strcmp(a, "--ppe")) s_opt.pkts_per_event = atoi(v);
+        else if (!strcmp(a, "--drop")) s_opt.drop = atof(v);
+        else if (!strcmp(a, "--corrupt")) s_opt.corrupt = atof(v);
+        else if (!strcmp(a, "--disconnect")) s_opt.disconnect = atof(v);
+        else if (!strcmp(a, "--seed")) s_opt.seed = (unsigned)atoi(v);
+        else { usage(argv[0]); return 2; }
+        ++i;
+    }
+    if (s_opt.mtu < 23 || s_opt.dle < 27 || s_opt.dle > 251 || s_opt.pkts_per_event < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    srand(s_opt.seed);
+    mkdir(s_opt.out, 0755);
+
+    uint32_t size = 0;
+    const char* name = NULL;
+    uint8_t* data = load_source(&size, &name);
+    if (!data || size == 0) return 1;
+    uint32_t crc = file_transfer_crc32(0, data, size);
+
+    file_transfer_init(s_opt.out, on_reply);
+
+    // Same sizing as ble_sync: one frame per ATT write, capped like notifications
+    uint16_t att_payload = (uint16_t)(s_opt.mtu - 3);
+    uint16_t cap = s_opt.dle >= 251 ? 244 : 203;
+    if (att_payload > cap) att_payload = cap;
+    uint16_t chunk_hint = (uint16_t)(att_payload - FILE_TRANSFER_HDR_LEN);
+
+    uint32_t offset = 0, cut_at = 0, resumed_at = 0;
+    uint16_t chunk = 0;
+    int window = 0, resumes = 0;
+    if (s_opt.disconnect > 0 && s_opt.disconnect < 1) cut_at = (uint32_t)(size * s_opt.disconnect);
+
+    // An interrupted upload under another name must not leave its part file
+    // behind once this one starts
+    char stale[256];
+    snprintf(stale, sizeof(stale), "%s/stale.bin.part", s_opt.out);
+    if (!do_begin("stale.bin", 1000, 0, chunk_hint, &offset, &chunk, &window)) return 1;
+    file_transfer_suspend();
+    struct stat st_stale;
+    if (stat(stale, &st_stale) != 0) {
+        fprintf(stderr, "no part file for the interrupted upload\n");
+        return 1;
+    }
+
+    clock_t t0 = clock();
+    if (!do_begin(name, size, crc, chunk_hint, &offset, &chunk, &window)) return 1;
+    if (stat(stale, &st_stale) == 0) {
+        fprintf(stderr, "stale part file left: %s\n", stale);
+        return 1;
+    }
+    while (!pump(data, size, &offset, chunk, window, cut_at)) {
+        // Link lost: the watch suspends, the phone reconnects and begins again
+        file_transfer_suspend();
+        while (pop_reply()) {
+            // acks still in flight are lost with the link
+        }
+        cut_at = 0;
+        resumes++;
+        if (!do_begin(name, size, crc, chunk_hint, &resumed_at, &chunk, &window)) return 1;
+        offset = resumed_at;
+    }
+    if (file_transfer_end() != ESP_OK) {
+        const char* l = pop_reply();
+        fprintf(stderr, "end failed: %s\n", l ? l : "(none)");
+        return 1;
+    }
+    const char* done = pop_reply();
+    double host_s = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", s_opt.out, name);
+    bool ok = done && reply_is(done, "done") && strstr(done, "\"ok\":true") && verify(path, data, size);
+
+    // A reset while the next upload of the same name is committed, after the
+    // stored copy was moved aside: the next init puts it back
+    char aside[256];
+    snprintf(aside, sizeof(aside), "%s/.ft_old", s_opt.out);
+    if (ok && do_begin(name, size, crc ^ 1, chunk_hint, &offset, &chunk, &window) && rename(path, aside) == 0) {
+        file_transfer_suspend();
+        file_transfer_init(s_opt.out, on_reply);
+        if (!verify(path, data, size) || stat(aside, &st_stale) == 0) {
+            fprintf(stderr, "stored copy not restored after an interrupted commit\n");
+            ok = false;
+        }
+        file_transfer_abort();
+    }
+
+    file_transfer_stats_t st;
+    file_transfer_get_stats(&st);
+    double event_bound_us = (double)((s_link.ll_pdus + s_opt.pkts_per_event - 1) / s_opt.pkts_per_event) *
+                            s_opt.itvl_ms * 1000.0;
+    double ble_us = s_link.air_us > event_bound_us ? s_link.air_us : event_bound_us;
+
+    printf("file          %s (%u bytes, crc %08x)\n", name, (unsigned)size, (unsigned)crc);
+    printf("link          mtu %u, dle %u, %dM PHY, itvl %.2f ms, %d pkts/event, chunk %u, window %d\n",
+           s_opt.mtu, s_opt.dle, s_opt.phy, s_opt.itvl_ms, s_opt.pkts_per_event, chunk, window);
+    printf("frames        %llu sent, %llu dropped, %llu corrupted, %llu ack/nak, %llu timeouts\n",
+           (unsigned long long)s_link.frames, (unsigned long long)s_link.dropped,
+           (unsigned long long)s_link.corrupted, (unsigned long long)s_link.notifies,
+           (unsigned long long)s_link.timeouts);
+    printf("receiver      %u crc errors, %u gaps, %u duplicates\n", (unsigned)st.crc_errors, (unsigned)st.gaps,
+           (unsigned)st.duplicates);
+    if (resumes) printf("resume        %d reconnect(s), resumed at %u\n", resumes, (unsigned)resumed_at);
+    printf("retransmitted %llu bytes (%.1f%%)\n", (unsigned long long)s_link.retransmit_bytes,
+           100.0 * (double)s_link.retransmit_bytes / size);
+    printf("host          %.1f ms, %.1f MB/s\n", host_s * 1000, host_s > 0 ? size / host_s / 1e6 : 0);
+    printf("modeled BLE   %.0f ms, %.1f kB/s\n", ble_us / 1000, size / ble_us * 1000.0);
+    printf("result        %s\n", ok ? "OK" : "FAILED");
+    free(data);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// Notification journal (components/notif_journal) on files in a scratch
+// directory. notif_journal_init() again stands in for a restart: the index
+// is rebuilt from the segments alone. Covers segment rotation, replay of
+// records and tombstones after a restart, a torn tail, the index cap and
+// clearing.
+//
+//   notif_journal_test [--out dir]
+
+#include "notif_journal.h"
+#include "settings.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static char s_dir[256] = "notif_journal_out";
+static char s_body[NOTIF_JOURNAL_BODY_MAX + 4];
+static int s_failures;
+static uint32_t s_erases;
+static uint32_t s_storage_changes;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        fprintf(stderr, "FAIL: %s\n", what);
+        s_failures++;
+    }
+}
+
+// Flash wear accounting lives in the settings component
+void settings_wear_note(settings_part_t part, uint32_t bytes, uint32_t erases)
+{
+    (void)part;
+    (void)bytes;
+    s_erases += erases;
+}
+
+void settings_storage_changed(void)
+{
+    s_storage_changes++;
+}
+
+static void seg_path(char* out, size_t out_sz, int seg)
+{
+    snprintf(out, out_sz, "%s/.notif_%d.log", s_dir, seg);
+}
+
+static void restart(void)
+{
+    check(notif_journal_init(s_dir) == ESP_OK, "restart: init");
+}
+
+// Message of `len` bytes that tells which notification it belongs to
+static const char* message_for(uint32_t n, size_t len)
+{
+    static char msg[NOTIF_JOURNAL_BODY_MAX];
+    int head = snprintf(msg, sizeof(msg), "#%lu:", (unsigned long)n);
+    for (size_t i = (size_t)head; i < len; ++i) msg[i] = (char)('a' + (n + i) % 26);
+    msg[len > (size_t)head ? len : (size_t)head] = '\0';
+    return msg;
+}
+
+static bool read_matches(uint32_t id, const char* app, const char* title, const char* message)
+{
+    notif_entry_t e;
+    return notif_journal_read(id, &e, s_body, sizeof(s_body)) == ESP_OK && e.id == id &&
+           strcmp(e.app, app) == 0 && strcmp(e.title, title) == 0 && strcmp(e.message, message) == 0 &&
+           strcmp(e.timestamp, "2026-10-19T08:00:00") == 0;
+}
+
+static uint32_t append(const char* app, const char* title, const char* message)
+{
+    uint32_t id = 0;
+    if (notif_journal_append(app, title, message, "2026-10-19T08:00:00", &id) != ESP_OK) return 0;
+    return id;
+}
+
+static void test_append_and_query(void)
+{
+    uint32_t a = append("com.chat", "Ann", "lunch?");
+    uint32_t b = append("com.mail", "Bob", "report attached");
+    uint32_t c = append("com.chat", "Cy", "");
+    check(a == 1 && b == 2 && c == 3, "append: ids start at 1");
+    check(notif_journal_count() == 3 && notif_journal_id_at(0) == c && notif_journal_id_at(2) == a &&
+          notif_journal_id_at(3) == 0, "append: newest first");
+    check(read_matches(b, "com.mail", "Bob", "report attached"), "append: read back");
+
+    uint32_t ids[4];
+    size_t n = notif_journal_query("com.chat", 0, ids, 4);
+    check(n == 2 && ids[0] == c && ids[1] == a, "query: per app, newest first");
+    n = notif_journal_query(NULL, 1, ids, 4);
+    check(n == 2 && ids[0] == b && ids[1] == a, "query: all apps, skip");
+
+    check(notif_journal_count_below(c) == 2 && notif_journal_id_below(c, 0) == b &&
+          notif_journal_id_below(c, 2) == 0, "below: newer entries are left out");
+
+    // A long title and message are cut to fit the body limit
+    char big[3 * NOTIF_JOURNAL_BODY_MAX];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    uint32_t d = append("com.chat", big, big);
+    notif_entry_t e;
+    check(d && notif_journal_read(d, &e, s_body, sizeof(s_body)) == ESP_OK &&
+          strlen(e.app) + strlen(e.title) + strlen(e.message) + strlen(e.timestamp) <= NOTIF_JOURNAL_BODY_MAX,
+          "append: oversize body is cut");
+    check(notif_journal_read(d, &e, s_body, 40) == ESP_OK && strlen(e.message) < 40,
+          "read: small buffer cuts the strings");
+}
+
+static void test_delete_and_replay(void)
+{
+    uint32_t newest = notif_journal_id_at(0);
+    size_t count = notif_journal_count();
+    check(notif_journal_delete(2) == ESP_OK, "delete: existing id");
+    check(notif_journal_delete(2) == ESP_ERR_NOT_FOUND, "delete: twice");
+    check(notif_journal_count() == count - 1, "delete: count drops");
+    notif_entry_t e;
+    check(notif_journal_read(2, &e, s_body, sizeof(s_body)) == ESP_ERR_NOT_FOUND, "delete: read fails");
+
+    restart();
+    check(notif_journal_count() == count - 1 && notif_journal_id_at(0) == newest, "replay: same index");
+    check(notif_journal_read(2, &e, s_body, sizeof(s_body)) == ESP_ERR_NOT_FOUND, "replay: tombstone applies");
+    check(read_matches(1, "com.chat", "Ann", "lunch?"), "replay: records read back");
+    // The tombstone took an id as well
+    uint32_t id = append("com.chat", "Dee", "after restart");
+    check(id == newest + 2, "replay: ids continue after the newest record");
+}
+
+// Garbage after the last record, as a write cut off by a reset leaves it
+static void test_torn_tail(void)
+{
+    size_t count = notif_journal_count();
+    uint32_t newest = notif_journal_id_at(0);
+    for (int seg = 0; seg < 2; ++seg) {
+        char path[300];
+        seg_path(path, sizeof(path), seg);
+        FILE* f = fopen(path, "ab");
+        if (f) {
+            fwrite("\x4e\x4a\x01\x05garbage", 1, 11, f);
+            fclose(f);
+        }
+    }
+    restart();
+    check(notif_journal_count() == count && notif_journal_id_at(0) == newest, "torn: records before it kept");
+    uint32_t id = append("com.chat", "Eve", "after the tear");
+    restart();
+    check(id && notif_journal_id_at(0) == id && read_matches(id, "com.chat", "Eve", "after the tear"),
+          "torn: appends land after the cut");
+}
+
+static void test_rotation(void)
+{
+    check(notif_journal_clear() == ESP_OK && notif_journal_count() == 0, "rotation: clear");
+    const size_t len = 1900;
+    const uint32_t total = 3 * NOTIF_JOURNAL_SEGMENT_BYTES / len;
+    uint32_t first = 0, last = 0;
+    s_erases = 0;
+    s_storage_changes = 0;
+    for (uint32_t n = 0; n < total; ++n) {
+        uint32_t id = append("com.news", "Headline", message_for(n, len));
+        if (!first) first = id;
+        last = id;
+    }
+    check(first == 1, "clear: ids start over");
+    check(last == first + total - 1, "rotation: every append stored");
+    check(s_erases > 0, "rotation: emptied segments count as erases");
+    check(s_storage_changes > 0 && s_storage_changes <= 4, "rotation: only emptying a segment changes storage");
+
+    // Whole segments age out: what is left is the newest run, at most two
+    // segments' worth
+    size_t count = notif_journal_count();
+    size_t per_segment = NOTIF_JOURNAL_SEGMENT_BYTES / (len + 18 + 8 + 8 + 19);
+    check(count >= per_segment && count <= 2 * (per_segment + 1) && count < total, "rotation: oldest dropped");
+    uint32_t oldest = notif_journal_id_at(count - 1);
+    notif_entry_t e;
+    check(notif_journal_read(oldest - 1, &e, s_body, sizeof(s_body)) == ESP_ERR_NOT_FOUND,
+          "rotation: aged-out id not found");
+    bool contiguous = true, readable = true;
+    for (size_t pos = 0; pos < count; ++pos) {
+        uint32_t id = notif_journal_id_at(pos);
+        contiguous = contiguous && id == last - pos;
+        readable = readable && read_matches(id, "com.news", "Headline", message_for(id - first, len));
+    }
+    check(contiguous && readable, "rotation: survivors intact");
+
+    struct stat st;
+    bool bounded = true;
+    for (int seg = 0; seg < 2; ++seg) {
+        char path[300];
+        seg_path(path, sizeof(path), seg);
+        bounded = bounded && stat(path, &st) == 0 && st.st_size <= NOTIF_JOURNAL_SEGMENT_BYTES;
+    }
+    check(bounded, "rotation: segments stay within their size");
+
+    restart();
+    check(notif_journal_count() == count && notif_journal_id_at(0) == last &&
+          notif_journal_id_at(count - 1) == oldest, "rotation: replay after restart");
+    uint32_t id = append("com.news", "Headline", "one more");
+    check(id == last + 1, "rotation: appends continue in the active segment");
+}
+
+static void test_index_cap(void)
+{
+    check(notif_journal_clear() == ESP_OK, "cap: clear");
+    const uint32_t total = NOTIF_JOURNAL_MAX + 40;
+    for (uint32_t n = 0; n < total; ++n) append("com.chat", "t", "m");
+    check(notif_journal_count() == NOTIF_JOURNAL_MAX && notif_journal_id_at(0) == total &&
+          notif_journal_id_at(NOTIF_JOURNAL_MAX - 1) == total - NOTIF_JOURNAL_MAX + 1,
+          "cap: index keeps the newest NOTIF_JOURNAL_MAX");
+    restart();
+    check(notif_journal_count() == NOTIF_JOURNAL_MAX && notif_journal_id_at(0) == total, "cap: replay");
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            snprintf(s_dir, sizeof(s_dir), "%s", argv[++i]);
+        } else {
+            fprintf(stderr, "usage: %s [--out dir]\n", argv[0]);
+            return 2;
+        }
+    }
+    mkdir(s_dir, 0755);
+    for (int seg = 0; seg < 2; ++seg) {
+        char path[300];
+        seg_path(path, sizeof(path), seg);
+        remove(path);
+    }
+
+    check(notif_journal_append("a", "b", "c", "d", NULL) == ESP_ERR_INVALID_STATE, "append before init");
+    restart();
+    check(notif_journal_count() == 0, "init: empty directory");
+
+    test_append_and_query();
+    test_delete_and_replay();
+    test_torn_tail();
+    test_rotation();
+    test_index_cap();
+
+    check(notif_journal_clear() == ESP_OK && notif_journal_count() == 0, "clear: empty");
+    restart();
+    check(notif_journal_count() == 0, "clear: stays empty after restart");
+
+    printf("notif_journal_test: %s\n", s_failures ? "FAILED" : "OK");
+    return s_failures ? 1 : 0;
+}
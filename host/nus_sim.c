@@ -0,0 +1,593 @@
+// Scripted phone against the real Nordic UART + ble_sync stack.
+//
+// nimble-nordic-uart and ble_sync run unmodified on top of the fakes in
+// fake/: GATT writes arrive on a NimBLE "host task" as (optionally
+// fragmented) mbuf chains, notifications are reassembled into lines here,
+// and the UI/RTC calls ble_sync makes are recorded with timestamps.
+//
+//   nus_sim [scenario...]     default: all scenarios
+//
+// Each scenario prints its measurements and fails the run if an invariant
+// breaks (wrong fields, lost control lines, drops not accounted for).
+
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ble_sync.h"
+#include "cJSON.h"
+#include "esp_timer.h"
+#include "fake_ble.h"
+#include "fake_watch.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nimble-nordic-uart.h"
+
+#define LINE_MAX_LEN 1024
+#define MAX_LINES    4096
+
+static const fake_ble_link_t k_link = { .mtu = 247, .phy = 2, .dle = 251, .bonded = false };
+
+// ---- phone side ------------------------------------------------------------
+
+typedef struct {
+    int64_t us;
+    char text[LINE_MAX_LEN];
+} rx_line_t;
+
+static pthread_mutex_t s_rx_m = PTHREAD_MUTEX_INITIALIZER;
+static char s_partial[LINE_MAX_LEN];
+static size_t s_partial_len;
+static rx_line_t* s_lines;
+static int s_num_lines;
+static int s_cursor; // first line not yet consumed by peer_expect
+
+static int s_failures;
+
+// Air-time model for the phone's writes: 0 sends as fast as the host takes
+// them (only ACL flow control applies), otherwise bytes per second
+static uint32_t s_pace_bps;
+static int64_t s_pace_next_us;
+
+static void fail(const char* fmt, ...)
+{
+    va_list ap;
+    fprintf(stderr, "  FAIL: ");
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+    s_failures++;
+}
+
+static void on_notify(const uint8_t* data, size_t len, void* arg)
+{
+    (void)arg;
+    int64_t now = esp_timer_get_time();
+    pthread_mutex_lock(&s_rx_m);
+    for (size_t i = 0; i < len; ++i) {
+        if (data[i] != '\n') {
+            if (s_partial_len < LINE_MAX_LEN - 1) s_partial[s_partial_len++] = (char)data[i];
+            continue;
+        }
+        if (s_num_lines < MAX_LINES) {
+            s_lines[s_num_lines].us = now;
+            memcpy(s_lines[s_num_lines].text, s_partial, s_partial_len);
+            s_lines[s_num_lines].text[s_partial_len] = '\0';
+            s_num_lines++;
+        }
+        s_partial_len = 0;
+    }
+    pthread_mutex_unlock(&s_rx_m);
+    // Each notification takes a little air time, so concurrent senders
+    // really do overlap
+    struct timespec ts = { .tv_sec = 0, .tv_nsec = 20000 };
+    nanosleep(&ts, NULL);
+}
+
+// Wait for the next line containing `needle`; earlier lines are skipped
+static bool peer_expect(const char* needle, uint32_t timeout_ms, rx_line_t* out)
+{
+    TickType_t start = xTaskGetTickCount();
+    for (;;) {
+        pthread_mutex_lock(&s_rx_m);
+        for (; s_cursor < s_num_lines; ++s_cursor) {
+            if (strstr(s_lines[s_cursor].text, needle)) {
+                if (out) *out = s_lines[s_cursor];
+                s_cursor++;
+                pthread_mutex_unlock(&s_rx_m);
+                return true;
+            }
+        }
+        pthread_mutex_unlock(&s_rx_m);
+        if (xTaskGetTickCount() - start >= timeout_ms) return false;
+        vTaskDelay(1);
+    }
+}
+
+static void peer_skip_all(void)
+{
+    pthread_mutex_lock(&s_rx_m);
+    s_cursor = s_num_lines;
+    pthread_mutex_unlock(&s_rx_m);
+}
+
+// Send one line as ATT writes of at most mtu-3 bytes, each delivered as an
+// mbuf chain of `frag`-byte segments
+static void peer_send(const char* line, uint16_t mtu, size_t frag)
+{
+    size_t len = strlen(line);
+    char* buf = malloc(len + 1);
+    memcpy(buf, line, len);
+    buf[len] = '\n';
+    size_t max = (size_t)mtu - 3;
+    for (size_t off = 0; off < len + 1; off += max) {
+        size_t n = len + 1 - off < max ? len + 1 - off : max;
+        if (s_pace_bps) {
+            int64_t now = esp_timer_get_time();
+            if (s_pace_next_us < now) s_pace_next_us = now;
+            int64_t wait = s_pace_next_us - now;
+            if (wait > 0) {
+                struct timespec ts = { .tv_sec = wait / 1000000, .tv_nsec = (long)(wait % 1000000) * 1000 };
+                nanosleep(&ts, NULL);
+            }
+            s_pace_next_us += (int64_t)n * 1000000 / s_pace_bps;
+        }
+        if (fake_ble_write(FAKE_NUS_RX, buf + off, n, frag) != 0) fail("write of %zu bytes rejected", n);
+    }
+    free(buf);
+}
+
+static int cmp_i64(const void* a, const void* b)
+{
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+static void print_pct(const char* what, int64_t* us, int n)
+{
+    if (n == 0) {
+        printf("  %-28s n=0\n", what);
+        return;
+    }
+    qsort(us, (size_t)n, sizeof(*us), cmp_i64);
+    printf("  %-28s n=%d p50=%.2f ms p99=%.2f ms max=%.2f ms\n", what, n, us[n / 2] / 1000.0,
+           us[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1] / 1000.0, us[n - 1] / 1000.0);
+}
+
+static double json_num(const char* text, const char* obj, const char* key)
+{
+    double v = -1;
+    cJSON* root = cJSON_Parse(text);
+    cJSON* o = obj ? cJSON_GetObjectItem(root, obj) : root;
+    cJSON* item = cJSON_GetObjectItem(o, key);
+    if (cJSON_IsNumber(item)) v = item->valuedouble;
+    cJSON_Delete(root);
+    return v;
+}
+
+static void make_notification(char* out, size_t cap, int i, const char* message)
+{
+    snprintf(out, cap,
+             "{\"notification\":\"2025-06-01T12:00:%02d\",\"app\":\"chat\",\"title\":\"msg %d\",\"message\":\"%s\"}",
+             i % 60, i, message);
+}
+
+// ---- scenarios ---------------------------------------------------------------
+
+// Connect on a clock that predates the threshold: status, then a time sync
+// request; the phone's datetime must reach the RTC
+static void scenario_connect(void)
+{
+    fake_watch_set_rtc_date(2020, 1, 1);
+    int64_t t0 = esp_timer_get_time();
+    if (fake_ble_connect(&k_link) != 0) {
+        fail("connect rejected");
+        return;
+    }
+    rx_line_t status, req;
+    if (!peer_expect("\"battery\":", 1000, &status)) fail("no status after subscribe");
+    if (!peer_expect("\"cmd\":\"time_sync\"", 1000, &req)) {
+        fail("no time_sync request with an old RTC");
+        return;
+    }
+    printf("  connect -> status %.2f ms, time_sync request %.2f ms\n", (status.us - t0) / 1000.0,
+           (req.us - t0) / 1000.0);
+
+    int64_t t1 = esp_timer_get_time();
+    peer_send("{\"datetime\":\"2025-06-01T12:34:56\"}", k_link.mtu, 0);
+    if (!fake_watch_wait_rtc_sets(1, 1000)) {
+        fail("datetime never reached rtc_set_time");
+        return;
+    }
+    fake_watch_counts_t c;
+    fake_watch_get_counts(&c);
+    printf("  datetime -> rtc_set_time %.2f ms\n", (esp_timer_get_time() - t1) / 1000.0);
+    if (c.rtc_last.tm_year != 2025 || c.rtc_last.tm_mon != 6 || c.rtc_last.tm_mday != 1 ||
+        c.rtc_last.tm_hour != 12 || c.rtc_last.tm_min != 34 || c.rtc_last.tm_sec != 56) {
+        fail("rtc got %d-%d-%d %d:%d:%d", c.rtc_last.tm_year, c.rtc_last.tm_mon, c.rtc_last.tm_mday,
+             c.rtc_last.tm_hour, c.rtc_last.tm_min, c.rtc_last.tm_sec);
+    }
+}
+
+// The same notification through every write/fragment shape must produce
+// identical UI calls: 1-byte mbufs, odd segment sizes, MTU-sized writes,
+// escapes and multi-byte UTF-8 split across segments
+static void scenario_fragment(void)
+{
+    static const char* k_message =
+        "Caf\\u00e9 \\\"quoted\\\" line\\nsecond line - a message long enough to span several ATT writes "
+        "at the negotiated MTU and many more at the default one. 0123456789abcdefghijklmnopqrstuvwxyz "
+        "0123456789abcdefghijklmnopqrstuvwxyz 0123456789abcdefghijklmnopqrstuvwxyz end";
+    static const char* k_expect_prefix = "Caf\xc3\xa9 \"quoted\" line\nsecond line";
+    const size_t frags[] = { 1, 3, 7, 20, 64, 0 };
+    const uint16_t mtus[] = { 23, 185, 247 };
+
+    fake_watch_counts_t before;
+    fake_watch_get_counts(&before);
+    uint32_t expected = before.notifications;
+    char line[LINE_MAX_LEN];
+    for (size_t m = 0; m < sizeof(mtus) / sizeof(mtus[0]); ++m) {
+        for (size_t f = 0; f < sizeof(frags) / sizeof(frags[0]); ++f) {
+            make_notification(line, sizeof(line), (int)(m * 10 + f), k_message);
+            peer_send(line, mtus[m] < k_link.mtu ? mtus[m] : k_link.mtu, frags[f]);
+            expected++;
+        }
+    }
+    if (!fake_watch_wait_notifs(expected, 2000)) {
+        fake_watch_counts_t c;
+        fake_watch_get_counts(&c);
+        fail("%u of %u fragmented notifications shown", c.notifications - before.notifications,
+             expected - before.notifications);
+        return;
+    }
+    int bad = 0;
+    for (uint32_t i = before.notifications; i < expected; ++i) {
+        fake_watch_notif_t n;
+        fake_watch_get_notif(i, &n);
+        if (strcmp(n.app, "chat") != 0 || strncmp(n.message, k_expect_prefix, strlen(k_expect_prefix)) != 0 ||
+            strstr(n.message, " end") == NULL || strncmp(n.timestamp, "2025-06-01T12:00:", 17) != 0) {
+            if (!bad++) fail("notification %u mangled: app='%s' message='%.60s...'", i, n.app, n.message);
+        }
+    }
+    printf("  %u notifications across %zu MTU x %zu fragment shapes, %d mangled\n",
+           expected - before.notifications, sizeof(mtus) / sizeof(mtus[0]), sizeof(frags) / sizeof(frags[0]), bad);
+}
+
+// Phone-paced notifications: write -> notifications_show latency; then
+// sequential status and echo round-trips on an idle link
+static void scenario_latency(void)
+{
+    enum { N = 200, RT = 100 };
+    int64_t* lat = calloc(N, sizeof(int64_t));
+    fake_watch_counts_t before;
+    fake_watch_get_counts(&before);
+    char line[LINE_MAX_LEN];
+    int got = 0;
+    for (int i = 0; i < N; ++i) {
+        make_notification(line, sizeof(line), i, "short body");
+        int64_t t = esp_timer_get_time();
+        peer_send(line, k_link.mtu, 0);
+        if (!fake_watch_wait_notifs(before.notifications + i + 1, 500)) {
+            fail("notification %d not shown", i);
+            break;
+        }
+        fake_watch_notif_t n;
+        fake_watch_get_notif(before.notifications + i, &n);
+        lat[got++] = n.us - t;
+    }
+    print_pct("notification -> UI", lat, got);
+
+    got = 0;
+    peer_skip_all();
+    for (int i = 0; i < RT; ++i) {
+        rx_line_t r;
+        int64_t t = esp_timer_get_time();
+        peer_send("{\"status\":\"?\"}", k_link.mtu, 0);
+        if (!peer_expect("\"battery\":", 500, &r)) {
+            fail("status round-trip %d lost", i);
+            break;
+        }
+        lat[got++] = r.us - t;
+    }
+    print_pct("status round-trip", lat, got);
+
+    got = 0;
+    for (int i = 0; i < RT; ++i) {
+        rx_line_t r;
+        char cmd[64], want[32];
+        snprintf(cmd, sizeof(cmd), "{\"cmd\":\"echo\",\"seq\":%d}", i);
+        snprintf(want, sizeof(want), "{\"echo\":%d,", i);
+        int64_t t = esp_timer_get_time();
+        peer_send(cmd, k_link.mtu, 0);
+        if (!peer_expect(want, 500, &r)) {
+            fail("echo %d lost", i);
+            break;
+        }
+        lat[got++] = r.us - t;
+    }
+    print_pct("echo round-trip", lat, got);
+    free(lat);
+}
+
+// A notification burst against a slow UI: the phone pushes faster than
+// notifications_show keeps up, the bulk lane overflows, commands in between
+// must still get through quickly, and every notification is either shown or
+// counted as dropped
+static void scenario_burst(void)
+{
+    enum { N = 200, ECHO_EVERY = 10, UI_MS = 8, PHONE_BPS = 100000 };
+    int64_t echo_sent[N / ECHO_EVERY];
+    int64_t echo_rtt[N / ECHO_EVERY];
+    int echoes = 0;
+    char line[LINE_MAX_LEN];
+    static char body[301];
+    memset(body, 'x', sizeof(body) - 1);
+
+    nordic_uart_reset_rx_stats();
+    fake_watch_set_ui_delay_ms(UI_MS);
+    fake_watch_counts_t before;
+    fake_watch_get_counts(&before);
+    peer_skip_all();
+
+    s_pace_bps = PHONE_BPS;
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < N; ++i) {
+        make_notification(line, sizeof(line), i, body);
+        peer_send(line, k_link.mtu, 0);
+        if (i % ECHO_EVERY == ECHO_EVERY - 1) {
+            char cmd[64];
+            snprintf(cmd, sizeof(cmd), "{\"cmd\":\"echo\",\"seq\":%d}", 1000 + echoes);
+            echo_sent[echoes++] = esp_timer_get_time();
+            peer_send(cmd, k_link.mtu, 0);
+        }
+    }
+    fake_ble_flush();
+    s_pace_bps = 0;
+    int64_t t_sent = esp_timer_get_time();
+
+    for (int i = 0; i < echoes; ++i) {
+        char want[32];
+        rx_line_t r;
+        snprintf(want, sizeof(want), "{\"echo\":%d,", 1000 + i);
+        if (!peer_expect(want, 2000, &r)) {
+            fail("echo %d lost in the burst", i);
+            echoes = i;
+            break;
+        }
+        echo_rtt[i] = r.us - echo_sent[i];
+    }
+
+    // Let the UI drain whatever made it into the bulk lane
+    struct nordic_uart_rx_stats st;
+    uint32_t shown = 0;
+    for (int tries = 0; tries < 400; ++tries) {
+        nordic_uart_get_rx_stats(&st);
+        fake_watch_counts_t c;
+        fake_watch_get_counts(&c);
+        shown = c.notifications - before.notifications;
+        if (shown >= st.lines[NORDIC_UART_RX_LANE_BULK] && nordic_uart_rx_pending() == 0) break;
+        vTaskDelay(10);
+    }
+    int64_t t_done = esp_timer_get_time();
+    fake_watch_set_ui_delay_ms(0);
+
+    printf("  %d notifications (%d B lines) + %d echoes at %d kB/s, UI %d ms each\n", N, (int)strlen(line), echoes,
+           PHONE_BPS / 1000, UI_MS);
+    printf("  phone wrote all in %.1f ms, UI drained at %.1f ms\n", (t_sent - t0) / 1000.0, (t_done - t0) / 1000.0);
+    printf("  bulk: %u queued, %u dropped, peak %u B | control: %u queued, %u dropped\n",
+           st.lines[NORDIC_UART_RX_LANE_BULK], st.dropped[NORDIC_UART_RX_LANE_BULK],
+           st.peak_used[NORDIC_UART_RX_LANE_BULK], st.lines[NORDIC_UART_RX_LANE_CONTROL],
+           st.dropped[NORDIC_UART_RX_LANE_CONTROL]);
+    print_pct("echo RTT during burst", echo_rtt, echoes);
+
+    if (st.dropped[NORDIC_UART_RX_LANE_CONTROL] != 0) fail("control lane dropped during a bulk burst");
+    if (shown + st.dropped[NORDIC_UART_RX_LANE_BULK] != N)
+        fail("%u shown + %u dropped != %d sent", shown, st.dropped[NORDIC_UART_RX_LANE_BULK], N);
+    if (st.peak_used[NORDIC_UART_RX_LANE_BULK] > CONFIG_NORDIC_UART_RX_BUFFER_SIZE)
+        fail("bulk peak %u exceeds the lane", st.peak_used[NORDIC_UART_RX_LANE_BULK]);
+    if (nordic_uart_rx_pending() != 0) fail("%zu bytes still pending after drain", nordic_uart_rx_pending());
+    if (echoes && echo_rtt[echoes - 1] > 0) {
+        // A command waits for at most the notification being drawn, not the backlog
+        qsort(echo_rtt, (size_t)echoes, sizeof(echo_rtt[0]), cmp_i64);
+        if (echo_rtt[echoes / 2] > 5 * UI_MS * 1000) fail("echo p50 %.1f ms behind the burst", echo_rtt[echoes / 2] / 1000.0);
+    }
+}
+
+// Connection controller and link report after all of the above
+static void scenario_link(void)
+{
+    rx_line_t r;
+    peer_skip_all();
+    peer_send("{\"cmd\":\"link\"}", k_link.mtu, 0);
+    if (!peer_expect("{\"link\":", 1000, &r)) {
+        fail("no link report");
+        return;
+    }
+    printf("  %s\n", r.text);
+    if (json_num(r.text, "link", "mtu") != k_link.mtu) fail("link mtu");
+    if (json_num(r.text, "link", "tx_phy") != 2) fail("link tx_phy");
+    if (json_num(r.text, "link", "dle") != k_link.dle) fail("link dle");
+
+    fake_ble_stats_t bs;
+    fake_ble_get_stats(&bs);
+    printf("  %u writes / %u B in, %u notifications / %u B out, %u param updates (last itvl %u-%u, lat %u)\n",
+           bs.writes, bs.write_bytes, bs.notifies, bs.notify_bytes, bs.conn_updates, bs.itvl_min, bs.itvl_max,
+           bs.latency);
+}
+
+// Throughput stream from its own task while uartTask answers echoes: every
+// line that reaches the phone must be whole, either filler or one JSON reply
+static void scenario_senders(void)
+{
+    enum { ECHOES = 40 };
+    peer_skip_all();
+    pthread_mutex_lock(&s_rx_m);
+    int first = s_num_lines;
+    pthread_mutex_unlock(&s_rx_m);
+
+    peer_send("{\"cmd\":\"tput\",\"bytes\":65536}", k_link.mtu, 0);
+    char line[64];
+    for (int i = 0; i < ECHOES; ++i) {
+        snprintf(line, sizeof(line), "{\"cmd\":\"echo\",\"seq\":%d}", i);
+        peer_send(line, k_link.mtu, 0);
+        vTaskDelay(2);
+    }
+    if (!peer_expect("{\"tput\":", 5000, NULL)) {
+        fail("no tput report");
+        return;
+    }
+    peer_expect("{\"echo\":39", 1000, NULL);
+
+    int filler = 0, json = 0, echoes = 0, torn = 0;
+    cJSON* reply;
+    pthread_mutex_lock(&s_rx_m);
+    for (int i = first; i < s_num_lines; ++i) {
+        const char* t = s_lines[i].text;
+        size_t n = strlen(t);
+        if (n && t[n - 1] == '\r') n--;
+        bool is_filler = n > 0;
+        for (size_t k = 0; k < n && is_filler; ++k) is_filler = t[k] >= 'A' && t[k] <= 'Z';
+        if (is_filler) {
+            filler++;
+        } else if ((reply = cJSON_ParseWithLength(t, n)) != NULL) {
+            json++;
+            echoes += cJSON_GetObjectItem(reply, "echo") != NULL;
+            cJSON_Delete(reply);
+        } else {
+            if (!torn++) fail("torn line: '%.80s'", t);
+        }
+    }
+    pthread_mutex_unlock(&s_rx_m);
+    printf("  %d filler lines, %d replies (%d echoes), %d torn\n", filler, json, echoes, torn);
+    if (echoes != ECHOES) fail("%d of %d echoes answered", echoes, ECHOES);
+}
+
+// Controller TX queue full for a while: the sender backs off and retries
+static void scenario_enomem(void)
+{
+    rx_line_t r;
+    peer_skip_all();
+    fake_ble_inject_notify_enomem(2);
+    int64_t t = esp_timer_get_time();
+    peer_send("{\"status\":\"?\"}", k_link.mtu, 0);
+    if (!peer_expect("\"battery\":", 2000, &r)) {
+        fail("status lost after ENOMEM");
+        return;
+    }
+    fake_ble_stats_t bs;
+    fake_ble_get_stats(&bs);
+    printf("  status after %u ENOMEM: %.1f ms\n", bs.notify_enomem, (r.us - t) / 1000.0);
+}
+
+// Disconnect and reconnect as a bonded phone: advertising resumes and the
+// restored subscription alone triggers the status push
+static void scenario_reconnect(void)
+{
+    fake_ble_disconnect();
+    if (!fake_ble_wait_advertising(1000)) {
+        fail("not advertising after disconnect");
+        return;
+    }
+    peer_skip_all();
+    fake_ble_link_t link = k_link;
+    link.bonded = true;
+    int64_t t0 = esp_timer_get_time();
+    fake_ble_connect(&link);
+    rx_line_t r;
+    if (!peer_expect("\"battery\":", 1000, &r)) fail("no status after bonded reconnect");
+    else printf("  bonded reconnect -> status %.2f ms\n", (r.us - t0) / 1000.0);
+    if (peer_expect("time_sync", 50, NULL)) fail("time_sync requested again after a successful sync");
+}
+
+// A phone that never reports a data length change: chunks stay sized for
+// 27-byte PDUs instead of the length the watch asked for
+static void scenario_no_dle(void)
+{
+    fake_ble_disconnect();
+    if (!fake_ble_wait_advertising(1000)) {
+        fail("not advertising after disconnect");
+        return;
+    }
+    fake_ble_link_t link = k_link;
+    link.bonded = true;
+    link.dle = 0;
+    fake_ble_connect(&link);
+    peer_skip_all();
+    peer_send("{\"cmd\":\"link\"}", link.mtu, 0);
+    rx_line_t r;
+    if (!peer_expect("{\"link\":", 1000, &r)) {
+        fail("no link report");
+        return;
+    }
+    printf("  dle %.0f, chunk %.0f\n", json_num(r.text, "link", "dle"), json_num(r.text, "link", "chunk"));
+    if (json_num(r.text, "link", "dle") != 27) fail("dle assumed before the controller reported it");
+    if (json_num(r.text, "link", "chunk") > 203) fail("chunk sized for an unconfirmed data length");
+}
+
+// Settings export/import over the control lane
+static void scenario_settings(void)
+{
+    rx_line_t r;
+    peer_skip_all();
+    peer_send("{\"cmd\":\"settings_get\"}", k_link.mtu, 0);
+    if (!peer_expect("{\"settings\":{", 1000, &r)) {
+        fail("no settings reply");
+        return;
+    }
+    double commits = json_num(r.text, "store", "commits");
+    peer_send("{\"cmd\":\"settings_set\",\"settings\":{\"brightness\":55}}", k_link.mtu, 0);
+    if (!peer_expect("{\"settings\":{", 1000, &r)) {
+        fail("no settings_set reply");
+        return;
+    }
+    printf("  %s\n", r.text);
+    if (json_num(r.text, "settings", "brightness") != 55) fail("brightness not applied");
+    if (json_num(r.text, "store", "commits") != commits + 1) fail("settings_set did not commit");
+    if (!strstr(r.text, "\"wear\":{\"nvs\":{\"bytes\":")) fail("no wear counters in settings reply");
+}
+
+static const struct {
+    const char* name;
+    void (*fn)(void);
+} k_scenarios[] = {
+    { "connect", scenario_connect },
+    { "fragment", scenario_fragment },
+    { "latency", scenario_latency },
+    { "burst", scenario_burst },
+    { "link", scenario_link },
+    { "senders", scenario_senders },
+    { "enomem", scenario_enomem },
+    { "settings", scenario_settings },
+    { "reconnect", scenario_reconnect },
+    { "no_dle", scenario_no_dle },
+};
+
+int main(int argc, char** argv)
+{
+    s_lines = calloc(MAX_LINES, sizeof(*s_lines));
+    fake_ble_set_notify_cb(on_notify, NULL);
+    fake_watch_set_power(76, false, 0);
+    fake_watch_set_steps(4321);
+
+    if (ble_sync_init() != ESP_OK || !fake_ble_wait_advertising(1000)) {
+        fprintf(stderr, "stack did not come up\n");
+        return 1;
+    }
+
+    for (size_t i = 0; i < sizeof(k_scenarios) / sizeof(k_scenarios[0]); ++i) {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; ++a) selected |= strcmp(argv[a], k_scenarios[i].name) == 0;
+        // "connect" brings the link up for everything after it
+        if (!selected && i != 0) continue;
+        int before = s_failures;
+        printf("%s%s\n", k_scenarios[i].name, selected ? "" : " (setup)");
+        k_scenarios[i].fn();
+        printf("  %s\n", s_failures == before ? "ok" : "FAILED");
+    }
+    printf("%s\n", s_failures ? "FAIL" : "OK");
+    return s_failures ? 1 : 0;
+}
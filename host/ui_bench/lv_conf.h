@@ -0,0 +1,20 @@
+// LVGL configuration for ui_bench: the settings of the watch's sdkconfig
+// that change what gets drawn and how, on one thread and the C library.
+#pragma once
+
+#define LV_COLOR_DEPTH              16
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+#define LV_USE_OS                   LV_OS_NONE
+#define LV_DEF_REFR_PERIOD          15
+#define LV_DRAW_BUF_STRIDE_ALIGN    1
+#define LV_DRAW_BUF_ALIGN           4
+#define LV_CACHE_DEF_SIZE           0
+#define LV_USE_SNAPSHOT             1
+#define LV_USE_LOG                  0
+#define LV_USE_THEME_DEFAULT        1
+#define LV_THEME_DEFAULT_DARK       1
+#define LV_FONT_MONTSERRAT_26       1
+#define LV_FONT_DEFAULT             &lv_font_montserrat_26
+#define LV_USE_FONT_COMPRESSED      1
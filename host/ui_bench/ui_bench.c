@@ -0,0 +1,300 @@
+// Screen transitions on LVGL itself: the render time of every frame of a
+// tile swipe, a finger drag and a screen load, drawn live and on
+// snapshots (components/gui/src/ui_transition.c). The tiles stand in for
+// the watch's: the watchface background and digits, the control grid and
+// a column of notification cards, in the firmware's fonts.
+//
+// Frames render through a 30-line partial buffer like the watch's and
+// flushing is a copy, so the times are LVGL's drawing alone. Host CPU
+// time is far below the ESP32-S3's; compare live with snapshots, and
+// expect the watch to need several times more for either.
+
+#include "lvgl.h"
+#include "ui_transition.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOR_RES         410     // Waveshare ESP32-S3-Touch-AMOLED-2.06
+#define VER_RES         502
+#define BUF_LINES       30      // CONFIG_BSP_DISPLAY_LVGL_BUF_HEIGHT
+#define FRAME_MS        15      // CONFIG_LV_DEF_REFR_PERIOD
+#define SNAP_FRAMES     3       // CONFIG_UI_TRANSITION_FRAMES
+#define MAX_FRAMES      200
+#define SETTLE_FRAMES   3
+
+LV_FONT_DECLARE(font_numbers_160);
+LV_FONT_DECLARE(font_numbers_80);
+LV_FONT_DECLARE(font_normal_26);
+LV_FONT_DECLARE(font_bold_26);
+LV_IMAGE_DECLARE(background_wf);
+
+typedef struct {
+    uint32_t n;
+    double ms[MAX_FRAMES];
+} run_t;
+
+static uint32_t s_tick;
+static uint16_t s_fb[HOR_RES * VER_RES];
+static uint32_t s_draw_buf[HOR_RES * BUF_LINES / 2];
+static bool s_pressed;
+static lv_point_t s_point;
+
+static lv_obj_t* s_tv;
+static lv_obj_t* s_face;
+static lv_obj_t* s_control;
+static lv_obj_t* s_other;
+
+static uint32_t tick_cb(void)
+{
+    return s_tick;
+}
+
+static void flush_cb(lv_display_t* disp, const lv_area_t* area, uint8_t* px)
+{
+    const int32_t w = lv_area_get_width(area);
+    for (int32_t y = area->y1; y <= area->y2; ++y) {
+        memcpy(&s_fb[y * HOR_RES + area->x1], px, (size_t)w * 2);
+        px += w * 2;
+    }
+    lv_display_flush_ready(disp);
+}
+
+static void read_cb(lv_indev_t* indev, lv_indev_data_t* data)
+{
+    (void)indev;
+    data->point = s_point;
+    data->state = s_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// One refresh period: the clock moves on and the timers run, which reads
+// the pointer, steps the animations and renders
+static double step(void)
+{
+    s_tick += FRAME_MS;
+    const double t0 = now_ms();
+    lv_timer_handler();
+    return now_ms() - t0;
+}
+
+// ---- screens --------------------------------------------------------------
+
+static lv_obj_t* label(lv_obj_t* parent, const lv_font_t* font, uint32_t color, const char* text)
+{
+    lv_obj_t* l = lv_label_create(parent);
+    lv_obj_set_style_text_font(l, font, 0);
+    lv_obj_set_style_text_color(l, lv_color_hex(color), 0);
+    lv_label_set_text(l, text);
+    return l;
+}
+
+static void build_face(lv_obj_t* tile)
+{
+    lv_obj_t* bg = lv_image_create(tile);
+    lv_image_set_src(bg, &background_wf);
+    lv_obj_center(bg);
+    lv_obj_align(label(tile, &font_numbers_160, 0xF0B000, "10"), LV_ALIGN_CENTER, 0, -95);
+    lv_obj_align(label(tile, &font_numbers_160, 0x90F090, "42"), LV_ALIGN_CENTER, 0, 105);
+    lv_obj_center(label(tile, &font_numbers_80, 0x909090, "17"));
+    lv_obj_align(label(tile, &font_normal_26, 0xC0C0C0, "19/10"), LV_ALIGN_RIGHT_MID, -20, 0);
+}
+
+static void build_control(lv_obj_t* tile)
+{
+    lv_obj_set_flex_flow(tile, LV_FLEX_FLOW_ROW_WRAP);
+    lv_obj_set_flex_align(tile, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_pad_all(tile, 12, 0);
+    lv_obj_set_style_pad_gap(tile, 14, 0);
+    static const char* const k_names[] = { "Brightness", "Silence", "Flashlight", "Battery", "Bluetooth", "Settings" };
+    for (size_t i = 0; i < sizeof(k_names) / sizeof(k_names[0]); ++i) {
+        lv_obj_t* item = lv_obj_create(tile);
+        lv_obj_remove_style_all(item);
+        lv_obj_set_size(item, lv_pct(46), 110);
+        lv_obj_set_style_bg_color(item, lv_color_white(), 0);
+        lv_obj_set_style_bg_opa(item, 38, 0);
+        lv_obj_set_style_radius(item, 16, 0);
+        lv_obj_center(label(item, &font_normal_26, 0xD0D0D0, k_names[i]));
+    }
+}
+
+static void build_cards(lv_obj_t* parent)
+{
+    lv_obj_set_flex_flow(parent, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_style_pad_all(parent, 14, 0);
+    lv_obj_set_style_pad_row(parent, 10, 0);
+    for (int i = 0; i < 3; ++i) {
+        lv_obj_t* card = lv_obj_create(parent);
+        lv_obj_remove_style_all(card);
+        lv_obj_set_size(card, lv_pct(100), LV_SIZE_CONTENT);
+        lv_obj_set_style_bg_color(card, lv_color_hex(0x1C1C1C), 0);
+        lv_obj_set_style_bg_opa(card, LV_OPA_COVER, 0);
+        lv_obj_set_style_radius(card, 18, 0);
+        lv_obj_set_style_pad_all(card, 14, 0);
+        lv_obj_set_flex_flow(card, LV_FLEX_FLOW_COLUMN);
+        label(card, &font_bold_26, 0x90F090, "Messages");
+        lv_obj_t* msg = label(card, &font_normal_26, 0xF0F0F0, "See you at the station at six, the train is late again");
+        lv_obj_set_width(msg, lv_pct(100));
+    }
+}
+
+static void build_ui(void)
+{
+    s_tv = lv_tileview_create(NULL);
+    lv_obj_set_style_bg_color(s_tv, lv_color_black(), 0);
+    lv_obj_set_scrollbar_mode(s_tv, LV_SCROLLBAR_MODE_OFF);
+    build_cards(lv_tileview_add_tile(s_tv, 0, 0, LV_DIR_BOTTOM));
+    s_face = lv_tileview_add_tile(s_tv, 0, 1, LV_DIR_ALL);
+    build_face(s_face);
+    s_control = lv_tileview_add_tile(s_tv, 1, 1, LV_DIR_HOR);
+    build_control(s_control);
+
+    s_other = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(s_other, lv_color_black(), 0);
+    build_cards(s_other);
+
+    lv_screen_load(s_tv);
+    lv_tileview_set_tile(s_tv, s_face, LV_ANIM_OFF);
+    ui_transition_attach_tileview(s_tv);
+}
+
+// ---- scenarios --------------------------------------------------------------
+
+static void reset(void)
+{
+    s_pressed = false;
+    for (int i = 0; i < 10; ++i) step();
+    lv_screen_load(s_tv);
+    lv_tileview_set_tile(s_tv, s_face, LV_ANIM_OFF);
+    for (int i = 0; i < 5; ++i) step();
+}
+
+// Steps until nothing animates and `screen` is shown again; the first
+// frame also carries `t_start`, the time spent starting the transition
+static void run_until_settled(run_t* r, lv_obj_t* screen, double t_start)
+{
+    uint32_t quiet = 0;
+    r->n = 0;
+    while (r->n < MAX_FRAMES && quiet < SETTLE_FRAMES) {
+        const double ms = step() + (r->n == 0 ? t_start : 0);
+        r->ms[r->n++] = ms;
+        quiet = lv_anim_count_running() == 0 && lv_screen_active() == screen ? quiet + 1 : 0;
+    }
+    r->n -= quiet;
+}
+
+static void swipe(run_t* r)
+{
+    const double t0 = now_ms();
+    lv_tileview_set_tile(s_tv, s_control, LV_ANIM_ON);
+    run_until_settled(r, s_tv, now_ms() - t0);
+}
+
+// Finger from the right edge to the left, 24 px per refresh, then let go
+static void drag(run_t* r)
+{
+    s_point = (lv_point_t){ 380, VER_RES / 2 };
+    s_pressed = true;
+    r->n = 0;
+    for (int i = 0; i < 12; ++i) {
+        r->ms[r->n++] = step();
+        s_point.x -= 24;
+    }
+    s_pressed = false;
+    run_t rest;
+    run_until_settled(&rest, s_tv, 0);
+    for (uint32_t i = 0; i < rest.n && r->n < MAX_FRAMES; ++i) r->ms[r->n++] = rest.ms[i];
+}
+
+static bool s_snapshots;
+
+static void screen_load(run_t* r)
+{
+    const double t0 = now_ms();
+    if (!s_snapshots || !ui_transition_load_screen(s_other, LV_SCR_LOAD_ANIM_OVER_TOP, 300)) {
+        lv_screen_load_anim(s_other, LV_SCR_LOAD_ANIM_OVER_TOP, 300, 0, false);
+    }
+    run_until_settled(r, s_other, now_ms() - t0);
+}
+
+static int cmp_double(const void* a, const void* b)
+{
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char* name, const char* mode, const run_t* r)
+{
+    if (r->n == 0) {
+        printf("%-14s %-9s no frames\n", name, mode);
+        return;
+    }
+    double sorted[MAX_FRAMES], sum = 0;
+    memcpy(sorted, r->ms, r->n * sizeof(double));
+    qsort(sorted, r->n, sizeof(double), cmp_double);
+    for (uint32_t i = 0; i < r->n; ++i) sum += r->ms[i];
+    printf("%-14s %-9s %6u %8.2f %8.2f %8.2f %8.2f %8.2f\n", name, mode, (unsigned)r->n, sum / r->n,
+           sorted[r->n / 2], sorted[(r->n * 95) / 100], sorted[r->n - 1], r->ms[0]);
+}
+
+int main(void)
+{
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_display_t* disp = lv_display_create(HOR_RES, VER_RES);
+    lv_display_set_buffers(disp, s_draw_buf, NULL, sizeof(s_draw_buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_indev_t* indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, read_cb);
+
+    const size_t frame = ui_transition_frame_size(disp);
+    void* mem = malloc(frame * SNAP_FRAMES);
+    if (!mem) return 1;
+    build_ui();
+
+    static const struct {
+        const char* name;
+        void (*run)(run_t*);
+    } k_scenarios[] = { { "tile swipe", swipe }, { "drag", drag }, { "screen load", screen_load } };
+
+    printf("%-14s %-9s %6s %8s %8s %8s %8s %8s   (ms per frame)\n", "transition", "drawn", "frames", "mean", "p50",
+           "p95", "max", "first");
+    bool ok = true;
+    static run_t r;
+    for (size_t i = 0; i < sizeof(k_scenarios) / sizeof(k_scenarios[0]); ++i) {
+        for (int snap = 0; snap < 2; ++snap) {
+            s_snapshots = snap;
+            ui_transition_init(snap ? mem : NULL, snap ? SNAP_FRAMES : 0);
+            reset();
+            ui_transition_stats_t before, after;
+            ui_transition_get_stats(&before);
+            k_scenarios[i].run(&r);
+            ui_transition_get_stats(&after);
+            report(k_scenarios[i].name, snap ? "snapshot" : "live", &r);
+            if (snap && after.transitions == before.transitions) {
+                printf("  FAILED: ran live (%u live fallbacks)\n", (unsigned)(after.live - before.live));
+                ok = false;
+            }
+            if (r.n == MAX_FRAMES) {
+                printf("  FAILED: did not settle\n");
+                ok = false;
+            }
+        }
+    }
+    ui_transition_stats_t st;
+    ui_transition_get_stats(&st);
+    printf("%u transitions on snapshots, %u snapshots, %u left live\n", (unsigned)st.transitions,
+           (unsigned)st.snapshots, (unsigned)st.live);
+    free(mem);
+    return ok ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 #include "bsp/display.h"
 #include "bsp/esp-bsp.h"
 #include "bsp_board_extra.h"
+#include "boot_seq.h"
 #include "display_manager.h"
 #include "esp_check.h"
 #include "esp_err.h"
@@ -49,7 +50,76 @@ static void power_init(void) {
     esp_bt_controller_mem_release(ESP_BT_MODE_CLASSIC_BT); // only BLE 
 }
 
+// Boot phases, in table order; BOOT_SEQ_AFTER() refers to these indexes.
+// A free worker takes the first ready phase: the short board phase goes
+// ahead of the SPIFFS mount, both beside the display, and audio runs
+// beside the rest once the board is up.
+// I2C is set up before the table so the display, the PMU/RTC and the codec
+// can share the bus from different cores.
+enum { PH_DISPLAY, PH_BOARD, PH_STORAGE, PH_SETTINGS, PH_UI, PH_BLE, PH_AUDIO };
+
+// Without a panel and the LVGL task, settings and the screens are skipped
+static esp_err_t phase_display(void) { return bsp_display_start() ? ESP_OK : ESP_FAIL; }
+
+// An RTC or PMU fault is logged by bsp_extra_init; the screens come up
+// regardless, as they always did
+static esp_err_t phase_board(void) {
+  (void)bsp_extra_init();
+  return ESP_OK;
+}
+
+static esp_err_t phase_storage(void) {
+  settings_init();
+  return ESP_OK;
+}
+
+static esp_err_t phase_settings(void) {
+  settings_apply_hw();
+  return ESP_OK;
+}
+
+static esp_err_t phase_ui(void) {
+  ui_start();
+  return ESP_OK;
+}
+
+static esp_err_t phase_ble(void) {
+  esp_err_t err = ble_sync_init();
+  if (err == ESP_OK) {
+    err = ble_sync_set_enabled(settings_get_bluetooth_enabled());
+  }
+  return err;
+}
+
+// Audio task; alerts queued from BLE and the UI never wait for the codec
+static esp_err_t phase_audio(void) { return audio_alert_init(); }
+
+static const boot_seq_phase_t k_boot_phases[] = {
+  // Panel, touch and the LVGL task
+  { .name = "display", .fn = phase_display, .after = 0, .core = BOOT_SEQ_ANY_CORE },
+  // RTC and PMU
+  { .name = "board", .fn = phase_board, .after = 0, .core = BOOT_SEQ_ANY_CORE },
+  // NVS record and the SPIFFS mount
+  { .name = "storage", .fn = phase_storage, .after = 0, .core = BOOT_SEQ_ANY_CORE },
+  { .name = "settings", .fn = phase_settings,
+    .after = BOOT_SEQ_AFTER(PH_DISPLAY) | BOOT_SEQ_AFTER(PH_STORAGE) | BOOT_SEQ_AFTER(PH_BOARD),
+    .core = BOOT_SEQ_ANY_CORE },
+  // Screens read settings, the PMU, images from /spiffs and the RTC, which
+  // settings_apply_hw() may still be setting and starting
+  { .name = "ui", .fn = phase_ui,
+    .after = BOOT_SEQ_AFTER(PH_DISPLAY) | BOOT_SEQ_AFTER(PH_STORAGE) | BOOT_SEQ_AFTER(PH_BOARD) |
+             BOOT_SEQ_AFTER(PH_SETTINGS),
+    .core = BOOT_SEQ_ANY_CORE },
+  // NimBLE host; the stored on/off state needs the settings record, and
+  // the notification journal and app registry it writes to are opened by
+  // ui_start()
+  { .name = "ble", .fn = phase_ble, .after = BOOT_SEQ_AFTER(PH_STORAGE) | BOOT_SEQ_AFTER(PH_UI),
+    .core = BOOT_SEQ_ANY_CORE },
+  { .name = "audio", .fn = phase_audio, .after = BOOT_SEQ_AFTER(PH_BOARD), .core = BOOT_SEQ_ANY_CORE },
+};
+
 extern "C" void app_main(void) {
+  boot_seq_mark("app_main");
 
   // esp_log_level_set("lcd_panel.io.spi", ESP_LOG_DEBUG);
 
@@ -66,26 +136,20 @@ extern "C" void app_main(void) {
   // BLE remains active; display_manager controls light-sleep via a PM lock
   // Defer PM config until after BSP and BLE init
 
-  bsp_display_start();
-
-  bsp_extra_init();
-
-  settings_init();
-
-  esp_err_t ble_cfg_err = ble_sync_set_enabled(settings_get_bluetooth_enabled());
-  if (ble_cfg_err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to apply stored BLE state: %s", esp_err_to_name(ble_cfg_err));
-  }
+  ESP_ERROR_CHECK(bsp_i2c_init());
 
-  // UI task chama display_manager_init() após criar o ecrã
+  // Independent phases run at the same time on both cores; the workers'
+  // stack is sized for building the screens (the old UI task had 8000)
+  // A failed phase and those it took with it are logged; the rest of the
+  // system is up, so boot carries on
+  esp_err_t boot_err = boot_seq_run(k_boot_phases, sizeof(k_boot_phases) / sizeof(k_boot_phases[0]), 8192);
+  if (boot_err != ESP_FAIL) ESP_ERROR_CHECK(boot_err);
+  boot_seq_log();
 
   // UI e BLE subscrevem eventos diretamente; sem acoplamento no main
 
   //sensors_init();
 
-  // Run the UI at a slightly higher priority so LVGL remains responsive
-  xTaskCreate(ui_task, "ui", 8000, NULL, 4, NULL);
-  
   // Sensor sampling can run at a lower priority without affecting UX
   //xTaskCreate(sensors_task, "sensors", 4096, NULL, 3, NULL);
 
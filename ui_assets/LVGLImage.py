@@ -1,5 +1,7 @@
 #!/usr/bin/env python3
 import os
+import re
+import zlib
 import logging
 import argparse
 import subprocess
@@ -8,15 +10,28 @@ from enum import Enum
 from typing import List
 from pathlib import Path
 
+class MissingModule:
+    """
+    Stand-in for an optional dependency; fails only when actually used, so
+    packing an asset bundle from existing C arrays works without pypng/lz4.
+    """
+
+    def __init__(self, hint: str) -> None:
+        self.hint = hint
+
+    def __getattr__(self, name):
+        raise ImportError(self.hint)
+
+
 try:
     import png
 except ImportError:
-    raise ImportError("Need pypng package, do `pip3 install pypng`")
+    png = MissingModule("Need pypng package, do `pip3 install pypng`")
 
 try:
     import lz4.block
 except ImportError:
-    raise ImportError("Need lz4 package, do `pip3 install lz4`")
+    lz4 = MissingModule("Need lz4 package, do `pip3 install lz4`")
 
 
 def uint8_t(val) -> bytes:
@@ -757,6 +772,48 @@ class LVGLImage:
             data = f.read()
             return self.from_data(data)
 
+    def from_c_array(self, filename: str):
+        """
+        Read back an image from a C file written by to_c_array, or by the
+        older LVGL v9 exporter that uses `.header.cf = ...` designators.
+        The C variable name is kept in `self.name`.
+        """
+
+        with open(filename, "r") as f:
+            text = f.read()
+
+        dsc = re.search(r"lv_image_dsc_t\s+(\w+)\s*=\s*\{(.*?)\};", text,
+                        re.S)
+        if dsc is None:
+            raise FormatError(f"no lv_image_dsc_t in {filename}")
+
+        fields = dict(
+            re.findall(r"\.(cf|w|h|stride|flags|data)\s*=\s*([^,\n]+)",
+                       dsc.group(2)))
+        if "COMPRESSED" in fields.get("flags", ""):
+            raise FormatError(f"compressed image not supported: {filename}")
+
+        cf_name = fields.get("cf", "").strip().replace("LV_COLOR_FORMAT_", "")
+        if cf_name not in ColorFormat.__members__:
+            raise FormatError(f"unknown color format '{cf_name}' in {filename}")
+
+        array = re.search(
+            r"uint8_t\s+" + re.escape(fields["data"].strip()) +
+            r"\s*\[\]\s*=\s*\{(.*?)\};", text, re.S)
+        if array is None:
+            raise FormatError(f"no pixel array in {filename}")
+        data = bytes(
+            int(v, 16) for v in re.findall(r"0x([0-9a-fA-F]{1,2})\b",
+                                           array.group(1)))
+
+        self.set_data(ColorFormat[cf_name], int(fields["w"], 0),
+                      int(fields["h"], 0), data,
+                      int(fields.get("stride", "0"), 0))
+        self.premultiplied = "PREMULTIPLIED" in fields.get("flags", "")
+        self.name = dsc.group(1)
+        logging.info(f"from c array: {filename}, {self}")
+        return self
+
     def _check_ext(self, filename: str, ext):
         if not filename.lower().endswith(ext):
             raise FormatError(f"filename not ended with {ext}")
@@ -1293,10 +1350,132 @@ class RAWImage():
         return self
 
 
+class AssetBundle:
+    """
+    Indexed image bundle for the "assets" flash partition. The firmware maps
+    it with esp_partition_mmap and points lv_image_dsc_t.data straight into
+    it, see components/assets. Little-endian layout:
+
+      header  24 bytes: magic "S3AB", version, count, slots, index_size,
+              total_size, CRC32 of slots + names
+      slots   28 bytes each, power-of-two count; open addressing on the
+              FNV-1a hash of the name with linear probing, name_off 0 = empty
+      names   NUL-terminated
+      data    pixel data exactly as in the C arrays, each entry 4-byte aligned
+    """
+
+    MAGIC = 0x42413353  # "S3AB"
+    VERSION = 1
+    HEADER_SIZE = 24
+    SLOT_SIZE = 28
+    DATA_ALIGN = 4
+    KIND_IMAGE = 1
+
+    def __init__(self) -> None:
+        self.images = []
+
+    @staticmethod
+    def hash(name: str) -> int:
+        h = 0x811c9dc5
+        for b in name.encode():
+            h = ((h ^ b) * 0x01000193) & 0xffffffff
+        return h
+
+    def add_image(self, name: str, img: LVGLImage):
+        if any(n == name for n, _ in self.images):
+            raise ParameterError(f"duplicate asset name: {name}")
+        if len(name.encode()) > 63:
+            raise ParameterError(f"asset name too long: {name}")
+        self.images.append((name, img))
+        return self
+
+    def _align(self, n: int) -> int:
+        return (n + self.DATA_ALIGN - 1) // self.DATA_ALIGN * self.DATA_ALIGN
+
+    @property
+    def binary(self) -> bytearray:
+        count = len(self.images)
+        slots = 8
+        while slots < count * 2:  # keep the load factor at or below 1/2
+            slots *= 2
+
+        names = bytearray()
+        name_off = []
+        for name, _ in self.images:
+            name_off.append(self.HEADER_SIZE + slots * self.SLOT_SIZE +
+                            len(names))
+            names += name.encode() + b"\0"
+
+        index_size = slots * self.SLOT_SIZE + len(names)
+        data_start = self._align(self.HEADER_SIZE + index_size)
+
+        table = [None] * slots
+        data = bytearray()
+        for i, (name, img) in enumerate(self.images):
+            h = self.hash(name)
+            j = h & (slots - 1)
+            while table[j] is not None:
+                j = (j + 1) & (slots - 1)
+            table[j] = (h, name_off[i], data_start + len(data), img)
+            data += img.data
+            data += bytes(self._align(len(data)) - len(data))
+
+        index = bytearray()
+        for entry in table:
+            if entry is None:
+                index += bytes(self.SLOT_SIZE)
+                continue
+            h, noff, doff, img = entry
+            index += uint32_t(h)
+            index += uint32_t(noff)
+            index += uint32_t(doff)
+            index += uint32_t(len(img.data))
+            index += uint16_t(img.w)
+            index += uint16_t(img.h)
+            index += uint16_t(img.stride)
+            index += uint16_t(0x01 if img.premultiplied else 0)
+            index += uint8_t(img.cf.value)
+            index += uint8_t(self.KIND_IMAGE)
+            index += uint16_t(0)
+        index += names
+
+        total = data_start + len(data)
+        binary = bytearray()
+        binary += uint32_t(self.MAGIC)
+        binary += uint16_t(self.VERSION)
+        binary += uint16_t(count)
+        binary += uint16_t(slots)
+        binary += uint16_t(0)
+        binary += uint32_t(index_size)
+        binary += uint32_t(total)
+        binary += uint32_t(zlib.crc32(index))
+        binary += index
+        binary += bytes(data_start - len(binary))
+        binary += data
+        return binary
+
+    def write(self, filename: str, max_size: int = 0):
+        binary = self.binary
+        if max_size and len(binary) > max_size:
+            raise ParameterError(
+                f"bundle is {len(binary)} bytes, partition holds {max_size}")
+
+        dir = path.dirname(filename)
+        if dir and not path.exists(dir):
+            os.makedirs(dir)
+        with open(filename, "wb") as f:
+            f.write(binary)
+
+        logging.info(f"bundle: {filename}, {len(self.images)} images, "
+                     f"{len(binary)} bytes")
+        return self
+
+
 class OutputFormat(Enum):
     C_ARRAY = "C"
     BIN_FILE = "BIN"
     PNG_FILE = "PNG"  # convert to lvgl image and then to png
+    BUNDLE = "BUNDLE"  # all inputs packed into one asset partition image
 
 
 class PNGConverter:
@@ -1373,9 +1552,11 @@ class PNGConverter:
 def main():
     parser = argparse.ArgumentParser(description='LVGL PNG to bin image tool.')
     parser.add_argument('--ofmt',
-                        help="output filename format, C or BIN",
+                        help=("output filename format, C or BIN; BUNDLE packs "
+                              "all inputs (PNG or LVGL C arrays) into the "
+                              "single file given by -o"),
                         default="BIN",
-                        choices=["C", "BIN", "PNG"])
+                        choices=["C", "BIN", "PNG", "BUNDLE"])
     parser.add_argument(
         '--cf',
         help=("bin image color format, use AUTO for automatically "
@@ -1419,21 +1600,31 @@ def main():
     parser.add_argument('--name',
                         default=None,
                         help="Specify name for output file. Only applies when input is a file, not a directory. (Also used for variable name inside .c file when format is 'C')")
+    parser.add_argument('--max-size',
+                        default=0,
+                        type=lambda x: int(x, 0),
+                        help="BUNDLE only: fail if the bundle is larger (partition size)")
     parser.add_argument('-v', '--verbose', action='store_true')
     parser.add_argument(
-        'input', help="the filename or folder to be recursively converted")
+        'input', nargs='+',
+        help="the filenames or folders to be recursively converted")
 
     args = parser.parse_args()
 
-    if path.isfile(args.input):
-        files = [args.input]
-    elif path.isdir(args.input):
-        files = list(Path(args.input).rglob("*.[pP][nN][gG]"))
-
-        if args.name is not None:
-            raise BaseException(f"invalid input: cannot specify --name when input is a directory")
-    else:
-        raise BaseException(f"invalid input: {args.input}")
+    bundle = args.ofmt == "BUNDLE"
+    files = []
+    for input in args.input:
+        if path.isfile(input):
+            files.append(input)
+        elif path.isdir(input):
+            files += sorted(Path(input).rglob("*.[pP][nN][gG]"))
+            if bundle:
+                files += sorted(Path(input).rglob("*.c"))
+
+            if args.name is not None:
+                raise BaseException(f"invalid input: cannot specify --name when input is a directory")
+        else:
+            raise BaseException(f"invalid input: {input}")
 
     if args.verbose:
         logging.basicConfig(level=logging.INFO)
@@ -1449,6 +1640,10 @@ def main():
         ColorFormat.RAW, ColorFormat.RAW_ALPHA) else OutputFormat.C_ARRAY
     compress = CompressMethod[args.compress]
 
+    if bundle:
+        c_files = [f for f in files if str(f).endswith(".c")]
+        files = [f for f in files if f not in c_files]
+
     converter = PNGConverter(files,
                              cf,
                              ofmt,
@@ -1464,6 +1659,16 @@ def main():
     for f, img in output:
         logging.info(f"len: {img.data_len} for {path.basename(f)} ")
 
+    if bundle:
+        assets = AssetBundle()
+        for f, img in output:
+            assets.add_image(path.basename(f).split('.')[0], img)
+        for f in c_files:
+            img = LVGLImage().from_c_array(str(f))
+            assets.add_image(img.name, img)
+        assets.write(args.output, args.max_size)
+        files += c_files
+
     print(f"done {len(files)} files")
 
 